@@ -21,6 +21,12 @@ function(add_benchmark NAME NAMESPACE)
     $<$<BOOL:${PLFIT_INCLUDE_DIR}>:${PLFIT_INCLUDE_DIR}>
   )
 
+  # Some benchmarks compare internal variants of functions, so we also have
+  # to add src/ to the include path even though it's not part of the public API
+  target_include_directories(
+    ${TARGET_NAME} PRIVATE ${CMAKE_SOURCE_DIR}/src ${CMAKE_BINARY_DIR}/src
+  )
+
   if (MSVC)
     # Add MSVC-specific include path for some headers that are missing on Windows
     target_include_directories(${TARGET_NAME} PRIVATE ${CMAKE_SOURCE_DIR}/msvc/include)
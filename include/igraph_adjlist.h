@@ -105,6 +105,79 @@ IGRAPH_EXPORT igraph_error_t igraph_inclist_fprint(const igraph_inclist_t *il, F
  */
 #define igraph_inclist_get(il,no) (&(il)->incs[(igraph_integer_t)(no)])
 
+typedef struct igraph_csr_adjlist_t {
+    igraph_integer_t length;
+    igraph_vector_int_t offsets;
+    igraph_vector_int_t neis;
+    igraph_vector_int_t eids;
+    igraph_bool_t has_eids;
+} igraph_csr_adjlist_t;
+
+IGRAPH_EXPORT igraph_error_t igraph_csr_adjlist_init(const igraph_t *graph,
+                                          igraph_csr_adjlist_t *al,
+                                          igraph_neimode_t mode,
+                                          igraph_loops_t loops,
+                                          igraph_multiple_t multiple);
+IGRAPH_EXPORT igraph_error_t igraph_csr_adjlist_init_incident(const igraph_t *graph,
+                                                   igraph_csr_adjlist_t *al,
+                                                   igraph_neimode_t mode,
+                                                   igraph_loops_t loops);
+IGRAPH_EXPORT void igraph_csr_adjlist_destroy(igraph_csr_adjlist_t *al);
+IGRAPH_EXPORT igraph_integer_t igraph_csr_adjlist_size(const igraph_csr_adjlist_t *al);
+IGRAPH_EXPORT igraph_bool_t igraph_csr_adjlist_has_eids(const igraph_csr_adjlist_t *al);
+IGRAPH_EXPORT igraph_error_t igraph_csr_adjlist_print(const igraph_csr_adjlist_t *al);
+IGRAPH_EXPORT igraph_error_t igraph_csr_adjlist_fprint(const igraph_csr_adjlist_t *al, FILE *outfile);
+
+/**
+ * \define igraph_csr_adjlist_degree
+ * \brief The number of entries stored for a vertex in a compact adjacency list.
+ *
+ * \param al The compact adjacency list object.
+ * \param no The vertex ID to query.
+ * \return The number of neighbors (and incident edges) stored for \p no.
+ *
+ * Time complexity: O(1).
+ */
+#define igraph_csr_adjlist_degree(al,no) \
+    (VECTOR((al)->offsets)[(igraph_integer_t)(no) + 1] - VECTOR((al)->offsets)[(igraph_integer_t)(no)])
+
+/**
+ * \define igraph_csr_adjlist_get
+ * \brief Query the neighbors of a vertex in a compact adjacency list.
+ *
+ * Returns a pointer into the neighbor array of the adjacency list; the
+ * neighbors of vertex \p no are the first
+ * \ref igraph_csr_adjlist_degree() elements starting at this address.
+ * The returned pointer must not be used to change the number of neighbors
+ * and it is invalidated when the adjacency list is destroyed.
+ *
+ * \param al The compact adjacency list object.
+ * \param no The vertex ID to query.
+ * \return Pointer to the first neighbor of \p no.
+ *
+ * Time complexity: O(1).
+ */
+#define igraph_csr_adjlist_get(al,no) \
+    (VECTOR((al)->neis) + VECTOR((al)->offsets)[(igraph_integer_t)(no)])
+
+/**
+ * \define igraph_csr_adjlist_get_eids
+ * \brief Query the incident edges of a vertex in a compact adjacency list.
+ *
+ * Only valid for adjacency lists that were created with
+ * \ref igraph_csr_adjlist_init_incident(). The i-th element starting at
+ * the returned address is the ID of the edge that leads to the i-th
+ * neighbor returned by \ref igraph_csr_adjlist_get().
+ *
+ * \param al The compact adjacency list object.
+ * \param no The vertex ID to query.
+ * \return Pointer to the first incident edge of \p no.
+ *
+ * Time complexity: O(1).
+ */
+#define igraph_csr_adjlist_get_eids(al,no) \
+    (VECTOR((al)->eids) + VECTOR((al)->offsets)[(igraph_integer_t)(no)])
+
 typedef struct igraph_lazy_adjlist_t {
     const igraph_t *graph;
     igraph_integer_t length;
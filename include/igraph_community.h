@@ -44,6 +44,32 @@ IGRAPH_EXPORT igraph_error_t igraph_coreness(
 IGRAPH_EXPORT igraph_error_t igraph_trussness(
     const igraph_t* graph, igraph_vector_int_t* trussness);
 
+typedef struct igraph_coreness_incremental_t {
+    igraph_vector_int_list_t adj;
+    igraph_vector_int_t cores;
+    igraph_vector_int_t cd;
+    igraph_vector_int_t mark;
+    igraph_vector_int_t visited;
+    igraph_vector_int_t queue;
+    igraph_integer_t stamp;
+} igraph_coreness_incremental_t;
+
+IGRAPH_EXPORT igraph_error_t igraph_coreness_incremental_init(
+    const igraph_t *graph, igraph_coreness_incremental_t *ic);
+IGRAPH_EXPORT void igraph_coreness_incremental_destroy(igraph_coreness_incremental_t *ic);
+IGRAPH_EXPORT igraph_integer_t igraph_coreness_incremental_vcount(
+    const igraph_coreness_incremental_t *ic);
+IGRAPH_EXPORT igraph_integer_t igraph_coreness_incremental_get(
+    const igraph_coreness_incremental_t *ic, igraph_integer_t vid);
+IGRAPH_EXPORT igraph_error_t igraph_coreness_incremental_coreness(
+    const igraph_coreness_incremental_t *ic, igraph_vector_int_t *cores);
+IGRAPH_EXPORT igraph_error_t igraph_coreness_incremental_add_vertices(
+    igraph_coreness_incremental_t *ic, igraph_integer_t nv);
+IGRAPH_EXPORT igraph_error_t igraph_coreness_incremental_add_edge(
+    igraph_coreness_incremental_t *ic, igraph_integer_t from, igraph_integer_t to);
+IGRAPH_EXPORT igraph_error_t igraph_coreness_incremental_delete_edge(
+    igraph_coreness_incremental_t *ic, igraph_integer_t from, igraph_integer_t to);
+
 /* -------------------------------------------------- */
 /* Community Structure                                */
 /* -------------------------------------------------- */
@@ -73,6 +99,20 @@ IGRAPH_EXPORT igraph_error_t igraph_community_spinglass(const igraph_t *graph,
                                              igraph_spinglass_implementation_t implementation,
                                              igraph_real_t gamma_minus);
 
+IGRAPH_EXPORT igraph_error_t igraph_community_spinglass_tempering(const igraph_t *graph,
+                                             const igraph_vector_t *weights,
+                                             igraph_real_t *modularity,
+                                             igraph_real_t *temperature,
+                                             igraph_vector_int_t *membership,
+                                             igraph_vector_int_t *csize,
+                                             igraph_integer_t spins,
+                                             igraph_integer_t replicas,
+                                             igraph_real_t starttemp,
+                                             igraph_real_t stoptemp,
+                                             igraph_real_t coolfact,
+                                             igraph_spincomm_update_t update_rule,
+                                             igraph_real_t gamma);
+
 IGRAPH_EXPORT igraph_error_t igraph_community_spinglass_single(const igraph_t *graph,
                                                     const igraph_vector_t *weights,
                                                     igraph_integer_t vertex,
@@ -91,6 +131,13 @@ IGRAPH_EXPORT igraph_error_t igraph_community_walktrap(const igraph_t *graph,
                                             igraph_matrix_int_t *merges,
                                             igraph_vector_t *modularity,
                                             igraph_vector_int_t *membership);
+IGRAPH_EXPORT igraph_error_t igraph_community_walktrap_bounded(const igraph_t *graph,
+                                            const igraph_vector_t *weights,
+                                            igraph_integer_t steps,
+                                            igraph_integer_t max_memory,
+                                            igraph_matrix_int_t *merges,
+                                            igraph_vector_t *modularity,
+                                            igraph_vector_int_t *membership);
 
 IGRAPH_EXPORT igraph_error_t igraph_community_infomap(const igraph_t * graph,
                                            const igraph_vector_t *e_weights,
@@ -53,6 +53,10 @@ IGRAPH_EXPORT igraph_error_t igraph_get_stochastic(
    const igraph_vector_t *weights
 );
 
+IGRAPH_EXPORT igraph_error_t igraph_get_adjacency_csr(
+   const igraph_t *graph, igraph_sparsemat_csr_t *res, igraph_get_adjacency_t type,
+   const igraph_vector_t *weights, igraph_loops_t loops
+);
 IGRAPH_EXPORT igraph_error_t igraph_get_stochastic_sparse(
    const igraph_t *graph, igraph_sparsemat_t *res, igraph_bool_t column_wise,
    const igraph_vector_t *weights
@@ -62,6 +62,11 @@ IGRAPH_EXPORT void igraph_sir_destroy(igraph_sir_t *sir);
 IGRAPH_EXPORT igraph_error_t igraph_sir(const igraph_t *graph, igraph_real_t beta,
                              igraph_real_t gamma, igraph_integer_t no_sim,
                              igraph_vector_ptr_t *result);
+IGRAPH_EXPORT igraph_error_t igraph_sir_summary(const igraph_t *graph, igraph_real_t beta,
+                                     igraph_real_t gamma, igraph_integer_t no_sim,
+                                     igraph_vector_int_t *final_size,
+                                     igraph_vector_int_t *peak,
+                                     igraph_vector_t *peak_time);
 
 __END_DECLS
 
@@ -68,6 +68,50 @@ IGRAPH_EXPORT igraph_error_t igraph_maxflow_value(const igraph_t *graph, igraph_
                                        const igraph_vector_t *capacity,
                                        igraph_maxflow_stats_t *stats);
 
+/**
+ * \struct igraph_flow_network_t
+ * \brief A graph prepared for repeated maximum flow calculations.
+ *
+ * This data structure holds the residual network of a graph, together with
+ * the state of the push-relabel algorithm after the last maximum flow
+ * calculation. It is created from a graph and a capacity vector with
+ * \ref igraph_flow_network_init(), and queried with
+ * \ref igraph_flow_network_maxflow(). Its members should not be accessed
+ * directly.
+ */
+
+typedef struct igraph_flow_network_t {
+    igraph_integer_t no_of_nodes;
+    igraph_bool_t directed;
+    igraph_vector_int_t first;
+    igraph_vector_int_t to;
+    igraph_vector_int_t rev;
+    igraph_vector_int_t edge_arc;
+    igraph_vector_t capacity;
+    igraph_vector_t rescap;
+    igraph_vector_t excess;
+    igraph_vector_int_t current;
+    igraph_vector_int_t distance;
+    igraph_integer_t source;
+    igraph_integer_t target;
+} igraph_flow_network_t;
+
+IGRAPH_EXPORT igraph_error_t igraph_flow_network_init(igraph_flow_network_t *network,
+                                                      const igraph_t *graph,
+                                                      const igraph_vector_t *capacity);
+IGRAPH_EXPORT void igraph_flow_network_destroy(igraph_flow_network_t *network);
+IGRAPH_EXPORT igraph_error_t igraph_flow_network_set_capacity(igraph_flow_network_t *network,
+                                                              igraph_integer_t eid,
+                                                              igraph_real_t capacity);
+IGRAPH_EXPORT igraph_error_t igraph_flow_network_maxflow(igraph_flow_network_t *network,
+                                                         igraph_real_t *value,
+                                                         igraph_vector_int_t *cut,
+                                                         igraph_vector_int_t *partition,
+                                                         igraph_vector_int_t *partition2,
+                                                         igraph_integer_t source,
+                                                         igraph_integer_t target,
+                                                         igraph_maxflow_stats_t *stats);
+
 IGRAPH_EXPORT igraph_error_t igraph_st_mincut(const igraph_t *graph, igraph_real_t *value,
                                    igraph_vector_int_t *cut, igraph_vector_int_t *partition,
                                    igraph_vector_int_t *partition2,
@@ -132,6 +132,9 @@ IGRAPH_EXPORT igraph_error_t igraph_layout_graphopt(const igraph_t *graph,
 
 IGRAPH_EXPORT igraph_error_t igraph_layout_mds(const igraph_t *graph, igraph_matrix_t *res,
                                     const igraph_matrix_t *dist, igraph_integer_t dim);
+IGRAPH_EXPORT igraph_error_t igraph_layout_pivot_mds(const igraph_t *graph, igraph_matrix_t *res,
+                                                     igraph_integer_t dim, igraph_integer_t no_of_pivots,
+                                                     const igraph_vector_t *weights);
 
 IGRAPH_EXPORT igraph_error_t igraph_layout_bipartite(const igraph_t *graph,
                                           const igraph_vector_bool_t *types,
@@ -274,6 +277,25 @@ IGRAPH_EXPORT igraph_error_t igraph_layout_davidson_harel(const igraph_t *graph,
                                                igraph_real_t weight_edge_crossings,
                                                igraph_real_t weight_node_edge_dist);
 
+/**
+ * \typedef igraph_layout_multilevel_refine_t
+ * \brief The force-directed algorithm used by the multilevel layout.
+ *
+ * \enumval IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD The
+ *    Fruchterman-Reingold algorithm, see \ref igraph_layout_fruchterman_reingold().
+ * \enumval IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT The GraphOpt algorithm,
+ *    see \ref igraph_layout_graphopt().
+ */
+
+typedef enum {
+    IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD = 0,
+    IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT
+} igraph_layout_multilevel_refine_t;
+
+IGRAPH_EXPORT igraph_error_t igraph_layout_multilevel(const igraph_t *graph, igraph_matrix_t *res,
+                                                      igraph_integer_t niter, igraph_integer_t coarsest_size,
+                                                      igraph_layout_multilevel_refine_t refine);
+
 /**
  * \typedef igraph_root_choice_t
  * \brief Root choice heuristic for tree visualizations.
@@ -235,6 +235,15 @@ IGRAPH_EXPORT igraph_error_t igraph_random_walk(const igraph_t *graph,
         igraph_neimode_t mode,
         igraph_integer_t steps,
         igraph_random_walk_stuck_t stuck);
+IGRAPH_EXPORT igraph_error_t igraph_random_walks(const igraph_t *graph,
+        const igraph_vector_t *weights,
+        igraph_matrix_int_t *walks,
+        igraph_vs_t starts,
+        igraph_integer_t walks_per_start,
+        igraph_neimode_t mode,
+        igraph_integer_t steps,
+        igraph_real_t p, igraph_real_t q,
+        igraph_random_walk_stuck_t stuck);
 
 IGRAPH_EXPORT igraph_error_t igraph_get_k_shortest_paths(const igraph_t *graph,
         const igraph_vector_t *weights,
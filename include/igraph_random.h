@@ -117,6 +117,8 @@ IGRAPH_EXPORT igraph_error_t igraph_rng_init(igraph_rng_t *rng, const igraph_rng
 IGRAPH_EXPORT void igraph_rng_destroy(igraph_rng_t *rng);
 
 IGRAPH_EXPORT igraph_error_t igraph_rng_seed(igraph_rng_t *rng, igraph_uint_t seed);
+IGRAPH_EXPORT igraph_error_t igraph_rng_seed_stream(igraph_rng_t *rng, igraph_uint_t seed,
+                                                    igraph_uint_t stream);
 IGRAPH_EXPORT igraph_integer_t igraph_rng_bits(const igraph_rng_t* rng);
 IGRAPH_EXPORT igraph_uint_t igraph_rng_max(const igraph_rng_t *rng);
 IGRAPH_EXPORT const char *igraph_rng_name(const igraph_rng_t *rng);
@@ -140,6 +142,14 @@ IGRAPH_EXPORT igraph_real_t igraph_rng_get_gamma(
     igraph_rng_t *rng, igraph_real_t shape, igraph_real_t scale
 );
 IGRAPH_EXPORT igraph_real_t igraph_rng_get_pois(igraph_rng_t *rng, igraph_real_t rate);
+IGRAPH_EXPORT igraph_error_t igraph_rng_fill_unif01(igraph_rng_t *rng, igraph_vector_t *res);
+IGRAPH_EXPORT igraph_error_t igraph_rng_fill_integer(
+    igraph_rng_t *rng, igraph_vector_int_t *res, igraph_integer_t l, igraph_integer_t h
+);
+IGRAPH_EXPORT igraph_error_t igraph_rng_fill_exp(igraph_rng_t *rng, igraph_vector_t *res,
+                                                 igraph_real_t rate);
+IGRAPH_EXPORT igraph_error_t igraph_rng_fill_geom(igraph_rng_t *rng, igraph_vector_t *res,
+                                                  igraph_real_t p);
 IGRAPH_EXPORT igraph_error_t igraph_rng_get_dirichlet(igraph_rng_t *rng,
                                            const igraph_vector_t *alpha,
                                            igraph_vector_t *result);
@@ -150,6 +160,7 @@ IGRAPH_EXPORT extern const igraph_rng_type_t igraph_rngtype_glibc2;
 IGRAPH_EXPORT extern const igraph_rng_type_t igraph_rngtype_mt19937;
 IGRAPH_EXPORT extern const igraph_rng_type_t igraph_rngtype_pcg32;
 IGRAPH_EXPORT extern const igraph_rng_type_t igraph_rngtype_pcg64;
+IGRAPH_EXPORT extern const igraph_rng_type_t igraph_rngtype_philox4x32;
 
 IGRAPH_EXPORT igraph_rng_t *igraph_rng_default(void);
 IGRAPH_EXPORT void igraph_rng_set_default(igraph_rng_t *rng);
@@ -66,6 +66,14 @@ typedef struct {
     igraph_integer_t col;
 } igraph_sparsemat_iterator_t;
 
+typedef struct {
+    igraph_integer_t nrow;
+    igraph_integer_t ncol;
+    igraph_vector_int_t rowptr;
+    igraph_vector_int_t colidx;
+    igraph_vector_t values;
+} igraph_sparsemat_csr_t;
+
 IGRAPH_EXPORT igraph_error_t igraph_sparsemat_init(
     igraph_sparsemat_t *A, igraph_integer_t rows, igraph_integer_t cols,
     igraph_integer_t nzmax
@@ -298,6 +306,26 @@ IGRAPH_EXPORT igraph_integer_t igraph_sparsemat_iterator_idx(const igraph_sparse
 IGRAPH_EXPORT igraph_real_t igraph_sparsemat_iterator_get(const igraph_sparsemat_iterator_t *it);
 IGRAPH_EXPORT igraph_integer_t igraph_sparsemat_iterator_next(igraph_sparsemat_iterator_t *it);
 
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_csr_init(igraph_sparsemat_csr_t *A,
+                                                    igraph_integer_t rows,
+                                                    igraph_integer_t cols);
+IGRAPH_EXPORT void igraph_sparsemat_csr_destroy(igraph_sparsemat_csr_t *A);
+IGRAPH_EXPORT igraph_integer_t igraph_sparsemat_csr_nrow(const igraph_sparsemat_csr_t *A);
+IGRAPH_EXPORT igraph_integer_t igraph_sparsemat_csr_ncol(const igraph_sparsemat_csr_t *A);
+IGRAPH_EXPORT igraph_integer_t igraph_sparsemat_csr_nonzero_storage(const igraph_sparsemat_csr_t *A);
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_as_csr(igraph_sparsemat_csr_t *res,
+                                                  const igraph_sparsemat_t *A);
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_csr_as_sparsemat(igraph_sparsemat_t *res,
+                                                            const igraph_sparsemat_csr_t *A);
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_csr_transpose(const igraph_sparsemat_csr_t *A,
+                                                         igraph_sparsemat_csr_t *res);
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_csr_gaxpy(const igraph_sparsemat_csr_t *A,
+                                                     const igraph_vector_t *x,
+                                                     igraph_vector_t *res);
+IGRAPH_EXPORT igraph_error_t igraph_sparsemat_csr_multiply_by_dense(const igraph_sparsemat_csr_t *A,
+                                                                 const igraph_matrix_t *B,
+                                                                 igraph_matrix_t *res);
+
 IGRAPH_EXPORT IGRAPH_DEPRECATED igraph_error_t igraph_sparsemat_copy(
     igraph_sparsemat_t *to, const igraph_sparsemat_t *from);
 IGRAPH_EXPORT IGRAPH_DEPRECATED igraph_error_t igraph_sparsemat_diag(
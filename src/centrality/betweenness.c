@@ -33,9 +33,11 @@
  * We provide separate implementations of single-source shortest path searches,
  * one with incidence lists and one with adjacency lists. We use the implementation
  * based on adjacency lists when possible (i.e. when weights are not needed) to
- * avoid an expensive IGRAPH_OTHER() lookup on edge IDs. The cost of this macro
- * comes from the inability of the branch predictor to predict accurately whether
- * the condition in the macro will be true or not.
+ * avoid carrying edge IDs around. The graph structure is always traversed through
+ * a compact (CSR) adjacency list; when edge IDs are needed, the list also stores
+ * them, so we never need an expensive IGRAPH_OTHER() lookup on edge IDs. The cost
+ * of this macro comes from the inability of the branch predictor to predict
+ * accurately whether the condition in the macro will be true or not.
  *
  * The following four functions are very similar in their structure. If you make
  * a modification to one of them, consider whether the same modification makes
@@ -56,7 +58,7 @@
  *                 discovered during the traversal
  * \param  parents adjacent list that starts empty and that stores the IDs
  *                 of the vertices that lead to a given node during the traversal
- * \param  adjlist the adjacency list of the graph
+ * \param  adjlist the compact adjacency list of the graph
  * \param  cutoff  cutoff length of shortest paths
  */
 static igraph_error_t igraph_i_sspf(
@@ -65,11 +67,11 @@ static igraph_error_t igraph_i_sspf(
         igraph_real_t *nrgeo,
         igraph_stack_int_t *stack,
         igraph_adjlist_t *parents,
-        const igraph_adjlist_t *adjlist,
+        const igraph_csr_adjlist_t *adjlist,
         igraph_real_t cutoff) {
 
     igraph_dqueue_int_t queue;
-    const igraph_vector_int_t *neis;
+    const igraph_integer_t *neis;
     igraph_vector_int_t *v;
     igraph_integer_t nlen;
 
@@ -95,10 +97,10 @@ static igraph_error_t igraph_i_sspf(
         IGRAPH_CHECK(igraph_stack_int_push(stack, actnode));
 
         /* Examine the neighbors of this node */
-        neis = igraph_adjlist_get(adjlist, actnode);
-        nlen = igraph_vector_int_size(neis);
+        neis = igraph_csr_adjlist_get(adjlist, actnode);
+        nlen = igraph_csr_adjlist_degree(adjlist, actnode);
         for (igraph_integer_t j = 0; j < nlen; j++) {
-            igraph_integer_t neighbor = VECTOR(*neis)[j];
+            igraph_integer_t neighbor = neis[j];
 
             if (VECTOR(*dist)[neighbor] == 0) {
                 /* We have found 'neighbor' for the first time */
@@ -126,7 +128,6 @@ static igraph_error_t igraph_i_sspf(
  * Internal function to calculate the single source shortest paths for the
  * edge unweighted case.
  *
- * \param  graph   the graph to calculate the single source shortest paths on
  * \param  source  the source node
  * \param  dist    distance of each node from the source node \em plus one;
  *                 must be filled with zeros initially
@@ -136,21 +137,20 @@ static igraph_error_t igraph_i_sspf(
  *                 discovered during the traversal
  * \param  parents incidence list that starts empty and that stores the IDs
  *                 of the edges that lead to a given node during the traversal
- * \param  inclist the incidence list of the graph
+ * \param  inclist the compact adjacency list of the graph, with edge IDs
  * \param  cutoff  cutoff length of shortest paths
  */
 static igraph_error_t igraph_i_sspf_edge(
-        const igraph_t *graph,
         igraph_integer_t source,
         igraph_vector_t *dist,
         igraph_real_t *nrgeo,
         igraph_stack_int_t *stack,
         igraph_inclist_t *parents,
-        const igraph_inclist_t *inclist,
+        const igraph_csr_adjlist_t *inclist,
         igraph_real_t cutoff) {
 
     igraph_dqueue_int_t queue;
-    const igraph_vector_int_t *neis;
+    const igraph_integer_t *neis, *incs;
     igraph_vector_int_t *v;
     igraph_integer_t nlen;
 
@@ -176,11 +176,12 @@ static igraph_error_t igraph_i_sspf_edge(
         IGRAPH_CHECK(igraph_stack_int_push(stack, actnode));
 
         /* Examine the neighbors of this node */
-        neis = igraph_inclist_get(inclist, actnode);
-        nlen = igraph_vector_int_size(neis);
+        neis = igraph_csr_adjlist_get(inclist, actnode);
+        incs = igraph_csr_adjlist_get_eids(inclist, actnode);
+        nlen = igraph_csr_adjlist_degree(inclist, actnode);
         for (igraph_integer_t j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*neis)[j];
-            igraph_integer_t neighbor = IGRAPH_OTHER(graph, edge, actnode);
+            igraph_integer_t edge = incs[j];
+            igraph_integer_t neighbor = neis[j];
 
             if (VECTOR(*dist)[neighbor] == 0) {
                 /* We have found 'neighbor' for the first time */
@@ -219,7 +220,7 @@ static igraph_error_t igraph_i_sspf_edge(
  *                 discovered during the traversal
  * \param  parents adjacency list that starts empty and that stores the IDs
  *                 of the vertices that lead to a given node during the traversal
- * \param  inclist the incidence list of the graph
+ * \param  inclist the compact adjacency list of the graph, with edge IDs
  * \param  cutoff  cutoff length of shortest paths
  */
 static igraph_error_t igraph_i_sspf_weighted(
@@ -230,14 +231,14 @@ static igraph_error_t igraph_i_sspf_weighted(
         const igraph_vector_t *weights,
         igraph_stack_int_t *stack,
         igraph_adjlist_t *parents,
-        const igraph_inclist_t *inclist,
+        const igraph_csr_adjlist_t *inclist,
         igraph_real_t cutoff) {
 
     const igraph_real_t eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
     int cmp_result;
     igraph_2wheap_t queue;
-    const igraph_vector_int_t *neis;
+    const igraph_integer_t *neis, *incs;
     igraph_vector_int_t *v;
     igraph_integer_t nlen;
 
@@ -267,11 +268,12 @@ static igraph_error_t igraph_i_sspf_weighted(
         IGRAPH_CHECK(igraph_stack_int_push(stack, minnei));
 
         /* Now check all neighbors of 'minnei' for a shorter path */
-        neis = igraph_inclist_get(inclist, minnei);
-        nlen = igraph_vector_int_size(neis);
+        neis = igraph_csr_adjlist_get(inclist, minnei);
+        incs = igraph_csr_adjlist_get_eids(inclist, minnei);
+        nlen = igraph_csr_adjlist_degree(inclist, minnei);
         for (igraph_integer_t j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*neis)[j];
-            igraph_integer_t to = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_integer_t edge = incs[j];
+            igraph_integer_t to = neis[j];
             igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
             igraph_real_t curdist = VECTOR(*dist)[to];
 
@@ -328,7 +330,7 @@ static igraph_error_t igraph_i_sspf_weighted(
  *                 discovered during the traversal
  * \param  parents incidence list that starts empty and that stores the IDs
  *                 of the edges that lead to a given node during the traversal
- * \param  inclist the incidence list of the graph
+ * \param  inclist the compact adjacency list of the graph, with edge IDs
  * \param  cutoff  cutoff length of shortest paths
  */
 static igraph_error_t igraph_i_sspf_weighted_edge(
@@ -339,14 +341,14 @@ static igraph_error_t igraph_i_sspf_weighted_edge(
         const igraph_vector_t *weights,
         igraph_stack_int_t *stack,
         igraph_inclist_t *parents,
-        const igraph_inclist_t *inclist,
+        const igraph_csr_adjlist_t *inclist,
         igraph_real_t cutoff) {
 
     const igraph_real_t eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
     int cmp_result;
     igraph_2wheap_t queue;
-    const igraph_vector_int_t *neis;
+    const igraph_integer_t *neis, *incs;
     igraph_vector_int_t *v;
     igraph_integer_t nlen;
 
@@ -376,11 +378,12 @@ static igraph_error_t igraph_i_sspf_weighted_edge(
         IGRAPH_CHECK(igraph_stack_int_push(stack, minnei));
 
         /* Now check all neighbors of 'minnei' for a shorter path */
-        neis = igraph_inclist_get(inclist, minnei);
-        nlen = igraph_vector_int_size(neis);
+        neis = igraph_csr_adjlist_get(inclist, minnei);
+        incs = igraph_csr_adjlist_get_eids(inclist, minnei);
+        nlen = igraph_csr_adjlist_degree(inclist, minnei);
         for (igraph_integer_t j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*neis)[j];
-            igraph_integer_t to = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_integer_t edge = incs[j];
+            igraph_integer_t to = neis[j];
             igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
             igraph_real_t curdist = VECTOR(*dist)[to];
 
@@ -540,8 +543,8 @@ igraph_error_t igraph_betweenness_cutoff(const igraph_t *graph, igraph_vector_t
 
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_integer_t no_of_edges = igraph_ecount(graph);
-    igraph_adjlist_t adjlist, parents;
-    igraph_inclist_t inclist;
+    igraph_csr_adjlist_t adjlist;
+    igraph_adjlist_t parents;
     igraph_integer_t source, j, neighbor;
     igraph_stack_int_t S;
     igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
@@ -562,12 +565,11 @@ igraph_error_t igraph_betweenness_cutoff(const igraph_t *graph, igraph_vector_t
     IGRAPH_CHECK(igraph_i_betweenness_check_weights(weights, no_of_edges));
 
     if (weights) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode, IGRAPH_NO_LOOPS));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &adjlist, mode, IGRAPH_NO_LOOPS));
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, mode, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
     }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
 
     IGRAPH_CHECK(igraph_adjlist_init_empty(&parents, no_of_nodes));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &parents);
@@ -611,7 +613,7 @@ igraph_error_t igraph_betweenness_cutoff(const igraph_t *graph, igraph_vector_t
 
         /* Conduct a single-source shortest path search from the source node */
         if (weights) {
-            IGRAPH_CHECK(igraph_i_sspf_weighted(graph, source, &dist, nrgeo, weights, &S, &parents, &inclist, cutoff));
+            IGRAPH_CHECK(igraph_i_sspf_weighted(graph, source, &dist, nrgeo, weights, &S, &parents, &adjlist, cutoff));
         } else {
             IGRAPH_CHECK(igraph_i_sspf(source, &dist, nrgeo, &S, &parents, &adjlist, cutoff));
         }
@@ -672,11 +674,7 @@ igraph_error_t igraph_betweenness_cutoff(const igraph_t *graph, igraph_vector_t
     igraph_vector_destroy(&dist);
     igraph_stack_int_destroy(&S);
     igraph_adjlist_destroy(&parents);
-    if (weights) {
-        igraph_inclist_destroy(&inclist);
-    } else {
-        igraph_adjlist_destroy(&adjlist);
-    }
+    igraph_csr_adjlist_destroy(&adjlist);
     IGRAPH_FINALLY_CLEAN(6);
 
     return IGRAPH_SUCCESS;
@@ -761,7 +759,8 @@ igraph_error_t igraph_edge_betweenness_cutoff(const igraph_t *graph, igraph_vect
                                    const igraph_vector_t *weights, igraph_real_t cutoff) {
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_integer_t no_of_edges = igraph_ecount(graph);
-    igraph_inclist_t inclist, parents;
+    igraph_csr_adjlist_t inclist;
+    igraph_inclist_t parents;
     igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
     igraph_vector_t dist;
     igraph_real_t *nrgeo;
@@ -771,8 +770,8 @@ igraph_error_t igraph_edge_betweenness_cutoff(const igraph_t *graph, igraph_vect
 
     IGRAPH_CHECK(igraph_i_betweenness_check_weights(weights, no_of_edges));
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode, IGRAPH_NO_LOOPS));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inclist, mode, IGRAPH_NO_LOOPS));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inclist);
 
     IGRAPH_CHECK(igraph_inclist_init_empty(&parents, no_of_nodes));
     IGRAPH_FINALLY(igraph_inclist_destroy, &parents);
@@ -813,7 +812,7 @@ igraph_error_t igraph_edge_betweenness_cutoff(const igraph_t *graph, igraph_vect
         if (weights) {
             IGRAPH_CHECK(igraph_i_sspf_weighted_edge(graph, source, &dist, nrgeo, weights, &S, &parents, &inclist, cutoff));
         } else {
-            IGRAPH_CHECK(igraph_i_sspf_edge(graph, source, &dist, nrgeo, &S, &parents, &inclist, cutoff));
+            IGRAPH_CHECK(igraph_i_sspf_edge(source, &dist, nrgeo, &S, &parents, &inclist, cutoff));
         }
 
         /* Aggregate betweenness scores for the edges we have reached in this
@@ -848,7 +847,7 @@ igraph_error_t igraph_edge_betweenness_cutoff(const igraph_t *graph, igraph_vect
     IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
     igraph_stack_int_destroy(&S);
-    igraph_inclist_destroy(&inclist);
+    igraph_csr_adjlist_destroy(&inclist);
     igraph_inclist_destroy(&parents);
     igraph_vector_destroy(&dist);
     IGRAPH_FREE(tmpscore);
@@ -903,8 +902,8 @@ igraph_error_t igraph_betweenness_subset(const igraph_t *graph, igraph_vector_t
     igraph_integer_t no_of_edges = igraph_ecount(graph);
     igraph_integer_t no_of_sources;
     igraph_integer_t no_of_processed_sources;
-    igraph_adjlist_t adjlist, parents;
-    igraph_inclist_t inclist;
+    igraph_csr_adjlist_t adjlist;
+    igraph_adjlist_t parents;
     igraph_integer_t source, j;
     igraph_stack_int_t S;
     igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
@@ -921,12 +920,11 @@ igraph_error_t igraph_betweenness_subset(const igraph_t *graph, igraph_vector_t
     IGRAPH_CHECK(igraph_vs_size(graph, &sources, &no_of_sources));
 
     if (weights) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode, IGRAPH_NO_LOOPS));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &adjlist, mode, IGRAPH_NO_LOOPS));
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, mode, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
     }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
 
     IGRAPH_CHECK(igraph_adjlist_init_empty(&parents, no_of_nodes));
     IGRAPH_FINALLY(igraph_adjlist_destroy, &parents);
@@ -1000,7 +998,7 @@ igraph_error_t igraph_betweenness_subset(const igraph_t *graph, igraph_vector_t
 
         /* Conduct a single-source shortest path search from the source node */
         if (weights) {
-            IGRAPH_CHECK(igraph_i_sspf_weighted(graph, source, &dist, nrgeo, weights, &S, &parents, &inclist, -1));
+            IGRAPH_CHECK(igraph_i_sspf_weighted(graph, source, &dist, nrgeo, weights, &S, &parents, &adjlist, -1));
         } else {
             IGRAPH_CHECK(igraph_i_sspf(source, &dist, nrgeo, &S, &parents, &adjlist, -1));
         }
@@ -1068,11 +1066,7 @@ igraph_error_t igraph_betweenness_subset(const igraph_t *graph, igraph_vector_t
     igraph_vector_destroy(&dist);
     igraph_stack_int_destroy(&S);
     igraph_adjlist_destroy(&parents);
-    if (weights) {
-        igraph_inclist_destroy(&inclist);
-    } else {
-        igraph_adjlist_destroy(&adjlist);
-    }
+    igraph_csr_adjlist_destroy(&adjlist);
     IGRAPH_FINALLY_CLEAN(7);
 
     return IGRAPH_SUCCESS;
@@ -1120,7 +1114,8 @@ igraph_error_t igraph_edge_betweenness_subset(const igraph_t *graph, igraph_vect
     igraph_integer_t no_of_edges = igraph_ecount(graph);
     igraph_integer_t no_of_sources;
     igraph_integer_t no_of_processed_sources;
-    igraph_inclist_t inclist, parents;
+    igraph_csr_adjlist_t inclist;
+    igraph_inclist_t parents;
     igraph_vit_t vit;
     igraph_eit_t eit;
     igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
@@ -1148,8 +1143,8 @@ igraph_error_t igraph_edge_betweenness_subset(const igraph_t *graph, igraph_vect
     igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode, IGRAPH_NO_LOOPS));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inclist, mode, IGRAPH_NO_LOOPS));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inclist);
     IGRAPH_CHECK(igraph_inclist_init_empty(&parents, no_of_nodes));
     IGRAPH_FINALLY(igraph_inclist_destroy, &parents);
 
@@ -1212,7 +1207,7 @@ igraph_error_t igraph_edge_betweenness_subset(const igraph_t *graph, igraph_vect
         if (weights) {
             IGRAPH_CHECK(igraph_i_sspf_weighted_edge(graph, source, &dist, nrgeo, weights, &S, &parents, &inclist, -1));
         } else {
-            IGRAPH_CHECK(igraph_i_sspf_edge(graph, source, &dist, nrgeo, &S, &parents, &inclist, -1));
+            IGRAPH_CHECK(igraph_i_sspf_edge(source, &dist, nrgeo, &S, &parents, &inclist, -1));
         }
 
         /* Aggregate betweenness scores for the nodes we have reached in this
@@ -1277,7 +1272,7 @@ igraph_error_t igraph_edge_betweenness_subset(const igraph_t *graph, igraph_vect
     IGRAPH_FREE(nrgeo);
     igraph_vector_destroy(&dist);
     igraph_inclist_destroy(&parents);
-    igraph_inclist_destroy(&inclist);
+    igraph_csr_adjlist_destroy(&inclist);
     IGRAPH_FREE(is_target);
     IGRAPH_FINALLY_CLEAN(7);
 
@@ -23,10 +23,121 @@
 
 #include "igraph_community.h"
 
+#include "igraph_adjlist.h"
 #include "igraph_memory.h"
 #include "igraph_interface.h"
 #include "igraph_iterators.h"
 
+#include "core/interruption.h"
+#include "core/parallel.h"
+#include "math/safe_intop.h"
+
+#include <string.h> /* memcpy */
+
+/* Graphs with fewer vertices than this are always processed sequentially;
+ * for those the cost of spawning threads outweighs the gains. */
+#define IGRAPH_I_CORENESS_PARALLEL_MIN_VERTICES 16384
+
+#ifdef IGRAPH_I_PARALLEL
+
+/* Level-synchronous parallel peeling, in the spirit of the ParK algorithm of
+ * Dasari, Desh and Zubair: ParK: An efficient algorithm for k-core
+ * decomposition on multicore processors (2014).
+ *
+ * 'cores' must contain the degrees of the vertices on entry, and contains
+ * the coreness values on exit. For each level k, vertices whose remaining
+ * degree is exactly k are peeled in parallel, sub-level by sub-level.
+ * Remaining degrees are never decremented below the current level, so
+ * the final remaining degree of each vertex is its coreness. */
+static igraph_error_t igraph_i_coreness_parallel(
+        const igraph_csr_adjlist_t *adjlist, igraph_vector_int_t *cores) {
+
+    igraph_integer_t no_of_nodes = igraph_vector_int_size(cores);
+    igraph_integer_t *deg = VECTOR(*cores);
+    igraph_integer_t *curr, *next, *tmp;
+    igraph_integer_t curr_size, next_size;
+    igraph_integer_t processed = 0, k = 0;
+
+    curr = IGRAPH_CALLOC(no_of_nodes, igraph_integer_t);
+    IGRAPH_CHECK_OOM(curr, "Cannot calculate k-cores.");
+    IGRAPH_FINALLY(igraph_free, curr);
+    next = IGRAPH_CALLOC(no_of_nodes, igraph_integer_t);
+    IGRAPH_CHECK_OOM(next, "Cannot calculate k-cores.");
+    IGRAPH_FINALLY(igraph_free, next);
+
+    while (processed < no_of_nodes) {
+        igraph_integer_t min_deg = IGRAPH_INTEGER_MAX;
+
+        /* Find the next non-empty level. Already peeled vertices have
+         * a remaining degree smaller than k. */
+#pragma omp parallel for reduction(min:min_deg)
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            if (deg[i] >= k && deg[i] < min_deg) {
+                min_deg = deg[i];
+            }
+        }
+        k = min_deg;
+
+        curr_size = 0;
+#pragma omp parallel for
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            if (deg[i] == k) {
+                igraph_integer_t idx;
+#pragma omp atomic capture
+                idx = curr_size++;
+                curr[idx] = i;
+            }
+        }
+
+        while (curr_size > 0) {
+            processed += curr_size;
+            next_size = 0;
+
+#pragma omp parallel for schedule(dynamic, 64)
+            for (igraph_integer_t i = 0; i < curr_size; i++) {
+                igraph_integer_t v = curr[i];
+                const igraph_integer_t *neis = igraph_csr_adjlist_get(adjlist, v);
+                igraph_integer_t nei_count = igraph_csr_adjlist_degree(adjlist, v);
+                for (igraph_integer_t j = 0; j < nei_count; j++) {
+                    igraph_integer_t u = neis[j], du;
+#pragma omp atomic read
+                    du = deg[u];
+                    if (du > k) {
+#pragma omp atomic capture
+                        du = deg[u]--;
+                        if (du == k + 1) {
+                            /* u has just dropped to level k */
+                            igraph_integer_t idx;
+#pragma omp atomic capture
+                            idx = next_size++;
+                            next[idx] = u;
+                        } else if (du <= k) {
+                            /* another thread got there first; undo */
+#pragma omp atomic
+                            deg[u]++;
+                        }
+                    }
+                }
+            }
+
+            tmp = curr; curr = next; next = tmp;
+            curr_size = next_size;
+        }
+
+        k++;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    IGRAPH_FREE(next);
+    IGRAPH_FREE(curr);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif /* IGRAPH_I_PARALLEL */
+
 /**
  * \function igraph_coreness
  * \brief Finding the coreness of the vertices in a network.
@@ -42,6 +153,19 @@
  * Decomposition of Networks.
  * https://arxiv.org/abs/cs/0310049
  *
+ * </para><para>
+ * When igraph is compiled with OpenMP support and the graph is large,
+ * the vertices are peeled level by level using multiple threads instead,
+ * following the ParK algorithm of Naga Shailaja Dasari, Ranjan Desh,
+ * Mohammad Zubair: ParK: An efficient algorithm for k-core decomposition
+ * on multicore processors. The result does not depend on which of the
+ * two methods is used. The number of threads is controlled through the
+ * usual OpenMP mechanisms, e.g. the \c OMP_NUM_THREADS environment variable.
+ *
+ * </para><para>
+ * To keep coreness values up to date while edges are added to or removed
+ * from a graph, see \ref igraph_coreness_incremental_init().
+ *
  * \param graph The input graph.
  * \param cores Pointer to an initialized vector, the result of the
  *        computation will be stored here. It will be resized as
@@ -54,7 +178,9 @@
  *        out-cores.
  * \return Error code.
  *
- * Time complexity: O(|E|), the number of edges.
+ * Time complexity: O(|E|), the number of edges, for the sequential
+ * algorithm. The parallel algorithm performs O(|V| k + |E|) work in total,
+ * where k is the number of distinct coreness values.
  */
 
 igraph_error_t igraph_coreness(const igraph_t *graph,
@@ -64,7 +190,7 @@ igraph_error_t igraph_coreness(const igraph_t *graph,
     igraph_integer_t *bin, *vert, *pos;
     igraph_integer_t maxdeg;
     igraph_integer_t i, j = 0;
-    igraph_vector_int_t neis;
+    igraph_csr_adjlist_t adjlist;
     igraph_neimode_t omode;
 
     if (mode != IGRAPH_ALL && mode != IGRAPH_OUT && mode != IGRAPH_IN) {
@@ -83,6 +209,21 @@ igraph_error_t igraph_coreness(const igraph_t *graph,
         return IGRAPH_SUCCESS;
     }
 
+    /* maximum degree + degree of vertices */
+    IGRAPH_CHECK(igraph_degree(graph, cores, igraph_vss_all(), mode, /* loops= */ true));
+
+    IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, omode, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+
+#ifdef IGRAPH_I_PARALLEL
+    if (no_of_nodes >= IGRAPH_I_CORENESS_PARALLEL_MIN_VERTICES && igraph_i_parallel_max_threads() > 1) {
+        IGRAPH_CHECK(igraph_i_coreness_parallel(&adjlist, cores));
+        igraph_csr_adjlist_destroy(&adjlist);
+        IGRAPH_FINALLY_CLEAN(1);
+        return IGRAPH_SUCCESS;
+    }
+#endif
+
     vert = IGRAPH_CALLOC(no_of_nodes, igraph_integer_t);
     if (vert == 0) {
         IGRAPH_ERROR("Cannot calculate k-cores", IGRAPH_ENOMEM); /* LCOV_EXCL_LINE */
@@ -94,9 +235,6 @@ igraph_error_t igraph_coreness(const igraph_t *graph,
     }
     IGRAPH_FINALLY(igraph_free, pos);
 
-    /* maximum degree + degree of vertices */
-    IGRAPH_CHECK(igraph_degree(graph, cores, igraph_vss_all(), mode, /* loops= */ true));
-
     maxdeg = igraph_vector_int_max(cores);
 
     bin = IGRAPH_CALLOC(maxdeg + 1, igraph_integer_t);
@@ -132,13 +270,12 @@ igraph_error_t igraph_coreness(const igraph_t *graph,
     bin[0] = 0;
 
     /* this is the main algorithm */
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&neis, maxdeg);
     for (i = 0; i < no_of_nodes; i++) {
         igraph_integer_t v = vert[i];
-        IGRAPH_CHECK(igraph_neighbors(graph, &neis, v, omode));
-        igraph_integer_t nei_count = igraph_vector_int_size(&neis);
+        const igraph_integer_t *neis = igraph_csr_adjlist_get(&adjlist, v);
+        igraph_integer_t nei_count = igraph_csr_adjlist_degree(&adjlist, v);
         for (j = 0; j < nei_count; j++) {
-            igraph_integer_t u = VECTOR(neis)[j];
+            igraph_integer_t u = neis[j];
             if (VECTOR(*cores)[u] > VECTOR(*cores)[v]) {
                 igraph_integer_t du = VECTOR(*cores)[u];
                 igraph_integer_t pu = pos[u];
@@ -156,13 +293,490 @@ igraph_error_t igraph_coreness(const igraph_t *graph,
         }
     }
 
-    igraph_vector_int_destroy(&neis);
-    IGRAPH_FINALLY_CLEAN(1);
-
     igraph_free(bin);
     igraph_free(pos);
     igraph_free(vert);
     IGRAPH_FINALLY_CLEAN(3);
 
+    igraph_csr_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_coreness_incremental_init
+ * \brief Initializes coreness values that can be maintained incrementally.
+ *
+ * Computing the coreness of all vertices from scratch takes time
+ * proportional to the size of the graph. When the graph changes through
+ * the insertion or removal of single edges, only a small part of the
+ * vertices is affected: an edge insertion may increase, an edge removal
+ * may decrease the coreness of some vertices, by at most one. An
+ * \type igraph_coreness_incremental_t object keeps its own copy of the
+ * graph structure together with the coreness values, and updates them after
+ * each change using the traversal algorithm of Sarıyüce et al., visiting
+ * only the vertices near the modified edge whose coreness may change.
+ *
+ * </para><para>
+ * Edge directions are ignored, i.e. the maintained values are the same as
+ * what \ref igraph_coreness() computes with \c IGRAPH_ALL. Multi-edges and
+ * self-loops are allowed; a self-loop adds two to the degree of its vertex.
+ *
+ * </para><para>
+ * Reference:
+ *
+ * </para><para>
+ * Ahmet Erdem Sarıyüce, Buğra Gedik, Gabriela Jacques-Silva, Kun-Lung Wu,
+ * Ümit V. Çatalyürek: Incremental k-core decomposition: algorithms and
+ * evaluation. The VLDB Journal 25, 425–447 (2016).
+ * https://doi.org/10.1007/s00778-016-0423-8
+ *
+ * \param graph The initial graph. It is not referenced after this function
+ *        returns; later changes to it are \em not reflected by the object.
+ * \param ic Pointer to an uninitialized \type igraph_coreness_incremental_t
+ *        object.
+ * \return Error code.
+ *
+ * \sa \ref igraph_coreness_incremental_add_edge(),
+ * \ref igraph_coreness_incremental_delete_edge(),
+ * \ref igraph_coreness_incremental_get(), \ref igraph_coreness_incremental_destroy().
+ *
+ * Time complexity: O(|V|+|E|), the number of vertices plus the number of
+ * edges.
+ */
+igraph_error_t igraph_coreness_incremental_init(
+        const igraph_t *graph, igraph_coreness_incremental_t *ic) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_csr_adjlist_t adjlist;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ic->cores, 0);
+    IGRAPH_CHECK(igraph_coreness(graph, &ic->cores, IGRAPH_ALL));
+
+    IGRAPH_CHECK(igraph_vector_int_list_init(&ic->adj, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &ic->adj);
+
+    IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_vector_int_t *neis = igraph_vector_int_list_get_ptr(&ic->adj, i);
+        igraph_integer_t nei_count = igraph_csr_adjlist_degree(&adjlist, i);
+        IGRAPH_CHECK(igraph_vector_int_resize(neis, nei_count));
+        if (nei_count > 0) {
+            memcpy(VECTOR(*neis), igraph_csr_adjlist_get(&adjlist, i),
+                   sizeof(igraph_integer_t) * nei_count);
+        }
+    }
+    igraph_csr_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ic->cd, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ic->mark, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ic->visited, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ic->queue, no_of_nodes);
+    ic->stamp = 0;
+
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_coreness_incremental_destroy
+ * \brief Frees the memory used by incrementally maintained coreness values.
+ *
+ * \param ic The object to destroy.
+ *
+ * Time complexity: O(|V|).
+ */
+void igraph_coreness_incremental_destroy(igraph_coreness_incremental_t *ic) {
+    igraph_vector_int_destroy(&ic->queue);
+    igraph_vector_int_destroy(&ic->visited);
+    igraph_vector_int_destroy(&ic->mark);
+    igraph_vector_int_destroy(&ic->cd);
+    igraph_vector_int_list_destroy(&ic->adj);
+    igraph_vector_int_destroy(&ic->cores);
+}
+
+/**
+ * \function igraph_coreness_incremental_vcount
+ * \brief The number of vertices in an incrementally maintained graph.
+ *
+ * \param ic The incremental coreness object.
+ * \return The number of vertices.
+ *
+ * Time complexity: O(1).
+ */
+igraph_integer_t igraph_coreness_incremental_vcount(const igraph_coreness_incremental_t *ic) {
+    return igraph_vector_int_size(&ic->cores);
+}
+
+/**
+ * \function igraph_coreness_incremental_get
+ * \brief The current coreness of a single vertex.
+ *
+ * \param ic The incremental coreness object.
+ * \param vid The vertex ID. It is not range-checked.
+ * \return The coreness of the vertex.
+ *
+ * Time complexity: O(1).
+ */
+igraph_integer_t igraph_coreness_incremental_get(
+        const igraph_coreness_incremental_t *ic, igraph_integer_t vid) {
+    return VECTOR(ic->cores)[vid];
+}
+
+/**
+ * \function igraph_coreness_incremental_coreness
+ * \brief The current coreness of all vertices.
+ *
+ * \param ic The incremental coreness object.
+ * \param cores Pointer to an initialized vector, the coreness of each
+ *        vertex will be stored here. It will be resized as needed.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|).
+ */
+igraph_error_t igraph_coreness_incremental_coreness(
+        const igraph_coreness_incremental_t *ic, igraph_vector_int_t *cores) {
+    IGRAPH_CHECK(igraph_vector_int_update(cores, &ic->cores));
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_coreness_incremental_add_vertices
+ * \brief Adds isolated vertices to an incrementally maintained graph.
+ *
+ * The new vertices have coreness zero and receive consecutive IDs
+ * following the existing ones.
+ *
+ * \param ic The incremental coreness object.
+ * \param nv The number of vertices to add.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+nv) in the worst case, amortized O(nv).
+ */
+igraph_error_t igraph_coreness_incremental_add_vertices(
+        igraph_coreness_incremental_t *ic, igraph_integer_t nv) {
+
+    igraph_integer_t no_of_nodes = igraph_vector_int_size(&ic->cores);
+    igraph_integer_t new_no_of_nodes;
+
+    if (nv < 0) {
+        IGRAPH_ERROR("Cannot add negative number of vertices.", IGRAPH_EINVAL);
+    }
+    IGRAPH_SAFE_ADD(no_of_nodes, nv, &new_no_of_nodes);
+
+    /* Reserve everything first so that a failure leaves the object intact. */
+    IGRAPH_CHECK(igraph_vector_int_list_reserve(&ic->adj, new_no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&ic->cores, new_no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&ic->cd, new_no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&ic->mark, new_no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&ic->visited, new_no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&ic->queue, new_no_of_nodes));
+
+    for (igraph_integer_t i = 0; i < nv; i++) {
+        IGRAPH_CHECK(igraph_vector_int_list_push_back_new(&ic->adj, NULL));
+    }
+    igraph_vector_int_resize(&ic->cores, new_no_of_nodes); /* reserved */
+    igraph_vector_int_resize(&ic->cd, new_no_of_nodes); /* reserved */
+    igraph_vector_int_resize(&ic->mark, new_no_of_nodes); /* reserved */
+    igraph_vector_int_resize(&ic->visited, new_no_of_nodes); /* reserved */
+    igraph_vector_int_resize(&ic->queue, new_no_of_nodes); /* reserved */
+    for (igraph_integer_t i = no_of_nodes; i < new_no_of_nodes; i++) {
+        VECTOR(ic->cores)[i] = 0;
+        VECTOR(ic->mark)[i] = 0;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Number of neighbors of v, counted with multiplicity, whose coreness is at
+ * least k. */
+static igraph_integer_t igraph_i_coreness_incremental_cd(
+        const igraph_coreness_incremental_t *ic, igraph_integer_t v, igraph_integer_t k) {
+    const igraph_vector_int_t *neis = igraph_vector_int_list_get_ptr(&ic->adj, v);
+    igraph_integer_t nei_count = igraph_vector_int_size(neis);
+    igraph_integer_t cd = 0;
+    for (igraph_integer_t i = 0; i < nei_count; i++) {
+        if (VECTOR(ic->cores)[ VECTOR(*neis)[i] ] >= k) {
+            cd++;
+        }
+    }
+    return cd;
+}
+
+/* Called after the degree of 'root' has increased, with k being the current
+ * coreness of 'root'. Promotes the vertices that now belong to the
+ * (k+1)-core to coreness k+1.
+ *
+ * Candidates are the vertices of coreness k that are reachable from 'root'
+ * through vertices of coreness k. A candidate can only enter the (k+1)-core
+ * if more than k of its neighbors are in it, therefore the traversal does
+ * not continue through candidates with at most k neighbors of coreness at
+ * least k. Afterwards, candidates that do not have enough neighbors are
+ * evicted iteratively; the remaining candidates are promoted.
+ *
+ * Candidates are marked with 'stamp' while they are still viable, and with
+ * 'stamp + 1' after they have been evicted. */
+static void igraph_i_coreness_incremental_promote(
+        igraph_coreness_incremental_t *ic, igraph_integer_t root, igraph_integer_t k) {
+
+    igraph_integer_t *cores = VECTOR(ic->cores);
+    igraph_integer_t *cd = VECTOR(ic->cd);
+    igraph_integer_t *mark = VECTOR(ic->mark);
+    igraph_integer_t *visited = VECTOR(ic->visited);
+    igraph_integer_t *queue = VECTOR(ic->queue);
+    igraph_integer_t visited_count = 0, queue_size = 0;
+    igraph_integer_t stamp;
+
+    ic->stamp += 2;
+    stamp = ic->stamp;
+
+    /* Phase 1: find the candidates */
+    mark[root] = stamp;
+    visited[visited_count++] = root;
+    for (igraph_integer_t i = 0; i < visited_count; i++) {
+        igraph_integer_t v = visited[i];
+        const igraph_vector_int_t *neis;
+        igraph_integer_t nei_count;
+
+        cd[v] = igraph_i_coreness_incremental_cd(ic, v, k);
+        if (cd[v] <= k) {
+            mark[v] = stamp + 1;
+            queue[queue_size++] = v;
+            continue;
+        }
+
+        neis = igraph_vector_int_list_get_ptr(&ic->adj, v);
+        nei_count = igraph_vector_int_size(neis);
+        for (igraph_integer_t j = 0; j < nei_count; j++) {
+            igraph_integer_t u = VECTOR(*neis)[j];
+            if (cores[u] == k && mark[u] != stamp && mark[u] != stamp + 1) {
+                mark[u] = stamp;
+                visited[visited_count++] = u;
+            }
+        }
+    }
+
+    /* Phase 2: evict candidates that cannot be in the (k+1)-core */
+    for (igraph_integer_t i = 0; i < queue_size; i++) {
+        igraph_integer_t v = queue[i];
+        const igraph_vector_int_t *neis = igraph_vector_int_list_get_ptr(&ic->adj, v);
+        igraph_integer_t nei_count = igraph_vector_int_size(neis);
+        for (igraph_integer_t j = 0; j < nei_count; j++) {
+            igraph_integer_t u = VECTOR(*neis)[j];
+            if (mark[u] == stamp) {
+                cd[u]--;
+                if (cd[u] <= k) {
+                    mark[u] = stamp + 1;
+                    queue[queue_size++] = u;
+                }
+            }
+        }
+    }
+
+    /* Phase 3: promote the remaining candidates */
+    for (igraph_integer_t i = 0; i < visited_count; i++) {
+        igraph_integer_t v = visited[i];
+        if (mark[v] == stamp) {
+            cores[v] = k + 1;
+        }
+    }
+}
+
+/* Called after the degree of some of the 'roots' has decreased, with k being
+ * the coreness of all of them. Demotes the vertices that are no longer part
+ * of the k-core to coreness k-1.
+ *
+ * Vertices are visited lazily, starting from the roots and continuing only
+ * from vertices that have been demoted. A demoted vertex keeps coreness k
+ * until its neighbors have been notified, so that the counts of vertices
+ * visited in the meantime stay consistent. Visited vertices are marked with
+ * 'stamp', demoted ones with 'stamp + 1'. */
+static void igraph_i_coreness_incremental_demote(
+        igraph_coreness_incremental_t *ic,
+        const igraph_integer_t *roots, igraph_integer_t root_count, igraph_integer_t k) {
+
+    igraph_integer_t *cores = VECTOR(ic->cores);
+    igraph_integer_t *cd = VECTOR(ic->cd);
+    igraph_integer_t *mark = VECTOR(ic->mark);
+    igraph_integer_t *queue = VECTOR(ic->queue);
+    igraph_integer_t queue_size = 0;
+    igraph_integer_t stamp;
+
+    ic->stamp += 2;
+    stamp = ic->stamp;
+
+    for (igraph_integer_t i = 0; i < root_count; i++) {
+        igraph_integer_t v = roots[i];
+        if (mark[v] != stamp && mark[v] != stamp + 1) {
+            cd[v] = igraph_i_coreness_incremental_cd(ic, v, k);
+            if (cd[v] < k) {
+                mark[v] = stamp + 1;
+                queue[queue_size++] = v;
+            } else {
+                mark[v] = stamp;
+            }
+        }
+    }
+
+    for (igraph_integer_t i = 0; i < queue_size; i++) {
+        igraph_integer_t v = queue[i];
+        const igraph_vector_int_t *neis = igraph_vector_int_list_get_ptr(&ic->adj, v);
+        igraph_integer_t nei_count = igraph_vector_int_size(neis);
+        for (igraph_integer_t j = 0; j < nei_count; j++) {
+            igraph_integer_t u = VECTOR(*neis)[j];
+            if (cores[u] != k || mark[u] == stamp + 1) {
+                continue;
+            }
+            if (mark[u] != stamp) {
+                mark[u] = stamp;
+                cd[u] = igraph_i_coreness_incremental_cd(ic, u, k);
+            }
+            cd[u]--;
+            if (cd[u] < k) {
+                mark[u] = stamp + 1;
+                queue[queue_size++] = u;
+            }
+        }
+        cores[v] = k - 1;
+    }
+}
+
+static igraph_error_t igraph_i_coreness_incremental_check_vid(
+        const igraph_coreness_incremental_t *ic, igraph_integer_t vid) {
+    if (vid < 0 || vid >= igraph_vector_int_size(&ic->cores)) {
+        IGRAPH_ERROR("Invalid vertex ID.", IGRAPH_EINVVID);
+    }
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_coreness_incremental_add_edge
+ * \brief Adds an edge and updates the coreness values.
+ *
+ * Only vertices whose coreness equals the smaller of the coreness values of
+ * the two endpoints, and which are connected to that endpoint through such
+ * vertices, may change; their coreness increases by at most one. When
+ * \p from and \p to are the same, a self-loop is added, which may increase
+ * the coreness of the affected vertices by up to two.
+ *
+ * \param ic The incremental coreness object.
+ * \param from The first endpoint of the new edge.
+ * \param to The second endpoint of the new edge.
+ * \return Error code.
+ *
+ * Time complexity: O(d(from) + d(to)) for storing the edge, plus the total
+ * degree of the vertices visited while updating the coreness values. In
+ * the worst case, this is O(|V|+|E|).
+ */
+igraph_error_t igraph_coreness_incremental_add_edge(
+        igraph_coreness_incremental_t *ic, igraph_integer_t from, igraph_integer_t to) {
+
+    igraph_vector_int_t *from_neis, *to_neis;
+    igraph_integer_t root, k;
+
+    IGRAPH_CHECK(igraph_i_coreness_incremental_check_vid(ic, from));
+    IGRAPH_CHECK(igraph_i_coreness_incremental_check_vid(ic, to));
+
+    from_neis = igraph_vector_int_list_get_ptr(&ic->adj, from);
+    to_neis = igraph_vector_int_list_get_ptr(&ic->adj, to);
+
+    /* Reserve first so that a failure leaves the object intact. */
+    IGRAPH_CHECK(igraph_vector_int_reserve(from_neis, igraph_vector_int_size(from_neis) + 2));
+    IGRAPH_CHECK(igraph_vector_int_reserve(to_neis, igraph_vector_int_size(to_neis) + 1));
+    igraph_vector_int_push_back(from_neis, to); /* reserved */
+    igraph_vector_int_push_back(to_neis, from); /* reserved */
+
+    root = VECTOR(ic->cores)[from] <= VECTOR(ic->cores)[to] ? from : to;
+    k = VECTOR(ic->cores)[root];
+    igraph_i_coreness_incremental_promote(ic, root, k);
+
+    /* A self-loop increases the degree by two, which is handled as two
+     * consecutive unit increases. */
+    if (from == to && VECTOR(ic->cores)[root] > k) {
+        igraph_i_coreness_incremental_promote(ic, root, k + 1);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Removes one occurrence of 'value' from 'v' by moving the last element into
+ * its place. Returns false if 'value' was not found. */
+static igraph_bool_t igraph_i_coreness_incremental_remove(
+        igraph_vector_int_t *v, igraph_integer_t value) {
+    igraph_integer_t n = igraph_vector_int_size(v);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        if (VECTOR(*v)[i] == value) {
+            VECTOR(*v)[i] = VECTOR(*v)[n - 1];
+            igraph_vector_int_pop_back(v);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \function igraph_coreness_incremental_delete_edge
+ * \brief Removes an edge and updates the coreness values.
+ *
+ * Only vertices whose coreness equals the smaller of the coreness values of
+ * the two endpoints, and which are connected to such an endpoint through
+ * such vertices, may change; their coreness decreases by at most one.
+ * When \p from and \p to are the same, a self-loop is removed, which may
+ * decrease the coreness of the affected vertices by up to two. If the two
+ * vertices are connected by multiple edges, only one of them is removed.
+ *
+ * \param ic The incremental coreness object.
+ * \param from The first endpoint of the edge.
+ * \param to The second endpoint of the edge.
+ * \return Error code. \c IGRAPH_EINVAL if there is no edge between the two
+ *         vertices.
+ *
+ * Time complexity: O(d(from) + d(to)) for locating the edge, plus the total
+ * degree of the vertices visited while updating the coreness values. In
+ * the worst case, this is O(|V|+|E|).
+ */
+igraph_error_t igraph_coreness_incremental_delete_edge(
+        igraph_coreness_incremental_t *ic, igraph_integer_t from, igraph_integer_t to) {
+
+    igraph_vector_int_t *from_neis, *to_neis;
+    igraph_integer_t roots[2], root_count, k;
+
+    IGRAPH_CHECK(igraph_i_coreness_incremental_check_vid(ic, from));
+    IGRAPH_CHECK(igraph_i_coreness_incremental_check_vid(ic, to));
+
+    from_neis = igraph_vector_int_list_get_ptr(&ic->adj, from);
+    to_neis = igraph_vector_int_list_get_ptr(&ic->adj, to);
+
+    if (!igraph_i_coreness_incremental_remove(from_neis, to)) {
+        IGRAPH_ERRORF("No edge between vertices %" IGRAPH_PRId " and %" IGRAPH_PRId ".",
+                      IGRAPH_EINVAL, from, to);
+    }
+    if (!igraph_i_coreness_incremental_remove(to_neis, from)) {
+        /* Every edge is stored in the neighbor lists of both of its endpoints,
+         * and self-loops are stored twice, so this is unreachable unless the
+         * adjacency list was corrupted. */
+        IGRAPH_FATAL("Corrupted adjacency list in incremental coreness calculation.");
+    }
+
+    k = VECTOR(ic->cores)[from] < VECTOR(ic->cores)[to] ? VECTOR(ic->cores)[from] : VECTOR(ic->cores)[to];
+    root_count = 0;
+    if (VECTOR(ic->cores)[from] == k) {
+        roots[root_count++] = from;
+    }
+    if (from != to && VECTOR(ic->cores)[to] == k) {
+        roots[root_count++] = to;
+    }
+    igraph_i_coreness_incremental_demote(ic, roots, root_count, k);
+
+    /* Removing a self-loop decreases the degree by two, which is handled
+     * as two consecutive unit decreases. */
+    if (from == to && VECTOR(ic->cores)[from] < k) {
+        igraph_i_coreness_incremental_demote(ic, roots, root_count, k - 1);
+    }
+
     return IGRAPH_SUCCESS;
 }
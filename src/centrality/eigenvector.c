@@ -27,60 +27,10 @@
 #include "igraph_topology.h"
 
 #include "centrality/centrality_internal.h"
+#include "linalg/spmv_internal.h"
 
 #include <limits.h>
 
-static igraph_error_t igraph_i_eigenvector_centrality(igraph_real_t *to, const igraph_real_t *from,
-                                           int n, void *extra) {
-    igraph_adjlist_t *adjlist = extra;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(adjlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += from[nei];
-        }
-    }
-
-
-    return IGRAPH_SUCCESS;
-}
-
-typedef struct igraph_i_eigenvector_centrality_t {
-    const igraph_t *graph;
-    const igraph_inclist_t *inclist;
-    const igraph_vector_t *weights;
-} igraph_i_eigenvector_centrality_t;
-
-static igraph_error_t igraph_i_eigenvector_centrality2(igraph_real_t *to, const igraph_real_t *from,
-                                            int n, void *extra) {
-
-    igraph_i_eigenvector_centrality_t *data = extra;
-    const igraph_t *graph = data->graph;
-    const igraph_inclist_t *inclist = data->inclist;
-    const igraph_vector_t *weights = data->weights;
-    igraph_vector_int_t *edges;
-    igraph_integer_t i, j, nlen;
-
-    for (i = 0; i < n; i++) {
-        edges = igraph_inclist_get(inclist, i);
-        nlen = igraph_vector_int_size(edges);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*edges)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            to[i] += w * from[nei];
-        }
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
 static igraph_error_t igraph_i_eigenvector_centrality_undirected(const igraph_t *graph, igraph_vector_t *vector,
                                                       igraph_real_t *value, igraph_bool_t scale,
                                                       const igraph_vector_t *weights,
@@ -164,35 +114,22 @@ static igraph_error_t igraph_i_eigenvector_centrality_undirected(const igraph_t
     options->which[0] = 'L'; options->which[1] = 'A';
     options->start = 1;   /* no random start vector */
 
-    if (!weights) {
-
-        igraph_adjlist_t adjlist;
-
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_eigenvector_centrality,
-                                           &adjlist, options, 0, &values, &vectors));
+    {
+        igraph_csr_adjlist_t adjlist;
+        igraph_i_csr_matrix_t A;
 
-        igraph_adjlist_destroy(&adjlist);
-        IGRAPH_FINALLY_CLEAN(1);
-
-    } else {
-
-        igraph_inclist_t inclist;
-        igraph_i_eigenvector_centrality_t data;
-
-        data.graph = graph;
-        data.inclist = &inclist;
-        data.weights = weights;
-
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+        if (weights) {
+            IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
+        } else {
+            IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
+        }
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+        igraph_i_csr_matrix_init(&A, &adjlist, weights);
 
-        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_eigenvector_centrality2,
-                                           &data, options, 0, &values, &vectors));
+        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_csr_arpack_cb,
+                                           &A, options, 0, &values, &vectors));
 
-        igraph_inclist_destroy(&inclist);
+        igraph_csr_adjlist_destroy(&adjlist);
         IGRAPH_FINALLY_CLEAN(1);
     }
 
@@ -355,33 +292,22 @@ static igraph_error_t igraph_i_eigenvector_centrality_directed(const igraph_t *g
     igraph_vector_destroy(&indegree);
     IGRAPH_FINALLY_CLEAN(1);
 
-    if (!weights) {
-        igraph_adjlist_t adjlist;
+    {
+        igraph_csr_adjlist_t adjlist;
+        igraph_i_csr_matrix_t A;
 
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-        IGRAPH_CHECK(igraph_arpack_rnsolve(igraph_i_eigenvector_centrality,
-                                           &adjlist, options, 0, &values,
-                                           &vectors));
-
-        igraph_adjlist_destroy(&adjlist);
-        IGRAPH_FINALLY_CLEAN(1);
-    } else {
-        igraph_inclist_t inclist;
-        igraph_i_eigenvector_centrality_t data;
-
-        data.graph = graph;
-        data.inclist = &inclist;
-        data.weights = weights;
-
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+        if (weights) {
+            IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &adjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
+        } else {
+            IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
+        }
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+        igraph_i_csr_matrix_init(&A, &adjlist, weights);
 
-        IGRAPH_CHECK(igraph_arpack_rnsolve(igraph_i_eigenvector_centrality2,
-                                           &data, options, 0, &values, &vectors));
+        IGRAPH_CHECK(igraph_arpack_rnsolve(igraph_i_csr_arpack_cb,
+                                           &A, options, 0, &values, &vectors));
 
-        igraph_inclist_destroy(&inclist);
+        igraph_csr_adjlist_destroy(&adjlist);
         IGRAPH_FINALLY_CLEAN(1);
     }
 
@@ -26,111 +26,27 @@
 #include "igraph_blas.h"
 
 #include "centrality/centrality_internal.h"
+#include "linalg/spmv_internal.h"
 
 #include <limits.h>
 
-/* struct for the unweighted variant of the HITS algorithm */
+/* struct for the HITS algorithm, the adjacency matrix and its transpose */
 typedef struct igraph_i_kleinberg_data_t {
-    igraph_adjlist_t *in;
-    igraph_adjlist_t *out;
+    igraph_i_csr_matrix_t in;
+    igraph_i_csr_matrix_t out;
     igraph_vector_t *tmp;
 } igraph_i_kleinberg_data_t;
 
-/* struct for the weighted variant of the HITS algorithm */
-typedef struct igraph_i_kleinberg_data2_t {
-    const igraph_t *graph;
-    igraph_inclist_t *in;
-    igraph_inclist_t *out;
-    igraph_vector_t *tmp;
-    const igraph_vector_t *weights;
-} igraph_i_kleinberg_data2_t;
-
-static igraph_error_t igraph_i_kleinberg_unweighted_hub_to_auth(
-        igraph_integer_t n, igraph_vector_t *to, const igraph_real_t *from,
-        igraph_adjlist_t *in) {
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(in, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*to)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            VECTOR(*to)[i] += from[nei];
-        }
-    }
-    return IGRAPH_SUCCESS;
-}
-
-/* ARPACK auxiliary routine for the unweighted HITS algorithm */
-static igraph_error_t igraph_i_kleinberg_unweighted(igraph_real_t *to,
+/* ARPACK auxiliary routine for the HITS algorithm */
+static igraph_error_t igraph_i_kleinberg(igraph_real_t *to,
                                          const igraph_real_t *from,
                                          int n, void *extra) {
     igraph_i_kleinberg_data_t *data = (igraph_i_kleinberg_data_t*)extra;
-    igraph_adjlist_t *out = data->out;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    igraph_i_kleinberg_unweighted_hub_to_auth(n, tmp, from, data->in);
-
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(out, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += VECTOR(*tmp)[nei];
-        }
-    }
-
-    return IGRAPH_SUCCESS;
-}
 
-static igraph_error_t igraph_i_kleinberg_weighted_hub_to_auth(igraph_integer_t n,
-        igraph_vector_t *to, const igraph_real_t *from, igraph_inclist_t *in,
-        const igraph_t *g, const igraph_vector_t *weights) {
-    igraph_vector_int_t *neis;
-    igraph_integer_t nlen, i, j;
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(in, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*to)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei_edge = VECTOR(*neis)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(g, nei_edge, i);
-            VECTOR(*to)[i] += from[nei] * VECTOR(*weights)[nei_edge];
-        }
-    }
-    return IGRAPH_SUCCESS;
-}
+    IGRAPH_UNUSED(n);
 
-/* ARPACK auxiliary routine for the weighted HITS algorithm */
-static igraph_error_t igraph_i_kleinberg_weighted(igraph_real_t *to,
-                                       const igraph_real_t *from,
-                                       int n, void *extra) {
-
-    igraph_i_kleinberg_data2_t *data = (igraph_i_kleinberg_data2_t*)extra;
-    igraph_inclist_t *out = data->out;
-    igraph_vector_t *tmp = data->tmp;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *g = data->graph;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    igraph_i_kleinberg_weighted_hub_to_auth(n, tmp, from, data->in, g, weights);
-
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(out, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei_edge = VECTOR(*neis)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(g, nei_edge, i);
-            to[i] += VECTOR(*tmp)[nei] * VECTOR(*weights)[nei_edge];
-        }
-    }
+    igraph_i_csr_spmv(&data->in, from, VECTOR(*data->tmp));
+    igraph_i_csr_spmv(&data->out, VECTOR(*data->tmp), to);
 
     return IGRAPH_SUCCESS;
 }
@@ -188,14 +104,12 @@ igraph_error_t igraph_hub_and_authority_scores(const igraph_t *graph,
         igraph_real_t *value, igraph_bool_t scale,
         const igraph_vector_t *weights, igraph_arpack_options_t *options) {
 
-    igraph_adjlist_t inadjlist, outadjlist;
-    igraph_inclist_t ininclist, outinclist;
+    igraph_csr_adjlist_t inadjlist, outadjlist;
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_vector_t tmp;
     igraph_vector_t values;
     igraph_matrix_t vectors;
     igraph_i_kleinberg_data_t extra;
-    igraph_i_kleinberg_data2_t extra2;
     igraph_integer_t i;
     igraph_vector_t *my_hub_vector_p;
     igraph_vector_t my_hub_vector;
@@ -264,15 +178,15 @@ igraph_error_t igraph_hub_and_authority_scores(const igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, options->n);
 
     if (weights == 0) {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &inadjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &inadjlist);
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &outadjlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &outadjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &inadjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inadjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &outadjlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &outadjlist);
     } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &ininclist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &ininclist);
-        IGRAPH_CHECK(igraph_inclist_init(graph, &outinclist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &outinclist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inadjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inadjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &outadjlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &outadjlist);
     }
 
     IGRAPH_CHECK(igraph_strength(graph, &tmp, igraph_vss_all(), IGRAPH_ALL, 0, 0));
@@ -284,21 +198,16 @@ igraph_error_t igraph_hub_and_authority_scores(const igraph_t *graph,
         }
     }
 
-    extra.in = &inadjlist; extra.out = &outadjlist; extra.tmp = &tmp;
-    extra2.in = &ininclist; extra2.out = &outinclist; extra2.tmp = &tmp;
-    extra2.graph = graph; extra2.weights = weights;
+    igraph_i_csr_matrix_init(&extra.in, &inadjlist, weights);
+    igraph_i_csr_matrix_init(&extra.out, &outadjlist, weights);
+    extra.tmp = &tmp;
 
     options->nev = 1;
     options->ncv = 0;   /* 0 means "automatic" in igraph_arpack_rssolve */
     options->which[0] = 'L'; options->which[1] = 'A';
 
-    if (weights == 0) {
-        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_kleinberg_unweighted, &extra,
-                                           options, 0, &values, &vectors));
-    } else {
-        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_kleinberg_weighted, &extra2,
-                                           options, 0, &values, &vectors));
-    }
+    IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_kleinberg, &extra,
+                                       options, 0, &values, &vectors));
 
 
     if (value) {
@@ -349,12 +258,7 @@ igraph_error_t igraph_hub_and_authority_scores(const igraph_t *graph,
     if (authority_vector) {
         igraph_real_t norm;
         IGRAPH_CHECK(igraph_vector_resize(authority_vector, no_of_nodes));
-        igraph_vector_null(authority_vector);
-        if (weights == 0) {
-            igraph_i_kleinberg_unweighted_hub_to_auth(no_of_nodes, authority_vector, &VECTOR(*my_hub_vector_p)[0], &inadjlist);
-        } else {
-            igraph_i_kleinberg_weighted_hub_to_auth(no_of_nodes, authority_vector, &VECTOR(*my_hub_vector_p)[0], &ininclist, graph, weights);
-        }
+        igraph_i_csr_spmv(&extra.in, VECTOR(*my_hub_vector_p), VECTOR(*authority_vector));
         if (!scale) {
             norm = 1.0 / igraph_blas_dnrm2(authority_vector);
         } else {
@@ -367,15 +271,9 @@ igraph_error_t igraph_hub_and_authority_scores(const igraph_t *graph,
         igraph_vector_destroy(&my_hub_vector);
         IGRAPH_FINALLY_CLEAN(1);
     }
-    if (weights == 0) {
-        igraph_adjlist_destroy(&outadjlist);
-        igraph_adjlist_destroy(&inadjlist);
-        IGRAPH_FINALLY_CLEAN(2);
-    } else {
-        igraph_inclist_destroy(&outinclist);
-        igraph_inclist_destroy(&ininclist);
-        IGRAPH_FINALLY_CLEAN(2);
-    }
+    igraph_csr_adjlist_destroy(&outadjlist);
+    igraph_csr_adjlist_destroy(&inadjlist);
+    IGRAPH_FINALLY_CLEAN(2);
     igraph_vector_destroy(&tmp);
     IGRAPH_FINALLY_CLEAN(1);
     return IGRAPH_SUCCESS;
@@ -26,6 +26,7 @@
 #include "igraph_structural.h"
 
 #include "centrality/prpack_internal.h"
+#include "linalg/spmv_internal.h"
 
 #include <limits.h>
 
@@ -38,36 +39,22 @@ static igraph_error_t igraph_i_personalized_pagerank_arpack(const igraph_t *grap
                                                  igraph_arpack_options_t *options);
 
 typedef struct igraph_i_pagerank_data_t {
-    const igraph_t *graph;
-    igraph_adjlist_t *adjlist;
-    igraph_real_t damping;
+    igraph_i_csr_matrix_t A;
     igraph_vector_t *outdegree;
     igraph_vector_t *tmp;
     igraph_vector_t *reset;
 } igraph_i_pagerank_data_t;
 
-typedef struct igraph_i_pagerank_data2_t {
-    const igraph_t *graph;
-    igraph_inclist_t *inclist;
-    const igraph_vector_t *weights;
-    igraph_real_t damping;
-    igraph_vector_t *outdegree;
-    igraph_vector_t *tmp;
-    igraph_vector_t *reset;
-} igraph_i_pagerank_data2_t;
-
 static igraph_error_t igraph_i_pagerank(igraph_real_t *to, const igraph_real_t *from,
                              int n, void *extra) {
 
     igraph_i_pagerank_data_t *data = extra;
-    igraph_adjlist_t *adjlist = data->adjlist;
     igraph_vector_t *outdegree = data->outdegree;
     igraph_vector_t *tmp = data->tmp;
     igraph_vector_t *reset = data->reset;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
+    igraph_integer_t i;
     igraph_real_t sumfrom = 0.0;
-    igraph_real_t fact = 1 - data->damping;
+    igraph_real_t fact = 1 - data->A.alpha;
 
     /* Calculate p(x) / outdegree(x) in advance for all the vertices.
      * Note that we may divide by zero here; this is intentional since
@@ -85,17 +72,9 @@ static igraph_error_t igraph_i_pagerank(igraph_real_t *to, const igraph_real_t *
     }
 
     /* Here we calculate the part of the `to` vector that results from
-     * moving along links (and not from teleportation) */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(adjlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += VECTOR(*tmp)[nei];
-        }
-        to[i] *= data->damping;
-    }
+     * moving along links (and not from teleportation). The alpha of the
+     * matrix is the damping factor. */
+    igraph_i_csr_spmv(&data->A, VECTOR(*tmp), to);
 
     /* Now we add the contribution from random jumps. `reset` is a vector
      * that defines the probability of ending up in vertex i after a jump.
@@ -121,17 +100,13 @@ static igraph_error_t igraph_i_pagerank(igraph_real_t *to, const igraph_real_t *
 static igraph_error_t igraph_i_pagerank2(igraph_real_t *to, const igraph_real_t *from,
                               int n, void *extra) {
 
-    igraph_i_pagerank_data2_t *data = extra;
-    const igraph_t *graph = data->graph;
-    igraph_inclist_t *inclist = data->inclist;
-    const igraph_vector_t *weights = data->weights;
+    igraph_i_pagerank_data_t *data = extra;
     igraph_vector_t *outdegree = data->outdegree;
     igraph_vector_t *tmp = data->tmp;
     igraph_vector_t *reset = data->reset;
-    igraph_integer_t i, j, nlen;
+    igraph_integer_t i;
     igraph_real_t sumfrom = 0.0;
-    igraph_vector_int_t *neis;
-    igraph_real_t fact = 1 - data->damping;
+    igraph_real_t fact = 1 - data->A.alpha;
 
     /*
     printf("PageRank weighted: multiplying vector: ");
@@ -153,17 +128,7 @@ static igraph_error_t igraph_i_pagerank2(igraph_real_t *to, const igraph_real_t
         }
     }
 
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(inclist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*neis)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            to[i] += VECTOR(*weights)[edge] * VECTOR(*tmp)[nei];
-        }
-        to[i] *= data->damping;
-    }
+    igraph_i_csr_spmv(&data->A, VECTOR(*tmp), to);
 
     /* printf("sumfrom = %.6f\n", (float)sumfrom); */
 
@@ -609,45 +574,42 @@ static igraph_error_t igraph_i_personalized_pagerank_arpack(const igraph_t *grap
 
     if (!weights) {
 
-        igraph_adjlist_t adjlist;
+        igraph_csr_adjlist_t adjlist;
         igraph_i_pagerank_data_t data;
 
-        data.graph = graph;
-        data.adjlist = &adjlist;
-        data.damping = damping;
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, dirmode, IGRAPH_LOOPS, IGRAPH_MULTIPLE));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+
+        igraph_i_csr_matrix_init(&data.A, &adjlist, NULL);
+        data.A.alpha = damping;
         data.outdegree = &outdegree;
         data.tmp = &tmp;
         data.reset = reset ? &normalized_reset : NULL;
 
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, dirmode, IGRAPH_LOOPS, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
         IGRAPH_CHECK(igraph_arpack_rnsolve(igraph_i_pagerank,
                                            &data, options, NULL, &values, &vectors));
 
-        igraph_adjlist_destroy(&adjlist);
+        igraph_csr_adjlist_destroy(&adjlist);
         IGRAPH_FINALLY_CLEAN(1);
 
     } else {
 
-        igraph_inclist_t inclist;
-        igraph_i_pagerank_data2_t data;
+        igraph_csr_adjlist_t inclist;
+        igraph_i_pagerank_data_t data;
+
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inclist, dirmode, IGRAPH_LOOPS));
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inclist);
 
-        data.graph = graph;
-        data.inclist = &inclist;
-        data.weights = weights;
-        data.damping = damping;
+        igraph_i_csr_matrix_init(&data.A, &inclist, weights);
+        data.A.alpha = damping;
         data.outdegree = &outdegree;
         data.tmp = &tmp;
         data.reset = reset ? &normalized_reset : NULL;
 
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, dirmode, IGRAPH_LOOPS));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-
         IGRAPH_CHECK(igraph_arpack_rnsolve(igraph_i_pagerank2,
                                            &data, options, NULL, &values, &vectors));
 
-        igraph_inclist_destroy(&inclist);
+        igraph_csr_adjlist_destroy(&inclist);
         IGRAPH_FINALLY_CLEAN(1);
     }
 
@@ -25,178 +25,293 @@
 
 */
 
-#include <vector>
-#include <unordered_set>
+#include <algorithm>
 
 #include "igraph_community.h"
 
 #include "igraph_adjlist.h"
 #include "igraph_error.h"
 #include "igraph_interface.h"
-#include "igraph_motifs.h"
+#include "igraph_memory.h"
 #include "igraph_structural.h"
 
-#include "core/exceptions.h"
 #include "core/interruption.h"
-
-using std::vector;
-using std::unordered_set;
-
-
-// Unpack the triangles as a vector of vertices to be a vector of edges.
-// So, instead of the triangle specified as vertices [1, 2, 3], return the
-// edges as [1, 2, 1, 3, 2, 3] so that the support can be computed.
-static igraph_error_t igraph_truss_i_unpack(const igraph_vector_int_t *tri, igraph_vector_int_t *unpacked_tri) {
-    igraph_integer_t num_triangles = igraph_vector_int_size(tri);
-
-    IGRAPH_CHECK(igraph_vector_int_resize(unpacked_tri, 2 * num_triangles));
-
-    for (igraph_integer_t i = 0, j = 0; i < num_triangles; i += 3, j += 6) {
-        VECTOR(*unpacked_tri)[j]   = VECTOR(*unpacked_tri)[j+2] = VECTOR(*tri)[i];
-        VECTOR(*unpacked_tri)[j+1] = VECTOR(*unpacked_tri)[j+4] = VECTOR(*tri)[i+1];
-        VECTOR(*unpacked_tri)[j+3] = VECTOR(*unpacked_tri)[j+5] = VECTOR(*tri)[i+2];
+#include "core/parallel.h"
+#include "properties/properties_internal.h"
+
+// Graphs with fewer edges than this are always peeled sequentially.
+#define IGRAPH_I_TRUSS_PARALLEL_MIN_EDGES 16384
+
+// Calls f(e1, e2) for each triangle containing the edge between u and v,
+// where e1 and e2 are the IDs of the other two edges of the triangle.
+// Loop edges are not part of any triangle.
+// Neighbor lists in 'inclist' are sorted, so their intersection is found by
+// merging them, or by binary searches in the longer list if the lengths are
+// very different.
+template <typename F>
+static inline void igraph_i_truss_for_each_triangle(
+        const igraph_csr_adjlist_t *inclist, igraph_integer_t u, igraph_integer_t v, F f) {
+
+    if (u == v) {
+        return;
     }
 
-    return IGRAPH_SUCCESS;
-}
-
+    igraph_integer_t du = igraph_csr_adjlist_degree(inclist, u);
+    igraph_integer_t dv = igraph_csr_adjlist_degree(inclist, v);
+    if (du > dv) {
+        std::swap(u, v);
+        std::swap(du, dv);
+    }
 
-// Compute the edge support, i.e. number of triangles each edge occurs in.
-// Time complexity: O(m), where m is the number of edges listed in eid.
-static void igraph_truss_i_compute_support(const igraph_vector_int_t *eid, igraph_vector_int_t *support) {
-    igraph_integer_t m = igraph_vector_int_size(eid);
-    for (igraph_integer_t i = 0; i < m; ++i) {
-        VECTOR(*support)[VECTOR(*eid)[i]] += 1;
+    const igraph_integer_t *nu = igraph_csr_adjlist_get(inclist, u);
+    const igraph_integer_t *eu = igraph_csr_adjlist_get_eids(inclist, u);
+    const igraph_integer_t *nv = igraph_csr_adjlist_get(inclist, v);
+    const igraph_integer_t *ev = igraph_csr_adjlist_get_eids(inclist, v);
+
+    if (du * 16 < dv) {
+        const igraph_integer_t *lo = nv, *end = nv + dv;
+        for (igraph_integer_t i = 0; i < du && lo < end; i++) {
+            lo = std::lower_bound(lo, end, nu[i]);
+            if (lo < end && *lo == nu[i]) {
+                f(eu[i], ev[lo - nv]);
+                lo++;
+            }
+        }
+    } else {
+        igraph_integer_t i = 0, j = 0;
+        while (i < du && j < dv) {
+            if (nu[i] < nv[j]) {
+                i++;
+            } else if (nu[i] > nv[j]) {
+                j++;
+            } else {
+                f(eu[i], ev[j]);
+                i++; j++;
+            }
+        }
     }
 }
 
+// Sequential peeling, following Algorithm 2 of Wang and Cheng. Edges are kept
+// in an array sorted by their current support, with the bucket boundaries in
+// 'bin', in the same way as vertices are kept in igraph_coreness(). Decreasing
+// the support of an edge moves it to the front of its bucket in O(1) time.
+static igraph_error_t igraph_i_trussness_sequential(
+        const igraph_t *graph, const igraph_csr_adjlist_t *inclist,
+        igraph_vector_int_t *support, igraph_vector_int_t *trussness) {
 
-/* internal function doing the computations once the support is defined */
-static igraph_error_t igraph_i_trussness(const igraph_t *graph, igraph_vector_int_t *support,
-                                         igraph_vector_int_t *trussness) {
-    IGRAPH_HANDLE_EXCEPTIONS_BEGIN;
-
-    igraph_adjlist_t adjlist;
-    igraph_vector_int_t commonNeighbors;
-    igraph_vector_bool_t completed;
-
-    // C++ data structures
-    vector< unordered_set<igraph_integer_t> > vec;
-
-    // Allocate memory for result
     igraph_integer_t no_of_edges = igraph_vector_int_size(support);
-    IGRAPH_CHECK(igraph_vector_int_resize(trussness, no_of_edges));
-    if (no_of_edges == 0) {
-        return IGRAPH_SUCCESS;
-    }
-
-    // Get max possible value = max entry in support.
-    // This cannot be computed if there are no edges, hence the above check
+    igraph_integer_t *sup = VECTOR(*support);
     igraph_integer_t max = igraph_vector_int_max(support);
+    igraph_integer_t *bin, *sorted, *pos;
+    igraph_vector_bool_t completed;
 
-    // Initialize completed edges.
     IGRAPH_VECTOR_BOOL_INIT_FINALLY(&completed, no_of_edges);
+    bin = IGRAPH_CALLOC(max + 1, igraph_integer_t);
+    IGRAPH_CHECK_OOM(bin, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, bin);
+    sorted = IGRAPH_CALLOC(no_of_edges, igraph_integer_t);
+    IGRAPH_CHECK_OOM(sorted, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, sorted);
+    pos = IGRAPH_CALLOC(no_of_edges, igraph_integer_t);
+    IGRAPH_CHECK_OOM(pos, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, pos);
+
+    // Bucket sort the edges by support.
+    for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+        bin[sup[i]]++;
+    }
+    for (igraph_integer_t i = 0, start = 0; i <= max; i++) {
+        igraph_integer_t count = bin[i];
+        bin[i] = start;
+        start += count;
+    }
+    for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+        pos[i] = bin[sup[i]]++;
+        sorted[pos[i]] = i;
+    }
+    for (igraph_integer_t i = max; i > 0; i--) {
+        bin[i] = bin[i - 1];
+    }
+    bin[0] = 0;
 
-    // The vector of levels. Each level of the vector is a set of edges initially
-    // at that level of support, where support is # of triangles the edge is in.
-    vec.resize(max + 1);
+    for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+        igraph_integer_t seed = sorted[i];
+        igraph_integer_t level = sup[seed];
 
-    // Add each edge to its appropriate level of support.
-    for (igraph_integer_t i = 0; i < no_of_edges; ++i) {
-        vec[VECTOR(*support)[i]].insert(i);  // insert edge i into its support level
-    }
+        if (i % 4096 == 0) {
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+
+        auto demote = [&](igraph_integer_t e) {
+            igraph_integer_t se = sup[e];
+            if (se > level) {
+                igraph_integer_t pe = pos[e];
+                igraph_integer_t pw = bin[se];
+                igraph_integer_t w = sorted[pw];
+                if (e != w) {
+                    pos[e] = pw;
+                    pos[w] = pe;
+                    sorted[pe] = w;
+                    sorted[pw] = e;
+                }
+                bin[se]++;
+                sup[e]--;
+            }
+        };
+
+        igraph_i_truss_for_each_triangle(
+            inclist, IGRAPH_FROM(graph, seed), IGRAPH_TO(graph, seed),
+            [&](igraph_integer_t e1, igraph_integer_t e2) {
+                if (!VECTOR(completed)[e1] && !VECTOR(completed)[e2]) {
+                    demote(e1);
+                    demote(e2);
+                }
+            });
 
-    // Record the trussness of edges at level 0. These edges are not part
-    // of any triangles, so there's not much to do and we "complete" them
-    for (auto edge : vec[0]) {
-        VECTOR(*trussness)[edge] = 2;
-        VECTOR(completed)[edge] = true;
+        VECTOR(*trussness)[seed] = level + 2;
+        VECTOR(completed)[seed] = true;
     }
 
-    // Initialize variables needed below.
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&commonNeighbors, 0);
+    IGRAPH_FREE(pos);
+    IGRAPH_FREE(sorted);
+    IGRAPH_FREE(bin);
+    igraph_vector_bool_destroy(&completed);
+    IGRAPH_FINALLY_CLEAN(4);
 
-    // Move through the levels, one level at a time, starting at first level.
-    for (igraph_integer_t level = 1; level <= max; ++level) {
+    return IGRAPH_SUCCESS;
+}
 
-        /* Track down edges one at a time */
-        while (!vec[level].empty()) {
-            IGRAPH_ALLOW_INTERRUPTION();
+#ifdef IGRAPH_I_PARALLEL
+
+// Level-synchronous parallel peeling, following the PKT algorithm of
+// Kabir and Madduri: Shared-memory graph truss decomposition (2017).
+// All edges whose support equals the current level are removed at once.
+// Supports are decremented atomically, and never below the current level.
+// When two edges of a triangle are removed in the same round, only the one
+// with the smaller ID updates the third edge.
+static igraph_error_t igraph_i_trussness_parallel(
+        const igraph_t *graph, const igraph_csr_adjlist_t *inclist,
+        igraph_vector_int_t *support, igraph_vector_int_t *trussness) {
+
+    enum : char { ACTIVE = 0, CURRENT = 1, DONE = 2 };
 
-            igraph_integer_t seed = *vec[level].begin();  // pull out the first edge
-            vec[level].erase(seed);  // remove the first element
-
-            /* Find the vertices of this edge */
-            igraph_integer_t fromVertex = IGRAPH_FROM(graph, seed);
-            igraph_integer_t toVertex = IGRAPH_TO(graph, seed);
-
-            /* Find neighbors of both vertices. If they run into each other,
-             * there is a triangle. We rely on the neighbor lists being sorted,
-             * as guaranteed by igraph_adjlist_init(), when computing intersections. */
-            igraph_vector_int_t *fromNeighbors = igraph_adjlist_get(&adjlist, fromVertex);
-            igraph_vector_int_t *toNeighbors = igraph_adjlist_get(&adjlist, toVertex);
-            igraph_vector_int_t *q1 = fromNeighbors;
-            igraph_vector_int_t *q2 = toNeighbors;
-
-            if (igraph_vector_int_size(q1) > igraph_vector_int_size(q2)) {
-                // case: #fromNeighbors > #toNeigbors, so make q1 the smaller set.
-                q1 = toNeighbors;
-                q2 = fromNeighbors;
+    igraph_integer_t no_of_edges = igraph_vector_int_size(support);
+    igraph_integer_t *sup = VECTOR(*support);
+    igraph_integer_t *curr, *next, *tmp;
+    igraph_integer_t curr_size, next_size;
+    igraph_integer_t processed = 0, level = 0;
+    char *state;
+
+    state = IGRAPH_CALLOC(no_of_edges, char);
+    IGRAPH_CHECK_OOM(state, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, state);
+    curr = IGRAPH_CALLOC(no_of_edges, igraph_integer_t);
+    IGRAPH_CHECK_OOM(curr, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, curr);
+    next = IGRAPH_CALLOC(no_of_edges, igraph_integer_t);
+    IGRAPH_CHECK_OOM(next, "Insufficient memory for trussness calculation.");
+    IGRAPH_FINALLY(igraph_free, next);
+
+    while (processed < no_of_edges) {
+        igraph_integer_t min_sup = IGRAPH_INTEGER_MAX;
+
+        // Find the next non-empty level.
+#pragma omp parallel for reduction(min:min_sup)
+        for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+            if (state[i] == ACTIVE && sup[i] < min_sup) {
+                min_sup = sup[i];
+            }
+        }
+        level = min_sup;
+
+        curr_size = 0;
+#pragma omp parallel for
+        for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+            if (state[i] == ACTIVE && sup[i] == level) {
+                igraph_integer_t idx;
+#pragma omp atomic capture
+                idx = curr_size++;
+                curr[idx] = i;
             }
+        }
 
-            // Intersect the neighbors.
-            IGRAPH_CHECK(igraph_vector_int_intersect_sorted(q1, q2, &commonNeighbors));
-
-            /* Go over the overlapping neighbors and check each */
-            igraph_integer_t ncommon = igraph_vector_int_size(&commonNeighbors);
-            for (igraph_integer_t j = 0; j < ncommon; j++) {
-                igraph_integer_t n = VECTOR(commonNeighbors)[j];  // the common neighbor
-                igraph_integer_t e1, e2;
-                IGRAPH_CHECK(igraph_get_eid(graph, &e1, fromVertex, n, IGRAPH_UNDIRECTED, /* error= */ true));
-                IGRAPH_CHECK(igraph_get_eid(graph, &e2, toVertex, n, IGRAPH_UNDIRECTED, /* error= */ true));
-
-                bool e1_complete = VECTOR(completed)[e1];
-                bool e2_complete = VECTOR(completed)[e2];
-
-                if (!e1_complete && !e2_complete) {
-                    igraph_integer_t newLevel;
-
-                    // Demote this edge, if higher than current level.
-                    if (VECTOR(*support)[e1] > level) {
-                        VECTOR(*support)[e1] -= 1;  // decrement the level
-                        newLevel = VECTOR(*support)[e1];
-                        vec[newLevel].insert(e1);
-                        vec[newLevel + 1].erase(e1);  // the old level
-                    }
-                    // Demote this edge, if higher than current level.
-                    if (VECTOR(*support)[e2] > level) {
-                        VECTOR(*support)[e2] -= 1;  // decrement the level
-                        newLevel = VECTOR(*support)[e2];
-                        vec[newLevel].insert(e2);
-                        vec[newLevel + 1].erase(e2);  // the old level
+        while (curr_size > 0) {
+            processed += curr_size;
+            next_size = 0;
+
+#pragma omp parallel for
+            for (igraph_integer_t i = 0; i < curr_size; i++) {
+                state[curr[i]] = CURRENT;
+            }
+
+#pragma omp parallel for schedule(dynamic, 16)
+            for (igraph_integer_t i = 0; i < curr_size; i++) {
+                igraph_integer_t seed = curr[i];
+
+                auto demote = [&](igraph_integer_t e) {
+                    igraph_integer_t se;
+#pragma omp atomic read
+                    se = sup[e];
+                    if (se > level) {
+#pragma omp atomic capture
+                        se = sup[e]--;
+                        if (se == level + 1) {
+                            igraph_integer_t idx;
+#pragma omp atomic capture
+                            idx = next_size++;
+                            next[idx] = e;
+                        } else if (se <= level) {
+#pragma omp atomic
+                            sup[e]++;
+                        }
                     }
-                }
+                };
+
+                igraph_i_truss_for_each_triangle(
+                    inclist, IGRAPH_FROM(graph, seed), IGRAPH_TO(graph, seed),
+                    [&](igraph_integer_t e1, igraph_integer_t e2) {
+                        char s1 = state[e1], s2 = state[e2];
+                        if (s1 == DONE || s2 == DONE) {
+                            return;
+                        }
+                        if (s1 == ACTIVE && s2 == ACTIVE) {
+                            demote(e1);
+                            demote(e2);
+                        } else if (s1 == ACTIVE) {
+                            if (seed < e2) {
+                                demote(e1);
+                            }
+                        } else if (s2 == ACTIVE) {
+                            if (seed < e1) {
+                                demote(e2);
+                            }
+                        }
+                    });
             }
-            // Record this edge; its level is its trussness.
-            VECTOR(*trussness)[seed] = level + 2;
-            VECTOR(completed)[seed] = true; // mark as complete
-            igraph_vector_int_clear(&commonNeighbors);
-        }  // end while
-    }  // end for-loop over levels
-
-    // Clean up.
-    igraph_vector_int_destroy(&commonNeighbors);
-    igraph_adjlist_destroy(&adjlist);
-    igraph_vector_bool_destroy(&completed);
+
+#pragma omp parallel for
+            for (igraph_integer_t i = 0; i < curr_size; i++) {
+                state[curr[i]] = DONE;
+                VECTOR(*trussness)[curr[i]] = level + 2;
+            }
+
+            tmp = curr; curr = next; next = tmp;
+            curr_size = next_size;
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    IGRAPH_FREE(next);
+    IGRAPH_FREE(curr);
+    IGRAPH_FREE(state);
     IGRAPH_FINALLY_CLEAN(3);
 
     return IGRAPH_SUCCESS;
-
-    IGRAPH_HANDLE_EXCEPTIONS_END;
 }
 
+#endif // IGRAPH_I_PARALLEL
 
 /**
  * \function igraph_trussness
@@ -220,6 +335,12 @@ static igraph_error_t igraph_i_trussness(const igraph_t *graph, igraph_vector_in
  * calling this function.
  *
  * </para><para>
+ * When igraph is compiled with OpenMP support, the initial support of the
+ * edges is computed in parallel, and for large graphs the edges are also
+ * removed level by level using multiple threads, following the PKT algorithm
+ * of Kabir and Madduri. The result does not depend on the number of threads.
+ *
+ * </para><para>
  * Reference:
  *
  * </para><para>
@@ -228,6 +349,12 @@ static igraph_error_t igraph_i_trussness(const igraph_t *graph, igraph_vector_in
  * Proceedings of the VLDB Endowment 5.9 (2012): 812-823.
  * https://doi.org/10.14778/2311906.2311909
  *
+ * </para><para>
+ * Humayun Kabir and Kamesh Madduri: Shared-memory graph truss decomposition.
+ * 2017 IEEE 24th International Conference on High Performance Computing
+ * (HiPC), 13-22.
+ * https://doi.org/10.1109/HiPC.2017.00012
+ *
  * \param graph The input graph. Loop edges are allowed; multigraphs are not.
  * \param truss Pointer to initialized vector of truss values that will
  * indicate the highest k-truss each edge occurs in. It will be resized as
@@ -237,7 +364,9 @@ static igraph_error_t igraph_i_trussness(const igraph_t *graph, igraph_vector_in
  * Time complexity: It should be O(|E|^1.5) according to the reference.
  */
 igraph_error_t igraph_trussness(const igraph_t* graph, igraph_vector_int_t* trussness) {
-    igraph_vector_int_t triangles, support, unpacked_triangles, eid;
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_csr_adjlist_t inclist;
+    igraph_vector_int_t support;
     igraph_bool_t is_multigraph;
 
     /* Check whether the graph is a multigraph; trussness will not work for these */
@@ -251,36 +380,33 @@ igraph_error_t igraph_trussness(const igraph_t* graph, igraph_vector_int_t* trus
         IGRAPH_ERROR("Trussness is not implemented for graph with multi-edges.", IGRAPH_UNIMPLEMENTED);
     }
 
-    /* Manage the stack to make it memory safe: do not change the order of
-     * initialization of the following four vectors */
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&support, igraph_ecount(graph));
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&eid, 0);
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&unpacked_triangles, 0);
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&triangles, 0);
-
-    // List the triangles as vertex triplets.
-    IGRAPH_CHECK(igraph_list_triangles(graph, &triangles));
-
-    // Unpack the triangles from vertex list to edge list.
-    IGRAPH_CHECK(igraph_truss_i_unpack(&triangles, &unpacked_triangles));
-    igraph_vector_int_destroy(&triangles);
-    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_CHECK(igraph_vector_int_resize(trussness, no_of_edges));
+    if (no_of_edges == 0) {
+        return IGRAPH_SUCCESS;
+    }
 
-    // Get the edge IDs of the unpacked triangles. Note: a given eid can occur
-    // multiple times in this list if it is in multiple triangles.
-    IGRAPH_CHECK(igraph_get_eids(graph, &eid, &unpacked_triangles, /* directed = */ false, /* error = */ true));
-    igraph_vector_int_destroy(&unpacked_triangles);
-    IGRAPH_FINALLY_CLEAN(1);
+    /* Loop edges are not part of any triangles, and they are left out of
+     * the incidence list. Their support stays zero. */
+    IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inclist, IGRAPH_ALL, IGRAPH_NO_LOOPS));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inclist);
 
-    // Compute the support of the edges.
-    igraph_truss_i_compute_support(&eid, &support);
-    igraph_vector_int_destroy(&eid);
-    IGRAPH_FINALLY_CLEAN(1);
+    // Compute the support of the edges, i.e. the number of triangles they are in.
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&support, no_of_edges);
+    IGRAPH_CHECK(igraph_i_triangle_support(&inclist, no_of_edges, &support, NULL));
 
     // Compute the trussness of the edges.
-    IGRAPH_CHECK(igraph_i_trussness(graph, &support, trussness));
+#ifdef IGRAPH_I_PARALLEL
+    if (no_of_edges >= IGRAPH_I_TRUSS_PARALLEL_MIN_EDGES && igraph_i_parallel_max_threads() > 1) {
+        IGRAPH_CHECK(igraph_i_trussness_parallel(graph, &inclist, &support, trussness));
+    } else
+#endif
+    {
+        IGRAPH_CHECK(igraph_i_trussness_sequential(graph, &inclist, &support, trussness));
+    }
+
     igraph_vector_int_destroy(&support);
-    IGRAPH_FINALLY_CLEAN(1);
+    igraph_csr_adjlist_destroy(&inclist);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -34,8 +34,18 @@
 
 #include "core/indheap.h"
 #include "core/interruption.h"
+#include "core/parallel.h"
 
-#include <string.h>
+#include <math.h>
+
+/* Edge betweenness scores closer than this (relative) tolerance are treated
+ * as equal when choosing the edge to remove. */
+#define IGRAPH_I_EB_TOLERANCE 1e-10
+
+/* The maximum number of lanes in which the contributions of the sources are
+ * added up, and the maximum number of partial scores that they may use. */
+#define IGRAPH_I_EB_MAX_LANES 32
+#define IGRAPH_I_EB_LANE_BUDGET (1 << 22)
 
 static igraph_error_t igraph_i_rewrite_membership_vector(igraph_vector_int_t *membership) {
     const igraph_integer_t no = igraph_vector_int_max(membership) + 1;
@@ -315,26 +325,528 @@ igraph_error_t igraph_community_eb_get_merges(const igraph_t *graph,
 
     return IGRAPH_SUCCESS;
 }
-
-/* Find the smallest active element in the vector */
+/* Find the largest active element in the vector. The values are sums of the
+ * contributions of many sources, which may have been added up in a different
+ * order for different edges, so values that are equal up to rounding errors
+ * are treated as ties. Ties are broken in favour of the smallest index. */
 static igraph_integer_t igraph_i_vector_which_max_not_null(const igraph_vector_t *v,
                                                    const bool *passive) {
-    igraph_integer_t which, i = 0, size = igraph_vector_size(v);
-    igraph_real_t max;
+    igraph_integer_t first, i = 0, size = igraph_vector_size(v);
+    igraph_real_t max, threshold;
     while (passive[i]) {
         i++;
     }
-    which = i;
-    max = VECTOR(*v)[which];
+    first = i;
+    max = VECTOR(*v)[first];
     for (i++; i < size; i++) {
         igraph_real_t elem = VECTOR(*v)[i];
         if (!passive[i] && elem > max) {
             max = elem;
-            which = i;
         }
     }
 
-    return which;
+    threshold = max - (fabs(max) + 1) * IGRAPH_I_EB_TOLERANCE;
+    for (i = first; i < size; i++) {
+        if (!passive[i] && VECTOR(*v)[i] >= threshold) {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* Workspace of a thread for the shortest path searches from single sources.
+ * 'distance', 'nrgeo' and 'tmpscore' are kept zero between searches. */
+typedef struct {
+    igraph_real_t *distance, *nrgeo, *tmpscore;
+    igraph_stack_int_t stack;
+    igraph_dqueue_int_t q;         /* unweighted only */
+    igraph_2wheap_t heap;          /* weighted only */
+    igraph_inclist_t parents;      /* weighted only */
+    igraph_bool_t weighted;
+} igraph_i_eb_workspace_t;
+
+static void igraph_i_eb_workspace_destroy(igraph_i_eb_workspace_t *ws) {
+    if (ws->weighted) {
+        igraph_inclist_destroy(&ws->parents);
+        igraph_2wheap_destroy(&ws->heap);
+    } else {
+        igraph_dqueue_int_destroy(&ws->q);
+    }
+    igraph_stack_int_destroy(&ws->stack);
+    IGRAPH_FREE(ws->tmpscore);
+    IGRAPH_FREE(ws->nrgeo);
+    IGRAPH_FREE(ws->distance);
+}
+
+static igraph_error_t igraph_i_eb_workspace_init(igraph_i_eb_workspace_t *ws,
+                                                 igraph_integer_t no_of_nodes,
+                                                 igraph_bool_t weighted) {
+    ws->weighted = weighted;
+
+    ws->distance = IGRAPH_CALLOC(no_of_nodes, igraph_real_t);
+    IGRAPH_CHECK_OOM(ws->distance, "Insufficient memory for edge betweenness-based community detection.");
+    IGRAPH_FINALLY(igraph_free, ws->distance);
+
+    ws->nrgeo = IGRAPH_CALLOC(no_of_nodes, igraph_real_t);
+    IGRAPH_CHECK_OOM(ws->nrgeo, "Insufficient memory for edge betweenness-based community detection.");
+    IGRAPH_FINALLY(igraph_free, ws->nrgeo);
+
+    ws->tmpscore = IGRAPH_CALLOC(no_of_nodes, igraph_real_t);
+    IGRAPH_CHECK_OOM(ws->tmpscore, "Insufficient memory for edge betweenness-based community detection.");
+    IGRAPH_FINALLY(igraph_free, ws->tmpscore);
+
+    IGRAPH_STACK_INT_INIT_FINALLY(&ws->stack, no_of_nodes);
+
+    if (weighted) {
+        IGRAPH_CHECK(igraph_2wheap_init(&ws->heap, no_of_nodes));
+        IGRAPH_FINALLY(igraph_2wheap_destroy, &ws->heap);
+        IGRAPH_CHECK(igraph_inclist_init_empty(&ws->parents, no_of_nodes));
+        IGRAPH_FINALLY_CLEAN(5);
+    } else {
+        IGRAPH_CHECK(igraph_dqueue_int_init(&ws->q, 100));
+        IGRAPH_FINALLY_CLEAN(4);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* The state of the algorithm that is needed to recompute the edge betweenness
+ * scores after an edge was removed. */
+typedef struct {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_inclist_t *elist_out, *elist_in;   /* only contain the active edges */
+    igraph_integer_t no_of_workspaces;
+    igraph_i_eb_workspace_t *workspaces;      /* one for each thread */
+    igraph_matrix_t lane_eb;                  /* partial scores, one column per lane */
+    igraph_vector_int_t sources;              /* the sources to process */
+} igraph_i_eb_state_t;
+
+/* Adds 'sign' times the contribution of the shortest paths starting at
+ * 'source' to the edge betweenness scores in 'eb'. */
+static igraph_error_t igraph_i_eb_source(const igraph_i_eb_state_t *state,
+                                         igraph_i_eb_workspace_t *ws,
+                                         igraph_integer_t source,
+                                         igraph_real_t sign, igraph_real_t *eb) {
+    const igraph_t *graph = state->graph;
+    const igraph_vector_t *weights = state->weights;
+    igraph_real_t *distance = ws->distance, *nrgeo = ws->nrgeo, *tmpscore = ws->tmpscore;
+    igraph_vector_int_t *neip;
+    igraph_integer_t neino;
+
+    if (weights == NULL) {
+        /* Unweighted variant follows */
+
+        /* The following is copied almost intact from
+         * igraph_edge_betweenness_cutoff */
+        IGRAPH_CHECK(igraph_dqueue_int_push(&ws->q, source));
+        IGRAPH_CHECK(igraph_stack_int_push(&ws->stack, source));
+
+        nrgeo[source] = 1;
+        distance[source] = 0;
+
+        while (!igraph_dqueue_int_empty(&ws->q)) {
+            igraph_integer_t actnode = igraph_dqueue_int_pop(&ws->q);
+
+            neip = igraph_inclist_get(state->elist_out, actnode);
+            neino = igraph_vector_int_size(neip);
+            for (igraph_integer_t i = 0; i < neino; i++) {
+                igraph_integer_t edge = VECTOR(*neip)[i];
+                igraph_integer_t neighbor = IGRAPH_OTHER(graph, edge, actnode);
+                if (nrgeo[neighbor] != 0) {
+                    /* we've already seen this node, another shortest path? */
+                    if (distance[neighbor] == distance[actnode] + 1) {
+                        nrgeo[neighbor] += nrgeo[actnode];
+                    }
+                } else {
+                    /* we haven't seen this node yet */
+                    nrgeo[neighbor] += nrgeo[actnode];
+                    distance[neighbor] = distance[actnode] + 1;
+                    IGRAPH_CHECK(igraph_dqueue_int_push(&ws->q, neighbor));
+                    IGRAPH_CHECK(igraph_stack_int_push(&ws->stack, neighbor));
+                }
+            }
+        } /* while !igraph_dqueue_int_empty */
+
+        /* Ok, we've the distance of each node and also the number of
+           shortest paths to them. Now we do an inverse search, starting
+           with the farthest nodes. The workspace is reset on the way. */
+        while (!igraph_stack_int_empty(&ws->stack)) {
+            igraph_integer_t actnode = igraph_stack_int_pop(&ws->stack);
+            if (distance[actnode] >= 1) {
+                /* set the temporary score of the friends */
+                neip = igraph_inclist_get(state->elist_in, actnode);
+                neino = igraph_vector_int_size(neip);
+                for (igraph_integer_t i = 0; i < neino; i++) {
+                    igraph_integer_t edge = VECTOR(*neip)[i];
+                    igraph_integer_t neighbor = IGRAPH_OTHER(graph, edge, actnode);
+                    if (distance[neighbor] == distance[actnode] - 1 &&
+                        nrgeo[neighbor] != 0) {
+                        igraph_real_t score =
+                            (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
+                        tmpscore[neighbor] += score;
+                        eb[edge] += sign * score;
+                    }
+                }
+            }
+            /* all neighbors that we read below were pushed earlier */
+            tmpscore[actnode] = 0;
+            distance[actnode] = 0;
+            nrgeo[actnode] = 0;
+        }
+    } else {
+        /* Weighted variant follows */
+
+        const igraph_real_t eps = IGRAPH_SHORTEST_PATH_EPSILON;
+        int cmp_result;
+
+        /* The following is copied almost intact from
+         * igraph_i_edge_betweenness_cutoff_weighted */
+        IGRAPH_CHECK(igraph_2wheap_push_with_index(&ws->heap, source, 0));
+        distance[source] = 1.0;
+        nrgeo[source] = 1;
+
+        while (!igraph_2wheap_empty(&ws->heap)) {
+            igraph_integer_t minnei = igraph_2wheap_max_index(&ws->heap);
+            igraph_real_t mindist = -igraph_2wheap_delete_max(&ws->heap);
+
+            IGRAPH_CHECK(igraph_stack_int_push(&ws->stack, minnei));
+
+            neip = igraph_inclist_get(state->elist_out, minnei);
+            neino = igraph_vector_int_size(neip);
+
+            for (igraph_integer_t i = 0; i < neino; i++) {
+                igraph_integer_t edge = VECTOR(*neip)[i];
+                igraph_integer_t to = IGRAPH_OTHER(graph, edge, minnei);
+                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+                igraph_real_t curdist = distance[to];
+                igraph_vector_int_t *v;
+
+                /* Note: curdist == 0 means infinity, and for this case
+                 * cmp_result should be -1. However, this case is handled
+                 * specially below, without referring to cmp_result. */
+                cmp_result = igraph_cmp_epsilon(altdist, curdist - 1, eps);
+
+                if (curdist == 0) {
+                    /* This is the first finite distance to 'to' */
+                    v = igraph_inclist_get(&ws->parents, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                    VECTOR(*v)[0] = edge;
+                    nrgeo[to] = nrgeo[minnei];
+                    distance[to] = altdist + 1.0;
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&ws->heap, to, -altdist));
+                } else if (cmp_result < 0) {
+                    /* This is a shorter path */
+                    v = igraph_inclist_get(&ws->parents, to);
+                    IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                    VECTOR(*v)[0] = edge;
+                    nrgeo[to] = nrgeo[minnei];
+                    distance[to] = altdist + 1.0;
+                    igraph_2wheap_modify(&ws->heap, to, -altdist);
+                } else if (cmp_result == 0) {
+                    /* Another path with the same length */
+                    v = igraph_inclist_get(&ws->parents, to);
+                    IGRAPH_CHECK(igraph_vector_int_push_back(v, edge));
+                    nrgeo[to] += nrgeo[minnei];
+                }
+            }
+        } /* igraph_2wheap_empty(&Q) */
+
+        while (!igraph_stack_int_empty(&ws->stack)) {
+            igraph_integer_t w = igraph_stack_int_pop(&ws->stack);
+            igraph_vector_int_t *parv = igraph_inclist_get(&ws->parents, w);
+            igraph_integer_t parv_len = igraph_vector_int_size(parv);
+
+            for (igraph_integer_t i = 0; i < parv_len; i++) {
+                igraph_integer_t fedge = VECTOR(*parv)[i];
+                igraph_integer_t neighbor = IGRAPH_OTHER(graph, fedge, w);
+                igraph_real_t score = (tmpscore[w] + 1) * nrgeo[neighbor] / nrgeo[w];
+                tmpscore[neighbor] += score;
+                eb[fedge] += sign * score;
+            }
+
+            tmpscore[w] = 0;
+            distance[w] = 0;
+            nrgeo[w] = 0;
+            igraph_vector_int_clear(parv);
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* The sources are divided into a fixed number of lanes, independently of the
+ * number of threads. Each lane adds up the contributions of its sources in
+ * order, and the lanes are added up in order, so that the result does not
+ * depend on the number of threads. */
+static igraph_integer_t igraph_i_eb_no_of_lanes(const igraph_i_eb_state_t *state) {
+    igraph_integer_t no_of_sources = igraph_vector_int_size(&state->sources);
+    igraph_integer_t no_of_lanes = igraph_matrix_ncol(&state->lane_eb);
+    return no_of_sources < no_of_lanes ? no_of_sources : no_of_lanes;
+}
+
+static igraph_error_t igraph_i_eb_lane(const igraph_i_eb_state_t *state,
+                                       igraph_i_eb_workspace_t *ws,
+                                       igraph_integer_t lane, igraph_real_t sign) {
+    igraph_integer_t no_of_sources = igraph_vector_int_size(&state->sources);
+    igraph_integer_t no_of_lanes = igraph_i_eb_no_of_lanes(state);
+    igraph_integer_t begin = no_of_sources * lane / no_of_lanes;
+    igraph_integer_t end = no_of_sources * (lane + 1) / no_of_lanes;
+    igraph_real_t *eb = &MATRIX(state->lane_eb, 0, lane);
+
+    for (igraph_integer_t i = begin; i < end; i++) {
+        IGRAPH_CHECK(igraph_i_eb_source(state, ws, VECTOR(state->sources)[i], sign, eb));
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+static igraph_error_t igraph_i_eb_lanes_parallel(const igraph_i_eb_state_t *state,
+                                                 igraph_real_t sign) {
+    igraph_integer_t no_of_lanes = igraph_i_eb_no_of_lanes(state);
+    int error = IGRAPH_SUCCESS;
+
+#pragma omp parallel num_threads(state->no_of_workspaces)
+    {
+        igraph_error_handler_t *handler = igraph_i_parallel_enter();
+        igraph_i_eb_workspace_t *ws = &state->workspaces[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic, 1)
+        for (igraph_integer_t lane = 0; lane < no_of_lanes; lane++) {
+            igraph_error_t ret;
+            int current_error;
+
+#pragma omp atomic read
+            current_error = error;
+            if (current_error != IGRAPH_SUCCESS) {
+                continue;
+            }
+
+            ret = igraph_i_eb_lane(state, ws, lane, sign);
+            if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                error = ret;
+            }
+        }
+
+        igraph_i_parallel_exit(handler);
+    }
+
+    if (error != IGRAPH_SUCCESS) {
+        IGRAPH_ERROR("Cannot calculate edge betweenness.", (igraph_error_t) error);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif
+
+/* Adds 'sign' times the contribution of all sources in state->sources to the
+ * partial scores of the lanes. */
+static igraph_error_t igraph_i_eb_lanes(const igraph_i_eb_state_t *state,
+                                        igraph_real_t sign) {
+    igraph_integer_t no_of_lanes = igraph_i_eb_no_of_lanes(state);
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_lanes > 1 && state->no_of_workspaces > 1) {
+        IGRAPH_CHECK(igraph_i_eb_lanes_parallel(state, sign));
+    } else
+#endif
+    {
+        for (igraph_integer_t lane = 0; lane < no_of_lanes; lane++) {
+            IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_CHECK(igraph_i_eb_lane(state, &state->workspaces[0], lane, sign));
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Adds the partial scores of the lanes to 'eb', for the given edges, and
+ * resets them to zero. */
+static void igraph_i_eb_collect_lanes(igraph_i_eb_state_t *state,
+                                      const igraph_vector_int_t *edges,
+                                      igraph_vector_t *eb) {
+    igraph_integer_t no_of_edges = igraph_vector_int_size(edges);
+    igraph_integer_t no_of_lanes = igraph_matrix_ncol(&state->lane_eb);
+
+    for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+        igraph_integer_t edge = VECTOR(*edges)[i];
+        igraph_real_t sum = VECTOR(*eb)[edge];
+        for (igraph_integer_t lane = 0; lane < no_of_lanes; lane++) {
+            sum += MATRIX(state->lane_eb, edge, lane);
+            MATRIX(state->lane_eb, edge, lane) = 0;
+        }
+        VECTOR(*eb)[edge] = sum;
+    }
+}
+
+static void igraph_i_eb_workspaces_destroy(igraph_i_eb_state_t *state) {
+    for (igraph_integer_t i = 0; i < state->no_of_workspaces; i++) {
+        igraph_i_eb_workspace_destroy(&state->workspaces[i]);
+    }
+    IGRAPH_FREE(state->workspaces);
+}
+
+/* Collects the vertices and the active edges of the weakly connected
+ * component that contains 'start'. Vertices and edges are marked with
+ * 'stamp' in 'vertex_mark' and 'edge_mark'. */
+static igraph_error_t igraph_i_eb_component(const igraph_i_eb_state_t *state,
+                                            igraph_integer_t start,
+                                            igraph_integer_t stamp,
+                                            igraph_vector_int_t *vertex_mark,
+                                            igraph_vector_int_t *edge_mark,
+                                            igraph_vector_int_t *vertices,
+                                            igraph_vector_int_t *edges) {
+    igraph_vector_int_clear(vertices);
+    igraph_vector_int_clear(edges);
+
+    IGRAPH_CHECK(igraph_vector_int_push_back(vertices, start));
+    VECTOR(*vertex_mark)[start] = stamp;
+
+    /* 'vertices' also serves as the queue of the breadth-first search */
+    for (igraph_integer_t i = 0; i < igraph_vector_int_size(vertices); i++) {
+        igraph_integer_t actnode = VECTOR(*vertices)[i];
+        for (int pass = 0; pass < 2; pass++) {
+            igraph_inclist_t *il = pass == 0 ? state->elist_out : state->elist_in;
+            igraph_vector_int_t *neip;
+            igraph_integer_t neino;
+
+            if (pass == 1 && state->elist_in == state->elist_out) {
+                break;
+            }
+
+            neip = igraph_inclist_get(il, actnode);
+            neino = igraph_vector_int_size(neip);
+            for (igraph_integer_t j = 0; j < neino; j++) {
+                igraph_integer_t edge = VECTOR(*neip)[j];
+                igraph_integer_t neighbor = IGRAPH_OTHER(state->graph, edge, actnode);
+                if (VECTOR(*edge_mark)[edge] != stamp) {
+                    VECTOR(*edge_mark)[edge] = stamp;
+                    IGRAPH_CHECK(igraph_vector_int_push_back(edges, edge));
+                }
+                if (VECTOR(*vertex_mark)[neighbor] != stamp) {
+                    VECTOR(*vertex_mark)[neighbor] = stamp;
+                    IGRAPH_CHECK(igraph_vector_int_push_back(vertices, neighbor));
+                }
+            }
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Computes the length of the shortest paths from all vertices of a component
+ * to 'target'. 'dist' must be infinite for all vertices of the component. */
+static igraph_error_t igraph_i_eb_distances_to(const igraph_i_eb_state_t *state,
+                                               igraph_integer_t target,
+                                               igraph_vector_t *dist) {
+    igraph_i_eb_workspace_t *ws = &state->workspaces[0];
+    const igraph_vector_t *weights = state->weights;
+
+    VECTOR(*dist)[target] = 0;
+
+    if (weights == NULL) {
+        IGRAPH_CHECK(igraph_dqueue_int_push(&ws->q, target));
+        while (!igraph_dqueue_int_empty(&ws->q)) {
+            igraph_integer_t actnode = igraph_dqueue_int_pop(&ws->q);
+            igraph_vector_int_t *neip = igraph_inclist_get(state->elist_in, actnode);
+            igraph_integer_t neino = igraph_vector_int_size(neip);
+            for (igraph_integer_t i = 0; i < neino; i++) {
+                igraph_integer_t neighbor = IGRAPH_OTHER(state->graph, VECTOR(*neip)[i], actnode);
+                if (VECTOR(*dist)[neighbor] == IGRAPH_INFINITY) {
+                    VECTOR(*dist)[neighbor] = VECTOR(*dist)[actnode] + 1;
+                    IGRAPH_CHECK(igraph_dqueue_int_push(&ws->q, neighbor));
+                }
+            }
+        }
+    } else {
+        IGRAPH_CHECK(igraph_2wheap_push_with_index(&ws->heap, target, 0));
+        while (!igraph_2wheap_empty(&ws->heap)) {
+            igraph_integer_t actnode = igraph_2wheap_max_index(&ws->heap);
+            igraph_real_t actdist = -igraph_2wheap_delete_max(&ws->heap);
+            igraph_vector_int_t *neip = igraph_inclist_get(state->elist_in, actnode);
+            igraph_integer_t neino = igraph_vector_int_size(neip);
+            for (igraph_integer_t i = 0; i < neino; i++) {
+                igraph_integer_t edge = VECTOR(*neip)[i];
+                igraph_integer_t neighbor = IGRAPH_OTHER(state->graph, edge, actnode);
+                igraph_real_t altdist = actdist + VECTOR(*weights)[edge];
+                if (VECTOR(*dist)[neighbor] == IGRAPH_INFINITY) {
+                    VECTOR(*dist)[neighbor] = altdist;
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&ws->heap, neighbor, -altdist));
+                } else if (altdist < VECTOR(*dist)[neighbor]) {
+                    VECTOR(*dist)[neighbor] = altdist;
+                    igraph_2wheap_modify(&ws->heap, neighbor, -altdist);
+                }
+            }
+        }
+        igraph_2wheap_clear(&ws->heap);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Removing an edge changes the shortest paths only from those sources whose
+ * shortest path DAG contains the edge. This function collects these sources
+ * from the vertices of the component of the edge into state->sources. In the
+ * weighted case, distances are compared with a generous tolerance: including
+ * a source unnecessarily only costs time. */
+static igraph_error_t igraph_i_eb_affected_sources(igraph_i_eb_state_t *state,
+                                                   igraph_integer_t edge,
+                                                   igraph_bool_t directed,
+                                                   const igraph_vector_int_t *vertices,
+                                                   igraph_vector_t *dist_from,
+                                                   igraph_vector_t *dist_to) {
+    igraph_integer_t from = IGRAPH_FROM(state->graph, edge);
+    igraph_integer_t to = IGRAPH_TO(state->graph, edge);
+    igraph_integer_t no_of_vertices = igraph_vector_int_size(vertices);
+    igraph_real_t w = state->weights ? VECTOR(*state->weights)[edge] : 1;
+    const igraph_real_t eps = state->weights ? 1e-6 : 0;
+
+    for (igraph_integer_t i = 0; i < no_of_vertices; i++) {
+        igraph_integer_t v = VECTOR(*vertices)[i];
+        VECTOR(*dist_from)[v] = IGRAPH_INFINITY;
+        VECTOR(*dist_to)[v] = IGRAPH_INFINITY;
+    }
+    IGRAPH_CHECK(igraph_i_eb_distances_to(state, from, dist_from));
+    IGRAPH_CHECK(igraph_i_eb_distances_to(state, to, dist_to));
+
+    igraph_vector_int_clear(&state->sources);
+    for (igraph_integer_t i = 0; i < no_of_vertices; i++) {
+        igraph_integer_t v = VECTOR(*vertices)[i];
+        igraph_real_t df = VECTOR(*dist_from)[v], dt = VECTOR(*dist_to)[v];
+        igraph_bool_t affected =
+            (df != IGRAPH_INFINITY && igraph_cmp_epsilon(df + w, dt, eps) == 0) ||
+            (!directed && dt != IGRAPH_INFINITY && igraph_cmp_epsilon(dt + w, df, eps) == 0);
+        if (affected) {
+            IGRAPH_CHECK(igraph_vector_int_push_back(&state->sources, v));
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Removes an edge from the incidence lists. */
+static void igraph_i_eb_remove_edge(igraph_i_eb_state_t *state, igraph_integer_t edge) {
+    igraph_integer_t from = IGRAPH_FROM(state->graph, edge);
+    igraph_integer_t to = IGRAPH_TO(state->graph, edge);
+    igraph_vector_int_t *neip;
+    igraph_integer_t neino, pos;
+
+    neip = igraph_inclist_get(state->elist_in, to);
+    neino = igraph_vector_int_size(neip);
+    igraph_vector_int_search(neip, 0, edge, &pos);
+    VECTOR(*neip)[pos] = VECTOR(*neip)[neino - 1];
+    igraph_vector_int_pop_back(neip);
+
+    neip = igraph_inclist_get(state->elist_out, from);
+    neino = igraph_vector_int_size(neip);
+    igraph_vector_int_search(neip, 0, edge, &pos);
+    VECTOR(*neip)[pos] = VECTOR(*neip)[neino - 1];
+    igraph_vector_int_pop_back(neip);
 }
 
 /**
@@ -363,6 +875,17 @@ static igraph_integer_t igraph_i_vector_which_max_not_null(const igraph_vector_t
  * of betweenness and modularity are used, however, only splits into
  * \em weakly connected components are detected.
  *
+ * </para><para>
+ * After an edge removal, the scores are only updated within the weakly
+ * connected component that contained the removed edge. If the edge lay on
+ * the shortest paths from only a few sources, the contributions of these
+ * sources are recalculated; otherwise the scores of the whole component are.
+ * The shortest path searches from different sources run in parallel when
+ * igraph was built with OpenMP support. The result does not depend on the
+ * number of threads. Edges whose betweenness differs only by rounding errors
+ * are considered to be tied, and of these, the one with the smallest ID is
+ * removed first.
+ *
  * \param graph The input graph.
  * \param result Pointer to an initialized vector, the result will be
  *     stored here, the IDs of the removed edges in the order of their
@@ -401,7 +924,8 @@ static igraph_integer_t igraph_i_vector_which_max_not_null(const igraph_vector_t
  * igraph_community_spinglass(), \ref igraph_community_walktrap().
  *
  * Time complexity: O(|V||E|^2), as the betweenness calculation requires
- * O(|V||E|) and we do it |E|-1 times.
+ * O(|V||E|) and we do it |E|-1 times. In practice, it is usually much less,
+ * as only the component of the removed edge is considered after each removal.
  *
  * \example examples/simple/igraph_community_edge_betweenness.c
  */
@@ -417,28 +941,18 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
 
     const igraph_integer_t no_of_nodes = igraph_vcount(graph);
     const igraph_integer_t no_of_edges = igraph_ecount(graph);
-    double *distance, *tmpscore;
-    double *nrgeo;
 
-    igraph_inclist_t elist_out, elist_in, parents;
-    igraph_inclist_t *elist_out_p, *elist_in_p;
-    igraph_vector_int_t *neip;
-    igraph_integer_t neino;
-    igraph_vector_t eb;
-    igraph_integer_t maxedge, pos;
-    igraph_integer_t from, to;
+    igraph_inclist_t elist_out, elist_in;
+    igraph_i_eb_state_t state;
+    igraph_vector_t eb, dist_from, dist_to;
+    igraph_vector_int_t vertex_mark, edge_mark;
+    igraph_vector_int_t comp_vertices, comp_edges;
+    igraph_integer_t maxedge, no_of_threads, no_of_lanes;
     igraph_bool_t result_owned = false;
-    igraph_stack_int_t stack;
     igraph_real_t steps, steps_done;
 
     bool *passive;
 
-    /* Needed only for the unweighted case */
-    igraph_dqueue_int_t q;
-
-    /* Needed only for the weighted case */
-    igraph_2wheap_t heap;
-
     if (result == NULL) {
         result = IGRAPH_CALLOC(1, igraph_vector_int_t);
         IGRAPH_CHECK_OOM(result, "Insufficient memory for edge betweenness-based community detection.");
@@ -448,35 +962,7 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
         result_owned = true;
     }
 
-    directed = directed && igraph_is_directed(graph);
-    if (directed) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_in, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_in);
-        elist_out_p = &elist_out;
-        elist_in_p = &elist_in;
-    } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
-        elist_out_p = elist_in_p = &elist_out;
-    }
-
-    distance = IGRAPH_CALLOC(no_of_nodes, double);
-    IGRAPH_CHECK_OOM(distance, "Insufficient memory for edge betweenness-based community detection.");
-    IGRAPH_FINALLY(igraph_free, distance);
-
-    nrgeo = IGRAPH_CALLOC(no_of_nodes, double);
-    IGRAPH_CHECK_OOM(nrgeo, "Insufficient memory for edge betweenness-based community detection.");
-    IGRAPH_FINALLY(igraph_free, nrgeo);
-
-    tmpscore = IGRAPH_CALLOC(no_of_nodes, double);
-    IGRAPH_CHECK_OOM(tmpscore, "Insufficient memory for edge betweenness-based community detection.");
-    IGRAPH_FINALLY(igraph_free, tmpscore);
-
-    if (weights == NULL) {
-        IGRAPH_DQUEUE_INT_INIT_FINALLY(&q, 100);
-    } else {
+    if (weights != NULL) {
         if (igraph_vector_size(weights) != no_of_edges) {
             IGRAPH_ERROR("Weight vector length must agree with number of edges.", IGRAPH_EINVAL);
         }
@@ -504,14 +990,50 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
                            "weights as similarities while edge betwenness treats them as "
                            "distances.");
         }
+    }
+
+    state.graph = graph;
+    state.weights = weights;
+
+    directed = directed && igraph_is_directed(graph);
+    if (directed) {
+        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
+        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
+        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_in, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
+        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_in);
+        state.elist_out = &elist_out;
+        state.elist_in = &elist_in;
+    } else {
+        IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
+        IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
+        state.elist_out = state.elist_in = &elist_out;
+    }
 
-        IGRAPH_CHECK(igraph_2wheap_init(&heap, no_of_nodes));
-        IGRAPH_FINALLY(igraph_2wheap_destroy, &heap);
-        IGRAPH_CHECK(igraph_inclist_init_empty(&parents, no_of_nodes));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &parents);
+#ifdef IGRAPH_I_PARALLEL_API
+    no_of_threads = igraph_i_parallel_max_threads();
+#else
+    no_of_threads = 1;
+#endif
+
+    state.workspaces = IGRAPH_CALLOC(no_of_threads, igraph_i_eb_workspace_t);
+    IGRAPH_CHECK_OOM(state.workspaces, "Insufficient memory for edge betweenness-based community detection.");
+    state.no_of_workspaces = 0;
+    IGRAPH_FINALLY(igraph_i_eb_workspaces_destroy, &state);
+    for (igraph_integer_t i = 0; i < no_of_threads; i++) {
+        IGRAPH_CHECK(igraph_i_eb_workspace_init(&state.workspaces[i], no_of_nodes, weights != NULL));
+        state.no_of_workspaces++;
     }
 
-    IGRAPH_STACK_INT_INIT_FINALLY(&stack, no_of_nodes);
+    /* The number of lanes is limited so that their partial scores take up
+     * a bounded amount of memory. */
+    no_of_lanes = IGRAPH_I_EB_LANE_BUDGET / (no_of_edges > 0 ? no_of_edges : 1);
+    if (no_of_lanes > IGRAPH_I_EB_MAX_LANES) {
+        no_of_lanes = IGRAPH_I_EB_MAX_LANES;
+    } else if (no_of_lanes < 1) {
+        no_of_lanes = 1;
+    }
+    IGRAPH_MATRIX_INIT_FINALLY(&state.lane_eb, no_of_edges, no_of_lanes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&state.sources, 0);
 
     IGRAPH_CHECK(igraph_vector_int_resize(result, no_of_edges));
     if (edge_betweenness) {
@@ -522,6 +1044,14 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
     }
 
     IGRAPH_VECTOR_INIT_FINALLY(&eb, no_of_edges);
+    IGRAPH_VECTOR_INIT_FINALLY(&dist_from, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&dist_to, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&vertex_mark, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&edge_mark, no_of_edges);
+    IGRAPH_CHECK(igraph_vector_int_init_range(&comp_vertices, 0, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &comp_vertices);
+    IGRAPH_CHECK(igraph_vector_int_init_range(&comp_edges, 0, no_of_edges));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &comp_edges);
 
     passive = IGRAPH_CALLOC(no_of_edges, bool);
     IGRAPH_CHECK_OOM(passive, "Insufficient memory for edge betweenness-based community detection.");
@@ -536,167 +1066,17 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
     steps = no_of_edges / 2.0 * (no_of_edges + 1);
     steps_done = 0;
 
+    /* The initial scores, from all sources */
+    IGRAPH_CHECK(igraph_vector_int_update(&state.sources, &comp_vertices));
+    IGRAPH_CHECK(igraph_i_eb_lanes(&state, 1));
+    igraph_i_eb_collect_lanes(&state, &comp_edges, &eb);
+
     for (igraph_integer_t e = 0; e < no_of_edges; steps_done += no_of_edges - e, e++) {
         IGRAPH_PROGRESS("Edge betweenness community detection: ",
                         100.0 * steps_done / steps, NULL);
+        IGRAPH_ALLOW_INTERRUPTION();
 
-        igraph_vector_null(&eb);
-
-        if (weights == NULL) {
-            /* Unweighted variant follows */
-
-            /* The following for loop is copied almost intact from
-             * igraph_edge_betweenness_cutoff */
-            for (igraph_integer_t source = 0; source < no_of_nodes; source++) {
-
-                IGRAPH_ALLOW_INTERRUPTION();
-
-                memset(distance, 0, (size_t) no_of_nodes * sizeof(double));
-                memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(double));
-                memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
-                igraph_stack_int_clear(&stack); /* it should be empty anyway... */
-
-                IGRAPH_CHECK(igraph_dqueue_int_push(&q, source));
-
-                nrgeo[source] = 1;
-                distance[source] = 0;
-
-                while (!igraph_dqueue_int_empty(&q)) {
-                    igraph_integer_t actnode = igraph_dqueue_int_pop(&q);
-
-                    neip = igraph_inclist_get(elist_out_p, actnode);
-                    neino = igraph_vector_int_size(neip);
-                    for (igraph_integer_t i = 0; i < neino; i++) {
-                        igraph_integer_t edge = VECTOR(*neip)[i];
-                        igraph_integer_t neighbor = IGRAPH_OTHER(graph, edge, actnode);
-                        if (nrgeo[neighbor] != 0) {
-                            /* we've already seen this node, another shortest path? */
-                            if (distance[neighbor] == distance[actnode] + 1) {
-                                nrgeo[neighbor] += nrgeo[actnode];
-                            }
-                        } else {
-                            /* we haven't seen this node yet */
-                            nrgeo[neighbor] += nrgeo[actnode];
-                            distance[neighbor] = distance[actnode] + 1;
-                            IGRAPH_CHECK(igraph_dqueue_int_push(&q, neighbor));
-                            IGRAPH_CHECK(igraph_stack_int_push(&stack, neighbor));
-                        }
-                    }
-                } /* while !igraph_dqueue_int_empty */
-
-                /* Ok, we've the distance of each node and also the number of
-                   shortest paths to them. Now we do an inverse search, starting
-                   with the farthest nodes. */
-                while (!igraph_stack_int_empty(&stack)) {
-                    igraph_integer_t actnode = igraph_stack_int_pop(&stack);
-                    if (distance[actnode] < 1) {
-                        continue;    /* skip source node */
-                    }
-
-                    /* set the temporary score of the friends */
-                    neip = igraph_inclist_get(elist_in_p, actnode);
-                    neino = igraph_vector_int_size(neip);
-                    for (igraph_integer_t i = 0; i < neino; i++) {
-                        igraph_integer_t edge = VECTOR(*neip)[i];
-                        igraph_integer_t neighbor = IGRAPH_OTHER(graph, edge, actnode);
-                        if (distance[neighbor] == distance[actnode] - 1 &&
-                            nrgeo[neighbor] != 0) {
-                            tmpscore[neighbor] +=
-                                (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                            VECTOR(eb)[edge] +=
-                                (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                        }
-                    }
-                }
-                /* Ok, we've the scores for this source */
-            } /* for source <= no_of_nodes */
-        } else {
-            /* Weighted variant follows */
-
-            const igraph_real_t eps = IGRAPH_SHORTEST_PATH_EPSILON;
-            int cmp_result;
-
-            /* The following for loop is copied almost intact from
-             * igraph_i_edge_betweenness_cutoff_weighted */
-            for (igraph_integer_t source = 0; source < no_of_nodes; source++) {
-                /* This will contain the edge betweenness in the current step */
-                IGRAPH_ALLOW_INTERRUPTION();
-
-                memset(distance, 0, (size_t) no_of_nodes * sizeof(double));
-                memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(double));
-                memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
-
-                IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, source, 0));
-                distance[source] = 1.0;
-                nrgeo[source] = 1;
-
-                while (!igraph_2wheap_empty(&heap)) {
-                    igraph_integer_t minnei = igraph_2wheap_max_index(&heap);
-                    igraph_real_t mindist = -igraph_2wheap_delete_max(&heap);
-
-                    IGRAPH_CHECK(igraph_stack_int_push(&stack, minnei));
-
-                    neip = igraph_inclist_get(elist_out_p, minnei);
-                    neino = igraph_vector_int_size(neip);
-
-                    for (igraph_integer_t i = 0; i < neino; i++) {
-                        igraph_integer_t edge = VECTOR(*neip)[i];
-                        igraph_integer_t to = IGRAPH_OTHER(graph, edge, minnei);
-                        igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                        igraph_real_t curdist = distance[to];
-                        igraph_vector_int_t *v;
-
-                        /* Note: curdist == 0 means infinity, and for this case
-                         * cmp_result should be -1. However, this case is handled
-                         * specially below, without referring to cmp_result. */
-                        cmp_result = igraph_cmp_epsilon(altdist, curdist - 1, eps);
-
-                        if (curdist == 0) {
-                            /* This is the first finite distance to 'to' */
-                            v = igraph_inclist_get(&parents, to);
-                            igraph_vector_int_resize(v, 1);
-                            VECTOR(*v)[0] = edge;
-                            nrgeo[to] = nrgeo[minnei];
-                            distance[to] = altdist + 1.0;
-                            IGRAPH_CHECK(igraph_2wheap_push_with_index(&heap, to, -altdist));
-                        } else if (cmp_result < 0) {
-                            /* This is a shorter path */
-                            v = igraph_inclist_get(&parents, to);
-                            igraph_vector_int_resize(v, 1);
-                            VECTOR(*v)[0] = edge;
-                            nrgeo[to] = nrgeo[minnei];
-                            distance[to] = altdist + 1.0;
-                            igraph_2wheap_modify(&heap, to, -altdist);
-                        } else if (cmp_result == 0) {
-                            /* Another path with the same length */
-                            v = igraph_inclist_get(&parents, to);
-                            IGRAPH_CHECK(igraph_vector_int_push_back(v, edge));
-                            nrgeo[to] += nrgeo[minnei];
-                        }
-                    }
-                } /* igraph_2wheap_empty(&Q) */
-
-                while (!igraph_stack_int_empty(&stack)) {
-                    igraph_integer_t w = igraph_stack_int_pop(&stack);
-                    igraph_vector_int_t *parv = igraph_inclist_get(&parents, w);
-                    igraph_integer_t parv_len = igraph_vector_int_size(parv);
-
-                    for (igraph_integer_t i = 0; i < parv_len; i++) {
-                        igraph_integer_t fedge = VECTOR(*parv)[i];
-                        igraph_integer_t neighbor = IGRAPH_OTHER(graph, fedge, w);
-                        tmpscore[neighbor] += (tmpscore[w] + 1) * nrgeo[neighbor] / nrgeo[w];
-                        VECTOR(eb)[fedge] += (tmpscore[w] + 1) * nrgeo[neighbor] / nrgeo[w];
-                    }
-
-                    tmpscore[w] = 0;
-                    distance[w] = 0;
-                    nrgeo[w] = 0;
-                    igraph_vector_int_clear(parv);
-                }
-            } /* source < no_of_nodes */
-        }
-
-        /* Now look for the smallest edge betweenness */
+        /* Now look for the largest edge betweenness */
         /* and eliminate that edge from the network */
         maxedge = igraph_i_vector_which_max_not_null(&eb, passive);
         VECTOR(*result)[e] = maxedge;
@@ -707,40 +1087,50 @@ igraph_error_t igraph_community_edge_betweenness(const igraph_t *graph,
             }
         }
         passive[maxedge] = true;
-        IGRAPH_CHECK(igraph_edge(graph, maxedge, &from, &to));
 
-        neip = igraph_inclist_get(elist_in_p, to);
-        neino = igraph_vector_int_size(neip);
-        igraph_vector_int_search(neip, 0, maxedge, &pos);
-        VECTOR(*neip)[pos] = VECTOR(*neip)[neino - 1];
-        igraph_vector_int_pop_back(neip);
+        if (e == no_of_edges - 1) {
+            break;
+        }
 
-        neip = igraph_inclist_get(elist_out_p, from);
-        neino = igraph_vector_int_size(neip);
-        igraph_vector_int_search(neip, 0, maxedge, &pos);
-        VECTOR(*neip)[pos] = VECTOR(*neip)[neino - 1];
-        igraph_vector_int_pop_back(neip);
+        /* Only the scores of the edges in the same component change. */
+        IGRAPH_CHECK(igraph_i_eb_component(&state, IGRAPH_FROM(graph, maxedge), e + 1,
+                                           &vertex_mark, &edge_mark,
+                                           &comp_vertices, &comp_edges));
+        IGRAPH_CHECK(igraph_i_eb_affected_sources(&state, maxedge, directed, &comp_vertices,
+                                                  &dist_from, &dist_to));
+
+        if (2 * igraph_vector_int_size(&state.sources) < igraph_vector_int_size(&comp_vertices)) {
+            /* Few sources are affected: subtract their old contributions,
+             * and add the new ones. */
+            IGRAPH_CHECK(igraph_i_eb_lanes(&state, -1));
+            igraph_i_eb_remove_edge(&state, maxedge);
+            IGRAPH_CHECK(igraph_i_eb_lanes(&state, 1));
+        } else {
+            /* Recompute the scores of the component from scratch. */
+            igraph_i_eb_remove_edge(&state, maxedge);
+            IGRAPH_CHECK(igraph_vector_int_update(&state.sources, &comp_vertices));
+            for (igraph_integer_t i = 0; i < igraph_vector_int_size(&comp_edges); i++) {
+                VECTOR(eb)[VECTOR(comp_edges)[i]] = 0;
+            }
+            IGRAPH_CHECK(igraph_i_eb_lanes(&state, 1));
+        }
+        igraph_i_eb_collect_lanes(&state, &comp_edges, &eb);
     }
 
     IGRAPH_PROGRESS("Edge betweenness community detection: ", 100.0, NULL);
 
     IGRAPH_FREE(passive);
+    igraph_vector_int_destroy(&comp_edges);
+    igraph_vector_int_destroy(&comp_vertices);
+    igraph_vector_int_destroy(&edge_mark);
+    igraph_vector_int_destroy(&vertex_mark);
+    igraph_vector_destroy(&dist_to);
+    igraph_vector_destroy(&dist_from);
     igraph_vector_destroy(&eb);
-    igraph_stack_int_destroy(&stack);
-    IGRAPH_FINALLY_CLEAN(3);
-
-    if (weights == NULL) {
-        igraph_dqueue_int_destroy(&q);
-        IGRAPH_FINALLY_CLEAN(1);
-    } else {
-        igraph_2wheap_destroy(&heap);
-        igraph_inclist_destroy(&parents);
-        IGRAPH_FINALLY_CLEAN(2);
-    }
-    igraph_free(tmpscore);
-    igraph_free(nrgeo);
-    igraph_free(distance);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_vector_int_destroy(&state.sources);
+    igraph_matrix_destroy(&state.lane_eb);
+    igraph_i_eb_workspaces_destroy(&state);
+    IGRAPH_FINALLY_CLEAN(11);
 
     if (directed) {
         igraph_inclist_destroy(&elist_out);
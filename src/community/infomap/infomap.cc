@@ -31,8 +31,11 @@
 
 #include "igraph_community.h"
 
+#include "core/default_rng_guard.h"
 #include "core/exceptions.h"
 #include "core/interruption.h"
+#include "core/parallel.h"
+#include "random/random_internal.h"
 
 #include "infomap_Node.h"
 #include "infomap_FlowGraph.h"
@@ -40,8 +43,10 @@
 
 #include <vector>
 #include <cmath>
+#include <limits>
 
 /****************************************************************************/
+// Interruption is only checked when rcall is false.
 static igraph_error_t infomap_partition(FlowGraph &fgraph, bool rcall) {
 
     // save the original graph
@@ -183,6 +188,180 @@ static igraph_error_t infomap_partition(FlowGraph &fgraph, bool rcall) {
 }
 
 
+/****************************************************************************/
+// Runs a single trial on a copy of fgraph, using 'rng', and stores the code
+// length and the (not reindexed) membership.
+static igraph_error_t infomap_trial(const FlowGraph &fgraph, igraph_rng_t *rng,
+                                    bool rcall, double &codeLength,
+                                    std::vector<igraph_integer_t> &membership) {
+    FlowGraph cpy_fgraph(fgraph);
+
+    {
+        DefaultRNGGuard guard(rng);
+        IGRAPH_CHECK(infomap_partition(cpy_fgraph, rcall));
+    }
+
+    codeLength = cpy_fgraph.codeLength;
+    membership.resize(fgraph.Nnode);
+    for (igraph_integer_t i = 0 ; i < cpy_fgraph.Nnode ; i++) {
+        for (const auto &v : cpy_fgraph.node[i].members) {
+            membership[v] = i;
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+// Trials with equal code length are ordered by their index, so that the
+// result does not depend on the order in which they are completed.
+static bool infomap_is_better(double codeLength, igraph_integer_t trial,
+                              double bestCodeLength, igraph_integer_t bestTrial) {
+    return bestTrial < 0 || codeLength < bestCodeLength ||
+           (codeLength == bestCodeLength && trial < bestTrial);
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+namespace {
+
+// The best partition found by infomap_trials_parallel(), and by each thread.
+struct InfomapBest {
+    double codeLength = std::numeric_limits<double>::infinity();
+    igraph_integer_t trial = -1;
+    std::vector<igraph_integer_t> membership;
+
+    void update(double newCodeLength, igraph_integer_t newTrial,
+                std::vector<igraph_integer_t> &newMembership) {
+        if (infomap_is_better(newCodeLength, newTrial, codeLength, trial)) {
+            codeLength = newCodeLength;
+            trial = newTrial;
+            membership.swap(newMembership);
+        }
+    }
+};
+
+struct InfomapTrials {
+    const FlowGraph *fgraph;
+    InfomapBest best;
+};
+
+struct InfomapWorkspace {
+    std::vector<igraph_integer_t> membership;
+    InfomapBest best;
+};
+
+} // namespace
+
+// Callbacks for igraph_i_parallel_run_tasks()
+
+static igraph_error_t infomap_task(void *data, void *workspace,
+                                   igraph_rng_t *rng, igraph_integer_t trial) {
+    const InfomapTrials *trials = static_cast<const InfomapTrials *>(data);
+    InfomapWorkspace *ws = static_cast<InfomapWorkspace *>(workspace);
+    double codeLength;
+
+    try {
+        IGRAPH_CHECK(infomap_trial(*trials->fgraph, rng, true, codeLength, ws->membership));
+        ws->best.update(codeLength, trial, ws->membership);
+    } catch (const std::bad_alloc &) {
+        return IGRAPH_ENOMEM;
+    } catch (...) {
+        return IGRAPH_FAILURE;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t infomap_workspace_init(void *data, void **workspace) {
+    IGRAPH_UNUSED(data);
+    try {
+        *workspace = new InfomapWorkspace;
+    } catch (const std::bad_alloc &) {
+        IGRAPH_ERROR("Cannot run Infomap trials.", IGRAPH_ENOMEM);
+    }
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t infomap_collect(void *data, void *workspace) {
+    InfomapTrials *trials = static_cast<InfomapTrials *>(data);
+    InfomapWorkspace *ws = static_cast<InfomapWorkspace *>(workspace);
+    if (ws->best.trial >= 0) {
+        trials->best.update(ws->best.codeLength, ws->best.trial, ws->best.membership);
+    }
+    return IGRAPH_SUCCESS;
+}
+
+static void infomap_workspace_destroy(void *workspace) {
+    delete static_cast<InfomapWorkspace *>(workspace);
+}
+
+static igraph_error_t infomap_trials_parallel(const FlowGraph &fgraph, igraph_uint_t seed,
+                                              igraph_integer_t nb_trials,
+                                              double &bestCodeLength, igraph_integer_t &bestTrial,
+                                              std::vector<igraph_integer_t> &bestMembership) {
+    InfomapTrials trials;
+    igraph_i_parallel_tasks_t tasks = { };
+
+    trials.fgraph = &fgraph;
+
+    tasks.no_of_tasks = nb_trials;
+    tasks.seed = seed;
+    tasks.data = &trials;
+    tasks.run = infomap_task;
+    tasks.workspace_init = infomap_workspace_init;
+    tasks.collect = infomap_collect;
+    tasks.workspace_destroy = infomap_workspace_destroy;
+    tasks.error_message = "Cannot run Infomap trials.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
+
+    bestCodeLength = trials.best.codeLength;
+    bestTrial = trials.best.trial;
+    bestMembership.swap(trials.best.membership);
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif // IGRAPH_I_PARALLEL_API
+
+static igraph_error_t infomap_trials(const FlowGraph &fgraph, igraph_uint_t seed,
+                                     igraph_integer_t nb_trials,
+                                     double &bestCodeLength, igraph_integer_t &bestTrial,
+                                     std::vector<igraph_integer_t> &bestMembership) {
+#ifdef IGRAPH_I_PARALLEL_API
+    if (nb_trials > 1 && igraph_i_parallel_max_threads() > 1) {
+        IGRAPH_CHECK(infomap_trials_parallel(fgraph, seed, nb_trials,
+                                             bestCodeLength, bestTrial, bestMembership));
+    } else
+#endif
+    {
+        igraph_rng_t rng;
+        std::vector<igraph_integer_t> trialMembership;
+
+        IGRAPH_CHECK(igraph_rng_init(&rng, &igraph_rngtype_philox4x32));
+        IGRAPH_FINALLY(igraph_rng_destroy, &rng);
+
+        for (igraph_integer_t trial = 0; trial < nb_trials; trial++) {
+            double codeLength;
+
+            //partition the network
+            igraph_rng_seed_stream(&rng, seed, (igraph_uint_t) trial);
+            IGRAPH_CHECK(infomap_trial(fgraph, &rng, false, codeLength, trialMembership));
+
+            // if better than the better, store the partition
+            if (infomap_is_better(codeLength, trial, bestCodeLength, bestTrial)) {
+                bestCodeLength = codeLength;
+                bestTrial = trial;
+                bestMembership.swap(trialMembership);
+            }
+        }
+
+        igraph_rng_destroy(&rng);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_community_infomap
  * \brief Find community structure that minimizes the expected description length of a random walker trajectory.
@@ -213,6 +392,15 @@ static igraph_error_t infomap_partition(FlowGraph &fgraph, bool rcall) {
  * If you want to specify a random seed (as in the original
  * implementation) you can use \ref igraph_rng_seed().
  *
+ * </para><para>
+ * The trials are independent of each other. When igraph is built with
+ * OpenMP support, they are run in parallel. The stationary distribution of
+ * the random walker is computed only once and shared by all trials. Every
+ * trial draws its random numbers from a separate Philox stream, derived from
+ * a seed taken from the default random number generator, therefore the
+ * result only depends on the state of the default generator, not on the
+ * number of threads.
+ *
  * \param graph The input graph.
  * \param e_weights Numeric vector giving the weights of the edges.
  *     The random walker will favour edges with high weights over
@@ -248,39 +436,36 @@ igraph_error_t igraph_community_infomap(const igraph_t * graph,
                              igraph_vector_int_t *membership,
                              igraph_real_t *codelength) {
 
+    if (nb_trials < 1) {
+        IGRAPH_ERRORF("Number of trials must be at least 1, got %" IGRAPH_PRId ".",
+                      IGRAPH_EINVAL, nb_trials);
+    }
+
     IGRAPH_HANDLE_EXCEPTIONS(
         FlowGraph fgraph(graph, e_weights, v_weights);
 
-        // compute stationary distribution
+        // compute stationary distribution, this is shared by all trials
         fgraph.initiate();
 
-        double shortestCodeLength = 1000.0;
+        double shortestCodeLength = std::numeric_limits<double>::infinity();
+        igraph_integer_t bestTrial = -1;
+        std::vector<igraph_integer_t> bestMembership;
+        igraph_uint_t seed = igraph_i_rng_stream_seed();
 
         // create membership vector
         igraph_integer_t Nnode = fgraph.Nnode;
         IGRAPH_CHECK(igraph_vector_int_resize(membership, Nnode));
 
-        for (igraph_integer_t trial = 0; trial < nb_trials; trial++) {
-            FlowGraph cpy_fgraph(fgraph);
+        IGRAPH_CHECK(infomap_trials(fgraph, seed, nb_trials,
+                                    shortestCodeLength, bestTrial, bestMembership));
 
-            //partition the network
-            IGRAPH_CHECK(infomap_partition(cpy_fgraph, false));
-
-            // if better than the better...
-            if (cpy_fgraph.codeLength < shortestCodeLength) {
-                shortestCodeLength = cpy_fgraph.codeLength;
-                // ... store the partition
-                for (igraph_integer_t i = 0 ; i < cpy_fgraph.Nnode ; i++) {
-                    size_t Nmembers = cpy_fgraph.node[i].members.size();
-                    for (size_t k = 0; k < Nmembers; k++) {
-                        //cluster[ cpy_fgraph->node[i].members[k] ] = i;
-                        VECTOR(*membership)[cpy_fgraph.node[i].members[k]] = i;
-                    }
-                }
-            }
+        for (igraph_integer_t i = 0; i < Nnode; i++) {
+            VECTOR(*membership)[i] = bestMembership[i];
         }
 
-        *codelength = (igraph_real_t) shortestCodeLength / log(2.0);
+        if (codelength) {
+            *codelength = (igraph_real_t) shortestCodeLength / log(2.0);
+        }
 
         IGRAPH_CHECK(igraph_reindex_membership(membership, NULL, NULL));
 
@@ -127,8 +127,7 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
     igraph_integer_t no_of_edges = igraph_ecount(graph);
     igraph_integer_t no_of_not_fixed_nodes = no_of_nodes;
     igraph_integer_t i, j, k;
-    igraph_adjlist_t al;
-    igraph_inclist_t il;
+    igraph_csr_adjlist_t al;
     igraph_bool_t running, control_iteration;
     igraph_bool_t unlabelled_left;
     igraph_neimode_t reversed_mode;
@@ -224,16 +223,15 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
 
     /* From this point onwards we use 'fixed_copy' instead of 'fixed' */
 
-    /* Create an adjacency/incidence list representation for efficiency.
-     * For the unweighted case, the adjacency list is enough. For the
-     * weighted case, we need the incidence list */
+    /* Create a compact adjacency list representation for efficiency.
+     * For the unweighted case, the neighbors are enough. For the
+     * weighted case, we also need the incident edges */
     if (weights) {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &il, reversed_mode, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &il);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &al, reversed_mode, IGRAPH_LOOPS_ONCE));
     } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &al, reversed_mode, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &al);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &al, reversed_mode, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
     }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &al);
 
     /* Create storage space for counting distinct labels and dominant ones */
     IGRAPH_VECTOR_INIT_FINALLY(&label_counters, no_of_nodes + 1);
@@ -264,8 +262,8 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
     while (running) {
         igraph_integer_t v1, num_neis;
         igraph_real_t max_count;
-        igraph_vector_int_t *neis;
-        igraph_vector_int_t *ineis;
+        const igraph_integer_t *neis;
+        const igraph_integer_t *ineis;
         igraph_bool_t was_zero;
 
         if (control_iteration) {
@@ -288,15 +286,16 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
             igraph_vector_int_clear(&nonzero_labels);
             max_count = 0.0;
             if (weights) {
-                ineis = igraph_inclist_get(&il, v1);
-                num_neis = igraph_vector_int_size(ineis);
+                neis = igraph_csr_adjlist_get(&al, v1);
+                ineis = igraph_csr_adjlist_get_eids(&al, v1);
+                num_neis = igraph_csr_adjlist_degree(&al, v1);
                 for (j = 0; j < num_neis; j++) {
-                    k = VECTOR(*membership)[IGRAPH_OTHER(graph, VECTOR(*ineis)[j], v1)];
+                    k = VECTOR(*membership)[neis[j]];
                     if (k == 0) {
                         continue;    /* skip if it has no label yet */
                     }
                     was_zero = (VECTOR(label_counters)[k] == 0);
-                    VECTOR(label_counters)[k] += VECTOR(*weights)[VECTOR(*ineis)[j]];
+                    VECTOR(label_counters)[k] += VECTOR(*weights)[ineis[j]];
                     if (was_zero && VECTOR(label_counters)[k] != 0) {
                         /* counter just became nonzero */
                         IGRAPH_CHECK(igraph_vector_int_push_back(&nonzero_labels, k));
@@ -310,10 +309,10 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
                     }
                 }
             } else {
-                neis = igraph_adjlist_get(&al, v1);
-                num_neis = igraph_vector_int_size(neis);
+                neis = igraph_csr_adjlist_get(&al, v1);
+                num_neis = igraph_csr_adjlist_degree(&al, v1);
                 for (j = 0; j < num_neis; j++) {
-                    k = VECTOR(*membership)[VECTOR(*neis)[j]];
+                    k = VECTOR(*membership)[neis[j]];
                     if (k == 0) {
                         continue;    /* skip if it has no label yet */
                     }
@@ -359,11 +358,7 @@ igraph_error_t igraph_community_label_propagation(const igraph_t *graph,
         control_iteration = !control_iteration;
     }
 
-    if (weights) {
-        igraph_inclist_destroy(&il);
-    } else {
-        igraph_adjlist_destroy(&al);
-    }
+    igraph_csr_adjlist_destroy(&al);
     IGRAPH_FINALLY_CLEAN(1);
 
     /* Shift back the membership vector, permute labels in increasing order */
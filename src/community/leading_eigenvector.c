@@ -33,6 +33,7 @@
 #include "igraph_structural.h"
 
 #include "core/interruption.h"
+#include "linalg/spmv_internal.h"
 
 #include <limits.h>
 
@@ -80,15 +81,9 @@
 
 typedef struct igraph_i_community_leading_eigenvector_data_t {
     igraph_vector_int_t *idx;
-    igraph_vector_int_t *idx2;
-    igraph_adjlist_t *adjlist;
-    igraph_inclist_t *inclist;
+    igraph_i_csr_matrix_t A;
     igraph_vector_t *tmp;
-    igraph_integer_t no_of_edges;
-    igraph_vector_int_t *mymembership;
-    igraph_integer_t comm;
-    const igraph_vector_t *weights;
-    const igraph_t *graph;
+    igraph_vector_t *rowsum;
     igraph_vector_t *strength;
     igraph_real_t sumweights;
 } igraph_i_community_leading_eigenvector_data_t;
@@ -99,52 +94,34 @@ static igraph_error_t igraph_i_community_leading_eigenvector(
         int n, void *extra) {
 
     igraph_i_community_leading_eigenvector_data_t *data = extra;
-    igraph_integer_t j, k, nlen, size = n;
+    igraph_integer_t j, size = n;
     igraph_vector_int_t *idx = data->idx;
-    igraph_vector_int_t *idx2 = data->idx2;
     igraph_vector_t *tmp = data->tmp;
-    igraph_adjlist_t *adjlist = data->adjlist;
+    igraph_vector_t *rowsum = data->rowsum;
+    igraph_vector_t *strength = data->strength;
     igraph_real_t ktx, ktx2;
-    igraph_integer_t no_of_edges = data->no_of_edges;
-    igraph_vector_int_t *mymembership = data->mymembership;
-    igraph_integer_t comm = data->comm;
+    igraph_real_t sw = data->sumweights;
 
-    /* Ax */
-    for (j = 0; j < size; j++) {
-        igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, oldid);
-        nlen = igraph_vector_int_size(neis);
-        to[j] = 0.0;
-        VECTOR(*tmp)[j] = 0.0;
-        for (k = 0; k < nlen; k++) {
-            igraph_integer_t nei = VECTOR(*neis)[k];
-            igraph_integer_t neimemb = VECTOR(*mymembership)[nei];
-            if (neimemb == comm) {
-                to[j] += from[ VECTOR(*idx2)[nei] ];
-                VECTOR(*tmp)[j] += 1;
-            }
-        }
-    }
+    /* Ax, A being the adjacency matrix of the community */
+    igraph_i_csr_spmv(&data->A, from, to);
 
-    /* Now calculate k^Tx/2m */
+    /* k^Tx/2m */
     ktx = 0.0; ktx2 = 0.0;
     for (j = 0; j < size; j++) {
         igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, oldid);
-        igraph_integer_t degree = igraph_vector_int_size(neis);
-        ktx += from[j] * degree;
-        ktx2 += degree;
+        igraph_real_t str = VECTOR(*strength)[oldid];
+        ktx += from[j] * str;
+        ktx2 += str;
     }
-    ktx = ktx / no_of_edges / 2.0;
-    ktx2 = ktx2 / no_of_edges / 2.0;
+    ktx = ktx / sw / 2.0;
+    ktx2 = ktx2 / sw / 2.0;
 
-    /* Now calculate Bx */
+    /* Bx */
     for (j = 0; j < size; j++) {
         igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, oldid);
-        igraph_real_t degree = igraph_vector_int_size(neis);
-        to[j] = to[j] - ktx * degree;
-        VECTOR(*tmp)[j] = VECTOR(*tmp)[j] - ktx2 * degree;
+        igraph_real_t str = VECTOR(*strength)[oldid];
+        to[j] = to[j] - ktx * str;
+        VECTOR(*tmp)[j] = VECTOR(*rowsum)[j] - ktx2 * str;
     }
 
     /* -d_ij summa l in G B_il */
@@ -155,67 +132,52 @@ static igraph_error_t igraph_i_community_leading_eigenvector(
     return IGRAPH_SUCCESS;
 }
 
-static igraph_error_t igraph_i_community_leading_eigenvector_weighted(
-        igraph_real_t *to,
-        const igraph_real_t *from,
-        int n, void *extra) {
-
-    igraph_i_community_leading_eigenvector_data_t *data = extra;
-    igraph_integer_t j, k, nlen, size = n;
-    igraph_vector_int_t *idx = data->idx;
-    igraph_vector_int_t *idx2 = data->idx2;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_inclist_t *inclist = data->inclist;
-    igraph_real_t ktx, ktx2;
-    igraph_vector_int_t *mymembership = data->mymembership;
-    igraph_integer_t comm = data->comm;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_t *strength = data->strength;
-    igraph_real_t sw = data->sumweights;
+/* Restricts the adjacency list to the size vertices of a community,
+ * listed in idx, renumbering them according to idx2. The number (or
+ * total weight) of the edges within the community is stored in rowsum
+ * for each vertex. The result is used as the matrix A in the ARPACK
+ * callback above, so that the multiplication can run in parallel. */
+static igraph_error_t igraph_i_community_leading_eigenvector_restrict(
+        const igraph_csr_adjlist_t *adjlist,
+        const igraph_vector_t *weights,
+        const igraph_vector_int_t *membership,
+        igraph_integer_t comm,
+        const igraph_vector_int_t *idx,
+        const igraph_vector_int_t *idx2,
+        igraph_integer_t size,
+        igraph_csr_adjlist_t *sub,
+        igraph_vector_t *rowsum) {
+
+    igraph_integer_t j, k, nnz = 0;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(&sub->offsets, size + 1));
+    igraph_vector_int_clear(&sub->neis);
+    igraph_vector_int_clear(&sub->eids);
+    IGRAPH_CHECK(igraph_vector_resize(rowsum, size));
+    sub->length = size;
 
-    /* Ax */
     for (j = 0; j < size; j++) {
         igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_vector_int_t *inc = igraph_inclist_get(inclist, oldid);
-        nlen = igraph_vector_int_size(inc);
-        to[j] = 0.0;
-        VECTOR(*tmp)[j] = 0.0;
+        const igraph_integer_t *neis = igraph_csr_adjlist_get(adjlist, oldid);
+        const igraph_integer_t *eids = weights ? igraph_csr_adjlist_get_eids(adjlist, oldid) : NULL;
+        igraph_integer_t nlen = igraph_csr_adjlist_degree(adjlist, oldid);
+        VECTOR(sub->offsets)[j] = nnz;
+        VECTOR(*rowsum)[j] = 0.0;
         for (k = 0; k < nlen; k++) {
-            igraph_integer_t edge = VECTOR(*inc)[k];
-            igraph_real_t w = VECTOR(*weights)[edge];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, oldid);
-            igraph_integer_t neimemb = VECTOR(*mymembership)[nei];
-            if (neimemb == comm) {
-                to[j] += from[ VECTOR(*idx2)[nei] ] * w;
-                VECTOR(*tmp)[j] += w;
+            igraph_integer_t nei = neis[k];
+            if (VECTOR(*membership)[nei] == comm) {
+                IGRAPH_CHECK(igraph_vector_int_push_back(&sub->neis, VECTOR(*idx2)[nei]));
+                if (weights) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(&sub->eids, eids[k]));
+                    VECTOR(*rowsum)[j] += VECTOR(*weights)[eids[k]];
+                } else {
+                    VECTOR(*rowsum)[j] += 1;
+                }
+                nnz++;
             }
         }
     }
-
-    /* k^Tx/2m */
-    ktx = 0.0; ktx2 = 0.0;
-    for (j = 0; j < size; j++) {
-        igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_real_t str = VECTOR(*strength)[oldid];
-        ktx += from[j] * str;
-        ktx2 += str;
-    }
-    ktx = ktx / sw / 2.0;
-    ktx2 = ktx2 / sw / 2.0;
-
-    /* Bx */
-    for (j = 0; j < size; j++) {
-        igraph_integer_t oldid = VECTOR(*idx)[j];
-        igraph_real_t str = VECTOR(*strength)[oldid];
-        to[j] = to[j] - ktx * str;
-        VECTOR(*tmp)[j] = VECTOR(*tmp)[j] - ktx2 * str;
-    }
-
-    /* -d_ij summa l in G B_il */
-    for (j = 0; j < size; j++) {
-        to[j] -= VECTOR(*tmp)[j] * from[j];
-    }
+    VECTOR(sub->offsets)[size] = nnz;
 
     return IGRAPH_SUCCESS;
 }
@@ -348,21 +310,17 @@ igraph_error_t igraph_community_leading_eigenvector(
     igraph_dqueue_int_t tosplit;
     igraph_vector_int_t idx, idx2;
     igraph_vector_t mymerges;
-    igraph_vector_t strength, tmp;
+    igraph_vector_t strength, tmp, rowsum;
     igraph_vector_t start_vec;
     igraph_integer_t staken = 0;
-    igraph_adjlist_t adjlist;
-    igraph_inclist_t inclist;
+    igraph_csr_adjlist_t adjlist, subadjlist;
     igraph_integer_t i, j, k, l;
     igraph_integer_t communities;
     igraph_vector_int_t vmembership, *mymembership = membership;
     igraph_i_community_leading_eigenvector_data_t extra;
     igraph_arpack_storage_t storage;
     igraph_real_t mod = 0;
-    igraph_arpack_function_t *arpcb1 =
-            weights ? igraph_i_community_leading_eigenvector_weighted :
-                      igraph_i_community_leading_eigenvector;
-    igraph_real_t sumweights = 0.0;
+    igraph_arpack_function_t *arpcb1 = igraph_i_community_leading_eigenvector;
 
     if (no_of_nodes > INT_MAX) {
         IGRAPH_ERROR("Graph too large for ARPACK", IGRAPH_EOVERFLOW);
@@ -471,16 +429,21 @@ igraph_error_t igraph_community_leading_eigenvector(
     igraph_vector_int_null(&idx);
     IGRAPH_VECTOR_INT_INIT_FINALLY(&idx2, no_of_nodes);
     if (!weights) {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
     } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-        IGRAPH_VECTOR_INIT_FINALLY(&strength, no_of_nodes);
-        IGRAPH_CHECK(igraph_strength(graph, &strength, igraph_vss_all(),
-                                     IGRAPH_ALL, IGRAPH_LOOPS, weights));
-        sumweights = igraph_vector_sum(weights);
-    }
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE));
+    }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&subadjlist.offsets, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&subadjlist.neis, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&subadjlist.eids, 0);
+    subadjlist.length = 0;
+    subadjlist.has_eids = weights != NULL;
+    IGRAPH_VECTOR_INIT_FINALLY(&rowsum, 0);
+    /* degrees in the unweighted case */
+    IGRAPH_VECTOR_INIT_FINALLY(&strength, no_of_nodes);
+    IGRAPH_CHECK(igraph_strength(graph, &strength, igraph_vss_all(),
+                                 IGRAPH_ALL, IGRAPH_LOOPS, weights));
 
     if (options == 0) {
         options = igraph_arpack_options_get_default();
@@ -496,16 +459,10 @@ igraph_error_t igraph_community_leading_eigenvector(
                                             (int) no_of_nodes, 1));
     IGRAPH_FINALLY(igraph_arpack_storage_destroy, &storage);
     extra.idx = &idx;
-    extra.idx2 = &idx2;
     extra.tmp = &tmp;
-    extra.adjlist = &adjlist;
-    extra.inclist = &inclist;
-    extra.weights = weights;
-    extra.sumweights = sumweights;
-    extra.graph = graph;
+    extra.rowsum = &rowsum;
     extra.strength = &strength;
-    extra.no_of_edges = no_of_edges;
-    extra.mymembership = mymembership;
+    extra.sumweights = weights ? igraph_vector_sum(weights) : no_of_edges;
 
     while (!igraph_dqueue_int_empty(&tosplit) && staken < steps) {
         igraph_integer_t comm = igraph_dqueue_int_pop_back(&tosplit);
@@ -534,7 +491,11 @@ igraph_error_t igraph_community_leading_eigenvector(
         options->ncv = 0;   /* 0 means "automatic" in igraph_arpack_rssolve */
         options->nconv = 0;
         options->lworkl = 0;        /* we surely have enough space */
-        extra.comm = comm;
+        IGRAPH_CHECK(igraph_i_community_leading_eigenvector_restrict(
+                         &adjlist, weights, mymembership, comm, &idx, &idx2, size,
+                         &subadjlist, &rowsum));
+        /* The vectors of subadjlist may have been reallocated. */
+        igraph_i_csr_matrix_init(&extra.A, &subadjlist, weights);
 
         /* Use a random start vector, but don't let ARPACK generate the
          * start vector -- we want to use our own RNG. Also, we want to generate
@@ -707,14 +668,11 @@ igraph_error_t igraph_community_leading_eigenvector(
 
     igraph_arpack_storage_destroy(&storage);
     IGRAPH_FINALLY_CLEAN(1);
-    if (!weights) {
-        igraph_adjlist_destroy(&adjlist);
-        IGRAPH_FINALLY_CLEAN(1);
-    } else {
-        igraph_inclist_destroy(&inclist);
-        igraph_vector_destroy(&strength);
-        IGRAPH_FINALLY_CLEAN(2);
-    }
+    igraph_vector_destroy(&strength);
+    igraph_vector_destroy(&rowsum);
+    igraph_csr_adjlist_destroy(&subadjlist);
+    igraph_csr_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(6);
     igraph_dqueue_int_destroy(&tosplit);
     igraph_vector_destroy(&tmp);
     igraph_vector_int_destroy(&idx2);
@@ -69,6 +69,21 @@ static igraph_error_t igraph_i_community_spinglass_orig(
         igraph_spincomm_update_t update_rule,
         igraph_real_t gamma);
 
+static igraph_error_t igraph_i_community_spinglass_tempering(
+        const igraph_t *graph,
+        const igraph_vector_t *weights,
+        igraph_real_t *modularity,
+        igraph_real_t *temperature,
+        igraph_vector_int_t *membership,
+        igraph_vector_int_t *csize,
+        igraph_integer_t spins,
+        igraph_integer_t replicas,
+        igraph_real_t starttemp,
+        igraph_real_t stoptemp,
+        igraph_real_t coolfact,
+        igraph_spincomm_update_t update_rule,
+        igraph_real_t gamma);
+
 static igraph_error_t igraph_i_community_spinglass_negative(
         const igraph_t *graph,
         const igraph_vector_t *weights,
@@ -364,6 +379,195 @@ static igraph_error_t igraph_i_community_spinglass_orig(
     return IGRAPH_SUCCESS;
 }
 
+/**
+ * \function igraph_community_spinglass_tempering
+ * \brief Spinglass community detection with parallel tempering.
+ *
+ * This function optimizes the same quality function as the original
+ * implementation of \ref igraph_community_spinglass(), but instead of a
+ * single simulated annealing run it cools several replicas of the spin
+ * system at once, each at a different temperature. The temperatures of
+ * the replicas grow geometrically by a factor of 1.1, starting from the
+ * coldest one, which follows the same cooling schedule as in
+ * \ref igraph_community_spinglass(). After each temperature step,
+ * replicas at neighbouring temperatures exchange their configurations
+ * with the Metropolis probability, which lets the colder replicas escape
+ * from local minima. The configuration with the lowest energy found in the
+ * last step is returned.
+ *
+ * </para><para>
+ * The spins are updated one class of a vertex coloring at a time: the
+ * vertices of a class are not adjacent, so they are updated at once,
+ * using the community sizes (or degree sums) from the start of the class.
+ * With OpenMP support, these updates and the replicas run in parallel.
+ * The vertices of each class are split into chunks that use their own
+ * random number streams, so the result does not depend on the number of
+ * threads. It does differ from the result of \ref igraph_community_spinglass().
+ *
+ * \param graph The input graph, it may be directed but the direction
+ *     of the edges is not used in the algorithm. It must be connected.
+ * \param weights The vector giving the edge weights, it may be \c NULL,
+ *     in which case all edges are weighted equally. The edge weights
+ *     must be positive. This condition is not verified by the function.
+ * \param modularity Pointer to a real number, if not \c NULL then the
+ *     modularity score of the solution will be stored here, see
+ *     \ref igraph_community_spinglass().
+ * \param temperature Pointer to a real number, if not \c NULL then
+ *     the temperature of the returned replica at the end of the algorithm
+ *     will be stored here.
+ * \param membership Pointer to an initialized vector or \c NULL. If
+ *     not \c NULL then the result of the clustering will be stored
+ *     here. For each vertex, the number of its cluster is given, with the
+ *     first cluster numbered zero. The vector will be resized as
+ *     needed.
+ * \param csize Pointer to an initialized vector or \c NULL. If not \c
+ *     NULL then the sizes of the clusters will stored here in cluster
+ *     number order. The vector will be resized as needed.
+ * \param spins Integer giving the number of spins, i.e. the maximum
+ *     number of clusters.
+ * \param replicas The number of replicas, at least one.
+ * \param starttemp Real number, the temperature at the start, must be
+ *     positive.
+ * \param stoptemp Real number, the algorithm stops when the coldest
+ *     replica reaches this temperature. It must be positive.
+ * \param coolfact Real number, the cooling factor for the simulated
+ *     annealing.
+ * \param update_rule The type of the update rule, \c
+ *     IGRAPH_SPINCOMM_UPDATE_SIMPLE or \c IGRAPH_SPINCOMM_UPDATE_CONFIG,
+ *     see \ref igraph_community_spinglass().
+ * \param gamma Real number. The gamma parameter of the
+ *     algorithm, see \ref igraph_community_spinglass().
+ * \return Error code.
+ *
+ * \sa \ref igraph_community_spinglass().
+ *
+ * Time complexity: O(R (|V| q + |E|)) per temperature step, where R is
+ * the number of replicas and q the number of spins.
+ */
+
+igraph_error_t igraph_community_spinglass_tempering(const igraph_t *graph,
+                                         const igraph_vector_t *weights,
+                                         igraph_real_t *modularity,
+                                         igraph_real_t *temperature,
+                                         igraph_vector_int_t *membership,
+                                         igraph_vector_int_t *csize,
+                                         igraph_integer_t spins,
+                                         igraph_integer_t replicas,
+                                         igraph_real_t starttemp,
+                                         igraph_real_t stoptemp,
+                                         igraph_real_t coolfact,
+                                         igraph_spincomm_update_t update_rule,
+                                         igraph_real_t gamma) {
+    IGRAPH_HANDLE_EXCEPTIONS(
+        return igraph_i_community_spinglass_tempering(graph, weights, modularity,
+                temperature, membership, csize,
+                spins, replicas, starttemp,
+                stoptemp, coolfact, update_rule,
+                gamma);
+    );
+}
+
+static igraph_error_t igraph_i_community_spinglass_tempering(
+        const igraph_t *graph,
+        const igraph_vector_t *weights,
+        igraph_real_t *modularity,
+        igraph_real_t *temperature,
+        igraph_vector_int_t *membership,
+        igraph_vector_int_t *csize,
+        igraph_integer_t spins,
+        igraph_integer_t replicas,
+        igraph_real_t starttemp,
+        igraph_real_t stoptemp,
+        igraph_real_t coolfact,
+        igraph_spincomm_update_t update_rule,
+        igraph_real_t gamma) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_bool_t use_weights = false;
+    bool changes;
+    double kT, acc, prob;
+
+    /* Check arguments */
+
+    if (spins < 2) {
+        IGRAPH_ERROR("Number of spins must be at least 2", IGRAPH_EINVAL);
+    }
+    if (replicas < 1) {
+        IGRAPH_ERROR("Number of replicas must be at least 1", IGRAPH_EINVAL);
+    }
+    if (update_rule != IGRAPH_SPINCOMM_UPDATE_SIMPLE &&
+        update_rule != IGRAPH_SPINCOMM_UPDATE_CONFIG) {
+        IGRAPH_ERROR("Invalid update rule", IGRAPH_EINVAL);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != igraph_ecount(graph)) {
+            IGRAPH_ERROR("Invalid weight vector length", IGRAPH_EINVAL);
+        }
+        use_weights = 1;
+    }
+    if (coolfact < 0 || coolfact >= 1.0) {
+        IGRAPH_ERROR("Invalid cooling factor", IGRAPH_EINVAL);
+    }
+    if (gamma < 0.0) {
+        IGRAPH_ERROR("Invalid gamma value", IGRAPH_EINVAL);
+    }
+    if (!(stoptemp > 0.0)) {
+        IGRAPH_ERROR("stoptemp must be positive", IGRAPH_EINVAL);
+    }
+    if (starttemp / stoptemp < 1.0) {
+        IGRAPH_ERROR("starttemp should be larger than stoptemp", IGRAPH_EINVAL);
+    }
+
+    /* Trivial cases are handled by the original implementation. */
+    if (no_of_nodes < 2) {
+        return igraph_i_community_spinglass_orig(graph, weights, modularity,
+                temperature, membership, csize, spins, false, starttemp,
+                stoptemp, coolfact, update_rule, gamma);
+    }
+
+    igraph_bool_t conn;
+    IGRAPH_CHECK(igraph_is_connected(graph, &conn, IGRAPH_WEAK));
+    if (!conn) {
+        IGRAPH_ERROR("Cannot work with unconnected graph", IGRAPH_EINVAL);
+    }
+
+    network net;
+
+    IGRAPH_CHECK(igraph_i_read_network(graph, weights,
+                                       &net, use_weights, 0));
+
+    prob = 2.0 * net.sum_weights / double(net.node_list->Size())
+           / double(net.node_list->Size() - 1);
+
+    PottsModel pm(&net, (unsigned int)spins, update_rule);
+    PottsReplicas pr(&net, (unsigned int)spins, update_rule, replicas);
+
+    RNG_BEGIN();
+
+    kT = pm.FindStartTemp(gamma, prob, starttemp);
+    IGRAPH_CHECK(pr.assign_initial_conf(kT, 1.1));
+    changes = true;
+
+    while (changes && pr.Get_kT(0) / stoptemp > 1.0) {
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        pr.Cool(coolfact);
+        acc = pr.HeatBathColored(gamma, prob, 50);
+        pr.ExchangeReplicas(gamma, prob);
+        /* less than 1 percent acceptance ratio in the coldest replica */
+        changes = acc >= (1.0 - 1.0 / double(spins)) * 0.01;
+    }
+
+    igraph_integer_t best = pr.FindBestReplica(gamma, prob);
+    pr.SetClusters(best, &net);
+    pm.WriteClusters(modularity, temperature, csize, membership, pr.Get_kT(best), gamma);
+
+    RNG_END();
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_community_spinglass_single
  * \brief Community of a single node based on statistical mechanics.
@@ -50,6 +50,9 @@
 #include "igraph_types.h"
 #include "igraph_vector.h"
 #include "igraph_matrix.h"
+#include "igraph_random.h"
+
+#include <vector>
 
 // Simple matrix class with heap allocation, allowing mat[i][j] indexing.
 class SimpleMatrix {
@@ -121,6 +124,63 @@ public:
 };
 
 
+// Several replicas of the Potts model of PottsModel, at different
+// temperatures, for parallel tempering. The network is copied into flat
+// arrays, and the spins are updated one class of a vertex coloring at a
+// time: no two nodes of a class are linked, so their updates only interact
+// through the color field, which is kept fixed while a class is updated.
+// The nodes of a class are processed in chunks, each of which uses its own
+// random stream, so the result does not depend on the number of threads.
+class PottsReplicas {
+private:
+    unsigned long q;
+    unsigned int operation_mode;
+    igraph_integer_t num_of_nodes;
+    igraph_integer_t num_of_replicas;
+    // the neighbours of node i are neighbours[offsets[i]] ... neighbours[offsets[i+1]-1]
+    std::vector<igraph_integer_t> offsets;
+    std::vector<igraph_integer_t> neighbours;
+    std::vector<double> link_weights;
+    std::vector<double> degree;
+    double total_degree_sum;
+    // the nodes of color c are class_nodes[class_offsets[c]] ... class_nodes[class_offsets[c+1]-1]
+    std::vector<igraph_integer_t> class_offsets;
+    std::vector<igraph_integer_t> class_nodes;
+    // spins and color fields of the replica at temperature kT[r] are stored from
+    // r*num_of_nodes and r*(q+1), respectively
+    std::vector<unsigned long> spins;
+    std::vector<unsigned long> new_spins;
+    std::vector<double> color_fields;
+    std::vector<double> kT;
+    std::vector<double> acceptance;
+    // per-thread workspace
+    int num_of_threads;
+    std::vector<igraph_rng_t> rngs;
+    std::vector<double> workspace;
+    igraph_uint_t seed;
+    igraph_uint_t stream;
+
+    void update_chunk(igraph_integer_t r, igraph_integer_t from, igraph_integer_t to,
+                      igraph_rng_t *rng, double *nb, double *weights,
+                      double gamma, double prob, double beta);
+
+    PottsReplicas(const PottsReplicas &);
+    PottsReplicas &operator=(const PottsReplicas &);
+public:
+    PottsReplicas(network *net, unsigned long q, int norm_by_degree, igraph_integer_t replicas);
+    ~PottsReplicas();
+    igraph_error_t assign_initial_conf(double kT_min, double ratio);
+    double HeatBathColored(double gamma, double prob, unsigned int max_sweeps);
+    igraph_integer_t ExchangeReplicas(double gamma, double prob);
+    void Cool(double coolfact);
+    double calculate_energy(igraph_integer_t r, double gamma, double prob) const;
+    igraph_integer_t FindBestReplica(double gamma, double prob) const;
+    void SetClusters(igraph_integer_t r, network *net) const;
+    double Get_kT(igraph_integer_t r) const {
+        return kT[r];
+    }
+};
+
 class PottsModelN {
 private:
     //  HugeArray<double> neg_gammalookup;
@@ -0,0 +1,346 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "pottsmodel_2.h"
+
+#include "igraph_random.h"
+
+#include "core/parallel.h"
+#include "random/random_internal.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The number of nodes of a color class that are updated with the same
+// random stream, and by the same thread.
+#define POTTS_CHUNK_SIZE 256
+
+//#######################################################
+// Copies the network into flat arrays, and colors its nodes greedily:
+// each node gets the smallest color not used by its preceding neighbours.
+//#######################################################
+PottsReplicas::PottsReplicas(network *net, unsigned long qvalue, int m,
+                             igraph_integer_t replicas) :
+    q(qvalue), operation_mode(m), num_of_replicas(replicas),
+    total_degree_sum(0.0), num_of_threads(0), seed(0), stream(0) {
+
+    DLList_Iter<NLink*> l_iter;
+    NNode *node;
+    NLink *l_cur;
+    igraph_integer_t num_of_colors = 0;
+
+    num_of_nodes = net->node_list->Size();
+    offsets.resize(num_of_nodes + 1);
+    degree.resize(num_of_nodes);
+    offsets[0] = 0;
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        node = net->node_list->Get(i);
+        degree[i] = 0.0;
+        l_cur = l_iter.First(node->Get_Links());
+        while (!l_iter.End()) {
+            if (node == l_cur->Get_Start()) {
+                neighbours.push_back(l_cur->Get_End()->Get_Index());
+            } else {
+                neighbours.push_back(l_cur->Get_Start()->Get_Index());
+            }
+            link_weights.push_back(l_cur->Get_Weight());
+            degree[i] += l_cur->Get_Weight();
+            l_cur = l_iter.Next();
+        }
+        offsets[i + 1] = neighbours.size();
+        total_degree_sum += degree[i];
+    }
+
+    std::vector<igraph_integer_t> color(num_of_nodes), mark;
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        // the colors of the neighbours are marked with i
+        mark.resize(offsets[i + 1] - offsets[i] + 1, -1);
+        for (igraph_integer_t j = offsets[i]; j < offsets[i + 1]; j++) {
+            igraph_integer_t u = neighbours[j];
+            if (u < i && color[u] < (igraph_integer_t) mark.size()) {
+                mark[color[u]] = i;
+            }
+        }
+        color[i] = 0;
+        while (mark[color[i]] == i) {
+            color[i]++;
+        }
+        if (color[i] >= num_of_colors) {
+            num_of_colors = color[i] + 1;
+        }
+    }
+    class_offsets.assign(num_of_colors + 1, 0);
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        class_offsets[color[i] + 1]++;
+    }
+    for (igraph_integer_t c = 0; c < num_of_colors; c++) {
+        class_offsets[c + 1] += class_offsets[c];
+    }
+    class_nodes.resize(num_of_nodes);
+    std::vector<igraph_integer_t> next(class_offsets.begin(), class_offsets.end() - 1);
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        class_nodes[next[color[i]]++] = i;
+    }
+
+    spins.resize(num_of_replicas * num_of_nodes);
+    new_spins.resize(num_of_replicas * num_of_nodes);
+    color_fields.resize(num_of_replicas * (q + 1));
+    kT.resize(num_of_replicas);
+    acceptance.resize(num_of_replicas);
+}
+
+PottsReplicas::~PottsReplicas() {
+    for (size_t i = 0; i < rngs.size(); i++) {
+        igraph_rng_destroy(&rngs[i]);
+    }
+}
+
+//#######################################################
+// Sets up the random streams, and assigns a random initial configuration
+// to each replica. The temperatures of the replicas grow geometrically,
+// starting from kT_min.
+//#######################################################
+igraph_error_t PottsReplicas::assign_initial_conf(double kT_min, double ratio) {
+    int threads = igraph_i_parallel_max_threads();
+
+    rngs.reserve(threads);
+    for (int t = 0; t < threads; t++) {
+        igraph_rng_t rng;
+        IGRAPH_CHECK(igraph_rng_init(&rng, &igraph_rngtype_philox4x32));
+        rngs.push_back(rng);
+    }
+    num_of_threads = threads;
+    workspace.resize(2 * (q + 1) * threads);
+    seed = igraph_i_rng_stream_seed();
+
+    for (igraph_integer_t r = 0; r < num_of_replicas; r++) {
+        unsigned long *spin = &spins[r * num_of_nodes];
+        double *color_field = &color_fields[r * (q + 1)];
+
+        kT[r] = r == 0 ? kT_min : kT[r - 1] * ratio;
+        acceptance[r] = 1.0;
+        IGRAPH_CHECK(igraph_rng_seed_stream(&rngs[0], seed, stream++));
+        std::fill(color_field, color_field + q + 1, 0.0);
+        for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+            spin[i] = igraph_rng_get_integer(&rngs[0], 1, q);
+            color_field[spin[i]] += operation_mode == 0 ? 1.0 : degree[i];
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+//#######################################################
+// Heat bath update of the class nodes from ... to-1 in replica r,
+// the same as in PottsModel::HeatBathLookup(). The new spins are stored
+// in new_spins, and applied once the whole class has been updated.
+//#######################################################
+void PottsReplicas::update_chunk(igraph_integer_t r, igraph_integer_t from, igraph_integer_t to,
+                                 igraph_rng_t *rng, double *nb, double *weights,
+                                 double gamma, double prob, double beta) {
+    const unsigned long *spin = &spins[r * num_of_nodes];
+    const double *color_field = &color_fields[r * (q + 1)];
+    unsigned long *new_spin = &new_spins[r * num_of_nodes];
+
+    for (igraph_integer_t i = from; i < to; i++) {
+        igraph_integer_t node = class_nodes[i];
+        unsigned long old_spin = spin[node], spin_opt = old_spin;
+        double delta, minweight = 0.0, norm = 0.0, h, x;
+
+        std::fill(nb, nb + q + 1, 0.0);
+        for (igraph_integer_t j = offsets[node]; j < offsets[node + 1]; j++) {
+            nb[spin[neighbours[j]]] += link_weights[j];
+        }
+
+        if (operation_mode == 0) {
+            delta = 1.0;
+        } else {
+            prob = degree[node] / total_degree_sum;
+            delta = degree[node];
+        }
+        weights[old_spin] = 0.0;
+        for (unsigned long s = 1; s <= q; s++) {
+            if (s != old_spin) {
+                h = color_field[s] - (color_field[old_spin] - delta);
+                weights[s] = nb[old_spin] - nb[s] + gamma * prob * h;
+                if (weights[s] < minweight) {
+                    minweight = weights[s];
+                }
+            }
+        }
+        for (unsigned long s = 1; s <= q; s++) {
+            weights[s] = exp(-beta * (weights[s] - minweight));
+            norm += weights[s];
+        }
+
+        x = igraph_rng_get_unif(rng, 0, norm);
+        for (unsigned long s = 1; s <= q; s++) {
+            if (x <= weights[s]) {
+                spin_opt = s;
+                break;
+            }
+            x -= weights[s];
+        }
+        new_spin[node] = spin_opt;
+    }
+}
+
+//#######################################################
+// Performs max_sweeps sweeps on all replicas and returns the acceptance
+// ratio of the coldest one.
+//#######################################################
+double PottsReplicas::HeatBathColored(double gamma, double prob, unsigned int max_sweeps) {
+    igraph_integer_t num_of_colors = class_offsets.size() - 1;
+    std::vector<igraph_integer_t> changes(num_of_replicas, 0);
+
+    for (unsigned int sweep = 0; sweep < max_sweeps; sweep++) {
+        for (igraph_integer_t c = 0; c < num_of_colors; c++) {
+            igraph_integer_t from = class_offsets[c], to = class_offsets[c + 1];
+            igraph_integer_t chunks = (to - from + POTTS_CHUNK_SIZE - 1) / POTTS_CHUNK_SIZE;
+            igraph_integer_t tasks = chunks * num_of_replicas;
+
+            IGRAPH_I_OMP(omp parallel for schedule(dynamic, 1) num_threads(num_of_threads) if (tasks > 1))
+            for (igraph_integer_t t = 0; t < tasks; t++) {
+#ifdef IGRAPH_I_PARALLEL
+                int thread = omp_get_thread_num();
+#else
+                int thread = 0;
+#endif
+                igraph_integer_t r = t / chunks, k = t % chunks;
+                igraph_integer_t chunk_from = from + k * POTTS_CHUNK_SIZE;
+                double *nb = &workspace[2 * (q + 1) * thread];
+
+                // Philox streams are seeded without allocation, this cannot fail
+                igraph_rng_seed_stream(&rngs[thread], seed, stream + t);
+                update_chunk(r, chunk_from, std::min(chunk_from + POTTS_CHUNK_SIZE, to),
+                             &rngs[thread], nb, nb + q + 1, gamma, prob, 1.0 / kT[r]);
+            }
+            stream += tasks;
+
+            for (igraph_integer_t r = 0; r < num_of_replicas; r++) {
+                unsigned long *spin = &spins[r * num_of_nodes];
+                const unsigned long *new_spin = &new_spins[r * num_of_nodes];
+                double *color_field = &color_fields[r * (q + 1)];
+                for (igraph_integer_t i = from; i < to; i++) {
+                    igraph_integer_t node = class_nodes[i];
+                    if (new_spin[node] != spin[node]) {
+                        double delta = operation_mode == 0 ? 1.0 : degree[node];
+                        color_field[spin[node]] -= delta;
+                        color_field[new_spin[node]] += delta;
+                        spin[node] = new_spin[node];
+                        changes[r]++;
+                    }
+                }
+            }
+        }
+    }
+
+    for (igraph_integer_t r = 0; r < num_of_replicas; r++) {
+        acceptance[r] = double(changes[r]) / double(num_of_nodes) / double(max_sweeps);
+    }
+    return acceptance[0];
+}
+
+//#######################################################
+// The energy whose changes drive the heat bath updates:
+// the weight of the links within communities, counted negatively,
+// plus gamma/2 times the null model term.
+//#######################################################
+double PottsReplicas::calculate_energy(igraph_integer_t r, double gamma, double prob) const {
+    const unsigned long *spin = &spins[r * num_of_nodes];
+    const double *color_field = &color_fields[r * (q + 1)];
+    double inner = 0.0, field = 0.0;
+
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        for (igraph_integer_t j = offsets[i]; j < offsets[i + 1]; j++) {
+            if (spin[neighbours[j]] == spin[i]) {
+                inner += link_weights[j];
+            }
+        }
+    }
+    for (unsigned long s = 1; s <= q; s++) {
+        field += color_field[s] * color_field[s];
+    }
+    if (operation_mode != 0) {
+        prob = 1.0 / total_degree_sum;
+    }
+    return -inner / 2.0 + gamma * prob * field / 2.0;
+}
+
+//#######################################################
+// Proposes to exchange the configurations of each pair of replicas at
+// neighbouring temperatures, with the Metropolis acceptance probability.
+// Returns the number of exchanges.
+//#######################################################
+igraph_integer_t PottsReplicas::ExchangeReplicas(double gamma, double prob) {
+    std::vector<double> energy(num_of_replicas);
+    igraph_integer_t exchanges = 0;
+
+    IGRAPH_I_OMP(omp parallel for num_threads(num_of_threads) if (num_of_replicas > 1))
+    for (igraph_integer_t r = 0; r < num_of_replicas; r++) {
+        energy[r] = calculate_energy(r, gamma, prob);
+    }
+
+    igraph_rng_seed_stream(&rngs[0], seed, stream++);
+    for (igraph_integer_t r = 0; r + 1 < num_of_replicas; r++) {
+        double x = (1.0 / kT[r] - 1.0 / kT[r + 1]) * (energy[r] - energy[r + 1]);
+        if (x >= 0 || igraph_rng_get_unif01(&rngs[0]) < exp(x)) {
+            std::swap_ranges(spins.begin() + r * num_of_nodes,
+                             spins.begin() + (r + 1) * num_of_nodes,
+                             spins.begin() + (r + 1) * num_of_nodes);
+            std::swap_ranges(color_fields.begin() + r * (q + 1),
+                             color_fields.begin() + (r + 1) * (q + 1),
+                             color_fields.begin() + (r + 1) * (q + 1));
+            std::swap(energy[r], energy[r + 1]);
+            exchanges++;
+        }
+    }
+
+    return exchanges;
+}
+
+void PottsReplicas::Cool(double coolfact) {
+    for (igraph_integer_t r = 0; r < num_of_replicas; r++) {
+        kT[r] *= coolfact;
+    }
+}
+
+// The replica with the lowest energy; ties are broken by the lower temperature.
+igraph_integer_t PottsReplicas::FindBestReplica(double gamma, double prob) const {
+    igraph_integer_t best = 0;
+    double best_energy = calculate_energy(0, gamma, prob);
+
+    for (igraph_integer_t r = 1; r < num_of_replicas; r++) {
+        double energy = calculate_energy(r, gamma, prob);
+        if (energy < best_energy) {
+            best = r;
+            best_energy = energy;
+        }
+    }
+    return best;
+}
+
+// Copies the spins of replica r into the cluster indices of the nodes.
+void PottsReplicas::SetClusters(igraph_integer_t r, network *net) const {
+    const unsigned long *spin = &spins[r * num_of_nodes];
+
+    for (igraph_integer_t i = 0; i < num_of_nodes; i++) {
+        net->node_list->Get(i)->Set_ClusterIndex(spin[i]);
+    }
+}
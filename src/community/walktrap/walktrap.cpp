@@ -120,6 +120,9 @@ using namespace igraph::walktrap;
  * Time complexity: O(|E||V|^2) in the worst case, O(|V|^2 log|V|) typically,
  * |V| is the number of vertices, |E| is the number of edges.
  *
+ * \sa \ref igraph_community_walktrap_bounded() to limit the memory used
+ * for large graphs.
+ *
  * \example examples/simple/walktrap.c
  */
 
@@ -129,6 +132,68 @@ igraph_error_t igraph_community_walktrap(const igraph_t *graph,
                               igraph_matrix_int_t *merges,
                               igraph_vector_t *modularity,
                               igraph_vector_int_t *membership) {
+    return igraph_community_walktrap_bounded(graph, weights, steps, /* max_memory= */ -1,
+                                             merges, modularity, membership);
+}
+
+/**
+ * \function igraph_community_walktrap_bounded
+ * \brief Walktrap community finding with a bound on the memory use.
+ *
+ * The Walktrap algorithm stores the probability vector of the random walks
+ * starting from each community, and most of its memory is taken up by these
+ * vectors. This function works like \ref igraph_community_walktrap(), but
+ * keeps the memory used by the probability vectors below \p max_memory
+ * bytes, like the original implementation did. When the bound is exceeded,
+ * the vectors of the communities that are the farthest from all of their
+ * neighbors are deleted first, as these are the least likely to be merged
+ * soon. Deleted vectors are recomputed from the random walks when they are
+ * needed again, therefore a tighter bound makes the computation slower.
+ *
+ * </para><para>
+ * When the memory is bounded, the probability vectors are stored in single
+ * precision, so that more of them fit within the bound. Distances are still
+ * computed in double precision, but the results may slightly differ from
+ * the ones of \ref igraph_community_walktrap() when the distances of
+ * several pairs of communities are almost equal.
+ *
+ * \param graph The input graph, edge directions are ignored.
+ * \param weights Numeric vector giving the weights of the edges.
+ *     If it is a NULL pointer then all edges will have equal
+ *     weights. The weights are expected to be positive.
+ * \param steps Integer constant, the length of the random walks.
+ * \param max_memory The maximum number of bytes used for storing
+ *     probability vectors. At least the two vectors of the communities
+ *     whose distance is being computed are always stored, so the bound
+ *     may be exceeded temporarily when it is very small. If negative,
+ *     the memory use is not bounded and this function is equivalent to
+ *     \ref igraph_community_walktrap().
+ * \param merges Pointer to a matrix, the merges performed by the
+ *     algorithm will be stored here (if not \c NULL). See \ref
+ *     igraph_community_walktrap() for details.
+ * \param modularity Pointer to a vector. If not \c NULL then the
+ *     modularity score of the current clustering is stored here after
+ *     each merge operation.
+ * \param membership Pointer to a vector. If not a \c NULL pointer, then
+ *     the membership vector corresponding to the maximal modularity
+ *     score is stored here. If it is not a \c NULL pointer, then neither
+ *     \p modularity nor \p merges may be \c NULL.
+ * \return Error code.
+ *
+ * \sa \ref igraph_community_walktrap().
+ *
+ * Time complexity: O(|E||V|^2) in the worst case, O(|V|^2 log|V|) typically,
+ * |V| is the number of vertices, |E| is the number of edges. Recomputing the
+ * deleted probability vectors adds O(|E| steps) for each recomputation.
+ */
+
+igraph_error_t igraph_community_walktrap_bounded(const igraph_t *graph,
+                              const igraph_vector_t *weights,
+                              igraph_integer_t steps,
+                              igraph_integer_t max_memory,
+                              igraph_matrix_int_t *merges,
+                              igraph_vector_t *modularity,
+                              igraph_vector_int_t *membership) {
 
     IGRAPH_HANDLE_EXCEPTIONS(
         igraph_integer_t no_of_nodes = igraph_vcount(graph);
@@ -179,7 +244,7 @@ igraph_error_t igraph_community_walktrap(const igraph_t *graph,
             IGRAPH_CHECK(igraph_vector_resize(modularity, no_of_nodes - comp_count + 1));
             igraph_vector_null(modularity);
         }
-        Communities C(&G, length, merges, modularity);
+        Communities C(&G, length, merges, modularity, max_memory < 0 ? -1 : max_memory);
 
         while (!C.H->is_empty()) {
             IGRAPH_ALLOW_INTERRUPTION();
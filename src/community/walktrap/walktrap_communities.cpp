@@ -57,6 +57,8 @@
 #include "config.h"
 #include <algorithm>
 #include <cmath>
+#include <initializer_list>
+#include <limits>
 
 using namespace std;
 
@@ -84,9 +86,32 @@ Neighbor::Neighbor() {
 
 Probabilities::~Probabilities() {
     delete[] P;
+    delete[] Pf;
     delete[] vertices;
 }
 
+void Probabilities::allocate(int nb_probabilities, bool full) {
+    // Probability vectors are stored in single precision when the memory is
+    // bounded, so that more of them fit within the bound.
+    size = nb_probabilities;
+    if (C->max_memory >= 0) {
+        P = nullptr;
+        Pf = new float[size];
+    } else {
+        P = new double[size];
+        Pf = nullptr;
+    }
+    vertices = full ? nullptr : new int[size];
+}
+
+size_t Probabilities::memory() const {
+    size_t m = sizeof(Probabilities) + size * (P ? sizeof(double) : sizeof(float));
+    if (vertices) {
+        m += size * sizeof(int);
+    }
+    return m;
+}
+
 Probabilities::Probabilities(int community) {
     Graph* G = C->G;
     int nb_vertices1 = 0;
@@ -151,29 +176,25 @@ Probabilities::Probabilities(int community) {
     }
 
     if (nb_vertices1 > (G->nb_vertices / 2)) {
-        P = new double[G->nb_vertices];
-        size = G->nb_vertices;
-        vertices = nullptr;
+        allocate(G->nb_vertices, true);
         if (nb_vertices1 == G->nb_vertices) {
             for (int i = 0; i < G->nb_vertices; i++) {
-                P[i] = tmp_vector1[i] / sqrt(G->vertices[i].total_weight);
+                set(i, tmp_vector1[i] / sqrt(G->vertices[i].total_weight));
             }
         } else {
             for (int i = 0; i < G->nb_vertices; i++) {
-                P[i] = 0.;
+                set(i, 0.);
             }
             for (int i = 0; i < nb_vertices1; i++) {
-                P[vertices1[i]] = tmp_vector1[vertices1[i]] / sqrt(G->vertices[vertices1[i]].total_weight);
+                set(vertices1[i], tmp_vector1[vertices1[i]] / sqrt(G->vertices[vertices1[i]].total_weight));
             }
         }
     } else {
-        P = new double[nb_vertices1];
-        size = nb_vertices1;
-        vertices = new int[nb_vertices1];
+        allocate(nb_vertices1, false);
         int j = 0;
         for (int i = 0; i < G->nb_vertices; i++) {
             if (id[i] == current_id) {
-                P[j] = tmp_vector1[i] / sqrt(G->vertices[i].total_weight);
+                set(j, tmp_vector1[i] / sqrt(G->vertices[i].total_weight));
                 vertices[j] = i;
                 j++;
             }
@@ -192,43 +213,39 @@ Probabilities::Probabilities(int community1, int community2) {
 
 
     if (P1->size == C->G->nb_vertices) {
-        P = new double[C->G->nb_vertices];
-        size = C->G->nb_vertices;
-        vertices = nullptr;
+        allocate(C->G->nb_vertices, true);
 
         if (P2->size == C->G->nb_vertices) { // two full vectors
             for (int i = 0; i < C->G->nb_vertices; i++) {
-                P[i] = P1->P[i] * w1 + P2->P[i] * w2;
+                set(i, P1->get(i) * w1 + P2->get(i) * w2);
             }
         } else { // P1 full vector, P2 partial vector
             int j = 0;
             for (int i = 0; i < P2->size; i++) {
                 for (; j < P2->vertices[i]; j++) {
-                    P[j] = P1->P[j] * w1;
+                    set(j, P1->get(j) * w1);
                 }
-                P[j] = P1->P[j] * w1 + P2->P[i] * w2;
+                set(j, P1->get(j) * w1 + P2->get(i) * w2);
                 j++;
             }
             for (; j < C->G->nb_vertices; j++) {
-                P[j] = P1->P[j] * w1;
+                set(j, P1->get(j) * w1);
             }
         }
     } else {
         if (P2->size == C->G->nb_vertices) { // P1 partial vector, P2 full vector
-            P = new double[C->G->nb_vertices];
-            size = C->G->nb_vertices;
-            vertices = nullptr;
+            allocate(C->G->nb_vertices, true);
 
             int j = 0;
             for (int i = 0; i < P1->size; i++) {
                 for (; j < P1->vertices[i]; j++) {
-                    P[j] = P2->P[j] * w2;
+                    set(j, P2->get(j) * w2);
                 }
-                P[j] = P1->P[i] * w1 + P2->P[j] * w2;
+                set(j, P1->get(i) * w1 + P2->get(j) * w2);
                 j++;
             }
             for (; j < C->G->nb_vertices; j++) {
-                P[j] = P2->P[j] * w2;
+                set(j, P2->get(j) * w2);
             }
         } else { // two partial vectors
             int i = 0;
@@ -236,85 +253,90 @@ Probabilities::Probabilities(int community1, int community2) {
             int nb_vertices1 = 0;
             while ((i < P1->size) && (j < P2->size)) {
                 if (P1->vertices[i] < P2->vertices[j]) {
-                    tmp_vector1[P1->vertices[i]] = P1->P[i] * w1;
+                    tmp_vector1[P1->vertices[i]] = P1->get(i) * w1;
                     vertices1[nb_vertices1++] = P1->vertices[i];
                     i++;
                     continue;
                 }
                 if (P1->vertices[i] > P2->vertices[j]) {
-                    tmp_vector1[P2->vertices[j]] = P2->P[j] * w2;
+                    tmp_vector1[P2->vertices[j]] = P2->get(j) * w2;
                     vertices1[nb_vertices1++] = P2->vertices[j];
                     j++;
                     continue;
                 }
-                tmp_vector1[P1->vertices[i]] = P1->P[i] * w1 + P2->P[j] * w2;
+                tmp_vector1[P1->vertices[i]] = P1->get(i) * w1 + P2->get(j) * w2;
                 vertices1[nb_vertices1++] = P1->vertices[i];
                 i++;
                 j++;
             }
             if (i == P1->size) {
                 for (; j < P2->size; j++) {
-                    tmp_vector1[P2->vertices[j]] = P2->P[j] * w2;
+                    tmp_vector1[P2->vertices[j]] = P2->get(j) * w2;
                     vertices1[nb_vertices1++] = P2->vertices[j];
                 }
             } else {
                 for (; i < P1->size; i++) {
-                    tmp_vector1[P1->vertices[i]] = P1->P[i] * w1;
+                    tmp_vector1[P1->vertices[i]] = P1->get(i) * w1;
                     vertices1[nb_vertices1++] = P1->vertices[i];
                 }
             }
 
             if (nb_vertices1 > (C->G->nb_vertices / 2)) {
-                P = new double[C->G->nb_vertices];
-                size = C->G->nb_vertices;
-                vertices = nullptr;
+                allocate(C->G->nb_vertices, true);
                 for (int i = 0; i < C->G->nb_vertices; i++) {
-                    P[i] = 0.;
+                    set(i, 0.);
                 }
                 for (int i = 0; i < nb_vertices1; i++) {
-                    P[vertices1[i]] = tmp_vector1[vertices1[i]];
+                    set(vertices1[i], tmp_vector1[vertices1[i]]);
                 }
             } else {
-                P = new double[nb_vertices1];
-                size = nb_vertices1;
-                vertices = new int[nb_vertices1];
+                allocate(nb_vertices1, false);
                 for (int i = 0; i < nb_vertices1; i++) {
                     vertices[i] = vertices1[i];
-                    P[i] = tmp_vector1[vertices1[i]];
+                    set(i, tmp_vector1[vertices1[i]]);
                 }
             }
         }
     }
 }
 
-double Probabilities::compute_distance(const Probabilities* P2) const {
+static inline double square(double x) {
+    return x * x;
+}
+
+// compute the squared distance r^2 between two probability vectors, each
+// given by its size, its vertices (0 if full) and its probabilities; the
+// computation is done in double precision for both storage types
+template <class T>
+static double compute_distance(int size, const int* vertices, const T* P,
+                               int size2, const int* vertices2, const T* P2) {
     double r = 0.0;
     if (vertices) {
-        if (P2->vertices) { // two partial vectors
+        if (vertices2) { // two partial vectors
             int i = 0;
             int j = 0;
-            while ((i < size) && (j < P2->size)) {
-                if (vertices[i] < P2->vertices[j]) {
-                    r += P[i] * P[i];
+            while ((i < size) && (j < size2)) {
+                if (vertices[i] < vertices2[j]) {
+                    r += square(P[i]);
                     i++;
                     continue;
                 }
-                if (vertices[i] > P2->vertices[j]) {
-                    r += P2->P[j] * P2->P[j];
+                if (vertices[i] > vertices2[j]) {
+                    r += square(P2[j]);
                     j++;
                     continue;
                 }
-                r += (P[i] - P2->P[j]) * (P[i] - P2->P[j]);
+                r += square(double(P[i]) - P2[j]);
                 i++;
                 j++;
             }
             if (i == size) {
-                for (; j < P2->size; j++) {
-                    r += P2->P[j] * P2->P[j];
+                for (; j < size2; j++) {
+                    r += square(P2[j]);
                 }
             } else {
                 for (; i < size; i++) {
-                    r += P[i] * P[i];
+                    r += square(P[i]);
                 }
             }
         } else { // P1 partial vector, P2 full vector
@@ -322,37 +344,45 @@ double Probabilities::compute_distance(const Probabilities* P2) const {
             int i = 0;
             for (int j = 0; j < size; j++) {
                 for (; i < vertices[j]; i++) {
-                    r += P2->P[i] * P2->P[i];
+                    r += square(P2[i]);
                 }
-                r += (P[j] - P2->P[i]) * (P[j] - P2->P[i]);
+                r += square(double(P[j]) - P2[i]);
                 i++;
             }
-            for (; i < P2->size; i++) {
-                r += P2->P[i] * P2->P[i];
+            for (; i < size2; i++) {
+                r += square(P2[i]);
             }
         }
     } else {
-        if (P2->vertices) { // P1 full vector, P2 partial vector
+        if (vertices2) { // P1 full vector, P2 partial vector
             int i = 0;
-            for (int j = 0; j < P2->size; j++) {
-                for (; i < P2->vertices[j]; i++) {
-                    r += P[i] * P[i];
+            for (int j = 0; j < size2; j++) {
+                for (; i < vertices2[j]; i++) {
+                    r += square(P[i]);
                 }
-                r += (P[i] - P2->P[j]) * (P[i] - P2->P[j]);
+                r += square(double(P[i]) - P2[j]);
                 i++;
             }
             for (; i < size; i++) {
-                r += P[i] * P[i];
+                r += square(P[i]);
             }
         } else { // two full vectors
             for (int i = 0; i < size; i++) {
-                r += (P[i] - P2->P[i]) * (P[i] - P2->P[i]);
+                r += square(double(P[i]) - P2[i]);
             }
         }
     }
     return r;
 }
 
+double Probabilities::compute_distance(const Probabilities* P2) const {
+    if (P) {
+        return walktrap::compute_distance(size, vertices, P, P2->size, P2->vertices, P2->P);
+    } else {
+        return walktrap::compute_distance(size, vertices, Pf, P2->size, P2->vertices, P2->Pf);
+    }
+}
+
 Community::Community() {
     P = nullptr;
     first_neighbor = nullptr;
@@ -372,11 +402,14 @@ Community::~Community() {
 
 Communities::Communities(Graph* graph, int random_walks_length,
                          igraph_matrix_int_t *pmerges,
-                         igraph_vector_t *pmodularity) {
+                         igraph_vector_t *pmodularity,
+                         igraph_integer_t pmax_memory) {
     G = graph;
     merges = pmerges;
     mergeidx = 0;
     modularity = pmodularity;
+    max_memory = pmax_memory;
+    memory_used = 0;
 
     Probabilities::C = this;
     Probabilities::length = random_walks_length;
@@ -396,6 +429,11 @@ Communities::Communities(Graph* graph, int random_walks_length,
     }
 
     H = new Neighbor_heap(G->nb_edges);
+    if (max_memory >= 0) {
+        min_delta_sigma = new Min_delta_sigma_heap(2 * G->nb_vertices);
+    } else {
+        min_delta_sigma = nullptr;
+    }
     communities = new Community[2 * G->nb_vertices];
 
 // init the n single vertex communities
@@ -434,6 +472,9 @@ Communities::Communities(Graph* graph, int random_walks_length,
         update_neighbor(N, compute_delta_sigma(N->community1, N->community2));
         N->exact = true;
         N = H->get_first();
+        if (max_memory >= 0) {
+            manage_memory();
+        }
         /* TODO: this could use igraph_progress */
         /*     if(!silent) { */
         /*       c++; */
@@ -460,6 +501,7 @@ Communities::~Communities() {
     delete[] members;
     delete[] communities;
     delete H;
+    delete min_delta_sigma;
 
     delete[] Probabilities::tmp_vector1;
     delete[] Probabilities::tmp_vector2;
@@ -532,21 +574,107 @@ void Community::remove_neighbor(Neighbor* N) {  // remove a neighbor from the li
     }
 }
 
+double Community::min_delta_sigma() const {
+    double r = std::numeric_limits<double>::infinity();
+    for (Neighbor* N = first_neighbor; N != nullptr;) {
+        if (N->delta_sigma < r) {
+            r = N->delta_sigma;
+        }
+        if (N->community1 == this_community) {
+            N = N->next_community1;
+        } else {
+            N = N->next_community2;
+        }
+    }
+    return r;
+}
+
 void Communities::remove_neighbor(Neighbor* N) {
     communities[N->community1].remove_neighbor(N);
     communities[N->community2].remove_neighbor(N);
     H->remove(N);
+
+    if (max_memory >= 0) {
+        for (int c : { N->community1, N->community2 }) {
+            if (N->delta_sigma == min_delta_sigma->delta_sigma[c]) {
+                min_delta_sigma->delta_sigma[c] = communities[c].min_delta_sigma();
+                if (communities[c].P) {
+                    min_delta_sigma->update(c);
+                }
+            }
+        }
+    }
 }
 
 void Communities::add_neighbor(Neighbor* N) {
     communities[N->community1].add_neighbor(N);
     communities[N->community2].add_neighbor(N);
     H->add(N);
+
+    if (max_memory >= 0) {
+        for (int c : { N->community1, N->community2 }) {
+            if (N->delta_sigma < min_delta_sigma->delta_sigma[c]) {
+                min_delta_sigma->delta_sigma[c] = N->delta_sigma;
+                if (communities[c].P) {
+                    min_delta_sigma->update(c);
+                }
+            }
+        }
+    }
 }
 
 void Communities::update_neighbor(Neighbor* N, double new_delta_sigma) {
+    if (max_memory < 0) {
+        N->delta_sigma = new_delta_sigma;
+        H->update(N);
+        return;
+    }
+
+    double old_delta_sigma = N->delta_sigma;
     N->delta_sigma = new_delta_sigma;
     H->update(N);
+
+    for (int c : { N->community1, N->community2 }) {
+        if (new_delta_sigma < min_delta_sigma->delta_sigma[c]) {
+            min_delta_sigma->delta_sigma[c] = new_delta_sigma;
+        } else if (old_delta_sigma == min_delta_sigma->delta_sigma[c]) {
+            min_delta_sigma->delta_sigma[c] = communities[c].min_delta_sigma();
+        } else {
+            continue;
+        }
+        if (communities[c].P) {
+            min_delta_sigma->update(c);
+        }
+    }
+}
+
+void Communities::store_probabilities(int c, Probabilities* P) {
+    communities[c].P = P;
+    memory_used += P->memory();
+    if (max_memory >= 0) {
+        min_delta_sigma->update(c);
+    }
+}
+
+void Communities::free_probabilities(int c) {
+    if (communities[c].P) {
+        memory_used -= communities[c].P->memory();
+        delete communities[c].P;
+        communities[c].P = nullptr;
+        if (max_memory >= 0) {
+            min_delta_sigma->remove_community(c);
+        }
+    }
+}
+
+// Probability vectors are deleted starting from the communities that are the
+// farthest from all their neighbors, as these are the least likely to take
+// part in one of the next merges. Deleted vectors are recomputed from the
+// random walks when they are needed again.
+void Communities::manage_memory() {
+    while (memory_used > max_memory && !min_delta_sigma->is_empty()) {
+        free_probabilities(min_delta_sigma->get_max_community());
+    }
 }
 
 void Communities::merge_communities(Neighbor* merge_N) {
@@ -572,17 +700,11 @@ void Communities::merge_communities(Neighbor* merge_N) {
 // update the new probability vector...
 
     if (communities[c1].P && communities[c2].P) {
-        communities[nb_communities].P = new Probabilities(c1, c2);
+        store_probabilities(nb_communities, new Probabilities(c1, c2));
     }
 
-    if (communities[c1].P) {
-        delete communities[c1].P;
-        communities[c1].P = nullptr;
-    }
-    if (communities[c2].P) {
-        delete communities[c2].P;
-        communities[c2].P = nullptr;
-    }
+    free_probabilities(c1);
+    free_probabilities(c2);
 
 // update the new neighbors
 // by enumerating all the neighbors of c1 and c2
@@ -733,12 +855,18 @@ double Communities::merge_nearest_communities() {
         update_neighbor(N, compute_delta_sigma(N->community1, N->community2));
         N->exact = true;
         N = H->get_first();
+        if (max_memory >= 0) {
+            manage_memory();
+        }
     }
 
     double d = N->delta_sigma;
     remove_neighbor(N);
 
     merge_communities(N);
+    if (max_memory >= 0) {
+        manage_memory();
+    }
 
     if (merges) {
         MATRIX(*merges, mergeidx, 0) = N->community1;
@@ -770,12 +898,12 @@ double Communities::merge_nearest_communities() {
     return d;
 }
 
-double Communities::compute_delta_sigma(int community1, int community2) const {
+double Communities::compute_delta_sigma(int community1, int community2) {
     if (!communities[community1].P) {
-        communities[community1].P = new Probabilities(community1);
+        store_probabilities(community1, new Probabilities(community1));
     }
     if (!communities[community2].P) {
-        communities[community2].P = new Probabilities(community2);
+        store_probabilities(community2, new Probabilities(community2));
     }
 
     return communities[community1].P->compute_distance(communities[community2].P) * double(communities[community1].size) * double(communities[community2].size) / double(communities[community1].size + communities[community2].size);
@@ -81,7 +81,21 @@ public:
 
     int size;                         // number of probabilities stored
     int* vertices;                        // the vertices corresponding to the stored probabilities, 0 if all the probabilities are stored
-    double* P;                         // the probabilities
+    double* P;                         // the probabilities, 0 if they are stored in single precision
+    float* Pf;                         // the probabilities in single precision, used when the memory is bounded, 0 otherwise
+
+    double get(int i) const {         // the i-th stored probability
+        return P ? P[i] : Pf[i];
+    }
+    void set(int i, double p) {       // set the i-th stored probability
+        if (P) {
+            P[i] = p;
+        } else {
+            Pf[i] = static_cast<float>(p);
+        }
+    }
+    void allocate(int nb_probabilities, bool full); // allocate the storage, with vertices if not full
+    size_t memory() const;             // the memory used by this probability vector, in bytes
 
     double compute_distance(const Probabilities* P2) const;   // compute the squared distance r^2 between this probability vector and P2
     explicit Probabilities(int community);                 // compute the probability vector of a community
@@ -116,6 +130,7 @@ public:
 
     void add_neighbor(Neighbor* N);
     void remove_neighbor(Neighbor* N);
+    double min_delta_sigma() const;    // the smallest delta_sigma to an adjacent community
 
     Community();          // create an empty community
     ~Community();         // destructor
@@ -133,6 +148,11 @@ public:
     // a community points to the first_member the array which contains
     // the next member (-1 = end of the community)
     Neighbor_heap* H;     // the distances between adjacent communities.
+    Min_delta_sigma_heap* min_delta_sigma; // the communities with a stored probability vector,
+    // by their smallest delta_sigma; only used when the memory is bounded
+
+    igraph_integer_t max_memory;  // the maximum memory used by the probability vectors, -1 if unbounded
+    igraph_integer_t memory_used; // the memory currently used by the probability vectors
 
 
     Community* communities;   // array of the communities
@@ -142,13 +162,18 @@ public:
 
     Communities(Graph* G, int random_walks_length = 3,
                 igraph_matrix_int_t *merges = nullptr,
-                igraph_vector_t *modularity = nullptr);  // Constructor
+                igraph_vector_t *modularity = nullptr,
+                igraph_integer_t max_memory = -1);  // Constructor
     ~Communities();                   // Destructor
 
     void merge_communities(Neighbor* N);          // create a community by merging two existing communities
     double merge_nearest_communities();
 
-    double compute_delta_sigma(int c1, int c2) const;       // compute delta_sigma(c1,c2)
+    double compute_delta_sigma(int c1, int c2);       // compute delta_sigma(c1,c2)
+
+    void store_probabilities(int c, Probabilities* P);  // set the probability vector of a community
+    void free_probabilities(int c);                     // delete the probability vector of a community
+    void manage_memory();             // delete probability vectors until the memory bound is met
 
     void remove_neighbor(Neighbor* N);
     void add_neighbor(Neighbor* N);
@@ -55,6 +55,8 @@
 
 #include "walktrap_heap.h"
 
+#include <limits>
+
 using namespace igraph::walktrap;
 
 void Neighbor_heap::move_up(int index) {
@@ -140,3 +142,91 @@ Neighbor_heap::~Neighbor_heap() {
 bool Neighbor_heap::is_empty() const {
     return (size == 0);
 }
+
+void Min_delta_sigma_heap::move_up(int index) {
+    while (index > 0 && delta_sigma[H[(index - 1) / 2]] < delta_sigma[H[index]]) {
+        int parent = (index - 1) / 2;
+        int tmp = H[parent];
+        I[H[index]] = parent;
+        H[parent] = H[index];
+        I[tmp] = index;
+        H[index] = tmp;
+        index = parent;
+    }
+}
+
+void Min_delta_sigma_heap::move_down(int index) {
+    while (true) {
+        int max = index;
+        if (2 * index + 1 < size && delta_sigma[H[2 * index + 1]] > delta_sigma[H[max]]) {
+            max = 2 * index + 1;
+        }
+        if (2 * index + 2 < size && delta_sigma[H[2 * index + 2]] > delta_sigma[H[max]]) {
+            max = 2 * index + 2;
+        }
+        if (max != index) {
+            int tmp = H[max];
+            I[H[index]] = max;
+            H[max] = H[index];
+            I[tmp] = index;
+            H[index] = tmp;
+            index = max;
+        } else {
+            break;
+        }
+    }
+}
+
+int Min_delta_sigma_heap::get_max_community() {
+    if (size == 0) {
+        return -1;
+    } else {
+        return H[0];
+    }
+}
+
+void Min_delta_sigma_heap::remove_community(int community) {
+    if (I[community] == -1 || size == 0) {
+        return;
+    }
+    int last_community = H[--size];
+    H[I[community]] = last_community;
+    I[last_community] = I[community];
+    move_up(I[last_community]);
+    move_down(I[last_community]);
+    I[community] = -1;
+}
+
+void Min_delta_sigma_heap::update(int community) {
+    if (community < 0 || community >= max_size) {
+        return;
+    }
+    if (I[community] == -1) {
+        I[community] = size++;
+        H[I[community]] = community;
+    }
+    move_up(I[community]);
+    move_down(I[community]);
+}
+
+Min_delta_sigma_heap::Min_delta_sigma_heap(int max_s) {
+    max_size = max_s;
+    size = 0;
+    H = new int[max_s];
+    I = new int[max_s];
+    delta_sigma = new double[max_s];
+    for (int i = 0; i < max_s; i++) {
+        I[i] = -1;
+        delta_sigma[i] = std::numeric_limits<double>::infinity();
+    }
+}
+
+Min_delta_sigma_heap::~Min_delta_sigma_heap() {
+    delete[] H;
+    delete[] I;
+    delete[] delta_sigma;
+}
+
+bool Min_delta_sigma_heap::is_empty() const {
+    return (size == 0);
+}
@@ -101,6 +101,29 @@ public:
     ~Neighbor_heap();
 };
 
+class Min_delta_sigma_heap {
+private:
+    int size;
+    int max_size;
+
+    int* H;   // the heap that contains the number of each community
+    int* I;   // the index of each community in the heap (-1 = not stored)
+
+    void move_up(int index);
+    void move_down(int index);
+
+public:
+    int get_max_community();          // return the community with the largest delta_sigma
+    void remove_community(int community); // remove a community
+    void update(int community);       // add a community or update its position
+    bool is_empty() const;
+
+    double* delta_sigma;              // the delta_sigma of the communities, by community number
+
+    explicit Min_delta_sigma_heap(int max_size);
+    ~Min_delta_sigma_heap();
+};
+
 }
 }        /* end of namespaces */
 
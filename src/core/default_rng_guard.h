@@ -0,0 +1,43 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_CORE_DEFAULT_RNG_GUARD_H
+#define IGRAPH_CORE_DEFAULT_RNG_GUARD_H
+
+#include "igraph_random.h"
+
+// Makes an RNG the default one of the current thread while the object exists.
+// Used by C++ code that runs randomized tasks on their own random number
+// streams, see igraph_i_parallel_run_tasks(), when the task draws its random
+// numbers from the default RNG.
+class DefaultRNGGuard {
+    igraph_rng_t saved;
+
+    DefaultRNGGuard(const DefaultRNGGuard&);
+    DefaultRNGGuard& operator=(const DefaultRNGGuard&);
+
+public:
+    explicit DefaultRNGGuard(igraph_rng_t *rng) : saved(*igraph_rng_default()) {
+        igraph_rng_set_default(rng);
+    }
+    ~DefaultRNGGuard() {
+        igraph_rng_set_default(&saved);
+    }
+};
+
+#endif // IGRAPH_CORE_DEFAULT_RNG_GUARD_H
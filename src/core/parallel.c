@@ -0,0 +1,184 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/parallel.h"
+
+#include "igraph_memory.h"
+
+#include "core/interruption.h"
+
+/* Number of tasks per thread that are run between two checks for
+ * interruption in parallel mode. */
+#define PARALLEL_TASKS_PER_ROUND 16
+
+/* The random number generators and workspaces of the threads running a set
+ * of tasks. Only the first 'no_of_rngs' generators and 'no_of_workspaces'
+ * workspaces are initialized. */
+typedef struct {
+    const igraph_i_parallel_tasks_t *tasks;
+    igraph_rng_t *rngs;
+    void **workspaces;
+    igraph_integer_t no_of_rngs, no_of_workspaces;
+} igraph_i_parallel_threads_t;
+
+static void igraph_i_parallel_threads_destroy(igraph_i_parallel_threads_t *threads) {
+    for (igraph_integer_t i = 0; i < threads->no_of_workspaces; i++) {
+        threads->tasks->workspace_destroy(threads->workspaces[i]);
+    }
+    for (igraph_integer_t i = 0; i < threads->no_of_rngs; i++) {
+        igraph_rng_destroy(&threads->rngs[i]);
+    }
+    IGRAPH_FREE(threads->workspaces);
+    IGRAPH_FREE(threads->rngs);
+}
+
+/* Workspaces are set up by the calling thread, so that errors are raised
+ * outside of parallel regions. */
+static igraph_error_t igraph_i_parallel_threads_init(igraph_i_parallel_threads_t *threads,
+                                                     const igraph_i_parallel_tasks_t *tasks,
+                                                     igraph_integer_t no_of_threads) {
+    threads->tasks = tasks;
+    threads->workspaces = NULL;
+    threads->no_of_rngs = threads->no_of_workspaces = 0;
+
+    threads->rngs = IGRAPH_CALLOC(no_of_threads, igraph_rng_t);
+    IGRAPH_CHECK_OOM(threads->rngs, "Insufficient memory for parallel tasks.");
+    IGRAPH_FINALLY(igraph_i_parallel_threads_destroy, threads);
+
+    if (tasks->workspace_init) {
+        threads->workspaces = IGRAPH_CALLOC(no_of_threads, void *);
+        IGRAPH_CHECK_OOM(threads->workspaces, "Insufficient memory for parallel tasks.");
+    }
+
+    for (igraph_integer_t i = 0; i < no_of_threads; i++) {
+        IGRAPH_CHECK(igraph_rng_init(&threads->rngs[i], &igraph_rngtype_philox4x32));
+        threads->no_of_rngs++;
+        if (tasks->workspace_init) {
+            IGRAPH_CHECK(tasks->workspace_init(tasks->data, &threads->workspaces[i]));
+            threads->no_of_workspaces++;
+        }
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_i_parallel_run_task(const igraph_i_parallel_threads_t *threads,
+                                                 igraph_integer_t thread,
+                                                 igraph_integer_t task) {
+    const igraph_i_parallel_tasks_t *tasks = threads->tasks;
+    igraph_rng_t *rng = &threads->rngs[thread];
+
+    igraph_rng_seed_stream(rng, tasks->seed, (igraph_uint_t) task);
+    return tasks->run(tasks->data, threads->workspaces ? threads->workspaces[thread] : NULL,
+                      rng, task);
+}
+
+/**
+ * Runs a set of independent randomized tasks, in parallel if possible, see
+ * igraph_i_parallel_tasks_t. Each thread has its own random number
+ * generator and workspace. When a task fails, no new tasks are started, and
+ * the error is raised with the reason given in the task set. Without
+ * parallelism, the tasks are run in order, and the user may interrupt the
+ * computation between two tasks. In parallel, the user may interrupt it
+ * after every PARALLEL_TASKS_PER_ROUND tasks per thread.
+ */
+igraph_error_t igraph_i_parallel_run_tasks(const igraph_i_parallel_tasks_t *tasks) {
+    igraph_integer_t no_of_threads = igraph_i_parallel_max_threads();
+    igraph_i_parallel_threads_t threads;
+
+    if (tasks->no_of_tasks == 0) {
+        return IGRAPH_SUCCESS;
+    }
+    if (no_of_threads > tasks->no_of_tasks) {
+        no_of_threads = tasks->no_of_tasks;
+    }
+#ifndef IGRAPH_I_PARALLEL_API
+    no_of_threads = 1;
+#endif
+
+    IGRAPH_CHECK(igraph_i_parallel_threads_init(&threads, tasks, no_of_threads));
+    IGRAPH_FINALLY(igraph_i_parallel_threads_destroy, &threads);
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_threads > 1) {
+        /* Tasks are run in rounds, so that the user can interrupt the
+         * computation between them, outside of the parallel region. */
+        igraph_integer_t round_size = no_of_threads * PARALLEL_TASKS_PER_ROUND;
+        int error = IGRAPH_SUCCESS;
+
+        for (igraph_integer_t from = 0; from < tasks->no_of_tasks; from += round_size) {
+            igraph_integer_t to = tasks->no_of_tasks - from > round_size ?
+                                  from + round_size : tasks->no_of_tasks;
+
+#pragma omp parallel num_threads(no_of_threads)
+            {
+                igraph_error_handler_t *handler = igraph_i_parallel_enter();
+                igraph_integer_t thread = omp_get_thread_num();
+
+#pragma omp for schedule(dynamic, 1)
+                for (igraph_integer_t task = from; task < to; task++) {
+                    igraph_error_t ret;
+                    int current_error;
+
+#pragma omp atomic read
+                    current_error = error;
+                    if (current_error != IGRAPH_SUCCESS) {
+                        continue;
+                    }
+
+                    ret = igraph_i_parallel_run_task(&threads, thread, task);
+                    if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                        error = ret;
+                    }
+                }
+
+                igraph_i_parallel_exit(handler);
+            }
+
+            if (error != IGRAPH_SUCCESS) {
+                IGRAPH_ERROR(tasks->error_message, (igraph_error_t) error);
+            }
+
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+    } else
+#endif
+    {
+        for (igraph_integer_t task = 0; task < tasks->no_of_tasks; task++) {
+            igraph_error_t ret = igraph_i_parallel_run_task(&threads, 0, task);
+            if (ret != IGRAPH_SUCCESS) {
+                IGRAPH_ERROR(tasks->error_message, ret);
+            }
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+    }
+
+    if (tasks->collect) {
+        for (igraph_integer_t i = 0; i < threads.no_of_workspaces; i++) {
+            IGRAPH_CHECK(tasks->collect(tasks->data, threads.workspaces[i]));
+        }
+    }
+
+    igraph_i_parallel_threads_destroy(&threads);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
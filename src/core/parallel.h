@@ -0,0 +1,114 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_CORE_PARALLEL_H
+#define IGRAPH_CORE_PARALLEL_H
+
+#include "igraph_decls.h"
+#include "igraph_error.h"
+#include "igraph_random.h"
+#include "igraph_threading.h"
+
+/* Parallel code paths are written with OpenMP pragmas. They rely on
+ * 'atomic capture' and on 'min' / 'max' reductions, which first appeared
+ * in OpenMP 3.1; older implementations (such as the one in MSVC) fall
+ * back to the sequential code. Parallel regions must not allocate memory
+ * or raise igraph errors, unless they follow the rules described at
+ * igraph_i_parallel_enter() below; otherwise all workspace is set up before
+ * entering them. */
+#if defined(_OPENMP) && _OPENMP >= 201107
+#  include <omp.h>
+#  define IGRAPH_I_PARALLEL 1
+#endif
+
+/* IGRAPH_I_OMP(omp parallel for) expands to the corresponding pragma when
+ * parallel code paths are available, and to nothing otherwise. Use it in
+ * code that is shared between the sequential and parallel versions. */
+#ifdef IGRAPH_I_PARALLEL
+#  define IGRAPH_I_OMP(directive) _Pragma(#directive)
+#else
+#  define IGRAPH_I_OMP(directive)
+#endif
+
+/* Parallel regions may call igraph functions that allocate memory or raise
+ * errors only if the error handler and the 'finally' stack are thread-local,
+ * i.e. if igraph was built with thread-local storage. */
+#if defined(IGRAPH_I_PARALLEL) && IGRAPH_THREAD_SAFE
+#  define IGRAPH_I_PARALLEL_API 1
+#endif
+
+__BEGIN_DECLS
+
+/* The number of threads that a parallel region would use, or 1 if
+ * parallel code paths are not available. */
+static inline int igraph_i_parallel_max_threads(void) {
+#ifdef IGRAPH_I_PARALLEL
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+/* Each thread of a parallel region that calls fallible igraph functions
+ * brackets its work with igraph_i_parallel_enter() and
+ * igraph_i_parallel_exit(). In between, errors do not reach the user's error
+ * handler (which may not return normally, e.g. it may longjmp), and only
+ * unwind the part of the thread's 'finally' stack that was set up within the
+ * region. Failing calls still return their error code: the region must
+ * collect it, and raise it with IGRAPH_ERROR() after the region has ended. */
+static inline igraph_error_handler_t *igraph_i_parallel_enter(void) {
+    IGRAPH_FINALLY_ENTER();
+    return igraph_set_error_handler(igraph_error_handler_ignore);
+}
+
+static inline void igraph_i_parallel_exit(igraph_error_handler_t *saved_handler) {
+    igraph_set_error_handler(saved_handler);
+    IGRAPH_FINALLY_EXIT();
+}
+
+#endif
+
+/* Independent randomized tasks, run by igraph_i_parallel_run_tasks(). Task
+ * 'i' draws its random numbers from stream 'i' of 'seed' (see
+ * igraph_rng_seed_stream()), which makes the results independent of the
+ * number of threads and of the order in which tasks are completed. 'seed'
+ * is usually taken from igraph_i_rng_stream_seed().
+ *
+ * Tasks report errors by returning an error code, they must not raise
+ * exceptions or check for interruption. The workspace callbacks are optional;
+ * 'collect' is called for the workspace of each thread, one at a time, after
+ * all tasks have succeeded. */
+typedef struct igraph_i_parallel_tasks_t {
+    igraph_integer_t no_of_tasks;
+    igraph_uint_t seed;
+    void *data;
+    igraph_error_t (*run)(void *data, void *workspace, igraph_rng_t *rng, igraph_integer_t task);
+    igraph_error_t (*workspace_init)(void *data, void **workspace);
+    igraph_error_t (*collect)(void *data, void *workspace);
+    void (*workspace_destroy)(void *workspace);
+    /* Reason given when a task fails. */
+    const char *error_message;
+} igraph_i_parallel_tasks_t;
+
+igraph_error_t igraph_i_parallel_run_tasks(const igraph_i_parallel_tasks_t *tasks);
+
+__END_DECLS
+
+#endif
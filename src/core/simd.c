@@ -0,0 +1,651 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/simd.h"
+
+#include "igraph_error.h"
+
+#include <math.h>
+
+/* SSE2 is part of x86-64, and NEON is part of AArch64, so these are used
+ * whenever igraph is compiled for these architectures. AVX2 and AVX-512
+ * kernels are compiled with function attributes, and are selected at run
+ * time if the CPU supports them; this needs GCC or Clang. The integer
+ * kernels assume 64-bit igraph_integer_t. */
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#  define IGRAPH_I_SIMD_HAVE_SSE2 1
+#  include <emmintrin.h>
+#  if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5)
+#    define IGRAPH_I_SIMD_HAVE_AVX 1
+#    include <immintrin.h>
+#  endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#  define IGRAPH_I_SIMD_HAVE_NEON 1
+#  include <arm_neon.h>
+#endif
+
+/* The number of partial results of sums and products. All instruction sets
+ * use the same number, so that they give the same results. */
+#define IGRAPH_I_SIMD_LANES 16
+
+typedef struct igraph_i_simd_kernels_t {
+    igraph_real_t (*sum)(const igraph_real_t *x, igraph_integer_t n);
+    igraph_real_t (*prod)(const igraph_real_t *x, igraph_integer_t n);
+    igraph_real_t (*sumsq)(const igraph_real_t *x, igraph_integer_t n);
+    void (*scale)(igraph_real_t *x, igraph_integer_t n, igraph_real_t by);
+    void (*add_constant)(igraph_real_t *x, igraph_integer_t n, igraph_real_t plus);
+    void (*add)(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+    void (*sub)(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+    void (*mul)(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+    void (*div)(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+    igraph_real_t (*max)(const igraph_real_t *x, igraph_integer_t n, igraph_bool_t *nan);
+    igraph_real_t (*min)(const igraph_real_t *x, igraph_integer_t n, igraph_bool_t *nan);
+    igraph_bool_t (*minmax)(const igraph_real_t *x, igraph_integer_t n,
+                            igraph_real_t *min, igraph_real_t *max);
+    igraph_integer_t (*find)(const igraph_real_t *x, igraph_integer_t n, igraph_real_t value);
+    igraph_bool_t (*isininterval)(const igraph_real_t *x, igraph_integer_t n,
+                                  igraph_real_t low, igraph_real_t high);
+    igraph_real_t (*maxdifference)(const igraph_real_t *x, const igraph_real_t *y,
+                                   igraph_integer_t n, igraph_bool_t *nan);
+    igraph_integer_t (*int_sum)(const igraph_integer_t *x, igraph_integer_t n);
+    void (*int_add_constant)(igraph_integer_t *x, igraph_integer_t n, igraph_integer_t plus);
+    void (*int_add)(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n);
+    void (*int_sub)(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n);
+    void (*int_cumsum)(igraph_integer_t *to, const igraph_integer_t *from, igraph_integer_t n);
+    igraph_integer_t (*int_find)(const igraph_integer_t *x, igraph_integer_t n, igraph_integer_t value);
+    igraph_integer_t (*int_max)(const igraph_integer_t *x, igraph_integer_t n);
+    igraph_integer_t (*int_min)(const igraph_integer_t *x, igraph_integer_t n);
+    void (*int_minmax)(const igraph_integer_t *x, igraph_integer_t n,
+                       igraph_integer_t *min, igraph_integer_t *max);
+} igraph_i_simd_kernels_t;
+
+/* Combines the partial results pairwise: lane j with lane j + 8, then with
+ * lane j + 4, and so on. */
+static igraph_real_t igraph_i_simd_reduce_sum(igraph_real_t *lanes) {
+    int width, j;
+    for (width = IGRAPH_I_SIMD_LANES / 2; width > 0; width /= 2) {
+        for (j = 0; j < width; j++) {
+            lanes[j] += lanes[j + width];
+        }
+    }
+    return lanes[0];
+}
+
+static igraph_real_t igraph_i_simd_reduce_prod(igraph_real_t *lanes) {
+    int width, j;
+    for (width = IGRAPH_I_SIMD_LANES / 2; width > 0; width /= 2) {
+        for (j = 0; j < width; j++) {
+            lanes[j] *= lanes[j + width];
+        }
+    }
+    return lanes[0];
+}
+
+/* Scalar kernels, for other architectures, and for the integer kernels that
+ * an instruction set does not have. */
+
+#define KERNEL(name) igraph_i_simd_scalar_ ## name
+#define TARGET
+#define W 1
+#define VD igraph_real_t
+#define VD_LOAD(p) (*(p))
+#define VD_STORE(p, v) (*(p) = (v))
+#define VD_SET1(x) (x)
+#define VD_ADD(a, b) ((a) + (b))
+#define VD_SUB(a, b) ((a) - (b))
+#define VD_MUL(a, b) ((a) * (b))
+#define VD_DIV(a, b) ((a) / (b))
+#define VD_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define VD_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define VD_ABS(a) fabs(a)
+#define MD igraph_bool_t
+#define MD_FALSE false
+#define MD_UNORD(a, b) (isnan(a) || isnan(b))
+#define MD_EQ(a, b) ((a) == (b))
+#define MD_GE(a, b) ((a) >= (b))
+#define MD_LE(a, b) ((a) <= (b))
+#define MD_OR(a, b) ((a) || (b))
+#define MD_AND(a, b) ((a) && (b))
+#define MD_ANY(m) (m)
+#define MD_ALL(m) (m)
+#define WI 1
+#define VI igraph_integer_t
+#define VI_LOAD(p) (*(p))
+#define VI_STORE(p, v) (*(p) = (v))
+#define VI_SET1(x) (x)
+#define VI_ADD(a, b) ((a) + (b))
+#define VI_SUB(a, b) ((a) - (b))
+#define VI_MAX(a, b) ((a) > (b) ? (a) : (b))
+#define VI_MIN(a, b) ((a) < (b) ? (a) : (b))
+#define VI_PREFIX(v) (v)
+#define VI_LAST(v) (v)
+#define MI igraph_bool_t
+#define MI_EQ(a, b) ((a) == (b))
+#define MI_ANY(m) (m)
+#include "simd.pmt"
+#include "simd_off.h"
+
+#ifdef IGRAPH_I_SIMD_HAVE_SSE2
+
+#if IGRAPH_INTEGER_SIZE == 64
+static inline __m128i igraph_i_simd_sse2_cmpeq_epi64(__m128i a, __m128i b) {
+    __m128i eq = _mm_cmpeq_epi32(a, b);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+#endif
+
+#define KERNEL(name) igraph_i_simd_sse2_ ## name
+#define TARGET
+#define W 2
+#define VD __m128d
+#define VD_LOAD(p) _mm_loadu_pd(p)
+#define VD_STORE(p, v) _mm_storeu_pd((p), (v))
+#define VD_SET1(x) _mm_set1_pd(x)
+#define VD_ADD(a, b) _mm_add_pd((a), (b))
+#define VD_SUB(a, b) _mm_sub_pd((a), (b))
+#define VD_MUL(a, b) _mm_mul_pd((a), (b))
+#define VD_DIV(a, b) _mm_div_pd((a), (b))
+#define VD_MAX(a, b) _mm_max_pd((a), (b))
+#define VD_MIN(a, b) _mm_min_pd((a), (b))
+#define VD_ABS(a) _mm_andnot_pd(_mm_set1_pd(-0.0), (a))
+#define MD __m128d
+#define MD_FALSE _mm_setzero_pd()
+#define MD_UNORD(a, b) _mm_cmpunord_pd((a), (b))
+#define MD_EQ(a, b) _mm_cmpeq_pd((a), (b))
+#define MD_GE(a, b) _mm_cmpge_pd((a), (b))
+#define MD_LE(a, b) _mm_cmple_pd((a), (b))
+#define MD_OR(a, b) _mm_or_pd((a), (b))
+#define MD_AND(a, b) _mm_and_pd((a), (b))
+#define MD_ANY(m) (_mm_movemask_pd(m) != 0)
+#define MD_ALL(m) (_mm_movemask_pd(m) == 0x3)
+#if IGRAPH_INTEGER_SIZE == 64
+#  define WI 2
+#  define VI __m128i
+#  define VI_LOAD(p) _mm_loadu_si128((const __m128i *) (p))
+#  define VI_STORE(p, v) _mm_storeu_si128((__m128i *) (p), (v))
+#  define VI_SET1(x) _mm_set1_epi64x(x)
+#  define VI_ADD(a, b) _mm_add_epi64((a), (b))
+#  define VI_SUB(a, b) _mm_sub_epi64((a), (b))
+#  define VI_PREFIX(v) _mm_add_epi64((v), _mm_slli_si128((v), 8))
+#  define VI_LAST(v) _mm_shuffle_epi32((v), _MM_SHUFFLE(3, 2, 3, 2))
+#  define MI __m128i
+#  define MI_EQ(a, b) igraph_i_simd_sse2_cmpeq_epi64((a), (b))
+#  define MI_ANY(m) (_mm_movemask_epi8(m) != 0)
+#endif
+#include "simd.pmt"
+#include "simd_off.h"
+
+#endif /* IGRAPH_I_SIMD_HAVE_SSE2 */
+
+#ifdef IGRAPH_I_SIMD_HAVE_AVX
+
+#define IGRAPH_I_TARGET_AVX2 __attribute__((target("avx2")))
+
+#if IGRAPH_INTEGER_SIZE == 64
+static inline IGRAPH_I_TARGET_AVX2 __m256i igraph_i_simd_avx2_prefix_epi64(__m256i v) {
+    __m256i zero = _mm256_setzero_si256();
+    /* Shift by one and then by two elements, and add. */
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+    return v;
+}
+#endif
+
+#define KERNEL(name) igraph_i_simd_avx2_ ## name
+#define TARGET IGRAPH_I_TARGET_AVX2
+#define W 4
+#define VD __m256d
+#define VD_LOAD(p) _mm256_loadu_pd(p)
+#define VD_STORE(p, v) _mm256_storeu_pd((p), (v))
+#define VD_SET1(x) _mm256_set1_pd(x)
+#define VD_ADD(a, b) _mm256_add_pd((a), (b))
+#define VD_SUB(a, b) _mm256_sub_pd((a), (b))
+#define VD_MUL(a, b) _mm256_mul_pd((a), (b))
+#define VD_DIV(a, b) _mm256_div_pd((a), (b))
+#define VD_MAX(a, b) _mm256_max_pd((a), (b))
+#define VD_MIN(a, b) _mm256_min_pd((a), (b))
+#define VD_ABS(a) _mm256_andnot_pd(_mm256_set1_pd(-0.0), (a))
+#define MD __m256d
+#define MD_FALSE _mm256_setzero_pd()
+#define MD_UNORD(a, b) _mm256_cmp_pd((a), (b), _CMP_UNORD_Q)
+#define MD_EQ(a, b) _mm256_cmp_pd((a), (b), _CMP_EQ_OQ)
+#define MD_GE(a, b) _mm256_cmp_pd((a), (b), _CMP_GE_OQ)
+#define MD_LE(a, b) _mm256_cmp_pd((a), (b), _CMP_LE_OQ)
+#define MD_OR(a, b) _mm256_or_pd((a), (b))
+#define MD_AND(a, b) _mm256_and_pd((a), (b))
+#define MD_ANY(m) (_mm256_movemask_pd(m) != 0)
+#define MD_ALL(m) (_mm256_movemask_pd(m) == 0xF)
+#if IGRAPH_INTEGER_SIZE == 64
+#  define WI 4
+#  define VI __m256i
+#  define VI_LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#  define VI_STORE(p, v) _mm256_storeu_si256((__m256i *) (p), (v))
+#  define VI_SET1(x) _mm256_set1_epi64x(x)
+#  define VI_ADD(a, b) _mm256_add_epi64((a), (b))
+#  define VI_SUB(a, b) _mm256_sub_epi64((a), (b))
+#  define VI_MAX(a, b) _mm256_blendv_epi8((b), (a), _mm256_cmpgt_epi64((a), (b)))
+#  define VI_MIN(a, b) _mm256_blendv_epi8((a), (b), _mm256_cmpgt_epi64((a), (b)))
+#  define VI_PREFIX(v) igraph_i_simd_avx2_prefix_epi64(v)
+#  define VI_LAST(v) _mm256_permute4x64_epi64((v), _MM_SHUFFLE(3, 3, 3, 3))
+#  define MI __m256i
+#  define MI_EQ(a, b) _mm256_cmpeq_epi64((a), (b))
+#  define MI_ANY(m) (_mm256_movemask_epi8(m) != 0)
+#endif
+#include "simd.pmt"
+#include "simd_off.h"
+
+#define IGRAPH_I_TARGET_AVX512 __attribute__((target("avx512f")))
+
+#if IGRAPH_INTEGER_SIZE == 64
+static inline IGRAPH_I_TARGET_AVX512 __m512i igraph_i_simd_avx512_prefix_epi64(__m512i v) {
+    __m512i zero = _mm512_setzero_si512();
+    /* Shift by one, two and four elements, and add. */
+    v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 7));
+    v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 6));
+    v = _mm512_add_epi64(v, _mm512_alignr_epi64(v, zero, 4));
+    return v;
+}
+#endif
+
+#define KERNEL(name) igraph_i_simd_avx512_ ## name
+#define TARGET IGRAPH_I_TARGET_AVX512
+#define W 8
+#define VD __m512d
+#define VD_LOAD(p) _mm512_loadu_pd(p)
+#define VD_STORE(p, v) _mm512_storeu_pd((p), (v))
+#define VD_SET1(x) _mm512_set1_pd(x)
+#define VD_ADD(a, b) _mm512_add_pd((a), (b))
+#define VD_SUB(a, b) _mm512_sub_pd((a), (b))
+#define VD_MUL(a, b) _mm512_mul_pd((a), (b))
+#define VD_DIV(a, b) _mm512_div_pd((a), (b))
+#define VD_MAX(a, b) _mm512_max_pd((a), (b))
+#define VD_MIN(a, b) _mm512_min_pd((a), (b))
+#define VD_ABS(a) _mm512_abs_pd(a)
+#define MD __mmask8
+#define MD_FALSE 0
+#define MD_UNORD(a, b) _mm512_cmp_pd_mask((a), (b), _CMP_UNORD_Q)
+#define MD_EQ(a, b) _mm512_cmp_pd_mask((a), (b), _CMP_EQ_OQ)
+#define MD_GE(a, b) _mm512_cmp_pd_mask((a), (b), _CMP_GE_OQ)
+#define MD_LE(a, b) _mm512_cmp_pd_mask((a), (b), _CMP_LE_OQ)
+#define MD_OR(a, b) ((__mmask8) ((a) | (b)))
+#define MD_AND(a, b) ((__mmask8) ((a) & (b)))
+#define MD_ANY(m) ((m) != 0)
+#define MD_ALL(m) ((m) == 0xFF)
+#if IGRAPH_INTEGER_SIZE == 64
+#  define WI 8
+#  define VI __m512i
+#  define VI_LOAD(p) _mm512_loadu_si512((const void *) (p))
+#  define VI_STORE(p, v) _mm512_storeu_si512((void *) (p), (v))
+#  define VI_SET1(x) _mm512_set1_epi64(x)
+#  define VI_ADD(a, b) _mm512_add_epi64((a), (b))
+#  define VI_SUB(a, b) _mm512_sub_epi64((a), (b))
+#  define VI_MAX(a, b) _mm512_max_epi64((a), (b))
+#  define VI_MIN(a, b) _mm512_min_epi64((a), (b))
+#  define VI_PREFIX(v) igraph_i_simd_avx512_prefix_epi64(v)
+#  define VI_LAST(v) _mm512_permutexvar_epi64(_mm512_set1_epi64(7), (v))
+#  define MI __mmask8
+#  define MI_EQ(a, b) _mm512_cmpeq_epi64_mask((a), (b))
+#  define MI_ANY(m) ((m) != 0)
+#endif
+#include "simd.pmt"
+#include "simd_off.h"
+
+#endif /* IGRAPH_I_SIMD_HAVE_AVX */
+
+#ifdef IGRAPH_I_SIMD_HAVE_NEON
+
+static inline uint64x2_t igraph_i_simd_neon_cmpunord_f64(float64x2_t a, float64x2_t b) {
+    uint64x2_t ord = vandq_u64(vceqq_f64(a, a), vceqq_f64(b, b));
+    return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(ord)));
+}
+
+#define KERNEL(name) igraph_i_simd_neon_ ## name
+#define TARGET
+#define W 2
+#define VD float64x2_t
+#define VD_LOAD(p) vld1q_f64(p)
+#define VD_STORE(p, v) vst1q_f64((p), (v))
+#define VD_SET1(x) vdupq_n_f64(x)
+#define VD_ADD(a, b) vaddq_f64((a), (b))
+#define VD_SUB(a, b) vsubq_f64((a), (b))
+#define VD_MUL(a, b) vmulq_f64((a), (b))
+#define VD_DIV(a, b) vdivq_f64((a), (b))
+#define VD_MAX(a, b) vmaxq_f64((a), (b))
+#define VD_MIN(a, b) vminq_f64((a), (b))
+#define VD_ABS(a) vabsq_f64(a)
+#define MD uint64x2_t
+#define MD_FALSE vdupq_n_u64(0)
+#define MD_UNORD(a, b) igraph_i_simd_neon_cmpunord_f64((a), (b))
+#define MD_EQ(a, b) vceqq_f64((a), (b))
+#define MD_GE(a, b) vcgeq_f64((a), (b))
+#define MD_LE(a, b) vcleq_f64((a), (b))
+#define MD_OR(a, b) vorrq_u64((a), (b))
+#define MD_AND(a, b) vandq_u64((a), (b))
+#define MD_ANY(m) (vmaxvq_u32(vreinterpretq_u32_u64(m)) != 0)
+#define MD_ALL(m) (vminvq_u32(vreinterpretq_u32_u64(m)) != 0)
+#if IGRAPH_INTEGER_SIZE == 64
+#  define WI 2
+#  define VI int64x2_t
+#  define VI_LOAD(p) vld1q_s64(p)
+#  define VI_STORE(p, v) vst1q_s64((p), (v))
+#  define VI_SET1(x) vdupq_n_s64(x)
+#  define VI_ADD(a, b) vaddq_s64((a), (b))
+#  define VI_SUB(a, b) vsubq_s64((a), (b))
+#  define VI_MAX(a, b) vbslq_s64(vcgtq_s64((a), (b)), (a), (b))
+#  define VI_MIN(a, b) vbslq_s64(vcgtq_s64((a), (b)), (b), (a))
+#  define VI_PREFIX(v) vaddq_s64((v), vextq_s64(vdupq_n_s64(0), (v), 1))
+#  define VI_LAST(v) vdupq_laneq_s64((v), 1)
+#  define MI uint64x2_t
+#  define MI_EQ(a, b) vceqq_s64((a), (b))
+#  define MI_ANY(m) (vmaxvq_u32(vreinterpretq_u32_u64(m)) != 0)
+#endif
+#include "simd.pmt"
+#include "simd_off.h"
+
+#endif /* IGRAPH_I_SIMD_HAVE_NEON */
+
+/* Set by igraph_i_simd_force_level(), for testing; -1 if not forced. */
+static int igraph_i_simd_forced_level = -1;
+
+static igraph_i_simd_level_t igraph_i_simd_detect(void) {
+#ifdef IGRAPH_I_SIMD_HAVE_AVX
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return IGRAPH_I_SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return IGRAPH_I_SIMD_AVX2;
+    }
+#endif
+#if defined(IGRAPH_I_SIMD_HAVE_SSE2)
+    return IGRAPH_I_SIMD_SSE2;
+#elif defined(IGRAPH_I_SIMD_HAVE_NEON)
+    return IGRAPH_I_SIMD_NEON;
+#else
+    return IGRAPH_I_SIMD_SCALAR;
+#endif
+}
+
+#ifdef IGRAPH_I_SIMD_HAVE_AVX
+
+/* The best instruction set that the CPU supports; -1 until it is first
+ * needed. Threads that look it up at the same time store the same value.
+ * It is accessed with the atomic builtins of GCC and Clang, which are
+ * available whenever the CPU is queried at run time, so that this does not
+ * depend on OpenMP. */
+static int igraph_i_simd_detected_level = -1;
+
+/* The best instruction set that the CPU supports, detected on the
+ * first call only. */
+static igraph_i_simd_level_t igraph_i_simd_detected(void) {
+    int level = __atomic_load_n(&igraph_i_simd_detected_level, __ATOMIC_RELAXED);
+
+    if (level < 0) {
+        level = igraph_i_simd_detect();
+        __atomic_store_n(&igraph_i_simd_detected_level, level, __ATOMIC_RELAXED);
+    }
+
+    return (igraph_i_simd_level_t) level;
+}
+
+#else
+
+/* Without run time detection, the instruction set is known at compile time,
+ * and there is nothing to cache. */
+static igraph_i_simd_level_t igraph_i_simd_detected(void) {
+    return igraph_i_simd_detect();
+}
+
+#endif /* IGRAPH_I_SIMD_HAVE_AVX */
+
+/* The instruction set used by the kernels: the best one that the CPU
+ * supports, unless another one was forced. */
+igraph_i_simd_level_t igraph_i_simd_level(void) {
+    if (igraph_i_simd_forced_level >= 0) {
+        return (igraph_i_simd_level_t) igraph_i_simd_forced_level;
+    }
+    return igraph_i_simd_detected();
+}
+
+igraph_bool_t igraph_i_simd_level_supported(igraph_i_simd_level_t level) {
+    switch (level) {
+    case IGRAPH_I_SIMD_SCALAR:
+        return true;
+#ifdef IGRAPH_I_SIMD_HAVE_SSE2
+    case IGRAPH_I_SIMD_SSE2:
+        return true;
+#endif
+#ifdef IGRAPH_I_SIMD_HAVE_AVX
+    case IGRAPH_I_SIMD_AVX2:
+    case IGRAPH_I_SIMD_AVX512:
+        return igraph_i_simd_detected() >= level;
+#endif
+#ifdef IGRAPH_I_SIMD_HAVE_NEON
+    case IGRAPH_I_SIMD_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+/* Makes the kernels use the given instruction set, which must be supported.
+ * Not thread-safe; meant for tests only. */
+void igraph_i_simd_force_level(igraph_i_simd_level_t level) {
+    IGRAPH_ASSERT(igraph_i_simd_level_supported(level));
+    igraph_i_simd_forced_level = level;
+}
+
+void igraph_i_simd_reset_level(void) {
+    igraph_i_simd_forced_level = -1;
+}
+
+const char *igraph_i_simd_level_name(igraph_i_simd_level_t level) {
+    switch (level) {
+    case IGRAPH_I_SIMD_SCALAR:
+        return "scalar";
+    case IGRAPH_I_SIMD_SSE2:
+        return "SSE2";
+    case IGRAPH_I_SIMD_AVX2:
+        return "AVX2";
+    case IGRAPH_I_SIMD_AVX512:
+        return "AVX-512";
+    case IGRAPH_I_SIMD_NEON:
+        return "NEON";
+    }
+    return "unknown";
+}
+
+static const igraph_i_simd_kernels_t *igraph_i_simd_kernels(void) {
+    switch (igraph_i_simd_level()) {
+#ifdef IGRAPH_I_SIMD_HAVE_SSE2
+    case IGRAPH_I_SIMD_SSE2:
+        return &igraph_i_simd_sse2_kernels;
+#endif
+#ifdef IGRAPH_I_SIMD_HAVE_AVX
+    case IGRAPH_I_SIMD_AVX2:
+        return &igraph_i_simd_avx2_kernels;
+    case IGRAPH_I_SIMD_AVX512:
+        return &igraph_i_simd_avx512_kernels;
+#endif
+#ifdef IGRAPH_I_SIMD_HAVE_NEON
+    case IGRAPH_I_SIMD_NEON:
+        return &igraph_i_simd_neon_kernels;
+#endif
+    default:
+        return &igraph_i_simd_scalar_kernels;
+    }
+}
+
+igraph_real_t igraph_i_simd_sum(const igraph_real_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->sum(x, n);
+}
+
+igraph_real_t igraph_i_simd_prod(const igraph_real_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->prod(x, n);
+}
+
+igraph_real_t igraph_i_simd_sumsq(const igraph_real_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->sumsq(x, n);
+}
+
+void igraph_i_simd_scale(igraph_real_t *x, igraph_integer_t n, igraph_real_t by) {
+    igraph_i_simd_kernels()->scale(x, n, by);
+}
+
+void igraph_i_simd_add_constant(igraph_real_t *x, igraph_integer_t n, igraph_real_t plus) {
+    igraph_i_simd_kernels()->add_constant(x, n, plus);
+}
+
+void igraph_i_simd_add(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->add(x, y, n);
+}
+
+void igraph_i_simd_sub(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->sub(x, y, n);
+}
+
+void igraph_i_simd_mul(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->mul(x, y, n);
+}
+
+void igraph_i_simd_div(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->div(x, y, n);
+}
+
+/* The vector functions return the first largest (or smallest) element, or
+ * the first NaN. The kernels only find the value, so it is looked up again
+ * when it may be ambiguous, i.e. when it is NaN or zero. */
+
+igraph_real_t igraph_i_simd_max(const igraph_real_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    igraph_bool_t nan;
+    igraph_real_t res = k->max(x, n, &nan);
+    if (nan || res == 0) {
+        res = x[k->find(x, n, nan ? IGRAPH_NAN : res)];
+    }
+    return res;
+}
+
+igraph_real_t igraph_i_simd_min(const igraph_real_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    igraph_bool_t nan;
+    igraph_real_t res = k->min(x, n, &nan);
+    if (nan || res == 0) {
+        res = x[k->find(x, n, nan ? IGRAPH_NAN : res)];
+    }
+    return res;
+}
+
+void igraph_i_simd_minmax(const igraph_real_t *x, igraph_integer_t n,
+                          igraph_real_t *min, igraph_real_t *max) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    if (k->minmax(x, n, min, max)) {
+        *min = *max = x[k->find(x, n, IGRAPH_NAN)];
+        return;
+    }
+    if (*min == 0) {
+        *min = x[k->find(x, n, *min)];
+    }
+    if (*max == 0) {
+        *max = x[k->find(x, n, *max)];
+    }
+}
+
+igraph_integer_t igraph_i_simd_which_max(const igraph_real_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    igraph_bool_t nan;
+    igraph_real_t res = k->max(x, n, &nan);
+    return k->find(x, n, nan ? IGRAPH_NAN : res);
+}
+
+igraph_integer_t igraph_i_simd_which_min(const igraph_real_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    igraph_bool_t nan;
+    igraph_real_t res = k->min(x, n, &nan);
+    return k->find(x, n, nan ? IGRAPH_NAN : res);
+}
+
+igraph_bool_t igraph_i_simd_isininterval(const igraph_real_t *x, igraph_integer_t n,
+                                         igraph_real_t low, igraph_real_t high) {
+    return igraph_i_simd_kernels()->isininterval(x, n, low, high);
+}
+
+/* Returns the first NaN difference if there is one, like
+ * igraph_vector_maxdifference(). */
+igraph_real_t igraph_i_simd_maxdifference(const igraph_real_t *x, const igraph_real_t *y,
+                                          igraph_integer_t n) {
+    igraph_bool_t nan;
+    igraph_real_t res = igraph_i_simd_kernels()->maxdifference(x, y, n, &nan);
+    if (nan) {
+        igraph_integer_t i;
+        for (i = 0; i < n; i++) {
+            igraph_real_t d = fabs(x[i] - y[i]);
+            if (isnan(d)) {
+                return d;
+            }
+        }
+    }
+    return res;
+}
+
+igraph_integer_t igraph_i_simd_int_sum(const igraph_integer_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->int_sum(x, n);
+}
+
+void igraph_i_simd_int_add_constant(igraph_integer_t *x, igraph_integer_t n, igraph_integer_t plus) {
+    igraph_i_simd_kernels()->int_add_constant(x, n, plus);
+}
+
+void igraph_i_simd_int_add(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->int_add(x, y, n);
+}
+
+void igraph_i_simd_int_sub(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n) {
+    igraph_i_simd_kernels()->int_sub(x, y, n);
+}
+
+void igraph_i_simd_int_cumsum(igraph_integer_t *to, const igraph_integer_t *from, igraph_integer_t n) {
+    igraph_i_simd_kernels()->int_cumsum(to, from, n);
+}
+
+igraph_integer_t igraph_i_simd_int_max(const igraph_integer_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->int_max(x, n);
+}
+
+igraph_integer_t igraph_i_simd_int_min(const igraph_integer_t *x, igraph_integer_t n) {
+    return igraph_i_simd_kernels()->int_min(x, n);
+}
+
+void igraph_i_simd_int_minmax(const igraph_integer_t *x, igraph_integer_t n,
+                              igraph_integer_t *min, igraph_integer_t *max) {
+    igraph_i_simd_kernels()->int_minmax(x, n, min, max);
+}
+
+igraph_integer_t igraph_i_simd_int_which_max(const igraph_integer_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    return k->int_find(x, n, k->int_max(x, n));
+}
+
+igraph_integer_t igraph_i_simd_int_which_min(const igraph_integer_t *x, igraph_integer_t n) {
+    const igraph_i_simd_kernels_t *k = igraph_i_simd_kernels();
+    return k->int_find(x, n, k->int_min(x, n));
+}
@@ -0,0 +1,88 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_CORE_SIMD_H
+#define IGRAPH_CORE_SIMD_H
+
+#include "igraph_decls.h"
+#include "igraph_types.h"
+
+__BEGIN_DECLS
+
+/* Vectorized kernels behind the igraph_vector_t and igraph_vector_int_t
+ * (and thus igraph_matrix_t and igraph_matrix_int_t) element-wise
+ * operations. The instruction set is chosen at run time, from the ones
+ * igraph was compiled for, and the CPU supports.
+ *
+ * All kernels give exactly the same results as the plain loops they
+ * replace, with two exceptions: integer overflow wraps around, and sums and
+ * products of reals are accumulated in 16 interleaved partial results, which
+ * are then combined pairwise. This order is the same for all instruction
+ * sets, so the results do not depend on the CPU, apart from which NaN
+ * results from operations on two NaNs. NaN handling and the choice between
+ * equal elements follow the vector functions. */
+
+typedef enum {
+    IGRAPH_I_SIMD_SCALAR = 0,
+    IGRAPH_I_SIMD_SSE2,
+    IGRAPH_I_SIMD_AVX2,
+    IGRAPH_I_SIMD_AVX512,
+    IGRAPH_I_SIMD_NEON
+} igraph_i_simd_level_t;
+
+igraph_i_simd_level_t igraph_i_simd_level(void);
+igraph_bool_t igraph_i_simd_level_supported(igraph_i_simd_level_t level);
+void igraph_i_simd_force_level(igraph_i_simd_level_t level);
+void igraph_i_simd_reset_level(void);
+const char *igraph_i_simd_level_name(igraph_i_simd_level_t level);
+
+igraph_real_t igraph_i_simd_sum(const igraph_real_t *x, igraph_integer_t n);
+igraph_real_t igraph_i_simd_prod(const igraph_real_t *x, igraph_integer_t n);
+igraph_real_t igraph_i_simd_sumsq(const igraph_real_t *x, igraph_integer_t n);
+void igraph_i_simd_scale(igraph_real_t *x, igraph_integer_t n, igraph_real_t by);
+void igraph_i_simd_add_constant(igraph_real_t *x, igraph_integer_t n, igraph_real_t plus);
+void igraph_i_simd_add(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+void igraph_i_simd_sub(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+void igraph_i_simd_mul(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+void igraph_i_simd_div(igraph_real_t *x, const igraph_real_t *y, igraph_integer_t n);
+igraph_real_t igraph_i_simd_max(const igraph_real_t *x, igraph_integer_t n);
+igraph_real_t igraph_i_simd_min(const igraph_real_t *x, igraph_integer_t n);
+void igraph_i_simd_minmax(const igraph_real_t *x, igraph_integer_t n,
+                          igraph_real_t *min, igraph_real_t *max);
+igraph_integer_t igraph_i_simd_which_max(const igraph_real_t *x, igraph_integer_t n);
+igraph_integer_t igraph_i_simd_which_min(const igraph_real_t *x, igraph_integer_t n);
+igraph_bool_t igraph_i_simd_isininterval(const igraph_real_t *x, igraph_integer_t n,
+                                         igraph_real_t low, igraph_real_t high);
+igraph_real_t igraph_i_simd_maxdifference(const igraph_real_t *x, const igraph_real_t *y,
+                                          igraph_integer_t n);
+
+igraph_integer_t igraph_i_simd_int_sum(const igraph_integer_t *x, igraph_integer_t n);
+void igraph_i_simd_int_add_constant(igraph_integer_t *x, igraph_integer_t n, igraph_integer_t plus);
+void igraph_i_simd_int_add(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n);
+void igraph_i_simd_int_sub(igraph_integer_t *x, const igraph_integer_t *y, igraph_integer_t n);
+void igraph_i_simd_int_cumsum(igraph_integer_t *to, const igraph_integer_t *from, igraph_integer_t n);
+igraph_integer_t igraph_i_simd_int_max(const igraph_integer_t *x, igraph_integer_t n);
+igraph_integer_t igraph_i_simd_int_min(const igraph_integer_t *x, igraph_integer_t n);
+void igraph_i_simd_int_minmax(const igraph_integer_t *x, igraph_integer_t n,
+                              igraph_integer_t *min, igraph_integer_t *max);
+igraph_integer_t igraph_i_simd_int_which_max(const igraph_integer_t *x, igraph_integer_t n);
+igraph_integer_t igraph_i_simd_int_which_min(const igraph_integer_t *x, igraph_integer_t n);
+
+__END_DECLS
+
+#endif
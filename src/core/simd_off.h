@@ -0,0 +1,172 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Undefines the macros that describe an instruction set to simd.pmt. */
+
+#ifdef KERNEL
+    #undef KERNEL
+#endif
+
+#ifdef TARGET
+    #undef TARGET
+#endif
+
+#ifdef W
+    #undef W
+#endif
+
+#ifdef VD
+    #undef VD
+#endif
+
+#ifdef VD_LOAD
+    #undef VD_LOAD
+#endif
+
+#ifdef VD_STORE
+    #undef VD_STORE
+#endif
+
+#ifdef VD_SET1
+    #undef VD_SET1
+#endif
+
+#ifdef VD_ADD
+    #undef VD_ADD
+#endif
+
+#ifdef VD_SUB
+    #undef VD_SUB
+#endif
+
+#ifdef VD_MUL
+    #undef VD_MUL
+#endif
+
+#ifdef VD_DIV
+    #undef VD_DIV
+#endif
+
+#ifdef VD_MAX
+    #undef VD_MAX
+#endif
+
+#ifdef VD_MIN
+    #undef VD_MIN
+#endif
+
+#ifdef VD_ABS
+    #undef VD_ABS
+#endif
+
+#ifdef MD
+    #undef MD
+#endif
+
+#ifdef MD_FALSE
+    #undef MD_FALSE
+#endif
+
+#ifdef MD_UNORD
+    #undef MD_UNORD
+#endif
+
+#ifdef MD_EQ
+    #undef MD_EQ
+#endif
+
+#ifdef MD_GE
+    #undef MD_GE
+#endif
+
+#ifdef MD_LE
+    #undef MD_LE
+#endif
+
+#ifdef MD_OR
+    #undef MD_OR
+#endif
+
+#ifdef MD_AND
+    #undef MD_AND
+#endif
+
+#ifdef MD_ANY
+    #undef MD_ANY
+#endif
+
+#ifdef MD_ALL
+    #undef MD_ALL
+#endif
+
+#ifdef WI
+    #undef WI
+#endif
+
+#ifdef VI
+    #undef VI
+#endif
+
+#ifdef VI_LOAD
+    #undef VI_LOAD
+#endif
+
+#ifdef VI_STORE
+    #undef VI_STORE
+#endif
+
+#ifdef VI_SET1
+    #undef VI_SET1
+#endif
+
+#ifdef VI_ADD
+    #undef VI_ADD
+#endif
+
+#ifdef VI_SUB
+    #undef VI_SUB
+#endif
+
+#ifdef VI_MAX
+    #undef VI_MAX
+#endif
+
+#ifdef VI_MIN
+    #undef VI_MIN
+#endif
+
+#ifdef VI_PREFIX
+    #undef VI_PREFIX
+#endif
+
+#ifdef VI_LAST
+    #undef VI_LAST
+#endif
+
+#ifdef MI
+    #undef MI
+#endif
+
+#ifdef MI_EQ
+    #undef MI_EQ
+#endif
+
+#ifdef MI_ANY
+    #undef MI_ANY
+#endif
@@ -0,0 +1,431 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "igraph_sparsemat.h"
+
+#include "igraph_memory.h"
+
+#include "core/parallel.h"
+#include "linalg/spmv_internal.h"
+
+#include <string.h>
+
+#include <cs/cs.h>
+#undef cs  /* because otherwise it messes up the name of the 'cs' member in igraph_sparsemat_t */
+
+/**
+ * \section about_sparsemat_csr Compressed sparse row matrices
+ *
+ * <para>
+ * The <code>igraph_sparsemat_csr_t</code> data type stores a sparse
+ * matrix in compressed sparse row (CSR) form: the column indices and
+ * values of the entries of each row are stored consecutively, in the
+ * \c colidx and \c values vectors, and the entries of row \c i are at
+ * positions <code>rowptr[i]</code> to <code>rowptr[i+1]-1</code>.
+ * Unlike <code>igraph_sparsemat_t</code>, whose compressed form is
+ * column-oriented, this gives fast access to the rows, which is what
+ * matrix-vector products with graph matrices need. Matrix-vector
+ * products, products with dense matrices and transposition split the
+ * rows between threads when igraph is built with OpenMP support; their
+ * results do not depend on the number of threads.
+ * </para>
+ *
+ * <para>
+ * The same position may be stored more than once; such entries are
+ * added up by all operations, just like duplicate entries in an
+ * <code>igraph_sparsemat_t</code>. The column indices within a row are
+ * in increasing order in matrices created by
+ * \ref igraph_sparsemat_as_csr() and \ref igraph_sparsemat_csr_transpose(),
+ * but not necessarily in other ones. CSR matrices cannot be modified
+ * after they are created, apart from changing the stored values
+ * in place.
+ * </para>
+ */
+
+/* Computes the compressed rows of the transpose of the nrow-by-ncol
+ * matrix given by ptr, idx and x, i.e. its compressed columns. tptr must
+ * have room for ncol + 1 elements, tidx and tx for ptr[nrow] elements.
+ * Each thread counts and then scatters the entries of a range of rows;
+ * the output positions of the entries of each column are assigned to
+ * the ranges in order, so the row indices within each column are sorted
+ * and the result does not depend on the number of threads. */
+static igraph_error_t igraph_i_sparsemat_csr_transpose(
+        igraph_integer_t nrow, igraph_integer_t ncol,
+        const igraph_integer_t *ptr, const igraph_integer_t *idx, const igraph_real_t *x,
+        igraph_integer_t *tptr, igraph_integer_t *tidx, igraph_real_t *tx) {
+
+    igraph_integer_t nnz = ptr[nrow];
+    igraph_integer_t parts = igraph_i_csr_parts(nrow, ptr);
+    igraph_integer_t *starts, *pos;
+    igraph_integer_t total = 0;
+
+    /* Each range needs a counter for every column; use fewer ranges for
+     * very sparse matrices, so that the counters take no more memory
+     * than the matrix itself. */
+    if (parts > 1 && parts * ncol > 2 * (nnz + nrow)) {
+        parts = ncol > 0 ? 2 * (nnz + nrow) / ncol : 1;
+        if (parts < 1) {
+            parts = 1;
+        }
+    }
+
+    starts = IGRAPH_CALLOC(parts + 1, igraph_integer_t);
+    IGRAPH_CHECK_OOM(starts, "Insufficient memory for sparse matrix transposition.");
+    IGRAPH_FINALLY(igraph_free, starts);
+
+    pos = IGRAPH_CALLOC(parts * ncol + 1, igraph_integer_t);
+    IGRAPH_CHECK_OOM(pos, "Insufficient memory for sparse matrix transposition.");
+    IGRAPH_FINALLY(igraph_free, pos);
+
+    for (igraph_integer_t p = 0; p <= parts; p++) {
+        starts[p] = igraph_i_csr_part_start(nrow, ptr, p, parts);
+    }
+
+    IGRAPH_I_OMP(omp parallel for schedule(static, 1) if (parts > 1))
+    for (igraph_integer_t p = 0; p < parts; p++) {
+        igraph_integer_t *cnt = pos + p * ncol;
+        for (igraph_integer_t k = ptr[starts[p]]; k < ptr[starts[p + 1]]; k++) {
+            cnt[idx[k]]++;
+        }
+    }
+
+    /* Turn the counts into the first output position of each range
+     * within each column. */
+    for (igraph_integer_t j = 0; j < ncol; j++) {
+        tptr[j] = total;
+        for (igraph_integer_t p = 0; p < parts; p++) {
+            igraph_integer_t c = pos[p * ncol + j];
+            pos[p * ncol + j] = total;
+            total += c;
+        }
+    }
+    tptr[ncol] = total;
+
+    IGRAPH_I_OMP(omp parallel for schedule(static, 1) if (parts > 1))
+    for (igraph_integer_t p = 0; p < parts; p++) {
+        igraph_integer_t *next = pos + p * ncol;
+        for (igraph_integer_t i = starts[p]; i < starts[p + 1]; i++) {
+            for (igraph_integer_t k = ptr[i]; k < ptr[i + 1]; k++) {
+                igraph_integer_t to = next[idx[k]]++;
+                tidx[to] = i;
+                tx[to] = x[k];
+            }
+        }
+    }
+
+    IGRAPH_FREE(pos);
+    IGRAPH_FREE(starts);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Initializes the vectors of A for the given size and number of stored
+ * entries. rowptr is set to all zeros. */
+static igraph_error_t igraph_i_sparsemat_csr_init_size(igraph_sparsemat_csr_t *A,
+                                                       igraph_integer_t rows,
+                                                       igraph_integer_t cols,
+                                                       igraph_integer_t nnz) {
+    if (rows < 0) {
+        IGRAPH_ERROR("Negative number of rows.", IGRAPH_EINVAL);
+    }
+    if (cols < 0) {
+        IGRAPH_ERROR("Negative number of columns.", IGRAPH_EINVAL);
+    }
+
+    A->nrow = rows;
+    A->ncol = cols;
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&A->rowptr, rows + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&A->colidx, nnz);
+    IGRAPH_CHECK(igraph_vector_init(&A->values, nnz));
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_sparsemat_csr_init
+ * \brief Initializes a compressed sparse row matrix with no stored entries.
+ *
+ * The matrix has the given size and all of its elements are zero. Use
+ * \ref igraph_get_adjacency_csr() or \ref igraph_sparsemat_as_csr() to
+ * create a matrix with entries.
+ *
+ * </para><para>The matrix must be destroyed with
+ * \ref igraph_sparsemat_csr_destroy() once it is no longer needed.
+ * \param A Pointer to an uninitialized CSR matrix.
+ * \param rows The number of rows in the matrix.
+ * \param cols The number of columns.
+ * \return Error code.
+ *
+ * Time complexity: O(rows).
+ */
+
+igraph_error_t igraph_sparsemat_csr_init(igraph_sparsemat_csr_t *A,
+                                         igraph_integer_t rows,
+                                         igraph_integer_t cols) {
+    return igraph_i_sparsemat_csr_init_size(A, rows, cols, 0);
+}
+
+/**
+ * \function igraph_sparsemat_csr_destroy
+ * \brief Deallocates memory used by a compressed sparse row matrix.
+ *
+ * \param A The CSR matrix to destroy.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_sparsemat_csr_destroy(igraph_sparsemat_csr_t *A) {
+    igraph_vector_destroy(&A->values);
+    igraph_vector_int_destroy(&A->colidx);
+    igraph_vector_int_destroy(&A->rowptr);
+}
+
+/**
+ * \function igraph_sparsemat_csr_nrow
+ * \brief Number of rows of a compressed sparse row matrix.
+ *
+ * \param A The input matrix.
+ * \return The number of rows.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_sparsemat_csr_nrow(const igraph_sparsemat_csr_t *A) {
+    return A->nrow;
+}
+
+/**
+ * \function igraph_sparsemat_csr_ncol
+ * \brief Number of columns of a compressed sparse row matrix.
+ *
+ * \param A The input matrix.
+ * \return The number of columns.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_sparsemat_csr_ncol(const igraph_sparsemat_csr_t *A) {
+    return A->ncol;
+}
+
+/**
+ * \function igraph_sparsemat_csr_nonzero_storage
+ * \brief Returns the number of stored entries of a compressed sparse row matrix.
+ *
+ * The stored entries can be zero, and multiple entries can be at the
+ * same position.
+ *
+ * \param A The input matrix.
+ * \return Number of stored entries.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_integer_t igraph_sparsemat_csr_nonzero_storage(const igraph_sparsemat_csr_t *A) {
+    return VECTOR(A->rowptr)[A->nrow];
+}
+
+/**
+ * \function igraph_sparsemat_as_csr
+ * \brief Converts a sparse matrix to compressed sparse row form.
+ *
+ * The column indices within each row of the result are in increasing
+ * order. Duplicate entries are kept, they are not added up.
+ *
+ * \param res Pointer to an uninitialized CSR matrix, the result is
+ *    stored here.
+ * \param A The input matrix, in triplet or column-compressed format.
+ * \return Error code.
+ *
+ * Time complexity: O(n+m+nz), the number of rows and columns plus
+ * the number of stored entries. Triplet matrices are compressed first.
+ */
+
+igraph_error_t igraph_sparsemat_as_csr(igraph_sparsemat_csr_t *res,
+                                       const igraph_sparsemat_t *A) {
+    igraph_sparsemat_t compressed;
+    const igraph_sparsemat_t *cc = A;
+    igraph_integer_t nrow = igraph_sparsemat_nrow(A);
+    igraph_integer_t ncol = igraph_sparsemat_ncol(A);
+
+    if (igraph_sparsemat_is_triplet(A)) {
+        IGRAPH_CHECK(igraph_sparsemat_compress(A, &compressed));
+        IGRAPH_FINALLY(igraph_sparsemat_destroy, &compressed);
+        cc = &compressed;
+    }
+
+    /* The compressed columns of A are the compressed rows of its
+     * transpose, so transposing them gives the compressed rows of A. */
+    IGRAPH_CHECK(igraph_i_sparsemat_csr_init_size(res, nrow, ncol, cc->cs->p[ncol]));
+    IGRAPH_FINALLY(igraph_sparsemat_csr_destroy, res);
+    IGRAPH_CHECK(igraph_i_sparsemat_csr_transpose(ncol, nrow, cc->cs->p, cc->cs->i, cc->cs->x,
+                                                  VECTOR(res->rowptr), VECTOR(res->colidx),
+                                                  VECTOR(res->values)));
+    IGRAPH_FINALLY_CLEAN(1);
+
+    if (cc != A) {
+        igraph_sparsemat_destroy(&compressed);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_sparsemat_csr_as_sparsemat
+ * \brief Converts a compressed sparse row matrix to a column-compressed sparse matrix.
+ *
+ * The row indices within each column of the result are in increasing
+ * order. Duplicate entries are kept, they are not added up.
+ *
+ * \param res Pointer to an uninitialized sparse matrix, the result is
+ *    stored here in column-compressed format.
+ * \param A The input matrix.
+ * \return Error code.
+ *
+ * Time complexity: O(n+m+nz), the number of rows and columns plus
+ * the number of stored entries.
+ */
+
+igraph_error_t igraph_sparsemat_csr_as_sparsemat(igraph_sparsemat_t *res,
+                                                 const igraph_sparsemat_csr_t *A) {
+    igraph_integer_t nnz = igraph_sparsemat_csr_nonzero_storage(A);
+
+    res->cs = cs_spalloc(A->nrow, A->ncol, nnz, /*values=*/ 1, /*triplet=*/ 0);
+    IGRAPH_CHECK_OOM(res->cs, "Cannot allocate memory for sparse matrix.");
+    IGRAPH_FINALLY(igraph_sparsemat_destroy, res);
+
+    IGRAPH_CHECK(igraph_i_sparsemat_csr_transpose(A->nrow, A->ncol, VECTOR(A->rowptr),
+                                                  VECTOR(A->colidx), VECTOR(A->values),
+                                                  res->cs->p, res->cs->i, res->cs->x));
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_sparsemat_csr_transpose
+ * \brief Transposes a compressed sparse row matrix.
+ *
+ * The column indices within each row of the result are in increasing
+ * order. The rows of the input are split between threads when igraph
+ * is built with OpenMP support.
+ *
+ * \param A The input matrix.
+ * \param res Pointer to an uninitialized CSR matrix, the result is
+ *    stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(n+m+nz), the number of rows and columns plus
+ * the number of stored entries.
+ */
+
+igraph_error_t igraph_sparsemat_csr_transpose(const igraph_sparsemat_csr_t *A,
+                                              igraph_sparsemat_csr_t *res) {
+    IGRAPH_CHECK(igraph_i_sparsemat_csr_init_size(res, A->ncol, A->nrow,
+                                                  igraph_sparsemat_csr_nonzero_storage(A)));
+    IGRAPH_FINALLY(igraph_sparsemat_csr_destroy, res);
+
+    IGRAPH_CHECK(igraph_i_sparsemat_csr_transpose(A->nrow, A->ncol, VECTOR(A->rowptr),
+                                                  VECTOR(A->colidx), VECTOR(A->values),
+                                                  VECTOR(res->rowptr), VECTOR(res->colidx),
+                                                  VECTOR(res->values)));
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_sparsemat_csr_gaxpy
+ * \brief Matrix-vector product of a compressed sparse row matrix, added to another vector.
+ *
+ * The rows of the matrix are split between threads when igraph is
+ * built with OpenMP support. Each element of the result is computed
+ * by a single thread, so the result does not depend on the number of
+ * threads.
+ *
+ * \param A The input matrix.
+ * \param x The input vector, its size must match the number of
+ *    columns in \p A.
+ * \param res This vector is added to the matrix-vector product
+ *    and it is overwritten by the result. Its size must match the
+ *    number of rows in \p A.
+ * \return Error code.
+ *
+ * Time complexity: O(n+nz), the number of rows plus the number of
+ * stored entries.
+ */
+
+igraph_error_t igraph_sparsemat_csr_gaxpy(const igraph_sparsemat_csr_t *A,
+                                          const igraph_vector_t *x,
+                                          igraph_vector_t *res) {
+    igraph_i_csr_matrix_t M;
+
+    if (A->ncol != igraph_vector_size(x) || A->nrow != igraph_vector_size(res)) {
+        IGRAPH_ERROR("Invalid matrix/vector size for multiplication.", IGRAPH_EINVAL);
+    }
+
+    igraph_i_csr_matrix_init_sparsemat(&M, A);
+    M.accumulate = true;
+    igraph_i_csr_spmv(&M, VECTOR(*x), VECTOR(*res));
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_sparsemat_csr_multiply_by_dense
+ * \brief Multiplies a compressed sparse row matrix by a dense matrix.
+ *
+ * The columns of \p B are processed in groups, whose rows are read
+ * together for each stored entry of \p A. The rows of \p A are split
+ * between threads when igraph is built with OpenMP support; the result
+ * does not depend on the number of threads.
+ *
+ * \param A The sparse matrix.
+ * \param B The dense matrix, its number of rows must match the number
+ *    of columns in \p A.
+ * \param res An initialized matrix, the result is stored here. It
+ *    will be resized as needed.
+ * \return Error code.
+ *
+ * Time complexity: O(p(n+nz)+mp), where p is the number of columns of
+ * \p B, n and m are the number of rows and columns of \p A, and nz is
+ * its number of stored entries.
+ */
+
+igraph_error_t igraph_sparsemat_csr_multiply_by_dense(const igraph_sparsemat_csr_t *A,
+                                                      const igraph_matrix_t *B,
+                                                      igraph_matrix_t *res) {
+    igraph_i_csr_matrix_t M;
+    igraph_integer_t p = igraph_matrix_ncol(B);
+
+    if (igraph_matrix_nrow(B) != A->ncol) {
+        IGRAPH_ERROR("Invalid dimensions in sparse-dense matrix product.", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, A->nrow, p));
+
+    igraph_i_csr_matrix_init_sparsemat(&M, A);
+    IGRAPH_CHECK(igraph_i_csr_spmm(&M, &MATRIX(*B, 0, 0), &MATRIX(*res, 0, 0), p));
+
+    return IGRAPH_SUCCESS;
+}
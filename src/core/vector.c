@@ -27,6 +27,8 @@
 #include "igraph_types.h"
 #include "igraph_nongraph.h"
 
+#include "core/simd.h"
+
 #include <float.h>
 
 #define BASE_IGRAPH_REAL
@@ -40,8 +40,18 @@
 #include "core/buckets.h"
 #include "core/cutheap.h"
 #include "core/interruption.h"
+#include "core/parallel.h"
 #include "math/safe_intop.h"
 
+/* Functions that run many independent maximum flow computations, such as
+ * the connectivity and Gomory-Hu tree functions, only use multiple threads
+ * for graphs with at least this many vertices. */
+#define IGRAPH_I_FLOW_PARALLEL_MIN_VERTICES 32
+
+/* Number of maximum flows per thread that are computed between two checks
+ * for interruption in parallel mode. */
+#define IGRAPH_I_FLOW_PARALLEL_TASKS_PER_ROUND 16
+
 /*
  * Some general remarks about the functions in this file.
  *
@@ -172,6 +182,10 @@ static igraph_error_t igraph_i_maxflow_undirected(const igraph_t *graph,
     igraph_t newgraph;
     igraph_integer_t size;
 
+    if (capacity && igraph_vector_size(capacity) != no_of_edges) {
+        IGRAPH_ERROR("Capacity vector must match number of edges in length.", IGRAPH_EINVAL);
+    }
+
     /* We need to convert this to directed by hand, since we need to be
        sure that the edge IDs will be handled properly to build the new
        capacity vector. */
@@ -1092,6 +1106,387 @@ igraph_error_t igraph_maxflow_value(const igraph_t *graph, igraph_real_t *value,
                           source, target, capacity, stats);
 }
 
+/**
+ * \function igraph_flow_network_init
+ * \brief Prepares a graph for repeated maximum flow calculations.
+ *
+ * </para><para>
+ * Each call to \ref igraph_maxflow() converts the graph into a residual
+ * network, which often takes longer than the flow calculation itself.
+ * When many maximum flows are needed in the same graph, for example
+ * between different pairs of vertices or with different capacities, it is
+ * better to do this conversion only once, with this function, and then use
+ * \ref igraph_flow_network_maxflow() for the individual calculations.
+ *
+ * </para><para>
+ * The network does not refer to \p graph after it has been created, so
+ * the graph may be modified or destroyed while the network is in use.
+ *
+ * \param network Pointer to an uninitialized flow network object.
+ * \param graph The input graph, either directed or undirected.
+ * \param capacity Vector containing the capacity of the edges. If NULL, then
+ *        every edge is considered to have capacity 1.0.
+ * \return Error code.
+ *
+ * \sa \ref igraph_flow_network_destroy() to free the allocated memory,
+ * \ref igraph_flow_network_set_capacity() to change capacities.
+ *
+ * Time complexity: O(|V|+|E|).
+ */
+
+igraph_error_t igraph_flow_network_init(igraph_flow_network_t *network,
+                                        const igraph_t *graph,
+                                        const igraph_vector_t *capacity) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_integer_t no_of_arcs;
+
+    if (capacity && igraph_vector_size(capacity) != no_of_edges) {
+        IGRAPH_ERROR("Capacity vector must match number of edges in length.", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_SAFE_MULT(no_of_edges, 2, &no_of_arcs);
+
+    network->no_of_nodes = no_of_nodes;
+    network->directed = igraph_is_directed(graph);
+    network->source = -1;
+    network->target = -1;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->first, no_of_nodes + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->to, no_of_arcs);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->rev, no_of_arcs);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->edge_arc, no_of_edges);
+    IGRAPH_VECTOR_INIT_FINALLY(&network->capacity, no_of_edges);
+    IGRAPH_VECTOR_INIT_FINALLY(&network->rescap, no_of_arcs);
+    IGRAPH_VECTOR_INIT_FINALLY(&network->excess, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->current, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&network->distance, no_of_nodes);
+
+    /* Each edge u -> v becomes a pair of arcs, u -> v and its reverse
+     * v -> u. The arcs are stored contiguously by their tail vertex, the
+     * arcs of vertex v are first[v], ..., first[v+1]-1. We use 'current'
+     * as temporary storage for the insertion positions. */
+    for (igraph_integer_t e = 0; e < no_of_edges; e++) {
+        VECTOR(network->first)[IGRAPH_FROM(graph, e) + 1]++;
+        VECTOR(network->first)[IGRAPH_TO(graph, e) + 1]++;
+    }
+    for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+        VECTOR(network->first)[v + 1] += VECTOR(network->first)[v];
+        VECTOR(network->current)[v] = VECTOR(network->first)[v];
+    }
+    for (igraph_integer_t e = 0; e < no_of_edges; e++) {
+        igraph_integer_t from = IGRAPH_FROM(graph, e);
+        igraph_integer_t to = IGRAPH_TO(graph, e);
+        igraph_integer_t arc = VECTOR(network->current)[from]++;
+        igraph_integer_t rev_arc = VECTOR(network->current)[to]++;
+        VECTOR(network->to)[arc] = to;
+        VECTOR(network->to)[rev_arc] = from;
+        VECTOR(network->rev)[arc] = rev_arc;
+        VECTOR(network->rev)[rev_arc] = arc;
+        VECTOR(network->edge_arc)[e] = arc;
+        VECTOR(network->capacity)[e] = capacity ? VECTOR(*capacity)[e] : 1.0;
+    }
+
+    IGRAPH_FINALLY_CLEAN(9);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_flow_network_destroy
+ * \brief Deallocates the memory used by a flow network.
+ *
+ * \param network The flow network to destroy.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_flow_network_destroy(igraph_flow_network_t *network) {
+    igraph_vector_int_destroy(&network->distance);
+    igraph_vector_int_destroy(&network->current);
+    igraph_vector_destroy(&network->excess);
+    igraph_vector_destroy(&network->rescap);
+    igraph_vector_destroy(&network->capacity);
+    igraph_vector_int_destroy(&network->edge_arc);
+    igraph_vector_int_destroy(&network->rev);
+    igraph_vector_int_destroy(&network->to);
+    igraph_vector_int_destroy(&network->first);
+}
+
+/**
+ * \function igraph_flow_network_set_capacity
+ * \brief Changes the capacity of an edge in a flow network.
+ *
+ * </para><para>
+ * If the edge carries no more flow in the result of the last
+ * \ref igraph_flow_network_maxflow() call than its new capacity, which is
+ * always the case when the capacity is increased, the next maximum flow
+ * calculation between the same source and target vertices starts from
+ * the previous flow instead of from scratch.
+ *
+ * \param network The flow network.
+ * \param eid The ID of the edge in the graph that the network was
+ *        created from.
+ * \param capacity The new capacity of the edge.
+ * \return Error code:
+ *         \c IGRAPH_EINVAL: invalid edge ID.
+ *
+ * Time complexity: O(1).
+ */
+
+igraph_error_t igraph_flow_network_set_capacity(igraph_flow_network_t *network,
+                                                igraph_integer_t eid,
+                                                igraph_real_t capacity) {
+    igraph_integer_t arc, rev_arc;
+    igraph_real_t delta;
+
+    if (eid < 0 || eid >= igraph_vector_int_size(&network->edge_arc)) {
+        IGRAPH_ERROR("Invalid edge ID.", IGRAPH_EINVAL);
+    }
+
+    arc = VECTOR(network->edge_arc)[eid];
+    rev_arc = VECTOR(network->rev)[arc];
+    delta = capacity - VECTOR(network->capacity)[eid];
+    VECTOR(network->capacity)[eid] = capacity;
+
+    /* For a flow f on the edge, the residual capacity of the arc is c - f,
+     * and that of the reverse arc is f in directed graphs and c + f in
+     * undirected ones, where the flow may go in both directions. If the
+     * new capacity cannot carry the current flow, we start over at the
+     * next calculation. */
+    VECTOR(network->rescap)[arc] += delta;
+    if (!network->directed) {
+        VECTOR(network->rescap)[rev_arc] += delta;
+    }
+    if (VECTOR(network->rescap)[arc] < 0 || VECTOR(network->rescap)[rev_arc] < 0) {
+        network->source = network->target = -1;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+#undef FIRST
+#undef LAST
+#undef CURRENT
+#undef RESCAP
+#undef REV
+#undef HEAD
+#undef EXCESS
+#undef DIST
+#define FIRST(i)       (VECTOR(network->first)[(i)])
+#define LAST(i)        (VECTOR(network->first)[(i)+1])
+#define CURRENT(i)     (VECTOR(network->current)[(i)])
+#define RESCAP(i)      (VECTOR(network->rescap)[(i)])
+#define REV(i)         (VECTOR(network->rev)[(i)])
+#define HEAD(i)        (VECTOR(network->to)[(i)])
+#define EXCESS(i)      (VECTOR(network->excess)[(i)])
+#define DIST(i)        (VECTOR(network->distance)[(i)])
+
+/**
+ * \function igraph_flow_network_maxflow
+ * \brief Maximum flow between a pair of vertices in a flow network.
+ *
+ * </para><para>
+ * This function calculates the same maximum flow value and minimum cut as
+ * \ref igraph_maxflow(), with the same push-relabel algorithm, but in a
+ * graph that was prepared for repeated calculations with
+ * \ref igraph_flow_network_init().
+ *
+ * </para><para>
+ * If the previous call used the same source and target vertices, and
+ * capacities were only changed in a way that keeps the previous flow valid
+ * (see \ref igraph_flow_network_set_capacity()), the calculation is warm
+ * started from the previous flow, and only the extra flow is computed.
+ *
+ * \param network The flow network. It is modified by this function, as it
+ *        stores the flow for the next call.
+ * \param value Pointer to a real number, the value of the maximum flow
+ *        will be placed here, unless it is a null pointer.
+ * \param cut A null pointer or a pointer to an initialized vector.
+ *        If not a null pointer, then the IDs of the edges in the minimum
+ *        cut corresponding to the maximum flow are stored here.
+ * \param partition A null pointer or a pointer to an initialized
+ *        vector. If not a null pointer, then the side of the minimum cut
+ *        that contains the source vertex is stored here.
+ * \param partition2 A null pointer or a pointer to an initialized
+ *        vector. If not a null pointer, then the side of the minimum cut
+ *        that contains the target vertex is stored here.
+ * \param source The ID of the source vertex.
+ * \param target The ID of the target vertex.
+ * \param stats Counts of the number of different operations
+ *        performed by the algorithm are stored here, unless it is a null
+ *        pointer.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|^3), like \ref igraph_maxflow(), but without the
+ * cost of building the residual network.
+ *
+ * \sa \ref igraph_maxflow() to calculate the flow on each edge.
+ */
+
+igraph_error_t igraph_flow_network_maxflow(igraph_flow_network_t *network,
+                                           igraph_real_t *value,
+                                           igraph_vector_int_t *cut,
+                                           igraph_vector_int_t *partition,
+                                           igraph_vector_int_t *partition2,
+                                           igraph_integer_t source,
+                                           igraph_integer_t target,
+                                           igraph_maxflow_stats_t *stats) {
+
+    igraph_integer_t no_of_nodes = network->no_of_nodes;
+    igraph_integer_t no_of_edges = igraph_vector_size(&network->capacity);
+    igraph_integer_t npushsince = 0, nrelabelsince = 0;
+    igraph_integer_t i, j;
+    igraph_buckets_t buckets;
+    igraph_dbuckets_t ibuckets;
+    igraph_dqueue_int_t bfsq;
+    igraph_maxflow_stats_t local_stats;   /* used if the user passed a null pointer for stats */
+
+    if (stats == 0) {
+        stats = &local_stats;
+    }
+
+    if (source < 0 || source >= no_of_nodes || target < 0 || target >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid source or target vertex.", IGRAPH_EINVVID);
+    }
+    if (source == target) {
+        IGRAPH_ERROR("Source and target vertices are the same.", IGRAPH_EINVAL);
+    }
+
+    stats->nopush = stats->norelabel = stats->nogap = stats->nogapnodes =
+                                           stats->nobfs = 0;
+
+    /* Start from zero flow, unless the current one is the maximum flow
+     * (or rather, preflow) between the same vertices, with some capacities
+     * increased since. That is a valid preflow for the new capacities, from
+     * which the push-relabel algorithm can continue. */
+    if (network->source != source || network->target != target) {
+        for (i = 0; i < no_of_edges; i++) {
+            igraph_integer_t arc = VECTOR(network->edge_arc)[i];
+            RESCAP(arc) = VECTOR(network->capacity)[i];
+            RESCAP(REV(arc)) = network->directed ? 0.0 : VECTOR(network->capacity)[i];
+        }
+        igraph_vector_null(&network->excess);
+    }
+    network->source = network->target = -1;
+
+    for (i = 0; i < no_of_nodes; i++) {
+        CURRENT(i) = FIRST(i);
+    }
+
+    IGRAPH_CHECK(igraph_dqueue_int_init(&bfsq, no_of_nodes));
+    IGRAPH_FINALLY(igraph_dqueue_int_destroy, &bfsq);
+    IGRAPH_CHECK(igraph_buckets_init(&buckets, no_of_nodes + 1, no_of_nodes));
+    IGRAPH_FINALLY(igraph_buckets_destroy, &buckets);
+    IGRAPH_CHECK(igraph_dbuckets_init(&ibuckets, no_of_nodes + 1, no_of_nodes));
+    IGRAPH_FINALLY(igraph_dbuckets_destroy, &ibuckets);
+
+    /* Send as much flow as possible from the source to its neighbors */
+    for (i = FIRST(source), j = LAST(source); i < j; i++) {
+        if (HEAD(i) != source) {
+            igraph_real_t delta = RESCAP(i);
+            RESCAP(i) = 0;
+            RESCAP(REV(i)) += delta;
+            EXCESS(HEAD(i)) += delta;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_mf_bfs(&bfsq, source, target, no_of_nodes,
+                                 &buckets, &ibuckets, &network->distance,
+                                 &network->first, &network->current, &network->to,
+                                 &network->excess, &network->rescap, &network->rev));
+    (stats->nobfs)++;
+
+    while (!igraph_buckets_empty(&buckets)) {
+        igraph_integer_t vertex = igraph_buckets_popmax(&buckets);
+        igraph_i_mf_discharge(vertex, &network->current, &network->first, &network->rescap,
+                              &network->to, &network->distance, &network->excess,
+                              no_of_nodes, source, target, &buckets, &ibuckets,
+                              &network->rev, stats, &npushsince, &nrelabelsince);
+        if (npushsince > no_of_nodes / 2 && nrelabelsince > no_of_nodes) {
+            (stats->nobfs)++;
+            IGRAPH_CHECK(igraph_i_mf_bfs(&bfsq, source, target, no_of_nodes,
+                                         &buckets, &ibuckets, &network->distance,
+                                         &network->first, &network->current, &network->to,
+                                         &network->excess, &network->rescap, &network->rev));
+            npushsince = nrelabelsince = 0;
+        }
+    }
+
+    igraph_dbuckets_destroy(&ibuckets);
+    igraph_buckets_destroy(&buckets);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    network->source = source;
+    network->target = target;
+
+    if (value) {
+        *value = EXCESS(target);
+    }
+
+    if (cut || partition || partition2) {
+        /* Find all vertices from which the target is reachable in the
+           residual graph, with a backward breadth-first search. Their
+           distances are not needed any more, so 'distance' marks them. */
+        igraph_integer_t marked = 1;
+
+        igraph_vector_int_null(&network->distance);
+        igraph_dqueue_int_clear(&bfsq);
+        IGRAPH_CHECK(igraph_dqueue_int_push(&bfsq, target));
+        DIST(target) = 1;
+        while (!igraph_dqueue_int_empty(&bfsq)) {
+            igraph_integer_t actnode = igraph_dqueue_int_pop(&bfsq);
+            for (i = FIRST(actnode), j = LAST(actnode); i < j; i++) {
+                igraph_integer_t nei = HEAD(i);
+                if (!DIST(nei) && RESCAP(REV(i)) > 0.0) {
+                    DIST(nei) = 1;
+                    marked++;
+                    IGRAPH_CHECK(igraph_dqueue_int_push(&bfsq, nei));
+                }
+            }
+        }
+
+        if (cut) {
+            igraph_vector_int_clear(cut);
+            for (i = 0; i < no_of_edges; i++) {
+                igraph_integer_t arc = VECTOR(network->edge_arc)[i];
+                igraph_integer_t f = HEAD(REV(arc));
+                igraph_integer_t t = HEAD(arc);
+                if (!DIST(f) && DIST(t)) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(cut, i));
+                } else if (!network->directed && DIST(f) && !DIST(t)) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(cut, i));
+                }
+            }
+        }
+
+        if (partition2) {
+            igraph_integer_t x = 0;
+            IGRAPH_CHECK(igraph_vector_int_resize(partition2, marked));
+            for (i = 0; i < no_of_nodes; i++) {
+                if (DIST(i)) {
+                    VECTOR(*partition2)[x++] = i;
+                }
+            }
+        }
+
+        if (partition) {
+            igraph_integer_t x = 0;
+            IGRAPH_CHECK(igraph_vector_int_resize(partition, no_of_nodes - marked));
+            for (i = 0; i < no_of_nodes; i++) {
+                if (!DIST(i)) {
+                    VECTOR(*partition)[x++] = i;
+                }
+            }
+        }
+    }
+
+    igraph_dqueue_int_destroy(&bfsq);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_st_mincut_value
  * \brief The minimum s-t cut in a graph.
@@ -1467,6 +1862,7 @@ static igraph_error_t igraph_i_mincut_directed(const igraph_t *graph,
     igraph_vector_int_t mypartition, mypartition2, mycut;
     igraph_vector_int_t *ppartition = 0, *ppartition2 = 0, *pcut = 0;
     igraph_vector_int_t bestpartition, bestpartition2, bestcut;
+    igraph_flow_network_t network;
 
     if (partition) {
         IGRAPH_VECTOR_INT_INIT_FINALLY(&bestpartition, 0);
@@ -1491,10 +1887,14 @@ static igraph_error_t igraph_i_mincut_directed(const igraph_t *graph,
         pcut = &mycut;
     }
 
+    IGRAPH_CHECK(igraph_flow_network_init(&network, graph, capacity));
+    IGRAPH_FINALLY(igraph_flow_network_destroy, &network);
+
     for (i = 1; i < no_of_nodes; i++) {
-        IGRAPH_CHECK(igraph_maxflow(graph, /*value=*/ &flow, /*flow=*/ 0,
-                                    pcut, ppartition, ppartition2, /*source=*/ 0,
-                                    /*target=*/ i, capacity, 0));
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_flow_network_maxflow(&network, /*value=*/ &flow,
+                                                 pcut, ppartition, ppartition2, /*source=*/ 0,
+                                                 /*target=*/ i, 0));
         if (flow < minmaxflow) {
             minmaxflow = flow;
             if (cut) {
@@ -1511,10 +1911,10 @@ static igraph_error_t igraph_i_mincut_directed(const igraph_t *graph,
                 break;
             }
         }
-        IGRAPH_CHECK(igraph_maxflow(graph, /*value=*/ &flow, /*flow=*/ 0,
-                                    pcut, ppartition, ppartition2,
-                                    /*source=*/ i,
-                                    /*target=*/ 0, capacity, 0));
+        IGRAPH_CHECK(igraph_flow_network_maxflow(&network, /*value=*/ &flow,
+                                                 pcut, ppartition, ppartition2,
+                                                 /*source=*/ i,
+                                                 /*target=*/ 0, 0));
         if (flow < minmaxflow) {
             minmaxflow = flow;
             if (cut) {
@@ -1533,6 +1933,9 @@ static igraph_error_t igraph_i_mincut_directed(const igraph_t *graph,
         }
     }
 
+    igraph_flow_network_destroy(&network);
+    IGRAPH_FINALLY_CLEAN(1);
+
     if (value) {
         *value = minmaxflow;
     }
@@ -1647,6 +2050,137 @@ static igraph_error_t igraph_i_mincut_value_undirected(const igraph_t *graph,
     return igraph_i_mincut_undirected(graph, res, 0, 0, 0, capacity);
 }
 
+/* Flow networks of the same graph, one for each thread of a parallel
+ * computation, used as push-relabel workspaces. */
+typedef struct {
+    igraph_flow_network_t *networks;
+    igraph_integer_t size;
+} igraph_i_flow_networks_t;
+
+static void igraph_i_flow_networks_destroy(igraph_i_flow_networks_t *networks) {
+    for (igraph_integer_t i = 0; i < networks->size; i++) {
+        igraph_flow_network_destroy(&networks->networks[i]);
+    }
+    IGRAPH_FREE(networks->networks);
+}
+
+static igraph_error_t igraph_i_flow_networks_init(igraph_i_flow_networks_t *networks,
+                                                  igraph_integer_t size,
+                                                  const igraph_t *graph,
+                                                  const igraph_vector_t *capacity) {
+    networks->size = 0;
+    networks->networks = IGRAPH_CALLOC(size, igraph_flow_network_t);
+    IGRAPH_CHECK_OOM(networks->networks, "Insufficient memory for flow networks.");
+    IGRAPH_FINALLY(igraph_i_flow_networks_destroy, networks);
+
+    for (; networks->size < size; networks->size++) {
+        IGRAPH_CHECK(igraph_flow_network_init(&networks->networks[networks->size], graph, capacity));
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* The smaller of the maximum flow values from vertex 0 to vertex i and
+ * back, in a directed flow network. The second flow is skipped when the
+ * first one is already zero. */
+static igraph_error_t igraph_i_mincut_value_directed_pair(igraph_flow_network_t *network,
+                                                          igraph_real_t *res,
+                                                          igraph_integer_t i) {
+    igraph_real_t flow;
+
+    IGRAPH_CHECK(igraph_flow_network_maxflow(network, res, 0, 0, 0, 0, i, 0));
+    if (*res == 0) {
+        return IGRAPH_SUCCESS;
+    }
+    IGRAPH_CHECK(igraph_flow_network_maxflow(network, &flow, 0, 0, 0, i, 0, 0));
+    if (flow < *res) {
+        *res = flow;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+/* Parallel version of the loop of igraph_mincut_value() for directed
+ * graphs. Each thread uses its own flow network as push-relabel workspace;
+ * the graph and the capacities are only read. The smallest flow value found
+ * so far is shared between the threads, so that all of them stop as soon as
+ * one finds a zero flow. Target vertices are processed in rounds, so that the
+ * user can interrupt the computation between them, outside of the parallel
+ * region. */
+static igraph_error_t igraph_i_mincut_value_directed_parallel(const igraph_t *graph,
+                                                              igraph_real_t *res,
+                                                              const igraph_vector_t *capacity) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_threads = igraph_i_parallel_max_threads();
+    igraph_integer_t round_size = no_of_threads * IGRAPH_I_FLOW_PARALLEL_TASKS_PER_ROUND;
+    igraph_real_t minmaxflow = IGRAPH_INFINITY;
+    igraph_i_flow_networks_t networks;
+    int error = IGRAPH_SUCCESS;
+
+    IGRAPH_CHECK(igraph_i_flow_networks_init(&networks, no_of_threads, graph, capacity));
+    IGRAPH_FINALLY(igraph_i_flow_networks_destroy, &networks);
+
+    for (igraph_integer_t from = 1; from < no_of_nodes && minmaxflow != 0; from += round_size) {
+        igraph_integer_t to = no_of_nodes - from > round_size ? from + round_size : no_of_nodes;
+
+#pragma omp parallel num_threads(networks.size)
+        {
+            igraph_error_handler_t *handler = igraph_i_parallel_enter();
+            igraph_flow_network_t *network = &networks.networks[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic, 1)
+            for (igraph_integer_t i = from; i < to; i++) {
+                igraph_real_t flow, bound;
+                igraph_error_t ret;
+                int current_error;
+
+#pragma omp atomic read
+                bound = minmaxflow;
+#pragma omp atomic read
+                current_error = error;
+                if (bound == 0 || current_error != IGRAPH_SUCCESS) {
+                    continue;
+                }
+
+                ret = igraph_i_mincut_value_directed_pair(network, &flow, i);
+                if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                    error = ret;
+                    continue;
+                }
+
+#pragma omp critical (igraph_i_mincut_value_directed_parallel)
+                {
+                    if (flow < minmaxflow) {
+                        minmaxflow = flow;
+                    }
+                }
+            }
+
+            igraph_i_parallel_exit(handler);
+        }
+
+        if (error != IGRAPH_SUCCESS) {
+            IGRAPH_ERROR("Cannot calculate minimum cut value.", (igraph_error_t) error);
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    igraph_i_flow_networks_destroy(&networks);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    *res = minmaxflow;
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif /* IGRAPH_I_PARALLEL_API */
+
 /**
  * \function igraph_mincut_value
  * \brief The minimum edge cut in a graph.
@@ -1666,6 +2200,8 @@ static igraph_error_t igraph_i_mincut_value_undirected(const igraph_t *graph,
  * the maximum flow is calculated between a fixed vertex and all the
  * other vertices in the graph and this is done in both
  * directions. Then the minimum is taken to get the minimum cut.
+ * When igraph is built with OpenMP support, these maximum flows are
+ * calculated in parallel.
  *
  * \param graph The input graph.
  * \param res Pointer to a real variable, the result will be stored
@@ -1689,6 +2225,7 @@ igraph_error_t igraph_mincut_value(const igraph_t *graph, igraph_real_t *res,
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_real_t minmaxflow, flow;
     igraph_integer_t i;
+    igraph_flow_network_t network;
 
     minmaxflow = IGRAPH_INFINITY;
 
@@ -1697,17 +2234,22 @@ igraph_error_t igraph_mincut_value(const igraph_t *graph, igraph_real_t *res,
         return IGRAPH_SUCCESS;
     }
 
-    for (i = 1; i < no_of_nodes; i++) {
-        IGRAPH_CHECK(igraph_maxflow_value(graph, &flow, 0, i,
-                                          capacity, 0));
-        if (flow < minmaxflow) {
-            minmaxflow = flow;
-            if (flow == 0) {
-                break;
-            }
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_nodes >= IGRAPH_I_FLOW_PARALLEL_MIN_VERTICES && igraph_i_parallel_max_threads() > 1) {
+        IGRAPH_CHECK(igraph_i_mincut_value_directed_parallel(graph, &minmaxflow, capacity));
+        if (res) {
+            *res = minmaxflow;
         }
-        IGRAPH_CHECK(igraph_maxflow_value(graph, &flow, i, 0,
-                                          capacity, 0));
+        return IGRAPH_SUCCESS;
+    }
+#endif
+
+    IGRAPH_CHECK(igraph_flow_network_init(&network, graph, capacity));
+    IGRAPH_FINALLY(igraph_flow_network_destroy, &network);
+
+    for (i = 1; i < no_of_nodes; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_mincut_value_directed_pair(&network, &flow, i));
         if (flow < minmaxflow) {
             minmaxflow = flow;
             if (flow == 0) {
@@ -1716,6 +2258,9 @@ igraph_error_t igraph_mincut_value(const igraph_t *graph, igraph_real_t *res,
         }
     }
 
+    igraph_flow_network_destroy(&network);
+    IGRAPH_FINALLY_CLEAN(1);
+
     if (res) {
         *res = minmaxflow;
     }
@@ -1779,27 +2324,18 @@ static igraph_error_t igraph_i_st_vertex_connectivity_check_errors(const igraph_
     return IGRAPH_SUCCESS;
 }
 
-static igraph_error_t igraph_i_st_vertex_connectivity_directed(const igraph_t *graph,
-                                                    igraph_integer_t *res,
-                                                    igraph_integer_t source,
-                                                    igraph_integer_t target,
-                                                    igraph_vconn_nei_t neighbors) {
-
+/* Creates the graph in which vertex connectivities of a directed graph are
+ * calculated as maximum flows. Each vertex v is split into an "out" vertex
+ * v, which keeps the edges starting at v, and an "in" vertex n + v, which
+ * receives the edges pointing to v. Each in-vertex is connected to the
+ * corresponding out-vertex. With unit capacities, the maximum flow from
+ * s to n + t is then the number of vertex-independent paths from s to t.
+ * The same graph serves all (s, t) pairs. */
+static igraph_error_t igraph_i_split_vertices(const igraph_t *graph, igraph_t *split) {
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_integer_t no_of_edges = igraph_ecount(graph);
     igraph_vector_int_t edges;
-    igraph_real_t real_res;
-    igraph_t newgraph;
     igraph_integer_t i;
-    igraph_bool_t done;
-    igraph_integer_t no_conn;
-
-    IGRAPH_CHECK(igraph_i_st_vertex_connectivity_check_errors(graph, res, source, target, neighbors, &done, &no_conn));
-    if (done) {
-        return IGRAPH_SUCCESS;
-    }
-
-    /* Create the new graph */
 
     IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
     IGRAPH_CHECK(igraph_vector_int_reserve(&edges, 2 * (no_of_edges + no_of_nodes)));
@@ -1807,10 +2343,7 @@ static igraph_error_t igraph_i_st_vertex_connectivity_directed(const igraph_t *g
     IGRAPH_CHECK(igraph_vector_int_resize(&edges, 2 * (no_of_edges + no_of_nodes)));
 
     for (i = 0; i < 2 * no_of_edges; i += 2) {
-        igraph_integer_t to = VECTOR(edges)[i + 1];
-        if (to != source && to != target) {
-            VECTOR(edges)[i + 1] = no_of_nodes + to;
-        }
+        VECTOR(edges)[i + 1] += no_of_nodes;
     }
 
     for (i = 0; i < no_of_nodes; i++) {
@@ -1818,17 +2351,39 @@ static igraph_error_t igraph_i_st_vertex_connectivity_directed(const igraph_t *g
         VECTOR(edges)[ 2 * (no_of_edges + i) + 1 ] = i;
     }
 
-    IGRAPH_CHECK(igraph_create(&newgraph, &edges, 2 * no_of_nodes,
-                               igraph_is_directed(graph)));
+    IGRAPH_CHECK(igraph_create(split, &edges, 2 * no_of_nodes, IGRAPH_DIRECTED));
 
     igraph_vector_int_destroy(&edges);
     IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_i_st_vertex_connectivity_directed(const igraph_t *graph,
+                                                    igraph_integer_t *res,
+                                                    igraph_integer_t source,
+                                                    igraph_integer_t target,
+                                                    igraph_vconn_nei_t neighbors) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_real_t real_res;
+    igraph_t newgraph;
+    igraph_bool_t done;
+    igraph_integer_t no_conn;
+
+    IGRAPH_CHECK(igraph_i_st_vertex_connectivity_check_errors(graph, res, source, target, neighbors, &done, &no_conn));
+    if (done) {
+        return IGRAPH_SUCCESS;
+    }
+
+    /* Create the new graph */
+    IGRAPH_CHECK(igraph_i_split_vertices(graph, &newgraph));
     IGRAPH_FINALLY(igraph_destroy, &newgraph);
 
     /* Do the maximum flow */
 
     IGRAPH_CHECK(igraph_maxflow_value(&newgraph, &real_res,
-                                      source, target, 0, 0));
+                                      source, no_of_nodes + target, 0, 0));
     *res = (igraph_integer_t)real_res;
 
     *res -= no_conn;
@@ -1924,25 +2479,161 @@ igraph_error_t igraph_st_vertex_connectivity(const igraph_t *graph,
     return IGRAPH_SUCCESS;
 }
 
+/* The vertex connectivity from 'source' to 'target' in a directed graph,
+ * or the number of vertices if they are adjacent. 'network' is the flow
+ * network of the graph created by igraph_i_split_vertices(). */
+static igraph_error_t igraph_i_vertex_connectivity_pair(const igraph_t *graph,
+                                                         igraph_flow_network_t *network,
+                                                         igraph_integer_t *res,
+                                                         igraph_integer_t source,
+                                                         igraph_integer_t target) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_bool_t conn;
+    igraph_real_t flow;
+
+    IGRAPH_CHECK(igraph_are_connected(graph, source, target, &conn));
+    if (conn) {
+        *res = no_of_nodes;
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_CHECK(igraph_flow_network_maxflow(network, &flow, 0, 0, 0,
+                                             source, no_of_nodes + target, 0));
+    *res = (igraph_integer_t) flow;
+
+    return IGRAPH_SUCCESS;
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+/* Parallel version of the loop of igraph_i_vertex_connectivity_directed().
+ * Vertex pairs (i, j) are numbered as i * no_of_nodes + j and distributed
+ * among the threads, each of which uses its own flow network of 'split'. The
+ * smallest connectivity found so far is shared, so that all threads stop as
+ * soon as one of them finds zero. Pairs are processed in rounds, so that the
+ * user can interrupt the computation between them, outside of the parallel
+ * region. */
+static igraph_error_t igraph_i_vertex_connectivity_directed_parallel(const igraph_t *graph,
+                                                                     const igraph_t *split,
+                                                                     igraph_integer_t *res,
+                                                                     igraph_bool_t symmetric) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_pairs = no_of_nodes * no_of_nodes;
+    igraph_integer_t no_of_threads = igraph_i_parallel_max_threads();
+    igraph_integer_t round_size = no_of_threads * IGRAPH_I_FLOW_PARALLEL_TASKS_PER_ROUND;
+    igraph_integer_t minconn = no_of_nodes - 1;
+    igraph_i_flow_networks_t networks;
+    int error = IGRAPH_SUCCESS;
+
+    IGRAPH_CHECK(igraph_i_flow_networks_init(&networks, no_of_threads, split, NULL));
+    IGRAPH_FINALLY(igraph_i_flow_networks_destroy, &networks);
+
+    for (igraph_integer_t from = 0; from < no_of_pairs && minconn != 0; from += round_size) {
+        igraph_integer_t to = no_of_pairs - from > round_size ? from + round_size : no_of_pairs;
+
+#pragma omp parallel num_threads(networks.size)
+        {
+            igraph_error_handler_t *handler = igraph_i_parallel_enter();
+            igraph_flow_network_t *network = &networks.networks[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic, 1)
+            for (igraph_integer_t k = from; k < to; k++) {
+                igraph_integer_t i = k / no_of_nodes, j = k % no_of_nodes;
+                igraph_integer_t conn, bound;
+                igraph_error_t ret;
+                int current_error;
+
+                if (symmetric ? j <= i : j == i) {
+                    continue;
+                }
+
+#pragma omp atomic read
+                bound = minconn;
+#pragma omp atomic read
+                current_error = error;
+                if (bound == 0 || current_error != IGRAPH_SUCCESS) {
+                    continue;
+                }
+
+                ret = igraph_i_vertex_connectivity_pair(graph, network, &conn, i, j);
+                if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                    error = ret;
+                    continue;
+                }
+
+                if (conn < bound) {
+#pragma omp critical (igraph_i_vertex_connectivity_directed_parallel)
+                    {
+                        if (conn < minconn) {
+                            minconn = conn;
+                        }
+                    }
+                }
+            }
+
+            igraph_i_parallel_exit(handler);
+        }
+
+        if (error != IGRAPH_SUCCESS) {
+            IGRAPH_ERROR("Cannot calculate vertex connectivity.", (igraph_error_t) error);
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    igraph_i_flow_networks_destroy(&networks);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    *res = minconn;
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif /* IGRAPH_I_PARALLEL_API */
+
+/* If 'symmetric' is true, the graph must be the directed version of an
+ * undirected graph (see IGRAPH_TO_DIRECTED_MUTUAL), where the connectivity
+ * from i to j is the same as from j to i. Only pairs with i < j are
+ * considered then. */
 static igraph_error_t igraph_i_vertex_connectivity_directed(const igraph_t *graph,
-                                                 igraph_integer_t *res) {
+                                                 igraph_integer_t *res,
+                                                 igraph_bool_t symmetric) {
 
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_integer_t i, j;
     igraph_integer_t minconn = no_of_nodes - 1, conn = 0;
+    igraph_t split;
+    igraph_flow_network_t network;
+
+    /* The split graph is built only once, and so is its flow network,
+     * instead of once per vertex pair as in igraph_st_vertex_connectivity(). */
+    IGRAPH_CHECK(igraph_i_split_vertices(graph, &split));
+    IGRAPH_FINALLY(igraph_destroy, &split);
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_nodes >= IGRAPH_I_FLOW_PARALLEL_MIN_VERTICES && igraph_i_parallel_max_threads() > 1) {
+        IGRAPH_CHECK(igraph_i_vertex_connectivity_directed_parallel(graph, &split, &minconn, symmetric));
+        igraph_destroy(&split);
+        IGRAPH_FINALLY_CLEAN(1);
+        if (res) {
+            *res = minconn;
+        }
+        return IGRAPH_SUCCESS;
+    }
+#endif
+
+    IGRAPH_CHECK(igraph_flow_network_init(&network, &split, NULL));
+    IGRAPH_FINALLY(igraph_flow_network_destroy, &network);
 
     for (i = 0; i < no_of_nodes; i++) {
-        for (j = 0; j < no_of_nodes; j++) {
+        for (j = symmetric ? i + 1 : 0; j < no_of_nodes; j++) {
             if (i == j) {
                 continue;
             }
 
             IGRAPH_ALLOW_INTERRUPTION();
-
-            IGRAPH_CHECK(igraph_st_vertex_connectivity(graph, &conn,
-                         i,
-                         j,
-                         IGRAPH_VCONN_NEI_NUMBER_OF_NODES));
+            IGRAPH_CHECK(igraph_i_vertex_connectivity_pair(graph, &network, &conn, i, j));
             if (conn < minconn) {
                 minconn = conn;
                 if (conn == 0) {
@@ -1950,11 +2641,15 @@ static igraph_error_t igraph_i_vertex_connectivity_directed(const igraph_t *grap
                 }
             }
         }
-        if (conn == 0) {
+        if (minconn == 0) {
             break;
         }
     }
 
+    igraph_flow_network_destroy(&network);
+    igraph_destroy(&split);
+    IGRAPH_FINALLY_CLEAN(2);
+
     if (res) {
         *res = minconn;
     }
@@ -1970,7 +2665,7 @@ static igraph_error_t igraph_i_vertex_connectivity_undirected(const igraph_t *gr
     IGRAPH_FINALLY(igraph_destroy, &newgraph);
     IGRAPH_CHECK(igraph_to_directed(&newgraph, IGRAPH_TO_DIRECTED_MUTUAL));
 
-    IGRAPH_CHECK(igraph_i_vertex_connectivity_directed(&newgraph, res));
+    IGRAPH_CHECK(igraph_i_vertex_connectivity_directed(&newgraph, res, /* symmetric = */ true));
 
     igraph_destroy(&newgraph);
     IGRAPH_FINALLY_CLEAN(1);
@@ -2052,6 +2747,11 @@ static igraph_error_t igraph_i_connectivity_checks(const igraph_t *graph,
  *    They were suggested by Peter McMahan, thanks Peter.
  * \return Error code.
  *
+ * </para><para>
+ * When igraph is built with OpenMP support, the maximum flow calculations
+ * for different vertex pairs run in parallel, and all of them stop as soon
+ * as a pair with zero connectivity is found.
+ *
  * Time complexity: O(|V|^5).
  *
  * \sa \ref igraph_st_vertex_connectivity(), \ref igraph_maxflow_value(),
@@ -2070,7 +2770,7 @@ igraph_error_t igraph_vertex_connectivity(const igraph_t *graph, igraph_integer_
     /* Are we done yet? */
     if (!ret) {
         if (igraph_is_directed(graph)) {
-            IGRAPH_CHECK(igraph_i_vertex_connectivity_directed(graph, res));
+            IGRAPH_CHECK(igraph_i_vertex_connectivity_directed(graph, res, /* symmetric = */ false));
         } else {
             IGRAPH_CHECK(igraph_i_vertex_connectivity_undirected(graph, res));
         }
@@ -2379,6 +3079,55 @@ igraph_error_t igraph_cohesion(const igraph_t *graph, igraph_integer_t *res,
     return IGRAPH_SUCCESS;
 }
 
+/* Computes the maximum flows and the source side of the corresponding minimum
+ * cuts from 'batch_size' consecutive source vertices, starting at 'source',
+ * to the vertices in 'targets', for igraph_gomory_hu_tree(). The flows of a
+ * batch are independent, so they are computed in parallel; each thread uses
+ * its own flow network as push-relabel workspace. */
+static igraph_error_t igraph_i_gomory_hu_flows(igraph_i_flow_networks_t *networks,
+                                               igraph_integer_t source,
+                                               igraph_integer_t batch_size,
+                                               const igraph_vector_int_t *targets,
+                                               igraph_vector_t *flow_values,
+                                               igraph_vector_int_list_t *partitions) {
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (batch_size > 1) {
+        int error = IGRAPH_SUCCESS;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(networks->size)
+        for (igraph_integer_t k = 0; k < batch_size; k++) {
+            igraph_error_handler_t *handler = igraph_i_parallel_enter();
+            igraph_error_t ret = igraph_flow_network_maxflow(
+                        &networks->networks[omp_get_thread_num()],
+                        &VECTOR(*flow_values)[k], 0,
+                        igraph_vector_int_list_get_ptr(partitions, k), 0,
+                        source + k, VECTOR(*targets)[k], 0);
+            igraph_i_parallel_exit(handler);
+            if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                error = ret;
+            }
+        }
+
+        if (error != IGRAPH_SUCCESS) {
+            IGRAPH_ERROR("Cannot calculate Gomory-Hu tree.", (igraph_error_t) error);
+        }
+
+        return IGRAPH_SUCCESS;
+    }
+#endif
+
+    for (igraph_integer_t k = 0; k < batch_size; k++) {
+        IGRAPH_CHECK(igraph_flow_network_maxflow(&networks->networks[0],
+                                                 &VECTOR(*flow_values)[k], 0,
+                                                 igraph_vector_int_list_get_ptr(partitions, k), 0,
+                                                 source + k, VECTOR(*targets)[k], 0));
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_gomory_hu_tree
  * \brief Gomory-Hu tree of a graph.
@@ -2415,6 +3164,13 @@ igraph_error_t igraph_cohesion(const igraph_t *graph, igraph_integer_t *res,
  *        every edge is considered to have capacity 1.0.
  * \return Error code.
  *
+ * </para><para>
+ * When igraph is built with OpenMP support, the maximum flows of several
+ * consecutive source vertices are computed in parallel, speculatively
+ * assuming that their neighbors in the tree do not change in the meantime.
+ * Flows whose assumption turns out to be wrong are recomputed, so the result
+ * is the same as with a single thread.
+ *
  * Time complexity: O(|V|^4) since it performs a max-flow calculation
  * between vertex zero and every other vertex and max-flow is
  * O(|V|^3).
@@ -2425,11 +3181,15 @@ igraph_error_t igraph_gomory_hu_tree(const igraph_t *graph, igraph_t *tree,
                           igraph_vector_t *flows, const igraph_vector_t *capacity) {
 
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
-    igraph_integer_t source, target, mid, i, n;
+    igraph_integer_t source, target, mid, i, k, n;
+    igraph_integer_t batch_size, batch_end;
     igraph_vector_int_t neighbors;
     igraph_vector_t flow_values;
     igraph_vector_int_t partition;
-    igraph_vector_int_t partition2;
+    igraph_vector_int_list_t partitions;
+    igraph_vector_int_t batch_targets;
+    igraph_vector_t batch_flow_values;
+    igraph_i_flow_networks_t networks;
     igraph_real_t flow_value;
 
     if (igraph_is_directed(graph)) {
@@ -2437,51 +3197,92 @@ igraph_error_t igraph_gomory_hu_tree(const igraph_t *graph, igraph_t *tree,
                      IGRAPH_EINVAL);
     }
 
+    /* Maximum flows are computed in batches of consecutive source vertices,
+     * one flow per thread; see igraph_i_gomory_hu_flows(). Single-threaded,
+     * this is exactly Gusfield's algorithm. */
+    batch_size = 1;
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_nodes >= IGRAPH_I_FLOW_PARALLEL_MIN_VERTICES) {
+        batch_size = igraph_i_parallel_max_threads();
+    }
+#endif
+
     /* Allocate memory */
     IGRAPH_VECTOR_INT_INIT_FINALLY(&neighbors, no_of_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&flow_values, no_of_nodes);
     IGRAPH_VECTOR_INT_INIT_FINALLY(&partition, 0);
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&partition2, 0);
+    IGRAPH_CHECK(igraph_vector_int_list_init(&partitions, batch_size));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &partitions);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&batch_targets, batch_size);
+    IGRAPH_VECTOR_INIT_FINALLY(&batch_flow_values, batch_size);
+
+    /* The graph is converted to a flow network only once per thread,
+     * instead of in each igraph_maxflow() call. */
+    IGRAPH_CHECK(igraph_i_flow_networks_init(&networks, batch_size, graph, capacity));
+    IGRAPH_FINALLY(igraph_i_flow_networks_destroy, &networks);
 
     /* Initialize the tree: every edge points to node 0 */
     /* Actually, this is done implicitly since both 'neighbors' and 'flow_values' are
      * initialized to zero already */
 
     /* For each source vertex except vertex zero... */
-    for (source = 1; source < no_of_nodes; source++) {
+    for (source = 1; source < no_of_nodes; ) {
         IGRAPH_ALLOW_INTERRUPTION();
         IGRAPH_PROGRESS("Gomory-Hu tree", (100.0 * (source - 1)) / (no_of_nodes - 1), 0);
 
-        /* Find its current neighbor in the tree */
-        target = VECTOR(neighbors)[source];
+        /* Find the current neighbors of the next few source vertices in
+         * the tree, and the maximum flows between them */
+        batch_end = source + batch_size < no_of_nodes ? source + batch_size : no_of_nodes;
+        for (k = 0; source + k < batch_end; k++) {
+            VECTOR(batch_targets)[k] = VECTOR(neighbors)[source + k];
+        }
+        IGRAPH_CHECK(igraph_i_gomory_hu_flows(&networks, source, batch_end - source,
+                                              &batch_targets, &batch_flow_values, &partitions));
+
+        for (k = 0; source < batch_end; k++, source++) {
+            target = VECTOR(batch_targets)[k];
+
+            /* Updating the tree for earlier sources of the batch may have
+             * changed the neighbor of this one, in which case the flow has to
+             * be recomputed; this one becomes the first source of the next
+             * batch. The first source of a batch is always up-to-date. */
+            if (VECTOR(neighbors)[source] != target) {
+                break;
+            }
 
-        /* Find the maximum flow between source and target */
-        IGRAPH_CHECK(igraph_maxflow(graph, &flow_value, 0, 0, &partition, &partition2,
-                                    source, target, capacity, 0));
+            flow_value = VECTOR(batch_flow_values)[k];
+            IGRAPH_CHECK(igraph_vector_int_update(&partition, igraph_vector_int_list_get_ptr(&partitions, k)));
 
-        /* Store the maximum flow */
-        VECTOR(flow_values)[source] = flow_value;
+            /* Store the maximum flow */
+            VECTOR(flow_values)[source] = flow_value;
 
-        /* Update the tree */
-        /* igraph_maxflow() guarantees that the source vertex will be in &partition
-         * and not in &partition2 so we need to iterate over &partition to find
-         * all the nodes that are of interest to us */
-        n = igraph_vector_int_size(&partition);
-        for (i = 0; i < n; i++) {
-            mid = VECTOR(partition)[i];
-            if (mid != source) {
-                if (VECTOR(neighbors)[mid] == target) {
-                    VECTOR(neighbors)[mid] = source;
-                } else if (VECTOR(neighbors)[target] == mid) {
-                    VECTOR(neighbors)[target] = source;
-                    VECTOR(neighbors)[source] = mid;
-                    VECTOR(flow_values)[source] = VECTOR(flow_values)[target];
-                    VECTOR(flow_values)[target] = flow_value;
+            /* Update the tree */
+            /* igraph_maxflow() guarantees that the source vertex will be in &partition
+             * and not in &partition2 so we need to iterate over &partition to find
+             * all the nodes that are of interest to us */
+            n = igraph_vector_int_size(&partition);
+            for (i = 0; i < n; i++) {
+                mid = VECTOR(partition)[i];
+                if (mid != source) {
+                    if (VECTOR(neighbors)[mid] == target) {
+                        VECTOR(neighbors)[mid] = source;
+                    } else if (VECTOR(neighbors)[target] == mid) {
+                        VECTOR(neighbors)[target] = source;
+                        VECTOR(neighbors)[source] = mid;
+                        VECTOR(flow_values)[source] = VECTOR(flow_values)[target];
+                        VECTOR(flow_values)[target] = flow_value;
+                    }
                 }
             }
         }
     }
 
+    igraph_i_flow_networks_destroy(&networks);
+    igraph_vector_destroy(&batch_flow_values);
+    igraph_vector_int_destroy(&batch_targets);
+    igraph_vector_int_list_destroy(&partitions);
+    IGRAPH_FINALLY_CLEAN(4);
+
     IGRAPH_PROGRESS("Gomory-Hu tree", 100.0, 0);
 
     /* Re-use the 'partition' vector as an edge list now */
@@ -2497,10 +3298,9 @@ igraph_error_t igraph_gomory_hu_tree(const igraph_t *graph, igraph_t *tree,
     IGRAPH_CHECK(igraph_add_edges(tree, &partition, 0));
 
     /* Free the allocated memory */
-    igraph_vector_int_destroy(&partition2);
     igraph_vector_int_destroy(&partition);
     igraph_vector_int_destroy(&neighbors);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     /* Return the flow values to the caller */
     if (flows != 0) {
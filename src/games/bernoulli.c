@@ -0,0 +1,350 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "games/games_internal.h"
+
+#include "igraph_random.h"
+
+#include "core/interruption.h"
+#include "core/parallel.h"
+#include "math/safe_intop.h"
+#include "random/random_internal.h"
+
+#include <math.h>
+
+/* Sampling of independent edges, shared by the G(n,p) and stochastic block
+ * model generators.
+ *
+ * The rows of the blocks are split into chunks of roughly equal expected work.
+ * Each chunk is sampled with geometric skips from its own random number stream,
+ * so the result does not depend on the order in which chunks are processed.
+ * The sequential version appends the edges of the chunks to the result in
+ * order. The parallel version makes two passes: the first one counts the edges
+ * of each chunk, and the second one generates them again, directly into their
+ * final place in the result. Both check for interruption between chunks, the
+ * parallel version after each round of chunks, see igraph_i_parallel_run_tasks().
+ *
+ * Positions within a chunk are kept as integers, and a chunk never has more
+ * than 2^52 potential edges, so the skips are applied exactly even when the
+ * number of potential edges of the whole graph cannot be represented exactly
+ * by a double. */
+
+/* Expected number of edges, plus the number of rows for triangles, in a chunk. */
+#define IGRAPH_I_BERNOULLI_CHUNK_COST 65536.0
+
+/* 2^52, doubles represent all integers up to this value exactly. */
+#define IGRAPH_I_BERNOULLI_MAX_CHUNK_SLOTS 4503599627370496.0
+
+static igraph_bool_t igraph_i_bernoulli_is_rectangle(const igraph_i_bernoulli_block_t *block) {
+    return block->shape == IGRAPH_I_BERNOULLI_RECTANGLE ||
+           block->shape == IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG;
+}
+
+static igraph_integer_t igraph_i_bernoulli_row_length(const igraph_i_bernoulli_block_t *block,
+                                                      igraph_integer_t row) {
+    switch (block->shape) {
+    case IGRAPH_I_BERNOULLI_RECTANGLE:
+        return block->from_size;
+    case IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG:
+        return block->from_size - 1;
+    case IGRAPH_I_BERNOULLI_TRIANGLE:
+        return row + 1;
+    default:
+        return row;
+    }
+}
+
+/* The number of potential edges in rows begin, ..., end - 1. */
+static igraph_real_t igraph_i_bernoulli_slots(const igraph_i_bernoulli_block_t *block,
+                                              igraph_integer_t begin, igraph_integer_t end) {
+    igraph_real_t b = begin, e = end;
+
+    switch (block->shape) {
+    case IGRAPH_I_BERNOULLI_TRIANGLE:
+        return (e * (e + 1) - b * (b + 1)) / 2;
+    case IGRAPH_I_BERNOULLI_TRIANGLE_NO_DIAG:
+        return (e * (e - 1) - b * (b - 1)) / 2;
+    default:
+        return (e - b) * igraph_i_bernoulli_row_length(block, begin);
+    }
+}
+
+/* Splits the blocks into chunks. Each chunk is described by three elements of
+ * 'chunks': the index of the block, and the first and one past the last row.
+ * Also returns the expected total number of edges. */
+static igraph_error_t igraph_i_bernoulli_chunks(const igraph_i_bernoulli_block_t *blocks,
+                                                igraph_integer_t no_of_blocks,
+                                                igraph_vector_int_t *chunks,
+                                                igraph_real_t *expected) {
+    igraph_vector_int_clear(chunks);
+    *expected = 0;
+
+    for (igraph_integer_t b = 0; b < no_of_blocks; b++) {
+        const igraph_i_bernoulli_block_t *block = &blocks[b];
+        igraph_integer_t rows = block->to_size;
+        igraph_real_t prob = block->prob;
+
+        if (!(prob > 0) || rows == 0) {
+            continue;
+        }
+        *expected += prob * igraph_i_bernoulli_slots(block, 0, rows);
+
+        if (igraph_i_bernoulli_is_rectangle(block)) {
+            igraph_integer_t length = igraph_i_bernoulli_row_length(block, 0);
+            igraph_real_t per_chunk;
+            igraph_integer_t rows_per_chunk;
+
+            if (length == 0) {
+                continue;
+            }
+
+            /* Skipping rows of a rectangle takes constant time, only the
+             * edges count. */
+            per_chunk = floor(IGRAPH_I_BERNOULLI_CHUNK_COST / (prob * length));
+            if (per_chunk > floor(IGRAPH_I_BERNOULLI_MAX_CHUNK_SLOTS / length)) {
+                per_chunk = floor(IGRAPH_I_BERNOULLI_MAX_CHUNK_SLOTS / length);
+            }
+            rows_per_chunk = per_chunk < 1 ? 1 : (per_chunk >= rows ? rows : (igraph_integer_t) per_chunk);
+
+            for (igraph_integer_t begin = 0; begin < rows; begin += rows_per_chunk) {
+                IGRAPH_CHECK(igraph_vector_int_push_back(chunks, b));
+                IGRAPH_CHECK(igraph_vector_int_push_back(chunks, begin));
+                IGRAPH_CHECK(igraph_vector_int_push_back(chunks,
+                             rows - begin > rows_per_chunk ? begin + rows_per_chunk : rows));
+            }
+        } else {
+            igraph_integer_t begin = 0;
+            igraph_real_t cost = 0, slots = 0;
+
+            /* Triangles are traversed row by row. */
+            for (igraph_integer_t row = 0; row < rows; row++) {
+                igraph_integer_t length = igraph_i_bernoulli_row_length(block, row);
+                if (row > begin && (cost + 1 + prob * length > IGRAPH_I_BERNOULLI_CHUNK_COST ||
+                                    slots + length > IGRAPH_I_BERNOULLI_MAX_CHUNK_SLOTS)) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(chunks, b));
+                    IGRAPH_CHECK(igraph_vector_int_push_back(chunks, begin));
+                    IGRAPH_CHECK(igraph_vector_int_push_back(chunks, row));
+                    begin = row;
+                    cost = slots = 0;
+                }
+                cost += 1 + prob * length;
+                slots += length;
+            }
+            IGRAPH_CHECK(igraph_vector_int_push_back(chunks, b));
+            IGRAPH_CHECK(igraph_vector_int_push_back(chunks, begin));
+            IGRAPH_CHECK(igraph_vector_int_push_back(chunks, rows));
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Samples the edges in rows begin, ..., end - 1 of a block. All edges are
+ * counted, but at most 'capacity' of them are stored in 'out'. */
+static igraph_integer_t igraph_i_bernoulli_chunk(const igraph_i_bernoulli_block_t *block,
+                                                 igraph_integer_t begin, igraph_integer_t end,
+                                                 igraph_rng_t *rng,
+                                                 igraph_integer_t *out, igraph_integer_t capacity) {
+    igraph_bool_t rectangle = igraph_i_bernoulli_is_rectangle(block);
+    igraph_real_t slots = igraph_i_bernoulli_slots(block, begin, end);
+    igraph_integer_t row = begin, col = 0, count = 0;
+    igraph_integer_t length = igraph_i_bernoulli_row_length(block, begin);
+    igraph_i_rng_buffer_t buffer;
+
+    igraph_i_rng_buffer_init(&buffer, rng);
+
+    while (true) {
+        igraph_real_t skip = igraph_i_rng_buffer_geom(&buffer, block->prob, slots);
+
+        if (rectangle) {
+            igraph_real_t target = col + skip;
+            if (target >= length) {
+                igraph_real_t skipped_rows = floor(target / length);
+                if (skipped_rows >= end - row) {
+                    break;
+                }
+                row += (igraph_integer_t) skipped_rows;
+                col = (igraph_integer_t) (target - skipped_rows * length);
+            } else {
+                col = (igraph_integer_t) target;
+            }
+        } else {
+            while (skip >= length - col) {
+                skip -= length - col;
+                col = 0;
+                if (++row == end) {
+                    return count;
+                }
+                length = igraph_i_bernoulli_row_length(block, row);
+            }
+            col += (igraph_integer_t) skip;
+        }
+
+        if (count < capacity) {
+            igraph_integer_t from = col;
+            if (block->shape == IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG && col >= row) {
+                from++;
+            }
+            out[2 * count] = block->from_offset + from;
+            out[2 * count + 1] = block->to_offset + row;
+        }
+        count++;
+        col++;
+    }
+
+    return count;
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+/* The chunks of igraph_i_bernoulli_edges(), generated in two passes. */
+typedef struct {
+    const igraph_i_bernoulli_block_t *blocks;
+    const igraph_vector_int_t *chunks;
+    igraph_vector_int_t *offsets;
+    igraph_integer_t *out;
+} igraph_i_bernoulli_pass_t;
+
+/* If 'out' is NULL, stores the number of edges of chunk 'c' in offsets[c + 1].
+ * Otherwise, stores the edges of chunk 'c' in out, starting at edge offsets[c].
+ * See igraph_i_parallel_run_tasks(). */
+static igraph_error_t igraph_i_bernoulli_task(void *data, void *workspace,
+                                              igraph_rng_t *rng, igraph_integer_t c) {
+    const igraph_i_bernoulli_pass_t *pass = data;
+    const igraph_i_bernoulli_block_t *block = &pass->blocks[VECTOR(*pass->chunks)[3 * c]];
+    igraph_integer_t begin = VECTOR(*pass->chunks)[3 * c + 1], end = VECTOR(*pass->chunks)[3 * c + 2];
+
+    IGRAPH_UNUSED(workspace);
+
+    if (pass->out) {
+        igraph_integer_t first = VECTOR(*pass->offsets)[c];
+        igraph_i_bernoulli_chunk(block, begin, end, rng, pass->out + 2 * first,
+                                 VECTOR(*pass->offsets)[c + 1] - first);
+    } else {
+        VECTOR(*pass->offsets)[c + 1] = igraph_i_bernoulli_chunk(block, begin, end, rng, NULL, 0);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_i_bernoulli_edges_parallel(const igraph_i_bernoulli_block_t *blocks,
+                                                        const igraph_vector_int_t *chunks,
+                                                        igraph_uint_t seed,
+                                                        igraph_vector_int_t *offsets,
+                                                        igraph_integer_t *out) {
+    igraph_i_bernoulli_pass_t pass;
+    igraph_i_parallel_tasks_t tasks = { 0 };
+
+    pass.blocks = blocks;
+    pass.chunks = chunks;
+    pass.offsets = offsets;
+    pass.out = out;
+
+    tasks.no_of_tasks = igraph_vector_int_size(chunks) / 3;
+    tasks.seed = seed;
+    tasks.data = &pass;
+    tasks.run = igraph_i_bernoulli_task;
+    tasks.error_message = "Cannot generate random graph.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif /* IGRAPH_I_PARALLEL_API */
+
+/* Includes each potential edge of the blocks independently, with the
+ * probability of its block, and stores the edges in 'edges', in the order of
+ * the blocks, and by row within a block. Uses a seed drawn from the default
+ * random number generator. */
+igraph_error_t igraph_i_bernoulli_edges(const igraph_i_bernoulli_block_t *blocks,
+                                        igraph_integer_t no_of_blocks,
+                                        igraph_vector_int_t *edges) {
+    igraph_vector_int_t chunks;
+    igraph_integer_t no_of_chunks;
+    igraph_real_t expected;
+    igraph_uint_t seed;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&chunks, 0);
+    IGRAPH_CHECK(igraph_i_bernoulli_chunks(blocks, no_of_blocks, &chunks, &expected));
+    no_of_chunks = igraph_vector_int_size(&chunks) / 3;
+
+    seed = igraph_i_rng_stream_seed();
+    igraph_vector_int_clear(edges);
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_chunks > 1 && igraph_i_parallel_max_threads() > 1) {
+        igraph_vector_int_t offsets;
+        igraph_integer_t no_of_edges = 0, size;
+
+        IGRAPH_VECTOR_INT_INIT_FINALLY(&offsets, no_of_chunks + 1);
+        IGRAPH_CHECK(igraph_i_bernoulli_edges_parallel(blocks, &chunks, seed, &offsets, NULL));
+        for (igraph_integer_t c = 1; c <= no_of_chunks; c++) {
+            IGRAPH_SAFE_ADD(no_of_edges, VECTOR(offsets)[c], &no_of_edges);
+            VECTOR(offsets)[c] = no_of_edges;
+        }
+        IGRAPH_SAFE_MULT(no_of_edges, 2, &size);
+        IGRAPH_CHECK(igraph_vector_int_resize(edges, size));
+        IGRAPH_CHECK(igraph_i_bernoulli_edges_parallel(blocks, &chunks, seed, &offsets, VECTOR(*edges)));
+
+        igraph_vector_int_destroy(&offsets);
+        IGRAPH_FINALLY_CLEAN(1);
+    } else
+#endif
+    {
+        igraph_rng_t rng;
+        igraph_integer_t reserve;
+
+        IGRAPH_CHECK(igraph_i_safe_floor(expected * 1.1, &reserve));
+        IGRAPH_SAFE_MULT(reserve, 2, &reserve);
+        IGRAPH_CHECK(igraph_vector_int_reserve(edges, reserve));
+
+        IGRAPH_CHECK(igraph_rng_init(&rng, &igraph_rngtype_philox4x32));
+        IGRAPH_FINALLY(igraph_rng_destroy, &rng);
+
+        for (igraph_integer_t c = 0; c < no_of_chunks; c++) {
+            const igraph_i_bernoulli_block_t *block = &blocks[VECTOR(chunks)[3 * c]];
+            igraph_integer_t begin = VECTOR(chunks)[3 * c + 1], end = VECTOR(chunks)[3 * c + 2];
+            igraph_integer_t size = igraph_vector_int_size(edges);
+            igraph_integer_t available = (igraph_vector_int_capacity(edges) - size) / 2;
+            igraph_integer_t count, new_size;
+
+            IGRAPH_ALLOW_INTERRUPTION();
+
+            igraph_rng_seed_stream(&rng, seed, (igraph_uint_t) c);
+            count = igraph_i_bernoulli_chunk(block, begin, end, &rng, VECTOR(*edges) + size, available);
+            IGRAPH_SAFE_MULT(count, 2, &new_size);
+            IGRAPH_SAFE_ADD(new_size, size, &new_size);
+            if (count > available) {
+                /* The estimate was too low. Make room for this chunk and
+                 * some more, then generate it again. */
+                IGRAPH_CHECK(igraph_vector_int_reserve(edges, new_size + new_size / 8));
+                igraph_rng_seed_stream(&rng, seed, (igraph_uint_t) c);
+                igraph_i_bernoulli_chunk(block, begin, end, &rng, VECTOR(*edges) + size, count);
+            }
+            IGRAPH_CHECK(igraph_vector_int_resize(edges, new_size));
+        }
+
+        igraph_rng_destroy(&rng);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    igraph_vector_int_destroy(&chunks);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
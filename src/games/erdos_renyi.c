@@ -27,6 +27,7 @@
 #include "igraph_interface.h"
 #include "igraph_random.h"
 
+#include "games/games_internal.h"
 #include "random/random_internal.h"
 #include "math/safe_intop.h"
 
@@ -41,16 +42,8 @@ igraph_error_t igraph_erdos_renyi_game_gnp(
     igraph_t *graph, igraph_integer_t n, igraph_real_t p,
     igraph_bool_t directed, igraph_bool_t loops
 ) {
-    /* This function uses doubles in its `s` vector, and for `maxedges` and `last`.
-     * This is because on a system with 32-bit ints, maxedges will be larger than
-     * IGRAPH_INTEGER_MAX and this will cause overflows when calculating `from` and `to`
-     * for tests on large graphs.
-    */
-    igraph_integer_t no_of_nodes = n;
-    igraph_real_t no_of_nodes_real = (igraph_real_t) no_of_nodes;   /* for divisions below */
-    igraph_vector_int_t edges = IGRAPH_VECTOR_NULL;
-    igraph_vector_t s = IGRAPH_VECTOR_NULL;
-    igraph_integer_t vsize;
+    igraph_vector_int_t edges;
+    igraph_i_bernoulli_block_t block;
 
     if (n < 0) {
         IGRAPH_ERROR("Invalid number of vertices.", IGRAPH_EINVAL);
@@ -59,83 +52,22 @@ igraph_error_t igraph_erdos_renyi_game_gnp(
         IGRAPH_ERROR("Invalid probability given.", IGRAPH_EINVAL);
     }
 
-    if (p == 0.0 || no_of_nodes == 0) {
+    if (p == 0.0 || n == 0) {
         IGRAPH_CHECK(igraph_empty(graph, n, directed));
     } else if (p == 1.0) {
         IGRAPH_CHECK(igraph_full(graph, n, directed, loops));
     } else {
-
-        igraph_integer_t i;
-        igraph_real_t maxedges = n, last;
-        igraph_integer_t maxedges_int;
-
-        if (directed && loops) {
-            maxedges *= n;
-        } else if (directed && !loops) {
-            maxedges *= (n - 1);
-        } else if (!directed && loops) {
-            maxedges *= (n + 1) / 2.0;
+        if (directed) {
+            block.shape = loops ? IGRAPH_I_BERNOULLI_RECTANGLE : IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG;
         } else {
-            maxedges *= (n - 1) / 2.0;
+            block.shape = loops ? IGRAPH_I_BERNOULLI_TRIANGLE : IGRAPH_I_BERNOULLI_TRIANGLE_NO_DIAG;
         }
-
-        if (maxedges > IGRAPH_MAX_EXACT_REAL) {
-            IGRAPH_ERROR("Too many vertices, overflow in maximum number of edges.", IGRAPH_EOVERFLOW);
-        }
-        IGRAPH_VECTOR_INIT_FINALLY(&s, 0);
-        IGRAPH_CHECK(igraph_i_safe_floor(maxedges * p * 1.1, &maxedges_int));
-        IGRAPH_CHECK(igraph_vector_reserve(&s, maxedges_int));
-
-        RNG_BEGIN();
-
-        last = RNG_GEOM(p);
-        while (last < maxedges) {
-            IGRAPH_CHECK(igraph_vector_push_back(&s, last));
-            last += RNG_GEOM(p);
-            last += 1;
-        }
-
-        RNG_END();
+        block.from_offset = block.to_offset = 0;
+        block.from_size = block.to_size = n;
+        block.prob = p;
 
         IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
-        IGRAPH_CHECK(igraph_vector_int_reserve(&edges, igraph_vector_size(&s) * 2));
-
-        vsize = igraph_vector_size(&s);
-        if (directed && loops) {
-            for (i = 0; i < vsize; i++) {
-                igraph_integer_t to = floor(VECTOR(s)[i] / no_of_nodes_real);
-                igraph_integer_t from = VECTOR(s)[i] - to * no_of_nodes_real;
-                igraph_vector_int_push_back(&edges, from);
-                igraph_vector_int_push_back(&edges, to);
-            }
-        } else if (directed && !loops) {
-            for (i = 0; i < vsize; i++) {
-                igraph_integer_t to = floor(VECTOR(s)[i] / no_of_nodes_real);
-                igraph_integer_t from = VECTOR(s)[i] - to * no_of_nodes_real;
-                if (from == to) {
-                    to = no_of_nodes - 1;
-                }
-                igraph_vector_int_push_back(&edges, from);
-                igraph_vector_int_push_back(&edges, to);
-            }
-        } else if (!directed && loops) {
-            for (i = 0; i < vsize; i++) {
-                igraph_integer_t to = floor((sqrt(8 * VECTOR(s)[i] + 1) - 1) / 2);
-                igraph_integer_t from = VECTOR(s)[i] - (((igraph_real_t)to) * (to + 1)) / 2;
-                igraph_vector_int_push_back(&edges, from);
-                igraph_vector_int_push_back(&edges, to);
-            }
-        } else { /* !directed && !loops */
-            for (i = 0; i < vsize; i++) {
-                igraph_integer_t to = floor((sqrt(8 * VECTOR(s)[i] + 1) + 1) / 2);
-                igraph_integer_t from = VECTOR(s)[i] - (((igraph_real_t)to) * (to - 1)) / 2;
-                igraph_vector_int_push_back(&edges, from);
-                igraph_vector_int_push_back(&edges, to);
-            }
-        }
-
-        igraph_vector_destroy(&s);
-        IGRAPH_FINALLY_CLEAN(1);
+        IGRAPH_CHECK(igraph_i_bernoulli_edges(&block, 1, &edges));
         IGRAPH_CHECK(igraph_create(graph, &edges, n, directed));
         igraph_vector_int_destroy(&edges);
         IGRAPH_FINALLY_CLEAN(1);
@@ -249,6 +181,13 @@ igraph_error_t igraph_erdos_renyi_game_gnm(
  * \function igraph_erdos_renyi_game
  * \brief Generates a random (Erdős-Rényi) graph.
  *
+ * </para><para>
+ * When igraph is built with OpenMP support, G(n,p) graphs are generated in
+ * parallel. The potential edges are split into chunks, each of which draws
+ * its random numbers from a separate Philox stream, derived from a seed taken
+ * from the default random number generator. Therefore the result only depends
+ * on the state of the default generator, not on the number of threads.
+ *
  * \param graph Pointer to an uninitialized graph object.
  * \param type The type of the random graph, possible values:
  *        \clist
@@ -0,0 +1,56 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_GAMES_INTERNAL_H
+#define IGRAPH_GAMES_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+
+__BEGIN_DECLS
+
+/* The shape of a set of potential edges between two groups of vertices,
+ * each of which is included independently with the same probability.
+ *
+ * The potential edges are arranged into rows, one for each vertex of the
+ * 'to' group. Row 'i' of a rectangle contains the edges from all vertices
+ * of the 'from' group, the other shapes are only used when the two groups
+ * are the same: row 'i' of a triangle contains the edges from vertices
+ * 0, ..., i, and the _NO_DIAG variants exclude the loop edge (i, i). */
+typedef enum {
+    IGRAPH_I_BERNOULLI_RECTANGLE,
+    IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG,
+    IGRAPH_I_BERNOULLI_TRIANGLE,
+    IGRAPH_I_BERNOULLI_TRIANGLE_NO_DIAG
+} igraph_i_bernoulli_shape_t;
+
+typedef struct {
+    igraph_i_bernoulli_shape_t shape;
+    igraph_integer_t from_offset, from_size;
+    igraph_integer_t to_offset, to_size;
+    igraph_real_t prob;
+} igraph_i_bernoulli_block_t;
+
+igraph_error_t igraph_i_bernoulli_edges(const igraph_i_bernoulli_block_t *blocks,
+                                        igraph_integer_t no_of_blocks,
+                                        igraph_vector_int_t *edges);
+
+__END_DECLS
+
+#endif
@@ -26,11 +26,13 @@
 
 #include "igraph_constructors.h"
 #include "igraph_matrix.h"
+#include "igraph_memory.h"
 #include "igraph_random.h"
 #include "igraph_vector.h"
 
-#include "core/interruption.h"
+#include "games/games_internal.h"
 #include "math/safe_intop.h"
+#include "random/random_internal.h"
 
 #include <float.h>      /* for DBL_EPSILON */
 #include <math.h>       /* for sqrt and floor */
@@ -50,6 +52,10 @@
  * The order of the vertex IDs in the generated graph corresponds to
  * the \p block_sizes argument.
  *
+ * </para><para>
+ * When igraph is built with OpenMP support, the edges are generated in
+ * parallel, see \ref igraph_erdos_renyi_game() for details.
+ *
  * \param graph The output graph. This should be a pointer to an
  *     uninitialized graph.
  * \param n Number of vertices.
@@ -77,15 +83,12 @@ igraph_error_t igraph_sbm_game(igraph_t *graph, igraph_integer_t n,
                     const igraph_vector_int_t *block_sizes,
                     igraph_bool_t directed, igraph_bool_t loops) {
 
-#define IGRAPH_CHECK_MAXEDGES() \
-    do {if (maxedges > IGRAPH_MAX_EXACT_REAL) { \
-        IGRAPH_ERROR("Too many vertices, overflow in maximum number of edges.", IGRAPH_EOVERFLOW); \
-    }} while (0)
-
     igraph_integer_t no_blocks = igraph_matrix_nrow(pref_matrix);
     igraph_integer_t from, to, fromoff = 0;
+    igraph_integer_t no_pairs, no_of_pairs = 0;
     igraph_real_t minp, maxp;
     igraph_vector_int_t edges;
+    igraph_i_bernoulli_block_t *pairs;
 
     /* ------------------------------------------------------------ */
     /* Check arguments                                              */
@@ -131,123 +134,50 @@ igraph_error_t igraph_sbm_game(igraph_t *graph, igraph_integer_t n,
      * guaranteed to be non-negative. This shouldn't be checked separately.
      */
 
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
-
-    RNG_BEGIN();
+    IGRAPH_SAFE_MULT(no_blocks, no_blocks, &no_pairs);
+    pairs = IGRAPH_CALLOC(no_pairs > 0 ? no_pairs : 1, igraph_i_bernoulli_block_t);
+    IGRAPH_CHECK_OOM(pairs, "Insufficient memory for stochastic block model.");
+    IGRAPH_FINALLY(igraph_free, pairs);
 
     for (from = 0; from < no_blocks; from++) {
         igraph_integer_t fromsize = VECTOR(*block_sizes)[from];
         igraph_integer_t start = directed ? 0 : from;
         igraph_integer_t i, tooff = 0;
 
-        IGRAPH_ALLOW_INTERRUPTION();
-
         for (i = 0; i < start; i++) {
             tooff += VECTOR(*block_sizes)[i];
         }
         for (to = start; to < no_blocks; to++) {
             igraph_integer_t tosize = VECTOR(*block_sizes)[to];
-            igraph_real_t prob = MATRIX(*pref_matrix, from, to);
-            igraph_real_t maxedges;
-            igraph_real_t last = RNG_GEOM(prob);  /* RNG_GEOM may return NaN so igraph_integer_t is not suitable */
-            igraph_integer_t vfrom, vto;
-
-            if (directed && loops) {
-                maxedges = ((igraph_real_t) fromsize) * tosize;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor(last / fromsize);
-                    vfrom = last - ((igraph_real_t) vto) * fromsize;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else if (directed && !loops && from != to) {
-                maxedges = ((igraph_real_t) fromsize) * tosize;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor(last / fromsize);
-                    vfrom = last - ((igraph_real_t) vto) * fromsize;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else if (directed && !loops && from == to) {
-                maxedges = ((igraph_real_t) fromsize) * (fromsize - 1.0);
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor(last / fromsize);
-                    vfrom = last - ((igraph_real_t) vto) * fromsize;
-                    if (vfrom == vto) {
-                        vto = fromsize - 1;
-                    }
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else if (!directed && loops && from != to) {
-                maxedges = ((igraph_real_t) fromsize) * tosize;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor(last / fromsize);
-                    vfrom = last - ((igraph_real_t) vto) * fromsize;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else if (!directed && loops && from == to) {
-                maxedges = ((igraph_real_t) fromsize) * (fromsize + 1.0) / 2.0;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor((sqrt(8 * last + 1) - 1) / 2);
-                    vfrom = last - (((igraph_real_t) vto) * (vto + 1.0)) / 2.0;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else if (!directed && !loops && from != to) {
-                maxedges = ((igraph_real_t) fromsize) * tosize;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor(last / fromsize);
-                    vfrom = last - ((igraph_real_t) vto) * fromsize;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
-            } else { /*!directed && !loops && from==to */
-                maxedges = ((igraph_real_t) fromsize) * (fromsize - 1.0) / 2.0;
-                IGRAPH_CHECK_MAXEDGES();
-                while (last < maxedges) {
-                    vto = floor((sqrt(8 * last + 1) + 1) / 2);
-                    vfrom = last - (((igraph_real_t) vto) * (vto - 1.0)) / 2.0;
-                    igraph_vector_int_push_back(&edges, fromoff + vfrom);
-                    igraph_vector_int_push_back(&edges, tooff + vto);
-                    last += RNG_GEOM(prob);
-                    last += 1;
-                }
+            igraph_i_bernoulli_block_t *pair = &pairs[no_of_pairs++];
+
+            if (from != to) {
+                pair->shape = IGRAPH_I_BERNOULLI_RECTANGLE;
+            } else if (directed) {
+                pair->shape = loops ? IGRAPH_I_BERNOULLI_RECTANGLE : IGRAPH_I_BERNOULLI_RECTANGLE_NO_DIAG;
+            } else {
+                pair->shape = loops ? IGRAPH_I_BERNOULLI_TRIANGLE : IGRAPH_I_BERNOULLI_TRIANGLE_NO_DIAG;
             }
+            pair->from_offset = fromoff;
+            pair->from_size = fromsize;
+            pair->to_offset = tooff;
+            pair->to_size = tosize;
+            pair->prob = MATRIX(*pref_matrix, from, to);
 
             tooff += tosize;
         }
         fromoff += fromsize;
     }
 
-    RNG_END();
-
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
+    IGRAPH_CHECK(igraph_i_bernoulli_edges(pairs, no_of_pairs, &edges));
     IGRAPH_CHECK(igraph_create(graph, &edges, n, directed));
 
     igraph_vector_int_destroy(&edges);
-    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FREE(pairs);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
-#undef IGRAPH_CHECK_MAXEDGES
 }
 
 /**
@@ -288,6 +218,7 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
     igraph_integer_t no_blocks = n / m;
     igraph_vector_int_t edges;
     igraph_integer_t offset = 0;
+    igraph_i_rng_buffer_t buffer;
 
     if (n < 1) {
         IGRAPH_ERROR("`n' must be positive for HSBM", IGRAPH_EINVAL);
@@ -333,6 +264,7 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
     IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&buffer, igraph_rng_default());
 
     /* Block models first */
 
@@ -349,7 +281,9 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
                 igraph_integer_t tosize = VECTOR(csizes)[to];
                 igraph_real_t prob = MATRIX(*C, from, to);
                 igraph_real_t maxedges;
-                igraph_real_t last = RNG_GEOM(prob);  /* RNG_GEOM may return NaN so igraph_integer_t is not suitable */
+                igraph_real_t last;  /* may be infinite, so igraph_integer_t is not suitable */
+                igraph_i_rng_buffer_clear(&buffer); /* drop variates for the previous probability */
+                last = igraph_i_rng_buffer_geom(&buffer, prob, ((igraph_real_t) fromsize) * tosize);
                 if (from != to) {
                     maxedges = ((igraph_real_t) fromsize) * tosize;
                     IGRAPH_CHECK_MAXEDGES();
@@ -358,7 +292,7 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
                         igraph_integer_t vfrom = last - ((igraph_real_t) vto) * fromsize;
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + fromoff + vfrom));
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + tooff + vto));
-                        last += RNG_GEOM(prob);
+                        last += igraph_i_rng_buffer_geom(&buffer, prob, maxedges - last);
                         last += 1;
                     }
                 } else { /* from==to */
@@ -369,7 +303,7 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
                         igraph_integer_t vfrom = last - (((igraph_real_t) vto) * (vto - 1.0)) / 2.0;
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + fromoff + vfrom));
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + tooff + vto));
-                        last += RNG_GEOM(prob);
+                        last += igraph_i_rng_buffer_geom(&buffer, prob, maxedges - last);
                         last += 1;
                     }
                 }
@@ -406,13 +340,15 @@ igraph_error_t igraph_hsbm_game(igraph_t *graph, igraph_integer_t n,
             igraph_integer_t tosize = n - tooff;
             igraph_real_t maxedges = ((igraph_real_t) fromsize) * tosize;
             IGRAPH_CHECK_MAXEDGES();
-            igraph_real_t last = RNG_GEOM(p);  /* RNG_GEOM may return NaN so igraph_integer_t is not suitable */
+            igraph_real_t last;  /* may be infinite, so igraph_integer_t is not suitable */
+            igraph_i_rng_buffer_clear(&buffer); /* drop variates for the previous probability */
+            last = igraph_i_rng_buffer_geom(&buffer, p, maxedges);
             while (last < maxedges) {
                 igraph_integer_t vto = floor(last / fromsize);
                 igraph_integer_t vfrom = last - ((igraph_real_t) vto) * fromsize;
                 IGRAPH_CHECK(igraph_vector_int_push_back(&edges, fromoff + vfrom));
                 IGRAPH_CHECK(igraph_vector_int_push_back(&edges, tooff + vto));
-                last += RNG_GEOM(p);
+                last += igraph_i_rng_buffer_geom(&buffer, p, maxedges - last);
                 last += 1;
             }
 
@@ -467,6 +403,7 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
     igraph_vector_int_t edges;
     igraph_vector_t csizes;
     igraph_integer_t b, offset = 0;
+    igraph_i_rng_buffer_t buffer;
 
     if (n < 1) {
         IGRAPH_ERROR("`n' must be positive for HSBM.", IGRAPH_EINVAL);
@@ -539,6 +476,7 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
     IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&buffer, igraph_rng_default());
 
     /* Block models first */
 
@@ -564,7 +502,9 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
                 igraph_integer_t tosize = VECTOR(csizes)[to];
                 igraph_real_t prob = MATRIX(*C, from, to);
                 igraph_real_t maxedges;
-                igraph_real_t last = RNG_GEOM(prob);  /* RNG_GEOM may return NaN so igraph_integer_t is not suitable */
+                igraph_real_t last;  /* may be infinite, so igraph_integer_t is not suitable */
+                igraph_i_rng_buffer_clear(&buffer); /* drop variates for the previous probability */
+                last = igraph_i_rng_buffer_geom(&buffer, prob, ((igraph_real_t) fromsize) * tosize);
                 if (from != to) {
                     maxedges = ((igraph_real_t) fromsize) * tosize;
                     while (last < maxedges) {
@@ -572,7 +512,7 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
                         igraph_integer_t vfrom = last - ((igraph_real_t) vto) * fromsize;
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + fromoff + vfrom));
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + tooff + vto));
-                        last += RNG_GEOM(prob);
+                        last += igraph_i_rng_buffer_geom(&buffer, prob, maxedges - last);
                         last += 1;
                     }
                 } else { /* from==to */
@@ -582,7 +522,7 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
                         igraph_integer_t vfrom = last - (((igraph_real_t) vto) * (vto - 1.0)) / 2.0;
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + fromoff + vfrom));
                         IGRAPH_CHECK(igraph_vector_int_push_back(&edges, offset + tooff + vto));
-                        last += RNG_GEOM(prob);
+                        last += igraph_i_rng_buffer_geom(&buffer, prob, maxedges - last);
                         last += 1;
                     }
                 }
@@ -620,13 +560,15 @@ igraph_error_t igraph_hsbm_list_game(igraph_t *graph, igraph_integer_t n,
             igraph_integer_t fromsize = VECTOR(*mlist)[b];
             igraph_integer_t tosize = n - tooff;
             igraph_real_t maxedges = ((igraph_real_t) fromsize) * tosize;
-            igraph_real_t last = RNG_GEOM(p);  /* RNG_GEOM may return NaN so igraph_integer_t is not suitable */
+            igraph_real_t last;  /* may be infinite, so igraph_integer_t is not suitable */
+            igraph_i_rng_buffer_clear(&buffer); /* drop variates for the previous probability */
+            last = igraph_i_rng_buffer_geom(&buffer, p, maxedges);
             while (last < maxedges) {
                 igraph_integer_t vto = floor(last / fromsize);
                 igraph_integer_t vfrom = last - ((igraph_real_t) vto) * fromsize;
                 IGRAPH_CHECK(igraph_vector_int_push_back(&edges, fromoff + vfrom));
                 IGRAPH_CHECK(igraph_vector_int_push_back(&edges, tooff + vto));
-                last += RNG_GEOM(p);
+                last += igraph_i_rng_buffer_geom(&buffer, p, maxedges - last);
                 last += 1;
             }
 
@@ -32,6 +32,23 @@
 
 #include "core/interruption.h"
 #include "core/math.h" /* M_SQRT2 */
+#include "random/random_internal.h"
+
+/* Same as RNG_UNIF(0, max), but uses buffered uniform numbers. Every
+ * remaining edge needs at least two of them, which is how 'needed' is
+ * computed by the caller, so the graph is the same as without buffering. */
+static igraph_real_t igraph_i_static_fitness_unif(igraph_i_rng_buffer_t *buffer,
+                                                  igraph_real_t max,
+                                                  igraph_integer_t needed) {
+    igraph_real_t r;
+    if (max == 0) {
+        return 0;
+    }
+    do {
+        r = igraph_i_rng_buffer_unif01(buffer, needed) * max;
+    } while (IGRAPH_UNLIKELY(r == max));
+    return r;
+}
 
 /**
  * \ingroup generators
@@ -102,6 +119,7 @@ igraph_error_t igraph_static_fitness_game(igraph_t *graph, igraph_integer_t no_o
     igraph_vector_t cum_fitness_in, cum_fitness_out;
     igraph_vector_t *p_cum_fitness_in, *p_cum_fitness_out;
     igraph_real_t x, max_in, max_out;
+    igraph_i_rng_buffer_t buffer;
     igraph_real_t max_no_of_edges;
     igraph_bool_t is_directed = (fitness_in != 0);
     igraph_real_t num_steps;
@@ -180,6 +198,7 @@ igraph_error_t igraph_static_fitness_game(igraph_t *graph, igraph_integer_t no_o
     }
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&buffer, igraph_rng_default());
     num_steps = no_of_edges;
     if (multiple) {
         /* Generating when multiple edges are allowed */
@@ -194,9 +213,9 @@ igraph_error_t igraph_static_fitness_game(igraph_t *graph, igraph_integer_t no_o
                 IGRAPH_ALLOW_INTERRUPTION();
             }
 
-            x = RNG_UNIF(0, max_out);
+            x = igraph_i_static_fitness_unif(&buffer, max_out, 2 * no_of_edges);
             igraph_vector_binsearch(p_cum_fitness_out, x, &from);
-            x = RNG_UNIF(0, max_in);
+            x = igraph_i_static_fitness_unif(&buffer, max_in, 2 * no_of_edges - 1);
             igraph_vector_binsearch(p_cum_fitness_in, x, &to);
 
             /* Skip if loop edge and loops = false */
@@ -230,9 +249,9 @@ igraph_error_t igraph_static_fitness_game(igraph_t *graph, igraph_integer_t no_o
                 IGRAPH_ALLOW_INTERRUPTION();
             }
 
-            x = RNG_UNIF(0, max_out);
+            x = igraph_i_static_fitness_unif(&buffer, max_out, 2 * no_of_edges);
             igraph_vector_binsearch(p_cum_fitness_out, x, &from);
-            x = RNG_UNIF(0, max_in);
+            x = igraph_i_static_fitness_unif(&buffer, max_in, 2 * no_of_edges - 1);
             igraph_vector_binsearch(p_cum_fitness_in, x, &to);
 
             /* Skip if loop edge and loops = false */
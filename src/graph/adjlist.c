@@ -871,6 +871,249 @@ igraph_integer_t igraph_inclist_size(const igraph_inclist_t *il) {
     return il->length;
 }
 
+static igraph_error_t igraph_i_csr_adjlist_init(
+    const igraph_t *graph, igraph_csr_adjlist_t *al, igraph_neimode_t mode,
+    igraph_loops_t loops, igraph_multiple_t multiple, igraph_bool_t with_eids
+) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_integer_t capacity, ptr = 0;
+    igraph_vector_int_t tmp;
+    igraph_bool_t has_loops = false;
+    igraph_bool_t has_multiple = false;
+
+    if (mode != IGRAPH_IN && mode != IGRAPH_OUT && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Cannot create compact adjacency list view.", IGRAPH_EINVMODE);
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    /* Upper bound for the number of stored entries; each edge appears at most
+     * twice, and only once when we consider one direction only. */
+    capacity = (mode == IGRAPH_ALL) ? 2 * no_of_edges : no_of_edges;
+
+    if (!with_eids) {
+        /* if we already know there are no multi-edges, they don't need to be removed */
+        if (igraph_i_property_cache_has(graph, IGRAPH_PROP_HAS_MULTI) &&
+            !igraph_i_property_cache_get_bool(graph, IGRAPH_PROP_HAS_MULTI)) {
+            multiple = IGRAPH_MULTIPLE;
+        }
+
+        /* if we already know there are no loops, they don't need to be removed */
+        if (igraph_i_property_cache_has(graph, IGRAPH_PROP_HAS_LOOP) &&
+            !igraph_i_property_cache_get_bool(graph, IGRAPH_PROP_HAS_LOOP)) {
+            loops = (mode == IGRAPH_ALL) ? IGRAPH_LOOPS_TWICE : IGRAPH_LOOPS_ONCE;
+        }
+    }
+
+    al->length = no_of_nodes;
+    al->has_eids = with_eids;
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&al->offsets, no_of_nodes + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&al->neis, capacity);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&al->eids, with_eids ? capacity : 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&tmp, 0);
+
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t n;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        VECTOR(al->offsets)[i] = ptr;
+
+        if (with_eids) {
+            IGRAPH_CHECK(igraph_incident(graph, &tmp, i, mode));
+            if (loops != IGRAPH_LOOPS_TWICE) {
+                IGRAPH_CHECK(igraph_i_remove_loops_from_incidence_vector_in_place(&tmp, graph, loops));
+            }
+            n = igraph_vector_int_size(&tmp);
+            for (igraph_integer_t j = 0; j < n; j++) {
+                igraph_integer_t eid = VECTOR(tmp)[j];
+                VECTOR(al->eids)[ptr + j] = eid;
+                VECTOR(al->neis)[ptr + j] = IGRAPH_OTHER(graph, eid, i);
+            }
+        } else {
+            IGRAPH_CHECK(igraph_neighbors(graph, &tmp, i, mode));
+            /* Attention: This function will only set values for has_loops and has_multiple
+             * if it finds loops/multi-edges. Otherwise they are left at their original value. */
+            IGRAPH_CHECK(igraph_i_simplify_sorted_int_adjacency_vector_in_place(
+                &tmp, i, mode, loops, multiple, &has_loops, &has_multiple
+            ));
+            n = igraph_vector_int_size(&tmp);
+            memcpy(VECTOR(al->neis) + ptr, VECTOR(tmp), n * sizeof(igraph_integer_t));
+        }
+
+        ptr += n;
+    }
+    VECTOR(al->offsets)[no_of_nodes] = ptr;
+
+    /* Always succeeds since we never grow the vectors */
+    igraph_vector_int_resize(&al->neis, ptr);
+    if (with_eids) {
+        igraph_vector_int_resize(&al->eids, ptr);
+    }
+
+    if (!with_eids) {
+        /* See igraph_adjlist_init() for the reasoning behind these updates */
+        if (has_loops) {
+            igraph_i_property_cache_set_bool(graph, IGRAPH_PROP_HAS_LOOP, true);
+        } else if (loops == IGRAPH_NO_LOOPS) {
+            igraph_i_property_cache_set_bool(graph, IGRAPH_PROP_HAS_LOOP, false);
+        }
+        if (has_multiple) {
+            igraph_i_property_cache_set_bool(graph, IGRAPH_PROP_HAS_MULTI, true);
+        } else if (multiple == IGRAPH_NO_MULTIPLE) {
+            igraph_i_property_cache_set_bool(graph, IGRAPH_PROP_HAS_MULTI, false);
+        }
+    }
+
+    igraph_vector_int_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(4); /* + offsets, neis, eids */
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_csr_adjlist_init
+ * \brief Constructs a compact adjacency list of vertices from a given graph.
+ *
+ * A compact adjacency list stores the neighbors of all vertices in a single
+ * array, together with an offset array that tells where the neighbors of
+ * each vertex start (this layout is also known as compressed sparse row,
+ * or CSR, format). Compared to \ref igraph_adjlist_init(), it needs only a
+ * constant number of memory allocations irrespective of the size of the
+ * graph, and iterating over the neighbors of consecutive vertices accesses
+ * memory sequentially. The price is that the neighbor lists cannot be
+ * modified after construction.
+ *
+ * </para><para>
+ * The neighbor lists are returned in sorted order, and the \p mode,
+ * \p loops and \p multiple arguments have the same meaning as in
+ * \ref igraph_adjlist_init(). Use \ref igraph_csr_adjlist_get() and
+ * \ref igraph_csr_adjlist_degree() to access the neighbors of a vertex.
+ *
+ * \param graph The input graph.
+ * \param al Pointer to an uninitialized <type>igraph_csr_adjlist_t</type> object.
+ * \param mode Constant specifying whether to include only outgoing
+ *   (\c IGRAPH_OUT), only incoming (\c IGRAPH_IN),
+ *   or both (\c IGRAPH_ALL) types of neighbors
+ *   in the adjacency list. It is ignored for undirected graphs.
+ * \param loops Specifies how to treat loop edges, see
+ *   \ref igraph_adjlist_init() for details.
+ * \param multiple Specifies how to treat multiple (parallel) edges, see
+ *   \ref igraph_adjlist_init() for details.
+ * \return Error code.
+ *
+ * \sa \ref igraph_csr_adjlist_init_incident() to also store the IDs of the
+ * incident edges.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+igraph_error_t igraph_csr_adjlist_init(const igraph_t *graph,
+                                       igraph_csr_adjlist_t *al,
+                                       igraph_neimode_t mode,
+                                       igraph_loops_t loops,
+                                       igraph_multiple_t multiple) {
+    return igraph_i_csr_adjlist_init(graph, al, mode, loops, multiple, /* with_eids = */ false);
+}
+
+/**
+ * \function igraph_csr_adjlist_init_incident
+ * \brief Constructs a compact adjacency list that also stores incident edges.
+ *
+ * This function is similar to \ref igraph_csr_adjlist_init(), but it also
+ * records the ID of the edge leading to each neighbor in an array that is
+ * parallel to the neighbor array. The incident edge IDs can be retrieved
+ * with \ref igraph_csr_adjlist_get_eids(). Since every edge is recorded
+ * separately, multiple edges are always kept. The ordering of the entries
+ * and the treatment of loop edges is the same as in
+ * \ref igraph_inclist_init().
+ *
+ * \param graph The input graph.
+ * \param al Pointer to an uninitialized <type>igraph_csr_adjlist_t</type> object.
+ * \param mode Constant specifying whether incoming edges
+ *   (<code>IGRAPH_IN</code>), outgoing edges (<code>IGRAPH_OUT</code>) or
+ *   both (<code>IGRAPH_ALL</code>) to include in the adjacency list
+ *   of directed graphs. It is ignored for undirected graphs.
+ * \param loops Specifies how to treat loop edges, see
+ *   \ref igraph_inclist_init() for details.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+igraph_error_t igraph_csr_adjlist_init_incident(const igraph_t *graph,
+                                                igraph_csr_adjlist_t *al,
+                                                igraph_neimode_t mode,
+                                                igraph_loops_t loops) {
+    return igraph_i_csr_adjlist_init(graph, al, mode, loops, IGRAPH_MULTIPLE, /* with_eids = */ true);
+}
+
+/**
+ * \function igraph_csr_adjlist_destroy
+ * \brief Deallocates a compact adjacency list.
+ *
+ * \param al The compact adjacency list to destroy.
+ *
+ * Time complexity: O(1), apart from memory management.
+ */
+void igraph_csr_adjlist_destroy(igraph_csr_adjlist_t *al) {
+    igraph_vector_int_destroy(&al->eids);
+    igraph_vector_int_destroy(&al->neis);
+    igraph_vector_int_destroy(&al->offsets);
+}
+
+/**
+ * \function igraph_csr_adjlist_size
+ * \brief Returns the number of vertices in a compact adjacency list.
+ *
+ * \param al The compact adjacency list.
+ * \return The number of vertices in the adjacency list.
+ *
+ * Time complexity: O(1).
+ */
+igraph_integer_t igraph_csr_adjlist_size(const igraph_csr_adjlist_t *al) {
+    return al->length;
+}
+
+/**
+ * \function igraph_csr_adjlist_has_eids
+ * \brief Does a compact adjacency list store incident edge IDs?
+ *
+ * \param al The compact adjacency list.
+ * \return True if the adjacency list was created with
+ *   \ref igraph_csr_adjlist_init_incident(), false otherwise.
+ *
+ * Time complexity: O(1).
+ */
+igraph_bool_t igraph_csr_adjlist_has_eids(const igraph_csr_adjlist_t *al) {
+    return al->has_eids;
+}
+
+#ifndef USING_R
+igraph_error_t igraph_csr_adjlist_print(const igraph_csr_adjlist_t *al) {
+    return igraph_csr_adjlist_fprint(al, stdout);
+}
+#endif
+
+igraph_error_t igraph_csr_adjlist_fprint(const igraph_csr_adjlist_t *al, FILE *outfile) {
+    igraph_integer_t n = al->length;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        igraph_integer_t deg = igraph_csr_adjlist_degree(al, i);
+        const igraph_integer_t *neis = igraph_csr_adjlist_get(al, i);
+        for (igraph_integer_t j = 0; j < deg; j++) {
+            if (j > 0) {
+                fputc(' ', outfile);
+            }
+            fprintf(outfile, "%" IGRAPH_PRId, neis[j]);
+        }
+        fputc('\n', outfile);
+    }
+    return IGRAPH_SUCCESS;
+}
+
 /* See the prototype above for a description of this function. */
 static igraph_error_t igraph_i_simplify_sorted_int_adjacency_vector_in_place(
     igraph_vector_int_t *v, igraph_integer_t index, igraph_neimode_t mode,
@@ -275,6 +275,8 @@ public:
     bool importDendrogramStructure(const igraph_hrg_t *hrg);
     // (consensus tree) delete splits with less than 0.5 weight
     void cullSplitHist();
+    // (consensus tree) add the split histogram of another dendrogram
+    void mergeSplitHist(const dendro*);
     // return size of consensus split
     int getConsensusSize();
     // return split tree with consensus splits
@@ -31,9 +31,14 @@
 #include "igraph_random.h"
 #include "igraph_structural.h"
 
+#include "core/default_rng_guard.h"
 #include "core/exceptions.h"
+#include "core/parallel.h"
+#include "random/random_internal.h"
 
 #include <climits>
+#include <new>
+#include <vector>
 
 using namespace fitHRG;
 
@@ -84,7 +89,7 @@ struct pblock {
 }
 
 static igraph_error_t markovChainMonteCarlo(dendro *d, igraph_integer_t period,
-                          igraph_hrg_t *hrg) {
+                          igraph_hrg_t *hrg, igraph_real_t *logL) {
 
     igraph_real_t bestL = d->getLikelihood();
     double  dL;
@@ -121,6 +126,10 @@ static igraph_error_t markovChainMonteCarlo(dendro *d, igraph_integer_t period,
     // corrects floating-point errors O(n)
     d->refreshLikelihood();
 
+    if (logL) {
+        *logL = bestL;
+    }
+
     return IGRAPH_SUCCESS;
 }
 
@@ -269,6 +278,151 @@ static igraph_error_t igraph_i_hrg_getsimplegraph(const igraph_t *igraph,
     return IGRAPH_SUCCESS;
 }
 
+// The sampling in igraph_hrg_consensus() and igraph_hrg_predict() is
+// divided between this many chains, started from the same dendrogram.
+// The number does not depend on the number of threads, so that the
+// results only depend on the seed.
+#define HRG_SAMPLE_CHAINS 8
+
+// The number of independent chains between which igraph_hrg_fit() divides
+// a fixed number of steps. Like HRG_SAMPLE_CHAINS, it is fixed, so that the
+// fitted dendrogram only depends on the seed. Each chain holds its own
+// dendrogram.
+#define HRG_FIT_CHAINS 4
+
+namespace {
+
+// Independent Markov chains. Each one has its own dendrogram, but they
+// share the graph (and, for link prediction, its adjacency histograms).
+class hrg_chains {
+    std::vector<dendro*> chains;
+
+    hrg_chains(const hrg_chains&);
+    hrg_chains& operator=(const hrg_chains&);
+
+public:
+    hrg_chains(graph *g, igraph_integer_t no_of_chains) {
+        chains.reserve(no_of_chains);
+        try {
+            for (igraph_integer_t i = 0; i < no_of_chains; i++) {
+                chains.push_back(new dendro);
+                chains.back()->g = g;
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+    ~hrg_chains() {
+        release();
+    }
+    void release() {
+        for (size_t i = 0; i < chains.size(); i++) {
+            chains[i]->g = NULL; // not owned by the chain
+            delete chains[i];
+        }
+        chains.clear();
+    }
+    dendro *operator[](igraph_integer_t i) {
+        return chains[i];
+    }
+};
+
+} // namespace
+
+// Runs one chain of hrg_run_chains() with 'rng' as the default RNG, see
+// igraph_i_parallel_run_tasks().
+template <class Task>
+static igraph_error_t hrg_run_chain(void *data, void *workspace,
+                                    igraph_rng_t *rng, igraph_integer_t chain) {
+    Task &task = *static_cast<Task *>(data);
+
+    IGRAPH_UNUSED(workspace);
+
+    try {
+        DefaultRNGGuard guard(rng);
+        return task(chain);
+    } catch (const std::bad_alloc &) {
+        return IGRAPH_ENOMEM;
+    } catch (...) {
+        return IGRAPH_FAILURE;
+    }
+}
+
+// Runs task(chain) for each chain, in parallel if possible. Each chain uses
+// its own random stream as the default RNG. The task must not check for
+// interruption.
+template <class Task>
+static igraph_error_t hrg_run_chains(Task task, igraph_integer_t no_of_chains) {
+    igraph_i_parallel_tasks_t tasks = { };
+
+    tasks.no_of_tasks = no_of_chains;
+    tasks.seed = igraph_i_rng_stream_seed();
+    tasks.data = &task;
+    tasks.run = hrg_run_chain<Task>;
+    tasks.error_message = "Cannot run HRG Markov chains.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
+
+    return IGRAPH_SUCCESS;
+}
+
+// The number of samples (or steps) taken by a chain, when 'num_samples' are
+// divided between 'no_of_chains' chains.
+static igraph_integer_t hrg_chain_samples(igraph_integer_t num_samples,
+                                          igraph_integer_t no_of_chains,
+                                          igraph_integer_t chain) {
+    return num_samples / no_of_chains + (chain < num_samples % no_of_chains ? 1 : 0);
+}
+
+static igraph_error_t hrg_copy(igraph_hrg_t *to, const igraph_hrg_t *from) {
+    IGRAPH_CHECK(igraph_vector_int_update(&to->left, &from->left));
+    IGRAPH_CHECK(igraph_vector_int_update(&to->right, &from->right));
+    IGRAPH_CHECK(igraph_vector_update(&to->prob, &from->prob));
+    IGRAPH_CHECK(igraph_vector_int_update(&to->edges, &from->edges));
+    IGRAPH_CHECK(igraph_vector_int_update(&to->vertices, &from->vertices));
+    return IGRAPH_SUCCESS;
+}
+
+namespace {
+
+// The HRGs recorded by the chains of igraph_hrg_fit().
+class hrg_list {
+    std::vector<igraph_hrg_t> hrgs;
+    size_t no_of_initialized;
+
+    hrg_list(const hrg_list&);
+    hrg_list& operator=(const hrg_list&);
+
+public:
+    hrg_list() : no_of_initialized(0) { }
+    ~hrg_list() {
+        for (size_t i = 0; i < no_of_initialized; i++) {
+            igraph_hrg_destroy(&hrgs[i]);
+        }
+    }
+    igraph_error_t init(igraph_integer_t size, igraph_integer_t n) {
+        hrgs.resize(size);
+        while (no_of_initialized < hrgs.size()) {
+            IGRAPH_CHECK(igraph_hrg_init(&hrgs[no_of_initialized], n));
+            no_of_initialized++;
+        }
+        return IGRAPH_SUCCESS;
+    }
+    igraph_hrg_t *operator[](igraph_integer_t i) {
+        return &hrgs[i];
+    }
+};
+
+} // namespace
+
+// Divides the sampling of 'num_samples' dendrograms between independent
+// chains that start from the current dendrogram of 'd'. When 'consensus'
+// is true, the split histograms of the chains are merged into that of
+// 'd', otherwise the samples are added to the adjacency histograms of
+// the graph, which the chains share with 'd'.
+static igraph_error_t hrg_sample_chains(dendro *d, igraph_integer_t num_samples,
+                                        bool consensus);
+
 /**
  * \function igraph_hrg_init
  * \brief Allocate memory for a HRG.
@@ -380,6 +534,53 @@ igraph_error_t igraph_hrg_resize(igraph_hrg_t *hrg, igraph_integer_t newsize) {
     return IGRAPH_SUCCESS;
 }
 
+// Runs the fitting in independent chains, and keeps the most likely
+// dendrogram found by any of them. A fixed number of steps is divided
+// between HRG_FIT_CHAINS chains, so the total work is the same as with a
+// single chain. Fitting until convergence (steps == 0) uses a single chain,
+// as there is no budget to divide.
+static igraph_error_t hrg_fit_chains(dendro *d, igraph_hrg_t *hrg, bool start,
+                                     igraph_integer_t steps) {
+    igraph_integer_t no_of_chains =
+        steps == 0 ? 1 : (steps < HRG_FIT_CHAINS ? steps : HRG_FIT_CHAINS);
+    hrg_chains chains(d->g, no_of_chains);
+    hrg_list hrgs;
+    std::vector<igraph_real_t> logL(no_of_chains);
+    igraph_integer_t best = 0;
+
+    IGRAPH_CHECK(hrgs.init(no_of_chains, d->g->numNodes()));
+
+    auto task = [&](igraph_integer_t chain) -> igraph_error_t {
+        dendro *dc = chains[chain];
+        if (start) {
+            dc->importDendrogramStructure(hrg);
+        } else {
+            dc->buildDendrogram();
+        }
+        if (steps > 0) {
+            dc->recordDendrogramStructure(hrgs[chain]);
+            IGRAPH_CHECK(markovChainMonteCarlo(dc, hrg_chain_samples(steps, no_of_chains, chain),
+                                               hrgs[chain], &logL[chain]));
+        } else {
+            IGRAPH_CHECK(MCMCEquilibrium_Find(dc, hrgs[chain]));
+            logL[chain] = dc->getLikelihood();
+        }
+        return IGRAPH_SUCCESS;
+    };
+    IGRAPH_CHECK(hrg_run_chains(task, no_of_chains));
+
+    // Ties are broken by the chain index, so that the result does not
+    // depend on the order in which the chains finish.
+    for (igraph_integer_t chain = 1; chain < no_of_chains; chain++) {
+        if (logL[chain] > logL[best]) {
+            best = chain;
+        }
+    }
+    IGRAPH_CHECK(hrg_copy(hrg, hrgs[best]));
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_hrg_fit
  * \brief Fit a hierarchical random graph model to a network.
@@ -397,6 +598,19 @@ igraph_error_t igraph_hrg_resize(igraph_hrg_t *hrg, igraph_integer_t newsize) {
  *   convergence criteria is fulfilled.
  * \return Error code.
  *
+ * </para><para>
+ * When \p steps is positive, the steps are divided between four
+ * independent Markov chains, and the most likely dendrogram found by any
+ * of them is returned. The total number of steps is the same as with a
+ * single chain, but when igraph is built with OpenMP support, the chains
+ * run in parallel. Shorter chains explore less of the space of
+ * dendrograms each, but they start from different dendrograms, unless
+ * \p start is true. The four chains hold a dendrogram each, which takes
+ * four times as much memory. When \p steps is zero, a single chain is
+ * run until convergence. Each chain uses its own random stream derived
+ * from igraph's default random number generator, so the result depends
+ * only on the seed, not on the number of threads.
+ *
  * Time complexity: TODO.
  */
 
@@ -431,11 +645,7 @@ igraph_error_t igraph_hrg_fit(const igraph_t *graph,
     }
 
     // Run fixed number of steps, or until convergence
-    if (steps > 0) {
-        IGRAPH_CHECK(markovChainMonteCarlo(d, steps, hrg));
-    } else {
-        IGRAPH_CHECK(MCMCEquilibrium_Find(d, hrg));
-    }
+    IGRAPH_CHECK(hrg_fit_chains(d, hrg, start, steps));
 
     delete d;
 
@@ -646,6 +856,13 @@ igraph_error_t igraph_hrg_dendrogram(
  *   the consensus tree.
  * \return Error code.
  *
+ * </para><para>
+ * Once the chain has reached equilibrium, the sampling is divided between
+ * up to eight independent chains started from the same dendrogram, which
+ * run in parallel when igraph is built with OpenMP support. Each chain
+ * uses its own random stream derived from igraph's default random number
+ * generator, so the result does not depend on the number of threads.
+ *
  * Time complexity: TODO.
  */
 
@@ -679,7 +896,7 @@ igraph_error_t igraph_hrg_consensus(const igraph_t *graph,
         IGRAPH_CHECK(MCMCEquilibrium_Find(d, hrg));
     }
 
-    IGRAPH_CHECK(markovChainMonteCarlo2(d, num_samples));
+    IGRAPH_CHECK(hrg_sample_chains(d, num_samples, /* consensus= */ true));
 
     d->recordConsensusTree(parents, weights);
 
@@ -724,6 +941,52 @@ static igraph_error_t MCMCEquilibrium_Sample(dendro *d, igraph_integer_t num_sam
     return IGRAPH_SUCCESS;
 }
 
+static igraph_error_t hrg_sample_chains(dendro *d, igraph_integer_t num_samples,
+                                        bool consensus) {
+    igraph_integer_t no_of_chains =
+        num_samples < HRG_SAMPLE_CHAINS ? num_samples : HRG_SAMPLE_CHAINS;
+    igraph_hrg_t state;
+
+    if (no_of_chains <= 1) {
+        if (consensus) {
+            IGRAPH_CHECK(markovChainMonteCarlo2(d, num_samples));
+        } else {
+            IGRAPH_CHECK(MCMCEquilibrium_Sample(d, num_samples));
+        }
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_CHECK(igraph_hrg_init(&state, d->g->numNodes()));
+    IGRAPH_FINALLY(igraph_hrg_destroy, &state);
+    d->recordDendrogramStructure(&state);
+
+    hrg_chains chains(d->g, no_of_chains);
+
+    auto task = [&](igraph_integer_t chain) -> igraph_error_t {
+        dendro *dc = chains[chain];
+        igraph_integer_t samples = hrg_chain_samples(num_samples, no_of_chains, chain);
+        dc->importDendrogramStructure(&state);
+        if (consensus) {
+            IGRAPH_CHECK(markovChainMonteCarlo2(dc, samples));
+        } else {
+            IGRAPH_CHECK(MCMCEquilibrium_Sample(dc, samples));
+        }
+        return IGRAPH_SUCCESS;
+    };
+    IGRAPH_CHECK(hrg_run_chains(task, no_of_chains));
+
+    if (consensus) {
+        for (igraph_integer_t chain = 0; chain < no_of_chains; chain++) {
+            d->mergeSplitHist(chains[chain]);
+        }
+    }
+
+    igraph_hrg_destroy(&state);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
 static int QsortPartition (pblock* array, igraph_integer_t left, igraph_integer_t right, igraph_integer_t index) {
     pblock p_value, temp;
     p_value.L = array[index].L;
@@ -839,6 +1102,11 @@ static igraph_error_t recordPredictions(pblock *br_list, igraph_vector_int_t *ed
  *   probabilities. Higher numbers result higher resolution.
  * \return Error code.
  *
+ * </para><para>
+ * As in \ref igraph_hrg_consensus(), the sampling is divided between
+ * independent chains that may run in parallel; the result does not
+ * depend on the number of threads.
+ *
  * Time complexity: TODO.
  */
 
@@ -884,7 +1152,7 @@ igraph_error_t igraph_hrg_predict(const igraph_t *graph,
         IGRAPH_CHECK(MCMCEquilibrium_Find(d, hrg));
     }
 
-    IGRAPH_CHECK(MCMCEquilibrium_Sample(d, num_samples));
+    IGRAPH_CHECK(hrg_sample_chains(d, num_samples, /* consensus= */ false));
     IGRAPH_CHECK(rankCandidatesByProbability(sg, d, br_list, mk));
     IGRAPH_CHECK(recordPredictions(br_list, edges, prob, mk));
 
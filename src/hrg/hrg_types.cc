@@ -41,6 +41,8 @@
 #include "igraph_constructors.h"
 #include "igraph_random.h"
 
+#include "core/parallel.h"
+
 #include <stdexcept>
 #include <climits>
 
@@ -50,8 +52,8 @@ using namespace fitHRG;
 // ******** Red-Black Tree Methods ***************************************
 
 rbtree::rbtree() {
-    root = new elementrb;
-    leaf = new elementrb;
+    root = nodes.allocate();
+    leaf = nodes.allocate();
 
     leaf->parent = root;
 
@@ -61,14 +63,7 @@ rbtree::rbtree() {
 }
 
 rbtree::~rbtree() {
-    if (root != NULL &&
-        (root->left != leaf || root->right != leaf)) {
-        deleteSubTree(root);
-    }
-    if (root) {
-        delete root;
-    }
-    delete leaf;
+    // the nodes are freed by the pool
     support = 0;
     root = 0;
     leaf = 0;
@@ -87,7 +82,7 @@ void rbtree::deleteSubTree(elementrb *z) {
     if (z->right != leaf) {
         deleteSubTree(z->right);
     }
-    delete z;
+    nodes.release(z);
 }
 
 // ******** Search Functions *********************************************
@@ -340,7 +335,7 @@ void rbtree::insertItem(int newKey, int newValue) {
     // find newKey in tree; return pointer to it O(log k)
     current = findItem(newKey);
     if (current == NULL) {
-        newNode = new elementrb;    // elementrb for the rbtree
+        newNode = nodes.allocate(); // elementrb for the rbtree
         newNode->key = newKey;
         newNode->value = newValue;
         newNode->color = true;  // new nodes are always RED
@@ -354,7 +349,7 @@ void rbtree::insertItem(int newKey, int newValue) {
         // other properly
         current = root;
         if (current->key == -1) {    // insert as root
-            delete root;           // delete old root
+            nodes.release(root);   // delete old root
             root = newNode;            // set root to newNode
             leaf->parent = newNode;        // set leaf's parent
             current = leaf;            // skip next loop
@@ -526,7 +521,7 @@ void rbtree::deleteItem(int killKey) {
             deleteCleanup(x);
         }
 
-        delete y;
+        nodes.release(y);
         y = NULL;
     }
 
@@ -1345,6 +1340,18 @@ void dendro::cullSplitHist() {
     return;
 }
 
+// ***********************************************************************
+
+void dendro::mergeSplitHist(const dendro* other) {
+    if (other->splithist == NULL) {
+        return;
+    }
+    if (splithist == NULL) {
+        splithist = new splittree;
+    }
+    splithist->addTree(other->splithist);
+}
+
 // **********************************************************************
 
 elementd* dendro::findCommonAncestor(list** paths_, const int i, const int j) {
@@ -2466,12 +2473,12 @@ bool graph::addAdjacencyObs(const int i, const int j,
             index = num_bins;
         }
 
-        // Add the weight to the proper probability bin
-        if (A[i][j][index] < 0.5) {
-            A[i][j][index] = 1.0;
-        } else {
-            A[i][j][index] += 1.0;
-        }
+        // Add the weight to the proper probability bin. The histograms
+        // may be shared by several chains that run in parallel; the
+        // counts are integers, so the result does not depend on the
+        // order of the updates.
+        IGRAPH_I_OMP(omp atomic)
+        A[i][j][index] += 1.0;
         return true;
     }
     return false;
@@ -2482,11 +2489,10 @@ bool graph::addAdjacencyObs(const int i, const int j,
 void graph::addAdjacencyEnd() {
     // We need to also keep a running total of how much weight has been added
     // to the histogram, and the number of observations in the histogram.
-    if (obs_count == 0) {
-        total_weight  = 1.0; obs_count = 1;
-    } else {
-        total_weight += 1.0; obs_count++;
-    }
+    IGRAPH_I_OMP(omp atomic)
+    total_weight += 1.0;
+    IGRAPH_I_OMP(omp atomic)
+    obs_count++;
     return;
 }
 
@@ -2824,8 +2830,8 @@ bool interns::swapEdges(const int one_x, const int one_y,
 // ******** Red-Black Tree Methods ***************************************
 
 splittree::splittree() {
-    root = new elementsp;
-    leaf = new elementsp;
+    root = nodes.allocate();
+    leaf = nodes.allocate();
 
     leaf->parent   = root;
 
@@ -2837,16 +2843,10 @@ splittree::splittree() {
 }
 
 splittree::~splittree() {
-    if (root != NULL && (root->left != leaf || root->right != leaf)) {
-        deleteSubTree(root); root = NULL;
-    }
+    // the nodes are freed by the pool
     support      = 0;
     total_weight = 0.0;
     total_count  = 0;
-    if (root) {
-        delete root;
-    }
-    delete leaf;
     root    = NULL;
     leaf    = NULL;
 }
@@ -2868,7 +2868,7 @@ void splittree::deleteSubTree(elementsp *z) {
         deleteSubTree(z->right);
         z->right = NULL;
     }
-    delete z;
+    nodes.release(z);
     /* No point in setting z to NULL here because z is passed by value */
     /* z = NULL; */
     return;
@@ -3194,7 +3194,7 @@ bool splittree::insertItem(string newKey, double newValue) {
         current->count++;
         return true;
     } else {
-        newNode = new elementsp;    // elementsp for the splittree
+        newNode = nodes.allocate(); // elementsp for the splittree
         newNode->split = newKey;    //  store newKey
         newNode->weight = newValue; //  store newValue
         newNode->color = true;  //  new nodes are always RED
@@ -3209,7 +3209,7 @@ bool splittree::insertItem(string newKey, double newValue) {
         // other properly
         current = root;
         if (current->split.empty()) {   // insert as root
-            delete root;      //   delete old root
+            nodes.release(root); //   delete old root
             root = newNode;       //   set root to newNode
             leaf->parent   = newNode; //   set leaf's parent
             current = leaf;       //   skip next loop
@@ -3249,6 +3249,32 @@ bool splittree::insertItem(string newKey, double newValue) {
     return true;
 }
 
+void splittree::addTree(const splittree *other) {
+    if (!other->root->split.empty()) {
+        addSubTree(other, other->root);
+    }
+    total_weight += other->total_weight;
+    total_count  += other->total_count;
+}
+
+void splittree::addSubTree(const splittree *other, const elementsp *z) {
+    elementsp *current = findItem(z->split);
+    if (current == NULL) {
+        insertItem(z->split, z->weight);
+        current = findItem(z->split);
+        current->count = z->count;
+    } else {
+        current->weight += z->weight;
+        current->count  += z->count;
+    }
+    if (z->left  != other->leaf) {
+        addSubTree(other, z->left);
+    }
+    if (z->right != other->leaf) {
+        addSubTree(other, z->right);
+    }
+}
+
 // private house-keeping function for insertion
 void splittree::insertCleanup(elementsp *z) {
 
@@ -3357,7 +3383,7 @@ void splittree::deleteItem(string killKey) {
         if (y->color == false) {
             deleteCleanup(x);
         }
-        delete y;            // deallocate y
+        nodes.release(y);    // deallocate y
         y = NULL;            // point y to NULL for safety
     }              //
 
@@ -0,0 +1,86 @@
+/* -*- mode: C++ -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_HRG_NODE_POOL
+#define IGRAPH_HRG_NODE_POOL
+
+#include <cstddef>
+#include <vector>
+
+namespace fitHRG {
+
+// ******** Node Pool Class **********************************************
+// Allocates the nodes of a tree from contiguous blocks owned by the
+// pool. Released nodes are kept on a free list and handed out again
+// by the next allocation, so the many insertions and deletions done
+// during the MCMC do not go through the global allocator, and the
+// nodes of a tree stay close to each other in memory. All nodes are
+// freed together when the pool is destroyed.
+
+template <class T> class node_pool {
+private:
+    std::vector<T*> blocks;       // blocks of nodes, owned by the pool
+    std::vector<T*> free_nodes;   // nodes available for allocation
+    size_t block_size;        // size of the next block to allocate
+    size_t node_count;        // total number of nodes in all blocks
+
+    node_pool(const node_pool&);
+    node_pool& operator=(const node_pool&);
+
+public:
+    node_pool(): block_size(16), node_count(0) { }
+    ~node_pool() {
+        for (size_t i = 0; i < blocks.size(); i++) {
+            delete [] blocks[i];
+        }
+    }
+
+    // returns a default-initialized node
+    T* allocate() {
+        if (free_nodes.empty()) {
+            T* block = new T[block_size];
+            try {
+                blocks.push_back(block);
+            } catch (...) {
+                delete [] block;
+                throw;
+            }
+            // there is room for all nodes, so release() never reallocates
+            free_nodes.reserve(node_count + block_size);
+            node_count += block_size;
+            for (size_t i = block_size; i > 0; i--) {
+                free_nodes.push_back(&block[i - 1]);
+            }
+            block_size *= 2;
+        }
+        T* node = free_nodes.back();
+        free_nodes.pop_back();
+        *node = T();
+        return node;
+    }
+
+    // returns a node to the pool
+    void release(T* node) {
+        free_nodes.push_back(node);
+    }
+};
+
+} // namespace fitHRG
+
+#endif
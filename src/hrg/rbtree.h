@@ -55,6 +55,8 @@
 #ifndef IGRAPH_HRG_RBTREE
 #define IGRAPH_HRG_RBTREE
 
+#include "hrg/node_pool.h"
+
 namespace fitHRG {
 
 // ******** Basic Structures *********************************************
@@ -113,6 +115,7 @@ private:
     elementrb* root;      // binary tree root
     elementrb* leaf;      // all leaf nodes
     int support;          // number of nodes in the tree
+    node_pool<elementrb> nodes;   // storage for the nodes
 
     void rotateLeft(elementrb *x);    // left-rotation operator
     void rotateRight(elementrb *y);   // right-rotation operator
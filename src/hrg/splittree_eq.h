@@ -62,6 +62,8 @@
 #ifndef IGRAPH_HRG_SPLITTREE
 #define IGRAPH_HRG_SPLITTREE
 
+#include "hrg/node_pool.h"
+
 #include <string>
 
 namespace fitHRG {
@@ -126,6 +128,7 @@ private:
     int support;          // number of nodes in the tree
     double total_weight;      // total weight stored
     int total_count;      // total number of observations stored
+    node_pool<elementsp> nodes;   // storage for the nodes
 
     // left-rotation operator
     void rotateLeft(elementsp*);
@@ -142,6 +145,8 @@ private:
     elementsp* returnMinKey(elementsp*);
     // returns successor of z's key
     elementsp* returnSuccessor(elementsp*);
+    // add the splits in the subtree of another splittree rooted at z
+    void addSubTree(const splittree*, const elementsp*);
 
 public:
     // default constructor/destructor
@@ -155,6 +160,8 @@ public:
     void finishedThisRound();
     // insert a new key with stored value
     bool insertItem(std::string, double);
+    // add the weights and counts of the splits in another splittree
+    void addTree(const splittree*);
     void clearTree();
     // delete a node with given key
     void deleteItem(std::string);
@@ -0,0 +1,331 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "layout/barnes_hut.h"
+
+#include "igraph_memory.h"
+
+#include "core/parallel.h"
+
+#include <math.h>
+
+/* Cells with at most this many vertices are not subdivided. */
+#define IGRAPH_I_BH_LEAF_SIZE 8
+
+/* Cells at this depth are not subdivided either; this only matters when
+ * many vertices are at (almost) the same position. */
+#define IGRAPH_I_BH_MAX_DEPTH 40
+
+/* Room for the children of one cell at each level of a depth-first traversal. */
+#define IGRAPH_I_BH_STACK_SIZE ((IGRAPH_I_BH_MAX_DEPTH + 1) * 8)
+
+igraph_error_t igraph_i_bh_tree_init(igraph_i_bh_tree_t *tree,
+                                     igraph_integer_t no_of_nodes, igraph_integer_t dim) {
+    IGRAPH_ASSERT(dim == 2 || dim == 3);
+
+    tree->dim = dim;
+    tree->no_of_nodes = no_of_nodes;
+    tree->no_of_cells = 0;
+    tree->cells_size = no_of_nodes / IGRAPH_I_BH_LEAF_SIZE + 1;
+    tree->cells = IGRAPH_CALLOC(tree->cells_size, igraph_i_bh_cell_t);
+    IGRAPH_CHECK_OOM(tree->cells, "Cannot build Barnes-Hut tree.");
+    IGRAPH_FINALLY(igraph_free, tree->cells);
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&tree->order, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&tree->rank, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&tree->coords, no_of_nodes * dim);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&tree->tmp_order, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&tree->tmp_coords, no_of_nodes * dim);
+
+    IGRAPH_FINALLY_CLEAN(6);
+    return IGRAPH_SUCCESS;
+}
+
+void igraph_i_bh_tree_destroy(igraph_i_bh_tree_t *tree) {
+    IGRAPH_FREE(tree->cells);
+    igraph_vector_int_destroy(&tree->order);
+    igraph_vector_int_destroy(&tree->rank);
+    igraph_vector_destroy(&tree->coords);
+    igraph_vector_int_destroy(&tree->tmp_order);
+    igraph_vector_destroy(&tree->tmp_coords);
+}
+
+/* Appends 'count' cells to the tree, and returns the index of the first one. */
+static igraph_error_t igraph_i_bh_add_cells(igraph_i_bh_tree_t *tree, igraph_integer_t count,
+                                            igraph_integer_t *first) {
+    if (tree->no_of_cells + count > tree->cells_size) {
+        igraph_integer_t new_size = 2 * tree->cells_size + count;
+        igraph_i_bh_cell_t *tmp = IGRAPH_REALLOC(tree->cells, new_size, igraph_i_bh_cell_t);
+        IGRAPH_CHECK_OOM(tmp, "Cannot build Barnes-Hut tree.");
+        tree->cells = tmp;
+        tree->cells_size = new_size;
+    }
+    *first = tree->no_of_cells;
+    tree->no_of_cells += count;
+    return IGRAPH_SUCCESS;
+}
+
+/* Computes the sum of the coordinates of a cell, and subdivides it
+ * recursively, reordering its vertices by child. */
+static igraph_error_t igraph_i_bh_split(igraph_i_bh_tree_t *tree, igraph_integer_t cell,
+                                        igraph_integer_t depth) {
+    const igraph_integer_t dim = tree->dim;
+    const igraph_integer_t first = tree->cells[cell].first, last = tree->cells[cell].last;
+    igraph_real_t *coords = VECTOR(tree->coords);
+    igraph_real_t center[3], half;
+    igraph_integer_t count[8] = { 0 }, pos[8];
+    igraph_integer_t i, k, o, child, no_children = 0;
+
+    for (k = 0; k < dim; k++) {
+        igraph_real_t sum = 0;
+        for (i = first; i < last; i++) {
+            sum += coords[i * dim + k];
+        }
+        tree->cells[cell].sum[k] = sum;
+        center[k] = tree->cells[cell].center[k];
+    }
+    half = tree->cells[cell].half;
+
+    if (last - first <= IGRAPH_I_BH_LEAF_SIZE || depth >= IGRAPH_I_BH_MAX_DEPTH) {
+        tree->cells[cell].no_children = 0;
+        return IGRAPH_SUCCESS;
+    }
+
+    /* Counting sort of the vertices by the child cell they fall into. */
+    for (i = first; i < last; i++) {
+        for (o = 0, k = 0; k < dim; k++) {
+            o |= (coords[i * dim + k] >= center[k]) << k;
+        }
+        count[o]++;
+    }
+    for (o = 0, k = first; o < (1 << dim); o++) {
+        pos[o] = k;
+        k += count[o];
+        if (count[o] > 0) {
+            no_children++;
+        }
+    }
+    for (i = first; i < last; i++) {
+        igraph_integer_t j;
+        for (o = 0, k = 0; k < dim; k++) {
+            o |= (coords[i * dim + k] >= center[k]) << k;
+        }
+        j = pos[o]++;
+        VECTOR(tree->tmp_order)[j] = VECTOR(tree->order)[i];
+        for (k = 0; k < dim; k++) {
+            VECTOR(tree->tmp_coords)[j * dim + k] = coords[i * dim + k];
+        }
+    }
+    for (i = first; i < last; i++) {
+        VECTOR(tree->order)[i] = VECTOR(tree->tmp_order)[i];
+        for (k = 0; k < dim; k++) {
+            coords[i * dim + k] = VECTOR(tree->tmp_coords)[i * dim + k];
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_bh_add_cells(tree, no_children, &child));
+    tree->cells[cell].child = child;
+    tree->cells[cell].no_children = no_children;
+
+    for (o = 0, i = child; o < (1 << dim); o++) {
+        igraph_i_bh_cell_t *c;
+        if (count[o] == 0) {
+            continue;
+        }
+        c = &tree->cells[i++];
+        for (k = 0; k < dim; k++) {
+            c->center[k] = center[k] + ((o >> k) & 1 ? half / 2 : -half / 2);
+        }
+        c->half = half / 2;
+        c->last = pos[o];
+        c->first = pos[o] - count[o];
+    }
+    for (i = child; i < child + no_children; i++) {
+        IGRAPH_CHECK(igraph_i_bh_split(tree, i, depth + 1));
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Rebuilds the tree for the given positions; 'pos' has one row per vertex
+ * and (at least) 'dim' columns. */
+igraph_error_t igraph_i_bh_tree_build(igraph_i_bh_tree_t *tree, const igraph_matrix_t *pos) {
+    const igraph_integer_t dim = tree->dim, no_of_nodes = tree->no_of_nodes;
+    igraph_i_bh_cell_t *root;
+    igraph_integer_t i, k, cell;
+
+    tree->no_of_cells = 0;
+    if (no_of_nodes == 0) {
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_CHECK(igraph_i_bh_add_cells(tree, 1, &cell));
+    root = &tree->cells[cell];
+    root->first = 0;
+    root->last = no_of_nodes;
+    root->half = 0;
+    for (k = 0; k < dim; k++) {
+        igraph_real_t min = MATRIX(*pos, 0, k), max = min;
+        for (i = 0; i < no_of_nodes; i++) {
+            igraph_real_t x = MATRIX(*pos, i, k);
+            VECTOR(tree->coords)[i * dim + k] = x;
+            if (x < min) {
+                min = x;
+            } else if (x > max) {
+                max = x;
+            }
+        }
+        root->center[k] = (min + max) / 2;
+        if ((max - min) / 2 > root->half) {
+            root->half = (max - min) / 2;
+        }
+    }
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(tree->order)[i] = i;
+    }
+
+    IGRAPH_CHECK(igraph_i_bh_split(tree, 0, 0));
+
+    for (i = 0; i < no_of_nodes; i++) {
+        VECTOR(tree->rank)[VECTOR(tree->order)[i]] = i;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Moves vertex v by 'delta', updating the sums of the cells that contain it.
+ * The vertex stays in the same cells; if it leaves the cube of a cell, the
+ * cube is enlarged around its center to contain it again. Larger cubes are
+ * opened more often, so the approximation stays as accurate as after a
+ * rebuild, but it gets slower until the next rebuild. */
+void igraph_i_bh_tree_move(igraph_i_bh_tree_t *tree, igraph_integer_t v,
+                           const igraph_real_t *delta) {
+    const igraph_integer_t dim = tree->dim, r = VECTOR(tree->rank)[v];
+    igraph_real_t *p = VECTOR(tree->coords) + r * dim;
+    igraph_integer_t k, cell = 0;
+
+    for (k = 0; k < dim; k++) {
+        p[k] += delta[k];
+    }
+    while (1) {
+        igraph_i_bh_cell_t *c = &tree->cells[cell];
+        for (k = 0; k < dim; k++) {
+            igraph_real_t extent = fabs(p[k] - c->center[k]);
+            c->sum[k] += delta[k];
+            if (extent > c->half) {
+                c->half = extent;
+            }
+        }
+        if (c->no_children == 0) {
+            break;
+        }
+        for (cell = c->child; tree->cells[cell].last <= r; cell++) ;
+    }
+}
+
+static inline void igraph_i_bh_add_force(const igraph_i_bh_kernel_t *kernel,
+                                         igraph_integer_t dim, const igraph_real_t *d,
+                                         igraph_real_t r2, igraph_real_t mass,
+                                         igraph_real_t *force) {
+    igraph_real_t g;
+    igraph_integer_t k;
+
+    if (r2 == 0 || (kernel->cutoff > 0 && r2 >= kernel->cutoff * kernel->cutoff)) {
+        return;
+    }
+    g = kernel->power == 1 ? kernel->scale / r2 : kernel->scale / (r2 * sqrt(r2));
+    if (kernel->linear != 0) {
+        g -= kernel->linear * sqrt(r2);
+    }
+    for (k = 0; k < dim; k++) {
+        force[k] += d[k] * g * mass;
+    }
+}
+
+/* Computes the force exerted on vertex v by all other vertices. Cells that
+ * contain v are always opened, so v never interacts with itself. */
+void igraph_i_bh_tree_force(const igraph_i_bh_tree_t *tree, igraph_integer_t v,
+                            const igraph_i_bh_kernel_t *kernel, igraph_real_t theta,
+                            igraph_real_t *force) {
+    const igraph_integer_t dim = tree->dim, r = VECTOR(tree->rank)[v];
+    const igraph_real_t *coords = VECTOR(tree->coords), *p = coords + r * dim;
+    const igraph_real_t theta2 = theta * theta;
+    igraph_integer_t stack[IGRAPH_I_BH_STACK_SIZE], size = 0;
+    igraph_real_t d[3];
+    igraph_integer_t i, k;
+
+    for (k = 0; k < dim; k++) {
+        force[k] = 0;
+    }
+    if (tree->no_of_cells == 0) {
+        return;
+    }
+
+    stack[size++] = 0;
+    while (size > 0) {
+        const igraph_i_bh_cell_t *c = &tree->cells[stack[--size]];
+        if (c->no_children == 0) {
+            for (i = c->first; i < c->last; i++) {
+                igraph_real_t r2 = 0;
+                if (i == r) {
+                    continue;
+                }
+                for (k = 0; k < dim; k++) {
+                    d[k] = p[k] - coords[i * dim + k];
+                    r2 += d[k] * d[k];
+                }
+                igraph_i_bh_add_force(kernel, dim, d, r2, 1, force);
+            }
+        } else {
+            igraph_real_t mass = c->last - c->first, r2 = 0;
+            for (k = 0; k < dim; k++) {
+                d[k] = p[k] - c->sum[k] / mass;
+                r2 += d[k] * d[k];
+            }
+            if ((r < c->first || r >= c->last) && 4 * c->half * c->half < theta2 * r2) {
+                igraph_i_bh_add_force(kernel, dim, d, r2, mass, force);
+            } else {
+                for (i = c->child; i < c->child + c->no_children; i++) {
+                    stack[size++] = i;
+                }
+            }
+        }
+    }
+}
+
+/* Computes the forces on all vertices, in parallel if possible, and stores
+ * their coordinates in the 'dim' vectors of 'forces'. */
+void igraph_i_bh_tree_forces(const igraph_i_bh_tree_t *tree,
+                             const igraph_i_bh_kernel_t *kernel, igraph_real_t theta,
+                             igraph_vector_t **forces) {
+    const igraph_integer_t dim = tree->dim, no_of_nodes = tree->no_of_nodes;
+    igraph_integer_t i;
+
+    /* Vertices are processed in tree order, so that consecutive queries
+     * visit the same cells. */
+    IGRAPH_I_OMP(omp parallel for schedule(dynamic, 64))
+    for (i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t v = VECTOR(tree->order)[i], k;
+        igraph_real_t force[3];
+        igraph_i_bh_tree_force(tree, v, kernel, theta, force);
+        for (k = 0; k < dim; k++) {
+            VECTOR(*forces[k])[v] = force[k];
+        }
+    }
+}
@@ -0,0 +1,94 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_LAYOUT_BARNES_HUT_H
+#define IGRAPH_LAYOUT_BARNES_HUT_H
+
+#include "igraph_decls.h"
+#include "igraph_error.h"
+#include "igraph_types.h"
+#include "igraph_matrix.h"
+#include "igraph_vector.h"
+
+__BEGIN_DECLS
+
+/* Force-directed layouts of graphs with more vertices than this
+ * approximate the repulsion between all vertex pairs with a Barnes-Hut tree. */
+#define IGRAPH_I_BH_MIN_VERTICES 1000
+
+/* A cell is treated as a single point if its side length is less than this
+ * fraction of its distance from the vertex whose force is computed. */
+#define IGRAPH_I_BH_THETA 0.7
+
+/* The force exerted on a vertex by another one at offset d = (own position -
+ * other position), at distance r = |d|, is
+ *
+ *     d * (scale / r^(power + 1) - linear * r)  if r < cutoff or cutoff <= 0,
+ *
+ * i.e. a repulsion of magnitude scale / r^power and an attraction of
+ * magnitude linear * r^2. Coincident vertices do not interact. */
+typedef struct igraph_i_bh_kernel_t {
+    igraph_real_t scale;
+    int power;                        /* 1 or 2 */
+    igraph_real_t linear;
+    igraph_real_t cutoff;
+} igraph_i_bh_kernel_t;
+
+typedef struct igraph_i_bh_cell_t {
+    igraph_real_t center[3];          /* The center of the cell's cube */
+    igraph_real_t half;               /* Half of the side length of the cube */
+    igraph_real_t sum[3];             /* The sum of the coordinates of the cell's vertices */
+    igraph_integer_t first, last;     /* The cell contains the vertices order[first] ... order[last - 1] */
+    igraph_integer_t child;           /* The children are cells child ... child + no_children - 1 */
+    igraph_integer_t no_children;     /* Zero for leaves */
+} igraph_i_bh_cell_t;
+
+/**
+ * A quadtree (in 2D) or octree (in 3D) of vertex positions. The vertices of
+ * each cell are consecutive in 'order', and their coordinates are stored in
+ * the same order in 'coords'.
+ */
+typedef struct igraph_i_bh_tree_t {
+    igraph_integer_t dim;
+    igraph_integer_t no_of_nodes;
+    igraph_i_bh_cell_t *cells;
+    igraph_integer_t no_of_cells, cells_size;
+    igraph_vector_int_t order;        /* The vertices, ordered by cell */
+    igraph_vector_int_t rank;         /* The position of each vertex in 'order' */
+    igraph_vector_t coords;           /* dim coordinates for each element of 'order' */
+    igraph_vector_int_t tmp_order;
+    igraph_vector_t tmp_coords;
+} igraph_i_bh_tree_t;
+
+IGRAPH_PRIVATE_EXPORT igraph_error_t igraph_i_bh_tree_init(igraph_i_bh_tree_t *tree,
+                                                           igraph_integer_t no_of_nodes, igraph_integer_t dim);
+IGRAPH_PRIVATE_EXPORT void igraph_i_bh_tree_destroy(igraph_i_bh_tree_t *tree);
+IGRAPH_PRIVATE_EXPORT igraph_error_t igraph_i_bh_tree_build(igraph_i_bh_tree_t *tree, const igraph_matrix_t *pos);
+IGRAPH_PRIVATE_EXPORT void igraph_i_bh_tree_move(igraph_i_bh_tree_t *tree, igraph_integer_t v,
+                                                 const igraph_real_t *delta);
+IGRAPH_PRIVATE_EXPORT void igraph_i_bh_tree_force(const igraph_i_bh_tree_t *tree, igraph_integer_t v,
+                                                  const igraph_i_bh_kernel_t *kernel, igraph_real_t theta,
+                                                  igraph_real_t *force);
+IGRAPH_PRIVATE_EXPORT void igraph_i_bh_tree_forces(const igraph_i_bh_tree_t *tree,
+                                                   const igraph_i_bh_kernel_t *kernel, igraph_real_t theta,
+                                                   igraph_vector_t **forces);
+
+__END_DECLS
+
+#endif
@@ -36,6 +36,7 @@
 #include "drl_Node.h"
 #include "DensityGrid.h"
 
+#include <algorithm>
 #include <cmath>
 #include <deque>
 #include <stdexcept>
@@ -90,8 +91,12 @@ void DensityGrid::Init() {
  * Function: DensityGrid::GetDensity               *
  * Description: Get_Density from density grid      *
  **************************************************/
-float DensityGrid::GetDensity(float Nx, float Ny, bool fineDensity) {
-    deque<Node>::iterator BI;
+// If self is not NULL, it must be a node that is currently
+// in the grid; its own contribution is left out, as if it
+// had been subtracted before the call.
+
+float DensityGrid::GetDensity(float Nx, float Ny, bool fineDensity, const Node *self) {
+    deque<Node>::const_iterator BI;
     int x_grid, y_grid;
     float x_dist, y_dist, distance, density = 0;
     int boundary = 10;  // boundary around plane
@@ -118,6 +123,9 @@ float DensityGrid::GetDensity(float Nx, float Ny, bool fineDensity) {
 
                 // Look through bin and add fine repulsions
                 for (BI = GET_BIN(i, j).begin(); BI != GET_BIN(i, j).end(); ++BI) {
+                    if (self && BI->id == self->id) {
+                        continue;
+                    }
                     x_dist =  Nx - (BI->x);
                     y_dist =  Ny - (BI->y);
                     distance = x_dist * x_dist + y_dist * y_dist;
@@ -129,6 +137,13 @@ float DensityGrid::GetDensity(float Nx, float Ny, bool fineDensity) {
 
         // Add rough estimate
         density = Density[y_grid][x_grid];
+        if (self) {
+            int x_off = x_grid - (int)((self->sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
+            int y_off = y_grid - (int)((self->sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
+            if (x_off >= -RADIUS && x_off <= RADIUS && y_off >= -RADIUS && y_off <= RADIUS) {
+                density -= fall_off[y_off + RADIUS][x_off + RADIUS];
+            }
+        }
         density *= density;
     }
 
@@ -139,56 +154,90 @@ float DensityGrid::GetDensity(float Nx, float Ny, bool fineDensity) {
 /// Nodes should all be passed by constant ref
 
 void DensityGrid::Add(Node &n, bool fineDensity) {
+    if (!Contains(n.x, n.y, fineDensity)) {
+        throw runtime_error("Exceeded density grid in DrL.");
+    }
     if (fineDensity) {
-        fineAdd(n);
+        fineAdd(n, n.x, n.y, 0, GRID_SIZE);
     } else {
-        Add(n);
+        Add(n.x, n.y, 0, GRID_SIZE);
     }
+    n.sub_x = n.x;
+    n.sub_y = n.y;
 }
 
 void DensityGrid::Subtract( Node &n, bool first_add,
                             bool fine_first_add, bool fineDensity) {
     if ( fineDensity && !fine_first_add ) {
-        fineSubtract (n);
+        fineSubtract (n, 0, GRID_SIZE);
     } else if ( !first_add ) {
-        Subtract(n);
+        Subtract(n.sub_x, n.sub_y, 0, GRID_SIZE);
     }
 }
 
+// Move is Subtract followed by Add to (x, y), restricted to the
+// grid rows row_begin <= row < row_end.  Calls on disjoint row
+// ranges may run concurrently.  The sub position of the node is
+// not updated, this is left to the caller once all rows are done.
+// The new position must have been checked with Contains().
+
+void DensityGrid::Move(const Node &n, float x, float y,
+                       bool first_add, bool fine_first_add, bool fineDensity,
+                       int row_begin, int row_end) {
+    if ( fineDensity && !fine_first_add ) {
+        fineSubtract (n, row_begin, row_end);
+    } else if ( !first_add ) {
+        Subtract(n.sub_x, n.sub_y, row_begin, row_end);
+    }
+    if (fineDensity) {
+        fineAdd(n, x, y, row_begin, row_end);
+    } else {
+        Add(x, y, row_begin, row_end);
+    }
+}
+
+// Checks whether a node can be added to the grid at (x, y)
+
+bool DensityGrid::Contains(float x, float y, bool fineDensity) {
+    int x_grid, y_grid;
+
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    if (!fineDensity) {
+        x_grid -= RADIUS;
+        y_grid -= RADIUS;
+    }
+
+    return x_grid < GRID_SIZE && x_grid >= 0 &&
+           y_grid < GRID_SIZE && y_grid >= 0;
+}
 
 /***************************************************
  * Function: DensityGrid::Subtract                *
  * Description: Subtract a node from density grid  *
  **************************************************/
-void DensityGrid::Subtract(Node &N) {
-    int x_grid, y_grid, diam;
+void DensityGrid::Subtract(float x, float y, int row_begin, int row_end) {
+    int x_grid, y_grid, diam, i_begin, i_end, j_begin, j_end;
     float *den_ptr, *fall_ptr;
 
     /* Where to subtract */
-    x_grid = (int)((N.sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
     x_grid -= RADIUS;
     y_grid -= RADIUS;
     diam = 2 * RADIUS;
 
-    // check to see that we are inside grid
-    if ( (x_grid >= GRID_SIZE) || (x_grid < 0) ||
-         (y_grid >= GRID_SIZE) || (y_grid < 0) ) {
-#ifdef MUSE_MPI
-        MPI_Abort ( MPI_COMM_WORLD, 1 );
-#else
-        throw runtime_error("Exceeded density grid in DrL.");
-#endif
-    }
-
-    /* Subtract density values */
-    den_ptr = &Density[y_grid][x_grid];
-    fall_ptr = &fall_off[0][0];
-    for (int i = 0; i <= diam; i++) {
-        for (int j = 0; j <= diam; j++) {
+    /* Subtract density values, clipped to the grid and the rows */
+    i_begin = max(0, row_begin - y_grid);
+    i_end = min(diam + 1, row_end - y_grid);
+    j_begin = max(0, -x_grid);
+    j_end = min(diam + 1, GRID_SIZE - x_grid);
+    for (int i = i_begin; i < i_end; i++) {
+        den_ptr = &Density[y_grid + i][x_grid + j_begin];
+        fall_ptr = &fall_off[i][j_begin];
+        for (int j = j_begin; j < j_end; j++) {
             *den_ptr++ -= *fall_ptr++;
         }
-        den_ptr += GRID_SIZE - (diam + 1);
     }
 }
 
@@ -196,71 +245,73 @@ void DensityGrid::Subtract(Node &N) {
  * Function: DensityGrid::Add                     *
  * Description: Add a node to the density grid     *
  **************************************************/
-void DensityGrid::Add(Node &N) {
-
-    int x_grid, y_grid, diam;
+void DensityGrid::Add(float x, float y, int row_begin, int row_end) {
+    int x_grid, y_grid, diam, i_begin, i_end, j_begin, j_end;
     float *den_ptr, *fall_ptr;
 
-
     /* Where to add */
-    x_grid = (int)((N.x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.y + HALF_VIEW + .5) * VIEW_TO_GRID);
-
-    N.sub_x = N.x;
-    N.sub_y = N.y;
-
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
     x_grid -= RADIUS;
     y_grid -= RADIUS;
     diam = 2 * RADIUS;
 
-    // check to see that we are inside grid
-    if ( (x_grid >= GRID_SIZE) || (x_grid < 0) ||
-         (y_grid >= GRID_SIZE) || (y_grid < 0) ) {
-#ifdef MUSE_MPI
-        MPI_Abort ( MPI_COMM_WORLD, 1 );
-#else
-        throw runtime_error("Exceeded density grid in DrL.");
-#endif
-    }
-
-    /* Add density values */
-    den_ptr = &Density[y_grid][x_grid];
-    fall_ptr = &fall_off[0][0];
-    for (int i = 0; i <= diam; i++) {
-        for (int j = 0; j <= diam; j++) {
+    /* Add density values, clipped to the grid and the rows */
+    i_begin = max(0, row_begin - y_grid);
+    i_end = min(diam + 1, row_end - y_grid);
+    j_begin = max(0, -x_grid);
+    j_end = min(diam + 1, GRID_SIZE - x_grid);
+    for (int i = i_begin; i < i_end; i++) {
+        den_ptr = &Density[y_grid + i][x_grid + j_begin];
+        fall_ptr = &fall_off[i][j_begin];
+        for (int j = j_begin; j < j_end; j++) {
             *den_ptr++ += *fall_ptr++;
         }
-        den_ptr += GRID_SIZE - (diam + 1);
     }
-
 }
 
 /***************************************************
  * Function: DensityGrid::fineSubtract             *
  * Description: Subtract a node from bins          *
  **************************************************/
-void DensityGrid::fineSubtract(Node &N) {
+void DensityGrid::fineSubtract(const Node &N, int row_begin, int row_end) {
     int x_grid, y_grid;
+    deque<Node>::iterator BI;
 
     /* Where to subtract */
     x_grid = (int)((N.sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
     y_grid = (int)((N.sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
-    GET_BIN(y_grid, x_grid).pop_front();
+    if (y_grid < row_begin || y_grid >= row_end) {
+        return;
+    }
+
+    deque<Node> &bin = GET_BIN(y_grid, x_grid);
+    for (BI = bin.begin(); BI != bin.end(); ++BI) {
+        if (BI->id == N.id) {
+            bin.erase(BI);
+            break;
+        }
+    }
 }
 
 /***************************************************
  * Function: DensityGrid::fineAdd                  *
  * Description: Add a node to the bins             *
  **************************************************/
-void DensityGrid::fineAdd(Node &N) {
+void DensityGrid::fineAdd(const Node &N, float x, float y, int row_begin, int row_end) {
     int x_grid, y_grid;
 
     /* Where to add */
-    x_grid = (int)((N.x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.y + HALF_VIEW + .5) * VIEW_TO_GRID);
-    N.sub_x = N.x;
-    N.sub_y = N.y;
-    GET_BIN(y_grid, x_grid).push_back(N);
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    if (y_grid < row_begin || y_grid >= row_end) {
+        return;
+    }
+
+    deque<Node> &bin = GET_BIN(y_grid, x_grid);
+    bin.push_back(N);
+    bin.back().x = bin.back().sub_x = x;
+    bin.back().y = bin.back().sub_y = y;
 }
 
 } // namespace drl
@@ -38,9 +38,6 @@
 
 #include "drl_layout.h"
 #include "drl_Node.h"
-#ifdef MUSE_MPI
-    #include <mpi.h>
-#endif
 
 #include <deque>
 
@@ -54,7 +51,12 @@ public:
     void Init();
     void Subtract(Node &n, bool first_add, bool fine_first_add, bool fineDensity);
     void Add(Node &n, bool fineDensity );
-    float GetDensity(float Nx, float Ny, bool fineDensity);
+    void Move(const Node &n, float x, float y,
+              bool first_add, bool fine_first_add, bool fineDensity,
+              int row_begin, int row_end);
+    bool Contains(float x, float y, bool fineDensity);
+    float GetDensity(float Nx, float Ny, bool fineDensity,
+                     const Node *self = NULL);
 
     // Contructor/Destructor
     DensityGrid() {};
@@ -63,10 +65,10 @@ public:
 private:
 
     // Private Members
-    void Subtract( Node &N );
-    void Add( Node &N );
-    void fineSubtract( Node &N );
-    void fineAdd( Node &N );
+    void Subtract( float x, float y, int row_begin, int row_end );
+    void Add( float x, float y, int row_begin, int row_end );
+    void fineSubtract( const Node &N, int row_begin, int row_end );
+    void fineAdd( const Node &N, float x, float y, int row_begin, int row_end );
 
     // new dynamic variables -- SBM
     float (*fall_off)[RADIUS * 2 + 1];
@@ -36,6 +36,7 @@
 #include "drl_Node_3d.h"
 #include "DensityGrid_3d.h"
 
+#include <algorithm>
 #include <cmath>
 #include <deque>
 #include <stdexcept>
@@ -95,8 +96,13 @@ void DensityGrid::Init() {
  * Function: DensityGrid::GetDensity               *
  * Description: Get_Density from density grid      *
  **************************************************/
-float DensityGrid::GetDensity(float Nx, float Ny, float Nz, bool fineDensity) {
-    deque<Node>::iterator BI;
+// If self is not NULL, it must be a node that is currently
+// in the grid; its own contribution is left out, as if it
+// had been subtracted before the call.
+
+float DensityGrid::GetDensity(float Nx, float Ny, float Nz, bool fineDensity,
+                              const Node *self) {
+    deque<Node>::const_iterator BI;
     int x_grid, y_grid, z_grid;
     float x_dist, y_dist, z_dist, distance, density = 0;
     int boundary = 10;  // boundary around plane
@@ -128,6 +134,9 @@ float DensityGrid::GetDensity(float Nx, float Ny, float Nz, bool fineDensity) {
 
                     // Look through bin and add fine repulsions
                     for (BI = GET_BIN(k, i, j).begin(); BI < GET_BIN(k, i, j).end(); ++BI) {
+                        if (self && BI->id == self->id) {
+                            continue;
+                        }
                         x_dist =  Nx - (BI->x);
                         y_dist =  Ny - (BI->y);
                         z_dist =  Nz - (BI->z);
@@ -141,70 +150,118 @@ float DensityGrid::GetDensity(float Nx, float Ny, float Nz, bool fineDensity) {
 
         // Add rough estimate
         density = Density[z_grid][y_grid][x_grid];
+        if (self) {
+            int x_off = x_grid - (int)((self->sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
+            int y_off = y_grid - (int)((self->sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
+            int z_off = z_grid - (int)((self->sub_z + HALF_VIEW + .5) * VIEW_TO_GRID);
+            if (x_off >= -RADIUS && x_off <= RADIUS && y_off >= -RADIUS && y_off <= RADIUS &&
+                z_off >= -RADIUS && z_off <= RADIUS) {
+                density -= fall_off[z_off + RADIUS][y_off + RADIUS][x_off + RADIUS];
+            }
+        }
         density *= density;
     }
 
     return density;
 }
 
-/// Wrapper functions for the Add and subtract methods
-/// Nodes should all be passed by constant ref
 
 void DensityGrid::Add(Node &n, bool fineDensity) {
+    if (!Contains(n.x, n.y, n.z, fineDensity)) {
+        throw runtime_error("Exceeded density grid in DrL.");
+    }
     if (fineDensity) {
-        fineAdd(n);
+        fineAdd(n, n.x, n.y, n.z, 0, GRID_SIZE);
     } else {
-        Add(n);
+        Add(n.x, n.y, n.z, 0, GRID_SIZE);
     }
+    n.sub_x = n.x;
+    n.sub_y = n.y;
+    n.sub_z = n.z;
 }
 
 void DensityGrid::Subtract( Node &n, bool first_add,
                             bool fine_first_add, bool fineDensity) {
     if ( fineDensity && !fine_first_add ) {
-        fineSubtract (n);
+        fineSubtract (n, 0, GRID_SIZE);
+    } else if ( !first_add ) {
+        Subtract(n.sub_x, n.sub_y, n.sub_z, 0, GRID_SIZE);
+    }
+}
+
+// Move is Subtract followed by Add to (x, y, z), restricted to the
+// grid planes z_begin <= z < z_end.  Calls on disjoint plane
+// ranges may run concurrently.  The sub position of the node is
+// not updated, this is left to the caller once all planes are done.
+// The new position must have been checked with Contains().
+
+void DensityGrid::Move(const Node &n, float x, float y, float z,
+                       bool first_add, bool fine_first_add, bool fineDensity,
+                       int z_begin, int z_end) {
+    if ( fineDensity && !fine_first_add ) {
+        fineSubtract (n, z_begin, z_end);
     } else if ( !first_add ) {
-        Subtract(n);
+        Subtract(n.sub_x, n.sub_y, n.sub_z, z_begin, z_end);
+    }
+    if (fineDensity) {
+        fineAdd(n, x, y, z, z_begin, z_end);
+    } else {
+        Add(x, y, z, z_begin, z_end);
     }
 }
 
+// Checks whether a node can be added to the grid at (x, y, z)
+
+bool DensityGrid::Contains(float x, float y, float z, bool fineDensity) {
+    int x_grid, y_grid, z_grid;
+
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    z_grid = (int)((z + HALF_VIEW + .5) * VIEW_TO_GRID);
+    if (!fineDensity) {
+        x_grid -= RADIUS;
+        y_grid -= RADIUS;
+        z_grid -= RADIUS;
+    }
+
+    return x_grid < GRID_SIZE && x_grid >= 0 &&
+           y_grid < GRID_SIZE && y_grid >= 0 &&
+           z_grid < GRID_SIZE && z_grid >= 0;
+}
 
 /***************************************************
  * Function: DensityGrid::Subtract                *
  * Description: Subtract a node from density grid  *
  **************************************************/
-void DensityGrid::Subtract(Node &N) {
+void DensityGrid::Subtract(float x, float y, float z, int z_begin, int z_end) {
     int x_grid, y_grid, z_grid, diam;
+    int i_begin, i_end, j_begin, j_end, k_begin, k_end;
     float *den_ptr, *fall_ptr;
 
     /* Where to subtract */
-    x_grid = (int)((N.sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
-    z_grid = (int)((N.sub_z + HALF_VIEW + .5) * VIEW_TO_GRID);
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    z_grid = (int)((z + HALF_VIEW + .5) * VIEW_TO_GRID);
     x_grid -= RADIUS;
     y_grid -= RADIUS;
     z_grid -= RADIUS;
     diam = 2 * RADIUS;
 
-    // check to see that we are inside grid
-    if ( (x_grid >= GRID_SIZE) || (x_grid < 0) ||
-         (y_grid >= GRID_SIZE) || (y_grid < 0) ||
-         (z_grid >= GRID_SIZE) || (z_grid < 0) ) {
-#ifdef MUSE_MPI
-        MPI_Abort ( MPI_COMM_WORLD, 1 );
-#else
-        throw runtime_error("Exceeded density grid in DrL.");
-#endif
-    }
-
-    /* Subtract density values */
-    den_ptr = &Density[z_grid][y_grid][x_grid];
-    fall_ptr = &fall_off[0][0][0];
-    for (int i = 0; i <= diam; i++) {
-        for (int j = 0; j <= diam; j++)
-            for (int k = 0; k <= diam; k++) {
+    /* Subtract density values, clipped to the grid and the planes */
+    i_begin = max(0, z_begin - z_grid);
+    i_end = min(diam + 1, z_end - z_grid);
+    j_begin = max(0, -y_grid);
+    j_end = min(diam + 1, GRID_SIZE - y_grid);
+    k_begin = max(0, -x_grid);
+    k_end = min(diam + 1, GRID_SIZE - x_grid);
+    for (int i = i_begin; i < i_end; i++) {
+        for (int j = j_begin; j < j_end; j++) {
+            den_ptr = &Density[z_grid + i][y_grid + j][x_grid + k_begin];
+            fall_ptr = &fall_off[i][j][k_begin];
+            for (int k = k_begin; k < k_end; k++) {
                 *den_ptr++ -= *fall_ptr++;
             }
-        den_ptr += GRID_SIZE - (diam + 1);
+        }
     }
 }
 
@@ -212,79 +269,83 @@ void DensityGrid::Subtract(Node &N) {
  * Function: DensityGrid::Add                     *
  * Description: Add a node to the density grid     *
  **************************************************/
-void DensityGrid::Add(Node &N) {
-
+void DensityGrid::Add(float x, float y, float z, int z_begin, int z_end) {
     int x_grid, y_grid, z_grid, diam;
+    int i_begin, i_end, j_begin, j_end, k_begin, k_end;
     float *den_ptr, *fall_ptr;
 
-
     /* Where to add */
-    x_grid = (int)((N.x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.y + HALF_VIEW + .5) * VIEW_TO_GRID);
-    z_grid = (int)((N.z + HALF_VIEW + .5) * VIEW_TO_GRID);
-
-    N.sub_x = N.x;
-    N.sub_y = N.y;
-    N.sub_z = N.z;
-
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    z_grid = (int)((z + HALF_VIEW + .5) * VIEW_TO_GRID);
     x_grid -= RADIUS;
     y_grid -= RADIUS;
     z_grid -= RADIUS;
     diam = 2 * RADIUS;
 
-    // check to see that we are inside grid
-    if ( (x_grid >= GRID_SIZE) || (x_grid < 0) ||
-         (y_grid >= GRID_SIZE) || (y_grid < 0) ||
-         (z_grid >= GRID_SIZE) || (z_grid < 0) ) {
-#ifdef MUSE_MPI
-        MPI_Abort ( MPI_COMM_WORLD, 1 );
-#else
-        throw runtime_error("Exceeded density grid in DrL.");
-#endif
-    }
-
-    /* Add density values */
-    den_ptr = &Density[z_grid][y_grid][x_grid];
-    fall_ptr = &fall_off[0][0][0];
-    for (int i = 0; i <= diam; i++) {
-        for (int j = 0; j <= diam; j++)
-            for (int k = 0; k <= diam; k++) {
+    /* Add density values, clipped to the grid and the planes */
+    i_begin = max(0, z_begin - z_grid);
+    i_end = min(diam + 1, z_end - z_grid);
+    j_begin = max(0, -y_grid);
+    j_end = min(diam + 1, GRID_SIZE - y_grid);
+    k_begin = max(0, -x_grid);
+    k_end = min(diam + 1, GRID_SIZE - x_grid);
+    for (int i = i_begin; i < i_end; i++) {
+        for (int j = j_begin; j < j_end; j++) {
+            den_ptr = &Density[z_grid + i][y_grid + j][x_grid + k_begin];
+            fall_ptr = &fall_off[i][j][k_begin];
+            for (int k = k_begin; k < k_end; k++) {
                 *den_ptr++ += *fall_ptr++;
             }
-        den_ptr += GRID_SIZE - (diam + 1);
+        }
     }
-
 }
 
 /***************************************************
  * Function: DensityGrid::fineSubtract             *
  * Description: Subtract a node from bins          *
  **************************************************/
-void DensityGrid::fineSubtract(Node &N) {
+void DensityGrid::fineSubtract(const Node &N, int z_begin, int z_end) {
     int x_grid, y_grid, z_grid;
+    deque<Node>::iterator BI;
 
     /* Where to subtract */
     x_grid = (int)((N.sub_x + HALF_VIEW + .5) * VIEW_TO_GRID);
     y_grid = (int)((N.sub_y + HALF_VIEW + .5) * VIEW_TO_GRID);
     z_grid = (int)((N.sub_z + HALF_VIEW + .5) * VIEW_TO_GRID);
-    GET_BIN(z_grid, y_grid, x_grid).pop_front();
+    if (z_grid < z_begin || z_grid >= z_end) {
+        return;
+    }
+
+    deque<Node> &bin = GET_BIN(z_grid, y_grid, x_grid);
+    for (BI = bin.begin(); BI != bin.end(); ++BI) {
+        if (BI->id == N.id) {
+            bin.erase(BI);
+            break;
+        }
+    }
 }
 
 /***************************************************
  * Function: DensityGrid::fineAdd                  *
  * Description: Add a node to the bins             *
  **************************************************/
-void DensityGrid::fineAdd(Node &N) {
+void DensityGrid::fineAdd(const Node &N, float x, float y, float z, int z_begin, int z_end) {
     int x_grid, y_grid, z_grid;
 
     /* Where to add */
-    x_grid = (int)((N.x + HALF_VIEW + .5) * VIEW_TO_GRID);
-    y_grid = (int)((N.y + HALF_VIEW + .5) * VIEW_TO_GRID);
-    z_grid = (int)((N.z + HALF_VIEW + .5) * VIEW_TO_GRID);
-    N.sub_x = N.x;
-    N.sub_y = N.y;
-    N.sub_z = N.z;
-    GET_BIN(z_grid, y_grid, x_grid).push_back(N);
+    x_grid = (int)((x + HALF_VIEW + .5) * VIEW_TO_GRID);
+    y_grid = (int)((y + HALF_VIEW + .5) * VIEW_TO_GRID);
+    z_grid = (int)((z + HALF_VIEW + .5) * VIEW_TO_GRID);
+    if (z_grid < z_begin || z_grid >= z_end) {
+        return;
+    }
+
+    deque<Node> &bin = GET_BIN(z_grid, y_grid, x_grid);
+    bin.push_back(N);
+    bin.back().x = bin.back().sub_x = x;
+    bin.back().y = bin.back().sub_y = y;
+    bin.back().z = bin.back().sub_z = z;
 }
 
 } // namespace drl3d
@@ -36,6 +36,7 @@
 #include <map>
 #include <vector>
 #include <cmath>
+#include <stdexcept>
 
 using namespace std;
 
@@ -44,9 +45,7 @@ using namespace std;
 #include "igraph_interface.h"
 #include "igraph_progress.h"
 #include "core/interruption.h"
-#ifdef MUSE_MPI
-    #include <mpi.h>
-#endif
+#include "core/parallel.h"
 
 namespace drl {
 
@@ -129,9 +128,6 @@ namespace drl {
 graph::graph(const igraph_t *igraph,
              const igraph_layout_drl_options_t *options,
              const igraph_vector_t *weights) {
-    myid = 0;
-    num_procs = 1;
-
     STAGE = 0;
     iterations = options->init_iterations;
     temperature = options->init_temperature;
@@ -194,6 +190,7 @@ graph::graph(const igraph_t *igraph,
     }
 
     // read .int file for graph info
+    neighbors.resize ( num_nodes );
     igraph_integer_t node_1, node_2;
     igraph_real_t weight;
     for (igraph_integer_t i = 0; i < no_of_edges; i++) {
@@ -813,99 +810,57 @@ int graph::ReCompute( ) {
 }
 
 // update_nodes -- this function will complete the primary node update
-// loop in layout's recompute routine.  It follows exactly the same
-// sequence to ensure similarity of parallel layout to the standard layout
+// loop in layout's recompute routine.  The nodes are updated in batches:
+// the new positions of the nodes of a batch are computed in parallel,
+// all from the same layout and density grid, then the density grid is
+// updated.  The batches only depend on the number of nodes, and the
+// density grid is updated in the same order for any number of threads,
+// so the layout only depends on the random seed.
 
 void graph::update_nodes ( ) {
 
-    vector<igraph_integer_t> node_indices;           // node list of nodes currently being updated
-    float old_positions[2 * MAX_PROCS]; // positions before update
-    float new_positions[2 * MAX_PROCS]; // positions after update
-
-    bool all_fixed;                     // check if all nodes are fixed
-
-    // initial node list consists of 0,1,...,num_procs
-    for ( int i = 0; i < num_procs; i++ ) {
-        node_indices.push_back( i );
+    vector<igraph_integer_t> batch;     // nodes being updated
+    vector<float> jumps;                // random numbers of the batch
+    vector<float> new_positions;        // positions after update
+    igraph_integer_t batch_size, num_batches, size;
+
+    // a pass takes at least MIN_BATCHES batches of at most BATCH_SIZE
+    // nodes; batch b consists of nodes b, b + num_batches, ..., which
+    // are usually not close to each other.  With one node per batch,
+    // this is the original sequential update.
+    batch_size = (num_nodes + MIN_BATCHES - 1) / MIN_BATCHES;
+    if ( batch_size > BATCH_SIZE ) {
+        batch_size = BATCH_SIZE;
+    } else if ( batch_size < 1 ) {
+        batch_size = 1;
     }
+    num_batches = (num_nodes + batch_size - 1) / batch_size;
 
-    // next we calculate the number of nodes there would be if the
-    // num_nodes by num_procs schedule grid were perfectly square
-    igraph_integer_t square_num_nodes = (igraph_integer_t)(num_procs + num_procs * floor ((float)(num_nodes - 1) / (float)num_procs ));
-
-    for ( igraph_integer_t i = myid; i < square_num_nodes; i += num_procs ) {
-
-        // get old positions
-        get_positions ( node_indices, old_positions );
-
-        // default new position is old position
-        get_positions ( node_indices, new_positions );
-
-        if ( i < num_nodes ) {
+    for ( igraph_integer_t b = 0; b < num_batches; b++ ) {
 
-            // advance random sequence according to myid
-            for ( size_t j = 0; j < 2 * myid; j++ ) {
-                RNG_UNIF01();
-            }
-            // rand();
-
-            // calculate node energy possibilities
+        batch.clear();
+        for ( igraph_integer_t i = b; i < num_nodes; i += num_batches ) {
             if ( !(positions[i].fixed && real_fixed) ) {
-                update_node_pos ( i, old_positions, new_positions );
-            }
-
-            // advance random sequence for next iteration
-            for ( size_t j = 2 * myid; j < 2 * (node_indices.size() - 1); j++ ) {
-                RNG_UNIF01();
+                batch.push_back( i );
             }
-            // rand();
-
-        } else {
-            // advance random sequence according to use by
-            // the other processors
-            for ( size_t j = 0; j < 2 * (node_indices.size()); j++ ) {
-                RNG_UNIF01();
-            }
-            //rand();
-        }
-
-        // check if anything was actually updated (e.g. everything was fixed)
-        all_fixed = true;
-        for ( size_t j = 0; j < node_indices.size (); j++ )
-            if ( !(positions [ node_indices[j] ].fixed && real_fixed) ) {
-                all_fixed = false;
-            }
-
-        // update positions across processors (if not all fixed)
-        if ( !all_fixed ) {
-#ifdef MUSE_MPI
-            MPI_Allgather ( &new_positions[2 * myid], 2, MPI_FLOAT,
-                            new_positions, 2, MPI_FLOAT, MPI_COMM_WORLD );
-#endif
-
-            // update positions (old to new)
-            update_density ( node_indices, old_positions, new_positions );
         }
+        size = batch.size();
 
-        /*
-        if ( myid == 0 )
-          {
-            // output node list (for debugging)
-            for ( unsigned int j = 0; j < node_indices.size(); j++ )
-              cout << node_indices[j] << " ";
-            cout << endl;
-          }
-        */
-
-        // compute node list for next update
-        for ( size_t j = 0; j < node_indices.size(); j++ ) {
-            node_indices [j] += num_procs;
+        // the random numbers are drawn in node order up front
+        jumps.resize( 2 * size );
+        new_positions.resize( 2 * size );
+        for ( igraph_integer_t j = 0; j < 2 * size; j++ ) {
+            jumps[j] = RNG_UNIF01();
         }
 
-        while ( !node_indices.empty() && node_indices.back() >= num_nodes ) {
-            node_indices.pop_back ( );
+        // calculate node energy possibilities
+        IGRAPH_I_OMP(omp parallel for schedule(dynamic, 16) if (size > 1))
+        for ( igraph_integer_t j = 0; j < size; j++ ) {
+            update_node_pos ( batch[j], &jumps[2 * j], &new_positions[2 * j] );
         }
 
+        // update positions (old to new)
+        update_density ( batch, new_positions );
     }
 
     // update first_add and fine_first_add
@@ -916,28 +871,14 @@ void graph::update_nodes ( ) {
 
 }
 
-// The get_positions function takes the node_indices list
-// and returns the corresponding positions in an array.
-
-void graph::get_positions ( vector<igraph_integer_t> &node_indices,
-                            float return_positions[2 * MAX_PROCS]  ) {
-
-    // fill positions
-    for (size_t i = 0; i < node_indices.size(); i++) {
-        return_positions[2 * i] = positions[ node_indices[i] ].x;
-        return_positions[2 * i + 1] = positions[ node_indices[i] ].y;
-    }
-
-}
-
 // update_node_pos -- this subroutine does the actual work of computing
-// the new position of a given node.  num_act_proc gives the number
-// of active processes at this level for use by the random number
-// generators.
+// the new position of a given node.  jumps holds the random numbers
+// for the random move.  Neither the positions nor the density grid are
+// modified, so this can run for several nodes at the same time.
 
 void graph::update_node_pos ( igraph_integer_t node_ind,
-                              float old_positions[2 * MAX_PROCS],
-                              float new_positions[2 * MAX_PROCS] ) {
+                              const float jumps[2],
+                              float new_positions[2] ) {
 
     float energies[2];          // node energies for possible positions
     float updated_pos[2][2];    // possible positions
@@ -946,82 +887,67 @@ void graph::update_node_pos ( igraph_integer_t node_ind,
     // old VxOrd parameter
     float jump_length = .010 * temperature;
 
-    // subtract old node
-    density_server.Subtract ( positions[node_ind], first_add, fine_first_add, fineDensity );
-
     // compute node energy for old solution
-    energies[0] = Compute_Node_Energy ( node_ind );
+    energies[0] = Compute_Node_Energy ( node_ind, positions[node_ind].x, positions[node_ind].y );
 
     // move node to centroid position
     Solve_Analytic ( node_ind, pos_x, pos_y );
-    positions[node_ind].x = updated_pos[0][0] = pos_x;
-    positions[node_ind].y = updated_pos[0][1] = pos_y;
+    updated_pos[0][0] = pos_x;
+    updated_pos[0][1] = pos_y;
 
-    /*
-    // ouput random numbers (for debugging)
-    int rand_0, rand_1;
-    rand_0 = rand();
-    rand_1 = rand();
-    cout << myid << ": " << rand_0 << ", " << rand_1 << endl;
-    */
-
-    // Do random method (RAND_MAX is C++ maximum random number)
-    updated_pos[1][0] = updated_pos[0][0] + (.5 - RNG_UNIF01()) * jump_length;
-    updated_pos[1][1] = updated_pos[0][1] + (.5 - RNG_UNIF01()) * jump_length;
+    // Do random method
+    updated_pos[1][0] = updated_pos[0][0] + (.5 - jumps[0]) * jump_length;
+    updated_pos[1][1] = updated_pos[0][1] + (.5 - jumps[1]) * jump_length;
 
     // compute node energy for random position
-    positions[node_ind].x = updated_pos[1][0];
-    positions[node_ind].y = updated_pos[1][1];
-    energies[1] = Compute_Node_Energy ( node_ind );
-
-    /*
-    // output update possiblities (debugging):
-    cout << node_ind << ": (" << updated_pos[0][0] << "," << updated_pos[0][1]
-         << "), " << energies[0] << "; (" << updated_pos[1][0] << ","
-         << updated_pos[1][1] << "), " << energies[1] << endl;
-    */
-
-    // add back old position
-    positions[node_ind].x = old_positions[2 * myid];
-    positions[node_ind].y = old_positions[2 * myid + 1];
-    if ( !fineDensity && !first_add ) {
-        density_server.Add ( positions[node_ind], fineDensity );
-    } else if ( !fine_first_add ) {
-        density_server.Add ( positions[node_ind], fineDensity );
-    }
+    energies[1] = Compute_Node_Energy ( node_ind, updated_pos[1][0], updated_pos[1][1] );
 
     // choose updated node position with lowest energy
     if ( energies[0] < energies[1] ) {
-        new_positions[2 * myid] = updated_pos[0][0];
-        new_positions[2 * myid + 1] = updated_pos[0][1];
+        new_positions[0] = updated_pos[0][0];
+        new_positions[1] = updated_pos[0][1];
         positions[node_ind].energy = energies[0];
     } else {
-        new_positions[2 * myid] = updated_pos[1][0];
-        new_positions[2 * myid + 1] = updated_pos[1][1];
+        new_positions[0] = updated_pos[1][0];
+        new_positions[1] = updated_pos[1][1];
         positions[node_ind].energy = energies[1];
     }
 
 }
 
-// update_density takes a sequence of node_indices and their positions and
+// update_density takes a batch of nodes and their new positions and
 // updates the positions by subtracting the old positions and adding the
-// new positions to the density grid.
+// new positions to the density grid.  Each thread works on its own
+// rows of the grid.
+
+void graph::update_density ( const vector<igraph_integer_t> &batch,
+                             const vector<float> &new_positions ) {
+
+    igraph_integer_t size = batch.size();
+    int num_bands = size > 1 ? igraph_i_parallel_max_threads() : 1;
 
-void graph::update_density ( vector<igraph_integer_t> &node_indices,
-                             float old_positions[2 * MAX_PROCS],
-                             float new_positions[2 * MAX_PROCS] ) {
+    // check first, as the parallel part cannot throw
+    for ( igraph_integer_t i = 0; i < size; i++ ) {
+        if ( !density_server.Contains ( new_positions[2 * i + 0], new_positions[2 * i + 1], fineDensity ) ) {
+            throw runtime_error("Exceeded density grid in DrL.");
+        }
+    }
 
     // go through each node and subtract old position from
     // density grid before adding new position
-    for ( size_t i = 0; i < node_indices.size(); i++ ) {
-        positions[node_indices[i]].x = old_positions[2 * i];
-        positions[node_indices[i]].y = old_positions[2 * i + 1];
-        density_server.Subtract ( positions[node_indices[i]],
-                                  first_add, fine_first_add, fineDensity );
-
-        positions[node_indices[i]].x = new_positions[2 * i];
-        positions[node_indices[i]].y = new_positions[2 * i + 1];
-        density_server.Add ( positions[node_indices[i]], fineDensity );
+    IGRAPH_I_OMP(omp parallel for schedule(static, 1) if (num_bands > 1))
+    for ( int band = 0; band < num_bands; band++ ) {
+        int begin = GRID_SIZE * band / num_bands;
+        int end = GRID_SIZE * (band + 1) / num_bands;
+        for ( igraph_integer_t i = 0; i < size; i++ ) {
+            density_server.Move ( positions[batch[i]], new_positions[2 * i + 0], new_positions[2 * i + 1],
+                                  first_add, fine_first_add, fineDensity, begin, end );
+        }
+    }
+
+    for ( igraph_integer_t i = 0; i < size; i++ ) {
+        positions[batch[i]].x = positions[batch[i]].sub_x = new_positions[2 * i + 0];
+        positions[batch[i]].y = positions[batch[i]].sub_y = new_positions[2 * i + 1];
     }
 
 }
@@ -1032,8 +958,10 @@ void graph::update_density ( vector<igraph_integer_t> &node_indices,
 * This code has been modified from the      *
 * original code by B. Wylie.                *
 *********************************************/
+// The energy is computed as if the node was at (x, y),
+// without its own contribution to the density.
 
-float graph::Compute_Node_Energy( igraph_integer_t node_ind ) {
+float graph::Compute_Node_Energy( igraph_integer_t node_ind, float x, float y ) {
 
     /* Want to expand 4th power range of attraction */
     float attraction_factor = attraction * attraction *
@@ -1051,8 +979,8 @@ float graph::Compute_Node_Energy( igraph_integer_t node_ind ) {
         weight = EI->second;
 
         // Compute x,y distance
-        x_dis = positions[ node_ind ].x - positions[ EI->first ].x;
-        y_dis = positions[ node_ind ].y - positions[ EI->first ].y;
+        x_dis = x - positions[ EI->first ].x;
+        y_dis = y - positions[ EI->first ].y;
 
         // Energy Distance
         energy_distance = x_dis * x_dis + y_dis * y_dis;
@@ -1068,15 +996,11 @@ float graph::Compute_Node_Energy( igraph_integer_t node_ind ) {
         node_energy += weight * attraction_factor * energy_distance;
     }
 
-    // output effect of density (debugging)
-    //cout << "[before: " << node_energy;
-
-    // add density
-    node_energy += density_server.GetDensity ( positions[ node_ind ].x, positions[ node_ind ].y,
-                   fineDensity );
-
-    // after calling density server (debugging)
-    //cout << ", after: " << node_energy << "]" << endl;
+    // add density, the node is in the grid unless this is the
+    // first pass (of the current kind of density)
+    bool in_grid = fineDensity ? !fine_first_add : !first_add;
+    node_energy += density_server.GetDensity ( x, y, fineDensity,
+                   in_grid ? &positions[ node_ind ] : NULL );
 
     // return computated energy
     return node_energy;
@@ -1241,22 +1165,11 @@ void graph::write_sim ( const char *file_name )
 
 float graph::get_tot_energy ( ) {
 
-    float my_tot_energy, tot_energy;
-    my_tot_energy = 0;
-    for ( int i = myid; i < num_nodes; i += num_procs ) {
-        my_tot_energy += positions[i].energy;
+    float tot_energy = 0;
+    for ( igraph_integer_t i = 0; i < num_nodes; i++ ) {
+        tot_energy += positions[i].energy;
     }
 
-    //vector<Node>::iterator i;
-    //for ( i = positions.begin(); i != positions.end(); i++ )
-    //  tot_energy += i->energy;
-
-#ifdef MUSE_MPI
-    MPI_Reduce ( &my_tot_energy, &tot_energy, 1, MPI_FLOAT, MPI_SUM, 0, MPI_COMM_WORLD );
-#else
-    tot_energy = my_tot_energy;
-#endif
-
     return tot_energy;
 
 }
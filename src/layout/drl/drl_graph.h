@@ -82,24 +82,19 @@ private:
     // Methods
     int ReCompute ( );
     void update_nodes ( );
-    float Compute_Node_Energy ( igraph_integer_t node_ind );
+    float Compute_Node_Energy ( igraph_integer_t node_ind, float x, float y );
     void Solve_Analytic ( igraph_integer_t node_ind, float &pos_x, float &pos_y );
-    void get_positions ( std::vector<igraph_integer_t> &node_indices, float return_positions[2 * MAX_PROCS] );
-    void update_density ( std::vector<igraph_integer_t> &node_indices,
-                          float old_positions[2 * MAX_PROCS],
-                          float new_positions[2 * MAX_PROCS] );
+    void update_density ( const std::vector<igraph_integer_t> &batch,
+                          const std::vector<float> &new_positions );
     void update_node_pos ( igraph_integer_t node_ind,
-                           float old_positions[2 * MAX_PROCS],
-                           float new_positions[2 * MAX_PROCS] );
-
-    // MPI information
-    int myid, num_procs;
+                           const float jumps[2],
+                           float new_positions[2] );
 
     // graph decomposition information
     igraph_integer_t num_nodes;                  // number of nodes in graph
     float highest_sim;              // highest sim for normalization
     std::map <igraph_integer_t, igraph_integer_t> id_catalog;      // id_catalog[file id] = internal id
-    std::map <igraph_integer_t, std::map <igraph_integer_t, float> > neighbors;     // neighbors of nodes on this proc.
+    std::vector< std::map <igraph_integer_t, float> > neighbors;     // neighbors of nodes
 
     // graph layout information
     std::vector<Node> positions;
@@ -430,6 +430,11 @@ igraph_error_t igraph_layout_drl_options_init(igraph_layout_drl_options_t *optio
  * Please see more in the following technical report: Martin, S.,
  * Brown, W.M., Klavans, R., Boyack, K.W., DrL: Distributed Recursive
  * (Graph) Layout. SAND Reports, 2008. 2936: p. 1-10.
+ *
+ * </para><para> The vertices are moved in batches; the new positions of
+ * the vertices of a batch are computed in parallel when igraph is built
+ * with OpenMP support. The layout depends only on the random seed, not
+ * on the number of threads.
  * \param graph The input graph.
  * \param use_seed Logical scalar, if true, then the coordinates
  *    supplied in the \p res argument are used as starting points.
@@ -78,6 +78,11 @@ using namespace drl3d;
  *
  * </para><para> This function uses a modified DrL generator that does
  * the layout in three dimensions.
+ *
+ * </para><para> The vertices are moved in batches; the new positions of
+ * the vertices of a batch are computed in parallel when igraph is built
+ * with OpenMP support. The layout depends only on the random seed, not
+ * on the number of threads.
  * \param graph The input graph.
  * \param use_seed Logical scalar, if true, then the coordinates
  *    supplied in the \p res argument are used as starting points.
@@ -35,8 +35,9 @@
 
 #define DRL_VERSION "3.2 5/5/2006"
 
-// compile time parameters for MPI message passing
-#define MAX_PROCS 256      // maximum number of processors
+// compile time parameters for the parallel node update
+#define BATCH_SIZE 256     // maximum number of nodes updated together
+#define MIN_BATCHES 64     // minimum number of batches per iteration
 #define MAX_FILE_NAME 250   // max length of filename
 #define MAX_INT_LENGTH 4   // max length of integer suffix of intermediate .coord file
 
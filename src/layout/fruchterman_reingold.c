@@ -29,6 +29,7 @@
 
 #include "core/grid.h"
 #include "core/interruption.h"
+#include "layout/barnes_hut.h"
 #include "layout/layout_internal.h"
 
 static igraph_error_t igraph_layout_i_fr(const igraph_t *graph,
@@ -40,20 +41,25 @@ static igraph_error_t igraph_layout_i_fr(const igraph_t *graph,
                               const igraph_vector_t *minx,
                               const igraph_vector_t *maxx,
                               const igraph_vector_t *miny,
-                              const igraph_vector_t *maxy) {
+                              const igraph_vector_t *maxy,
+                              igraph_bool_t barnes_hut) {
 
     igraph_integer_t no_nodes = igraph_vcount(graph);
     igraph_integer_t no_edges = igraph_ecount(graph);
     igraph_integer_t i;
     igraph_vector_t dispx, dispy;
+    igraph_vector_t *disp[2] = { &dispx, &dispy };
     igraph_real_t temp = start_temp;
     igraph_real_t difftemp = start_temp / niter;
     igraph_bool_t conn = true;
     igraph_real_t C = 0;
+    igraph_i_bh_tree_t tree;
+    igraph_i_bh_kernel_t kernel = { /* scale = */ 1, /* power = */ 1, /* linear = */ 0, /* cutoff = */ 0 };
 
     IGRAPH_CHECK(igraph_is_connected(graph, &conn, IGRAPH_WEAK));
     if (!conn) {
         C = no_nodes * sqrt(no_nodes);
+        kernel.linear = 1 / C;
     }
 
     RNG_BEGIN();
@@ -64,6 +70,8 @@ static igraph_error_t igraph_layout_i_fr(const igraph_t *graph,
 
     IGRAPH_VECTOR_INIT_FINALLY(&dispx, no_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&dispy, no_nodes);
+    IGRAPH_CHECK(igraph_i_bh_tree_init(&tree, barnes_hut ? no_nodes : 0, 2));
+    IGRAPH_FINALLY(igraph_i_bh_tree_destroy, &tree);
 
     for (i = 0; i < niter; i++) {
         igraph_integer_t v, u, e;
@@ -74,7 +82,10 @@ static igraph_error_t igraph_layout_i_fr(const igraph_t *graph,
            for unconnected graphs */
         igraph_vector_null(&dispx);
         igraph_vector_null(&dispy);
-        if (conn) {
+        if (barnes_hut) {
+            IGRAPH_CHECK(igraph_i_bh_tree_build(&tree, res));
+            igraph_i_bh_tree_forces(&tree, &kernel, IGRAPH_I_BH_THETA, disp);
+        } else if (conn) {
             for (v = 0; v < no_nodes; v++) {
                 for (u = v + 1; u < no_nodes; u++) {
                     igraph_real_t dx = MATRIX(*res, v, 0) - MATRIX(*res, u, 0);
@@ -167,9 +178,10 @@ static igraph_error_t igraph_layout_i_fr(const igraph_t *graph,
 
     RNG_END();
 
+    igraph_i_bh_tree_destroy(&tree);
     igraph_vector_destroy(&dispx);
     igraph_vector_destroy(&dispy);
-    IGRAPH_FINALLY_CLEAN(2);
+    IGRAPH_FINALLY_CLEAN(3);
 
     return IGRAPH_SUCCESS;
 }
@@ -340,9 +352,14 @@ static igraph_error_t igraph_layout_i_grid_fr(
  * \param grid Whether to use the (fast but less accurate) grid based
  *        version of the algorithm. Possible values: \c
  *        IGRAPH_LAYOUT_GRID, \c IGRAPH_LAYOUT_NOGRID, \c
- *        IGRAPH_LAYOUT_AUTOGRID. The last one uses the grid based
- *        version only for large graphs, currently the ones with
- *        more than 1000 vertices.
+ *        IGRAPH_LAYOUT_AUTOGRID. The grid based version only computes
+ *        the repulsion between vertices that are close to each other.
+ *        \c IGRAPH_LAYOUT_AUTOGRID computes the repulsion exactly for
+ *        small graphs, and approximates it with a Barnes-Hut tree for
+ *        large graphs, currently the ones with more than 1000 vertices.
+ *        The Barnes-Hut approximation takes the repulsion of distant
+ *        vertices into account, and is computed in parallel when igraph
+ *        is built with OpenMP support.
  * \param weight Pointer to a vector containing edge weights,
  *        the attraction along the edges will be multiplied by these.
  *        Weights must be positive.
@@ -361,7 +378,8 @@ static igraph_error_t igraph_layout_i_grid_fr(
  *
  * Time complexity: O(|V|^2) in each
  * iteration, |V| is the number of
- * vertices in the graph.
+ * vertices in the graph. O(|V| log |V| + |E|) per iteration
+ * with the Barnes-Hut approximation.
  */
 
 igraph_error_t igraph_layout_fruchterman_reingold(const igraph_t *graph,
@@ -416,20 +434,14 @@ igraph_error_t igraph_layout_fruchterman_reingold(const igraph_t *graph,
         IGRAPH_ERROR("miny must not be greater than maxy.", IGRAPH_EINVAL);
     }
 
-    if (grid == IGRAPH_LAYOUT_AUTOGRID) {
-        if (no_nodes > 1000) {
-            grid = IGRAPH_LAYOUT_GRID;
-        } else {
-            grid = IGRAPH_LAYOUT_NOGRID;
-        }
-    }
-
     if (grid == IGRAPH_LAYOUT_GRID) {
         return igraph_layout_i_grid_fr(graph, res, use_seed, niter, start_temp,
                                        weight, minx, maxx, miny, maxy);
     } else {
+        igraph_bool_t barnes_hut =
+            grid == IGRAPH_LAYOUT_AUTOGRID && no_nodes > IGRAPH_I_BH_MIN_VERTICES;
         return igraph_layout_i_fr(graph, res, use_seed, niter, start_temp,
-                                  weight, minx, maxx, miny, maxy);
+                                  weight, minx, maxx, miny, maxy, barnes_hut);
     }
 }
 
@@ -477,7 +489,10 @@ igraph_error_t igraph_layout_fruchterman_reingold(const igraph_t *graph,
  *
  * Time complexity: O(|V|^2) in each
  * iteration, |V| is the number of
- * vertices in the graph.
+ * vertices in the graph. For graphs with more than 1000 vertices, the
+ * repulsion is approximated with a Barnes-Hut tree, see
+ * \ref igraph_layout_fruchterman_reingold(), and the time complexity is
+ * O(|V| log |V| + |E|) per iteration.
  *
  */
 
@@ -498,10 +513,14 @@ igraph_error_t igraph_layout_fruchterman_reingold_3d(const igraph_t *graph,
     const igraph_integer_t no_edges = igraph_ecount(graph);
     igraph_integer_t i;
     igraph_vector_t dispx, dispy, dispz;
+    igraph_vector_t *disp[3] = { &dispx, &dispy, &dispz };
     igraph_real_t temp = start_temp;
     igraph_real_t difftemp = start_temp / niter;
     igraph_bool_t conn = true;
     igraph_real_t C = 0;
+    igraph_bool_t barnes_hut = no_nodes > IGRAPH_I_BH_MIN_VERTICES;
+    igraph_i_bh_tree_t tree;
+    igraph_i_bh_kernel_t kernel = { /* scale = */ 1, /* power = */ 1, /* linear = */ 0, /* cutoff = */ 0 };
 
     if (niter < 0) {
         IGRAPH_ERROR("Number of iterations must be non-negative in "
@@ -552,6 +571,7 @@ igraph_error_t igraph_layout_fruchterman_reingold_3d(const igraph_t *graph,
     IGRAPH_CHECK(igraph_is_connected(graph, &conn, IGRAPH_WEAK));
     if (!conn) {
         C = no_nodes * sqrt(no_nodes);
+        kernel.linear = 1 / C;
     }
 
     RNG_BEGIN();
@@ -563,6 +583,8 @@ igraph_error_t igraph_layout_fruchterman_reingold_3d(const igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(&dispx, no_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&dispy, no_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&dispz, no_nodes);
+    IGRAPH_CHECK(igraph_i_bh_tree_init(&tree, barnes_hut ? no_nodes : 0, 3));
+    IGRAPH_FINALLY(igraph_i_bh_tree_destroy, &tree);
 
     for (i = 0; i < niter; i++) {
         igraph_integer_t v, u, e;
@@ -574,7 +596,10 @@ igraph_error_t igraph_layout_fruchterman_reingold_3d(const igraph_t *graph,
         igraph_vector_null(&dispx);
         igraph_vector_null(&dispy);
         igraph_vector_null(&dispz);
-        if (conn) {
+        if (barnes_hut) {
+            IGRAPH_CHECK(igraph_i_bh_tree_build(&tree, res));
+            igraph_i_bh_tree_forces(&tree, &kernel, IGRAPH_I_BH_THETA, disp);
+        } else if (conn) {
             for (v = 0; v < no_nodes; v++) {
                 for (u = v + 1; u < no_nodes; u++) {
                     igraph_real_t dx = MATRIX(*res, v, 0) - MATRIX(*res, u, 0);
@@ -687,10 +712,11 @@ igraph_error_t igraph_layout_fruchterman_reingold_3d(const igraph_t *graph,
 
     RNG_END();
 
+    igraph_i_bh_tree_destroy(&tree);
     igraph_vector_destroy(&dispx);
     igraph_vector_destroy(&dispy);
     igraph_vector_destroy(&dispz);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(4);
 
     return IGRAPH_SUCCESS;
 }
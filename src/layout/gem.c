@@ -29,6 +29,7 @@
 
 #include "core/interruption.h"
 #include "core/math.h"
+#include "layout/barnes_hut.h"
 
 /**
  * \ingroup layout
@@ -61,9 +62,16 @@
  *        vertices.
  * \return Error code.
  *
+ * </para><para>
+ * For graphs with more than 1000 vertices, the repulsion between the
+ * vertices is approximated with a Barnes-Hut tree, which is rebuilt after
+ * every vertex has been updated once.
+ *
  * Time complexity: O(t * n * (n+e)), where n is the number of vertices,
  * e is the number of edges and t is the number of time steps
- * performed.
+ * performed. With the Barnes-Hut approximation, the repulsion takes
+ * O(log n) time per step instead of O(n), plus O(n log n) for each
+ * rebuild.
  */
 
 igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
@@ -86,6 +94,9 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
     const igraph_real_t alpha_r = M_PI / 3.0;
     const igraph_real_t sigma_o = 1.0 / 3.0;
     const igraph_real_t sigma_r = 1.0 / 2.0 / no_nodes;
+    const igraph_bool_t barnes_hut = no_nodes > IGRAPH_I_BH_MIN_VERTICES;
+    igraph_i_bh_tree_t tree;
+    igraph_i_bh_kernel_t kernel = { /* scale = */ elen_des2, /* power = */ 1, /* linear = */ 0, /* cutoff = */ 0 };
 
     if (maxiter < 0) {
         IGRAPH_ERRORF("Number of iterations must be non-negative in GEM layout, "
@@ -130,6 +141,8 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_FINALLY(igraph_vector_int_destroy, &perm);
     IGRAPH_VECTOR_INIT_FINALLY(&phi, no_nodes);
     IGRAPH_VECTOR_INT_INIT_FINALLY(&neis, 10);
+    IGRAPH_CHECK(igraph_i_bh_tree_init(&tree, barnes_hut ? no_nodes : 0, 2));
+    IGRAPH_FINALLY(igraph_i_bh_tree_destroy, &tree);
 
     RNG_BEGIN();
 
@@ -166,6 +179,9 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
         if (perm_pointer <= 0) {
             igraph_vector_int_shuffle(&perm);
             perm_pointer = no_nodes - 1;
+            if (barnes_hut) {
+                IGRAPH_CHECK(igraph_i_bh_tree_build(&tree, res));
+            }
         }
         v = VECTOR(perm)[perm_pointer--];
 
@@ -175,17 +191,24 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
         px += RNG_UNIF(-32.0, 32.0);
         py += RNG_UNIF(-32.0, 32.0);
 
-        for (u = 0; u < no_nodes; u++) {
-            igraph_real_t dx, dy, dist2;
-            if (u == v) {
-                continue;
-            }
-            dx = MATRIX(*res, v, 0) - MATRIX(*res, u, 0);
-            dy = MATRIX(*res, v, 1) - MATRIX(*res, u, 1);
-            dist2 = dx * dx + dy * dy;
-            if (dist2 != 0) {
-                px += dx * elen_des2 / dist2;
-                py += dy * elen_des2 / dist2;
+        if (barnes_hut) {
+            igraph_real_t force[2];
+            igraph_i_bh_tree_force(&tree, v, &kernel, IGRAPH_I_BH_THETA, force);
+            px += force[0];
+            py += force[1];
+        } else {
+            for (u = 0; u < no_nodes; u++) {
+                igraph_real_t dx, dy, dist2;
+                if (u == v) {
+                    continue;
+                }
+                dx = MATRIX(*res, v, 0) - MATRIX(*res, u, 0);
+                dy = MATRIX(*res, v, 1) - MATRIX(*res, u, 1);
+                dist2 = dx * dx + dy * dy;
+                if (dist2 != 0) {
+                    px += dx * elen_des2 / dist2;
+                    py += dy * elen_des2 / dist2;
+                }
             }
         }
 
@@ -209,6 +232,10 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
             MATRIX(*res, v, 1) += py;
             barycenter_x += px;
             barycenter_y += py;
+            if (barnes_hut) {
+                igraph_real_t delta[2] = { px, py };
+                igraph_i_bh_tree_move(&tree, v, delta);
+            }
         }
 
         pvx = VECTOR(impulse_x)[v]; pvy = VECTOR(impulse_y)[v];
@@ -241,6 +268,7 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
 
     RNG_END();
 
+    igraph_i_bh_tree_destroy(&tree);
     igraph_vector_int_destroy(&neis);
     igraph_vector_destroy(&phi);
     igraph_vector_int_destroy(&perm);
@@ -248,7 +276,7 @@ igraph_error_t igraph_layout_gem(const igraph_t *graph, igraph_matrix_t *res,
     igraph_vector_destroy(&temp);
     igraph_vector_destroy(&impulse_y);
     igraph_vector_destroy(&impulse_x);
-    IGRAPH_FINALLY_CLEAN(7);
+    IGRAPH_FINALLY_CLEAN(8);
 
     return IGRAPH_SUCCESS;
 }
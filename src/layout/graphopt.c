@@ -27,6 +27,7 @@
 #include "igraph_progress.h"
 
 #include "core/interruption.h"
+#include "layout/barnes_hut.h"
 
 #define COULOMBS_CONSTANT 8987500000.0
 
@@ -332,9 +333,15 @@ static void igraph_i_move_nodes(
  *    a starting configuration. See also \p res above.
  * \return Error code.
  *
+ * </para><para>
+ * For graphs with more than 1000 vertices, the electrical forces are
+ * approximated with a Barnes-Hut tree, which is computed in parallel when
+ * igraph is built with OpenMP support.
+ *
  * Time complexity: O(n (|V|^2+|E|) ), n is the number of iterations,
  * |V| is the number of vertices, |E| the number
  * of edges. If \p node_charge is zero then it is only O(n|E|).
+ * With the Barnes-Hut approximation, it is O(n (|V| log |V| + |E|)).
  */
 igraph_error_t igraph_layout_graphopt(const igraph_t *graph, igraph_matrix_t *res,
                            igraph_integer_t niter,
@@ -354,9 +361,20 @@ igraph_error_t igraph_layout_graphopt(const igraph_t *graph, igraph_matrix_t *re
     igraph_integer_t this_node, other_node, edge;
     igraph_real_t distance;
     igraph_integer_t i;
+    igraph_vector_t *pending_forces[2] = { &pending_forces_x, &pending_forces_y };
+    /* Approximate the electrical forces in large graphs, with the same
+     * cutoff distance as below. */
+    igraph_bool_t barnes_hut = apply_electric_charges && no_of_nodes > IGRAPH_I_BH_MIN_VERTICES;
+    igraph_i_bh_tree_t tree;
+    igraph_i_bh_kernel_t kernel = {
+        /* scale = */ COULOMBS_CONSTANT * node_charge * node_charge, /* power = */ 2,
+        /* linear = */ 0, /* cutoff = */ 500.0
+    };
 
     IGRAPH_VECTOR_INIT_FINALLY(&pending_forces_x, no_of_nodes);
     IGRAPH_VECTOR_INIT_FINALLY(&pending_forces_y, no_of_nodes);
+    IGRAPH_CHECK(igraph_i_bh_tree_init(&tree, barnes_hut ? no_of_nodes : 0, 2));
+    IGRAPH_FINALLY(igraph_i_bh_tree_destroy, &tree);
 
     if (use_seed) {
         if (igraph_matrix_nrow(res) != no_of_nodes ||
@@ -380,7 +398,11 @@ igraph_error_t igraph_layout_graphopt(const igraph_t *graph, igraph_matrix_t *re
         igraph_vector_null(&pending_forces_y);
 
         // Apply electrical force applied by all other nodes
-        if (apply_electric_charges) {
+        if (barnes_hut) {
+            IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_CHECK(igraph_i_bh_tree_build(&tree, res));
+            igraph_i_bh_tree_forces(&tree, &kernel, IGRAPH_I_BH_THETA, pending_forces);
+        } else if (apply_electric_charges) {
             // Iterate through all nodes
             for (this_node = 0; this_node < no_of_nodes; this_node++) {
                 IGRAPH_ALLOW_INTERRUPTION();
@@ -426,9 +448,10 @@ igraph_error_t igraph_layout_graphopt(const igraph_t *graph, igraph_matrix_t *re
     }
     IGRAPH_PROGRESS("Graphopt layout", 100, NULL);
 
+    igraph_i_bh_tree_destroy(&tree);
     igraph_vector_destroy(&pending_forces_y);
     igraph_vector_destroy(&pending_forces_x);
-    IGRAPH_FINALLY_CLEAN(2);
+    IGRAPH_FINALLY_CLEAN(3);
 
     return IGRAPH_SUCCESS;
 }
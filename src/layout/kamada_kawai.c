@@ -23,15 +23,244 @@
 
 #include "igraph_layout.h"
 
+#include "igraph_adjlist.h"
 #include "igraph_interface.h"
 #include "igraph_paths.h"
 
 #include "core/interruption.h"
+#include "core/parallel.h"
 #include "layout/layout_internal.h"
 
 /* Energy gradient values below this threshold are considered to be zero. */
 #define KK_EPS 1e-13
 
+/* Graphs with more vertices than this are laid out with the sparse
+ * stress model, which uses distances from KK_PIVOTS pivot vertices only. */
+#define KK_SPARSE_MIN_VERTICES 1000
+#define KK_PIVOTS 50
+
+/* Sparse stress model (Ortmann, Klimenta and Brandes, 2016) for large
+ * graphs. The energy keeps the springs of the edges, with the edge weights
+ * as their lengths, and replaces all other springs by springs to k pivots.
+ * Each vertex is assigned to its closest pivot. The spring between vertex i
+ * and pivot p stands for the springs between i and the vertices assigned to
+ * p that are closer to p than half of the distance of i and p, and its
+ * strength is multiplied by their number. The energy is minimized by stress
+ * majorization: in each sweep, every vertex moves to the position that
+ * minimizes the energy if the other vertices stay in place. These moves are
+ * computed from the positions of the previous sweep, in parallel.
+ *
+ * 'bounds' holds the minimum and maximum coordinate vectors (or NULLs)
+ * of each dimension. If 'init' is true, the initial layout is computed with
+ * pivot MDS. Each sweep moves all vertices, therefore maxiter / |V| sweeps
+ * are done. */
+static igraph_error_t igraph_i_layout_kamada_kawai_sparse(
+        const igraph_t *graph, igraph_matrix_t *res, igraph_integer_t dim,
+        igraph_bool_t init, igraph_integer_t maxiter, igraph_real_t epsilon,
+        igraph_real_t kkconst, const igraph_vector_t *weights,
+        const igraph_vector_t *const *bounds) {
+
+    igraph_integer_t no_nodes = igraph_vcount(graph);
+    igraph_integer_t no_pivots;
+    igraph_integer_t no_sweeps = maxiter / no_nodes + (maxiter % no_nodes != 0);
+    igraph_real_t L, L0 = sqrt(no_nodes), max_dist = 0;
+    igraph_vector_int_t pivots, region, region_start;
+    igraph_vector_t region_dist;
+    igraph_matrix_t dist, kip, newpos;
+    igraph_csr_adjlist_t al;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&pivots, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&dist, 0, 0);
+    IGRAPH_CHECK(igraph_i_layout_maxmin_pivots(graph, weights, KK_PIVOTS, &pivots, &dist));
+    no_pivots = igraph_vector_int_size(&pivots);
+
+    /* As in the exact version, the distance of disconnected vertices is the
+     * largest distance in the graph, estimated from the pivots. */
+    for (igraph_integer_t p = 0; p < no_pivots; p++) {
+        for (igraph_integer_t i = 0; i < no_nodes; i++) {
+            if (isfinite(MATRIX(dist, i, p)) && MATRIX(dist, i, p) > max_dist) {
+                max_dist = MATRIX(dist, i, p);
+            }
+        }
+    }
+    if (max_dist == 0) {
+        max_dist = 1;
+    }
+    for (igraph_integer_t p = 0; p < no_pivots; p++) {
+        for (igraph_integer_t i = 0; i < no_nodes; i++) {
+            if (MATRIX(dist, i, p) > max_dist) {
+                MATRIX(dist, i, p) = max_dist;
+            }
+        }
+    }
+    L = L0 / max_dist;
+
+    if (init) {
+        IGRAPH_CHECK(igraph_i_layout_pivot_mds(&dist, &pivots, dim, res));
+        igraph_matrix_scale(res, L);
+    }
+
+    /* Regions of the pivots: the vertices of region p are
+     * region[region_start[p]] ... region[region_start[p + 1] - 1], sorted
+     * by their distance from p, which is stored in region_dist. */
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&region, no_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&region_start, no_pivots + 1);
+    IGRAPH_VECTOR_INIT_FINALLY(&region_dist, no_nodes);
+    {
+        igraph_vector_int_t closest, order;
+        IGRAPH_VECTOR_INT_INIT_FINALLY(&closest, no_nodes);
+        IGRAPH_VECTOR_INT_INIT_FINALLY(&order, 0);
+        for (igraph_integer_t i = 0; i < no_nodes; i++) {
+            igraph_integer_t best = 0;
+            for (igraph_integer_t p = 1; p < no_pivots; p++) {
+                if (MATRIX(dist, i, p) < MATRIX(dist, i, best)) {
+                    best = p;
+                }
+            }
+            VECTOR(closest)[i] = best;
+            VECTOR(region_start)[best + 1]++;
+        }
+        for (igraph_integer_t p = 0; p < no_pivots; p++) {
+            VECTOR(region_start)[p + 1] += VECTOR(region_start)[p];
+        }
+        /* Order by distance from the closest pivot, then stably by pivot */
+        for (igraph_integer_t i = 0; i < no_nodes; i++) {
+            VECTOR(region_dist)[i] = MATRIX(dist, i, VECTOR(closest)[i]);
+        }
+        IGRAPH_CHECK(igraph_vector_qsort_ind(&region_dist, &order, IGRAPH_ASCENDING));
+        {
+            igraph_vector_int_t next;
+            IGRAPH_CHECK(igraph_vector_int_init_copy(&next, &region_start));
+            IGRAPH_FINALLY(igraph_vector_int_destroy, &next);
+            for (igraph_integer_t j = 0; j < no_nodes; j++) {
+                igraph_integer_t i = VECTOR(order)[j];
+                igraph_integer_t pos = VECTOR(next)[ VECTOR(closest)[i] ]++;
+                VECTOR(region)[pos] = i;
+            }
+            igraph_vector_int_destroy(&next);
+            IGRAPH_FINALLY_CLEAN(1);
+        }
+        for (igraph_integer_t j = 0; j < no_nodes; j++) {
+            igraph_integer_t i = VECTOR(region)[j];
+            VECTOR(region_dist)[j] = MATRIX(dist, i, VECTOR(closest)[i]);
+        }
+        igraph_vector_int_destroy(&order);
+        igraph_vector_int_destroy(&closest);
+        IGRAPH_FINALLY_CLEAN(2);
+    }
+
+    /* Spring constants towards the pivots */
+    IGRAPH_MATRIX_INIT_FINALLY(&kip, no_nodes, no_pivots);
+    IGRAPH_I_OMP(omp parallel for schedule(static))
+    for (igraph_integer_t i = 0; i < no_nodes; i++) {
+        for (igraph_integer_t p = 0; p < no_pivots; p++) {
+            igraph_real_t d = MATRIX(dist, i, p);
+            igraph_integer_t lo = VECTOR(region_start)[p], hi = VECTOR(region_start)[p + 1];
+            if (d == 0) {
+                continue;
+            }
+            /* Number of region vertices with distance at most d / 2 */
+            while (lo < hi) {
+                igraph_integer_t mid = lo + (hi - lo) / 2;
+                if (VECTOR(region_dist)[mid] <= d / 2) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            lo -= VECTOR(region_start)[p];
+            MATRIX(kip, i, p) = kkconst * (lo > 0 ? lo : 1) / (d * d);
+        }
+    }
+
+    if (weights) {
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &al, IGRAPH_ALL, IGRAPH_NO_LOOPS));
+    } else {
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &al, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_MULTIPLE));
+    }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &al);
+    IGRAPH_MATRIX_INIT_FINALLY(&newpos, no_nodes, dim);
+
+    for (igraph_integer_t sweep = 0; sweep < no_sweeps; sweep++) {
+        igraph_real_t max_delta = 0;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_I_OMP(omp parallel for schedule(dynamic, 256) reduction(max: max_delta))
+        for (igraph_integer_t i = 0; i < no_nodes; i++) {
+            /* Sum of the spring constants, the energy gradient, and the sum
+             * of the positions that the springs would move i to. */
+            igraph_real_t ksum = 0, grad[3] = { 0, 0, 0 }, target[3] = { 0, 0, 0 };
+            igraph_real_t delta = 0;
+            igraph_integer_t n = igraph_csr_adjlist_degree(&al, i);
+            const igraph_integer_t *neis = igraph_csr_adjlist_get(&al, i);
+            const igraph_integer_t *eids = weights ? igraph_csr_adjlist_get_eids(&al, i) : NULL;
+
+            for (igraph_integer_t j = 0; j < n + no_pivots; j++) {
+                igraph_integer_t u;
+                igraph_real_t k, l, diff[3], d = 0;
+                if (j < n) {
+                    igraph_real_t w = weights ? VECTOR(*weights)[ eids[j] ] : 1;
+                    u = neis[j];
+                    k = kkconst / (w * w);
+                    l = L * w;
+                } else {
+                    igraph_integer_t p = j - n;
+                    u = VECTOR(pivots)[p];
+                    k = MATRIX(kip, i, p);
+                    l = L * MATRIX(dist, i, p);
+                    if (k == 0) {
+                        continue;
+                    }
+                }
+                for (igraph_integer_t c = 0; c < dim; c++) {
+                    diff[c] = MATRIX(*res, i, c) - MATRIX(*res, u, c);
+                    d += diff[c] * diff[c];
+                }
+                d = sqrt(d);
+                ksum += k;
+                for (igraph_integer_t c = 0; c < dim; c++) {
+                    igraph_real_t stretch = d > 0 ? l * diff[c] / d : 0;
+                    grad[c] += k * (diff[c] - stretch);
+                    target[c] += k * (MATRIX(*res, u, c) + stretch);
+                }
+            }
+
+            for (igraph_integer_t c = 0; c < dim; c++) {
+                igraph_real_t x = ksum > 0 ? target[c] / ksum : MATRIX(*res, i, c);
+                if (bounds[2 * c] && x < VECTOR(*bounds[2 * c])[i]) {
+                    x = VECTOR(*bounds[2 * c])[i];
+                }
+                if (bounds[2 * c + 1] && x > VECTOR(*bounds[2 * c + 1])[i]) {
+                    x = VECTOR(*bounds[2 * c + 1])[i];
+                }
+                MATRIX(newpos, i, c) = x;
+                delta += grad[c] * grad[c];
+            }
+            if (delta > max_delta) {
+                max_delta = delta;
+            }
+        }
+
+        if (max_delta < epsilon) {
+            break;
+        }
+        IGRAPH_CHECK(igraph_matrix_swap(res, &newpos));
+    }
+
+    igraph_matrix_destroy(&newpos);
+    igraph_csr_adjlist_destroy(&al);
+    igraph_matrix_destroy(&kip);
+    igraph_vector_destroy(&region_dist);
+    igraph_vector_int_destroy(&region_start);
+    igraph_vector_int_destroy(&region);
+    igraph_matrix_destroy(&dist);
+    igraph_vector_int_destroy(&pivots);
+    IGRAPH_FINALLY_CLEAN(8);
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \ingroup layout
  * \function igraph_layout_kamada_kawai
@@ -50,11 +279,17 @@
  * such as lattices.
  *
  * </para><para>
- * This layout algorithm is not suitable for large graphs. The memory
- * requirements are of the order O(|V|^2).
+ * The exact algorithm needs the distances between all pairs of vertices,
+ * which takes O(|V|^2) memory. Therefore graphs with more than 1000
+ * vertices are laid out with the sparse stress model of Ortmann et al.
+ * instead: the springs between non-adjacent vertices are replaced by
+ * springs to 50 pivot vertices, which stand for the vertices close to them.
+ * The energy is minimized by stress majorization, which moves all
+ * vertices in each step, in parallel when igraph is built with OpenMP
+ * support. In this mode, \p maxiter / |V| such steps are performed.
  *
  * </para><para>
- * Reference:
+ * References:
  *
  * </para><para>
  * Kamada, T. and Kawai, S.:
@@ -62,6 +297,12 @@
  * Information Processing Letters, 31/1, 7--15, 1989.
  * https://doi.org/10.1016/0020-0190(89)90102-6
  *
+ * </para><para>
+ * Ortmann, M., Klimenta, M. and Brandes, U.:
+ * A Sparse Stress Model.
+ * Journal of Graph Algorithms and Applications, 21/5, 791--821, 2017.
+ * https://doi.org/10.7155/jgaa.00440
+ *
  * \param graph A graph object.
  * \param res Pointer to an initialized matrix object. This will
  *        contain the result (x-positions in column zero and
@@ -70,7 +311,8 @@
  *        \p res argument as the initial configuration. If zero and there
  *        are any limits on the X or Y coordinates, then a random initial
  *        configuration is used. Otherwise the vertices are placed on a
- *        circle of radius 1 as the initial configuration.
+ *        circle of radius 1 as the initial configuration, or, for large
+ *        graphs, according to a pivot MDS layout.
  * \param maxiter The maximum number of iterations to perform. A reasonable
  *        default value is at least ten (or more) times the number of
  *        vertices.
@@ -96,7 +338,8 @@
  *
  * Time complexity: O(|V|) for each iteration, after an O(|V|^2
  * log|V|) initialization step. |V| is the number of vertices in the
- * graph.
+ * graph. For large graphs, O(|V| + |E|) per iteration on average, after
+ * an O((|V| + |E|) log |V|) initialization step.
  */
 
 igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t *res,
@@ -157,7 +400,7 @@ igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t
     if (!use_seed) {
         if (minx || maxx || miny || maxy) {
             igraph_i_layout_random_bounded(graph, res, minx, maxx, miny, maxy);
-        } else {
+        } else if (no_nodes <= KK_SPARSE_MIN_VERTICES) {
             igraph_layout_circle(graph, res, /* order= */ igraph_vss_all());
             /* The original paper recommends using a radius of 0.5*L0 here.
              * The coefficient of 0.36 was chosen empirically so that this initial
@@ -171,6 +414,13 @@ igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t
         return IGRAPH_SUCCESS;
     }
 
+    if (no_nodes > KK_SPARSE_MIN_VERTICES) {
+        const igraph_vector_t *bounds[4] = { minx, maxx, miny, maxy };
+        return igraph_i_layout_kamada_kawai_sparse(
+                   graph, res, 2, /* init = */ !use_seed && !(minx || maxx || miny || maxy),
+                   maxiter, epsilon, kkconst, weights, bounds);
+    }
+
     IGRAPH_MATRIX_INIT_FINALLY(&dij, no_nodes, no_nodes);
     IGRAPH_MATRIX_INIT_FINALLY(&kij, no_nodes, no_nodes);
     IGRAPH_MATRIX_INIT_FINALLY(&lij, no_nodes, no_nodes);
@@ -360,8 +610,8 @@ igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t
  * See the documentation of that function for more information.
  *
  * </para><para>
- * This layout algorithm is not suitable for large graphs. The memory
- * requirements are of the order O(|V|^2).
+ * Graphs with more than 1000 vertices are laid out with the sparse stress
+ * model, as in the 2D version.
  *
  * \param graph A graph object.
  * \param res Pointer to an initialized matrix object. This will
@@ -371,7 +621,8 @@ igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t
  *        \p res argument as the initial configuration. If zero and there
  *        are any limits on the z, y or z coordinates, then a random initial
  *        configuration is used. Otherwise the vertices are placed uniformly
- *        on a sphere of radius 1 as the initial configuration.
+ *        on a sphere of radius 1 as the initial configuration, or, for
+ *        large graphs, according to a pivot MDS layout.
  * \param maxiter The maximum number of iterations to perform. A reasonable
  *        default value is at least ten (or more) times the number of
  *        vertices.
@@ -402,7 +653,8 @@ igraph_error_t igraph_layout_kamada_kawai(const igraph_t *graph, igraph_matrix_t
  *
  * Time complexity: O(|V|) for each iteration, after an O(|V|^2
  * log|V|) initialization step. |V| is the number of vertices in the
- * graph.
+ * graph. For large graphs, O(|V| + |E|) per iteration on average, after
+ * an O((|V| + |E|) log |V|) initialization step.
  */
 
 igraph_error_t igraph_layout_kamada_kawai_3d(const igraph_t *graph, igraph_matrix_t *res,
@@ -473,7 +725,7 @@ igraph_error_t igraph_layout_kamada_kawai_3d(const igraph_t *graph, igraph_matri
     if (!use_seed) {
         if (minx || maxx || miny || maxy || minz || maxz) {
             igraph_i_layout_random_bounded_3d(graph, res, minx, maxx, miny, maxy, minz, maxz);
-        } else {
+        } else if (no_nodes <= KK_SPARSE_MIN_VERTICES) {
             igraph_layout_sphere(graph, res);
             /* The coefficient of 0.36 was chosen empirically so that this initial layout
              * would be as close as possible to the equilibrium layout when the graph is
@@ -486,6 +738,13 @@ igraph_error_t igraph_layout_kamada_kawai_3d(const igraph_t *graph, igraph_matri
         return IGRAPH_SUCCESS;
     }
 
+    if (no_nodes > KK_SPARSE_MIN_VERTICES) {
+        const igraph_vector_t *bounds[6] = { minx, maxx, miny, maxy, minz, maxz };
+        return igraph_i_layout_kamada_kawai_sparse(
+                   graph, res, 3, /* init = */ !use_seed && !(minx || maxx || miny || maxy || minz || maxz),
+                   maxiter, epsilon, kkconst, weights, bounds);
+    }
+
     IGRAPH_MATRIX_INIT_FINALLY(&dij, no_nodes, no_nodes);
     IGRAPH_MATRIX_INIT_FINALLY(&kij, no_nodes, no_nodes);
     IGRAPH_MATRIX_INIT_FINALLY(&lij, no_nodes, no_nodes);
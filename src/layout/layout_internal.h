@@ -28,6 +28,7 @@
 #include "igraph_error.h"
 #include "igraph_types.h"
 #include "igraph_matrix.h"
+#include "igraph_vector_list.h"
 
 #include "layout/merge_grid.h"
 
@@ -58,6 +59,21 @@ IGRAPH_PRIVATE_EXPORT igraph_error_t igraph_i_umap_fit_ab(igraph_real_t min_dist
                                                           igraph_real_t *a_p,
                                                           igraph_real_t *b_p);
 
+igraph_error_t igraph_i_layout_pivot_distances(const igraph_t *graph,
+                                               const igraph_vector_t *weights,
+                                               const igraph_vector_int_list_t *pivots,
+                                               igraph_matrix_t *dist);
+
+igraph_error_t igraph_i_layout_maxmin_pivots(const igraph_t *graph,
+                                             const igraph_vector_t *weights,
+                                             igraph_integer_t k,
+                                             igraph_vector_int_t *pivots,
+                                             igraph_matrix_t *dist);
+
+igraph_error_t igraph_i_layout_pivot_mds(const igraph_matrix_t *dist,
+                                         const igraph_vector_int_t *pivots,
+                                         igraph_integer_t dim, igraph_matrix_t *res);
+
 igraph_error_t igraph_i_layout_random_bounded(
         const igraph_t *graph, igraph_matrix_t *res,
         const igraph_vector_t *minx, const igraph_vector_t *maxx,
@@ -28,11 +28,15 @@
 #include "igraph_eigen.h"
 #include "igraph_interface.h"
 #include "igraph_memory.h"
+#include "igraph_nongraph.h"
 #include "igraph_operators.h"
 #include "igraph_paths.h"
 #include "igraph_random.h"
 #include "igraph_structural.h"
 
+#include "core/interruption.h"
+#include "layout/layout_internal.h"
+
 #include <limits.h>
 
 static igraph_error_t igraph_i_layout_mds_step(igraph_real_t *to, const igraph_real_t *from,
@@ -169,6 +173,11 @@ igraph_error_t igraph_i_layout_mds_single(const igraph_t* graph, igraph_matrix_t
  * classical multidimensional scaling may assign the same coordinates to
  * these vertices.
  *
+ * </para><para>
+ * The distance matrix takes O(|V|^2) memory. For large graphs, use
+ * \ref igraph_layout_pivot_mds(), which approximates this layout from the
+ * distances to a few pivot vertices.
+ *
  * \param graph A graph object.
  * \param res Pointer to an initialized matrix object. This will
  *        contain the result and will be resized if needed.
@@ -302,3 +311,207 @@ igraph_error_t igraph_layout_mds(const igraph_t* graph, igraph_matrix_t *res,
 
     return IGRAPH_SUCCESS;
 }
+
+/**
+ * \function igraph_layout_pivot_mds
+ * \brief Multidimensional scaling from the distances to a few pivot vertices.
+ *
+ * \experimental
+ *
+ * </para><para>
+ * Classical multidimensional scaling, as done by \ref igraph_layout_mds(),
+ * needs the matrix of all pairwise distances, which takes O(|V|^2) time
+ * and memory. Pivot MDS, proposed by Brandes and Pich, approximates it
+ * from the distances of all vertices to a small number of pivot vertices
+ * only: the |V| x k matrix of these distances is double centered, and the
+ * layout is spanned by the images of the top eigenvectors of its k x k
+ * cross product matrix. The layout is finally scaled so that the Euclidean
+ * distances of the vertices from the pivots match their graph distances in
+ * the least squares sense. The layout of a graph with millions of vertices
+ * can be computed this way in seconds; the result is often a good starting
+ * point for force-directed layouts.
+ *
+ * </para><para>
+ * The pivots are sampled uniformly at random from each connected component,
+ * and the shortest path searches from them run in parallel when igraph is
+ * built with OpenMP support. If the graph is disconnected, the components
+ * are laid out separately and their layouts are merged with
+ * \ref igraph_layout_merge_dla(). This is only supported in two dimensions.
+ *
+ * </para><para>
+ * Reference:
+ *
+ * </para><para>
+ * Brandes, U. and Pich, C.:
+ * Eigensolver Methods for Progressive Multidimensional Scaling of Large Data.
+ * Graph Drawing 2006, Lecture Notes in Computer Science 4372, 42--53, 2007.
+ * https://doi.org/10.1007/978-3-540-70904-6_6
+ *
+ * \param graph A graph object. Edge directions are ignored.
+ * \param res Pointer to an initialized matrix object. This will
+ *        contain the result and will be resized if needed.
+ * \param dim The number of dimensions in the embedding space. For
+ *        2D layouts, supply 2 here.
+ * \param no_of_pivots The number of pivots to use in each connected
+ *        component. All vertices of smaller components are used as pivots.
+ *        It must not be smaller than \p dim. Brandes and Pich found 50
+ *        pivots to be enough for most graphs.
+ * \param weights Edge weights, used as edge lengths when computing the
+ *        distances. Weights must be positive. Pass \c NULL to use
+ *        unit lengths.
+ * \return Error code.
+ *
+ * Time complexity: O(k (|V| + |E|) + k^2 |V|) for unweighted graphs, and
+ * O(k (|V| log |V| + |E|) + k^2 |V|) for weighted ones, where k is the
+ * number of pivots, plus the time of \ref igraph_layout_merge_dla() for
+ * disconnected graphs.
+ */
+
+igraph_error_t igraph_layout_pivot_mds(const igraph_t *graph, igraph_matrix_t *res,
+                                       igraph_integer_t dim, igraph_integer_t no_of_pivots,
+                                       const igraph_vector_t *weights) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_integer_t no_of_comps, max_comp_pivots = 0;
+    igraph_vector_int_t membership, csize;
+    igraph_vector_int_list_t vids, comp_pivots, pivot_sets;
+    igraph_matrix_t dist;
+
+    if (dim < 1) {
+        IGRAPH_ERRORF("Number of dimensions must be positive in pivot MDS layout, got %" IGRAPH_PRId ".",
+                      IGRAPH_EINVAL, dim);
+    }
+    if (no_of_pivots < dim) {
+        IGRAPH_ERRORF("Number of pivots (%" IGRAPH_PRId ") must not be smaller than the number "
+                      "of dimensions (%" IGRAPH_PRId ") in pivot MDS layout.",
+                      IGRAPH_EINVAL, no_of_pivots, dim);
+    }
+    if (weights && igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Invalid weight vector length.", IGRAPH_EINVAL);
+    }
+    if (weights && no_of_edges > 0 && !(igraph_vector_min(weights) > 0)) {
+        IGRAPH_ERROR("Weights must be positive for pivot MDS layout.", IGRAPH_EINVAL);
+    }
+
+    if (no_of_nodes == 0) {
+        IGRAPH_CHECK(igraph_matrix_resize(res, 0, dim));
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&membership, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&csize, 0);
+    IGRAPH_CHECK(igraph_connected_components(graph, &membership, &csize, &no_of_comps, IGRAPH_WEAK));
+
+    if (no_of_comps > 1 && dim != 2) {
+        IGRAPH_ERROR("Pivot MDS layout of disconnected graphs is only supported in two dimensions.",
+                     IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_list_init(&vids, no_of_comps));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &vids);
+    IGRAPH_CHECK(igraph_vector_int_list_init(&comp_pivots, no_of_comps));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &comp_pivots);
+    IGRAPH_CHECK(igraph_vector_int_list_init(&pivot_sets, 0));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &pivot_sets);
+    IGRAPH_MATRIX_INIT_FINALLY(&dist, 0, 0);
+
+    for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+        IGRAPH_CHECK(igraph_vector_int_reserve(igraph_vector_int_list_get_ptr(&vids, c), VECTOR(csize)[c]));
+    }
+    for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+        igraph_vector_int_push_back(igraph_vector_int_list_get_ptr(&vids, VECTOR(membership)[v]), v); /* reserved */
+    }
+
+    /* Sample the pivots of each component, as positions within its vertex
+     * list. The j-th pivots of all components form the j-th pivot set: the
+     * components are disjoint, so a single search from the whole set finds
+     * the distances from the j-th pivot within each component. */
+    RNG_BEGIN();
+    for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+        igraph_vector_int_t *pivots = igraph_vector_int_list_get_ptr(&comp_pivots, c);
+        igraph_integer_t n = VECTOR(csize)[c];
+        if (n <= no_of_pivots) {
+            IGRAPH_CHECK(igraph_vector_int_range(pivots, 0, n));
+        } else {
+            IGRAPH_CHECK(igraph_random_sample(pivots, 0, n - 1, no_of_pivots));
+        }
+        if (igraph_vector_int_size(pivots) > max_comp_pivots) {
+            max_comp_pivots = igraph_vector_int_size(pivots);
+        }
+    }
+    RNG_END();
+
+    IGRAPH_CHECK(igraph_vector_int_list_resize(&pivot_sets, max_comp_pivots));
+    for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+        const igraph_vector_int_t *comp_vids = igraph_vector_int_list_get_ptr(&vids, c);
+        const igraph_vector_int_t *pivots = igraph_vector_int_list_get_ptr(&comp_pivots, c);
+        igraph_integer_t k = igraph_vector_int_size(pivots);
+        for (igraph_integer_t j = 0; j < k; j++) {
+            IGRAPH_CHECK(igraph_vector_int_push_back(igraph_vector_int_list_get_ptr(&pivot_sets, j),
+                                                     VECTOR(*comp_vids)[ VECTOR(*pivots)[j] ]));
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_layout_pivot_distances(graph, weights, &pivot_sets, &dist));
+
+    if (no_of_comps == 1) {
+        /* The vertex list of the only component is the identity */
+        IGRAPH_CHECK(igraph_i_layout_pivot_mds(&dist, igraph_vector_int_list_get_ptr(&comp_pivots, 0),
+                                               dim, res));
+    } else {
+        igraph_matrix_list_t layouts;
+        igraph_matrix_t comp_dist, merged;
+
+        IGRAPH_CHECK(igraph_matrix_list_init(&layouts, no_of_comps));
+        IGRAPH_FINALLY(igraph_matrix_list_destroy, &layouts);
+        IGRAPH_MATRIX_INIT_FINALLY(&comp_dist, 0, 0);
+        IGRAPH_MATRIX_INIT_FINALLY(&merged, 0, 0);
+
+        for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+            const igraph_vector_int_t *comp_vids = igraph_vector_int_list_get_ptr(&vids, c);
+            const igraph_vector_int_t *pivots = igraph_vector_int_list_get_ptr(&comp_pivots, c);
+            igraph_integer_t n = igraph_vector_int_size(comp_vids);
+            igraph_integer_t k = igraph_vector_int_size(pivots);
+
+            IGRAPH_ALLOW_INTERRUPTION();
+
+            IGRAPH_CHECK(igraph_matrix_resize(&comp_dist, n, k));
+            for (igraph_integer_t j = 0; j < k; j++) {
+                for (igraph_integer_t i = 0; i < n; i++) {
+                    MATRIX(comp_dist, i, j) = MATRIX(dist, VECTOR(*comp_vids)[i], j);
+                }
+            }
+            IGRAPH_CHECK(igraph_i_layout_pivot_mds(&comp_dist, pivots, dim,
+                                                   igraph_matrix_list_get_ptr(&layouts, c)));
+        }
+
+        IGRAPH_CHECK(igraph_layout_merge_dla(NULL, &layouts, &merged));
+
+        /* igraph_layout_merge_dla() concatenates the layouts of the components */
+        IGRAPH_CHECK(igraph_matrix_resize(res, no_of_nodes, 2));
+        for (igraph_integer_t c = 0, row = 0; c < no_of_comps; c++) {
+            const igraph_vector_int_t *comp_vids = igraph_vector_int_list_get_ptr(&vids, c);
+            igraph_integer_t n = igraph_vector_int_size(comp_vids);
+            for (igraph_integer_t i = 0; i < n; i++, row++) {
+                MATRIX(*res, VECTOR(*comp_vids)[i], 0) = MATRIX(merged, row, 0);
+                MATRIX(*res, VECTOR(*comp_vids)[i], 1) = MATRIX(merged, row, 1);
+            }
+        }
+
+        igraph_matrix_destroy(&merged);
+        igraph_matrix_destroy(&comp_dist);
+        igraph_matrix_list_destroy(&layouts);
+        IGRAPH_FINALLY_CLEAN(3);
+    }
+
+    igraph_matrix_destroy(&dist);
+    igraph_vector_int_list_destroy(&pivot_sets);
+    igraph_vector_int_list_destroy(&comp_pivots);
+    igraph_vector_int_list_destroy(&vids);
+    igraph_vector_int_destroy(&csize);
+    igraph_vector_int_destroy(&membership);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return IGRAPH_SUCCESS;
+}
@@ -0,0 +1,413 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "igraph_layout.h"
+
+#include "igraph_adjlist.h"
+#include "igraph_components.h"
+#include "igraph_constructors.h"
+#include "igraph_graph_list.h"
+#include "igraph_interface.h"
+#include "igraph_operators.h"
+#include "igraph_random.h"
+
+#include "core/interruption.h"
+#include "operators/subgraph.h"
+
+#include <math.h>
+
+/* Coarsens a connected graph by collapsing the edges of a maximal matching,
+ * and attaching each unmatched vertex to the group of one of its matched
+ * neighbours. Every group thus has at least two vertices, so the coarse
+ * graph has at most half as many vertices as 'graph'. Vertices are matched
+ * to the neighbour of the smallest mass, i.e. the one representing the fewest
+ * vertices of the original graph, to keep the groups balanced. 'mass' is
+ * updated to the masses of the vertices of the coarse graph. */
+
+static igraph_error_t igraph_i_layout_multilevel_coarsen(
+        const igraph_t *graph, igraph_t *coarse,
+        igraph_vector_int_t *membership, igraph_vector_int_t *mass) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_integer_t no_of_groups = 0;
+    igraph_adjlist_t adjlist;
+    igraph_vector_int_t order, group_mass, edges;
+
+    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_NO_MULTIPLE));
+    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+    IGRAPH_CHECK(igraph_vector_int_init_range(&order, 0, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &order);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&group_mass, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&edges, 0);
+
+    IGRAPH_CHECK(igraph_vector_int_shuffle(&order));
+    IGRAPH_CHECK(igraph_vector_int_resize(membership, no_of_nodes));
+    igraph_vector_int_fill(membership, -1);
+
+    /* Maximal matching */
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t v = VECTOR(order)[i];
+        igraph_vector_int_t *neis = igraph_adjlist_get(&adjlist, v);
+        igraph_integer_t n = igraph_vector_int_size(neis);
+        igraph_integer_t best = -1;
+
+        if (VECTOR(*membership)[v] >= 0) {
+            continue;
+        }
+        for (igraph_integer_t j = 0; j < n; j++) {
+            igraph_integer_t u = VECTOR(*neis)[j];
+            if (VECTOR(*membership)[u] < 0 &&
+                (best < 0 || VECTOR(*mass)[u] < VECTOR(*mass)[best])) {
+                best = u;
+            }
+        }
+        if (best >= 0) {
+            VECTOR(*membership)[v] = VECTOR(*membership)[best] = no_of_groups++;
+            IGRAPH_CHECK(igraph_vector_int_push_back(&group_mass, VECTOR(*mass)[v] + VECTOR(*mass)[best]));
+        }
+    }
+
+    /* All neighbours of the unmatched vertices are matched */
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t v = VECTOR(order)[i];
+        igraph_vector_int_t *neis = igraph_adjlist_get(&adjlist, v);
+        igraph_integer_t n = igraph_vector_int_size(neis);
+        igraph_integer_t best = -1;
+
+        if (VECTOR(*membership)[v] >= 0) {
+            continue;
+        }
+        for (igraph_integer_t j = 0; j < n; j++) {
+            igraph_integer_t g = VECTOR(*membership)[ VECTOR(*neis)[j] ];
+            if (g >= 0 && (best < 0 || VECTOR(group_mass)[g] < VECTOR(group_mass)[best])) {
+                best = g;
+            }
+        }
+        if (best < 0) {
+            /* Isolated vertex, only possible if the graph has a single vertex */
+            best = no_of_groups++;
+            IGRAPH_CHECK(igraph_vector_int_push_back(&group_mass, 0));
+        }
+        VECTOR(*membership)[v] = best;
+        VECTOR(group_mass)[best] += VECTOR(*mass)[v];
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_reserve(&edges, 2 * no_of_edges));
+    for (igraph_integer_t e = 0; e < no_of_edges; e++) {
+        igraph_integer_t from = VECTOR(*membership)[ IGRAPH_FROM(graph, e) ];
+        igraph_integer_t to = VECTOR(*membership)[ IGRAPH_TO(graph, e) ];
+        if (from != to) {
+            igraph_vector_int_push_back(&edges, from); /* reserved */
+            igraph_vector_int_push_back(&edges, to); /* reserved */
+        }
+    }
+
+    IGRAPH_CHECK(igraph_create(coarse, &edges, no_of_groups, IGRAPH_UNDIRECTED));
+    IGRAPH_FINALLY(igraph_destroy, coarse);
+    IGRAPH_CHECK(igraph_simplify(coarse, /* multiple */ true, /* loops */ true, NULL));
+    IGRAPH_CHECK(igraph_vector_int_update(mass, &group_mass));
+
+    igraph_vector_int_destroy(&edges);
+    igraph_vector_int_destroy(&group_mass);
+    igraph_vector_int_destroy(&order);
+    igraph_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(5); /* + coarse */
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Runs the force-directed layout of a single level. */
+
+static igraph_error_t igraph_i_layout_multilevel_refine(
+        const igraph_t *graph, igraph_matrix_t *res, igraph_bool_t use_seed,
+        igraph_integer_t niter, igraph_layout_multilevel_refine_t refine) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+
+    switch (refine) {
+    case IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD:
+        /* Prolonged layouts only need local corrections, so they start
+         * from a lower temperature. */
+        return igraph_layout_fruchterman_reingold(
+                   graph, res, use_seed, niter,
+                   use_seed ? sqrt(no_of_nodes) / 10 : sqrt(no_of_nodes),
+                   IGRAPH_LAYOUT_AUTOGRID, NULL, NULL, NULL, NULL, NULL);
+    case IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT:
+        return igraph_layout_graphopt(graph, res, niter, 0.001, 30, 0, 1, 5, use_seed);
+    default:
+        IGRAPH_ERROR("Invalid refinement method for multilevel layout.", IGRAPH_EINVAL);
+    }
+}
+
+/* Places each vertex of a finer level at the position of its group in the
+ * coarse layout, with a small random offset. The coarse layout is first
+ * scaled up so that the area per vertex is roughly the same on both levels. */
+
+static void igraph_i_layout_multilevel_prolong(
+        const igraph_t *coarse, const igraph_matrix_t *coarse_layout,
+        const igraph_vector_int_t *membership, igraph_matrix_t *res) {
+
+    igraph_integer_t no_of_nodes = igraph_vector_int_size(membership);
+    igraph_integer_t no_of_groups = igraph_vcount(coarse);
+    igraph_integer_t no_of_edges = igraph_ecount(coarse);
+    igraph_real_t scale = sqrt((igraph_real_t) no_of_nodes / no_of_groups);
+    igraph_real_t edge_length = 0, jitter;
+
+    for (igraph_integer_t e = 0; e < no_of_edges; e++) {
+        igraph_integer_t from = IGRAPH_FROM(coarse, e), to = IGRAPH_TO(coarse, e);
+        igraph_real_t dx = MATRIX(*coarse_layout, from, 0) - MATRIX(*coarse_layout, to, 0);
+        igraph_real_t dy = MATRIX(*coarse_layout, from, 1) - MATRIX(*coarse_layout, to, 1);
+        edge_length += sqrt(dx * dx + dy * dy);
+    }
+    edge_length = no_of_edges > 0 ? scale * edge_length / no_of_edges : 1.0;
+    if (edge_length == 0) {
+        edge_length = 1.0;
+    }
+    jitter = edge_length / 4;
+
+    for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+        igraph_integer_t g = VECTOR(*membership)[v];
+        MATRIX(*res, v, 0) = scale * MATRIX(*coarse_layout, g, 0) + RNG_UNIF(-jitter, jitter);
+        MATRIX(*res, v, 1) = scale * MATRIX(*coarse_layout, g, 1) + RNG_UNIF(-jitter, jitter);
+    }
+}
+
+static igraph_error_t igraph_i_layout_multilevel_connected(
+        const igraph_t *graph, igraph_matrix_t *res, igraph_integer_t niter,
+        igraph_integer_t coarsest_size, igraph_layout_multilevel_refine_t refine) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_graph_list_t levels;
+    igraph_vector_int_list_t memberships;
+    igraph_vector_int_t mass;
+    igraph_matrix_t coarse_layout;
+    const igraph_t *current = graph;
+
+    IGRAPH_CHECK(igraph_graph_list_init(&levels, 0));
+    IGRAPH_FINALLY(igraph_graph_list_destroy, &levels);
+    IGRAPH_CHECK(igraph_vector_int_list_init(&memberships, 0));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &memberships);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&mass, no_of_nodes);
+    IGRAPH_MATRIX_INIT_FINALLY(&coarse_layout, 0, 0);
+
+    igraph_vector_int_fill(&mass, 1);
+
+    /* Coarsening phase: levels[i] is the coarsened version of levels[i-1],
+     * or of the input graph for i = 0, and memberships[i] maps the vertices
+     * of the finer graph to the ones of levels[i]. */
+    while (igraph_vcount(current) > coarsest_size) {
+        igraph_t coarse;
+        igraph_vector_int_t *membership;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_CHECK(igraph_vector_int_list_push_back_new(&memberships, &membership));
+        IGRAPH_CHECK(igraph_i_layout_multilevel_coarsen(current, &coarse, membership, &mass));
+        IGRAPH_FINALLY(igraph_destroy, &coarse);
+        IGRAPH_CHECK(igraph_graph_list_push_back(&levels, &coarse));
+        IGRAPH_FINALLY_CLEAN(1); /* ownership of coarse taken by levels */
+        current = igraph_graph_list_tail_ptr(&levels);
+    }
+
+    /* Layout of the coarsest graph, then prolongation and refinement */
+    IGRAPH_CHECK(igraph_i_layout_multilevel_refine(current, res, false, niter, refine));
+    for (igraph_integer_t level = igraph_graph_list_size(&levels) - 1; level >= 0; level--) {
+        const igraph_t *finer = level > 0 ? igraph_graph_list_get_ptr(&levels, level - 1) : graph;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_CHECK(igraph_matrix_update(&coarse_layout, res));
+        IGRAPH_CHECK(igraph_matrix_resize(res, igraph_vcount(finer), 2));
+        igraph_i_layout_multilevel_prolong(igraph_graph_list_get_ptr(&levels, level), &coarse_layout,
+                                           igraph_vector_int_list_get_ptr(&memberships, level), res);
+        IGRAPH_CHECK(igraph_i_layout_multilevel_refine(finer, res, true, niter, refine));
+    }
+
+    igraph_matrix_destroy(&coarse_layout);
+    igraph_vector_int_destroy(&mass);
+    igraph_vector_int_list_destroy(&memberships);
+    igraph_graph_list_destroy(&levels);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_layout_multilevel
+ * \brief Multilevel force-directed layout for large graphs.
+ *
+ * \experimental
+ *
+ * Force-directed layouts started from random positions need many
+ * iterations to untangle large graphs. This function follows the
+ * multilevel scheme of the FM^3 layout algorithm by Hachul and Jünger to
+ * speed this up: it repeatedly coarsens the graph by collapsing the edges
+ * of a maximal matching, where each unmatched vertex is merged into the
+ * group of one of its neighbours, until at most \p coarsest_size
+ * vertices remain. The coarsest graph is laid out from a random starting
+ * position. The layout of each level is then used as the starting point
+ * of the next finer one: every vertex is placed near the position of the
+ * vertex it was collapsed into, and the layout is refined with a few
+ * iterations of a force-directed algorithm, which only need to correct
+ * local details. Since each level has at most half as many vertices as the
+ * previous one, the total running time is dominated by the iterations on
+ * the original graph.
+ *
+ * </para><para>
+ * The connected components of the graph are laid out separately, and
+ * their layouts are merged with \ref igraph_layout_merge_dla().
+ *
+ * </para><para>
+ * Reference:
+ *
+ * </para><para>
+ * Hachul, S. and Jünger, M.:
+ * Drawing Large Graphs with a Potential-Field-Based Multilevel Algorithm.
+ * Graph Drawing 2004, Lecture Notes in Computer Science 3383, 285--295,
+ * 2005. https://doi.org/10.1007/978-3-540-31843-9_29
+ *
+ * \param graph Pointer to an initialized graph object. Edge directions are
+ *        ignored.
+ * \param res Pointer to an initialized matrix object. This will
+ *        contain the result and will be resized as needed.
+ * \param niter The number of iterations of the force-directed algorithm on
+ *        each level. A reasonable default value is 50.
+ * \param coarsest_size Coarsening stops when the graph has at most this
+ *        many vertices. Must be positive. A reasonable default value is 50.
+ * \param refine The force-directed layout algorithm used on each level.
+ *        Possible values:
+ *        \clist
+ *        \cli IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD
+ *          \ref igraph_layout_fruchterman_reingold() with
+ *          \c IGRAPH_LAYOUT_AUTOGRID. The start temperature is the square
+ *          root of the number of vertices on the coarsest level, and a tenth
+ *          of it on the other levels.
+ *        \cli IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT
+ *          \ref igraph_layout_graphopt() with its default parameters.
+ *        \endclist
+ * \return Error code.
+ *
+ * Time complexity: O(niter * (|V| log |V| + |E|)) for large connected
+ * graphs, plus the time of \ref igraph_layout_merge_dla() for
+ * disconnected ones.
+ */
+
+igraph_error_t igraph_layout_multilevel(const igraph_t *graph, igraph_matrix_t *res,
+                                        igraph_integer_t niter, igraph_integer_t coarsest_size,
+                                        igraph_layout_multilevel_refine_t refine) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_comps;
+    igraph_vector_int_t membership, csize;
+    igraph_vector_int_list_t vids;
+    igraph_vector_int_t map, invmap;
+    igraph_matrix_list_t layouts;
+    igraph_matrix_t merged;
+
+    if (niter < 0) {
+        IGRAPH_ERROR("Number of iterations must be non-negative in multilevel layout.", IGRAPH_EINVAL);
+    }
+    if (coarsest_size < 1) {
+        IGRAPH_ERRORF("Size of coarsest graph must be positive in multilevel layout, got %" IGRAPH_PRId ".",
+                      IGRAPH_EINVAL, coarsest_size);
+    }
+    if (refine != IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD &&
+        refine != IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT) {
+        IGRAPH_ERROR("Invalid refinement method for multilevel layout.", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&membership, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&csize, 0);
+    IGRAPH_CHECK(igraph_connected_components(graph, &membership, &csize, &no_of_comps, IGRAPH_WEAK));
+
+    if (no_of_comps <= 1) {
+        RNG_BEGIN();
+        IGRAPH_CHECK(igraph_i_layout_multilevel_connected(graph, res, niter, coarsest_size, refine));
+        RNG_END();
+        igraph_vector_int_destroy(&csize);
+        igraph_vector_int_destroy(&membership);
+        IGRAPH_FINALLY_CLEAN(2);
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_list_init(&vids, no_of_comps));
+    IGRAPH_FINALLY(igraph_vector_int_list_destroy, &vids);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&map, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&invmap, 0);
+    IGRAPH_CHECK(igraph_matrix_list_init(&layouts, no_of_comps));
+    IGRAPH_FINALLY(igraph_matrix_list_destroy, &layouts);
+    IGRAPH_MATRIX_INIT_FINALLY(&merged, 0, 0);
+
+    for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+        IGRAPH_CHECK(igraph_vector_int_reserve(igraph_vector_int_list_get_ptr(&vids, c), VECTOR(csize)[c]));
+    }
+    for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+        igraph_vector_int_push_back(igraph_vector_int_list_get_ptr(&vids, VECTOR(membership)[v]), v); /* reserved */
+    }
+
+    RNG_BEGIN();
+
+    for (igraph_integer_t c = 0; c < no_of_comps; c++) {
+        igraph_t component;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* The components are disjoint, so 'map' does not need to be cleared
+         * between them, see igraph_i_decompose_weak(). */
+        IGRAPH_CHECK(igraph_i_induced_subgraph_map(
+                         graph, &component, igraph_vss_vector(igraph_vector_int_list_get_ptr(&vids, c)),
+                         IGRAPH_SUBGRAPH_AUTO, &map, &invmap, /* map_is_prepared = */ true));
+        IGRAPH_FINALLY(igraph_destroy, &component);
+        IGRAPH_CHECK(igraph_vector_int_update(igraph_vector_int_list_get_ptr(&vids, c), &invmap));
+
+        IGRAPH_CHECK(igraph_i_layout_multilevel_connected(
+                         &component, igraph_matrix_list_get_ptr(&layouts, c), niter, coarsest_size, refine));
+
+        igraph_destroy(&component);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    RNG_END();
+
+    /* igraph_layout_merge_dla() only uses the layouts, not the graphs */
+    IGRAPH_CHECK(igraph_layout_merge_dla(NULL, &layouts, &merged));
+
+    /* igraph_layout_merge_dla() concatenates the layouts of the components */
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_nodes, 2));
+    for (igraph_integer_t c = 0, row = 0; c < no_of_comps; c++) {
+        const igraph_vector_int_t *comp_vids = igraph_vector_int_list_get_ptr(&vids, c);
+        igraph_integer_t n = igraph_vector_int_size(comp_vids);
+        for (igraph_integer_t i = 0; i < n; i++, row++) {
+            MATRIX(*res, VECTOR(*comp_vids)[i], 0) = MATRIX(merged, row, 0);
+            MATRIX(*res, VECTOR(*comp_vids)[i], 1) = MATRIX(merged, row, 1);
+        }
+    }
+
+    igraph_matrix_destroy(&merged);
+    igraph_matrix_list_destroy(&layouts);
+    igraph_vector_int_destroy(&invmap);
+    igraph_vector_int_destroy(&map);
+    igraph_vector_int_list_destroy(&vids);
+    igraph_vector_int_destroy(&csize);
+    igraph_vector_int_destroy(&membership);
+    IGRAPH_FINALLY_CLEAN(7);
+
+    return IGRAPH_SUCCESS;
+}
@@ -0,0 +1,439 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* Distances from a small set of pivot vertices, and layouts derived from
+ * them. These let distance-based layouts avoid the O(|V|^2) matrix of all
+ * pairwise distances. */
+
+#include "igraph_adjlist.h"
+#include "igraph_interface.h"
+#include "igraph_lapack.h"
+#include "igraph_memory.h"
+
+#include "core/indheap.h"
+#include "core/interruption.h"
+#include "core/parallel.h"
+#include "layout/layout_internal.h"
+
+#include <math.h>
+
+typedef struct igraph_i_pivot_workspace_t {
+    igraph_vector_int_t queue;        /* for unweighted graphs */
+    igraph_2wheap_t heap;             /* for weighted graphs */
+} igraph_i_pivot_workspace_t;
+
+static void igraph_i_pivot_workspace_destroy(igraph_i_pivot_workspace_t *ws) {
+    igraph_vector_int_destroy(&ws->queue);
+    igraph_2wheap_destroy(&ws->heap);
+}
+
+static igraph_error_t igraph_i_pivot_workspace_init(igraph_i_pivot_workspace_t *ws,
+                                                    igraph_integer_t no_of_nodes,
+                                                    igraph_bool_t weighted) {
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&ws->queue, weighted ? 0 : no_of_nodes);
+    IGRAPH_CHECK(igraph_2wheap_init(&ws->heap, weighted ? no_of_nodes : 0));
+    IGRAPH_FINALLY_CLEAN(1);
+    return IGRAPH_SUCCESS;
+}
+
+/* Writes the distances from the nearest of the 'no_of_sources' vertices in
+ * 'sources' to all vertices into 'dist', which has room for all vertices.
+ * Unreachable vertices get infinite distance. */
+static igraph_error_t igraph_i_pivot_sssp(const igraph_csr_adjlist_t *al,
+                                          const igraph_vector_t *weights,
+                                          igraph_i_pivot_workspace_t *ws,
+                                          const igraph_integer_t *sources,
+                                          igraph_integer_t no_of_sources,
+                                          igraph_real_t *dist) {
+
+    igraph_integer_t no_of_nodes = igraph_csr_adjlist_size(al);
+
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        dist[i] = IGRAPH_INFINITY;
+    }
+
+    if (!weights) {
+        igraph_integer_t *queue = VECTOR(ws->queue);
+        igraph_integer_t head = 0, tail = 0;
+
+        for (igraph_integer_t i = 0; i < no_of_sources; i++) {
+            if (dist[ sources[i] ] != 0) {
+                dist[ sources[i] ] = 0;
+                queue[tail++] = sources[i];
+            }
+        }
+        while (head < tail) {
+            igraph_integer_t v = queue[head++];
+            igraph_integer_t n = igraph_csr_adjlist_degree(al, v);
+            const igraph_integer_t *neis = igraph_csr_adjlist_get(al, v);
+            for (igraph_integer_t j = 0; j < n; j++) {
+                igraph_integer_t u = neis[j];
+                if (dist[u] == IGRAPH_INFINITY) {
+                    dist[u] = dist[v] + 1;
+                    queue[tail++] = u;
+                }
+            }
+        }
+    } else {
+        igraph_2wheap_t *heap = &ws->heap;
+
+        igraph_2wheap_clear(heap);
+        for (igraph_integer_t i = 0; i < no_of_sources; i++) {
+            if (!igraph_2wheap_has_elem(heap, sources[i])) {
+                IGRAPH_CHECK(igraph_2wheap_push_with_index(heap, sources[i], -0.0));
+            }
+        }
+        while (!igraph_2wheap_empty(heap)) {
+            igraph_integer_t v = igraph_2wheap_max_index(heap);
+            igraph_real_t vdist = -igraph_2wheap_deactivate_max(heap);
+            igraph_integer_t n = igraph_csr_adjlist_degree(al, v);
+            const igraph_integer_t *neis = igraph_csr_adjlist_get(al, v);
+            const igraph_integer_t *eids = igraph_csr_adjlist_get_eids(al, v);
+
+            dist[v] = vdist;
+            for (igraph_integer_t j = 0; j < n; j++) {
+                igraph_integer_t u = neis[j];
+                igraph_real_t altdist = vdist + VECTOR(*weights)[ eids[j] ];
+                if (!igraph_2wheap_has_elem(heap, u)) {
+                    IGRAPH_CHECK(igraph_2wheap_push_with_index(heap, u, -altdist));
+                } else if (igraph_2wheap_has_active(heap, u) &&
+                           altdist < -igraph_2wheap_get(heap, u)) {
+                    igraph_2wheap_modify(heap, u, -altdist);
+                }
+            }
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_i_pivot_adjlist_init(const igraph_t *graph,
+                                                  const igraph_vector_t *weights,
+                                                  igraph_csr_adjlist_t *al) {
+    if (weights) {
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, al, IGRAPH_ALL, IGRAPH_NO_LOOPS));
+    } else {
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, al, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_NO_MULTIPLE));
+    }
+    return IGRAPH_SUCCESS;
+}
+
+#ifdef IGRAPH_I_PARALLEL_API
+
+static igraph_error_t igraph_i_layout_pivot_distances_parallel(
+        const igraph_csr_adjlist_t *al, const igraph_vector_t *weights,
+        igraph_i_pivot_workspace_t *workspaces, int no_of_workspaces,
+        const igraph_vector_int_list_t *pivots, igraph_matrix_t *dist) {
+
+    igraph_integer_t no_of_pivots = igraph_vector_int_list_size(pivots);
+    int error = IGRAPH_SUCCESS;
+
+#pragma omp parallel num_threads(no_of_workspaces)
+    {
+        igraph_error_handler_t *handler = igraph_i_parallel_enter();
+        igraph_i_pivot_workspace_t *ws = &workspaces[omp_get_thread_num()];
+
+#pragma omp for schedule(dynamic, 1)
+        for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+            igraph_error_t ret;
+            int current_error;
+
+#pragma omp atomic read
+            current_error = error;
+            if (current_error != IGRAPH_SUCCESS) {
+                continue;
+            }
+
+            const igraph_vector_int_t *sources = igraph_vector_int_list_get_ptr(pivots, p);
+            ret = igraph_i_pivot_sssp(al, weights, ws, VECTOR(*sources), igraph_vector_int_size(sources),
+                                      &MATRIX(*dist, 0, p));
+            if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                error = ret;
+            }
+        }
+
+        igraph_i_parallel_exit(handler);
+    }
+
+    if (error != IGRAPH_SUCCESS) {
+        IGRAPH_ERROR("Cannot calculate distances from pivots.", (igraph_error_t) error);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+#endif
+
+/**
+ * Computes the distances from k pivots to all vertices, ignoring edge
+ * directions. Each pivot is a set of vertices given as an element of
+ * 'pivots', and column p of the |V| x k matrix 'dist' holds the distances
+ * from the nearest vertex of pivots[p]; unreachable vertices are at infinite
+ * distance. A set usually has a single vertex; putting one pivot of each
+ * connected component into the same set computes the distances within all
+ * components with a single search. The pivots are processed in parallel when
+ * igraph is built with OpenMP support. 'weights' must be positive, or NULL
+ * for unit weights.
+ */
+igraph_error_t igraph_i_layout_pivot_distances(const igraph_t *graph,
+                                               const igraph_vector_t *weights,
+                                               const igraph_vector_int_list_t *pivots,
+                                               igraph_matrix_t *dist) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_pivots = igraph_vector_int_list_size(pivots);
+    igraph_integer_t no_of_workspaces = igraph_i_parallel_max_threads();
+    igraph_i_pivot_workspace_t *workspaces;
+    igraph_csr_adjlist_t al;
+
+    if (no_of_workspaces > no_of_pivots) {
+        no_of_workspaces = no_of_pivots > 0 ? no_of_pivots : 1;
+    }
+
+    IGRAPH_CHECK(igraph_matrix_resize(dist, no_of_nodes, no_of_pivots));
+    IGRAPH_CHECK(igraph_i_pivot_adjlist_init(graph, weights, &al));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &al);
+
+    workspaces = IGRAPH_CALLOC(no_of_workspaces, igraph_i_pivot_workspace_t);
+    IGRAPH_CHECK_OOM(workspaces, "Insufficient memory for distances from pivots.");
+    IGRAPH_FINALLY(igraph_free, workspaces);
+    for (igraph_integer_t i = 0; i < no_of_workspaces; i++) {
+        IGRAPH_CHECK(igraph_i_pivot_workspace_init(&workspaces[i], no_of_nodes, weights != NULL));
+        IGRAPH_FINALLY(igraph_i_pivot_workspace_destroy, &workspaces[i]);
+    }
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_workspaces > 1) {
+        IGRAPH_CHECK(igraph_i_layout_pivot_distances_parallel(&al, weights, workspaces, no_of_workspaces,
+                                                              pivots, dist));
+    } else
+#endif
+    {
+        for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+            const igraph_vector_int_t *sources = igraph_vector_int_list_get_ptr(pivots, p);
+            IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_CHECK(igraph_i_pivot_sssp(&al, weights, &workspaces[0],
+                                             VECTOR(*sources), igraph_vector_int_size(sources),
+                                             &MATRIX(*dist, 0, p)));
+        }
+    }
+
+    for (igraph_integer_t i = 0; i < no_of_workspaces; i++) {
+        igraph_i_pivot_workspace_destroy(&workspaces[i]);
+    }
+    IGRAPH_FREE(workspaces);
+    igraph_csr_adjlist_destroy(&al);
+    IGRAPH_FINALLY_CLEAN(2 + no_of_workspaces);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * Selects min(k, |V|) pivots with the max-min strategy: the first pivot is
+ * vertex 0, and each further one is a vertex farthest from all pivots
+ * selected so far, vertices in not yet covered components first. The
+ * pivots are written to 'pivots', and their distances to 'dist' as in
+ * igraph_i_layout_pivot_distances(). Pivots are well spread over the
+ * graph, but have to be found one after the other.
+ */
+igraph_error_t igraph_i_layout_maxmin_pivots(const igraph_t *graph,
+                                             const igraph_vector_t *weights,
+                                             igraph_integer_t k,
+                                             igraph_vector_int_t *pivots,
+                                             igraph_matrix_t *dist) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_pivots = k < no_of_nodes ? k : no_of_nodes;
+    igraph_i_pivot_workspace_t ws;
+    igraph_csr_adjlist_t al;
+    igraph_vector_t mindist;
+    igraph_integer_t next = 0;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(pivots, no_of_pivots));
+    IGRAPH_CHECK(igraph_matrix_resize(dist, no_of_nodes, no_of_pivots));
+    IGRAPH_CHECK(igraph_i_pivot_adjlist_init(graph, weights, &al));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &al);
+    IGRAPH_CHECK(igraph_i_pivot_workspace_init(&ws, no_of_nodes, weights != NULL));
+    IGRAPH_FINALLY(igraph_i_pivot_workspace_destroy, &ws);
+    IGRAPH_VECTOR_INIT_FINALLY(&mindist, no_of_nodes);
+
+    igraph_vector_fill(&mindist, IGRAPH_INFINITY);
+
+    for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+        igraph_real_t *col = &MATRIX(*dist, 0, p);
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        VECTOR(*pivots)[p] = next;
+        IGRAPH_CHECK(igraph_i_pivot_sssp(&al, weights, &ws, &next, 1, col));
+
+        /* Infinite distances compare as the largest ones, so the next pivot
+         * is in an uncovered component as long as there is one. */
+        next = 0;
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            if (col[i] < VECTOR(mindist)[i]) {
+                VECTOR(mindist)[i] = col[i];
+            }
+            if (VECTOR(mindist)[i] > VECTOR(mindist)[next]) {
+                next = i;
+            }
+        }
+    }
+
+    igraph_vector_destroy(&mindist);
+    igraph_i_pivot_workspace_destroy(&ws);
+    igraph_csr_adjlist_destroy(&al);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * Pivot MDS (Brandes and Pich, 2007): approximates classical
+ * multidimensional scaling from the |V| x k matrix of distances to k pivots,
+ * in O(k^2 |V|) time. The squared distances are double centered, and the
+ * layout is spanned by the images of the top eigenvectors of C^T C,
+ * where C is the centered matrix. The layout is finally scaled so that the
+ * Euclidean distances from the pivots match the graph distances in the least
+ * squares sense. Infinite distances must have been replaced by finite ones.
+ *
+ * Reference:
+ *
+ * Brandes, U. and Pich, C.:
+ * Eigensolver Methods for Progressive Multidimensional Scaling of Large Data.
+ * Graph Drawing 2006, Lecture Notes in Computer Science 4372, 42--53, 2007.
+ * https://doi.org/10.1007/978-3-540-70904-6_6
+ */
+igraph_error_t igraph_i_layout_pivot_mds(const igraph_matrix_t *dist,
+                                         const igraph_vector_int_t *pivots,
+                                         igraph_integer_t dim, igraph_matrix_t *res) {
+
+    igraph_integer_t no_of_nodes = igraph_matrix_nrow(dist);
+    igraph_integer_t no_of_pivots = igraph_matrix_ncol(dist);
+    igraph_integer_t nev = dim < no_of_pivots ? dim : no_of_pivots;
+    igraph_matrix_t c, ctc, vectors;
+    igraph_vector_t values, col_means;
+    igraph_real_t grand_mean = 0, num = 0, den = 0;
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_nodes, dim));
+    igraph_matrix_null(res);
+    if (no_of_nodes <= 1 || nev == 0) {
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_MATRIX_INIT_FINALLY(&c, no_of_nodes, no_of_pivots);
+    IGRAPH_MATRIX_INIT_FINALLY(&ctc, no_of_pivots, no_of_pivots);
+    IGRAPH_MATRIX_INIT_FINALLY(&vectors, 0, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&values, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&col_means, no_of_pivots);
+
+    /* Double centering of the squared distances */
+    for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+        igraph_real_t sum = 0;
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            igraph_real_t d = MATRIX(*dist, i, p);
+            MATRIX(c, i, p) = d * d;
+            sum += d * d;
+        }
+        VECTOR(col_means)[p] = sum / no_of_nodes;
+        grand_mean += VECTOR(col_means)[p];
+    }
+    grand_mean /= no_of_pivots;
+    IGRAPH_I_OMP(omp parallel for schedule(static))
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_real_t row_mean = 0;
+        for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+            row_mean += MATRIX(c, i, p);
+        }
+        row_mean /= no_of_pivots;
+        for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+            MATRIX(c, i, p) = -0.5 * (MATRIX(c, i, p) - row_mean - VECTOR(col_means)[p] + grand_mean);
+        }
+    }
+
+    /* C^T C, only k x k */
+    IGRAPH_I_OMP(omp parallel for schedule(dynamic, 1))
+    for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+        for (igraph_integer_t q = p; q < no_of_pivots; q++) {
+            igraph_real_t sum = 0;
+            for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+                sum += MATRIX(c, i, p) * MATRIX(c, i, q);
+            }
+            MATRIX(ctc, p, q) = MATRIX(ctc, q, p) = sum;
+        }
+    }
+
+    /* Eigenvalues are returned in ascending order */
+    IGRAPH_CHECK(igraph_lapack_dsyevr(&ctc, IGRAPH_LAPACK_DSYEV_SELECT,
+                                      /*vl=*/ 0, /*vu=*/ 0, /*vestimate=*/ 0,
+                                      /*il=*/ no_of_pivots - nev + 1, /*iu=*/ no_of_pivots,
+                                      /*abstol=*/ 1e-14, &values, &vectors,
+                                      /*support=*/ NULL));
+
+    for (igraph_integer_t j = 0; j < nev; j++) {
+        igraph_integer_t ev = nev - 1 - j;
+        igraph_real_t norm = 0;
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            igraph_real_t sum = 0;
+            for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+                sum += MATRIX(c, i, p) * MATRIX(vectors, p, ev);
+            }
+            MATRIX(*res, i, j) = sum;
+            norm += sum * sum;
+        }
+        /* Coordinate axes are weighted by the square root of the eigenvalue
+         * of the double centered matrix, which is approximately the fourth
+         * root of the eigenvalue of C^T C. Normalizing to unit length first
+         * makes the result independent of the number of pivots. */
+        if (norm > 0) {
+            igraph_real_t scale = sqrt(sqrt(VECTOR(values)[ev] > 0 ? VECTOR(values)[ev] : 0) / norm);
+            for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+                MATRIX(*res, i, j) *= scale;
+            }
+        }
+    }
+
+    /* Fit the overall scale to the distances from the pivots */
+    for (igraph_integer_t p = 0; p < no_of_pivots; p++) {
+        igraph_integer_t pivot = VECTOR(*pivots)[p];
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            igraph_real_t e = 0;
+            for (igraph_integer_t j = 0; j < nev; j++) {
+                igraph_real_t d = MATRIX(*res, i, j) - MATRIX(*res, pivot, j);
+                e += d * d;
+            }
+            e = sqrt(e);
+            num += e * MATRIX(*dist, i, p);
+            den += e * e;
+        }
+    }
+    if (den > 0) {
+        igraph_matrix_scale(res, num / den);
+    }
+
+    igraph_vector_destroy(&col_means);
+    igraph_vector_destroy(&values);
+    igraph_matrix_destroy(&vectors);
+    igraph_matrix_destroy(&ctc);
+    igraph_matrix_destroy(&c);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return IGRAPH_SUCCESS;
+}
@@ -19,15 +19,20 @@
 
 #include "igraph_layout.h"
 
+#include "igraph_adjlist.h"
 #include "igraph_interface.h"
 #include "igraph_lapack.h"
 #include "igraph_matrix.h"
+#include "igraph_memory.h"
 #include "igraph_nongraph.h"
 #include "igraph_random.h"
+#include "igraph_structural.h"
 #include "igraph_vector_list.h"
 
 #include "layout/layout_internal.h"
 #include "core/interruption.h"
+#include "core/parallel.h"
+#include "random/random_internal.h"
 
 #include <math.h>
 
@@ -93,11 +98,12 @@
 #define UMAP_FORCE_LIMIT 4
 #define UMAP_MIN_DISTANCE_ATTRACTION 0.0001
 #define UMAP_CORRECT_DISTANCE_REPULSION 0.01
+#define UMAP_EDGE_BLOCK_SIZE 1024
 
 /* Find sigma for this vertex by binary search */
-static igraph_error_t igraph_i_umap_find_sigma(const igraph_vector_t *distances,
+static igraph_real_t igraph_i_umap_find_sigma(const igraph_vector_t *distances,
         const igraph_vector_int_t *eids,
-        igraph_real_t rho, igraph_real_t *sigma_p, igraph_real_t target) {
+        igraph_real_t rho, igraph_real_t target) {
 
     igraph_real_t sigma = 1;
     igraph_real_t sum;
@@ -145,9 +151,72 @@ static igraph_error_t igraph_i_umap_find_sigma(const igraph_vector_t *distances,
         }
     }
 
-    *sigma_p = sigma;
+    return sigma;
+}
 
-    return IGRAPH_SUCCESS;
+/* Computes the weights of the edges out of vertex 'i', whose IDs are in 'eids',
+ * as seen from 'i'. The weight of each edge is stored in 'weights_from' if 'i'
+ * is its source, and in 'weights_to' otherwise, which can only happen in
+ * undirected graphs. Each edge is thus written by a single vertex from
+ * either side, so vertices can be processed in parallel. */
+static void igraph_i_umap_vertex_weights(const igraph_t *graph,
+        const igraph_vector_t *distances, const igraph_vector_int_t *eids,
+        igraph_integer_t i, igraph_vector_t *weights_from, igraph_vector_t *weights_to) {
+
+    igraph_integer_t no_of_neis = igraph_vector_int_size(eids);
+    igraph_integer_t eid;
+    igraph_real_t rho, dist_max, dist, sigma, weight;
+
+    /* Vertex has no neighbors */
+    if (no_of_neis == 0) {
+        return;
+    }
+
+    /* Find rho for this vertex, i.e. the minimal non-self distance */
+    if (distances != NULL) {
+        rho = VECTOR(*distances)[VECTOR(*eids)[0]];
+        dist_max = rho;
+        for (igraph_integer_t j = 1; j < no_of_neis; j++) {
+            eid = VECTOR(*eids)[j];
+            dist = VECTOR(*distances)[eid];
+            rho = fmin(rho, dist);
+            dist_max = fmax(dist_max, dist);
+        }
+    } else {
+        rho = dist_max = 0;
+    }
+
+    /* If the maximal distance is rho, all neighbors are identical to
+     * each other. This can happen e.g. if distances == NULL. */
+    if (dist_max == rho) {
+        /* This is a special flag for later on */
+        sigma = -1;
+
+    /* Else, find sigma for this vertex, from its rho plus binary search */
+    } else {
+        sigma = igraph_i_umap_find_sigma(distances, eids, rho, log2(no_of_neis));
+    }
+
+    /* Convert to weights */
+    for (igraph_integer_t j = 0; j < no_of_neis; j++) {
+        eid = VECTOR(*eids)[j];
+
+        /* Basically, nodes closer than rho have probability 1, the rest is
+         * exponentially penalized keeping rough cardinality */
+        weight = sigma < 0 ? 1 : exp(-(VECTOR(*distances)[eid] - rho) / sigma);
+
+        #ifdef UMAP_DEBUG
+        if (distances != NULL)
+            printf("distance: %g\n", VECTOR(*distances)[eid]);
+        printf("weight: %g\n", weight);
+        #endif
+
+        if (IGRAPH_FROM(graph, eid) == i) {
+            VECTOR(*weights_from)[eid] = weight;
+        } else {
+            VECTOR(*weights_to)[eid] = weight;
+        }
+    }
 }
 
 
@@ -191,6 +260,8 @@ static igraph_error_t igraph_i_umap_find_sigma(const igraph_vector_t *distances,
  *
  * Technical note: For each vertex, this function computes its scale factor (sigma),
  * its connectivity correction (rho), and finally the weights themselves.
+ * Vertices are processed in parallel when igraph is built with OpenMP support;
+ * the result does not depend on the number of threads.
  *
  * </para><para>
  * References:
@@ -221,13 +292,11 @@ igraph_error_t igraph_layout_umap_compute_weights(
 
     igraph_integer_t no_of_vertices = igraph_vcount(graph);
     igraph_integer_t no_of_edges = igraph_ecount(graph);
-    igraph_integer_t no_of_neis, eid, i, j, k, l;
-    igraph_vector_int_t eids;
-    igraph_vector_int_list_t neighbors_seen;
-    igraph_vector_list_t weights_seen;
-    igraph_vector_int_t* neighbors_seen_elt;
-    igraph_vector_t* weights_seen_elt;
-    igraph_real_t rho, dist_max, dist, sigma, weight, weight_inv, sigma_target, dist_min;
+    igraph_bool_t directed = igraph_is_directed(graph);
+    igraph_bool_t has_loop;
+    igraph_inclist_t inclist;
+    igraph_vector_t weights_from, weights_to;
+    igraph_real_t dist_min;
 
     /* reserve memory for the weights */
     IGRAPH_CHECK(igraph_vector_resize(weights, no_of_edges));
@@ -247,143 +316,68 @@ igraph_error_t igraph_layout_umap_compute_weights(
         }
     }
 
-    /* Initialize auxiliary vectors */
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&eids, 0);
-    IGRAPH_VECTOR_INT_LIST_INIT_FINALLY(&neighbors_seen, no_of_vertices);
-    IGRAPH_VECTOR_LIST_INIT_FINALLY(&weights_seen, no_of_vertices);
-
-    /* Iterate over vertices x, like in the paper */
-    for (i = 0; i < no_of_vertices; i++) {
-        /* Edges out of this vertex, e.g. to its k-nearest neighbors */
-        IGRAPH_CHECK(igraph_incident(graph, &eids, i, IGRAPH_OUT));
-        no_of_neis = igraph_vector_int_size(&eids);
-
-        /* Vertex has no neighbors */
-        if (no_of_neis == 0) {
-            continue;
-        }
-
-        /* Find rho for this vertex, i.e. the minimal non-self distance */
-        if (distances != NULL) {
-            rho = VECTOR(*distances)[VECTOR(eids)[0]];
-            dist_max = rho;
-            for (j = 1; j < no_of_neis; j++) {
-                eid = VECTOR(eids)[j];
-                dist = VECTOR(*distances)[eid];
-                rho = fmin(rho, dist);
-                dist_max = fmax(dist_max, dist);
-            }
-        } else {
-            rho = dist_max = 0;
-        }
-
-        /* If the maximal distance is rho, all neighbors are identical to
-         * each other. This can happen e.g. if distances == NULL. */
-        if (dist_max == rho) {
-            /* This is a special flag for later on */
-            sigma = -1;
-
-        /* Else, find sigma for this vertex, from its rho plus binary search */
-        } else {
-            sigma_target = log2(no_of_neis);
-            IGRAPH_CHECK(igraph_i_umap_find_sigma(distances,
-                        &eids, rho, &sigma,
-                        sigma_target));
-        }
-
-        /* Convert to weights */
-        for (j = 0; j < no_of_neis; j++) {
-            eid = VECTOR(eids)[j];
-
-            /* Basically, nodes closer than rho have probability 1, the rest is
-             * exponentially penalized keeping rough cardinality */
-            weight = sigma < 0 ? 1 : exp(-(VECTOR(*distances)[eid] - rho) / sigma);
-
-            #ifdef UMAP_DEBUG
-            if (distances != NULL)
-                printf("distance: %g\n", VECTOR(*distances)[eid]);
-            printf("weight: %g\n", weight);
-            #endif
-
-            /* Store in vector lists for later symmetrization */
-            k = IGRAPH_OTHER(graph, eid, i);
-            if (k == i) {
-                IGRAPH_ERROR("Input graph must contain no self-loops.", IGRAPH_EINVAL);
-            }
-
-            neighbors_seen_elt = igraph_vector_int_list_get_ptr(&neighbors_seen, i);
-            IGRAPH_CHECK(igraph_vector_int_push_back(neighbors_seen_elt, k));
+    IGRAPH_CHECK(igraph_has_loop(graph, &has_loop));
+    if (has_loop) {
+        IGRAPH_ERROR("Input graph must contain no self-loops.", IGRAPH_EINVAL);
+    }
 
-            weights_seen_elt = igraph_vector_list_get_ptr(&weights_seen, i);
-            IGRAPH_CHECK(igraph_vector_push_back(weights_seen_elt, weight));
-        }
+    /* Edges out of each vertex, e.g. to its k-nearest neighbors */
+    IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
+    IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+    IGRAPH_VECTOR_INIT_FINALLY(&weights_from, no_of_edges);
+    IGRAPH_VECTOR_INIT_FINALLY(&weights_to, directed ? 0 : no_of_edges);
 
+    /* Iterate over vertices x, like in the paper. The vertices are
+     * independent of each other, so this is done in parallel. */
+    IGRAPH_I_OMP(omp parallel for schedule(dynamic, 256))
+    for (igraph_integer_t i = 0; i < no_of_vertices; i++) {
+        igraph_i_umap_vertex_weights(graph, distances, igraph_inclist_get(&inclist, i),
+                                     i, &weights_from, &weights_to);
     }
 
     /* Symmetrize the weights. UMAP weights are probabilities of that edge being a
      * "real" connection. Unlike the distances, which can represent a directed graph,
      * weights are usually symmetric. We symmetrize via fuzzy union. */
-    for (eid=0; eid < no_of_edges; eid++) {
-        i = IGRAPH_FROM(graph, eid);
-        k = IGRAPH_TO(graph, eid);
-
-        /* Direct weight, if found */
-        /* NOTE: this and the subsequent loop could be faster if we sorted the vectors
-         * beforehand. Probably not such a big deal. */
-        weight = 0;
-        neighbors_seen_elt = igraph_vector_int_list_get_ptr(&neighbors_seen, i);
-        weights_seen_elt = igraph_vector_list_get_ptr(&weights_seen, i);
-        no_of_neis = igraph_vector_int_size(neighbors_seen_elt);
-        for (l=0; l < no_of_neis; l++) {
-            if (VECTOR(*neighbors_seen_elt)[l] == k) {
-                weight = VECTOR(*weights_seen_elt)[l];
-                /* Tag this weight so we can ignore it later on if the opposite
-                 * directed edge is found. It's ok to retag */
-                VECTOR(*weights_seen_elt)[l] = -1;
-                break;
-            }
-        }
-
-        /* The opposite edge has already been union-ed, set this one to -1 */
-        if (weight < 0) {
-            VECTOR(*weights)[eid] = 0;
-            continue;
-        }
-
-        /* Weight of the opposite edge, if found */
-        weight_inv = 0;
-        neighbors_seen_elt = igraph_vector_int_list_get_ptr(&neighbors_seen, k);
-        weights_seen_elt = igraph_vector_list_get_ptr(&weights_seen, k);
-        no_of_neis = igraph_vector_int_size(neighbors_seen_elt);
-        for (l=0; l < no_of_neis; l++) {
-            if (VECTOR(*neighbors_seen_elt)[l] == i) {
-                weight_inv = VECTOR(*weights_seen_elt)[l];
-                /* Tag this weight so we can ignore it later on if the opposite
-                 * directed edge is found. It's ok to retag */
-                VECTOR(*weights_seen_elt)[l] = -1;
-                break;
+    IGRAPH_I_OMP(omp parallel for schedule(static))
+    for (igraph_integer_t eid = 0; eid < no_of_edges; eid++) {
+        igraph_real_t weight = VECTOR(weights_from)[eid];
+        igraph_real_t weight_inv = 0;
+
+        if (directed) {
+            /* Weight of the opposite edge, if found. Only the one with the
+             * smaller ID gets the union of the two, the other one is set to 0 so
+             * that it will be skipped by the layout. */
+            igraph_integer_t i = IGRAPH_FROM(graph, eid);
+            igraph_integer_t k = IGRAPH_TO(graph, eid);
+            igraph_vector_int_t *eids = igraph_inclist_get(&inclist, k);
+            igraph_integer_t no_of_neis = igraph_vector_int_size(eids);
+            for (igraph_integer_t l = 0; l < no_of_neis; l++) {
+                igraph_integer_t eid2 = VECTOR(*eids)[l];
+                if (IGRAPH_TO(graph, eid2) == i) {
+                    weight_inv = eid2 < eid ? -1 : VECTOR(weights_from)[eid2];
+                    break;
+                }
             }
+        } else {
+            weight_inv = VECTOR(weights_to)[eid];
         }
 
-        /* The opposite edge has already been union-ed, set this one to -1 */
+        /* The opposite edge has already been union-ed, set this one to 0 */
         if (weight_inv < 0) {
             VECTOR(*weights)[eid] = 0;
-            continue;
+        } else {
+            VECTOR(*weights)[eid] = weight + weight_inv - weight * weight_inv;
         }
-
-        /* First time this edge or its opposite are seen, set the W */
-        VECTOR(*weights)[eid] = weight + weight_inv - weight * weight_inv;
     }
 
-    igraph_vector_list_destroy(&weights_seen);
-    igraph_vector_int_list_destroy(&neighbors_seen);
-    igraph_vector_int_destroy(&eids);
+    igraph_vector_destroy(&weights_to);
+    igraph_vector_destroy(&weights_from);
+    igraph_inclist_destroy(&inclist);
     IGRAPH_FINALLY_CLEAN(3);
 
     return IGRAPH_SUCCESS;
 }
 
-
 /* Helper function to compute a and b parameters (smoothing probability metric in embedding space) */
 static igraph_error_t igraph_i_umap_get_ab_residuals(igraph_vector_t *residuals,
         igraph_real_t *squared_sum_res, igraph_integer_t nr_points, igraph_real_t a,
@@ -725,7 +719,9 @@ static igraph_real_t igraph_i_umap_attract(
         igraph_real_t a,
         igraph_real_t b)
 {
-    return - (2 * a * b * pow(dsq, b - 1.)) / (1. + a * pow(dsq, b));
+    /* dsq^(b - 1) = dsq^b / dsq, which saves a call to pow() */
+    igraph_real_t dsq_b = pow(dsq, b);
+    return - (2 * a * b * dsq_b / dsq) / (1. + a * dsq_b);
 }
 
 static igraph_real_t igraph_i_umap_repel(
@@ -738,44 +734,47 @@ static igraph_real_t igraph_i_umap_repel(
     return (2 * b) / (dsq_min + dsq) / (1. + a * pow(dsq, b));
 }
 
-static igraph_error_t igraph_i_umap_apply_forces(
+/* Returns whether there is an edge between 'from' and 'to'. Only used for
+ * small graphs, see igraph_i_umap_optimize_layout_stochastic_gradient(). */
+static igraph_bool_t igraph_i_umap_are_adjacent(const igraph_adjlist_t *adjlist,
+        igraph_integer_t from, igraph_integer_t to) {
+    const igraph_vector_int_t *neis = igraph_adjlist_get(adjlist, from);
+    igraph_integer_t nneis = igraph_vector_int_size(neis);
+    for (igraph_integer_t k = 0; k < nneis; k++) {
+        if (VECTOR(*neis)[k] == to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Moves the vertices at the ends of the edges 'from_eid' ... 'to_eid' - 1 that
+ * are to be sampled in this epoch. 'emb' holds the coordinates of the vertices
+ * in row-major order, i.e. those of each vertex are next to each other in
+ * memory. Random numbers are taken from 'rng'. Blocks of edges can be processed
+ * in parallel, see igraph_i_umap_apply_forces(). */
+static void igraph_i_umap_apply_forces_block(
         const igraph_t *graph,
         const igraph_vector_t *umap_weights,
-        igraph_matrix_t *layout,
+        const igraph_adjlist_t *adjlist,
+        igraph_real_t *emb,
+        igraph_integer_t no_of_vertices,
+        igraph_integer_t ndim,
         igraph_real_t a,
         igraph_real_t b,
         igraph_real_t learning_rate,
-        igraph_bool_t avoid_neighbor_repulsion,
-        igraph_integer_t negative_sampling_rate,
+        igraph_integer_t n_negative_vertices,
         igraph_integer_t epoch,
-        igraph_integer_t epochs,
-        igraph_vector_t *next_epoch_sample_per_edge)
+        igraph_vector_t *next_epoch_sample_per_edge,
+        igraph_rng_t *rng,
+        igraph_integer_t from_eid,
+        igraph_integer_t to_eid)
 {
-    igraph_integer_t no_of_vertices = igraph_matrix_nrow(layout);
-    igraph_integer_t ndim = igraph_matrix_ncol(layout);
-    igraph_integer_t no_of_edges = igraph_ecount(graph);
-    igraph_integer_t from, to, nneis, eid;
-    igraph_vector_t from_emb, to_emb, delta;
-    igraph_real_t force = 0, dsq, force_d;
-    /* The following is only used for small graphs, to avoid repelling your neighbors
-     * For large sparse graphs, it's not necessary. For large dense graphs, you should
-     * not be doing UMAP.
-     * */
-    igraph_vector_int_t neis, negative_vertices;
-    igraph_integer_t n_negative_vertices = (no_of_vertices - 1 < negative_sampling_rate) ? (no_of_vertices - 1) : negative_sampling_rate;
-
-    /* Initialize vectors */
-    IGRAPH_VECTOR_INIT_FINALLY(&from_emb, ndim);
-    IGRAPH_VECTOR_INIT_FINALLY(&to_emb, ndim);
-    IGRAPH_VECTOR_INIT_FINALLY(&delta, ndim);
-
-    if (avoid_neighbor_repulsion) {
-        IGRAPH_VECTOR_INT_INIT_FINALLY(&neis, 0);
-    }
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&negative_vertices, 0);
+    igraph_integer_t from, to;
+    igraph_real_t delta[3];
+    igraph_real_t force, dsq, force_d;
 
-    /* Iterate over edges. Stronger edges are sampled more often */
-    for (eid = 0; eid < no_of_edges; eid++) {
+    for (igraph_integer_t eid = from_eid; eid < to_eid; eid++) {
         /* Zero-weight edges do not affect vertex positions. They can
          * also emerge during the weight symmetrization. */
         if (VECTOR(*umap_weights)[eid] <= 0) {
@@ -793,9 +792,10 @@ static igraph_error_t igraph_i_umap_apply_forces(
         /* we move all vertices on one end of the edges, then we come back for
          * the vertices on the other end. This way we don't move both ends at the
          * same time, which is almost a wasted move since they attract each other */
-        int swapflag = (int)(RNG_UNIF01() > 0.5);
+        int swapflag = (int) igraph_rng_get_integer(rng, 0, 1);
         int swapflag_end = swapflag + 2;
         for (; swapflag < swapflag_end; swapflag++) {
+            igraph_real_t *from_emb;
 
             /* half the time, swap the from/to, otherwise some vertices are never moved.
              * This has to do with the graph representation within igraph */
@@ -806,15 +806,13 @@ static igraph_error_t igraph_i_umap_apply_forces(
                 to = IGRAPH_FROM(graph, eid);
                 from = IGRAPH_TO(graph, eid);
             }
-
+            from_emb = emb + from * ndim;
 
             /* Current coordinates of both vertices */
             dsq = 0;
             for (igraph_integer_t d = 0; d != ndim; d++) {
-                VECTOR(from_emb)[d] = MATRIX(*layout, from, d);
-                VECTOR(to_emb)[d] = MATRIX(*layout, to, d);
-                VECTOR(delta)[d] = MATRIX(*layout, from, d) - MATRIX(*layout, to, d);
-                dsq += VECTOR(delta)[d] * VECTOR(delta)[d];
+                delta[d] = from_emb[d] - emb[to * ndim + d];
+                dsq += delta[d] * delta[d];
             }
 
             /* Apply attractive force since they are neighbors */
@@ -822,61 +820,38 @@ static igraph_error_t igraph_i_umap_apply_forces(
             if (dsq >= UMAP_MIN_DISTANCE_ATTRACTION * UMAP_MIN_DISTANCE_ATTRACTION) {
                 force = igraph_i_umap_attract(dsq, a, b);
                 for (igraph_integer_t d = 0; d != ndim; d++) {
-                    force_d = force * VECTOR(delta)[d];
+                    force_d = force * delta[d];
                     /* clip force to avoid too rapid change */
                     force_d = igraph_i_umap_clip_force(force_d, UMAP_FORCE_LIMIT);
 
             #ifdef UMAP_DEBUG
-                    fprintf(stderr, "force attractive: delta[%ld] = %g, forces[%ld] = %g\n", d, VECTOR(delta)[d], d, force_d);
+                    fprintf(stderr, "force attractive: delta[%ld] = %g, forces[%ld] = %g\n", d, delta[d], d, force_d);
             #endif
 
-                    MATRIX(*layout, from, d) += learning_rate * force_d;
+                    from_emb[d] += learning_rate * force_d;
                 }
             }
 
             /* Random other nodes repel the focal vertex */
-            IGRAPH_CHECK(igraph_random_sample(&negative_vertices,
-                        0, no_of_vertices - 2, n_negative_vertices));
             for (igraph_integer_t j = 0; j < n_negative_vertices; j++) {
 
-                IGRAPH_ALLOW_INTERRUPTION();
-
-                /* Get random neighbor */
-                to = VECTOR(negative_vertices)[j];
-                /* obviously you cannot repel yourself */
+                /* Get random other vertex; obviously you cannot repel yourself */
+                to = igraph_rng_get_integer(rng, 0, no_of_vertices - 2);
                 if (to >= from) {
                     to++;
                 }
 
                 /* do not repel neighbors for small graphs, for big graphs this
                  * does not matter as long as the k in knn << number of vertices */
-                if (avoid_neighbor_repulsion) {
-                    /* NOTE: the efficiency of this step could be improved but it
-                     * should be only used for small graphs anyway, so it's fine */
-                    igraph_bool_t skip = 0;
-                    IGRAPH_CHECK(igraph_incident(graph, &neis, from, IGRAPH_ALL));
-                    nneis = igraph_vector_int_size(&neis);
-                    for (igraph_integer_t k = 0; k < nneis; k++) {
-                        igraph_integer_t eid2 = VECTOR(neis)[k];
-                        igraph_integer_t from2, to2;
-                        from2 = IGRAPH_FROM(graph, eid2);
-                        to2 = IGRAPH_TO(graph, eid2);
-                        if (((from2 == from) && (to2 == to)) || ((from2 == to) && (from == to2))) {
-                            skip = 1;
-                            break;
-                        }
-                    }
-                    if (skip == 1) {
-                        continue;
-                    }
+                if (adjlist && igraph_i_umap_are_adjacent(adjlist, from, to)) {
+                    continue;
                 }
 
                 /* Get layout of random neighbor and gradient in embedding */
                 dsq = 0;
                 for (igraph_integer_t d = 0; d != ndim; d++) {
-                    VECTOR(to_emb)[d] = MATRIX(*layout, to, d);
-                    VECTOR(delta)[d] = MATRIX(*layout, from, d) - MATRIX(*layout, to, d);
-                    dsq += VECTOR(delta)[d] * VECTOR(delta)[d];
+                    delta[d] = from_emb[d] - emb[to * ndim + d];
+                    dsq += delta[d] * delta[d];
                 }
 
                 /* This repels the other vertex assuming it's a negative example
@@ -884,33 +859,105 @@ static igraph_error_t igraph_i_umap_apply_forces(
                 force = igraph_i_umap_repel(dsq, a, b);
                 /* The repulsive force is already *away* from the other (non-neighbor) vertex */
                 for (igraph_integer_t d = 0; d != ndim; d++) {
-                    force_d = force * VECTOR(delta)[d];
+                    force_d = force * delta[d];
 
                     /* clip force to avoid too rapid change */
                     force_d = igraph_i_umap_clip_force(force_d, UMAP_FORCE_LIMIT);
 
                 #ifdef UMAP_DEBUG
-                    fprintf(stderr, "force repulsive: delta[%ld] = %g, forces[%ld] = %g\n", d, VECTOR(delta)[d], d, force_d);
+                    fprintf(stderr, "force repulsive: delta[%ld] = %g, forces[%ld] = %g\n", d, delta[d], d, force_d);
                 #endif
 
-                    MATRIX(*layout, from, d) += learning_rate * force_d;
+                    from_emb[d] += learning_rate * force_d;
                 }
             }
         }
     }
+}
 
-    /* Free vectors */
-    igraph_vector_int_destroy(&negative_vertices);
-    igraph_vector_destroy(&from_emb);
-    igraph_vector_destroy(&to_emb);
-    igraph_vector_destroy(&delta);
-    IGRAPH_FINALLY_CLEAN(4);
+/* The arguments of igraph_i_umap_apply_forces_block() that are shared by
+ * all blocks of edges in an epoch. */
+typedef struct {
+    const igraph_t *graph;
+    const igraph_vector_t *umap_weights;
+    const igraph_adjlist_t *adjlist;
+    igraph_real_t *emb;
+    igraph_integer_t no_of_vertices;
+    igraph_integer_t ndim;
+    igraph_real_t a, b;
+    igraph_real_t learning_rate;
+    igraph_integer_t n_negative_vertices;
+    igraph_integer_t epoch;
+    igraph_vector_t *next_epoch_sample_per_edge;
+} igraph_i_umap_epoch_t;
+
+/* Processes block 'block' of edges, see igraph_i_parallel_run_tasks(). */
+static igraph_error_t igraph_i_umap_apply_forces_task(void *data, void *workspace,
+                                                      igraph_rng_t *rng, igraph_integer_t block) {
+    const igraph_i_umap_epoch_t *ep = data;
+    igraph_integer_t no_of_edges = igraph_ecount(ep->graph);
+    igraph_integer_t from_eid = block * UMAP_EDGE_BLOCK_SIZE;
+    igraph_integer_t to_eid = no_of_edges - from_eid > UMAP_EDGE_BLOCK_SIZE ?
+                              from_eid + UMAP_EDGE_BLOCK_SIZE : no_of_edges;
+
+    IGRAPH_UNUSED(workspace);
+
+    igraph_i_umap_apply_forces_block(ep->graph, ep->umap_weights, ep->adjlist, ep->emb,
+                                     ep->no_of_vertices, ep->ndim, ep->a, ep->b,
+                                     ep->learning_rate, ep->n_negative_vertices, ep->epoch,
+                                     ep->next_epoch_sample_per_edge, rng,
+                                     from_eid, to_eid);
 
-    /* Free vector of neighbors if needed */
-    if (avoid_neighbor_repulsion) {
-        igraph_vector_int_destroy(&neis);
-        IGRAPH_FINALLY_CLEAN(1);
-    }
+    return IGRAPH_SUCCESS;
+}
+
+/* One epoch of stochastic gradient descent. The edges are split into blocks
+ * of UMAP_EDGE_BLOCK_SIZE, and each block draws its random numbers from a
+ * separate stream, see igraph_i_parallel_run_tasks(). When igraph is built
+ * with OpenMP support, blocks are processed in parallel "Hogwild" style:
+ * threads update the shared embedding without any locking. As UMAP moves
+ * only a few vertices per edge, and graphs it is used on are sparse, two
+ * threads rarely move the same vertex at the same time, and an occasional
+ * lost update does no harm to the stochastic gradient descent. The result
+ * is then not reproducible, though; with a single thread it depends only on
+ * the seed. */
+static igraph_error_t igraph_i_umap_apply_forces(
+        const igraph_t *graph,
+        const igraph_vector_t *umap_weights,
+        const igraph_adjlist_t *adjlist,
+        igraph_real_t *emb,
+        igraph_integer_t no_of_vertices,
+        igraph_integer_t ndim,
+        igraph_real_t a,
+        igraph_real_t b,
+        igraph_real_t learning_rate,
+        igraph_integer_t negative_sampling_rate,
+        igraph_integer_t epoch,
+        igraph_vector_t *next_epoch_sample_per_edge)
+{
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_i_umap_epoch_t ep;
+    igraph_i_parallel_tasks_t tasks = { 0 };
+
+    ep.graph = graph;
+    ep.umap_weights = umap_weights;
+    ep.adjlist = adjlist;
+    ep.emb = emb;
+    ep.no_of_vertices = no_of_vertices;
+    ep.ndim = ndim;
+    ep.a = a;
+    ep.b = b;
+    ep.learning_rate = learning_rate;
+    ep.n_negative_vertices = (no_of_vertices - 1 < negative_sampling_rate) ? (no_of_vertices - 1) : negative_sampling_rate;
+    ep.epoch = epoch;
+    ep.next_epoch_sample_per_edge = next_epoch_sample_per_edge;
+
+    tasks.no_of_tasks = (no_of_edges + UMAP_EDGE_BLOCK_SIZE - 1) / UMAP_EDGE_BLOCK_SIZE;
+    tasks.seed = igraph_i_rng_stream_seed();
+    tasks.data = &ep;
+    tasks.run = igraph_i_umap_apply_forces_task;
+    tasks.error_message = "Cannot compute UMAP layout.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
 
     return IGRAPH_SUCCESS;
 }
@@ -930,8 +977,12 @@ static igraph_error_t igraph_i_umap_optimize_layout_stochastic_gradient(
         igraph_integer_t negative_sampling_rate) {
 
     igraph_real_t learning_rate = 1;
+    igraph_integer_t no_of_vertices = igraph_matrix_nrow(layout);
+    igraph_integer_t ndim = igraph_matrix_ncol(layout);
     igraph_integer_t no_of_edges = igraph_ecount(graph);
     igraph_vector_t next_epoch_sample_per_edge;
+    igraph_vector_t emb;
+    igraph_adjlist_t adjlist;
 
 #ifdef UMAP_DEBUG
     igraph_real_t cross_entropy, cross_entropy_old;
@@ -939,6 +990,15 @@ static igraph_error_t igraph_i_umap_optimize_layout_stochastic_gradient(
 
     IGRAPH_VECTOR_INIT_FINALLY(&next_epoch_sample_per_edge, no_of_edges);
 
+    /* Row-major copy of the layout, so that the coordinates of a vertex
+     * are in the same cache line */
+    IGRAPH_VECTOR_INIT_FINALLY(&emb, no_of_vertices * ndim);
+    for (igraph_integer_t i = 0; i < no_of_vertices; i++) {
+        for (igraph_integer_t d = 0; d < ndim; d++) {
+            VECTOR(emb)[i * ndim + d] = MATRIX(*layout, i, d);
+        }
+    }
+
     /* Explicit avoidance of neighbor repulsion, only useful in small graphs
      * which are never very sparse. This is because negative sampling as implemented
      * relies on an approximation that only works if the graph is sparse, which is never
@@ -948,6 +1008,10 @@ static igraph_error_t igraph_i_umap_optimize_layout_stochastic_gradient(
     if (igraph_vcount(graph) < 100) {
         avoid_neighbor_repulsion = 1;
     }
+    if (avoid_neighbor_repulsion) {
+        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+    }
 
     /* Measure the (variable part of the) cross-entropy terms for debugging:
      * 1. - sum_edge_e mu(e) * log(nu(e))
@@ -964,18 +1028,21 @@ static igraph_error_t igraph_i_umap_optimize_layout_stochastic_gradient(
 #endif
 
     for (igraph_integer_t e = 0; e < epochs; e++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+
         /* Apply (stochastic) forces */
-        igraph_i_umap_apply_forces(
+        IGRAPH_CHECK(igraph_i_umap_apply_forces(
                 graph,
                 umap_weights,
-                layout,
+                avoid_neighbor_repulsion ? &adjlist : NULL,
+                VECTOR(emb),
+                no_of_vertices,
+                ndim,
                 a, b,
                 learning_rate,
-                avoid_neighbor_repulsion,
                 negative_sampling_rate,
                 e,
-                epochs,
-                &next_epoch_sample_per_edge);
+                &next_epoch_sample_per_edge));
 
 #ifdef UMAP_DEBUG
         /* Recompute CE and check how it's going*/
@@ -990,8 +1057,19 @@ static igraph_error_t igraph_i_umap_optimize_layout_stochastic_gradient(
         learning_rate = 1.0 - (igraph_real_t)(e + 1) / epochs;
     }
 
+    for (igraph_integer_t i = 0; i < no_of_vertices; i++) {
+        for (igraph_integer_t d = 0; d < ndim; d++) {
+            MATRIX(*layout, i, d) = VECTOR(emb)[i * ndim + d];
+        }
+    }
+
+    if (avoid_neighbor_repulsion) {
+        igraph_adjlist_destroy(&adjlist);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_vector_destroy(&emb);
     igraph_vector_destroy(&next_epoch_sample_per_edge);
-    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -1179,6 +1257,13 @@ static igraph_error_t igraph_i_layout_umap(
  * without computing the layout, see \ref igraph_layout_umap_compute_weights().
  *
  * </para><para>
+ *
+ * When igraph is built with OpenMP support, each epoch of the stochastic
+ * gradient descent processes blocks of edges in parallel, without any locking
+ * between threads. With more than one thread, the result is therefore not
+ * reproducible, even with a fixed random seed.
+ *
+ * </para><para>
  * References:
  *
  * </para><para>
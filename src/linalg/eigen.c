@@ -28,6 +28,9 @@
 #include "igraph_interface.h"
 #include "igraph_adjlist.h"
 
+#include "linalg/lobpcg_internal.h"
+#include "linalg/spmv_internal.h"
+
 #include <limits.h>
 #include <string.h>
 #include <math.h>
@@ -1281,26 +1284,6 @@ igraph_error_t igraph_eigen_matrix(const igraph_matrix_t *A,
     return IGRAPH_SUCCESS;
 }
 
-static igraph_error_t igraph_i_eigen_adjacency_arpack_sym_cb(igraph_real_t *to,
-        const igraph_real_t *from,
-        int n, void *extra) {
-    igraph_adjlist_t *adjlist = (igraph_adjlist_t *) extra;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(adjlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += from[nei];
-        }
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
 static igraph_error_t igraph_i_eigen_adjacency_arpack(const igraph_t *graph,
                                     const igraph_eigen_which_t *which,
                                     igraph_arpack_options_t *options,
@@ -1308,13 +1291,14 @@ static igraph_error_t igraph_i_eigen_adjacency_arpack(const igraph_t *graph,
                                     igraph_vector_t *values,
                                     igraph_matrix_t *vectors,
                                     igraph_vector_complex_t *cmplxvalues,
-                                    igraph_matrix_complex_t *cmplxvectors) {
+                                    igraph_matrix_complex_t *cmplxvectors,
+                                    igraph_i_eigensolver_t solver) {
 
     IGRAPH_UNUSED(cmplxvalues);
     IGRAPH_UNUSED(cmplxvectors);
 
-    igraph_adjlist_t adjlist;
-    void *extra = (void*) &adjlist;
+    igraph_csr_adjlist_t adjlist;
+    igraph_i_csr_matrix_t A;
     igraph_integer_t n = igraph_vcount(graph);
 
     if (!options) {
@@ -1386,18 +1370,41 @@ static igraph_error_t igraph_i_eigen_adjacency_arpack(const igraph_t *graph,
     options->n = (int) n;
     options->ncv = 2 * options->nev < options->n ? 2 * options->nev : options->n;
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
+    IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+    igraph_i_csr_matrix_init(&A, &adjlist, NULL);
 
-    IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_eigen_adjacency_arpack_sym_cb,
-                                       extra, options, storage, values, vectors));
+    /* The block eigensolver cannot find the smallest magnitude eigenvalues
+     * without inverting the matrix, ARPACK is used for those. */
+    if (solver == IGRAPH_I_EIGENSOLVER_LOBPCG && which->pos != IGRAPH_EIGEN_SM) {
+        IGRAPH_CHECK(igraph_i_lobpcg_rssolve(igraph_i_csr_block_cb,
+                                             &A, options, values, vectors));
+    } else {
+        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_csr_arpack_cb,
+                                           &A, options, storage, values, vectors));
+    }
 
-    igraph_adjlist_destroy(&adjlist);
+    igraph_csr_adjlist_destroy(&adjlist);
     IGRAPH_FINALLY_CLEAN(1);
 
     return IGRAPH_SUCCESS;
 }
 
+/* Like igraph_eigen_adjacency() with the ARPACK algorithm, but uses the
+ * block eigensolver, except for the eigenvalues of smallest magnitude. */
+igraph_error_t igraph_i_eigen_adjacency_lobpcg(const igraph_t *graph,
+                                               const igraph_eigen_which_t *which,
+                                               igraph_arpack_options_t *options,
+                                               igraph_vector_t *values,
+                                               igraph_matrix_t *vectors) {
+    if (options == 0) {
+        options = igraph_arpack_options_get_default();
+    }
+    return igraph_i_eigen_adjacency_arpack(graph, which, options, /* storage = */ NULL,
+                                           values, vectors, NULL, NULL,
+                                           IGRAPH_I_EIGENSOLVER_LOBPCG);
+}
+
 /**
  * \function igraph_eigen_adjacency
  *
@@ -1445,7 +1452,7 @@ igraph_error_t igraph_eigen_adjacency(const igraph_t *graph,
         IGRAPH_CHECK(igraph_i_eigen_adjacency_arpack(graph, which, options,
                      storage, values, vectors,
                      cmplxvalues,
-                     cmplxvectors));
+                     cmplxvectors, IGRAPH_I_EIGENSOLVER_ARPACK));
         break;
     case IGRAPH_EIGEN_COMP_LAPACK:
         IGRAPH_ERROR("'COMP_LAPACK' algorithm not implemented yet",
@@ -0,0 +1,581 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "linalg/lobpcg_internal.h"
+
+#include "igraph_blas.h"
+#include "igraph_lapack.h"
+#include "igraph_random.h"
+
+#include "core/interruption.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Relative tolerance of the residual norms when options->tol is zero. */
+#define IGRAPH_I_LOBPCG_DEFAULT_TOL 1e-10
+
+/* Directions of the search space whose eigenvalue in the scaled Gram
+ * matrix is below this, relative to the largest one, are considered
+ * linearly dependent on the others and are dropped. */
+#define IGRAPH_I_LOBPCG_DROP_TOL 1e-10
+
+/* A block is orthonormalized a second time if the reciprocal condition
+ * number of its scaled Gram matrix was below this. */
+#define IGRAPH_I_LOBPCG_REORTH_RCOND 1e-4
+
+/* An igraph_arpack_function_t that applies the igraph_i_block_function_t
+ * given in an igraph_i_block_arpack_data_t to a single vector. */
+igraph_error_t igraph_i_block_arpack_cb(igraph_real_t *to, const igraph_real_t *from,
+                                        int n, void *extra) {
+    igraph_i_block_arpack_data_t *data = extra;
+    return data->fun(to, from, n, 1, data->extra);
+}
+
+/* Chooses count of the eigenvalues in lambda, which must be in increasing
+ * order, according to 'which', and stores their indices in idx, in the
+ * order in which ARPACK would return them. */
+static void igraph_i_lobpcg_select(const igraph_vector_t *lambda, const char *which,
+                                   igraph_integer_t count, igraph_vector_int_t *idx) {
+    igraph_integer_t lo = 0, hi = igraph_vector_size(lambda) - 1;
+
+    for (igraph_integer_t j = 0; j < count; j++) {
+        if (which[0] == 'S') {
+            VECTOR(*idx)[j] = lo++;
+        } else if (which[1] == 'A') {
+            VECTOR(*idx)[j] = hi--;
+        } else if (fabs(VECTOR(*lambda)[lo]) > fabs(VECTOR(*lambda)[hi])) {
+            VECTOR(*idx)[j] = lo++;
+        } else {
+            VECTOR(*idx)[j] = hi--;
+        }
+    }
+}
+
+/* Given the Gram matrix G of the columns of V, computes T such that the
+ * columns of V T are orthonormal and span the same space as V, apart from
+ * the directions in which V is numerically rank deficient (SVQB, see
+ * Stathopoulos and Wu, SIAM J. Sci. Comput. 23, 2165, 2002). T has as
+ * many rows as G and at most as many columns. The reciprocal condition
+ * number of the kept part of the scaled Gram matrix is stored in rcond. */
+static igraph_error_t igraph_i_lobpcg_svqb(const igraph_matrix_t *G, igraph_matrix_t *T,
+                                           igraph_real_t *rcond) {
+    igraph_integer_t m = igraph_matrix_nrow(G), first;
+    igraph_vector_t d, lambda;
+    igraph_matrix_t Gs, V;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&d, m);
+    IGRAPH_VECTOR_INIT_FINALLY(&lambda, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&V, 0, 0);
+    IGRAPH_CHECK(igraph_matrix_init_copy(&Gs, G));
+    IGRAPH_FINALLY(igraph_matrix_destroy, &Gs);
+
+    /* Scale to unit diagonal first, so that short vectors are not dropped. */
+    for (igraph_integer_t i = 0; i < m; i++) {
+        VECTOR(d)[i] = MATRIX(*G, i, i) > 0 ? 1.0 / sqrt(MATRIX(*G, i, i)) : 0.0;
+    }
+    for (igraph_integer_t j = 0; j < m; j++) {
+        for (igraph_integer_t i = 0; i < m; i++) {
+            MATRIX(Gs, i, j) *= VECTOR(d)[i] * VECTOR(d)[j];
+        }
+    }
+
+    IGRAPH_CHECK(igraph_lapack_dsyevr(&Gs, IGRAPH_LAPACK_DSYEV_ALL, 0, 0, 0, 0, 0,
+                                      1e-14, &lambda, &V, NULL));
+
+    for (first = 0; first < m; first++) {
+        if (VECTOR(lambda)[first] > IGRAPH_I_LOBPCG_DROP_TOL * VECTOR(lambda)[m - 1]) {
+            break;
+        }
+    }
+
+    *rcond = first < m ? VECTOR(lambda)[first] / VECTOR(lambda)[m - 1] : 0.0;
+    IGRAPH_CHECK(igraph_matrix_resize(T, m, m - first));
+    for (igraph_integer_t j = first; j < m; j++) {
+        igraph_real_t s = 1.0 / sqrt(VECTOR(lambda)[j]);
+        for (igraph_integer_t i = 0; i < m; i++) {
+            MATRIX(*T, i, j - first) = VECTOR(d)[i] * MATRIX(V, i, j) * s;
+        }
+    }
+
+    igraph_matrix_destroy(&Gs);
+    igraph_matrix_destroy(&V);
+    igraph_vector_destroy(&lambda);
+    igraph_vector_destroy(&d);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Makes the k columns of the n-by-k matrix v orthogonal to the q columns
+ * of u, which must be orthonormal, and then orthonormal among themselves.
+ * Columns that turn out to be numerically linearly dependent are dropped,
+ * the number of remaining columns is returned in kk. If av is not NULL,
+ * it holds the operator applied to v, and is updated with the same linear
+ * transformations, using au, the operator applied to u. Both steps are
+ * repeated once if the projection cancelled most of a column or the
+ * block was ill-conditioned, which is enough for full accuracy. tmp and
+ * atmp must have room for n*k values each. */
+static igraph_error_t igraph_i_lobpcg_orthonormalize(const igraph_real_t *u,
+                                                     const igraph_real_t *au,
+                                                     igraph_integer_t q,
+                                                     igraph_real_t *v, igraph_real_t *av,
+                                                     igraph_integer_t n, igraph_integer_t k,
+                                                     igraph_integer_t *kk,
+                                                     igraph_real_t *tmp, igraph_real_t *atmp) {
+    igraph_matrix_t uv, auv, vv, avv, tv, C, T;
+    igraph_vector_t norm2;
+
+    IGRAPH_MATRIX_INIT_FINALLY(&C, 0, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&T, 0, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&norm2, k);
+
+    for (int pass = 0; pass < 2 && k > 0; pass++) {
+        igraph_bool_t accurate = true;
+        igraph_real_t rcond;
+
+        igraph_matrix_view(&vv, v, n, k);
+        if (q > 0) {
+            for (igraph_integer_t j = 0; j < k; j++) {
+                const igraph_real_t *col = v + j * n;
+                igraph_real_t sum = 0.0;
+                for (igraph_integer_t i = 0; i < n; i++) {
+                    sum += col[i] * col[i];
+                }
+                VECTOR(norm2)[j] = sum;
+            }
+            igraph_matrix_view(&uv, u, n, q);
+            IGRAPH_CHECK(igraph_blas_dgemm(true, false, 1.0, &uv, &vv, 0.0, &C));
+            IGRAPH_CHECK(igraph_blas_dgemm(false, false, -1.0, &uv, &C, 1.0, &vv));
+            if (av) {
+                igraph_matrix_view(&auv, au, n, q);
+                igraph_matrix_view(&avv, av, n, k);
+                IGRAPH_CHECK(igraph_blas_dgemm(false, false, -1.0, &auv, &C, 1.0, &avv));
+            }
+        }
+
+        IGRAPH_CHECK(igraph_blas_dgemm(true, false, 1.0, &vv, &vv, 0.0, &C));
+        if (q > 0) {
+            /* Daniel-Gragg-Kaufman-Stewart criterion: the projection is
+             * accurate unless it shortened a column by more than 1/sqrt(2) */
+            for (igraph_integer_t j = 0; j < k; j++) {
+                if (MATRIX(C, j, j) < 0.5 * VECTOR(norm2)[j]) {
+                    accurate = false;
+                }
+            }
+        }
+        IGRAPH_CHECK(igraph_i_lobpcg_svqb(&C, &T, &rcond));
+        k = igraph_matrix_ncol(&T);
+        if (k == 0) {
+            break;
+        }
+        igraph_matrix_view(&tv, tmp, n, k);
+        IGRAPH_CHECK(igraph_blas_dgemm(false, false, 1.0, &vv, &T, 0.0, &tv));
+        memcpy(v, tmp, sizeof(igraph_real_t) * n * k);
+        if (av) {
+            igraph_matrix_view(&avv, av, n, igraph_matrix_nrow(&T));
+            igraph_matrix_view(&tv, atmp, n, k);
+            IGRAPH_CHECK(igraph_blas_dgemm(false, false, 1.0, &avv, &T, 0.0, &tv));
+            memcpy(av, atmp, sizeof(igraph_real_t) * n * k);
+        }
+
+        if (accurate && rcond > IGRAPH_I_LOBPCG_REORTH_RCOND) {
+            break;
+        }
+    }
+    *kk = k;
+
+    igraph_vector_destroy(&norm2);
+    igraph_matrix_destroy(&T);
+    igraph_matrix_destroy(&C);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Rayleigh-Ritz projection onto the space spanned by the m orthonormal
+ * columns of the n-by-m matrix s, where as holds the operator applied to
+ * s. Computes the b wanted Ritz values in theta and the m-by-b matrix Z,
+ * such that s Z are the corresponding Ritz vectors. If x_is_ritz is true,
+ * the first b columns of s are the Ritz vectors of the previous step with
+ * the Ritz values given in theta, so that their block of the projected
+ * matrix is not computed again. anorm is updated with the largest Ritz
+ * value in absolute value seen so far, as an estimate of the norm of the
+ * operator. */
+static igraph_error_t igraph_i_lobpcg_rayleigh_ritz(const igraph_real_t *s,
+                                                    const igraph_real_t *as,
+                                                    igraph_integer_t n, igraph_integer_t m,
+                                                    const char *which, igraph_integer_t b,
+                                                    igraph_bool_t x_is_ritz,
+                                                    igraph_vector_t *theta, igraph_matrix_t *Z,
+                                                    igraph_real_t *anorm) {
+    igraph_matrix_t sv, asv, H, Y;
+    igraph_vector_t lambda;
+    igraph_vector_int_t idx;
+
+    IGRAPH_MATRIX_INIT_FINALLY(&H, m, m);
+    IGRAPH_MATRIX_INIT_FINALLY(&Y, 0, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&lambda, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&idx, b);
+
+    if (x_is_ritz && m > b) {
+        /* H = [diag(theta), S_x' A S_r; S_r' A S_x, S_r' A S_r], where S_r
+         * is the rest of S, and only the last m-b columns are computed. */
+        igraph_matrix_t Hr;
+        igraph_matrix_view(&sv, s, n, m);
+        igraph_matrix_view(&asv, as + b * n, n, m - b);
+        IGRAPH_MATRIX_INIT_FINALLY(&Hr, 0, 0);
+        IGRAPH_CHECK(igraph_blas_dgemm(true, false, 1.0, &sv, &asv, 0.0, &Hr));
+        for (igraph_integer_t j = 0; j < b; j++) {
+            MATRIX(H, j, j) = VECTOR(*theta)[j];
+        }
+        for (igraph_integer_t j = b; j < m; j++) {
+            for (igraph_integer_t i = 0; i < m; i++) {
+                MATRIX(H, i, j) = MATRIX(Hr, i, j - b);
+            }
+            for (igraph_integer_t i = 0; i < b; i++) {
+                MATRIX(H, j, i) = MATRIX(Hr, i, j - b);
+            }
+        }
+        igraph_matrix_destroy(&Hr);
+        IGRAPH_FINALLY_CLEAN(1);
+    } else {
+        igraph_matrix_view(&sv, s, n, m);
+        igraph_matrix_view(&asv, as, n, m);
+        IGRAPH_CHECK(igraph_blas_dgemm(true, false, 1.0, &sv, &asv, 0.0, &H));
+    }
+    for (igraph_integer_t j = 0; j < m; j++) {
+        for (igraph_integer_t i = 0; i < j; i++) {
+            igraph_real_t h = (MATRIX(H, i, j) + MATRIX(H, j, i)) / 2;
+            MATRIX(H, i, j) = MATRIX(H, j, i) = h;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_lapack_dsyevr(&H, IGRAPH_LAPACK_DSYEV_ALL, 0, 0, 0, 0, 0,
+                                      1e-14, &lambda, &Y, NULL));
+    if (fabs(VECTOR(lambda)[0]) > *anorm) {
+        *anorm = fabs(VECTOR(lambda)[0]);
+    }
+    if (fabs(VECTOR(lambda)[m - 1]) > *anorm) {
+        *anorm = fabs(VECTOR(lambda)[m - 1]);
+    }
+
+    igraph_i_lobpcg_select(&lambda, which, b, &idx);
+    IGRAPH_CHECK(igraph_matrix_resize(Z, m, b));
+    IGRAPH_CHECK(igraph_vector_resize(theta, b));
+    for (igraph_integer_t j = 0; j < b; j++) {
+        igraph_integer_t k = VECTOR(idx)[j];
+        VECTOR(*theta)[j] = VECTOR(lambda)[k];
+        memcpy(&MATRIX(*Z, 0, j), &MATRIX(Y, 0, k), sizeof(igraph_real_t) * m);
+    }
+
+    igraph_vector_int_destroy(&idx);
+    igraph_vector_destroy(&lambda);
+    igraph_matrix_destroy(&Y);
+    igraph_matrix_destroy(&H);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* c = alpha a b + beta c for column-major blocks stored without gaps. */
+static igraph_error_t igraph_i_lobpcg_gemm(igraph_real_t alpha,
+                                           const igraph_real_t *a, igraph_integer_t arow,
+                                           igraph_integer_t acol,
+                                           const igraph_matrix_t *b, igraph_real_t beta,
+                                           igraph_real_t *c) {
+    igraph_matrix_t av, cv;
+    igraph_matrix_view(&av, a, arow, acol);
+    igraph_matrix_view(&cv, c, arow, igraph_matrix_ncol(b));
+    return igraph_blas_dgemm(false, false, alpha, &av, b, beta, &cv);
+}
+
+/* For problems that are too small for the block iteration, the operator
+ * is applied to the identity matrix, and the resulting dense matrix is
+ * diagonalized directly. */
+static igraph_error_t igraph_i_lobpcg_dense(igraph_i_block_function_t *fun, void *extra,
+                                            igraph_arpack_options_t *options,
+                                            igraph_vector_t *values,
+                                            igraph_matrix_t *vectors) {
+    igraph_integer_t n = options->n, nev = options->nev;
+    igraph_matrix_t I, M, V;
+    igraph_vector_t lambda;
+    igraph_vector_int_t idx;
+
+    IGRAPH_MATRIX_INIT_FINALLY(&I, n, n);
+    IGRAPH_MATRIX_INIT_FINALLY(&M, n, n);
+    IGRAPH_MATRIX_INIT_FINALLY(&V, 0, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&lambda, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&idx, nev);
+
+    for (igraph_integer_t i = 0; i < n; i++) {
+        MATRIX(I, i, i) = 1.0;
+    }
+    IGRAPH_CHECK(fun(&MATRIX(M, 0, 0), &MATRIX(I, 0, 0), n, n, extra));
+    for (igraph_integer_t j = 0; j < n; j++) {
+        for (igraph_integer_t i = 0; i < j; i++) {
+            igraph_real_t h = (MATRIX(M, i, j) + MATRIX(M, j, i)) / 2;
+            MATRIX(M, i, j) = MATRIX(M, j, i) = h;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_lapack_dsyevr(&M, IGRAPH_LAPACK_DSYEV_ALL, 0, 0, 0, 0, 0,
+                                      1e-14, &lambda, &V, NULL));
+    igraph_i_lobpcg_select(&lambda, options->which, nev, &idx);
+
+    if (values) {
+        IGRAPH_CHECK(igraph_vector_resize(values, nev));
+        for (igraph_integer_t j = 0; j < nev; j++) {
+            VECTOR(*values)[j] = VECTOR(lambda)[VECTOR(idx)[j]];
+        }
+    }
+    if (vectors) {
+        IGRAPH_CHECK(igraph_matrix_resize(vectors, n, nev));
+        for (igraph_integer_t j = 0; j < nev; j++) {
+            memcpy(&MATRIX(*vectors, 0, j), &MATRIX(V, 0, VECTOR(idx)[j]),
+                   sizeof(igraph_real_t) * n);
+        }
+    }
+
+    options->noiter = 0;
+    options->nconv = (int) nev;
+    options->numop = (int) n;
+
+    igraph_vector_int_destroy(&idx);
+    igraph_vector_destroy(&lambda);
+    igraph_matrix_destroy(&V);
+    igraph_matrix_destroy(&M);
+    igraph_matrix_destroy(&I);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * Block eigensolver for symmetric operators, an alternative to
+ * igraph_arpack_rssolve() that applies the operator to a whole block of
+ * vectors at once. This is LOBPCG without preconditioning (Knyazev, SIAM
+ * J. Sci. Comput. 23, 517, 2001) with soft locking of converged vectors.
+ * All dense linear algebra is done with BLAS-3 and LAPACK calls on the
+ * block, only the operator itself is applied through \p fun.
+ *
+ * The following members of \p options are used: \c n, \c nev, \c which
+ * (LA, SA or LM), \c tol, \c mxiter and \c start, as in ARPACK; \c nb is
+ * ignored. The block holds \c nev plus a few guard vectors.
+ * A Ritz pair is converged when the norm of its residual is at
+ * most \c tol times the estimated norm of the operator, zero \c tol means
+ * 1e-10. \c noiter, \c nconv and \c numop are set on return. The results
+ * are ordered as in igraph_arpack_rssolve().
+ */
+igraph_error_t igraph_i_lobpcg_rssolve(igraph_i_block_function_t *fun, void *extra,
+                                       igraph_arpack_options_t *options,
+                                       igraph_vector_t *values,
+                                       igraph_matrix_t *vectors) {
+    igraph_integer_t n = options->n, nev = options->nev;
+    igraph_integer_t guard = nev / 2 > 3 ? nev / 2 : 3;
+    igraph_integer_t b = nev + guard;
+    igraph_real_t tol = options->tol > 0 ? options->tol : IGRAPH_I_LOBPCG_DEFAULT_TOL;
+    const char *which = options->which;
+    igraph_real_t anorm = 0.0;
+    igraph_integer_t iter, nconv = 0, numop = 0;
+    igraph_bool_t have_p = false;
+    igraph_integer_t m;
+    igraph_matrix_t S, AS, P, AP, Z, Zx, Zp;
+    igraph_real_t *s, *as, *p, *ap;
+    igraph_vector_t theta;
+    igraph_vector_int_t active;
+
+    if (n <= 0) {
+        IGRAPH_ERROR("The dimension of the eigenproblem must be positive.", IGRAPH_ARPACK_NPOS);
+    }
+    if (nev <= 0 || nev > n) {
+        IGRAPH_ERROR("The number of eigenvalues must be positive and at most the dimension "
+                     "of the eigenproblem.", IGRAPH_ARPACK_NEVNPOS);
+    }
+    if (options->mxiter <= 0) {
+        IGRAPH_ERROR("The maximum number of iterations must be positive.", IGRAPH_ARPACK_NONPOSI);
+    }
+    if (options->mode != 1) {
+        IGRAPH_ERROR("The block eigensolver only supports standard eigenproblems (mode 1).",
+                     IGRAPH_ARPACK_MODEINV);
+    }
+    if (!((which[0] == 'L' && which[1] == 'A') || (which[0] == 'S' && which[1] == 'A') ||
+          (which[0] == 'L' && which[1] == 'M'))) {
+        IGRAPH_ERROR("The block eigensolver supports the LA, SA and LM eigenvalue "
+                     "selections only.", IGRAPH_ARPACK_WHICHINV);
+    }
+
+    /* The search space has up to 3b vectors. */
+    if (3 * b >= n) {
+        return igraph_i_lobpcg_dense(fun, extra, options, values, vectors);
+    }
+
+    /* S holds the blocks X, W and P of the search space next to each
+     * other, X in the first b columns, followed by W and P, which have at
+     * most one column for each vector that has not converged yet. All
+     * columns of S are orthonormal. AS holds the operator applied to S.
+     * P and AP keep the search directions between iterations, and are
+     * used as temporary storage otherwise. */
+    IGRAPH_MATRIX_INIT_FINALLY(&S, n, 3 * b);
+    IGRAPH_MATRIX_INIT_FINALLY(&AS, n, 3 * b);
+    IGRAPH_MATRIX_INIT_FINALLY(&P, n, b);
+    IGRAPH_MATRIX_INIT_FINALLY(&AP, n, b);
+    IGRAPH_MATRIX_INIT_FINALLY(&Z, 0, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&Zx, 0, 0);
+    IGRAPH_MATRIX_INIT_FINALLY(&Zp, 0, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&theta, b);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&active, 0);
+    s = &MATRIX(S, 0, 0);
+    as = &MATRIX(AS, 0, 0);
+    p = &MATRIX(P, 0, 0);
+    ap = &MATRIX(AP, 0, 0);
+
+    RNG_BEGIN();
+    for (igraph_integer_t i = 0; i < b * n; i++) {
+        s[i] = RNG_UNIF(-1, 1);
+    }
+    RNG_END();
+    if (options->start && vectors &&
+        igraph_matrix_nrow(vectors) == n && igraph_matrix_ncol(vectors) >= 1) {
+        memcpy(s, &MATRIX(*vectors, 0, 0), sizeof(igraph_real_t) * n);
+    }
+    IGRAPH_CHECK(igraph_i_lobpcg_orthonormalize(NULL, NULL, 0, s, NULL, n, b, &m, p, ap));
+    if (m < b) {
+        IGRAPH_ERROR("Could not generate linearly independent start vectors for the "
+                     "block eigensolver.", IGRAPH_DIVERGED);
+    }
+    IGRAPH_CHECK(fun(as, s, n, b, extra));
+    numop += b;
+
+    for (iter = 0; ; iter++) {
+        igraph_integer_t a, aw, ap_cols;
+        igraph_real_t threshold;
+
+        IGRAPH_CHECK(igraph_i_lobpcg_rayleigh_ritz(s, as, n, m, which, b, iter > 0,
+                                                   &theta, &Z, &anorm));
+
+        /* P = [W P] Z_wp, then X = X Z_x + P */
+        IGRAPH_CHECK(igraph_matrix_resize(&Zx, b, b));
+        for (igraph_integer_t j = 0; j < b; j++) {
+            memcpy(&MATRIX(Zx, 0, j), &MATRIX(Z, 0, j), sizeof(igraph_real_t) * b);
+        }
+        if (m > b) {
+            IGRAPH_CHECK(igraph_matrix_resize(&Zp, m - b, b));
+            for (igraph_integer_t j = 0; j < b; j++) {
+                memcpy(&MATRIX(Zp, 0, j), &MATRIX(Z, b, j), sizeof(igraph_real_t) * (m - b));
+            }
+            IGRAPH_CHECK(igraph_i_lobpcg_gemm(1.0, s + b * n, n, m - b, &Zp, 0.0, p));
+            IGRAPH_CHECK(igraph_i_lobpcg_gemm(1.0, as + b * n, n, m - b, &Zp, 0.0, ap));
+            memcpy(s + b * n, p, sizeof(igraph_real_t) * n * b);
+            memcpy(as + b * n, ap, sizeof(igraph_real_t) * n * b);
+        }
+        IGRAPH_CHECK(igraph_i_lobpcg_gemm(1.0, s, n, b, &Zx, m > b ? 1.0 : 0.0, s + b * n));
+        IGRAPH_CHECK(igraph_i_lobpcg_gemm(1.0, as, n, b, &Zx, m > b ? 1.0 : 0.0, as + b * n));
+        memcpy(s, s + b * n, sizeof(igraph_real_t) * n * b);
+        memcpy(as, as + b * n, sizeof(igraph_real_t) * n * b);
+        have_p = m > b;
+
+        threshold = tol * anorm;
+        nconv = 0;
+        igraph_vector_int_clear(&active);
+        for (igraph_integer_t j = 0; j < b; j++) {
+            const igraph_real_t *x = s + j * n, *ax = as + j * n;
+            igraph_real_t t = VECTOR(theta)[j], sum = 0.0;
+            for (igraph_integer_t i = 0; i < n; i++) {
+                igraph_real_t r = ax[i] - t * x[i];
+                sum += r * r;
+            }
+            if (sqrt(sum) <= threshold) {
+                if (j < nev) {
+                    nconv++;
+                }
+            } else {
+                IGRAPH_CHECK(igraph_vector_int_push_back(&active, j));
+            }
+        }
+
+        if (nconv == nev || iter >= options->mxiter) {
+            break;
+        }
+
+        /* W: the residuals of the active vectors, and P: their previous
+         * search directions, which are put after the space for W for now */
+        a = igraph_vector_int_size(&active);
+        for (igraph_integer_t k = 0; k < a; k++) {
+            igraph_integer_t j = VECTOR(active)[k];
+            const igraph_real_t *x = s + j * n, *ax = as + j * n;
+            igraph_real_t *w = s + (b + k) * n, t = VECTOR(theta)[j];
+            for (igraph_integer_t i = 0; i < n; i++) {
+                w[i] = ax[i] - t * x[i];
+            }
+            if (have_p) {
+                memcpy(s + (2 * b + k) * n, p + j * n, sizeof(igraph_real_t) * n);
+                memcpy(as + (2 * b + k) * n, ap + j * n, sizeof(igraph_real_t) * n);
+            }
+        }
+
+        IGRAPH_CHECK(igraph_i_lobpcg_orthonormalize(s, NULL, b, s + b * n, NULL, n, a,
+                                                    &aw, p, ap));
+        IGRAPH_CHECK(fun(as + b * n, s + b * n, n, aw, extra));
+        numop += aw;
+        m = b + aw;
+
+        if (have_p) {
+            memmove(s + m * n, s + 2 * b * n, sizeof(igraph_real_t) * n * a);
+            memmove(as + m * n, as + 2 * b * n, sizeof(igraph_real_t) * n * a);
+            IGRAPH_CHECK(igraph_i_lobpcg_orthonormalize(s, as, m, s + m * n, as + m * n, n, a,
+                                                        &ap_cols, p, ap));
+            m += ap_cols;
+        }
+
+        IGRAPH_ALLOW_INTERRUPTION();
+    }
+
+    options->noiter = (int) iter;
+    options->nconv = (int) nconv;
+    options->numop = (int) numop;
+
+    if (nconv < nev) {
+        IGRAPH_WARNINGF("Block eigensolver failed to converge (%" IGRAPH_PRId
+                        " iterations, %" IGRAPH_PRId "/%" IGRAPH_PRId
+                        " eigenvectors converged).", iter, nconv, nev);
+        IGRAPH_ERROR("Block eigensolver did not converge.", IGRAPH_ARPACK_MAXIT);
+    }
+
+    if (values) {
+        IGRAPH_CHECK(igraph_vector_resize(values, nev));
+        memcpy(VECTOR(*values), VECTOR(theta), sizeof(igraph_real_t) * nev);
+    }
+    if (vectors) {
+        IGRAPH_CHECK(igraph_matrix_resize(vectors, n, nev));
+        memcpy(&MATRIX(*vectors, 0, 0), s, sizeof(igraph_real_t) * n * nev);
+    }
+
+    igraph_vector_int_destroy(&active);
+    igraph_vector_destroy(&theta);
+    igraph_matrix_destroy(&Zp);
+    igraph_matrix_destroy(&Zx);
+    igraph_matrix_destroy(&Z);
+    igraph_matrix_destroy(&AP);
+    igraph_matrix_destroy(&P);
+    igraph_matrix_destroy(&AS);
+    igraph_matrix_destroy(&S);
+    IGRAPH_FINALLY_CLEAN(9);
+
+    return IGRAPH_SUCCESS;
+}
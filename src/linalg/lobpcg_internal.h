@@ -0,0 +1,71 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_LOBPCG_INTERNAL_H
+#define IGRAPH_LOBPCG_INTERNAL_H
+
+#include "igraph_arpack.h"
+#include "igraph_datatype.h"
+#include "igraph_decls.h"
+#include "igraph_eigen.h"
+#include "igraph_matrix.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+
+__BEGIN_DECLS
+
+/* The eigensolver used by the internal variants of the functions that
+ * can use the block eigensolver. The public functions always use ARPACK,
+ * as igraph_arpack_options_t has no room for this choice. */
+typedef enum {
+    IGRAPH_I_EIGENSOLVER_ARPACK = 0,
+    IGRAPH_I_EIGENSOLVER_LOBPCG
+} igraph_i_eigensolver_t;
+
+/* Multiplies the ncol columns of the n-by-ncol column-major matrix
+ * 'from' with a symmetric operator and stores the results in 'to'. */
+typedef igraph_error_t igraph_i_block_function_t(igraph_real_t *to,
+                                                 const igraph_real_t *from,
+                                                 igraph_integer_t n,
+                                                 igraph_integer_t ncol,
+                                                 void *extra);
+
+/* Wraps an igraph_i_block_function_t so that it can be used with ARPACK,
+ * see igraph_i_block_arpack_cb(). */
+typedef struct igraph_i_block_arpack_data_t {
+    igraph_i_block_function_t *fun;
+    void *extra;
+} igraph_i_block_arpack_data_t;
+
+igraph_error_t igraph_i_block_arpack_cb(igraph_real_t *to, const igraph_real_t *from,
+                                        int n, void *extra);
+
+igraph_error_t igraph_i_lobpcg_rssolve(igraph_i_block_function_t *fun, void *extra,
+                                       igraph_arpack_options_t *options,
+                                       igraph_vector_t *values,
+                                       igraph_matrix_t *vectors);
+
+igraph_error_t igraph_i_eigen_adjacency_lobpcg(const igraph_t *graph,
+                                               const igraph_eigen_which_t *which,
+                                               igraph_arpack_options_t *options,
+                                               igraph_vector_t *values,
+                                               igraph_matrix_t *vectors);
+
+__END_DECLS
+
+#endif
@@ -0,0 +1,301 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "linalg/spmv_internal.h"
+
+#include "igraph_memory.h"
+
+#include "core/parallel.h"
+
+/* Matrices with fewer stored entries plus rows than this are processed
+ * by a single thread, as starting the threads would take longer. */
+#define IGRAPH_I_SPMV_PARALLEL_THRESHOLD 20000
+
+/* Number of columns that igraph_i_csr_spmm() multiplies at once. */
+#define IGRAPH_I_SPMM_BLOCK 16
+
+/* Sets up A as the plain adjacency (or weight) matrix given by
+ * the adjacency list, i.e. alpha = 1 without any scaling. */
+void igraph_i_csr_matrix_init(igraph_i_csr_matrix_t *A,
+                              const igraph_csr_adjlist_t *adjlist,
+                              const igraph_vector_t *weights) {
+    A->nrow = A->ncol = adjlist->length;
+    A->rowptr = VECTOR(adjlist->offsets);
+    A->colidx = VECTOR(adjlist->neis);
+    A->eids = weights ? VECTOR(adjlist->eids) : NULL;
+    A->values = weights ? VECTOR(*weights) : NULL;
+    A->alpha = 1.0;
+    A->row_scale = NULL;
+    A->col_scale = NULL;
+    A->diag = NULL;
+    A->accumulate = false;
+}
+
+/* Sets up A as the matrix M, without any scaling. */
+void igraph_i_csr_matrix_init_sparsemat(igraph_i_csr_matrix_t *A,
+                                        const igraph_sparsemat_csr_t *M) {
+    A->nrow = M->nrow;
+    A->ncol = M->ncol;
+    A->rowptr = VECTOR(M->rowptr);
+    A->colidx = VECTOR(M->colidx);
+    A->eids = NULL;
+    A->values = VECTOR(M->values);
+    A->alpha = 1.0;
+    A->row_scale = NULL;
+    A->col_scale = NULL;
+    A->diag = NULL;
+    A->accumulate = false;
+}
+
+/* The number of row ranges that an operation on the nrow rows given by
+ * rowptr is split into. */
+igraph_integer_t igraph_i_csr_parts(igraph_integer_t nrow, const igraph_integer_t *rowptr) {
+    igraph_integer_t work = rowptr[nrow] + nrow;
+    return work < IGRAPH_I_SPMV_PARALLEL_THRESHOLD ? 1 : igraph_i_parallel_max_threads();
+}
+
+/* The first row of the part-th of parts row ranges. The ranges are
+ * balanced by the number of stored entries plus the number of rows. */
+igraph_integer_t igraph_i_csr_part_start(igraph_integer_t nrow, const igraph_integer_t *rowptr,
+                                         igraph_integer_t part, igraph_integer_t parts) {
+    igraph_integer_t target = (rowptr[nrow] + nrow) * part / parts;
+    igraph_integer_t lo = 0, hi = nrow;
+
+    /* smallest row r with rowptr[r] + r >= target */
+    while (lo < hi) {
+        igraph_integer_t mid = lo + (hi - lo) / 2;
+        if (rowptr[mid] + mid < target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+/* The value of the k-th stored entry of A, when it has values. */
+static inline igraph_real_t igraph_i_csr_value(const igraph_i_csr_matrix_t *A, igraph_integer_t k) {
+    return A->eids ? A->values[A->eids[k]] : A->values[k];
+}
+
+/* to[i] for begin <= i < end */
+static void igraph_i_csr_spmv_rows(const igraph_i_csr_matrix_t *A,
+                                   const igraph_real_t *from, igraph_real_t *to,
+                                   igraph_integer_t begin, igraph_integer_t end) {
+    const igraph_integer_t *rowptr = A->rowptr;
+    const igraph_integer_t *colidx = A->colidx;
+    const igraph_real_t *cs = A->col_scale ? VECTOR(*A->col_scale) : NULL;
+    const igraph_real_t *rs = A->row_scale ? VECTOR(*A->row_scale) : NULL;
+    const igraph_real_t *diag = A->diag ? VECTOR(*A->diag) : NULL;
+    igraph_real_t alpha = A->alpha;
+
+    for (igraph_integer_t i = begin; i < end; i++) {
+        igraph_integer_t k, kend = rowptr[i + 1];
+        igraph_real_t sum = 0.0;
+
+        if (A->values && cs) {
+            for (k = rowptr[i]; k < kend; k++) {
+                sum += igraph_i_csr_value(A, k) * (cs[colidx[k]] * from[colidx[k]]);
+            }
+        } else if (A->values) {
+            for (k = rowptr[i]; k < kend; k++) {
+                sum += igraph_i_csr_value(A, k) * from[colidx[k]];
+            }
+        } else if (cs) {
+            for (k = rowptr[i]; k < kend; k++) {
+                sum += cs[colidx[k]] * from[colidx[k]];
+            }
+        } else {
+            for (k = rowptr[i]; k < kend; k++) {
+                sum += from[colidx[k]];
+            }
+        }
+
+        if (alpha != 1.0) {
+            sum *= alpha;
+        }
+        if (diag) {
+            sum += diag[i] * from[i];
+        }
+        if (rs) {
+            sum = rs[i] * sum;
+        }
+        to[i] = A->accumulate ? to[i] + sum : sum;
+    }
+}
+
+/**
+ * Computes to = R (alpha A C + D) from, see igraph_i_csr_matrix_t. The
+ * rows are split between threads when the matrix is large enough; each
+ * element of the result is computed by a single thread in the same way,
+ * so the result does not depend on the number of threads. \p from and
+ * \p to must not overlap.
+ */
+void igraph_i_csr_spmv(const igraph_i_csr_matrix_t *A,
+                       const igraph_real_t *from, igraph_real_t *to) {
+    igraph_integer_t parts = igraph_i_csr_parts(A->nrow, A->rowptr);
+
+    if (parts == 1) {
+        igraph_i_csr_spmv_rows(A, from, to, 0, A->nrow);
+        return;
+    }
+
+    IGRAPH_I_OMP(omp parallel for schedule(static, 1))
+    for (igraph_integer_t p = 0; p < parts; p++) {
+        igraph_i_csr_spmv_rows(A, from, to,
+                               igraph_i_csr_part_start(A->nrow, A->rowptr, p, parts),
+                               igraph_i_csr_part_start(A->nrow, A->rowptr, p + 1, parts));
+    }
+}
+
+/* to[j * nrow + i] for begin <= i < end and 0 <= j < ncol, where from_t
+ * holds the ncol input columns in row-major order, so that the entries
+ * belonging to a column index of A are next to each other in memory. */
+static void igraph_i_csr_spmm_rows(const igraph_i_csr_matrix_t *A,
+                                   const igraph_real_t *from_t, igraph_real_t *to,
+                                   igraph_integer_t ncol,
+                                   igraph_integer_t begin, igraph_integer_t end) {
+    const igraph_integer_t *rowptr = A->rowptr;
+    const igraph_integer_t *colidx = A->colidx;
+    const igraph_real_t *cs = A->col_scale ? VECTOR(*A->col_scale) : NULL;
+    const igraph_real_t *rs = A->row_scale ? VECTOR(*A->row_scale) : NULL;
+    const igraph_real_t *diag = A->diag ? VECTOR(*A->diag) : NULL;
+    igraph_real_t alpha = A->alpha;
+    igraph_integer_t n = A->nrow;
+    igraph_real_t sum[IGRAPH_I_SPMM_BLOCK];
+
+    for (igraph_integer_t i = begin; i < end; i++) {
+        for (igraph_integer_t j = 0; j < ncol; j++) {
+            sum[j] = 0.0;
+        }
+
+        /* The same operations as in igraph_i_csr_spmv_rows(), so that
+         * each column gets exactly the same result. */
+        for (igraph_integer_t k = rowptr[i]; k < rowptr[i + 1]; k++) {
+            const igraph_real_t *x = from_t + colidx[k] * ncol;
+            if (A->values && cs) {
+                igraph_real_t wk = igraph_i_csr_value(A, k), c = cs[colidx[k]];
+                for (igraph_integer_t j = 0; j < ncol; j++) {
+                    sum[j] += wk * (c * x[j]);
+                }
+            } else if (A->values) {
+                igraph_real_t wk = igraph_i_csr_value(A, k);
+                for (igraph_integer_t j = 0; j < ncol; j++) {
+                    sum[j] += wk * x[j];
+                }
+            } else if (cs) {
+                igraph_real_t c = cs[colidx[k]];
+                for (igraph_integer_t j = 0; j < ncol; j++) {
+                    sum[j] += c * x[j];
+                }
+            } else {
+                for (igraph_integer_t j = 0; j < ncol; j++) {
+                    sum[j] += x[j];
+                }
+            }
+        }
+
+        for (igraph_integer_t j = 0; j < ncol; j++) {
+            igraph_real_t r = sum[j];
+            if (alpha != 1.0) {
+                r *= alpha;
+            }
+            if (diag) {
+                r += diag[i] * from_t[i * ncol + j];
+            }
+            if (rs) {
+                r = rs[i] * r;
+            }
+            to[j * n + i] = A->accumulate ? to[j * n + i] + r : r;
+        }
+    }
+}
+
+/**
+ * Multiplies the \p ncol columns of the column-major matrix \p from,
+ * which has as many rows as \p A has columns, like \ref igraph_i_csr_spmv()
+ * and stores the results in the columns of \p to. The columns are
+ * processed in groups of up to IGRAPH_I_SPMM_BLOCK, which are first
+ * copied to row-major order. This way the entries of the group that
+ * belong to a column index of \p A are read together, instead of once
+ * for each column. Each column of the result is the same as what
+ * \ref igraph_i_csr_spmv() would give. \p from and \p to must not overlap.
+ */
+igraph_error_t igraph_i_csr_spmm(const igraph_i_csr_matrix_t *A,
+                                 const igraph_real_t *from, igraph_real_t *to,
+                                 igraph_integer_t ncol) {
+    igraph_integer_t n = A->nrow, m = A->ncol;
+    igraph_integer_t parts = igraph_i_csr_parts(A->nrow, A->rowptr);
+    igraph_integer_t block = ncol < IGRAPH_I_SPMM_BLOCK ? ncol : IGRAPH_I_SPMM_BLOCK;
+    igraph_real_t *from_t;
+
+    if (ncol == 1) {
+        igraph_i_csr_spmv(A, from, to);
+        return IGRAPH_SUCCESS;
+    }
+    if (ncol == 0 || n == 0) {
+        return IGRAPH_SUCCESS;
+    }
+
+    from_t = IGRAPH_CALLOC(m * block, igraph_real_t);
+    IGRAPH_CHECK_OOM(from_t, "Insufficient memory for sparse matrix multiplication.");
+    IGRAPH_FINALLY(igraph_free, from_t);
+
+    for (igraph_integer_t c = 0; c < ncol; c += block) {
+        igraph_integer_t nc = ncol - c < block ? ncol - c : block;
+        const igraph_real_t *fc = from + c * m;
+
+        IGRAPH_I_OMP(omp parallel for if (parts > 1))
+        for (igraph_integer_t i = 0; i < m; i++) {
+            for (igraph_integer_t j = 0; j < nc; j++) {
+                from_t[i * nc + j] = fc[j * m + i];
+            }
+        }
+
+        IGRAPH_I_OMP(omp parallel for schedule(static, 1) if (parts > 1))
+        for (igraph_integer_t p = 0; p < parts; p++) {
+            igraph_i_csr_spmm_rows(A, from_t, to + c * n, nc,
+                                   igraph_i_csr_part_start(A->nrow, A->rowptr, p, parts),
+                                   igraph_i_csr_part_start(A->nrow, A->rowptr, p + 1, parts));
+        }
+    }
+
+    IGRAPH_FREE(from_t);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* An igraph_arpack_function_t that multiplies with the
+ * igraph_i_csr_matrix_t given in extra. */
+igraph_error_t igraph_i_csr_arpack_cb(igraph_real_t *to, const igraph_real_t *from,
+                                      int n, void *extra) {
+    IGRAPH_UNUSED(n);
+    igraph_i_csr_spmv((const igraph_i_csr_matrix_t *) extra, from, to);
+    return IGRAPH_SUCCESS;
+}
+
+/* An igraph_i_block_function_t that multiplies with the
+ * igraph_i_csr_matrix_t given in extra. */
+igraph_error_t igraph_i_csr_block_cb(igraph_real_t *to, const igraph_real_t *from,
+                                     igraph_integer_t n, igraph_integer_t ncol,
+                                     void *extra) {
+    IGRAPH_UNUSED(n);
+    return igraph_i_csr_spmm((const igraph_i_csr_matrix_t *) extra, from, to, ncol);
+}
@@ -0,0 +1,89 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_SPMV_INTERNAL_H
+#define IGRAPH_SPMV_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_adjlist.h"
+#include "igraph_sparsemat.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+
+__BEGIN_DECLS
+
+/* A matrix in compressed sparse row form, for the ARPACK callbacks and
+ * other iterative solvers. The entries of row i are in positions
+ * rowptr[i] to rowptr[i+1]-1 of colidx and, if eids is NULL, of values.
+ * Otherwise the value of entry k is values[eids[k]], this is how edge
+ * weights are looked up. If values is NULL, all entries are one.
+ *
+ * igraph_i_csr_matrix_init() sets up a graph matrix from an adjacency
+ * list: row i of A has the entries of the neighbors of vertex i in the
+ * list, i.e. an adjacency list created with IGRAPH_OUT gives the
+ * adjacency matrix, and one created with IGRAPH_IN gives its transpose.
+ * The operator applied by igraph_i_csr_spmv() and igraph_i_csr_spmm() is
+ *
+ *     R (alpha A C + D)
+ *
+ * where R, C and D are diagonal matrices given by row_scale, col_scale
+ * and diag. Any of them may be NULL, which stands for the identity for
+ * R and C, and for zero for D. D can only be given for square matrices.
+ * If accumulate is true, the result is added to the output instead of
+ * overwriting it. */
+typedef struct igraph_i_csr_matrix_t {
+    igraph_integer_t nrow;
+    igraph_integer_t ncol;
+    const igraph_integer_t *rowptr;
+    const igraph_integer_t *colidx;
+    const igraph_integer_t *eids;
+    const igraph_real_t *values;
+    igraph_real_t alpha;
+    const igraph_vector_t *row_scale;
+    const igraph_vector_t *col_scale;
+    const igraph_vector_t *diag;
+    igraph_bool_t accumulate;
+} igraph_i_csr_matrix_t;
+
+void igraph_i_csr_matrix_init(igraph_i_csr_matrix_t *A,
+                              const igraph_csr_adjlist_t *adjlist,
+                              const igraph_vector_t *weights);
+void igraph_i_csr_matrix_init_sparsemat(igraph_i_csr_matrix_t *A,
+                                        const igraph_sparsemat_csr_t *M);
+
+igraph_integer_t igraph_i_csr_parts(igraph_integer_t nrow, const igraph_integer_t *rowptr);
+igraph_integer_t igraph_i_csr_part_start(igraph_integer_t nrow, const igraph_integer_t *rowptr,
+                                         igraph_integer_t part, igraph_integer_t parts);
+
+void igraph_i_csr_spmv(const igraph_i_csr_matrix_t *A,
+                       const igraph_real_t *from, igraph_real_t *to);
+
+igraph_error_t igraph_i_csr_spmm(const igraph_i_csr_matrix_t *A,
+                                 const igraph_real_t *from, igraph_real_t *to,
+                                 igraph_integer_t ncol);
+
+igraph_error_t igraph_i_csr_arpack_cb(igraph_real_t *to, const igraph_real_t *from,
+                                      int n, void *extra);
+
+igraph_error_t igraph_i_csr_block_cb(igraph_real_t *to, const igraph_real_t *from,
+                                     igraph_integer_t n, igraph_integer_t ncol,
+                                     void *extra);
+
+__END_DECLS
+
+#endif
@@ -280,6 +280,160 @@ igraph_error_t igraph_get_adjacency_sparse(
     return IGRAPH_SUCCESS;
 }
 
+/* Stores the entry (row, col, value) at next[row] and increments
+ * next[row]; when colidx is NULL, only increments next[row]. */
+#define ADD_ENTRY(row, col, value) \
+    do { \
+        igraph_integer_t pos = next[row]++; \
+        if (colidx) { \
+            colidx[pos] = (col); \
+            values[pos] = (value); \
+        } \
+    } while (0)
+
+/* Visits the entries of the adjacency matrix in the same way as
+ * igraph_get_adjacency_sparse(), one entry per edge and direction. */
+static void igraph_i_get_adjacency_csr_entries(
+    const igraph_t *graph, igraph_get_adjacency_t type,
+    const igraph_vector_t *weights, igraph_loops_t loops,
+    igraph_integer_t *next, igraph_integer_t *colidx, igraph_real_t *values
+) {
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_bool_t directed = igraph_is_directed(graph);
+
+    for (igraph_integer_t i = 0; i < no_of_edges; i++) {
+        igraph_integer_t from = IGRAPH_FROM(graph, i);
+        igraph_integer_t to = IGRAPH_TO(graph, i);
+
+        if (from == to) {
+            if (loops == IGRAPH_NO_LOOPS) {
+                continue;
+            }
+            ADD_ENTRY(from, to, (!directed && loops == IGRAPH_LOOPS_TWICE ? 2 : 1) * WEIGHT_OF(i));
+        } else if (directed) {
+            ADD_ENTRY(from, to, WEIGHT_OF(i));
+        } else if (type == IGRAPH_GET_ADJACENCY_UPPER) {
+            ADD_ENTRY(from < to ? from : to, from < to ? to : from, WEIGHT_OF(i));
+        } else if (type == IGRAPH_GET_ADJACENCY_LOWER) {
+            ADD_ENTRY(from < to ? to : from, from < to ? from : to, WEIGHT_OF(i));
+        } else {
+            ADD_ENTRY(from, to, WEIGHT_OF(i));
+            ADD_ENTRY(to, from, WEIGHT_OF(i));
+        }
+    }
+}
+
+#undef ADD_ENTRY
+
+/**
+ * \function igraph_get_adjacency_csr
+ * \brief Returns the adjacency matrix of a graph in compressed sparse row form.
+ *
+ * This function creates the same matrix as \ref igraph_get_adjacency_sparse(),
+ * but directly in the compressed sparse row form of
+ * <type>igraph_sparsemat_csr_t</type>, without building a triplet matrix
+ * first. There is one stored entry for each edge and each of its
+ * directions, in the order of edge IDs within each row; the entries
+ * of multi-edges are not added up.
+ *
+ * \param graph The input graph.
+ * \param res Pointer to an \em initialized CSR matrix. The result
+ *    will be stored here. The matrix will be resized as needed.
+ * \param type Constant specifying the type of the adjacency matrix to
+ *        create for undirected graphs. It is ignored for directed
+ *        graphs. Possible values:
+ *        \clist
+ *        \cli IGRAPH_GET_ADJACENCY_UPPER
+ *          the upper right triangle of the matrix is used.
+ *        \cli IGRAPH_GET_ADJACENCY_LOWER
+ *          the lower left triangle of the matrix is used.
+ *        \cli IGRAPH_GET_ADJACENCY_BOTH
+ *          the whole matrix is used, a symmetric matrix is returned
+ *          if the graph is undirected.
+ *        \endclist
+ * \param weights An optional vector containing the weight of each edge
+ *        in the graph. Supply a null pointer here to make all edges have
+ *        the same weight of 1.
+ * \param loops Constant specifying how loop edges should be handled.
+ *        Possible values:
+ *        \clist
+ *        \cli IGRAPH_NO_LOOPS
+ *          loop edges are ignored and the diagonal of the matrix will
+ *          contain zeros only
+ *        \cli IGRAPH_LOOPS_ONCE
+ *          loop edges are counted once, i.e. a vertex with a single
+ *          unweighted loop edge will have 1 in the corresponding
+ *          diagonal entry
+ *        \cli IGRAPH_LOOPS_TWICE
+ *          loop edges are counted twice in undirected graphs, i.e. a
+ *          vertex with a single unweighted loop edge in an undirected
+ *          graph will have 2 in the corresponding diagonal entry. Loop
+ *          edges in directed graphs are always counted once.
+ *        \endclist
+ * \return Error code:
+ *        \c IGRAPH_EINVAL invalid type argument or weight vector length.
+ *
+ * \sa \ref igraph_get_adjacency_sparse() for a sparse matrix in triplet
+ * format.
+ *
+ * Time complexity: O(|V|+|E|), linear in the number of vertices and
+ * edges.
+ */
+
+igraph_error_t igraph_get_adjacency_csr(
+    const igraph_t *graph, igraph_sparsemat_csr_t *res, igraph_get_adjacency_t type,
+    const igraph_vector_t *weights, igraph_loops_t loops
+) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_vector_int_t next;
+    igraph_integer_t nnz = 0;
+
+    if (type != IGRAPH_GET_ADJACENCY_UPPER && type != IGRAPH_GET_ADJACENCY_LOWER &&
+        type != IGRAPH_GET_ADJACENCY_BOTH) {
+        IGRAPH_ERROR("Invalid type argument.", IGRAPH_EINVAL);
+    }
+    if (weights && igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERRORF("Weight vector length (%" IGRAPH_PRId ") does not match number of edges (%" IGRAPH_PRId ").",
+                      IGRAPH_EINVAL, igraph_vector_size(weights), no_of_edges);
+    }
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&next, no_of_nodes);
+
+    /* Count the entries in each row, then store them. */
+    igraph_i_get_adjacency_csr_entries(graph, type, weights, loops, VECTOR(next), NULL, NULL);
+
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        nnz += VECTOR(next)[i];
+    }
+
+    /* Reserve first, so that res is left unchanged if this fails. */
+    IGRAPH_CHECK(igraph_vector_int_reserve(&res->rowptr, no_of_nodes + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&res->colidx, nnz));
+    IGRAPH_CHECK(igraph_vector_reserve(&res->values, nnz));
+    igraph_vector_int_resize(&res->rowptr, no_of_nodes + 1); /* reserved */
+    igraph_vector_int_resize(&res->colidx, nnz); /* reserved */
+    igraph_vector_resize(&res->values, nnz); /* reserved */
+
+    nnz = 0;
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t count = VECTOR(next)[i];
+        VECTOR(res->rowptr)[i] = VECTOR(next)[i] = nnz;
+        nnz += count;
+    }
+    VECTOR(res->rowptr)[no_of_nodes] = nnz;
+    res->nrow = no_of_nodes;
+    res->ncol = no_of_nodes;
+
+    igraph_i_get_adjacency_csr_entries(graph, type, weights, loops, VECTOR(next),
+                                       VECTOR(res->colidx), VECTOR(res->values));
+
+    igraph_vector_int_destroy(&next);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
 #undef WEIGHT_OF
 
 /**
@@ -30,356 +30,132 @@
 #include "igraph_structural.h"
 
 #include "core/math.h"
+#include "misc/embedding.h"
+#include "linalg/lobpcg_internal.h"
+#include "linalg/spmv_internal.h"
 
 #include <limits.h>
 
 typedef struct {
-    const igraph_t *graph;
     const igraph_vector_t *cvec;
     const igraph_vector_t *cvec2;
-    igraph_adjlist_t *outlist, *inlist;
-    igraph_inclist_t *eoutlist, *einlist;
+    igraph_i_csr_matrix_t out, in;
     igraph_vector_t *tmp;
-    const igraph_vector_t *weights;
 } igraph_i_asembedding_data_t;
 
-/* Adjacency matrix, unweighted, undirected.
+/* The callbacks below multiply all ncol columns of 'from' at once, so
+ * that they can be used both with ARPACK (one column at a time, see
+ * igraph_i_block_arpack_cb()) and with the block eigensolver. */
+
+/* Adjacency matrix, undirected, optionally weighted.
    Eigendecomposition is used */
 static igraph_error_t igraph_i_asembeddingu(igraph_real_t *to, const igraph_real_t *from,
-                          int n, void *extra) {
+                          igraph_integer_t n, igraph_integer_t ncol, void *extra) {
     igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *outlist = data->outlist;
-    const igraph_vector_t *cvec = data->cvec;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
+    igraph_i_csr_matrix_t A = data->out;
 
-    /* to = (A+cD) from */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
-/* Adjacency matrix, weighted, undirected.
-   Eigendecomposition is used. */
-static igraph_error_t igraph_i_asembeddinguw(igraph_real_t *to, const igraph_real_t *from,
-                           int n, void *extra) {
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *outlist = data->eoutlist;
-    const igraph_vector_t *cvec = data->cvec;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_int_t *incs;
-    igraph_integer_t i, j, nlen;
+    IGRAPH_UNUSED(n);
 
     /* to = (A+cD) from */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(incs);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            to[i] += w * from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
+    A.diag = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, from, to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
-/* Adjacency matrix, unweighted, directed. SVD. */
+/* Adjacency matrix, directed, optionally weighted. SVD. */
 static igraph_error_t igraph_i_asembedding(igraph_real_t *to, const igraph_real_t *from,
-                         int n, void *extra) {
+                         igraph_integer_t n, igraph_integer_t ncol, void *extra) {
     igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *outlist = data->outlist;
-    igraph_adjlist_t *inlist = data->inlist;
-    const igraph_vector_t *cvec = data->cvec;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
+    igraph_i_csr_matrix_t A = data->out, At = data->in;
+
+    IGRAPH_CHECK(igraph_vector_resize(data->tmp, n * ncol));
 
     /* tmp = (A+cD)' from */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            VECTOR(*tmp)[i] += from[nei];
-        }
-        VECTOR(*tmp)[i] += VECTOR(*cvec)[i] * from[i];
-    }
+    At.diag = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&At, from, VECTOR(*data->tmp), ncol));
 
     /* to = (A+cD) tmp */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += VECTOR(*tmp)[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * VECTOR(*tmp)[i];
-    }
+    A.diag = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, VECTOR(*data->tmp), to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
-/* Adjacency matrix, unweighted, directed. SVD, right eigenvectors */
+/* Adjacency matrix, directed, optionally weighted. SVD, right eigenvectors */
 static igraph_error_t igraph_i_asembedding_right(igraph_real_t *to, const igraph_real_t *from,
-                               int n, void *extra) {
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *inlist = data->inlist;
-    const igraph_vector_t *cvec = data->cvec;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    /* to = (A+cD)' from */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
-/* Adjacency matrix, weighted, directed. SVD. */
-static igraph_error_t igraph_i_asembeddingw(igraph_real_t *to, const igraph_real_t *from,
-                          int n, void *extra) {
+                               igraph_integer_t n, igraph_integer_t ncol, void *extra) {
     igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *outlist = data->eoutlist;
-    igraph_inclist_t *inlist = data->einlist;
-    const igraph_vector_t *cvec = data->cvec;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *incs;
-    igraph_integer_t i, j, nlen;
-
-    /* tmp = (A+cD)' from */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(inlist, i);
-        nlen = igraph_vector_int_size(incs);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            VECTOR(*tmp)[i] += w * from[nei];
-        }
-        VECTOR(*tmp)[i] += VECTOR(*cvec)[i] * from[i];
-    }
-
-    /* to = (A+cD) tmp */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(incs);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            to[i] += w * VECTOR(*tmp)[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * VECTOR(*tmp)[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
+    igraph_i_csr_matrix_t At = data->in;
 
-/* Adjacency matrix, weighted, directed. SVD, right eigenvectors. */
-static igraph_error_t igraph_i_asembeddingw_right(igraph_real_t *to, const igraph_real_t *from,
-                                int n, void *extra) {
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *inlist = data->einlist;
-    const igraph_vector_t *cvec = data->cvec;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_int_t *incs;
-    igraph_integer_t i, j, nlen;
+    IGRAPH_UNUSED(n);
 
     /* to = (A+cD)' from */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(inlist, i);
-        nlen = igraph_vector_int_size(incs);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            to[i] += w * from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
+    At.diag = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&At, from, to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
-/* Laplacian D-A, unweighted, undirected. Eigendecomposition. */
+/* Laplacian D-A, undirected, optionally weighted. Eigendecomposition. */
 static igraph_error_t igraph_i_lsembedding_da(igraph_real_t *to, const igraph_real_t *from,
-                            int n, void *extra) {
+                            igraph_integer_t n, igraph_integer_t ncol, void *extra) {
     igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *outlist = data->outlist;
-    const igraph_vector_t *cvec = data->cvec;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
+    igraph_i_csr_matrix_t A = data->out;
 
-    /* to = (D-A) from */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] -= from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
-/* Laplacian D-A, weighted, undirected. Eigendecomposition. */
-static igraph_error_t igraph_i_lsembedding_daw(igraph_real_t *to, const igraph_real_t *from,
-                             int n, void *extra) {
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *outlist = data->eoutlist;
-    const igraph_vector_t *cvec = data->cvec;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_int_t *incs;
-    igraph_integer_t i, j, nlen;
+    IGRAPH_UNUSED(n);
 
     /* to = (D-A) from */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(incs);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            to[i] -= w * from[nei];
-        }
-        to[i] += VECTOR(*cvec)[i] * from[i];
-    }
+    A.alpha = -1;
+    A.diag = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, from, to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
 /* Laplacian DAD, unweighted, undirected. Eigendecomposition. */
 static igraph_error_t igraph_i_lsembedding_dad(igraph_real_t *to, const igraph_real_t *from,
-                             int n, void *extra) {
+                             igraph_integer_t n, igraph_integer_t ncol, void *extra) {
 
     igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *outlist = data->outlist;
-    const igraph_vector_t *cvec = data->cvec;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
+    igraph_i_csr_matrix_t A = data->out;
 
-    /* to = D^1/2 from */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*cvec)[i] * from[i];
-    }
-
-    /* tmp = A to */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            VECTOR(*tmp)[i] += to[nei];
-        }
-    }
+    IGRAPH_UNUSED(n);
 
-    /* to = D tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*cvec)[i] * VECTOR(*tmp)[i];
-    }
+    /* to = D^1/2 A D^1/2 from */
+    A.row_scale = data->cvec;
+    A.col_scale = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, from, to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
+/* Laplacian DAD, weighted, undirected. Eigendecomposition. */
 static igraph_error_t igraph_i_lsembedding_dadw(igraph_real_t *to, const igraph_real_t *from,
-                              int n, void *extra) {
+                              igraph_integer_t n, igraph_integer_t ncol, void *extra) {
 
     igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *outlist = data->eoutlist;
-    const igraph_vector_t *cvec = data->cvec;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *incs;
-    igraph_integer_t i, j, nlen;
-
-    /* to = D^-1/2 from */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*cvec)[i] * from[i];
-    }
+    igraph_i_csr_matrix_t A = data->out;
 
-    /* tmp = A' to */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(incs);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            VECTOR(*tmp)[i] += w * to[nei];
-        }
-    }
+    IGRAPH_CHECK(igraph_vector_resize(data->tmp, n * ncol));
 
-    /* to = D tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*cvec)[i] * VECTOR(*cvec)[i] * VECTOR(*tmp)[i];
-    }
+    /* tmp = D^-1/2 A' D^-1/2 from */
+    A.row_scale = data->cvec;
+    A.col_scale = data->cvec;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, from, VECTOR(*data->tmp), ncol));
 
-    /* tmp = A to */
-    for (i = 0; i < n; i++) {
-        incs = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(incs);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t edge = VECTOR(*incs)[j];
-            igraph_integer_t nei = IGRAPH_OTHER(graph, edge, i);
-            igraph_real_t w = VECTOR(*weights)[edge];
-            VECTOR(*tmp)[i] += w * to[nei];
-        }
-    }
-
-    /* to = D^-1/2 tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*cvec)[i] * VECTOR(*tmp)[i];
-    }
+    /* to = D^-1/2 A D^-1/2 tmp */
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, VECTOR(*data->tmp), to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
 /* Laplacian I-DAD, unweighted, undirected. Eigendecomposition. */
 static igraph_error_t igraph_i_lsembedding_idad(igraph_real_t *to, const igraph_real_t *from,
-                              int n, void *extra) {
+                              igraph_integer_t n, igraph_integer_t ncol, void *extra) {
 
-    igraph_i_lsembedding_dad(to, from, n, extra);
-    for (int i = 0; i < n; i++) {
+    IGRAPH_CHECK(igraph_i_lsembedding_dad(to, from, n, ncol, extra));
+    for (igraph_integer_t i = 0; i < n * ncol; i++) {
         to[i] = from[i] - to[i];
     }
 
@@ -387,214 +163,53 @@ static igraph_error_t igraph_i_lsembedding_idad(igraph_real_t *to, const igraph_
 }
 
 static igraph_error_t igraph_i_lsembedding_idadw(igraph_real_t *to, const igraph_real_t *from,
-                               int n, void *extra) {
+                               igraph_integer_t n, igraph_integer_t ncol, void *extra) {
 
-    igraph_i_lsembedding_dadw(to, from, n, extra);
-    for (int i = 0; i < n; i++) {
+    IGRAPH_CHECK(igraph_i_lsembedding_dadw(to, from, n, ncol, extra));
+    for (igraph_integer_t i = 0; i < n * ncol; i++) {
         to[i] = from[i] - to[i];
     }
 
     return IGRAPH_SUCCESS;
 }
 
-/* Laplacian OAP, unweighted, directed. SVD. */
+/* Laplacian OAP, directed, optionally weighted. SVD. */
 static igraph_error_t igraph_i_lseembedding_oap(igraph_real_t *to, const igraph_real_t *from,
-                              int n, void *extra) {
+                              igraph_integer_t n, igraph_integer_t ncol, void *extra) {
 
     igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *outlist = data->outlist;
-    igraph_adjlist_t *inlist = data->inlist;
+    igraph_i_csr_matrix_t A = data->out, At = data->in;
     const igraph_vector_t *deg_in = data->cvec;
     const igraph_vector_t *deg_out = data->cvec2;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    /* tmp = O' from */
-    for (i = 0; i < n; i++) {
-        VECTOR(*tmp)[i] = VECTOR(*deg_out)[i] * from[i];
-    }
-
-    /* to = A' tmp */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            to[i] += VECTOR(*tmp)[nei];
-        }
-    }
 
-    /* tmp = P' to */
-    for (i = 0; i < n; i++) {
-        VECTOR(*tmp)[i] = VECTOR(*deg_in)[i] * to[i];
-    }
+    IGRAPH_CHECK(igraph_vector_resize(data->tmp, n * ncol));
 
-    /* to = P tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_in)[i] * VECTOR(*tmp)[i];
-    }
+    /* tmp = P' A' O' from */
+    At.row_scale = deg_in;
+    At.col_scale = deg_out;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&At, from, VECTOR(*data->tmp), ncol));
 
-    /* tmp = A to */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            VECTOR(*tmp)[i] += to[nei];
-        }
-    }
-
-    /* to = O tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_out)[i] * VECTOR(*tmp)[i];
-    }
+    /* to = O A P tmp */
+    A.row_scale = deg_out;
+    A.col_scale = deg_in;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&A, VECTOR(*data->tmp), to, ncol));
 
     return IGRAPH_SUCCESS;
 }
 
-/* Laplacian OAP, unweighted, directed. SVD, right eigenvectors. */
+/* Laplacian OAP, directed, optionally weighted. SVD, right eigenvectors. */
 static igraph_error_t igraph_i_lseembedding_oap_right(igraph_real_t *to,
                                     const igraph_real_t *from,
-                                    int n, void *extra) {
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_adjlist_t *inlist = data->inlist;
-    const igraph_vector_t *deg_in = data->cvec;
-    const igraph_vector_t *deg_out = data->cvec2;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-
-    /* to = O' from */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_out)[i] * from[i];
-    }
-
-    /* tmp = A' to */
-    for (i = 0; i < n; i++) {
-        neis = igraph_adjlist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            igraph_integer_t nei = VECTOR(*neis)[j];
-            VECTOR(*tmp)[i] += to[nei];
-        }
-    }
-
-    /* to = P' tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_in)[i] * VECTOR(*tmp)[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
-/* Laplacian OAP, weighted, directed. SVD. */
-static igraph_error_t igraph_i_lseembedding_oapw(igraph_real_t *to, const igraph_real_t *from,
-                               int n, void *extra) {
-
-    igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *outlist = data->eoutlist;
-    igraph_inclist_t *inlist = data->einlist;
-    const igraph_vector_t *deg_in = data->cvec;
-    const igraph_vector_t *deg_out = data->cvec2;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-    igraph_integer_t edge, nei;
-    igraph_real_t w;
-
-    /* tmp = O' from */
-    for (i = 0; i < n; i++) {
-        VECTOR(*tmp)[i] = VECTOR(*deg_out)[i] * from[i];
-    }
-
-    /* to = A' tmp */
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        to[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            edge = VECTOR(*neis)[j];
-            nei = IGRAPH_OTHER(graph, edge, i);
-            w = VECTOR(*weights)[edge];
-            to[i] += w * VECTOR(*tmp)[nei];
-        }
-    }
-
-    /* tmp = P' to */
-    for (i = 0; i < n; i++) {
-        VECTOR(*tmp)[i] = VECTOR(*deg_in)[i] * to[i];
-    }
-
-    /* to = P tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_in)[i] * VECTOR(*tmp)[i];
-    }
-
-    /* tmp = A to */
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(outlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            edge = VECTOR(*neis)[j];
-            nei = IGRAPH_OTHER(graph, edge, i);
-            w = VECTOR(*weights)[edge];
-            VECTOR(*tmp)[i] += w * to[nei];
-        }
-    }
-
-    /* to = O tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_out)[i] * VECTOR(*tmp)[i];
-    }
-
-    return IGRAPH_SUCCESS;
-}
-
-/* Laplacian OAP, weighted, directed. SVD, right eigenvectors. */
-static igraph_error_t igraph_i_lseembedding_oapw_right(igraph_real_t *to,
-                                     const igraph_real_t *from,
-                                     int n, void *extra) {
+                                    igraph_integer_t n, igraph_integer_t ncol, void *extra) {
     igraph_i_asembedding_data_t *data = extra;
-    igraph_inclist_t *inlist = data->einlist;
-    const igraph_vector_t *deg_in = data->cvec;
-    const igraph_vector_t *deg_out = data->cvec2;
-    const igraph_vector_t *weights = data->weights;
-    const igraph_t *graph = data->graph;
-    igraph_vector_t *tmp = data->tmp;
-    igraph_vector_int_t *neis;
-    igraph_integer_t i, j, nlen;
-    igraph_integer_t edge, nei;
-    igraph_real_t w;
-
-    /* to = O' from */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_out)[i] * from[i];
-    }
+    igraph_i_csr_matrix_t At = data->in;
 
-    /* tmp = A' to */
-    for (i = 0; i < n; i++) {
-        neis = igraph_inclist_get(inlist, i);
-        nlen = igraph_vector_int_size(neis);
-        VECTOR(*tmp)[i] = 0.0;
-        for (j = 0; j < nlen; j++) {
-            edge = VECTOR(*neis)[j];
-            nei = IGRAPH_OTHER(graph, edge, i);
-            w = VECTOR(*weights)[edge];
-            VECTOR(*tmp)[i] += w * to[nei];
-        }
-    }
+    IGRAPH_UNUSED(n);
 
-    /* to = P' tmp */
-    for (i = 0; i < n; i++) {
-        to[i] = VECTOR(*deg_in)[i] * VECTOR(*tmp)[i];
-    }
+    /* to = P' A' O' from */
+    At.row_scale = data->cvec;
+    At.col_scale = data->cvec2;
+    IGRAPH_CHECK(igraph_i_csr_spmm(&At, from, to, ncol));
 
     return IGRAPH_SUCCESS;
 }
@@ -610,29 +225,23 @@ static igraph_error_t igraph_i_spectral_embedding(const igraph_t *graph,
                                 const igraph_vector_t *cvec,
                                 const igraph_vector_t *cvec2,
                                 igraph_arpack_options_t *options,
-                                igraph_arpack_function_t *callback,
-                                igraph_arpack_function_t *callback_right,
+                                igraph_i_block_function_t *callback,
+                                igraph_i_block_function_t *callback_right,
                                 igraph_bool_t symmetric,
                                 igraph_bool_t eigen,
-                                igraph_bool_t zapsmall) {
+                                igraph_bool_t zapsmall,
+                                igraph_i_eigensolver_t solver) {
 
     igraph_integer_t vc = igraph_vcount(graph);
     igraph_vector_t tmp;
-    igraph_adjlist_t outlist, inlist;
-    igraph_inclist_t eoutlist, einlist;
+    igraph_csr_adjlist_t outlist, inlist;
     igraph_integer_t i, j, cveclen = igraph_vector_size(cvec);
     igraph_i_asembedding_data_t data;
-    igraph_vector_t tmpD;
+    igraph_vector_t tmpD, cvec_full;
 
-    data.graph = graph;
     data.cvec = cvec;
     data.cvec2 = cvec2;
-    data.outlist = &outlist;
-    data.inlist = &inlist;
-    data.eoutlist = &eoutlist;
-    data.einlist = &einlist;
     data.tmp = &tmp;
-    data.weights = weights;
 
     if (weights && igraph_vector_size(weights) != igraph_ecount(graph)) {
         IGRAPH_ERROR("Invalid weight vector length", IGRAPH_EINVAL);
@@ -682,19 +291,29 @@ static igraph_error_t igraph_i_spectral_embedding(const igraph_t *graph,
 
     IGRAPH_VECTOR_INIT_FINALLY(&tmp, vc);
     if (!weights) {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &outlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &outlist);
-        if (!symmetric) {
-            IGRAPH_CHECK(igraph_adjlist_init(graph, &inlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
-            IGRAPH_FINALLY(igraph_adjlist_destroy, &inlist);
-        }
+        IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &outlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
     } else {
-        IGRAPH_CHECK(igraph_inclist_init(graph, &eoutlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
-        IGRAPH_FINALLY(igraph_inclist_destroy, &eoutlist);
-        if (!symmetric) {
-            IGRAPH_CHECK(igraph_inclist_init(graph, &einlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
-            IGRAPH_FINALLY(igraph_inclist_destroy, &einlist);
+        IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &outlist, IGRAPH_OUT, IGRAPH_LOOPS_ONCE));
+    }
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &outlist);
+    igraph_i_csr_matrix_init(&data.out, &outlist, weights);
+    if (!symmetric) {
+        if (!weights) {
+            IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &inlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE));
+        } else {
+            IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inlist, IGRAPH_IN, IGRAPH_LOOPS_ONCE));
         }
+        IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inlist);
+        igraph_i_csr_matrix_init(&data.in, &inlist, weights);
+    }
+
+    /* The callbacks use cvec as a diagonal matrix, a scalar is repeated */
+    IGRAPH_CHECK(igraph_vector_init(&cvec_full, 0));
+    IGRAPH_FINALLY(igraph_vector_destroy, &cvec_full);
+    if (cveclen == 1 && vc > 1) {
+        IGRAPH_CHECK(igraph_vector_resize(&cvec_full, vc));
+        igraph_vector_fill(&cvec_full, VECTOR(*cvec)[0]);
+        data.cvec = &cvec_full;
     }
     IGRAPH_VECTOR_INIT_FINALLY(&tmpD, no);
 
@@ -727,15 +346,21 @@ static igraph_error_t igraph_i_spectral_embedding(const igraph_t *graph,
     }
     RNG_END();
 
-    IGRAPH_CHECK(igraph_arpack_rssolve(callback, &data, options, 0, &tmpD, X));
+    if (solver == IGRAPH_I_EIGENSOLVER_LOBPCG) {
+        IGRAPH_CHECK(igraph_i_lobpcg_rssolve(callback, &data, options, &tmpD, X));
+    } else {
+        igraph_i_block_arpack_data_t arpack_data = { callback, &data };
+        IGRAPH_CHECK(igraph_arpack_rssolve(igraph_i_block_arpack_cb, &arpack_data,
+                                           options, 0, &tmpD, X));
+    }
 
     if (!symmetric) {
         /* calculate left eigenvalues */
         IGRAPH_CHECK(igraph_matrix_resize(Y, vc, no));
+        IGRAPH_CHECK(callback_right(&MATRIX(*Y, 0, 0), &MATRIX(*X, 0, 0), vc, no, &data));
         for (i = 0; i < no; i++) {
             igraph_real_t norm;
             igraph_vector_t v;
-            callback_right(&MATRIX(*Y, 0, i), &MATRIX(*X, 0, i), (int) vc, &data);
             igraph_vector_view(&v, &MATRIX(*Y, 0, i), vc);
             norm = 1.0 / igraph_blas_dnrm2(&v);
             igraph_vector_scale(&v, norm);
@@ -790,21 +415,15 @@ static igraph_error_t igraph_i_spectral_embedding(const igraph_t *graph,
     }
 
     igraph_vector_destroy(&tmpD);
-    if (!weights) {
-        if (!symmetric) {
-            igraph_adjlist_destroy(&inlist);
-            IGRAPH_FINALLY_CLEAN(1);
-        }
-        igraph_adjlist_destroy(&outlist);
-    } else {
-        if (!symmetric) {
-            igraph_inclist_destroy(&einlist);
-            IGRAPH_FINALLY_CLEAN(1);
-        }
-        igraph_inclist_destroy(&eoutlist);
+    igraph_vector_destroy(&cvec_full);
+    IGRAPH_FINALLY_CLEAN(2);
+    if (!symmetric) {
+        igraph_csr_adjlist_destroy(&inlist);
+        IGRAPH_FINALLY_CLEAN(1);
     }
+    igraph_csr_adjlist_destroy(&outlist);
     igraph_vector_destroy(&tmp);
-    IGRAPH_FINALLY_CLEAN(3);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -885,16 +504,32 @@ igraph_error_t igraph_adjacency_spectral_embedding(const igraph_t *graph,
                                         igraph_vector_t *D,
                                         const igraph_vector_t *cvec,
                                         igraph_arpack_options_t *options) {
+    return igraph_i_adjacency_spectral_embedding(graph, n, weights, which, scaled,
+                                                 X, Y, D, cvec, options,
+                                                 IGRAPH_I_EIGENSOLVER_ARPACK);
+}
 
-    igraph_arpack_function_t *callback, *callback_right;
+/* igraph_adjacency_spectral_embedding() with the given eigensolver. */
+igraph_error_t igraph_i_adjacency_spectral_embedding(const igraph_t *graph,
+                                                     igraph_integer_t n,
+                                                     const igraph_vector_t *weights,
+                                                     igraph_eigen_which_position_t which,
+                                                     igraph_bool_t scaled,
+                                                     igraph_matrix_t *X,
+                                                     igraph_matrix_t *Y,
+                                                     igraph_vector_t *D,
+                                                     const igraph_vector_t *cvec,
+                                                     igraph_arpack_options_t *options,
+                                                     igraph_i_eigensolver_t solver) {
+
+    igraph_i_block_function_t *callback, *callback_right;
     igraph_bool_t directed = igraph_is_directed(graph);
 
     if (directed) {
-        callback = weights ? igraph_i_asembeddingw : igraph_i_asembedding;
-        callback_right = (weights ? igraph_i_asembeddingw_right :
-                          igraph_i_asembedding_right);
+        callback = igraph_i_asembedding;
+        callback_right = igraph_i_asembedding_right;
     } else {
-        callback = weights ? igraph_i_asembeddinguw : igraph_i_asembeddingu;
+        callback = igraph_i_asembeddingu;
         callback_right = 0;
     }
 
@@ -906,7 +541,7 @@ igraph_error_t igraph_adjacency_spectral_embedding(const igraph_t *graph,
                                        X, Y, D, cvec, /* deg2=*/ 0,
                                        options, callback, callback_right,
                                        /*symmetric=*/ !directed,
-                                       /*eigen=*/ !directed, /*zapsmall=*/ 1);
+                                       /*eigen=*/ !directed, /*zapsmall=*/ 1, solver);
 }
 
 static igraph_error_t igraph_i_lse_und(const igraph_t *graph,
@@ -918,14 +553,15 @@ static igraph_error_t igraph_i_lse_und(const igraph_t *graph,
                      igraph_matrix_t *X,
                      igraph_matrix_t *Y,
                      igraph_vector_t *D,
-                     igraph_arpack_options_t *options) {
+                     igraph_arpack_options_t *options,
+                     igraph_i_eigensolver_t solver) {
 
-    igraph_arpack_function_t *callback;
+    igraph_i_block_function_t *callback;
     igraph_vector_t deg;
 
     switch (type) {
     case IGRAPH_EMBEDDING_D_A:
-        callback = weights ? igraph_i_lsembedding_daw : igraph_i_lsembedding_da;
+        callback = igraph_i_lsembedding_da;
         break;
     case IGRAPH_EMBEDDING_DAD:
         callback = weights ? igraph_i_lsembedding_dadw : igraph_i_lsembedding_dad;
@@ -960,7 +596,7 @@ static igraph_error_t igraph_i_lse_und(const igraph_t *graph,
     IGRAPH_CHECK(igraph_i_spectral_embedding(graph, no, weights, which,
                  scaled, X, Y, D, /*cvec=*/ &deg, /*deg2=*/ 0,
                  options, callback, 0, /*symmetric=*/ 1,
-                 /*eigen=*/ 1, /*zapsmall=*/ 1));
+                 /*eigen=*/ 1, /*zapsmall=*/ 1, solver));
 
     igraph_vector_destroy(&deg);
     IGRAPH_FINALLY_CLEAN(1);
@@ -977,13 +613,11 @@ static igraph_error_t igraph_i_lse_dir(const igraph_t *graph,
                      igraph_matrix_t *X,
                      igraph_matrix_t *Y,
                      igraph_vector_t *D,
-                     igraph_arpack_options_t *options) {
+                     igraph_arpack_options_t *options,
+                     igraph_i_eigensolver_t solver) {
 
-    igraph_arpack_function_t *callback =
-        weights ? igraph_i_lseembedding_oapw : igraph_i_lseembedding_oap;
-    igraph_arpack_function_t *callback_right =
-        weights ? igraph_i_lseembedding_oapw_right :
-        igraph_i_lseembedding_oap_right;
+    igraph_i_block_function_t *callback = igraph_i_lseembedding_oap;
+    igraph_i_block_function_t *callback_right = igraph_i_lseembedding_oap_right;
     igraph_vector_t deg_in, deg_out;
     igraph_integer_t i, n = igraph_vcount(graph);
 
@@ -1005,7 +639,7 @@ static igraph_error_t igraph_i_lse_dir(const igraph_t *graph,
                  scaled, X, Y, D, /*cvec=*/ &deg_in,
                  /*deg2=*/ &deg_out, options, callback,
                  callback_right, /*symmetric=*/ 0, /*eigen=*/ 0,
-                 /*zapsmall=*/ 1));
+                 /*zapsmall=*/ 1, solver));
 
     igraph_vector_destroy(&deg_in);
     igraph_vector_destroy(&deg_out);
@@ -1084,6 +718,23 @@ igraph_error_t igraph_laplacian_spectral_embedding(const igraph_t *graph,
                                         igraph_matrix_t *Y,
                                         igraph_vector_t *D,
                                         igraph_arpack_options_t *options) {
+    return igraph_i_laplacian_spectral_embedding(graph, n, weights, which, type,
+                                                 scaled, X, Y, D, options,
+                                                 IGRAPH_I_EIGENSOLVER_ARPACK);
+}
+
+/* igraph_laplacian_spectral_embedding() with the given eigensolver. */
+igraph_error_t igraph_i_laplacian_spectral_embedding(const igraph_t *graph,
+                                                     igraph_integer_t n,
+                                                     const igraph_vector_t *weights,
+                                                     igraph_eigen_which_position_t which,
+                                                     igraph_laplacian_spectral_embedding_type_t type,
+                                                     igraph_bool_t scaled,
+                                                     igraph_matrix_t *X,
+                                                     igraph_matrix_t *Y,
+                                                     igraph_vector_t *D,
+                                                     igraph_arpack_options_t *options,
+                                                     igraph_i_eigensolver_t solver) {
 
     if (options == 0) {
         options = igraph_arpack_options_get_default();
@@ -1091,10 +742,10 @@ igraph_error_t igraph_laplacian_spectral_embedding(const igraph_t *graph,
 
     if (igraph_is_directed(graph)) {
         return igraph_i_lse_dir(graph, n, weights, which, type, scaled,
-                                X, Y, D, options);
+                                X, Y, D, options, solver);
     } else {
         return igraph_i_lse_und(graph, n, weights, which, type, scaled,
-                                X, Y, D, options);
+                                X, Y, D, options, solver);
     }
 }
 
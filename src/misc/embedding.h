@@ -0,0 +1,44 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IGRAPH_EMBEDDING_INTERNAL_H
+#define IGRAPH_EMBEDDING_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_embedding.h"
+
+#include "linalg/lobpcg_internal.h"
+
+__BEGIN_DECLS
+
+igraph_error_t igraph_i_adjacency_spectral_embedding(
+        const igraph_t *graph, igraph_integer_t n, const igraph_vector_t *weights,
+        igraph_eigen_which_position_t which, igraph_bool_t scaled,
+        igraph_matrix_t *X, igraph_matrix_t *Y, igraph_vector_t *D,
+        const igraph_vector_t *cvec, igraph_arpack_options_t *options,
+        igraph_i_eigensolver_t solver);
+igraph_error_t igraph_i_laplacian_spectral_embedding(
+        const igraph_t *graph, igraph_integer_t n, const igraph_vector_t *weights,
+        igraph_eigen_which_position_t which,
+        igraph_laplacian_spectral_embedding_type_t type, igraph_bool_t scaled,
+        igraph_matrix_t *X, igraph_matrix_t *Y, igraph_vector_t *D,
+        igraph_arpack_options_t *options, igraph_i_eigensolver_t solver);
+
+__END_DECLS
+
+#endif
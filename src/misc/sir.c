@@ -31,6 +31,8 @@
 #include "igraph_structural.h"
 
 #include "core/interruption.h"
+#include "core/parallel.h"
+#include "random/random_internal.h"
 
 igraph_error_t igraph_sir_init(igraph_sir_t *sir) {
     IGRAPH_CHECK(igraph_vector_init(&sir->times, 1));
@@ -72,6 +74,281 @@ static void igraph_i_sir_destroy(igraph_vector_ptr_t *v) {
 #define S_I 1
 #define S_R 2
 
+/* Per-thread state of the simulations. All vertices are susceptible and all
+ * rates are zero between runs. */
+typedef struct {
+    igraph_vector_int_t status;
+    igraph_psumtree_t tree;
+    igraph_vector_int_t infected; /* vertices infected in the current run */
+} igraph_i_sir_state_t;
+
+static void igraph_i_sir_state_destroy(igraph_i_sir_state_t *state) {
+    igraph_vector_int_destroy(&state->infected);
+    igraph_psumtree_destroy(&state->tree);
+    igraph_vector_int_destroy(&state->status);
+    IGRAPH_FREE(state);
+}
+
+static igraph_error_t igraph_i_sir_state_init(igraph_i_sir_state_t **state,
+                                              igraph_integer_t no_of_nodes) {
+    igraph_i_sir_state_t *st = IGRAPH_CALLOC(1, igraph_i_sir_state_t);
+    IGRAPH_CHECK_OOM(st, "Cannot run SIR model.");
+    IGRAPH_FINALLY(igraph_free, st);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&st->status, no_of_nodes);
+    IGRAPH_CHECK(igraph_psumtree_init(&st->tree, no_of_nodes));
+    IGRAPH_FINALLY(igraph_psumtree_destroy, &st->tree);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&st->infected, no_of_nodes);
+    IGRAPH_FINALLY_CLEAN(4);
+    *state = st;
+    return IGRAPH_SUCCESS;
+}
+
+/* Sets the rate of a vertex back to zero and recomputes the partial sums
+ * above it from their children. Unlike igraph_psumtree_update(), this does
+ * not leave rounding errors behind: once every vertex with a non-zero rate
+ * is cleared, the tree is exactly zero again, as after
+ * igraph_psumtree_reset(), but in time proportional to the number of
+ * cleared vertices only. */
+static void igraph_i_sir_psumtree_clear(igraph_psumtree_t *t, igraph_integer_t idx) {
+    igraph_real_t *v = VECTOR(t->v);
+    igraph_integer_t size = igraph_vector_size(&t->v);
+    igraph_integer_t i = t->offset + idx;
+
+    v[i] = 0;
+    while (i > 0) {
+        i = (i - 1) / 2;
+        v[i] = (2 * i + 1 < size ? v[2 * i + 1] : 0) + (2 * i + 2 < size ? v[2 * i + 2] : 0);
+    }
+}
+
+/* Runs a single simulation from the given initially infected vertex and
+ * records either the full trajectory in 'sir', or only the final size, the
+ * peak number of infected and the time of the peak, for the summary
+ * version. */
+static igraph_error_t igraph_i_sir_simulate(const igraph_csr_adjlist_t *adjlist,
+                                            igraph_real_t beta, igraph_real_t gamma,
+                                            igraph_i_sir_state_t *state,
+                                            igraph_rng_t *rng,
+                                            igraph_sir_t *sir,
+                                            igraph_integer_t *final_size,
+                                            igraph_integer_t *peak,
+                                            igraph_real_t *peak_time) {
+
+    igraph_integer_t no_of_nodes = igraph_csr_adjlist_size(adjlist);
+    igraph_vector_int_t *status = &state->status;
+    igraph_psumtree_t *tree = &state->tree;
+    igraph_integer_t *infected = VECTOR(state->infected);
+    igraph_integer_t no_infected = 0;
+    igraph_integer_t ns, ni, nr, max_ni;
+    igraph_real_t time = 0, max_time = 0;
+    const igraph_integer_t *neis;
+    igraph_integer_t neilen;
+
+    infected[no_infected++] = igraph_rng_get_integer(rng, 0, no_of_nodes - 1);
+
+    /* Initially infected */
+    VECTOR(*status)[infected[0]] = S_I;
+    ns = no_of_nodes - 1;
+    ni = max_ni = 1;
+    nr = 0;
+
+    if (sir) {
+        VECTOR(sir->times)[0] = 0.0;
+        VECTOR(sir->no_s)[0]  = ns;
+        VECTOR(sir->no_i)[0]  = ni;
+        VECTOR(sir->no_r)[0]  = nr;
+    }
+
+    /* Rates */
+    IGRAPH_CHECK(igraph_psumtree_update(tree, infected[0], gamma));
+    neis = igraph_csr_adjlist_get(adjlist, infected[0]);
+    neilen = igraph_csr_adjlist_degree(adjlist, infected[0]);
+    for (igraph_integer_t i = 0; i < neilen; i++) {
+        IGRAPH_CHECK(igraph_psumtree_update(tree, neis[i], beta));
+    }
+
+    while (ni > 0) {
+        igraph_real_t psum, r;
+        igraph_integer_t vchange;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        psum = igraph_psumtree_sum(tree);
+        time += igraph_rng_get_exp(rng, psum);
+        r = igraph_rng_get_unif(rng, 0, psum);
+
+        igraph_psumtree_search(tree, &vchange, r);
+        neis = igraph_csr_adjlist_get(adjlist, vchange);
+        neilen = igraph_csr_adjlist_degree(adjlist, vchange);
+
+        if (VECTOR(*status)[vchange] == S_I) {
+            VECTOR(*status)[vchange] = S_R;
+            ni--; nr++;
+            IGRAPH_CHECK(igraph_psumtree_update(tree, vchange, 0.0));
+            for (igraph_integer_t i = 0; i < neilen; i++) {
+                igraph_integer_t nei = neis[i];
+                if (VECTOR(*status)[nei] == S_S) {
+                    igraph_real_t rate = igraph_psumtree_get(tree, nei);
+                    IGRAPH_CHECK(igraph_psumtree_update(tree, nei, rate - beta));
+                }
+            }
+
+        } else { /* S_S */
+            VECTOR(*status)[vchange] = S_I;
+            infected[no_infected++] = vchange;
+            ns--; ni++;
+            IGRAPH_CHECK(igraph_psumtree_update(tree, vchange, gamma));
+            for (igraph_integer_t i = 0; i < neilen; i++) {
+                igraph_integer_t nei = neis[i];
+                if (VECTOR(*status)[nei] == S_S) {
+                    igraph_real_t rate = igraph_psumtree_get(tree, nei);
+                    IGRAPH_CHECK(igraph_psumtree_update(tree, nei, rate + beta));
+                }
+            }
+            if (ni > max_ni) {
+                max_ni = ni;
+                max_time = time;
+            }
+        }
+
+        if (sir) {
+            IGRAPH_CHECK(igraph_vector_push_back(&sir->times, time));
+            IGRAPH_CHECK(igraph_vector_int_push_back(&sir->no_s, ns));
+            IGRAPH_CHECK(igraph_vector_int_push_back(&sir->no_i, ni));
+            IGRAPH_CHECK(igraph_vector_int_push_back(&sir->no_r, nr));
+        }
+
+    } /* psum > 0 */
+
+    if (final_size) {
+        *final_size = nr;
+    }
+    if (peak) {
+        *peak = max_ni;
+    }
+    if (peak_time) {
+        *peak_time = max_time;
+    }
+
+    /* Only infected vertices and their neighbors can have a non-zero rate,
+     * so it is enough to reset those for the next run. */
+    for (igraph_integer_t j = 0; j < no_infected; j++) {
+        igraph_integer_t v = infected[j];
+        VECTOR(*status)[v] = S_S;
+        igraph_i_sir_psumtree_clear(tree, v);
+        neis = igraph_csr_adjlist_get(adjlist, v);
+        neilen = igraph_csr_adjlist_degree(adjlist, v);
+        for (igraph_integer_t i = 0; i < neilen; i++) {
+            igraph_i_sir_psumtree_clear(tree, neis[i]);
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Arguments and results shared by all simulations of igraph_i_sir_run().
+ * Either 'result' or the summary vectors are used. */
+typedef struct {
+    const igraph_csr_adjlist_t *adjlist;
+    igraph_real_t beta, gamma;
+    igraph_vector_ptr_t *result;
+    igraph_vector_int_t *final_size;
+    igraph_vector_int_t *peak;
+    igraph_vector_t *peak_time;
+} igraph_i_sir_run_t;
+
+/* Runs simulation 'j', see igraph_i_parallel_run_tasks(). */
+static igraph_error_t igraph_i_sir_task(void *data, void *workspace,
+                                        igraph_rng_t *rng, igraph_integer_t j) {
+    const igraph_i_sir_run_t *run = data;
+    return igraph_i_sir_simulate(run->adjlist, run->beta, run->gamma, workspace, rng,
+                                 run->result ? VECTOR(*run->result)[j] : NULL,
+                                 run->final_size ? &VECTOR(*run->final_size)[j] : NULL,
+                                 run->peak ? &VECTOR(*run->peak)[j] : NULL,
+                                 run->peak_time ? &VECTOR(*run->peak_time)[j] : NULL);
+}
+
+static igraph_error_t igraph_i_sir_workspace_init(void *data, void **workspace) {
+    const igraph_i_sir_run_t *run = data;
+    return igraph_i_sir_state_init((igraph_i_sir_state_t **) workspace,
+                                   igraph_csr_adjlist_size(run->adjlist));
+}
+
+static void igraph_i_sir_workspace_destroy(void *workspace) {
+    igraph_i_sir_state_destroy(workspace);
+}
+
+static igraph_error_t igraph_i_sir_check_args(const igraph_t *graph, igraph_real_t beta,
+                                              igraph_real_t gamma, igraph_integer_t no_sim) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_bool_t simple;
+
+    if (no_of_nodes == 0) {
+        IGRAPH_ERROR("Cannot run SIR model on empty graph.", IGRAPH_EINVAL);
+    }
+    if (beta < 0) {
+        IGRAPH_ERROR("The infection rate beta must be non-negative in SIR model.", IGRAPH_EINVAL);
+    }
+    /* With a recovery rate of zero, the simulation would never stop. */
+    if (gamma <= 0) {
+        IGRAPH_ERROR("The recovery rate gamma must be positive in SIR model.", IGRAPH_EINVAL);
+    }
+    if (no_sim <= 0) {
+        IGRAPH_ERROR("Number of SIR simulations must be positive.", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_is_simple(graph, &simple));
+    if (!simple) {
+        IGRAPH_ERROR("SIR model only works with simple graphs.", IGRAPH_EINVAL);
+    }
+    if (igraph_is_directed(graph)) {
+        igraph_bool_t has_mutual;
+        IGRAPH_WARNING("Edge directions are ignored in SIR model.");
+        /* When the graph is directed, mutual edges are effectively multi-edges as we
+         * are ignoring edge directions. */
+        IGRAPH_CHECK(igraph_has_mutual(graph, &has_mutual, false));
+        if (has_mutual) {
+            IGRAPH_ERROR("SIR model only works with simple graphs.", IGRAPH_EINVAL);
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Runs the simulations, in parallel if possible. Every simulation draws its
+ * random numbers from its own stream, derived from a single seed taken from
+ * the default RNG up front, so the results do not depend on the number of
+ * threads. */
+static igraph_error_t igraph_i_sir_run(const igraph_t *graph, igraph_real_t beta,
+                                       igraph_real_t gamma, igraph_integer_t no_sim,
+                                       igraph_i_sir_run_t *run) {
+
+    igraph_csr_adjlist_t adjlist;
+    igraph_i_parallel_tasks_t tasks = { 0 };
+
+    IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &adjlist);
+
+    run->adjlist = &adjlist;
+    run->beta = beta;
+    run->gamma = gamma;
+
+    tasks.no_of_tasks = no_sim;
+    tasks.seed = igraph_i_rng_stream_seed();
+    tasks.data = run;
+    tasks.run = igraph_i_sir_task;
+    tasks.workspace_init = igraph_i_sir_workspace_init;
+    tasks.workspace_destroy = igraph_i_sir_workspace_destroy;
+    tasks.error_message = "Cannot run SIR model.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
+
+    igraph_csr_adjlist_destroy(&adjlist);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
 /**
  * \function igraph_sir
  * \brief Performs a number of SIR epidemics model runs on a graph.
@@ -88,6 +365,13 @@ static void igraph_i_sir_destroy(igraph_vector_ptr_t *v) {
  * single uniformly randomly chosen infected individual. A simulation
  * is stopped when no infected individuals are left.
  *
+ * </para><para>
+ * When igraph is built with OpenMP support, the simulations are run in
+ * parallel. Each simulation uses its own random number stream, derived
+ * from a seed taken from the default random number generator, therefore the results do not
+ * depend on the number of threads. Use \ref igraph_sir_summary() if only
+ * the size and the peak of the epidemics are needed.
+ *
  * \param graph The graph to perform the model on. For directed graphs
  *        edge directions are ignored and a warning is given.
  * \param beta The rate of infection of an individual that is
@@ -106,64 +390,23 @@ static void igraph_i_sir_destroy(igraph_vector_ptr_t *v) {
  *        using \ref igraph_vector_ptr_destroy_all().
  * \return Error code.
  *
- * Time complexity: O(no_sim * (|V| + |E| log(|V|))).
+ * Time complexity: O(|V| + |E| + no_sim * (d + e log(|V|))), where \c e is
+ * the number of events in a simulation and \c d is the total degree of the
+ * infected vertices. This is at most O(|V| + |E| + no_sim * |E| log(|V|)).
  */
 
 igraph_error_t igraph_sir(const igraph_t *graph, igraph_real_t beta,
                igraph_real_t gamma, igraph_integer_t no_sim,
                igraph_vector_ptr_t *result) {
 
-    igraph_integer_t infected;
-    igraph_vector_int_t status;
-    igraph_adjlist_t adjlist;
-    igraph_integer_t no_of_nodes = igraph_vcount(graph);
-    igraph_integer_t i, j, ns, ni, nr;
-    igraph_vector_int_t *neis;
-    igraph_psumtree_t tree;
-    igraph_real_t psum;
-    igraph_integer_t neilen;
-    igraph_bool_t simple;
-
-    if (no_of_nodes == 0) {
-        IGRAPH_ERROR("Cannot run SIR model on empty graph.", IGRAPH_EINVAL);
-    }
-    if (beta < 0) {
-        IGRAPH_ERROR("The infection rate beta must be non-negative in SIR model.", IGRAPH_EINVAL);
-    }
-    /* With a recovery rate of zero, the simulation would never stop. */
-    if (gamma <= 0) {
-        IGRAPH_ERROR("The recovery rate gamma must be positive in SIR model.", IGRAPH_EINVAL);
-    }
-    if (no_sim <= 0) {
-        IGRAPH_ERROR("Number of SIR simulations must be positive.", IGRAPH_EINVAL);
-    }
-
-    IGRAPH_CHECK(igraph_is_simple(graph, &simple));
-    if (!simple) {
-        IGRAPH_ERROR("SIR model only works with simple graphs.", IGRAPH_EINVAL);
-    }
-    if (igraph_is_directed(graph)) {
-        igraph_bool_t has_mutual;
-        IGRAPH_WARNING("Edge directions are ignored in SIR model.");
-        /* When the graph is directed, mutual edges are effectively multi-edges as we
-         * are ignoring edge directions. */
-        IGRAPH_CHECK(igraph_has_mutual(graph, &has_mutual, false));
-        if (has_mutual) {
-            IGRAPH_ERROR("SIR model only works with simple graphs.", IGRAPH_EINVAL);
-        }
-    }
+    igraph_i_sir_run_t run;
 
-    IGRAPH_CHECK(igraph_vector_int_init(&status, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_int_destroy, &status);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-    IGRAPH_CHECK(igraph_psumtree_init(&tree, no_of_nodes));
-    IGRAPH_FINALLY(igraph_psumtree_destroy, &tree);
+    IGRAPH_CHECK(igraph_i_sir_check_args(graph, beta, gamma, no_sim));
 
     IGRAPH_CHECK(igraph_vector_ptr_resize(result, no_sim));
     igraph_vector_ptr_null(result);
     IGRAPH_FINALLY(igraph_i_sir_destroy, result);
-    for (i = 0; i < no_sim; i++) {
+    for (igraph_integer_t i = 0; i < no_sim; i++) {
         igraph_sir_t *sir = IGRAPH_CALLOC(1, igraph_sir_t);
         if (!sir) {
             IGRAPH_ERROR("Cannot run SIR model.", IGRAPH_ENOMEM); /* LCOV_EXCL_LINE */
@@ -172,98 +415,85 @@ igraph_error_t igraph_sir(const igraph_t *graph, igraph_real_t beta,
         VECTOR(*result)[i] = sir;
     }
 
-    RNG_BEGIN();
-
-    for (j = 0; j < no_sim; j++) {
-
-        igraph_sir_t *sir = VECTOR(*result)[j];
-        igraph_vector_t *times_v = &sir->times;
-        igraph_vector_int_t *no_s_v = &sir->no_s;
-        igraph_vector_int_t *no_i_v = &sir->no_i;
-        igraph_vector_int_t *no_r_v = &sir->no_r;
+    run.result = result;
+    run.final_size = NULL;
+    run.peak = NULL;
+    run.peak_time = NULL;
+    IGRAPH_CHECK(igraph_i_sir_run(graph, beta, gamma, no_sim, &run));
 
-        infected = RNG_INTEGER(0, no_of_nodes - 1);
+    IGRAPH_FINALLY_CLEAN(1); /* result */
 
-        /* Initially infected */
-        igraph_vector_int_null(&status);
-        VECTOR(status)[infected] = S_I;
-        ns = no_of_nodes - 1;
-        ni = 1;
-        nr = 0;
-
-        VECTOR(*times_v)[0] = 0.0;
-        VECTOR(*no_s_v)[0]  = ns;
-        VECTOR(*no_i_v)[0]  = ni;
-        VECTOR(*no_r_v)[0]  = nr;
-
-        if (igraph_psumtree_sum(&tree) != 0) {
-            igraph_psumtree_reset(&tree);
-        }
-
-        /* Rates */
-        IGRAPH_CHECK(igraph_psumtree_update(&tree, infected, gamma));
-        neis = igraph_adjlist_get(&adjlist, infected);
-        neilen = igraph_vector_int_size(neis);
-        for (i = 0; i < neilen; i++) {
-            igraph_integer_t nei = VECTOR(*neis)[i];
-            IGRAPH_CHECK(igraph_psumtree_update(&tree, nei, beta));
-        }
-
-        while (ni > 0) {
-            igraph_real_t tt;
-            igraph_real_t r;
-            igraph_integer_t vchange;
-
-            IGRAPH_ALLOW_INTERRUPTION();
-
-            psum = igraph_psumtree_sum(&tree);
-            tt = igraph_rng_get_exp(igraph_rng_default(), psum);
-            r = RNG_UNIF(0, psum);
-
-            igraph_psumtree_search(&tree, &vchange, r);
-            neis = igraph_adjlist_get(&adjlist, vchange);
-            neilen = igraph_vector_int_size(neis);
-
-            if (VECTOR(status)[vchange] == S_I) {
-                VECTOR(status)[vchange] = S_R;
-                ni--; nr++;
-                IGRAPH_CHECK(igraph_psumtree_update(&tree, vchange, 0.0));
-                for (i = 0; i < neilen; i++) {
-                    igraph_integer_t nei = VECTOR(*neis)[i];
-                    if (VECTOR(status)[nei] == S_S) {
-                        igraph_real_t rate = igraph_psumtree_get(&tree, nei);
-                        IGRAPH_CHECK(igraph_psumtree_update(&tree, nei, rate - beta));
-                    }
-                }
+    return IGRAPH_SUCCESS;
+}
 
-            } else { /* S_S */
-                VECTOR(status)[vchange] = S_I;
-                ns--; ni++;
-                IGRAPH_CHECK(igraph_psumtree_update(&tree, vchange, gamma));
-                for (i = 0; i < neilen; i++) {
-                    igraph_integer_t nei = VECTOR(*neis)[i];
-                    if (VECTOR(status)[nei] == S_S) {
-                        igraph_real_t rate = igraph_psumtree_get(&tree, nei);
-                        IGRAPH_CHECK(igraph_psumtree_update(&tree, nei, rate + beta));
-                    }
-                }
-            }
+/**
+ * \function igraph_sir_summary
+ * \brief Performs a number of SIR epidemics model runs and summarizes each.
+ *
+ * This function runs the same simulations as \ref igraph_sir(), but instead
+ * of the full time series of each simulation, it only records the number of
+ * vertices that were infected at some point (the final size of the
+ * epidemic), the largest number of simultaneously infected vertices (the
+ * peak) and the time when the peak was first reached. It needs memory only
+ * for the graph and for \p no_sim numbers per output vector, which makes it
+ * possible to run a very large number of simulations. Histograms of these
+ * quantities can be computed from the output vectors.
+ *
+ * </para><para>
+ * With the same seed of the default random number generator,
+ * \ref igraph_sir() and this function perform exactly the same
+ * simulations.
+ *
+ * \param graph The graph to perform the model on. For directed graphs
+ *        edge directions are ignored and a warning is given.
+ * \param beta The rate of infection of an individual that is
+ *        susceptible and has a single infected neighbor.
+ * \param gamma The rate of recovery of an infected individual.
+ * \param no_sim The number of simulation runs to perform.
+ * \param final_size An initialized vector, the number of recovered
+ *        individuals at the end of each simulation is stored here. It will
+ *        be resized to \p no_sim. It may be \c NULL if not needed.
+ * \param peak An initialized vector, the largest number of infected
+ *        individuals during each simulation is stored here. It will be
+ *        resized to \p no_sim. It may be \c NULL if not needed.
+ * \param peak_time An initialized vector, the time at which the number of
+ *        infected individuals first reached its peak is stored here, for
+ *        each simulation. It will be resized to \p no_sim. It may be \c NULL
+ *        if not needed.
+ * \return Error code.
+ *
+ * \sa \ref igraph_sir() to record the full time series of the simulations.
+ *
+ * Time complexity: O(|V| + |E| + no_sim * (d + e log(|V|))), where \c e is
+ * the number of events in a simulation and \c d is the total degree of the
+ * infected vertices.
+ */
 
-            IGRAPH_CHECK(igraph_vector_push_back(times_v, tt + igraph_vector_tail(times_v)));
-            IGRAPH_CHECK(igraph_vector_int_push_back(no_s_v, ns));
-            IGRAPH_CHECK(igraph_vector_int_push_back(no_i_v, ni));
-            IGRAPH_CHECK(igraph_vector_int_push_back(no_r_v, nr));
+igraph_error_t igraph_sir_summary(const igraph_t *graph, igraph_real_t beta,
+                                  igraph_real_t gamma, igraph_integer_t no_sim,
+                                  igraph_vector_int_t *final_size,
+                                  igraph_vector_int_t *peak,
+                                  igraph_vector_t *peak_time) {
 
-        } /* psum > 0 */
+    igraph_i_sir_run_t run;
 
-    } /* j < no_sim */
+    IGRAPH_CHECK(igraph_i_sir_check_args(graph, beta, gamma, no_sim));
 
-    RNG_END();
+    if (final_size) {
+        IGRAPH_CHECK(igraph_vector_int_resize(final_size, no_sim));
+    }
+    if (peak) {
+        IGRAPH_CHECK(igraph_vector_int_resize(peak, no_sim));
+    }
+    if (peak_time) {
+        IGRAPH_CHECK(igraph_vector_resize(peak_time, no_sim));
+    }
 
-    igraph_psumtree_destroy(&tree);
-    igraph_adjlist_destroy(&adjlist);
-    igraph_vector_int_destroy(&status);
-    IGRAPH_FINALLY_CLEAN(4);  /* + result */
+    run.result = NULL;
+    run.final_size = final_size;
+    run.peak = peak;
+    run.peak_time = peak_time;
+    IGRAPH_CHECK(igraph_i_sir_run(graph, beta, gamma, no_sim, &run));
 
     return IGRAPH_SUCCESS;
 }
@@ -30,6 +30,9 @@
 #include "igraph_vector_ptr.h"
 
 #include "core/interruption.h"
+#include "core/parallel.h"
+#include "math/safe_intop.h"
+#include "random/random_internal.h"
 
 /**
  * This function performs a random walk with a given length on a graph,
@@ -250,6 +253,23 @@ static igraph_error_t igraph_i_random_walk_inclist(
 }
 
 
+static igraph_error_t igraph_i_random_walk_check_weights(const igraph_vector_t *weights,
+                                                         igraph_integer_t ec) {
+    if (igraph_vector_size(weights) != ec) {
+        IGRAPH_ERROR("Invalid weight vector length.", IGRAPH_EINVAL);
+    }
+    if (ec > 0) {
+        igraph_real_t min = igraph_vector_min(weights);
+        if (min < 0) {
+            IGRAPH_ERROR("Weights must be non-negative.", IGRAPH_EINVAL);
+        } else if (isnan(min)) {
+            IGRAPH_ERROR("Weights must not contain NaN values.", IGRAPH_EINVAL);
+        }
+    }
+    return IGRAPH_SUCCESS;
+}
+
+
 /**
  * \function igraph_random_walk
  * \brief Performs a random walk on a graph.
@@ -324,17 +344,7 @@ igraph_error_t igraph_random_walk(const igraph_t *graph,
     }
 
     if (weights) {
-        if (igraph_vector_size(weights) != ec) {
-            IGRAPH_ERROR("Invalid weight vector length.", IGRAPH_EINVAL);
-        }
-        if (ec > 0) {
-            igraph_real_t min = igraph_vector_min(weights);
-            if (min < 0) {
-                IGRAPH_ERROR("Weights must be non-negative.", IGRAPH_EINVAL);
-            } else if (isnan(min)) {
-                IGRAPH_ERROR("Weights must not contain NaN values.", IGRAPH_EINVAL);
-            }
-        }
+        IGRAPH_CHECK(igraph_i_random_walk_check_weights(weights, ec));
     }
 
     if (!igraph_is_directed(graph)) {
@@ -396,3 +406,456 @@ igraph_error_t igraph_random_edge_walk(
     return igraph_random_walk(graph, weights, NULL, edgewalk,
                               start, mode, steps, stuck);
 }
+
+
+/* Walks are generated in blocks of this size. Each block uses its own random
+ * number stream, derived from a single seed drawn from the default RNG before
+ * any walk is started, so the result does not depend on the number of threads. */
+#define IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE 64
+
+typedef struct {
+    const igraph_csr_adjlist_t *inclist;
+    const igraph_vector_int_t *starts;
+    igraph_matrix_int_t *walks;
+    igraph_integer_t no_of_walks;
+    /* Alias tables, only when the graph is weighted. An alias of -1 at the
+     * first position of a vertex means that all its edges have zero weight. */
+    const igraph_vector_t *prob;
+    const igraph_vector_int_t *alias;
+    igraph_integer_t steps;
+    igraph_random_walk_stuck_t stuck;
+    /* Second-order biases, see igraph_random_walks() */
+    igraph_bool_t second_order;
+    igraph_real_t inv_p, inv_q, max_bias;
+} igraph_i_random_walks_t;
+
+/* Builds the alias tables of the incident edges of vertices from..to-1 with
+ * Vose's method. 'small' and 'large' are work arrays with room for the
+ * largest degree. */
+static void igraph_i_random_walks_alias_tables(const igraph_csr_adjlist_t *inclist,
+                                               const igraph_vector_t *weights,
+                                               igraph_vector_t *prob,
+                                               igraph_vector_int_t *alias,
+                                               igraph_integer_t *small,
+                                               igraph_integer_t *large,
+                                               igraph_integer_t from,
+                                               igraph_integer_t to) {
+    for (igraph_integer_t v = from; v < to; v++) {
+        igraph_integer_t offset = VECTOR(inclist->offsets)[v];
+        igraph_integer_t degree = igraph_csr_adjlist_degree(inclist, v);
+        const igraph_integer_t *eids = igraph_csr_adjlist_get_eids(inclist, v);
+        igraph_real_t *p = VECTOR(*prob) + offset;
+        igraph_integer_t *a = VECTOR(*alias) + offset;
+        igraph_integer_t nsmall = 0, nlarge = 0;
+        igraph_real_t sum = 0;
+
+        if (degree == 0) {
+            continue;
+        }
+
+        for (igraph_integer_t k = 0; k < degree; k++) {
+            sum += VECTOR(*weights)[eids[k]];
+        }
+        if (sum == 0) {
+            a[0] = -1;
+            continue;
+        }
+
+        for (igraph_integer_t k = 0; k < degree; k++) {
+            p[k] = VECTOR(*weights)[eids[k]] * degree / sum;
+            a[k] = k;
+            if (p[k] < 1) {
+                small[nsmall++] = k;
+            } else {
+                large[nlarge++] = k;
+            }
+        }
+
+        while (nsmall > 0 && nlarge > 0) {
+            igraph_integer_t s = small[--nsmall];
+            igraph_integer_t l = large[nlarge - 1];
+            a[s] = l;
+            p[l] -= 1 - p[s];
+            if (p[l] < 1) {
+                nlarge--;
+                small[nsmall++] = l;
+            }
+        }
+
+        /* Whatever is left over has probability one, up to rounding errors. */
+        while (nlarge > 0) {
+            p[large[--nlarge]] = 1;
+        }
+        while (nsmall > 0) {
+            p[small[--nsmall]] = 1;
+        }
+    }
+}
+
+static igraph_error_t igraph_i_random_walks_build_alias_tables(const igraph_csr_adjlist_t *inclist,
+                                                               const igraph_vector_t *weights,
+                                                               igraph_vector_t *prob,
+                                                               igraph_vector_int_t *alias) {
+    igraph_integer_t no_of_nodes = igraph_csr_adjlist_size(inclist);
+    igraph_integer_t maxdeg = 0;
+    igraph_vector_int_t work;
+
+    for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+        igraph_integer_t degree = igraph_csr_adjlist_degree(inclist, v);
+        if (degree > maxdeg) {
+            maxdeg = degree;
+        }
+    }
+
+#ifdef IGRAPH_I_PARALLEL_API
+    if (no_of_nodes >= 1024 && igraph_i_parallel_max_threads() > 1) {
+        int error = IGRAPH_SUCCESS;
+
+#pragma omp parallel
+        {
+            igraph_error_handler_t *handler = igraph_i_parallel_enter();
+            igraph_vector_int_t thread_work;
+            igraph_error_t ret = igraph_vector_int_init(&thread_work, 2 * maxdeg);
+
+            if (ret != IGRAPH_SUCCESS) {
+#pragma omp atomic write
+                error = ret;
+            }
+
+#pragma omp for schedule(dynamic, 1024)
+            for (igraph_integer_t v = 0; v < no_of_nodes; v++) {
+                if (ret == IGRAPH_SUCCESS) {
+                    igraph_i_random_walks_alias_tables(inclist, weights, prob, alias,
+                                                       VECTOR(thread_work),
+                                                       VECTOR(thread_work) + maxdeg,
+                                                       v, v + 1);
+                }
+            }
+
+            if (ret == IGRAPH_SUCCESS) {
+                igraph_vector_int_destroy(&thread_work);
+            }
+            igraph_i_parallel_exit(handler);
+        }
+
+        if (error != IGRAPH_SUCCESS) {
+            IGRAPH_ERROR("Cannot build alias tables for random walks.", (igraph_error_t) error);
+        }
+
+        return IGRAPH_SUCCESS;
+    }
+#endif
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&work, 2 * maxdeg);
+    igraph_i_random_walks_alias_tables(inclist, weights, prob, alias,
+                                       VECTOR(work), VECTOR(work) + maxdeg,
+                                       0, no_of_nodes);
+    igraph_vector_int_destroy(&work);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Is 'x' among the neighbors of 'v'? Incident edge lists are sorted by
+ * neighbor ID, so this is a binary search. */
+static igraph_bool_t igraph_i_random_walks_is_neighbor(const igraph_csr_adjlist_t *inclist,
+                                                       igraph_integer_t v,
+                                                       igraph_integer_t x) {
+    const igraph_integer_t *neis = igraph_csr_adjlist_get(inclist, v);
+    igraph_integer_t lo = 0, hi = igraph_csr_adjlist_degree(inclist, v);
+
+    while (lo < hi) {
+        igraph_integer_t mid = lo + (hi - lo) / 2;
+        if (neis[mid] < x) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo < igraph_csr_adjlist_degree(inclist, v) && neis[lo] == x;
+}
+
+/* Generates walks from..to-1. The walks of the block advance in lock-step,
+ * one step at a time, so that the memory accesses of different walks are
+ * independent of each other and their cache misses can overlap. A single
+ * walk is latency-bound since every step depends on the previous one.
+ * Does not call IGRAPH_ERROR() so that it can be used from a parallel
+ * region; the only possible error is IGRAPH_ERWSTUCK. */
+static igraph_error_t igraph_i_random_walks_block(const igraph_i_random_walks_t *data,
+                                                  igraph_rng_t *rng,
+                                                  igraph_integer_t from,
+                                                  igraph_integer_t to) {
+    const igraph_csr_adjlist_t *inclist = data->inclist;
+    igraph_integer_t no_of_starts = igraph_vector_int_size(data->starts);
+    igraph_i_rng_buffer_t buffer;
+
+    /* Weighted walks only use uniform numbers, which are generated in blocks.
+     * The generator belongs to this block of walks, so it does not matter
+     * that the unused part of the last buffer is wasted. */
+    igraph_i_rng_buffer_init(&buffer, rng);
+
+    for (igraph_integer_t w = from; w < to; w++) {
+        MATRIX(*data->walks, 0, w) = VECTOR(*data->starts)[w % no_of_starts];
+    }
+
+    for (igraph_integer_t i = 1; i <= data->steps; i++) {
+        for (igraph_integer_t w = from; w < to; w++) {
+            igraph_integer_t *walk = &MATRIX(*data->walks, 0, w);
+            igraph_integer_t current = walk[i - 1];
+            igraph_integer_t previous = i > 1 ? walk[i - 2] : -1;
+            igraph_integer_t offset, degree, next;
+            const igraph_integer_t *neis;
+
+            if (current < 0) {
+                /* The walk got stuck earlier. */
+                walk[i] = -1;
+                continue;
+            }
+
+            offset = VECTOR(inclist->offsets)[current];
+            degree = igraph_csr_adjlist_degree(inclist, current);
+            neis = igraph_csr_adjlist_get(inclist, current);
+
+            if (degree == 0 || (data->prob && VECTOR(*data->alias)[offset] < 0)) {
+                if (data->stuck == IGRAPH_RANDOM_WALK_STUCK_ERROR) {
+                    return IGRAPH_ERWSTUCK;
+                }
+                walk[i] = -1;
+                continue;
+            }
+
+            while (true) {
+                igraph_integer_t k;
+                igraph_real_t bias;
+
+                if (data->prob) {
+                    /* A single uniform number selects both the column of
+                     * the alias table and the position within it. */
+                    igraph_real_t u = igraph_i_rng_buffer_unif01(&buffer, IGRAPH_I_RNG_BUFFER_SIZE) * degree;
+                    k = (igraph_integer_t) u;
+                    if (k >= degree) {
+                        k = degree - 1;
+                    }
+                    if (u - k >= VECTOR(*data->prob)[offset + k]) {
+                        k = VECTOR(*data->alias)[offset + k];
+                    }
+                } else {
+                    k = igraph_rng_get_integer(rng, 0, degree - 1);
+                }
+                next = neis[k];
+
+                if (!data->second_order || previous < 0) {
+                    break;
+                }
+
+                /* Rejection sampling of the second-order transition: the
+                 * candidate drawn from the first-order distribution is
+                 * accepted with probability bias / max_bias. */
+                if (next == previous) {
+                    bias = data->inv_p;
+                } else if (igraph_i_random_walks_is_neighbor(inclist, previous, next)) {
+                    bias = 1;
+                } else {
+                    bias = data->inv_q;
+                }
+                if (bias >= data->max_bias) {
+                    break;
+                }
+                if ((data->prob ? igraph_i_rng_buffer_unif01(&buffer, IGRAPH_I_RNG_BUFFER_SIZE) :
+                     igraph_rng_get_unif01(rng)) * data->max_bias < bias) {
+                    break;
+                }
+            }
+
+            walk[i] = next;
+        }
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Generates the walks of block 'b', see igraph_i_parallel_run_tasks(). */
+static igraph_error_t igraph_i_random_walks_task(void *data, void *workspace,
+                                                 igraph_rng_t *rng, igraph_integer_t b) {
+    const igraph_i_random_walks_t *walks = data;
+    igraph_integer_t from = b * IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE;
+    igraph_integer_t to = walks->no_of_walks - from > IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE ?
+                          from + IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE : walks->no_of_walks;
+
+    IGRAPH_UNUSED(workspace);
+
+    return igraph_i_random_walks_block(walks, rng, from, to);
+}
+
+/**
+ * \function igraph_random_walks
+ * \brief Performs many random walks on a graph at once.
+ *
+ * This function is meant for generating the large number of short walks
+ * that are needed e.g. by graph embedding methods such as DeepWalk and
+ * node2vec. It starts \p walks_per_start walks of the same length from each
+ * vertex in \p starts and stores all of them in a single matrix.
+ *
+ * </para><para>
+ * When \p p and \p q are both 1, each step chooses an edge incident to the
+ * current vertex with probability proportional to its weight, just like
+ * \ref igraph_random_walk() does. Otherwise the walks are second-order
+ * walks as in node2vec: having arrived at vertex \c v from vertex \c t, the
+ * weight of the edge to the next vertex \c x is multiplied by 1/\p p if
+ * \c x is \c t, by 1 if \c x is a neighbor of \c t, and by 1/\p q otherwise.
+ *
+ * </para><para>
+ * Weighted transitions take constant time, using alias tables that are
+ * built once for all vertices. Second-order walks use rejection sampling,
+ * which takes constant expected time per step unless \p p or \p q are very
+ * different from 1, plus a logarithmic-time neighbor check.
+ *
+ * </para><para>
+ * When igraph is built with OpenMP support, walks are generated in
+ * parallel. Every block of walks draws its random numbers from a separate
+ * Philox stream, derived from a seed taken from the default random number
+ * generator, therefore the result only depends on the state of the default generator,
+ * not on the number of threads. The walks are not the same as those
+ * that \ref igraph_random_walk() would generate.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ *   Multiple edges are respected, so are loop edges.
+ * \param weights A vector of non-negative edge weights. If it is \c NULL,
+ *   all edges are considered to have equal weight. A vertex whose
+ *   incident edges all have zero weight is treated as if it had no edges.
+ * \param walks An initialized matrix, the walks are stored here. It will be
+ *   resized to have \p steps + 1 rows, and one column per walk, so that each
+ *   walk is stored contiguously. The walks from the <code>i</code>th start
+ *   vertex are in columns \c i, \c i + n, \c i + 2n, etc., where \c n is the
+ *   number of start vertices.
+ * \param starts The start vertices. A vertex may appear several times.
+ * \param walks_per_start The number of walks to start from each element of
+ *   \p starts.
+ * \param mode How to walk along the edges in directed graphs.
+ *   \c IGRAPH_OUT means following edge directions, \c IGRAPH_IN means
+ *   going opposite the edge directions, \c IGRAPH_ALL means ignoring
+ *   edge directions. This argument is ignored for undirected graphs.
+ *   It also determines which vertices count as neighbors of the previous
+ *   vertex for second-order walks.
+ * \param steps The number of steps in each walk.
+ * \param p The return parameter of second-order walks, must be positive.
+ * \param q The in-out parameter of second-order walks, must be positive.
+ * \param stuck What to do if a random walk gets stuck.
+ *   \c IGRAPH_RANDOM_WALK_STUCK_RETURN means that the rest of the walk is
+ *   filled with -1 values; \c IGRAPH_RANDOM_WALK_STUCK_ERROR means that an
+ *   \c IGRAPH_ERWSTUCK error is reported.
+ * \return Error code: \c IGRAPH_ERWSTUCK if a walk got stuck.
+ *
+ * \sa \ref igraph_random_walk() for a single walk that also records the
+ * traversed edges.
+ *
+ * Time complexity: O(|V| + |E| + w * l) expected time for first-order walks,
+ * and O(|V| + |E| + w * l * log(d)) for second-order walks, where \c w is the
+ * number of walks, \c l is their length and \c d is the maximum degree.
+ */
+igraph_error_t igraph_random_walks(const igraph_t *graph,
+                                   const igraph_vector_t *weights,
+                                   igraph_matrix_int_t *walks,
+                                   igraph_vs_t starts,
+                                   igraph_integer_t walks_per_start,
+                                   igraph_neimode_t mode,
+                                   igraph_integer_t steps,
+                                   igraph_real_t p, igraph_real_t q,
+                                   igraph_random_walk_stuck_t stuck) {
+
+    igraph_integer_t ec = igraph_ecount(graph);
+    igraph_integer_t no_of_starts, no_of_walks, rows;
+    igraph_vector_int_t start_vertices;
+    igraph_i_parallel_tasks_t tasks = { 0 };
+    igraph_csr_adjlist_t inclist;
+    igraph_vector_t prob;
+    igraph_vector_int_t alias;
+    igraph_vit_t vit;
+    igraph_i_random_walks_t data;
+
+    if (!(mode == IGRAPH_ALL || mode == IGRAPH_IN || mode == IGRAPH_OUT)) {
+        IGRAPH_ERROR("Invalid mode parameter.", IGRAPH_EINVMODE);
+    }
+    if (steps < 0) {
+        IGRAPH_ERRORF("Number of steps should be non-negative, got %"
+                      IGRAPH_PRId ".", IGRAPH_EINVAL, steps);
+    }
+    if (walks_per_start < 0) {
+        IGRAPH_ERRORF("Number of walks per start vertex should be non-negative, got %"
+                      IGRAPH_PRId ".", IGRAPH_EINVAL, walks_per_start);
+    }
+    if (!(p > 0) || !(q > 0)) {
+        IGRAPH_ERRORF("The parameters p and q must be positive, got %g and %g.",
+                      IGRAPH_EINVAL, p, q);
+    }
+    if (weights) {
+        IGRAPH_CHECK(igraph_i_random_walk_check_weights(weights, ec));
+    }
+
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    IGRAPH_CHECK(igraph_vit_create(graph, starts, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&start_vertices, 0);
+    IGRAPH_CHECK(igraph_vit_as_vector(&vit, &start_vertices));
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    no_of_starts = igraph_vector_int_size(&start_vertices);
+    IGRAPH_SAFE_MULT(no_of_starts, walks_per_start, &no_of_walks);
+    IGRAPH_SAFE_ADD(steps, 1, &rows);
+    IGRAPH_CHECK(igraph_matrix_int_resize(walks, rows, no_of_walks));
+
+    if (no_of_walks == 0) {
+        igraph_vector_int_destroy(&start_vertices);
+        IGRAPH_FINALLY_CLEAN(1);
+        return IGRAPH_SUCCESS;
+    }
+
+    IGRAPH_CHECK(igraph_csr_adjlist_init_incident(graph, &inclist, mode, IGRAPH_LOOPS));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &inclist);
+
+    IGRAPH_VECTOR_INIT_FINALLY(&prob, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&alias, 0);
+    if (weights) {
+        igraph_integer_t no_of_arcs = igraph_vector_int_size(&inclist.neis);
+        IGRAPH_CHECK(igraph_vector_resize(&prob, no_of_arcs));
+        IGRAPH_CHECK(igraph_vector_int_resize(&alias, no_of_arcs));
+        IGRAPH_CHECK(igraph_i_random_walks_build_alias_tables(&inclist, weights, &prob, &alias));
+    }
+
+    data.inclist = &inclist;
+    data.starts = &start_vertices;
+    data.walks = walks;
+    data.no_of_walks = no_of_walks;
+    data.prob = weights ? &prob : NULL;
+    data.alias = weights ? &alias : NULL;
+    data.steps = steps;
+    data.stuck = stuck;
+    data.second_order = (p != 1 || q != 1);
+    data.inv_p = 1.0 / p;
+    data.inv_q = 1.0 / q;
+    data.max_bias = data.inv_p > data.inv_q ? data.inv_p : data.inv_q;
+    if (data.max_bias < 1) {
+        data.max_bias = 1;
+    }
+
+    /* Each block of walks has its own random number stream. */
+    tasks.no_of_tasks = (no_of_walks + IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE - 1) / IGRAPH_I_RANDOM_WALKS_BLOCK_SIZE;
+    tasks.seed = igraph_i_rng_stream_seed();
+    tasks.data = &data;
+    tasks.run = igraph_i_random_walks_task;
+    tasks.error_message = "Random walk got stuck.";
+    IGRAPH_CHECK(igraph_i_parallel_run_tasks(&tasks));
+
+    igraph_vector_int_destroy(&alias);
+    igraph_vector_destroy(&prob);
+    igraph_csr_adjlist_destroy(&inclist);
+    igraph_vector_int_destroy(&start_vertices);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return IGRAPH_SUCCESS;
+}
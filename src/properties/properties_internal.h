@@ -29,6 +29,11 @@ __BEGIN_DECLS
 igraph_error_t igraph_i_trans4_al_simplify(igraph_adjlist_t *al,
                                            const igraph_vector_int_t *rank);
 
+igraph_error_t igraph_i_triangle_support(const igraph_csr_adjlist_t *al,
+                                         igraph_integer_t no_of_edges,
+                                         igraph_vector_int_t *edge_support,
+                                         igraph_vector_int_t *vertex_support);
+
 __END_DECLS
 
 #endif
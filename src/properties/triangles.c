@@ -31,8 +31,11 @@
 #include "igraph_structural.h"
 
 #include "core/interruption.h"
+#include "core/parallel.h"
 #include "properties/properties_internal.h"
 
+#include <string.h> /* memmove */
+
 /**
  * \function igraph_transitivity_avglocal_undirected
  * \brief Average local transitivity (clustering coefficient).
@@ -321,13 +324,102 @@ igraph_error_t igraph_i_trans4_al_simplify(igraph_adjlist_t *al,
     return IGRAPH_SUCCESS;
 }
 
+/* Same as igraph_i_trans4_al_simplify(), but for compact adjacency lists.
+   The kept neighbors of each vertex are moved to the front of the neighbor
+   array so the adjacency list stays compact. */
+static igraph_error_t igraph_i_trans4_csr_al_simplify(igraph_csr_adjlist_t *al,
+                                                      const igraph_vector_int_t *rank) {
+    igraph_integer_t i;
+    igraph_integer_t n = al->length;
+    igraph_integer_t *neis = VECTOR(al->neis);
+    igraph_integer_t start = 0, write_ptr = 0;
+    igraph_vector_int_t mark;
+
+    IGRAPH_CHECK(igraph_vector_int_init(&mark, n));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &mark);
+
+    for (i = 0; i < n; i++) {
+        igraph_integer_t end = VECTOR(al->offsets)[i + 1];
+        igraph_integer_t j, l = end - start;
+        igraph_integer_t irank = VECTOR(*rank)[i];
+        VECTOR(mark)[i] = i + 1;
+        for (j = 0; j < l; /* nothing */) {
+            igraph_integer_t e = neis[start + j];
+            if (VECTOR(*rank)[e] > irank && VECTOR(mark)[e] != i + 1) {
+                VECTOR(mark)[e] = i + 1;
+                j++;
+            } else {
+                neis[start + j] = neis[start + l - 1];
+                l--;
+            }
+        }
+        VECTOR(al->offsets)[i] = write_ptr;
+        memmove(neis + write_ptr, neis + start, l * sizeof(igraph_integer_t));
+        write_ptr += l;
+        start = end;
+    }
+    VECTOR(al->offsets)[n] = write_ptr;
+
+    /* Always succeeds since we never grow the vector */
+    igraph_vector_int_resize(&al->neis, write_ptr);
+
+    igraph_vector_int_destroy(&mark);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Counts the triangles of all vertices with igraph_i_triangle_support(), and
+ * stores their degrees, ignoring loops and multi-edges, in 'degree' if it is
+ * not NULL. */
+static igraph_error_t igraph_i_adjacent_triangles_all(const igraph_t *graph,
+                                                      igraph_vector_int_t *triangles,
+                                                      igraph_vector_int_t *degree) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_csr_adjlist_t allneis;
+
+    IGRAPH_CHECK(igraph_csr_adjlist_init(graph, &allneis, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_NO_MULTIPLE));
+    IGRAPH_FINALLY(igraph_csr_adjlist_destroy, &allneis);
+
+    IGRAPH_CHECK(igraph_i_triangle_support(&allneis, 0, NULL, triangles));
+
+    if (degree) {
+        IGRAPH_CHECK(igraph_vector_int_resize(degree, no_of_nodes));
+        for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+            VECTOR(*degree)[i] = igraph_csr_adjlist_degree(&allneis, i);
+        }
+    }
+
+    igraph_csr_adjlist_destroy(&allneis);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return IGRAPH_SUCCESS;
+}
+
 static igraph_error_t igraph_transitivity_local_undirected4(const igraph_t *graph,
         igraph_vector_t *res,
         igraph_transitivity_mode_t mode) {
 
-#define TRANSIT 1
-#include "properties/triangles_template.h"
-#undef TRANSIT
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_vector_int_t triangles, degree;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&triangles, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_CHECK(igraph_i_adjacent_triangles_all(graph, &triangles, &degree));
+
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t deg = VECTOR(degree)[i];
+        if (mode == IGRAPH_TRANSITIVITY_ZERO && deg < 2) {
+            VECTOR(*res)[i] = 0.0;
+        } else {
+            VECTOR(*res)[i] = (igraph_real_t) VECTOR(triangles)[i] / deg / (deg - 1) * 2.0;
+        }
+    }
+
+    igraph_vector_int_destroy(&degree);
+    igraph_vector_int_destroy(&triangles);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return IGRAPH_SUCCESS;
 }
@@ -370,6 +462,7 @@ static igraph_error_t igraph_transitivity_local_undirected4(const igraph_t *grap
  *
  * Time complexity: O(n*d^2), n is the number of vertices for which
  * the transitivity is calculated, d is the average vertex degree.
+ * O(|V| + |E|^1.5) when it is calculated for all vertices.
  */
 
 igraph_error_t igraph_transitivity_local_undirected(const igraph_t *graph,
@@ -404,7 +497,20 @@ static igraph_error_t igraph_adjacent_triangles1(const igraph_t *graph,
 
 static igraph_error_t igraph_adjacent_triangles4(const igraph_t *graph,
                                       igraph_vector_t *res) {
-# include "properties/triangles_template.h"
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_vector_int_t triangles;
+
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&triangles, no_of_nodes);
+    IGRAPH_CHECK(igraph_i_adjacent_triangles_all(graph, &triangles, NULL));
+
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        VECTOR(*res)[i] = VECTOR(triangles)[i];
+    }
+
+    igraph_vector_int_destroy(&triangles);
+    IGRAPH_FINALLY_CLEAN(1);
+
     return IGRAPH_SUCCESS;
 }
 
@@ -420,7 +526,8 @@ static igraph_error_t igraph_adjacent_triangles4(const igraph_t *graph,
  * \sa \ref igraph_list_triangles() to list them.
  *
  * Time complexity: O(d^2 n), d is the average vertex degree of the
- * queried vertices, n is their number.
+ * queried vertices, n is their number. O(|V| + |E|^1.5) when all
+ * vertices are queried.
  */
 
 igraph_error_t igraph_adjacent_triangles(const igraph_t *graph,
@@ -463,9 +570,156 @@ igraph_error_t igraph_adjacent_triangles(const igraph_t *graph,
 
 igraph_error_t igraph_list_triangles(const igraph_t *graph,
                           igraph_vector_int_t *res) {
-# define TRIANGLES
 # include "properties/triangles_template.h"
-# undef TRIANGLES
+    return IGRAPH_SUCCESS;
+}
+
+/* Counts the triangles each edge and each vertex participates in, i.e. the
+ * "support" of the edges and vertices. 'al' must be an adjacency list created
+ * with IGRAPH_ALL, IGRAPH_NO_LOOPS and IGRAPH_NO_MULTIPLE, or, if edge
+ * supports are needed, an incidence list created with IGRAPH_ALL and
+ * IGRAPH_NO_LOOPS from a graph without multi-edges, so that the neighbors of
+ * each vertex are sorted and unique. Either of 'edge_support' and
+ * 'vertex_support' may be NULL.
+ *
+ * Edges are oriented from lower to higher ranked endpoints, ranking vertices
+ * by degree, and each triangle is found exactly once by intersecting the
+ * out-neighbor lists of the endpoints of its lowest ranked edge. Out-degrees
+ * in this orientation are O(sqrt(|E|)), which gives O(|E|^1.5) time. Vertices
+ * are processed in parallel when OpenMP is available.
+ */
+igraph_error_t igraph_i_triangle_support(const igraph_csr_adjlist_t *al,
+                                         igraph_integer_t no_of_edges,
+                                         igraph_vector_int_t *edge_support,
+                                         igraph_vector_int_t *vertex_support) {
+
+    igraph_integer_t no_of_nodes = igraph_csr_adjlist_size(al);
+    igraph_integer_t no_of_arcs = igraph_vector_int_size(&al->neis) / 2;
+    igraph_integer_t *offsets, *neis, *eids = NULL;
+    igraph_integer_t *esup = NULL, *vsup = NULL;
+
+    if (edge_support) {
+        IGRAPH_ASSERT(igraph_csr_adjlist_has_eids(al));
+        IGRAPH_CHECK(igraph_vector_int_resize(edge_support, no_of_edges));
+        igraph_vector_int_null(edge_support);
+        esup = VECTOR(*edge_support);
+    }
+    if (vertex_support) {
+        IGRAPH_CHECK(igraph_vector_int_resize(vertex_support, no_of_nodes));
+        igraph_vector_int_null(vertex_support);
+        vsup = VECTOR(*vertex_support);
+    }
+
+    if (no_of_arcs == 0) {
+        return IGRAPH_SUCCESS;
+    }
+
+    offsets = IGRAPH_CALLOC(no_of_nodes + 1, igraph_integer_t);
+    IGRAPH_CHECK_OOM(offsets, "Insufficient memory for counting triangles.");
+    IGRAPH_FINALLY(igraph_free, offsets);
+    neis = IGRAPH_CALLOC(no_of_arcs, igraph_integer_t);
+    IGRAPH_CHECK_OOM(neis, "Insufficient memory for counting triangles.");
+    IGRAPH_FINALLY(igraph_free, neis);
+    if (esup) {
+        eids = IGRAPH_CALLOC(no_of_arcs, igraph_integer_t);
+        IGRAPH_CHECK_OOM(eids, "Insufficient memory for counting triangles.");
+        IGRAPH_FINALLY(igraph_free, eids);
+    }
+
+#define HIGHER(u, v) \
+    (igraph_csr_adjlist_degree(al, u) < igraph_csr_adjlist_degree(al, v) || \
+     (igraph_csr_adjlist_degree(al, u) == igraph_csr_adjlist_degree(al, v) && (u) < (v)))
+
+    /* Keep only the edges pointing towards higher ranked vertices. The
+     * filtered neighbor lists are still sorted by vertex ID. */
+    IGRAPH_I_OMP(omp parallel for)
+    for (igraph_integer_t u = 0; u < no_of_nodes; u++) {
+        const igraph_integer_t *u_neis = igraph_csr_adjlist_get(al, u);
+        igraph_integer_t u_deg = igraph_csr_adjlist_degree(al, u);
+        igraph_integer_t count = 0;
+        for (igraph_integer_t j = 0; j < u_deg; j++) {
+            if (HIGHER(u, u_neis[j])) {
+                count++;
+            }
+        }
+        offsets[u + 1] = count;
+    }
+    for (igraph_integer_t u = 0; u < no_of_nodes; u++) {
+        offsets[u + 1] += offsets[u];
+    }
+    IGRAPH_I_OMP(omp parallel for)
+    for (igraph_integer_t u = 0; u < no_of_nodes; u++) {
+        const igraph_integer_t *u_neis = igraph_csr_adjlist_get(al, u);
+        const igraph_integer_t *u_eids = eids ? igraph_csr_adjlist_get_eids(al, u) : NULL;
+        igraph_integer_t u_deg = igraph_csr_adjlist_degree(al, u);
+        igraph_integer_t k = offsets[u];
+        for (igraph_integer_t j = 0; j < u_deg; j++) {
+            if (HIGHER(u, u_neis[j])) {
+                neis[k] = u_neis[j];
+                if (eids) {
+                    eids[k] = u_eids[j];
+                }
+                k++;
+            }
+        }
+    }
+
+#undef HIGHER
+
+    IGRAPH_I_OMP(omp parallel for schedule(dynamic, 64))
+    for (igraph_integer_t u = 0; u < no_of_nodes; u++) {
+        igraph_integer_t u_count = 0;
+        for (igraph_integer_t j = offsets[u]; j < offsets[u + 1]; j++) {
+            igraph_integer_t v = neis[j];
+            igraph_integer_t p = offsets[u], p_end = offsets[u + 1];
+            igraph_integer_t q = offsets[v], q_end = offsets[v + 1];
+            igraph_integer_t count = 0;
+            while (p < p_end && q < q_end) {
+                if (neis[p] < neis[q]) {
+                    p++;
+                } else if (neis[p] > neis[q]) {
+                    q++;
+                } else {
+                    count++;
+                    if (esup) {
+                        IGRAPH_I_OMP(omp atomic)
+                        esup[eids[p]]++;
+                        IGRAPH_I_OMP(omp atomic)
+                        esup[eids[q]]++;
+                    }
+                    if (vsup) {
+                        IGRAPH_I_OMP(omp atomic)
+                        vsup[neis[p]]++;
+                    }
+                    p++; q++;
+                }
+            }
+            if (count > 0) {
+                if (esup) {
+                    IGRAPH_I_OMP(omp atomic)
+                    esup[eids[j]] += count;
+                }
+                if (vsup) {
+                    IGRAPH_I_OMP(omp atomic)
+                    vsup[v] += count;
+                }
+                u_count += count;
+            }
+        }
+        if (vsup && u_count > 0) {
+            IGRAPH_I_OMP(omp atomic)
+            vsup[u] += u_count;
+        }
+    }
+
+    if (eids) {
+        IGRAPH_FREE(eids);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    IGRAPH_FREE(neis);
+    IGRAPH_FREE(offsets);
+    IGRAPH_FINALLY_CLEAN(2);
+
     return IGRAPH_SUCCESS;
 }
 
@@ -508,8 +762,8 @@ igraph_error_t igraph_list_triangles(const igraph_t *graph,
  * \sa \ref igraph_transitivity_local_undirected(),
  * \ref igraph_transitivity_avglocal_undirected().
  *
- * Time complexity: O(|V|*d^2), |V| is the number of vertices in
- * the graph, d is the average node degree.
+ * Time complexity: O(|V| + |E|^1.5), the number of vertices plus
+ * the number of edges to the power of 1.5.
  *
  * \example examples/simple/igraph_transitivity.c
  */
@@ -520,81 +774,27 @@ igraph_error_t igraph_transitivity_undirected(const igraph_t *graph,
 
     igraph_integer_t no_of_nodes = igraph_vcount(graph);
     igraph_real_t triples = 0, triangles = 0;
-    igraph_integer_t node, nn;
-    igraph_integer_t maxdegree;
-    igraph_integer_t *neis;
-    igraph_vector_int_t order;
-    igraph_vector_t rank;
-    igraph_vector_int_t degree;
-
-    igraph_adjlist_t allneis;
-    igraph_vector_int_t *neis1, *neis2;
-    igraph_integer_t i, j, neilen1, neilen2;
+    igraph_vector_int_t vertex_triangles, degree;
 
     if (no_of_nodes == 0) {
         *res = mode == IGRAPH_TRANSITIVITY_ZERO ? 0.0 : IGRAPH_NAN;
         return IGRAPH_SUCCESS;
     }
 
-    IGRAPH_VECTOR_INT_INIT_FINALLY(&order, no_of_nodes);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&vertex_triangles, no_of_nodes);
     IGRAPH_VECTOR_INT_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_CHECK(igraph_i_adjacent_triangles_all(graph, &vertex_triangles, &degree));
 
-    IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(), IGRAPH_ALL,
-                               IGRAPH_LOOPS));
-    maxdegree = igraph_vector_int_max(&degree) + 1;
-    IGRAPH_CHECK(igraph_vector_int_order1(&degree, &order, maxdegree));
-
-    igraph_vector_int_destroy(&degree);
-    IGRAPH_FINALLY_CLEAN(1);
-
-    IGRAPH_VECTOR_INIT_FINALLY(&rank, no_of_nodes);
-    for (i = 0; i < no_of_nodes; i++) {
-        VECTOR(rank)[ VECTOR(order)[i] ] = no_of_nodes - i - 1;
+    /* Each triangle is counted at all three of its vertices. */
+    for (igraph_integer_t i = 0; i < no_of_nodes; i++) {
+        igraph_integer_t deg = VECTOR(degree)[i];
+        triples += (igraph_real_t) deg * (deg - 1);
+        triangles += VECTOR(vertex_triangles)[i];
     }
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_NO_MULTIPLE));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
-
-    neis = IGRAPH_CALLOC(no_of_nodes, igraph_integer_t);
-    if (! neis) {
-        IGRAPH_ERROR("Insufficient memory for undirected global transitivity.", IGRAPH_ENOMEM); /* LCOV_EXCL_LINE */
-    }
-    IGRAPH_FINALLY(igraph_free, neis);
-
-    for (nn = no_of_nodes - 1; nn >= 0; nn--) {
-        node = VECTOR(order)[nn];
-
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        neis1 = igraph_adjlist_get(&allneis, node);
-        neilen1 = igraph_vector_int_size(neis1);
-        triples += (igraph_real_t)neilen1 * (neilen1 - 1);
-        /* Mark the neighbors of 'node' */
-        for (i = 0; i < neilen1; i++) {
-            igraph_integer_t nei = VECTOR(*neis1)[i];
-            neis[nei] = node + 1;
-        }
-        for (i = 0; i < neilen1; i++) {
-            igraph_integer_t nei = VECTOR(*neis1)[i];
-            /* If 'nei' is not ready yet */
-            if (VECTOR(rank)[nei] > VECTOR(rank)[node]) {
-                neis2 = igraph_adjlist_get(&allneis, nei);
-                neilen2 = igraph_vector_int_size(neis2);
-                for (j = 0; j < neilen2; j++) {
-                    igraph_integer_t nei2 = VECTOR(*neis2)[j];
-                    if (neis[nei2] == node + 1) {
-                        triangles += 1.0;
-                    }
-                }
-            }
-        }
-    }
-
-    IGRAPH_FREE(neis);
-    igraph_adjlist_destroy(&allneis);
-    igraph_vector_destroy(&rank);
-    igraph_vector_int_destroy(&order);
-    IGRAPH_FINALLY_CLEAN(4);
+    igraph_vector_int_destroy(&degree);
+    igraph_vector_int_destroy(&vertex_triangles);
+    IGRAPH_FINALLY_CLEAN(2);
 
     if (triples == 0 && mode == IGRAPH_TRANSITIVITY_ZERO) {
         *res = 0;
@@ -120,6 +120,19 @@
  * </para>
  * </section>
  *
+ * <section id="random-parallel"><title>Random numbers and threads</title>
+ * <para>
+ * When igraph is built with thread-local storage, the default generator
+ * is separate for each thread, so threads calling randomized igraph
+ * functions concurrently do not interfere with each other. Functions
+ * that use multiple threads internally draw a single seed from the
+ * calling thread's default generator and give each of their tasks an
+ * independent stream seeded with \ref igraph_rng_seed_stream(). Their
+ * results are therefore reproducible and do not depend on the number of
+ * threads.
+ * </para>
+ * </section>
+ *
  * <section id="random-example"><title>Example</title>
  * <para>
  * \example examples/simple/random_seed.c
@@ -180,12 +193,21 @@ void igraph_rng_set_default(igraph_rng_t *rng) {
  * \function igraph_rng_default
  * \brief Query the default random number generator.
  *
+ * </para><para>
+ * When igraph is built with thread-local storage, each thread has its own
+ * default generator, which is a separate PCG32 instance. New threads start
+ * from the same fixed state, so each thread should seed its default
+ * generator if it uses randomized igraph functions.
+ *
  * \return A pointer to the default random number generator.
  *
  * \sa \ref igraph_rng_set_default()
  */
 
 igraph_rng_t *igraph_rng_default(void) {
+    if (IGRAPH_UNLIKELY(igraph_i_rng_default.state == NULL)) {
+        igraph_i_rng_default.state = igraph_i_rng_default_state();
+    }
     return &igraph_i_rng_default;
 }
 
@@ -205,6 +227,8 @@ static uint64_t igraph_i_rng_get_uint64(igraph_rng_t *rng);
 static uint64_t igraph_i_rng_get_uint64_bounded(igraph_rng_t *rng, uint64_t range);
 #endif
 
+static igraph_real_t igraph_i_rng_bits_to_unif01(uint64_t bits);
+
 static double igraph_i_norm_rand(igraph_rng_t *rng);
 static double igraph_i_exp_rand(igraph_rng_t *rng);
 static double igraph_i_rbinom(igraph_rng_t *rng, igraph_integer_t n, double pp);
@@ -246,6 +270,15 @@ void igraph_rng_destroy(igraph_rng_t *rng) {
     rng->type->destroy(rng->state);
 }
 
+/* The SplitMix64 output function, used to combine seeds and stream numbers
+ * for generators that do not support streams natively. */
+static uint64_t igraph_i_splitmix64(uint64_t x) {
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
 /**
  * \function igraph_rng_seed
  * \brief Seeds a random number generator.
@@ -264,6 +297,61 @@ igraph_error_t igraph_rng_seed(igraph_rng_t *rng, igraph_uint_t seed) {
     return IGRAPH_SUCCESS;
 }
 
+/**
+ * \function igraph_rng_seed_stream
+ * \brief Seeds a random number generator to one of many independent streams.
+ *
+ * Seeding several generators with the same \p seed and different \p stream
+ * numbers gives generators that produce independent sequences. This is
+ * the recommended way of obtaining separate generators for the tasks of a
+ * parallel computation: if the task index is used as the stream number, the
+ * results do not depend on how tasks are assigned to threads.
+ *
+ * </para><para>
+ * For the \ref igraph_rngtype_philox4x32 generator the streams are
+ * guaranteed not to overlap. For other generators, the seed and the stream
+ * number are hashed into a single seed, which gives independent streams
+ * with high probability.
+ *
+ * \param rng The RNG.
+ * \param seed The seed, shared by all streams.
+ * \param stream The stream number.
+ * \return Error code.
+ *
+ * Time complexity: same as \ref igraph_rng_seed(), O(1) for counter-based
+ * generators.
+ */
+
+igraph_error_t igraph_rng_seed_stream(igraph_rng_t *rng, igraph_uint_t seed,
+                                      igraph_uint_t stream) {
+    const igraph_rng_type_t *type = rng->type;
+    if (type == &igraph_rngtype_philox4x32) {
+        IGRAPH_CHECK(igraph_i_rng_philox_seed_stream(rng->state, seed, stream));
+    } else {
+        uint64_t mixed = igraph_i_splitmix64((uint64_t) seed ^ igraph_i_splitmix64(stream));
+        IGRAPH_CHECK(type->seed(rng->state, (igraph_uint_t) mixed));
+    }
+    rng->is_seeded = 1;
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * Draws a seed for a set of random number streams from the default RNG,
+ * to be used with igraph_rng_seed_stream(). Randomized functions that split
+ * their work into independent tasks draw a single such seed, then seed a
+ * separate generator for each task with the task index as the stream number.
+ * This makes their results depend only on the state of the default RNG and
+ * not on the number of threads.
+ */
+
+igraph_uint_t igraph_i_rng_stream_seed(void) {
+    igraph_uint_t seed;
+    RNG_BEGIN();
+    seed = igraph_i_rng_get_uint(igraph_rng_default());
+    RNG_END();
+    return seed;
+}
+
 /**
  * \function igraph_rng_bits
  * \brief The number of random bits that a random number generator can produces in a single round.
@@ -680,8 +768,7 @@ igraph_real_t igraph_rng_get_unif01(igraph_rng_t *rng) {
          * Then we subtract 1 to arrive at the [0; 1) interval. This is fast
          * but we lose one bit of precision as there are 2^53 possible doubles
          * between 0 and 1. */
-        uint64_t r = (igraph_i_rng_get_random_bits_uint64(rng, 52) & 0xFFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
-        return *(double *)(&r) - 1.0;
+        return igraph_i_rng_bits_to_unif01(igraph_i_rng_get_random_bits_uint64(rng, 52));
     }
 }
 
@@ -832,6 +919,326 @@ igraph_real_t igraph_rng_get_pois(igraph_rng_t *rng, igraph_real_t rate) {
 }
 
 
+/* ------------------------------------ */
+
+/* Maximum number of raw RNG outputs generated at once by the bulk functions */
+#define IGRAPH_I_RNG_WORD_BLOCK 256
+
+/* The bulk generator of a built-in RNG type, or NULL if it has none. */
+static igraph_i_rng_fill_t *igraph_i_rng_fill_function(const igraph_rng_type_t *type) {
+    if (type == &igraph_rngtype_pcg32) {
+        return igraph_i_rng_pcg32_fill;
+    } else if (type == &igraph_rngtype_pcg64) {
+        return igraph_i_rng_pcg64_fill;
+    } else if (type == &igraph_rngtype_philox4x32) {
+        return igraph_i_rng_philox_fill;
+    }
+    return NULL;
+}
+
+/* Stores n raw outputs of the RNG, the same as n calls to its get() method. */
+static void igraph_i_rng_get_words(igraph_rng_t *rng, igraph_uint_t *words, igraph_integer_t n) {
+    const igraph_rng_type_t *type = rng->type;
+    igraph_i_rng_fill_t *fill = igraph_i_rng_fill_function(type);
+    if (fill) {
+        fill(rng->state, words, n);
+    } else {
+        for (igraph_integer_t i = 0; i < n; i++) {
+            words[i] = type->get(rng->state);
+        }
+    }
+}
+
+/* The number of raw outputs that igraph_i_rng_get_random_bits_uint64() consumes
+ * for the given number of bits. */
+static igraph_integer_t igraph_i_rng_words_per_bits(const igraph_rng_t *rng, uint8_t bits) {
+    igraph_integer_t rng_bitwidth = igraph_rng_bits(rng);
+    return (bits + rng_bitwidth - 1) / rng_bitwidth;
+}
+
+/* Combines raw outputs into random bits exactly like
+ * igraph_i_rng_get_random_bits_uint64() does. */
+static uint64_t igraph_i_rng_combine_words(const igraph_uint_t *words,
+                                           igraph_integer_t rng_bitwidth, uint8_t bits) {
+    uint64_t result;
+
+    if (rng_bitwidth >= bits) {
+        result = *words >> (rng_bitwidth - bits);
+    } else {
+        result = 0;
+        do {
+            result = (result << rng_bitwidth) + *(words++);
+            bits -= rng_bitwidth;
+        } while (bits > rng_bitwidth);
+        result = (result << bits) + (*words >> (rng_bitwidth - bits));
+    }
+
+    return result;
+}
+
+/* Converts 52 random bits to a double in [0, 1); see igraph_rng_get_unif01(). */
+static igraph_real_t igraph_i_rng_bits_to_unif01(uint64_t bits) {
+    uint64_t r = (bits & 0xFFFFFFFFFFFFFull) | 0x3FF0000000000000ull;
+    return *(double *)(&r) - 1.0;
+}
+
+/* Fills an array with the same values as n calls to igraph_rng_get_unif01(). */
+static void igraph_i_rng_fill_unif01(igraph_rng_t *rng, igraph_real_t *res, igraph_integer_t n) {
+    const igraph_rng_type_t *type = rng->type;
+    igraph_uint_t words[IGRAPH_I_RNG_WORD_BLOCK];
+    igraph_integer_t rng_bitwidth = igraph_rng_bits(rng);
+    igraph_integer_t per_value = igraph_i_rng_words_per_bits(rng, 52);
+    igraph_integer_t block = IGRAPH_I_RNG_WORD_BLOCK / per_value;
+
+    if (type->get_real) {
+        for (igraph_integer_t i = 0; i < n; i++) {
+            res[i] = type->get_real(rng->state);
+        }
+        return;
+    }
+
+    while (n > 0) {
+        igraph_integer_t m = n < block ? n : block;
+        igraph_i_rng_get_words(rng, words, m * per_value);
+        /* Special cases of igraph_i_rng_combine_words() for common generators,
+         * so that the compiler can vectorize the loop. */
+        if (rng_bitwidth == 32) {
+            for (igraph_integer_t i = 0; i < m; i++) {
+                uint64_t bits = ((uint64_t)(uint32_t) words[2 * i] << 20) + ((uint32_t) words[2 * i + 1] >> 12);
+                res[i] = igraph_i_rng_bits_to_unif01(bits);
+            }
+        } else if (rng_bitwidth == 64) {
+            for (igraph_integer_t i = 0; i < m; i++) {
+                res[i] = igraph_i_rng_bits_to_unif01((uint64_t) words[i] >> 12);
+            }
+        } else {
+            for (igraph_integer_t i = 0; i < m; i++) {
+                res[i] = igraph_i_rng_bits_to_unif01(
+                             igraph_i_rng_combine_words(words + i * per_value, rng_bitwidth, 52));
+            }
+        }
+        res += m;
+        n -= m;
+    }
+}
+
+/* Transforms uniform variates in [0, 1) to geometric ones, in place, by
+ * inversion. 0 < p <= 1 is assumed. */
+static void igraph_i_rng_unif01_to_geom(igraph_real_t *res, igraph_integer_t n, igraph_real_t p) {
+    igraph_real_t inv_log_q = 1.0 / log1p(-p);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        res[i] = floor(log1p(-res[i]) * inv_log_q);
+    }
+}
+
+/**
+ * \function igraph_rng_fill_unif01
+ * \brief Fills a vector with samples from the unit interval.
+ *
+ * The result is the same as setting the elements of the vector one by one,
+ * using \ref igraph_rng_get_unif01(), but this function is faster because it
+ * obtains the random bits from the generator in large blocks.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, all of its elements are overwritten.
+ * \return Error code, currently always \c IGRAPH_SUCCESS.
+ *
+ * Time complexity: O(n), the length of the vector.
+ */
+
+igraph_error_t igraph_rng_fill_unif01(igraph_rng_t *rng, igraph_vector_t *res) {
+    igraph_i_rng_fill_unif01(rng, VECTOR(*res), igraph_vector_size(res));
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_rng_fill_integer
+ * \brief Fills a vector with random integers from an interval.
+ *
+ * The result is the same as setting the elements of the vector one by one,
+ * using \ref igraph_rng_get_integer(), but this function is faster because it
+ * obtains the random bits from the generator in large blocks.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, all of its elements are overwritten.
+ * \param l Lower limit, inclusive, it can be negative as well.
+ * \param h Upper limit, inclusive, it can be negative as well, but it
+ *        must be at least \p l.
+ * \return Error code: \c IGRAPH_EINVAL if <code>h &lt; l</code>.
+ *
+ * Time complexity: O(n), the length of the vector.
+ */
+
+igraph_error_t igraph_rng_fill_integer(igraph_rng_t *rng, igraph_vector_int_t *res,
+                                       igraph_integer_t l, igraph_integer_t h) {
+    const igraph_rng_type_t *type = rng->type;
+    igraph_integer_t n = igraph_vector_int_size(res);
+    igraph_integer_t *out = VECTOR(*res);
+    igraph_uint_t words[IGRAPH_I_RNG_WORD_BLOCK];
+    igraph_integer_t rng_bitwidth = igraph_rng_bits(rng);
+    igraph_integer_t per_value = igraph_i_rng_words_per_bits(rng, 32);
+    igraph_integer_t block = IGRAPH_I_RNG_WORD_BLOCK / per_value;
+    igraph_integer_t pos = 0, size = 0;
+    igraph_uint_t span;
+    uint32_t range, t;
+
+    if (h < l) {
+        IGRAPH_ERRORF("Lower limit (%" IGRAPH_PRId ") must not be greater than upper limit (%" IGRAPH_PRId ").",
+                      IGRAPH_EINVAL, l, h);
+    }
+
+    /* Bulk generation is only implemented for ranges that need at most 32 bits,
+     * which is the common case. */
+    if (type->get_int || l == h) {
+        span = UINT32_MAX;
+    } else {
+        /* unsigned arithmetic, h - l may not fit into an igraph_integer_t */
+        span = (igraph_uint_t) h - (igraph_uint_t) l;
+    }
+    if (span >= UINT32_MAX) {
+        for (igraph_integer_t i = 0; i < n; i++) {
+            out[i] = igraph_rng_get_integer(rng, l, h);
+        }
+        return IGRAPH_SUCCESS;
+    }
+
+    /* Same as igraph_i_rng_get_uint32_bounded(). Each attempt uses 'per_value'
+     * words, and the buffer is never refilled with more words than the
+     * remaining values need, so the RNG is advanced exactly as much as with
+     * one-by-one generation. */
+    range = (uint32_t) span + 1;
+    t = (-range) % range;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        uint64_t m;
+        do {
+            if (pos == size) {
+                igraph_integer_t count = n - i < block ? n - i : block;
+                size = count * per_value;
+                igraph_i_rng_get_words(rng, words, size);
+                pos = 0;
+            }
+            m = (uint64_t)(uint32_t) igraph_i_rng_combine_words(words + pos, rng_bitwidth, 32) * range;
+            pos += per_value;
+        } while ((uint32_t) m < t);
+        out[i] = l + (igraph_integer_t)(m >> 32);
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_rng_fill_exp
+ * \brief Fills a vector with samples from an exponential distribution.
+ *
+ * The samples follow the same distribution as the ones from
+ * \ref igraph_rng_get_exp(), but they are generated by inversion from
+ * uniform variates obtained in blocks, which is considerably faster. The
+ * values are not the same as the ones \ref igraph_rng_get_exp() would
+ * produce.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, all of its elements are overwritten.
+ * \param rate Rate parameter, must be positive.
+ * \return Error code: \c IGRAPH_EINVAL if the rate is not positive.
+ *
+ * Time complexity: O(n), the length of the vector.
+ */
+
+igraph_error_t igraph_rng_fill_exp(igraph_rng_t *rng, igraph_vector_t *res,
+                                   igraph_real_t rate) {
+    igraph_integer_t n = igraph_vector_size(res);
+    igraph_real_t inv_rate;
+
+    if (!(rate > 0)) {
+        IGRAPH_ERRORF("Rate of exponential distribution must be positive, got %g.",
+                      IGRAPH_EINVAL, rate);
+    }
+
+    inv_rate = 1.0 / rate;
+    igraph_i_rng_fill_unif01(rng, VECTOR(*res), n);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        VECTOR(*res)[i] = -log1p(-VECTOR(*res)[i]) * inv_rate;
+    }
+
+    return IGRAPH_SUCCESS;
+}
+
+/**
+ * \function igraph_rng_fill_geom
+ * \brief Fills a vector with samples from a geometric distribution.
+ *
+ * The samples follow the same distribution as the ones from
+ * \ref igraph_rng_get_geom(), but they are generated by inversion from
+ * uniform variates obtained in blocks, which is considerably faster. The
+ * values are not the same as the ones \ref igraph_rng_get_geom() would
+ * produce.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, all of its elements are overwritten.
+ * \param p The probability of success in each trial. Must be larger
+ *        than zero and smaller or equal to 1.
+ * \return Error code: \c IGRAPH_EINVAL if \p p is out of range.
+ *
+ * Time complexity: O(n), the length of the vector.
+ */
+
+igraph_error_t igraph_rng_fill_geom(igraph_rng_t *rng, igraph_vector_t *res,
+                                    igraph_real_t p) {
+    igraph_integer_t n = igraph_vector_size(res);
+
+    if (!(p > 0 && p <= 1)) {
+        IGRAPH_ERRORF("Success probability of geometric distribution must be in (0, 1], got %g.",
+                      IGRAPH_EINVAL, p);
+    }
+
+    if (p == 1) {
+        igraph_vector_null(res);
+        return IGRAPH_SUCCESS;
+    }
+
+    igraph_i_rng_fill_unif01(rng, VECTOR(*res), n);
+    igraph_i_rng_unif01_to_geom(VECTOR(*res), n, p);
+
+    return IGRAPH_SUCCESS;
+}
+
+/* Buffered random variates for internal use, see random_internal.h. */
+
+void igraph_i_rng_buffer_init(igraph_i_rng_buffer_t *buffer, igraph_rng_t *rng) {
+    buffer->rng = rng;
+    buffer->size = buffer->pos = 0;
+}
+
+void igraph_i_rng_buffer_clear(igraph_i_rng_buffer_t *buffer) {
+    buffer->size = buffer->pos = 0;
+}
+
+void igraph_i_rng_buffer_refill_unif01(igraph_i_rng_buffer_t *buffer, igraph_integer_t needed) {
+    igraph_integer_t size = needed < 1 ? 1 : (needed > IGRAPH_I_RNG_BUFFER_SIZE ? IGRAPH_I_RNG_BUFFER_SIZE : needed);
+    igraph_i_rng_fill_unif01(buffer->rng, buffer->values, size);
+    buffer->size = size;
+    buffer->pos = 0;
+}
+
+void igraph_i_rng_buffer_refill_geom(igraph_i_rng_buffer_t *buffer, igraph_real_t p,
+                                     igraph_real_t trials) {
+    /* About trials * p values will be needed. */
+    igraph_real_t expected = trials * p + 1;
+    igraph_i_rng_buffer_refill_unif01(buffer, expected < IGRAPH_I_RNG_BUFFER_SIZE ?
+                                      (igraph_integer_t) expected : IGRAPH_I_RNG_BUFFER_SIZE);
+    if (p == 1) {
+        for (igraph_integer_t i = 0; i < buffer->size; i++) {
+            buffer->values[i] = 0;
+        }
+    } else {
+        igraph_i_rng_unif01_to_geom(buffer->values, buffer->size, p);
+    }
+}
+
 /**
  * \ingroup internal
  *
@@ -1034,6 +1441,7 @@ igraph_error_t igraph_random_sample(igraph_vector_int_t *res, igraph_integer_t l
 }
 
 static void igraph_i_random_sample_alga_real(igraph_vector_t *res,
+                                       igraph_i_rng_buffer_t *buffer,
                                        igraph_real_t l, igraph_real_t h,
                                        igraph_real_t length) {
     igraph_real_t N = h - l + 1;
@@ -1047,7 +1455,7 @@ static void igraph_i_random_sample_alga_real(igraph_vector_t *res,
     l = l - 1;
 
     while (n >= 2) {
-        V = RNG_UNIF01();
+        V = igraph_i_rng_buffer_unif01(buffer, (igraph_integer_t) n);
         S = 1;
         quot = top / Nreal;
         while (quot > V) {
@@ -1061,7 +1469,7 @@ static void igraph_i_random_sample_alga_real(igraph_vector_t *res,
         Nreal = -1.0 + Nreal; n = -1 + n;
     }
 
-    S = trunc(round(Nreal) * RNG_UNIF01());
+    S = trunc(round(Nreal) * igraph_i_rng_buffer_unif01(buffer, 1));
     l += S + 1;
     igraph_vector_push_back(res, l); /* allocated */
 }
@@ -1111,6 +1519,7 @@ igraph_error_t igraph_random_sample_real(igraph_vector_t *res, igraph_real_t l,
     igraph_real_t negalphainv = -13;
     igraph_real_t threshold = -negalphainv * n;
     igraph_real_t S;
+    igraph_i_rng_buffer_t buffer;
 
     /* getting back some sense of sanity */
     if (l > h) {
@@ -1149,7 +1558,14 @@ igraph_error_t igraph_random_sample_real(igraph_vector_t *res, igraph_real_t l,
 
     RNG_BEGIN();
 
-    Vprime = exp(log(RNG_UNIF01()) * ninv);
+    /* Uniform numbers are drawn in blocks. The block sizes are based on lower
+     * bounds of the number of values needed: every sample of the main loop
+     * uses at least one, except possibly the last sample, and Algorithm A
+     * uses exactly one per sample. The result is therefore the same as with
+     * drawing the numbers one by one. */
+    igraph_i_rng_buffer_init(&buffer, igraph_rng_default());
+
+    Vprime = exp(log(igraph_i_rng_buffer_unif01(&buffer, length)) * ninv);
     l = l - 1;
 
     while (n > 1 && threshold < N) {
@@ -1165,9 +1581,9 @@ igraph_error_t igraph_random_sample_real(igraph_vector_t *res, igraph_real_t l,
                 if (S < qu1) {
                     break;
                 }
-                Vprime = exp(log(RNG_UNIF01()) * ninv);
+                Vprime = exp(log(igraph_i_rng_buffer_unif01(&buffer, (igraph_integer_t) n - 1)) * ninv);
             }
-            U = RNG_UNIF01();
+            U = igraph_i_rng_buffer_unif01(&buffer, (igraph_integer_t) n - 1);
             negSreal = -S;
 
             y1 = exp(log(U * Nreal / qu1real) * nmin1inv);
@@ -1191,10 +1607,10 @@ igraph_error_t igraph_random_sample_real(igraph_vector_t *res, igraph_real_t l,
                 bottom = -1.0 + bottom;
             }
             if (Nreal / (-X + Nreal) >= y1 * exp(log(y2)*nmin1inv)) {
-                Vprime = exp(log(RNG_UNIF01()) * nmin1inv);
+                Vprime = exp(log(igraph_i_rng_buffer_unif01(&buffer, (igraph_integer_t) n - 1)) * nmin1inv);
                 break;
             }
-            Vprime = exp(log(RNG_UNIF01()) * ninv);
+            Vprime = exp(log(igraph_i_rng_buffer_unif01(&buffer, (igraph_integer_t) n - 1)) * ninv);
         }
 
         l += S + 1;
@@ -1206,7 +1622,7 @@ igraph_error_t igraph_random_sample_real(igraph_vector_t *res, igraph_real_t l,
     }
 
     if (n > 1) {
-        igraph_i_random_sample_alga_real(res, l + 1, h, n);
+        igraph_i_random_sample_alga_real(res, &buffer, l + 1, h, n);
     } else {
         S = floor(N * Vprime);
         l += S + 1;
@@ -25,6 +25,7 @@
 
 #include "igraph_decls.h"
 #include "igraph_types.h"
+#include "igraph_random.h"
 #include "igraph_vector.h"
 
 __BEGIN_DECLS
@@ -33,6 +34,80 @@ igraph_error_t igraph_random_sample_real(
         igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
         igraph_integer_t length);
 
+igraph_uint_t igraph_i_rng_stream_seed(void);
+
+void *igraph_i_rng_default_state(void);
+
+/* Bulk versions of the get() method of the built-in RNG types: store the
+ * same n values as n calls to get(). They are not part of igraph_rng_type_t,
+ * which user-defined types that were compiled against older headers also
+ * use; random.c picks them by comparing the type pointer instead. */
+typedef void igraph_i_rng_fill_t(void *state, igraph_uint_t *buffer, igraph_integer_t n);
+
+igraph_i_rng_fill_t igraph_i_rng_pcg32_fill;
+igraph_i_rng_fill_t igraph_i_rng_pcg64_fill;
+igraph_i_rng_fill_t igraph_i_rng_philox_fill;
+
+/* Seeds a Philox state to the given stream in constant time, see
+ * igraph_rng_seed_stream(). */
+igraph_error_t igraph_i_rng_philox_seed_stream(void *state, igraph_uint_t seed,
+                                               igraph_uint_t stream);
+
+/* Buffered random variates, for loops that consume many of them one at a time.
+ * The values are generated in blocks by the same code as igraph_rng_fill_...().
+ *
+ * 'needed' is the number of values the caller expects to consume, including
+ * the current one, and limits the size of the next block. Values left in the
+ * buffer when the caller is done are wasted, and the RNG will have advanced
+ * further than without buffering. When 'needed' is a lower bound on the
+ * number of values that will be consumed, uniform values are exactly the same
+ * as with igraph_rng_get_unif01() and the RNG ends up in the same state.
+ *
+ * Geometric variates take the number of remaining Bernoulli trials instead,
+ * see igraph_i_rng_buffer_geom().
+ *
+ * A buffer must only be used for one distribution at a time; call
+ * igraph_i_rng_buffer_clear() before changing the distribution or its
+ * parameter. */
+
+#define IGRAPH_I_RNG_BUFFER_SIZE 256
+
+typedef struct {
+    igraph_rng_t *rng;
+    igraph_integer_t size, pos;
+    igraph_real_t values[IGRAPH_I_RNG_BUFFER_SIZE];
+} igraph_i_rng_buffer_t;
+
+void igraph_i_rng_buffer_init(igraph_i_rng_buffer_t *buffer, igraph_rng_t *rng);
+void igraph_i_rng_buffer_clear(igraph_i_rng_buffer_t *buffer);
+void igraph_i_rng_buffer_refill_unif01(igraph_i_rng_buffer_t *buffer, igraph_integer_t needed);
+void igraph_i_rng_buffer_refill_geom(igraph_i_rng_buffer_t *buffer, igraph_real_t p,
+                                     igraph_real_t trials);
+
+static inline igraph_real_t igraph_i_rng_buffer_unif01(igraph_i_rng_buffer_t *buffer,
+                                                       igraph_integer_t needed) {
+    if (buffer->pos == buffer->size) {
+        igraph_i_rng_buffer_refill_unif01(buffer, needed);
+    }
+    return buffer->values[buffer->pos++];
+}
+
+/* Geometric variate with success probability 0 <= p <= 1, for skipping over
+ * Bernoulli trials. 'trials' is the number of trials the caller may still
+ * skip over, which gives the expected number of values needed. For p = 0,
+ * returns infinity without using the RNG. */
+static inline igraph_real_t igraph_i_rng_buffer_geom(igraph_i_rng_buffer_t *buffer,
+                                                     igraph_real_t p,
+                                                     igraph_real_t trials) {
+    if (p == 0) {
+        return IGRAPH_INFINITY;
+    }
+    if (buffer->pos == buffer->size) {
+        igraph_i_rng_buffer_refill_geom(buffer, p, trials);
+    }
+    return buffer->values[buffer->pos++];
+}
+
 __END_DECLS
 
 #endif
@@ -23,6 +23,8 @@
 
 #include "pcg/pcg_variants.h"
 
+#include "random/random_internal.h"
+
 #include "config.h" /* IGRAPH_THREAD_LOCAL */
 
 /* The original implementation of the 32-bit PCG random number generator in this
@@ -40,6 +42,13 @@ static igraph_uint_t igraph_rng_pcg32_get(void *vstate) {
     return pcg32_random_r(state);
 }
 
+void igraph_i_rng_pcg32_fill(void *vstate, igraph_uint_t *buffer, igraph_integer_t n) {
+    pcg32_random_t *state = (pcg32_random_t*) vstate;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        buffer[i] = pcg32_random_r(state);
+    }
+}
+
 static igraph_error_t igraph_rng_pcg32_seed(void *vstate, igraph_uint_t seed) {
     pcg32_random_t *state = (pcg32_random_t*) vstate;
 
@@ -113,12 +122,21 @@ const igraph_rng_type_t igraph_rngtype_pcg32 = {
 
 #define addr(a) (&a)
 
-static pcg32_random_t igraph_i_rng_default_state = PCG32_INITIALIZER;
+/* Both the default RNG and its state are thread-local, so that each thread
+ * has its own independent default generator. Since the address of a
+ * thread-local variable is not a constant expression, the state pointer is
+ * filled in by igraph_rng_default() on first use in each thread. */
+
+static IGRAPH_THREAD_LOCAL pcg32_random_t igraph_i_rng_default_pcg32_state = PCG32_INITIALIZER;
 
 IGRAPH_THREAD_LOCAL igraph_rng_t igraph_i_rng_default = {
     addr(igraph_rngtype_pcg32),
-    addr(igraph_i_rng_default_state),
+    /* state = */ NULL,
     /* is_seeded = */ true
 };
 
 #undef addr
+
+void *igraph_i_rng_default_state(void) {
+    return &igraph_i_rng_default_pcg32_state;
+}
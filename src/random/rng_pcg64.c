@@ -21,6 +21,8 @@
 #include "igraph_memory.h"
 #include "igraph_types.h"
 
+#include "random/random_internal.h"
+
 #include "config.h"
 
 /* The original implementation of the 64-bit PCG random number generator in this
@@ -42,6 +44,13 @@ static igraph_uint_t igraph_rng_pcg64_get(void *vstate) {
     return pcg64_random_r(state);
 }
 
+void igraph_i_rng_pcg64_fill(void *vstate, igraph_uint_t *buffer, igraph_integer_t n) {
+    pcg64_random_t *state = (pcg64_random_t*) vstate;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        buffer[i] = pcg64_random_r(state);
+    }
+}
+
 static igraph_error_t igraph_rng_pcg64_seed(void *vstate, igraph_uint_t seed) {
     pcg64_random_t *state = (pcg64_random_t*) vstate;
 
@@ -85,6 +94,13 @@ static igraph_uint_t igraph_rng_pcg64_get(void *vstate) {
     return 0;
 }
 
+void igraph_i_rng_pcg64_fill(void *vstate, igraph_uint_t *buffer, igraph_integer_t n) {
+    IGRAPH_UNUSED(vstate);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        buffer[i] = 0;
+    }
+}
+
 static igraph_error_t igraph_rng_pcg64_seed(void *vstate, igraph_uint_t seed) {
     IGRAPH_UNUSED(vstate); IGRAPH_UNUSED(seed);
     IGRAPH_ERROR("64-bit PCG generator needs __uint128_t.", IGRAPH_UNIMPLEMENTED);
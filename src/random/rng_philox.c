@@ -0,0 +1,223 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "igraph_random.h"
+
+#include "igraph_memory.h"
+#include "igraph_types.h"
+
+#include "random/random_internal.h"
+
+/* Philox4x32-10 counter-based random number generator, from
+ *
+ * J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw: Parallel random
+ * numbers: as easy as 1, 2, 3. Proceedings of the 2011 International
+ * Conference for High Performance Computing, Networking, Storage and
+ * Analysis (SC11). https://doi.org/10.1145/2063384.2063405
+ *
+ * The generator is a bijection of a 128-bit counter, keyed with a 64-bit key.
+ * We use the seed as the key, the low 64 bits of the counter as the position
+ * within a stream and the high 64 bits as the stream number. Each evaluation
+ * produces four 32-bit outputs, which are buffered. */
+
+#define PHILOX_M0 UINT32_C(0xD2511F53)
+#define PHILOX_M1 UINT32_C(0xCD9E8D57)
+#define PHILOX_W0 UINT32_C(0x9E3779B9)
+#define PHILOX_W1 UINT32_C(0xBB67AE85)
+#define PHILOX_ROUNDS 10
+
+typedef struct {
+    uint32_t key[2];
+    uint32_t counter[4];
+    uint32_t output[4];
+    int next; /* index of the next unused element of 'output', 4 if none */
+} igraph_i_rng_philox_state_t;
+
+static void igraph_i_rng_philox_block(const uint32_t counter[4], const uint32_t key[2],
+                                      uint32_t output[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t) p1;
+        c3 = (uint32_t) p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    output[0] = c0; output[1] = c1; output[2] = c2; output[3] = c3;
+}
+
+static igraph_uint_t igraph_rng_philox_get(void *vstate) {
+    igraph_i_rng_philox_state_t *state = (igraph_i_rng_philox_state_t *) vstate;
+
+    if (state->next == 4) {
+        igraph_i_rng_philox_block(state->counter, state->key, state->output);
+        /* Advance the 64-bit position within the stream. */
+        if (++state->counter[0] == 0) {
+            state->counter[1]++;
+        }
+        state->next = 0;
+    }
+
+    return state->output[state->next++];
+}
+
+/* Evaluates the generator at PHILOX_LANES consecutive counter values. The
+ * lanes are independent, which lets the compiler vectorize the rounds. */
+#define PHILOX_LANES 8
+
+static void igraph_i_rng_philox_blocks(igraph_i_rng_philox_state_t *state,
+                                       igraph_uint_t *buffer) {
+    uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+    uint32_t k0 = state->key[0], k1 = state->key[1];
+
+    for (int j = 0; j < PHILOX_LANES; j++) {
+        c0[j] = state->counter[0];
+        c1[j] = state->counter[1];
+        c2[j] = state->counter[2];
+        c3[j] = state->counter[3];
+        if (++state->counter[0] == 0) {
+            state->counter[1]++;
+        }
+    }
+
+    for (int round = 0; round < PHILOX_ROUNDS; round++) {
+        for (int j = 0; j < PHILOX_LANES; j++) {
+            uint64_t p0 = (uint64_t) PHILOX_M0 * c0[j];
+            uint64_t p1 = (uint64_t) PHILOX_M1 * c2[j];
+            c0[j] = (uint32_t) (p1 >> 32) ^ c1[j] ^ k0;
+            c2[j] = (uint32_t) (p0 >> 32) ^ c3[j] ^ k1;
+            c1[j] = (uint32_t) p1;
+            c3[j] = (uint32_t) p0;
+        }
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    for (int j = 0; j < PHILOX_LANES; j++) {
+        buffer[4 * j]     = c0[j];
+        buffer[4 * j + 1] = c1[j];
+        buffer[4 * j + 2] = c2[j];
+        buffer[4 * j + 3] = c3[j];
+    }
+}
+
+void igraph_i_rng_philox_fill(void *vstate, igraph_uint_t *buffer, igraph_integer_t n) {
+    igraph_i_rng_philox_state_t *state = (igraph_i_rng_philox_state_t *) vstate;
+    igraph_integer_t i = 0;
+
+    /* Use up the outputs that are already buffered, then generate the rest
+     * directly into the output, several blocks at a time. */
+    while (i < n && state->next < 4) {
+        buffer[i++] = state->output[state->next++];
+    }
+    while (n - i >= 4 * PHILOX_LANES) {
+        igraph_i_rng_philox_blocks(state, buffer + i);
+        i += 4 * PHILOX_LANES;
+    }
+    while (i < n) {
+        buffer[i++] = igraph_rng_philox_get(state);
+    }
+}
+
+igraph_error_t igraph_i_rng_philox_seed_stream(void *vstate, igraph_uint_t seed,
+                                              igraph_uint_t stream) {
+    igraph_i_rng_philox_state_t *state = (igraph_i_rng_philox_state_t *) vstate;
+    uint64_t seed64 = seed, stream64 = stream;
+
+    state->key[0] = (uint32_t) seed64;
+    state->key[1] = (uint32_t) (seed64 >> 32);
+    state->counter[0] = 0;
+    state->counter[1] = 0;
+    state->counter[2] = (uint32_t) stream64;
+    state->counter[3] = (uint32_t) (stream64 >> 32);
+    state->next = 4;
+
+    return IGRAPH_SUCCESS;
+}
+
+static igraph_error_t igraph_rng_philox_seed(void *vstate, igraph_uint_t seed) {
+    return igraph_i_rng_philox_seed_stream(vstate, seed, 0);
+}
+
+static igraph_error_t igraph_rng_philox_init(void **state) {
+    igraph_i_rng_philox_state_t *st;
+
+    st = IGRAPH_CALLOC(1, igraph_i_rng_philox_state_t);
+    IGRAPH_CHECK_OOM(st, "Cannot initialize Philox RNG.");
+    (*state) = st;
+
+    igraph_rng_philox_seed(st, 0);
+
+    return IGRAPH_SUCCESS;
+}
+
+static void igraph_rng_philox_destroy(void *vstate) {
+    igraph_i_rng_philox_state_t *state = (igraph_i_rng_philox_state_t *) vstate;
+    IGRAPH_FREE(state);
+}
+
+/**
+ * \var igraph_rngtype_philox4x32
+ * \brief The Philox4x32-10 counter-based random number generator.
+ *
+ * Philox is a counter-based generator: the random numbers are obtained by
+ * applying a keyed bijection to a simple counter. This makes it possible to
+ * derive a large number of independent streams from a single seed in constant
+ * time, using \ref igraph_rng_seed_stream(), which is useful for generating
+ * random numbers in parallel computations reproducibly. This implementation
+ * returns 32 random bits in a single iteration.
+ *
+ * </para><para>
+ * The seed is used as the 64-bit key, and the stream number selects one of
+ * 2^64 non-overlapping streams, each of which has period 2^66.
+ *
+ * </para><para>
+ * Reference:
+ *
+ * </para><para>
+ * J. K. Salmon, M. A. Moraes, R. O. Dror and D. E. Shaw:
+ * Parallel random numbers: as easy as 1, 2, 3.
+ * Proceedings of the International Conference for High Performance Computing,
+ * Networking, Storage and Analysis (SC11), 2011.
+ * https://doi.org/10.1145/2063384.2063405
+ */
+
+const igraph_rng_type_t igraph_rngtype_philox4x32 = {
+    /* name= */      "PHILOX4X32",
+    /* bits=  */     32,
+    /* init= */      igraph_rng_philox_init,
+    /* destroy= */   igraph_rng_philox_destroy,
+    /* seed= */      igraph_rng_philox_seed,
+    /* get= */       igraph_rng_philox_get,
+    /* get_int= */   0,
+    /* get_real= */  0,
+    /* get_norm= */  0,
+    /* get_geom= */  0,
+    /* get_binom= */ 0,
+    /* get_exp= */   0,
+    /* get_gamma= */ 0,
+    /* get_pois= */  0
+};
@@ -35,12 +35,26 @@ static inline void igraph_get_cpu_time(double *data) {
     data[2] = (double) self.ru_stime.tv_sec + 1e-6 * self.ru_stime.tv_usec; /* system */
 }
 
+/* The peak resident memory of the process so far, in megabytes. */
+static inline double igraph_get_peak_memory(void) {
+    struct rusage self;
+    getrusage(RUSAGE_SELF, &self);
+#ifdef __APPLE__
+    return self.ru_maxrss / 1048576.0; /* bytes */
+#else
+    return self.ru_maxrss / 1024.0;    /* kilobytes */
+#endif
+}
+
 #define BENCH_INIT() \
     do { \
         printf("\n|> Benchmark file: %s\n", IGRAPH_FILE_BASENAME); \
         sleep(1); \
     } while (0)
 
+#define BENCH_PEAK_MEMORY() \
+    printf("|   %-78s %6.1f MB\n", "peak memory", igraph_get_peak_memory())
+
 #define REPEAT(CODE, N) \
     do { \
         igraph_integer_t rep_i; \
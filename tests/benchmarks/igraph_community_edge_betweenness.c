@@ -0,0 +1,52 @@
+#include <igraph.h>
+#include "bench.h"
+
+void run_bench(igraph_integer_t blocks, igraph_integer_t block_size, int rep) {
+    igraph_t graph;
+    igraph_matrix_t pref_matrix;
+    igraph_vector_int_t block_sizes, removed_edges;
+    igraph_vector_t weights;
+    igraph_integer_t n = blocks * block_size;
+    char msg[128];
+
+    igraph_matrix_init(&pref_matrix, blocks, blocks);
+    igraph_matrix_fill(&pref_matrix, 0.5 / n);
+    for (igraph_integer_t i = 0; i < blocks; i++) {
+        MATRIX(pref_matrix, i, i) = 8.0 / block_size;
+    }
+    igraph_vector_int_init(&block_sizes, blocks);
+    igraph_vector_int_fill(&block_sizes, block_size);
+    igraph_sbm_game(&graph, n, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    igraph_vector_init(&weights, igraph_ecount(&graph));
+    igraph_rng_fill_unif01(igraph_rng_default(), &weights);
+    igraph_vector_add_constant(&weights, 1);
+    igraph_vector_int_init(&removed_edges, 0);
+
+    snprintf(msg, sizeof(msg) / sizeof(msg[0]),
+             "%d Edge betweenness, SBM, n=%" IGRAPH_PRId ", m=%" IGRAPH_PRId ", unweighted",
+             rep, n, igraph_ecount(&graph));
+    BENCH(msg, igraph_community_edge_betweenness(&graph, &removed_edges, NULL, NULL, NULL, NULL, NULL, IGRAPH_UNDIRECTED, NULL));
+
+    snprintf(msg, sizeof(msg) / sizeof(msg[0]),
+             "%d Edge betweenness, SBM, n=%" IGRAPH_PRId ", m=%" IGRAPH_PRId ", weighted",
+             rep + 1, n, igraph_ecount(&graph));
+    BENCH(msg, igraph_community_edge_betweenness(&graph, &removed_edges, NULL, NULL, NULL, NULL, NULL, IGRAPH_UNDIRECTED, &weights));
+
+    igraph_vector_int_destroy(&removed_edges);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&graph);
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref_matrix);
+}
+
+int main(void) {
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    /* Communities of 50 vertices with average degree 8. */
+    run_bench(4, 50, 1);
+    run_bench(8, 50, 3);
+
+    return 0;
+}
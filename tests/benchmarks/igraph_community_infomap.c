@@ -0,0 +1,44 @@
+#include <igraph.h>
+#include "bench.h"
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_t pref_matrix;
+    igraph_vector_int_t block_sizes, membership;
+    igraph_real_t codelength;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    igraph_vector_int_init(&membership, 0);
+
+    /* 10 blocks of 300 vertices, with clear community structure. */
+    igraph_matrix_init(&pref_matrix, 10, 10);
+    igraph_matrix_fill(&pref_matrix, 0.004);
+    for (igraph_integer_t i = 0; i < 10; i++) {
+        MATRIX(pref_matrix, i, i) = 0.05;
+    }
+    igraph_vector_int_init(&block_sizes, 10);
+    igraph_vector_int_fill(&block_sizes, 300);
+    igraph_sbm_game(&graph, 3000, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    /* The trials are independent, with enough threads they take about as
+     * long as a single one. */
+    BENCH(" 1 Infomap, SBM, n=3000, 1 trial",
+          igraph_community_infomap(&graph, NULL, NULL, 1, &membership, &codelength)
+         );
+    BENCH(" 2 Infomap, SBM, n=3000, 8 trials",
+          igraph_community_infomap(&graph, NULL, NULL, 8, &membership, &codelength)
+         );
+    BENCH(" 3 Infomap, SBM, n=3000, 32 trials",
+          igraph_community_infomap(&graph, NULL, NULL, 32, &membership, &codelength)
+         );
+
+    igraph_destroy(&graph);
+
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref_matrix);
+    igraph_vector_int_destroy(&membership);
+
+    return 0;
+}
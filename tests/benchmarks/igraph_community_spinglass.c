@@ -0,0 +1,49 @@
+#include <igraph.h>
+#include "bench.h"
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_t pref_matrix;
+    igraph_vector_int_t block_sizes, membership;
+    igraph_real_t modularity;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    igraph_vector_int_init(&membership, 0);
+
+    /* 4 blocks of 250 vertices, with clear community structure. */
+    igraph_matrix_init(&pref_matrix, 4, 4);
+    igraph_matrix_fill(&pref_matrix, 0.002);
+    for (igraph_integer_t i = 0; i < 4; i++) {
+        MATRIX(pref_matrix, i, i) = 0.04;
+    }
+    igraph_vector_int_init(&block_sizes, 4);
+    igraph_vector_int_fill(&block_sizes, 250);
+    igraph_sbm_game(&graph, 1000, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    BENCH(" 1 Spinglass, SBM, n=1000, original implementation",
+          igraph_community_spinglass(&graph, NULL, &modularity, NULL, &membership, NULL,
+                                     25, false, 1.0, 0.01, 0.99,
+                                     IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0,
+                                     IGRAPH_SPINCOMM_IMP_ORIG, 1.0)
+         );
+    BENCH(" 2 Spinglass, SBM, n=1000, parallel tempering, 1 replica",
+          igraph_community_spinglass_tempering(&graph, NULL, &modularity, NULL, &membership, NULL,
+                                               25, 1, 1.0, 0.01, 0.99,
+                                               IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0)
+         );
+    BENCH(" 3 Spinglass, SBM, n=1000, parallel tempering, 4 replicas",
+          igraph_community_spinglass_tempering(&graph, NULL, &modularity, NULL, &membership, NULL,
+                                               25, 4, 1.0, 0.01, 0.99,
+                                               IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0)
+         );
+
+    igraph_destroy(&graph);
+
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref_matrix);
+    igraph_vector_int_destroy(&membership);
+
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <igraph.h>
+#include "bench.h"
+
+/* The peak resident memory of the process never decreases, so the runs are
+ * ordered by increasing memory bound, and the last one is unbounded. */
+void run_bench(const igraph_t *graph, igraph_integer_t max_memory, int rep) {
+    igraph_matrix_int_t merges;
+    igraph_vector_t modularity;
+    char msg[128];
+
+    igraph_matrix_int_init(&merges, 0, 0);
+    igraph_vector_init(&modularity, 0);
+
+    if (max_memory < 0) {
+        snprintf(msg, sizeof(msg) / sizeof(msg[0]),
+                 "%d Walktrap, n=%" IGRAPH_PRId ", m=%" IGRAPH_PRId ", unbounded",
+                 rep, igraph_vcount(graph), igraph_ecount(graph));
+    } else {
+        snprintf(msg, sizeof(msg) / sizeof(msg[0]),
+                 "%d Walktrap, n=%" IGRAPH_PRId ", m=%" IGRAPH_PRId ", max_memory=%" IGRAPH_PRId " MB",
+                 rep, igraph_vcount(graph), igraph_ecount(graph), max_memory >> 20);
+    }
+    BENCH(msg, igraph_community_walktrap_bounded(graph, NULL, 4, max_memory, &merges, &modularity, NULL));
+    BENCH_PEAK_MEMORY();
+
+    igraph_vector_destroy(&modularity);
+    igraph_matrix_int_destroy(&merges);
+}
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_t pref_matrix;
+    igraph_vector_int_t block_sizes;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    /* 50 blocks of 100 vertices, with average degree 10. */
+    igraph_matrix_init(&pref_matrix, 50, 50);
+    igraph_matrix_fill(&pref_matrix, 2.0 / 5000);
+    for (igraph_integer_t i = 0; i < 50; i++) {
+        MATRIX(pref_matrix, i, i) = 8.0 / 100;
+    }
+    igraph_vector_int_init(&block_sizes, 50);
+    igraph_vector_int_fill(&block_sizes, 100);
+    igraph_sbm_game(&graph, 5000, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    BENCH_PEAK_MEMORY();
+    run_bench(&graph, 4 << 20, 1);
+    run_bench(&graph, 16 << 20, 2);
+    run_bench(&graph, -1, 3);
+
+    igraph_destroy(&graph);
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref_matrix);
+
+    return 0;
+}
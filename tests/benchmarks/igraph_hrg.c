@@ -0,0 +1,53 @@
+#include <igraph.h>
+#include "bench.h"
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_t pref_matrix;
+    igraph_vector_int_t block_sizes, parents, edges;
+    igraph_vector_t weights, prob;
+    igraph_hrg_t hrg;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    /* 4 blocks of 30 vertices. */
+    igraph_matrix_init(&pref_matrix, 4, 4);
+    igraph_matrix_fill(&pref_matrix, 0.02);
+    for (igraph_integer_t i = 0; i < 4; i++) {
+        MATRIX(pref_matrix, i, i) = 0.3;
+    }
+    igraph_vector_int_init(&block_sizes, 4);
+    igraph_vector_int_fill(&block_sizes, 30);
+    igraph_sbm_game(&graph, 120, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    igraph_hrg_init(&hrg, igraph_vcount(&graph));
+    igraph_vector_int_init(&parents, 0);
+    igraph_vector_init(&weights, 0);
+    igraph_vector_int_init(&edges, 0);
+    igraph_vector_init(&prob, 0);
+
+    /* Fitting runs one chain per thread, the sampling of the consensus tree
+     * and of the link probabilities is divided between independent chains. */
+    BENCH(" 1 HRG fit, SBM, n=120, until convergence",
+          igraph_hrg_fit(&graph, &hrg, /* start= */ false, /* steps= */ 0)
+         );
+    BENCH(" 2 HRG consensus, SBM, n=120, 200 samples",
+          igraph_hrg_consensus(&graph, &parents, &weights, &hrg, /* start= */ true, 200)
+         );
+    BENCH(" 3 HRG predict, SBM, n=120, 200 samples",
+          igraph_hrg_predict(&graph, &edges, &prob, &hrg, /* start= */ true, 200, 25)
+         );
+
+    igraph_vector_destroy(&prob);
+    igraph_vector_int_destroy(&edges);
+    igraph_vector_destroy(&weights);
+    igraph_vector_int_destroy(&parents);
+    igraph_hrg_destroy(&hrg);
+    igraph_destroy(&graph);
+
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref_matrix);
+
+    return 0;
+}
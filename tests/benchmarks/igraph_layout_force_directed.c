@@ -0,0 +1,77 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_t layout;
+    igraph_layout_drl_options_t drl_options;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    BENCH_INIT();
+
+    igraph_matrix_init(&layout, 0, 0);
+
+    /* Graphs with more than 1000 vertices approximate the repulsion with a
+     * Barnes-Hut tree, except for the Fruchterman-Reingold layout with
+     * IGRAPH_LAYOUT_NOGRID, which computes it for all pairs. */
+    igraph_barabasi_game(&graph, 5000, 1, 2, NULL, true, 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, NULL);
+
+    BENCH(" 1 Fruchterman-Reingold, n=5000, 20 iterations, exact",
+          igraph_layout_fruchterman_reingold(&graph, &layout, false, 20, 70,
+                                             IGRAPH_LAYOUT_NOGRID, NULL, NULL, NULL, NULL, NULL)
+         );
+    BENCH(" 2 Fruchterman-Reingold, n=5000, 20 iterations, grid",
+          igraph_layout_fruchterman_reingold(&graph, &layout, false, 20, 70,
+                                             IGRAPH_LAYOUT_GRID, NULL, NULL, NULL, NULL, NULL)
+         );
+    BENCH(" 3 Fruchterman-Reingold, n=5000, 20 iterations, Barnes-Hut",
+          igraph_layout_fruchterman_reingold(&graph, &layout, false, 20, 70,
+                                             IGRAPH_LAYOUT_AUTOGRID, NULL, NULL, NULL, NULL, NULL)
+         );
+    BENCH(" 4 Fruchterman-Reingold 3D, n=5000, 20 iterations, Barnes-Hut",
+          igraph_layout_fruchterman_reingold_3d(&graph, &layout, false, 20, 70,
+                                                NULL, NULL, NULL, NULL, NULL, NULL, NULL)
+         );
+    BENCH(" 5 Graphopt, n=5000, 20 iterations, Barnes-Hut",
+          igraph_layout_graphopt(&graph, &layout, 20, 0.001, 30, 0, 1, 5, false)
+         );
+    BENCH(" 6 GEM, n=5000, 100000 steps, Barnes-Hut",
+          igraph_layout_gem(&graph, &layout, false, 100000, 5000, 0.1, sqrt(5000))
+         );
+    BENCH(" 7 Kamada-Kawai, n=5000, 50 * n iterations, sparse stress model",
+          igraph_layout_kamada_kawai(&graph, &layout, false, 50 * 5000, 0, 5000,
+                                     NULL, NULL, NULL, NULL, NULL)
+         );
+    igraph_layout_drl_options_init(&drl_options, IGRAPH_LAYOUT_DRL_DEFAULT);
+    BENCH(" 8 DrL, n=5000, default options",
+          igraph_layout_drl(&graph, &layout, false, &drl_options, NULL)
+         );
+    BENCH(" 9 DrL 3D, n=5000, default options",
+          igraph_layout_drl_3d(&graph, &layout, false, &drl_options, NULL)
+         );
+    igraph_destroy(&graph);
+
+    igraph_barabasi_game(&graph, 100000, 1, 2, NULL, true, 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, NULL);
+    BENCH("10 Fruchterman-Reingold, n=100000, 20 iterations, Barnes-Hut",
+          igraph_layout_fruchterman_reingold(&graph, &layout, false, 20, 300,
+                                             IGRAPH_LAYOUT_AUTOGRID, NULL, NULL, NULL, NULL, NULL)
+         );
+    BENCH("11 Multilevel Fruchterman-Reingold, n=100000, 20 iterations per level",
+          igraph_layout_multilevel(&graph, &layout, 20, 50, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD)
+         );
+    BENCH("12 Multilevel graphopt, n=100000, 20 iterations per level",
+          igraph_layout_multilevel(&graph, &layout, 20, 50, IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT)
+         );
+    BENCH("13 Kamada-Kawai, n=100000, 10 * n iterations, sparse stress model",
+          igraph_layout_kamada_kawai(&graph, &layout, false, 10 * 100000, 0, 100000,
+                                     NULL, NULL, NULL, NULL, NULL)
+         );
+    igraph_destroy(&graph);
+
+    igraph_matrix_destroy(&layout);
+
+    return 0;
+}
@@ -62,6 +62,33 @@ int main(void) {
     BENCH("Larger graph, epochs: " TOSTR(EPOCHS) ", repetitions: " TOSTR(REP), REPEAT(igraph_layout_umap(&graph, &layout, 0, &distances, 0.01, EPOCHS, 0) , REP);
     );
 
+#undef EPOCHS
+#undef VCOUNT
+#define EPOCHS 20
+#define VCOUNT 100000
+#define OUTDEG 15
+
+    /* Same size as a k-nearest neighbor graph */
+    igraph_destroy(&graph);
+    igraph_erdos_renyi_game_gnm(&graph, VCOUNT, VCOUNT * OUTDEG, IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_resize(&distances, igraph_ecount(&graph));
+    RNG_BEGIN();
+    for (igraph_integer_t i=0; i < igraph_ecount(&graph); i++) {
+        VECTOR(distances)[i] = RNG_UNIF(0.05, 0.15);
+    }
+    RNG_END();
+
+    {
+        igraph_vector_t weights;
+        igraph_vector_init(&weights, 0);
+        BENCH("Large graph, n: " TOSTR(VCOUNT) ", computing weights only",
+              igraph_layout_umap_compute_weights(&graph, &distances, &weights);
+        );
+        igraph_vector_destroy(&weights);
+    }
+    BENCH("Large graph, n: " TOSTR(VCOUNT) ", epochs: " TOSTR(EPOCHS), igraph_layout_umap(&graph, &layout, 0, &distances, 0.01, EPOCHS, 0);
+    );
+
 
     igraph_matrix_destroy(&layout);
     igraph_destroy(&graph);
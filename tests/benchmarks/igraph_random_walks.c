@@ -0,0 +1,60 @@
+#include <igraph.h>
+#include "bench.h"
+
+int main(void) {
+    igraph_t graph;
+    igraph_matrix_int_t walks;
+    igraph_vector_int_t vertices;
+    igraph_vector_t weights;
+    igraph_integer_t ec, i;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    igraph_matrix_int_init(&walks, 0, 0);
+    igraph_vector_int_init(&vertices, 0);
+    igraph_vector_init(&weights, 0);
+
+    igraph_de_bruijn(&graph, 8, 5); /* 32768 vertices, 262144 edges, average degree: 16 */
+    ec = igraph_ecount(&graph);
+
+    igraph_vector_resize(&weights, ec);
+    for (i = 0; i < ec; ++i) {
+        VECTOR(weights)[i] = igraph_rng_get_unif01(igraph_rng_default());
+    }
+
+    /* The same walks generated one at a time and all at once. Note that
+     * igraph_random_walk() has an O(|V|) setup cost for every walk. */
+
+    BENCH(" 1 Single walks, directed, unweighted, 4096 x 10 walks of length 80",
+          REPEAT(for (i = 0; i < 4096; i++) igraph_random_walk(&graph, NULL, &vertices, NULL, i, IGRAPH_OUT, 80, IGRAPH_RANDOM_WALK_STUCK_RETURN), 10)
+         );
+
+    BENCH(" 2 Batch walks,  directed, unweighted, 4096 x 10 walks of length 80",
+          igraph_random_walks(&graph, NULL, &walks, igraph_vss_range(0, 4096), 10, IGRAPH_OUT, 80, 1, 1, IGRAPH_RANDOM_WALK_STUCK_RETURN)
+         );
+
+    BENCH(" 3 Single walks, directed, weighted,   4096 x 10 walks of length 80",
+          REPEAT(for (i = 0; i < 4096; i++) igraph_random_walk(&graph, &weights, &vertices, NULL, i, IGRAPH_OUT, 80, IGRAPH_RANDOM_WALK_STUCK_RETURN), 10)
+         );
+
+    BENCH(" 4 Batch walks,  directed, weighted,   4096 x 10 walks of length 80",
+          igraph_random_walks(&graph, &weights, &walks, igraph_vss_range(0, 4096), 10, IGRAPH_OUT, 80, 1, 1, IGRAPH_RANDOM_WALK_STUCK_RETURN)
+         );
+
+    BENCH(" 5 Batch walks,  undirected, weighted, 32768 x 10 walks of length 80",
+          igraph_random_walks(&graph, &weights, &walks, igraph_vss_all(), 10, IGRAPH_ALL, 80, 1, 1, IGRAPH_RANDOM_WALK_STUCK_RETURN)
+         );
+
+    BENCH(" 6 Batch walks,  undirected, weighted, 32768 x 10 walks of length 80, p = 0.5, q = 2",
+          igraph_random_walks(&graph, &weights, &walks, igraph_vss_all(), 10, IGRAPH_ALL, 80, 0.5, 2, IGRAPH_RANDOM_WALK_STUCK_RETURN)
+         );
+
+    igraph_destroy(&graph);
+
+    igraph_vector_destroy(&weights);
+    igraph_vector_int_destroy(&vertices);
+    igraph_matrix_int_destroy(&walks);
+
+    return 0;
+}
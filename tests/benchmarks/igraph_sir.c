@@ -0,0 +1,56 @@
+#include <igraph.h>
+#include "bench.h"
+
+void run_sir(const igraph_t *graph, igraph_integer_t no_sim) {
+    igraph_vector_ptr_t result;
+    igraph_vector_ptr_init(&result, 0);
+    igraph_sir(graph, 0.5, 1, no_sim, &result);
+    for (igraph_integer_t i = 0; i < no_sim; i++) {
+        igraph_sir_destroy(VECTOR(result)[i]);
+    }
+    igraph_vector_ptr_destroy_all(&result);
+}
+
+int main(void) {
+    igraph_t graph;
+    igraph_vector_int_t final_size, peak;
+    igraph_vector_t peak_time;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+    BENCH_INIT();
+
+    igraph_vector_int_init(&final_size, 0);
+    igraph_vector_int_init(&peak, 0);
+    igraph_vector_init(&peak_time, 0);
+
+    /* Below the epidemic threshold most outbreaks are small, so the cost of
+     * resetting the state between simulations dominates. */
+    igraph_erdos_renyi_game_gnm(&graph, 100000, 150000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    BENCH(" 1 SIR, G(n,m), n=100000, m=150000, small outbreaks, 2000 simulations",
+          run_sir(&graph, 2000)
+         );
+    BENCH(" 2 SIR summary, G(n,m), n=100000, m=150000, small outbreaks, 2000 simulations",
+          igraph_sir_summary(&graph, 0.5, 1, 2000, &final_size, &peak, &peak_time)
+         );
+
+    igraph_destroy(&graph);
+
+    /* Large outbreaks */
+    igraph_erdos_renyi_game_gnm(&graph, 10000, 50000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    BENCH(" 3 SIR, G(n,m), n=10000, m=50000, large outbreaks, 100 simulations",
+          run_sir(&graph, 100)
+         );
+    BENCH(" 4 SIR summary, G(n,m), n=10000, m=50000, large outbreaks, 100 simulations",
+          igraph_sir_summary(&graph, 0.5, 1, 100, &final_size, &peak, &peak_time)
+         );
+
+    igraph_destroy(&graph);
+
+    igraph_vector_destroy(&peak_time);
+    igraph_vector_int_destroy(&peak);
+    igraph_vector_int_destroy(&final_size);
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+/* Compares the column-compressed and compressed sparse row forms of
+ * graph adjacency matrices. */
+
+void bench(igraph_integer_t n, igraph_integer_t m, int rep) {
+    igraph_t graph;
+    igraph_sparsemat_t A, Ac, At;
+    igraph_sparsemat_csr_t csr, csrt;
+    igraph_vector_t x, y;
+    igraph_matrix_t B, res;
+    char name[200];
+
+    igraph_erdos_renyi_game_gnm(&graph, n, m, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    igraph_vector_init(&x, n);
+    igraph_vector_init(&y, n);
+    igraph_matrix_init(&B, n, 8);
+    igraph_matrix_init(&res, 0, 0);
+    RNG_BEGIN();
+    for (igraph_integer_t i = 0; i < n; i++) {
+        VECTOR(x)[i] = RNG_UNIF(-1, 1);
+        for (igraph_integer_t j = 0; j < 8; j++) {
+            MATRIX(B, i, j) = RNG_UNIF(-1, 1);
+        }
+    }
+    RNG_END();
+
+    igraph_sparsemat_init(&A, 0, 0, 0);
+    igraph_sparsemat_csr_init(&csr, 0, 0);
+
+    sprintf(name, "Adjacency, triplet and compress, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(
+              igraph_get_adjacency_sparse(&graph, &A, IGRAPH_GET_ADJACENCY_BOTH, NULL, IGRAPH_LOOPS_ONCE);
+              igraph_sparsemat_compress(&A, &Ac);
+              igraph_sparsemat_destroy(&Ac),
+              rep)
+    );
+    sprintf(name, "Adjacency, CSR, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(igraph_get_adjacency_csr(&graph, &csr, IGRAPH_GET_ADJACENCY_BOTH, NULL, IGRAPH_LOOPS_ONCE), rep)
+    );
+
+    igraph_sparsemat_compress(&A, &Ac);
+
+    sprintf(name, "Transpose, column-compressed, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_transpose(&Ac, &At); igraph_sparsemat_destroy(&At), rep)
+    );
+    sprintf(name, "Transpose, CSR, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_csr_transpose(&csr, &csrt); igraph_sparsemat_csr_destroy(&csrt), rep)
+    );
+
+    sprintf(name, "Matrix-vector product, column-compressed, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, 10 * rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_gaxpy(&Ac, &x, &y), 10 * rep)
+    );
+    sprintf(name, "Matrix-vector product, CSR, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, 10 * rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_csr_gaxpy(&csr, &x, &y), 10 * rep)
+    );
+
+    sprintf(name, "Product with 8 dense columns, column-compressed, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_multiply_by_dense(&Ac, &B, &res), rep)
+    );
+    sprintf(name, "Product with 8 dense columns, CSR, n=%" IGRAPH_PRId " m=%" IGRAPH_PRId ", %dx", n, m, rep);
+    BENCH(name,
+          REPEAT(igraph_sparsemat_csr_multiply_by_dense(&csr, &B, &res), rep)
+    );
+
+    igraph_sparsemat_destroy(&Ac);
+    igraph_sparsemat_csr_destroy(&csr);
+    igraph_sparsemat_destroy(&A);
+    igraph_matrix_destroy(&res);
+    igraph_matrix_destroy(&B);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+    igraph_destroy(&graph);
+}
+
+int main(void) {
+    BENCH_INIT();
+
+    bench(10000, 50000, 100);
+    bench(1000000, 5000000, 1);
+
+    return 0;
+}
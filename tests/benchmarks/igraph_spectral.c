@@ -0,0 +1,109 @@
+#include <igraph.h>
+
+#include "bench.h"
+
+#include "misc/embedding.h"
+
+/* Functions that use ARPACK with a sparse graph matrix. */
+
+int main(void) {
+    igraph_t graph, ugraph;
+    igraph_vector_t res, weights, cvec;
+    igraph_matrix_t X, Y;
+    igraph_vector_int_t membership, block_sizes;
+    igraph_matrix_t pref;
+    igraph_eigen_which_t which;
+    igraph_arpack_options_t arpack_opts;
+    igraph_real_t value;
+
+    BENCH_INIT();
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_arpack_options_init(&arpack_opts);
+
+    igraph_vector_init(&res, 0);
+    igraph_matrix_init(&X, 0, 0);
+    igraph_matrix_init(&Y, 0, 0);
+    igraph_vector_int_init(&membership, 0);
+
+    /* Five blocks, so that the leading eigenvalues are well separated. */
+    igraph_matrix_init(&pref, 5, 5);
+    igraph_matrix_fill(&pref, 2.0 / 80000);
+    for (igraph_integer_t i = 0; i < 5; i++) {
+        MATRIX(pref, i, i) = 18.0 / 20000;
+    }
+    igraph_vector_int_init(&block_sizes, 5);
+    igraph_vector_int_fill(&block_sizes, 20000);
+    igraph_sbm_game(&graph, 100000, &pref, &block_sizes, IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref);
+    igraph_vector_init(&weights, igraph_ecount(&graph));
+    for (igraph_integer_t i = 0; i < igraph_ecount(&graph); i++) {
+        VECTOR(weights)[i] = igraph_rng_get_unif(igraph_rng_default(), 1, 2);
+    }
+    igraph_vector_init(&cvec, igraph_vcount(&graph));
+    igraph_copy(&ugraph, &graph);
+    igraph_to_undirected(&ugraph, IGRAPH_TO_UNDIRECTED_EACH, NULL);
+
+    BENCH(" 1 Eigenvector centrality, SBM n=100000 k=5, undirected, 10x",
+          REPEAT(igraph_eigenvector_centrality(&ugraph, &res, &value, IGRAPH_UNDIRECTED, true, NULL, &arpack_opts), 10)
+    );
+    BENCH(" 2 Eigenvector centrality, SBM n=100000 k=5, undirected, weighted, 10x",
+          REPEAT(igraph_eigenvector_centrality(&ugraph, &res, &value, IGRAPH_UNDIRECTED, true, &weights, &arpack_opts), 10)
+    );
+    BENCH(" 3 Eigenvector centrality, SBM n=100000 k=5, directed, 10x",
+          REPEAT(igraph_eigenvector_centrality(&graph, &res, &value, IGRAPH_DIRECTED, true, NULL, &arpack_opts), 10)
+    );
+    BENCH(" 4 Hub and authority scores, SBM n=100000 k=5, 10x",
+          REPEAT(igraph_hub_and_authority_scores(&graph, &res, NULL, &value, true, NULL, &arpack_opts), 10)
+    );
+    BENCH(" 5 Hub and authority scores, SBM n=100000 k=5, weighted, 10x",
+          REPEAT(igraph_hub_and_authority_scores(&graph, &res, NULL, &value, true, &weights, &arpack_opts), 10)
+    );
+    BENCH(" 6 Adjacency spectral embedding, SBM n=100000 k=5, undirected, d=5",
+          igraph_adjacency_spectral_embedding(&ugraph, 5, NULL, IGRAPH_EIGEN_LA, true, &X, NULL, NULL, &cvec, &arpack_opts)
+    );
+    BENCH(" 7 Adjacency spectral embedding, SBM n=100000 k=5, directed, d=5",
+          igraph_adjacency_spectral_embedding(&graph, 5, NULL, IGRAPH_EIGEN_LA, true, &X, &Y, NULL, &cvec, &arpack_opts)
+    );
+    BENCH(" 8 Laplacian spectral embedding, SBM n=100000 k=5, undirected, DAD, d=5",
+          igraph_laplacian_spectral_embedding(&ugraph, 5, NULL, IGRAPH_EIGEN_LA, IGRAPH_EMBEDDING_DAD, true, &X, NULL, NULL, &arpack_opts)
+    );
+
+    which.pos = IGRAPH_EIGEN_LA;
+    which.howmany = 5;
+    BENCH(" 9 Adjacency eigenvalues, SBM n=100000 k=5, undirected, 5 largest",
+          igraph_eigen_adjacency(&ugraph, IGRAPH_EIGEN_ARPACK, &which, &arpack_opts, NULL, &res, &X, NULL, NULL)
+    );
+
+    /* The same with the block eigensolver. */
+    arpack_opts.start = 0;
+    BENCH("10 Adjacency spectral embedding, SBM n=100000 k=5, undirected, d=5, block solver",
+          igraph_i_adjacency_spectral_embedding(&ugraph, 5, NULL, IGRAPH_EIGEN_LA, true, &X, NULL, NULL, &cvec, &arpack_opts, IGRAPH_I_EIGENSOLVER_LOBPCG)
+    );
+    BENCH("11 Laplacian spectral embedding, SBM n=100000 k=5, undirected, DAD, d=5, block solver",
+          igraph_i_laplacian_spectral_embedding(&ugraph, 5, NULL, IGRAPH_EIGEN_LA, IGRAPH_EMBEDDING_DAD, true, &X, NULL, NULL, &arpack_opts, IGRAPH_I_EIGENSOLVER_LOBPCG)
+    );
+    arpack_opts.start = 0;
+    BENCH("12 Adjacency eigenvalues, SBM n=100000 k=5, undirected, 5 largest, block solver",
+          igraph_i_eigen_adjacency_lobpcg(&ugraph, &which, &arpack_opts, &res, &X)
+    );
+    arpack_opts.start = 0;
+    igraph_destroy(&ugraph);
+    igraph_destroy(&graph);
+    igraph_vector_destroy(&cvec);
+    igraph_vector_destroy(&weights);
+
+    igraph_barabasi_game(&graph, 20000, 1, 5, NULL, true, 1, IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE, NULL);
+    BENCH("13 Leading eigenvector communities, Barabasi n=20000 m=5",
+          igraph_community_leading_eigenvector(&graph, NULL, NULL, &membership, 10, &arpack_opts, NULL, false, NULL, NULL, NULL, NULL, NULL)
+    );
+    igraph_destroy(&graph);
+
+    igraph_vector_int_destroy(&membership);
+    igraph_matrix_destroy(&Y);
+    igraph_matrix_destroy(&X);
+    igraph_vector_destroy(&res);
+
+    return 0;
+}
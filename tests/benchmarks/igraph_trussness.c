@@ -0,0 +1,56 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "bench.h"
+
+int main(void) {
+    igraph_t g;
+    igraph_vector_int_t trussness;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    BENCH_INIT();
+
+    igraph_vector_int_init(&trussness, 0);
+
+    /* About 1.7 * 10^8 triangles */
+    igraph_erdos_renyi_game_gnm(&g, 4000, 2000000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    BENCH(" 1 Trussness, GNM, n=4000, m=2000000",
+          igraph_trussness(&g, &trussness);
+         );
+    igraph_destroy(&g);
+
+    igraph_barabasi_game(&g, 100000, /*power=*/ 1, 20, /*outseq=*/ NULL,
+                         /*outpref=*/ false, /*A=*/ 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, /*start_from=*/ NULL);
+    BENCH(" 2 Trussness, Barabasi, n=100000, m=20",
+          igraph_trussness(&g, &trussness);
+         );
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game_gnm(&g, 100, 1000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    BENCH(" 3 Trussness, GNM, n=100, m=1000, 1000x",
+          REPEAT(igraph_trussness(&g, &trussness), 1000);
+         );
+    igraph_destroy(&g);
+
+    igraph_vector_int_destroy(&trussness);
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <igraph.h>
+#include <math.h>
+
+#include "bench.h"
+
+/* Compares the vectorized vector operations with the plain loops that they
+ * replaced. The same kernels are used by the matrix operations. */
+
+/* Results are stored here, so that the plain loops are not optimized away. */
+static volatile igraph_real_t sink;
+static volatile igraph_integer_t isink;
+
+static igraph_real_t plain_sum(const igraph_vector_t *v) {
+    igraph_real_t res = 0;
+    for (const igraph_real_t *p = v->stor_begin; p < v->end; p++) {
+        res += *p;
+    }
+    return res;
+}
+
+static igraph_real_t plain_prod(const igraph_vector_t *v) {
+    igraph_real_t res = 1;
+    for (const igraph_real_t *p = v->stor_begin; p < v->end; p++) {
+        res *= *p;
+    }
+    return res;
+}
+
+static igraph_real_t plain_sumsq(const igraph_vector_t *v) {
+    igraph_real_t res = 0;
+    for (const igraph_real_t *p = v->stor_begin; p < v->end; p++) {
+        res += *p * *p;
+    }
+    return res;
+}
+
+static igraph_real_t plain_max(const igraph_vector_t *v) {
+    igraph_real_t max = *v->stor_begin;
+    if (isnan(max)) {
+        return max;
+    }
+    for (const igraph_real_t *p = v->stor_begin + 1; p < v->end; p++) {
+        if (*p > max) {
+            max = *p;
+        } else if (isnan(*p)) {
+            return *p;
+        }
+    }
+    return max;
+}
+
+static igraph_integer_t plain_which_max(const igraph_vector_t *v) {
+    const igraph_real_t *max = v->stor_begin;
+    if (isnan(*max)) {
+        return 0;
+    }
+    for (const igraph_real_t *p = v->stor_begin + 1; p < v->end; p++) {
+        if (*p > *max) {
+            max = p;
+        } else if (isnan(*p)) {
+            return p - v->stor_begin;
+        }
+    }
+    return max - v->stor_begin;
+}
+
+static void plain_minmax(const igraph_vector_t *v, igraph_real_t *min, igraph_real_t *max) {
+    *min = *max = *v->stor_begin;
+    if (isnan(*min)) {
+        return;
+    }
+    for (const igraph_real_t *p = v->stor_begin + 1; p < v->end; p++) {
+        if (*p > *max) {
+            *max = *p;
+        } else if (*p < *min) {
+            *min = *p;
+        } else if (isnan(*p)) {
+            *min = *max = *p;
+            return;
+        }
+    }
+}
+
+static igraph_bool_t plain_isininterval(const igraph_vector_t *v, igraph_real_t low, igraph_real_t high) {
+    for (const igraph_real_t *p = v->stor_begin; p < v->end; p++) {
+        if (!(*p >= low && *p <= high)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static igraph_real_t plain_maxdifference(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    igraph_integer_t n = igraph_vector_size(v1);
+    igraph_real_t diff = 0;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        igraph_real_t d = fabs(VECTOR(*v1)[i] - VECTOR(*v2)[i]);
+        if (d > diff) {
+            diff = d;
+        } else if (isnan(d)) {
+            return d;
+        }
+    }
+    return diff;
+}
+
+static void plain_scale(igraph_vector_t *v, igraph_real_t by) {
+    igraph_integer_t n = igraph_vector_size(v);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        VECTOR(*v)[i] *= by;
+    }
+}
+
+static void plain_add_constant(igraph_vector_t *v, igraph_real_t plus) {
+    igraph_integer_t n = igraph_vector_size(v);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        VECTOR(*v)[i] += plus;
+    }
+}
+
+#define PLAIN_ELEMENTWISE(NAME, OP) \
+    static void plain_ ## NAME(igraph_vector_t *v1, const igraph_vector_t *v2) { \
+        igraph_integer_t n = igraph_vector_size(v1); \
+        for (igraph_integer_t i = 0; i < n; i++) { \
+            VECTOR(*v1)[i] OP VECTOR(*v2)[i]; \
+        } \
+    }
+
+PLAIN_ELEMENTWISE(add, +=)
+PLAIN_ELEMENTWISE(sub, -=)
+PLAIN_ELEMENTWISE(mul, *=)
+PLAIN_ELEMENTWISE(div, /=)
+
+static igraph_integer_t plain_int_sum(const igraph_vector_int_t *v) {
+    igraph_integer_t res = 0;
+    for (const igraph_integer_t *p = v->stor_begin; p < v->end; p++) {
+        res += *p;
+    }
+    return res;
+}
+
+static igraph_integer_t plain_int_max(const igraph_vector_int_t *v) {
+    igraph_integer_t max = *v->stor_begin;
+    for (const igraph_integer_t *p = v->stor_begin + 1; p < v->end; p++) {
+        if (*p > max) {
+            max = *p;
+        }
+    }
+    return max;
+}
+
+static void plain_int_cumsum(igraph_vector_int_t *to, const igraph_vector_int_t *from) {
+    igraph_integer_t res = 0, n = igraph_vector_int_size(from);
+    igraph_vector_int_resize(to, n);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        res += VECTOR(*from)[i];
+        VECTOR(*to)[i] = res;
+    }
+}
+
+static void plain_int_add(igraph_vector_int_t *v1, const igraph_vector_int_t *v2) {
+    igraph_integer_t n = igraph_vector_int_size(v1);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        VECTOR(*v1)[i] += VECTOR(*v2)[i];
+    }
+}
+
+#define COMPARE(TITLE, PLAIN, VECTORIZED) \
+    do { \
+        sprintf(name, "%-16s n=%8" IGRAPH_PRId ", %6dx, plain loop", TITLE, n, rep); \
+        BENCH(name, REPEAT(PLAIN, rep)); \
+        sprintf(name, "%-16s n=%8" IGRAPH_PRId ", %6dx, vectorized", TITLE, n, rep); \
+        BENCH(name, REPEAT(VECTORIZED, rep)); \
+    } while (0)
+
+void bench(igraph_integer_t n, int rep) {
+    igraph_vector_t x, y;
+    igraph_vector_int_t ix, iy, iz;
+    igraph_real_t min, max;
+    char name[200];
+
+    igraph_vector_init(&x, n);
+    igraph_vector_init(&y, n);
+    igraph_vector_int_init(&ix, n);
+    igraph_vector_int_init(&iy, n);
+    igraph_vector_int_init(&iz, n);
+    RNG_BEGIN();
+    for (igraph_integer_t i = 0; i < n; i++) {
+        /* Products stay close to one. */
+        VECTOR(x)[i] = RNG_UNIF(0.99999, 1.00001);
+        VECTOR(y)[i] = RNG_UNIF(0.99999, 1.00001);
+        VECTOR(ix)[i] = RNG_INTEGER(-1000, 1000);
+        VECTOR(iy)[i] = RNG_INTEGER(-1000, 1000);
+    }
+    RNG_END();
+
+    COMPARE("sum", sink = plain_sum(&x), sink = igraph_vector_sum(&x));
+    COMPARE("prod", sink = plain_prod(&x), sink = igraph_vector_prod(&x));
+    COMPARE("sumsq", sink = plain_sumsq(&x), sink = igraph_vector_sumsq(&x));
+    COMPARE("max", sink = plain_max(&x), sink = igraph_vector_max(&x));
+    COMPARE("which_max", isink = plain_which_max(&x), isink = igraph_vector_which_max(&x));
+    COMPARE("minmax", (plain_minmax(&x, &min, &max), sink = min + max),
+            (igraph_vector_minmax(&x, &min, &max), sink = min + max));
+    COMPARE("isininterval", isink = plain_isininterval(&x, 0, 2), isink = igraph_vector_isininterval(&x, 0, 2));
+    COMPARE("maxdifference", sink = plain_maxdifference(&x, &y), sink = igraph_vector_maxdifference(&x, &y));
+    COMPARE("scale", plain_scale(&x, 0.999999), igraph_vector_scale(&x, 0.999999));
+    COMPARE("add_constant", plain_add_constant(&x, 1e-9), igraph_vector_add_constant(&x, 1e-9));
+    /* add and sub, and mul and div, cancel each other. */
+    COMPARE("add", plain_add(&x, &y), igraph_vector_add(&x, &y));
+    COMPARE("sub", plain_sub(&x, &y), igraph_vector_sub(&x, &y));
+    COMPARE("mul", plain_mul(&x, &y), igraph_vector_mul(&x, &y));
+    COMPARE("div", plain_div(&x, &y), igraph_vector_div(&x, &y));
+
+    COMPARE("int sum", isink = plain_int_sum(&ix), isink = igraph_vector_int_sum(&ix));
+    COMPARE("int max", isink = plain_int_max(&ix), isink = igraph_vector_int_max(&ix));
+    COMPARE("int cumsum", plain_int_cumsum(&iz, &ix), igraph_vector_int_cumsum(&iz, &ix));
+    COMPARE("int add", plain_int_add(&iz, &iy), igraph_vector_int_add(&iz, &iy));
+
+    igraph_vector_int_destroy(&iz);
+    igraph_vector_int_destroy(&iy);
+    igraph_vector_int_destroy(&ix);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+}
+
+int main(void) {
+    BENCH_INIT();
+
+    bench(1000, 100000);
+    bench(1000000, 100);
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+#include "layout/barnes_hut.h"
+
+#include "test_utilities.h"
+
+/* Computes the forces of the kernel on all vertices, exactly. */
+void exact_forces(const igraph_matrix_t *pos, const igraph_i_bh_kernel_t *kernel,
+                  igraph_matrix_t *forces) {
+    igraph_integer_t n = igraph_matrix_nrow(pos), dim = igraph_matrix_ncol(pos);
+
+    igraph_matrix_resize(forces, n, dim);
+    igraph_matrix_null(forces);
+    for (igraph_integer_t v = 0; v < n; v++) {
+        for (igraph_integer_t u = 0; u < n; u++) {
+            igraph_real_t d[3], r2 = 0, g;
+            for (igraph_integer_t k = 0; k < dim; k++) {
+                d[k] = MATRIX(*pos, v, k) - MATRIX(*pos, u, k);
+                r2 += d[k] * d[k];
+            }
+            if (r2 == 0 || (kernel->cutoff > 0 && r2 >= kernel->cutoff * kernel->cutoff)) {
+                continue;
+            }
+            g = kernel->power == 1 ? kernel->scale / r2 : kernel->scale / (r2 * sqrt(r2));
+            g -= kernel->linear * sqrt(r2);
+            for (igraph_integer_t k = 0; k < dim; k++) {
+                MATRIX(*forces, v, k) += d[k] * g;
+            }
+        }
+    }
+}
+
+/* The error of the approximate forces, relative to the norm of the exact ones. */
+igraph_real_t relative_error(const igraph_i_bh_tree_t *tree, const igraph_matrix_t *pos,
+                             const igraph_i_bh_kernel_t *kernel, igraph_real_t theta) {
+    igraph_integer_t n = igraph_matrix_nrow(pos), dim = igraph_matrix_ncol(pos);
+    igraph_matrix_t exact;
+    igraph_vector_t forces[3];
+    igraph_vector_t *force_ptrs[3] = { &forces[0], &forces[1], &forces[2] };
+    igraph_real_t err = 0, norm = 0;
+
+    igraph_matrix_init(&exact, 0, 0);
+    exact_forces(pos, kernel, &exact);
+    for (igraph_integer_t k = 0; k < dim; k++) {
+        igraph_vector_init(&forces[k], n);
+    }
+    igraph_i_bh_tree_forces(tree, kernel, theta, force_ptrs);
+    for (igraph_integer_t v = 0; v < n; v++) {
+        for (igraph_integer_t k = 0; k < dim; k++) {
+            igraph_real_t diff = VECTOR(forces[k])[v] - MATRIX(exact, v, k);
+            err += diff * diff;
+            norm += MATRIX(exact, v, k) * MATRIX(exact, v, k);
+        }
+    }
+    for (igraph_integer_t k = 0; k < dim; k++) {
+        igraph_vector_destroy(&forces[k]);
+    }
+    igraph_matrix_destroy(&exact);
+
+    return sqrt(err / norm);
+}
+
+/* Random positions, half of them in a few small clusters. */
+void random_positions(igraph_matrix_t *pos, igraph_integer_t n, igraph_integer_t dim) {
+    igraph_matrix_resize(pos, n, dim);
+    for (igraph_integer_t v = 0; v < n; v++) {
+        for (igraph_integer_t k = 0; k < dim; k++) {
+            if (v % 2 == 0) {
+                MATRIX(*pos, v, k) = RNG_UNIF(-100, 100);
+            } else {
+                MATRIX(*pos, v, k) = (v % 10) * 10 + RNG_NORMAL(0, 1);
+            }
+        }
+    }
+}
+
+void check_tree(igraph_integer_t n, igraph_integer_t dim, const igraph_i_bh_kernel_t *kernel) {
+    igraph_matrix_t pos;
+    igraph_i_bh_tree_t tree;
+    igraph_real_t err;
+
+    igraph_matrix_init(&pos, 0, 0);
+    random_positions(&pos, n, dim);
+    igraph_i_bh_tree_init(&tree, n, dim);
+    igraph_i_bh_tree_build(&tree, &pos);
+
+    /* Without approximation, the result is exact up to rounding errors. */
+    err = relative_error(&tree, &pos, kernel, 0);
+    IGRAPH_ASSERT(err < 1e-10);
+
+    err = relative_error(&tree, &pos, kernel, IGRAPH_I_BH_THETA);
+    IGRAPH_ASSERT(err < 0.05);
+
+    /* Moved vertices are taken into account without rebuilding the tree. */
+    for (igraph_integer_t v = 0; v < n; v += 7) {
+        igraph_real_t delta[3];
+        for (igraph_integer_t k = 0; k < dim; k++) {
+            delta[k] = RNG_UNIF(-50, 50);
+            MATRIX(pos, v, k) += delta[k];
+        }
+        igraph_i_bh_tree_move(&tree, v, delta);
+    }
+    err = relative_error(&tree, &pos, kernel, 0);
+    IGRAPH_ASSERT(err < 1e-10);
+    err = relative_error(&tree, &pos, kernel, IGRAPH_I_BH_THETA);
+    IGRAPH_ASSERT(err < 0.05);
+
+    igraph_i_bh_tree_destroy(&tree);
+    igraph_matrix_destroy(&pos);
+}
+
+int main(void) {
+    igraph_i_bh_kernel_t fr = { 1, 1, 0, 0 };
+    igraph_i_bh_kernel_t fr_disconnected = { 1, 1, 1e-4, 0 };
+    igraph_i_bh_kernel_t coulomb = { 1, 2, 0, 50 };
+    igraph_i_bh_tree_t tree;
+    igraph_matrix_t pos;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    printf("2D trees\n");
+    check_tree(2000, 2, &fr);
+    check_tree(2000, 2, &fr_disconnected);
+    check_tree(2000, 2, &coulomb);
+
+    printf("3D trees\n");
+    check_tree(2000, 3, &fr);
+    check_tree(2000, 3, &coulomb);
+
+    printf("Coincident vertices\n");
+    igraph_matrix_init(&pos, 100, 2);
+    igraph_matrix_fill(&pos, 1.0);
+    igraph_i_bh_tree_init(&tree, 100, 2);
+    igraph_i_bh_tree_build(&tree, &pos);
+    for (igraph_integer_t v = 0; v < 100; v++) {
+        igraph_real_t force[2];
+        igraph_i_bh_tree_force(&tree, v, &fr, IGRAPH_I_BH_THETA, force);
+        IGRAPH_ASSERT(force[0] == 0 && force[1] == 0);
+    }
+    igraph_i_bh_tree_destroy(&tree);
+    igraph_matrix_destroy(&pos);
+
+    printf("Empty tree\n");
+    igraph_matrix_init(&pos, 0, 2);
+    igraph_i_bh_tree_init(&tree, 0, 2);
+    igraph_i_bh_tree_build(&tree, &pos);
+    igraph_i_bh_tree_destroy(&tree);
+    igraph_matrix_destroy(&pos);
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
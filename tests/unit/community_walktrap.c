@@ -197,6 +197,40 @@ int main(void) {
 
   igraph_destroy(&graph);
 
+  printf("\nBounded memory\n\n");
+
+  {
+    igraph_matrix_int_t merges2;
+    igraph_vector_t modularity2;
+    const igraph_integer_t max_memory[] = { -1, 0, 1000, 20000, 1000000000 };
+
+    igraph_rng_seed(igraph_rng_default(), 1);
+    igraph_erdos_renyi_game_gnm(&graph, 100, 400, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+
+    igraph_matrix_int_init(&merges, 0, 0);
+    igraph_vector_init(&modularity, 0);
+    igraph_matrix_int_init(&merges2, 0, 0);
+    igraph_vector_init(&modularity2, 0);
+
+    igraph_community_walktrap(&graph, NULL, 4, &merges, &modularity, NULL);
+
+    /* Evicted probability vectors are recomputed, so the bound does not
+     * change the result; single precision storage could only make a
+     * difference for nearly tied merges, which this graph does not have. */
+    for (size_t i = 0; i < sizeof(max_memory) / sizeof(max_memory[0]); i++) {
+      igraph_community_walktrap_bounded(&graph, NULL, 4, max_memory[i], &merges2, &modularity2, NULL);
+      IGRAPH_ASSERT(igraph_matrix_int_all_e(&merges, &merges2));
+      IGRAPH_ASSERT(igraph_vector_all_almost_e(&modularity, &modularity2, 1e-12));
+    }
+    printf("OK\n");
+
+    igraph_vector_destroy(&modularity2);
+    igraph_matrix_int_destroy(&merges2);
+    igraph_vector_destroy(&modularity);
+    igraph_matrix_int_destroy(&merges);
+
+    igraph_destroy(&graph);
+  }
 
   VERIFY_FINALLY_STACK();
 
@@ -61,6 +61,56 @@ int main(void) {
         }
     }
 
+    /* Large enough to be generated in several chunks. */
+    for (int directed = 0; directed < 2; directed++) {
+        for (int loops = 0; loops < 2; loops++) {
+            igraph_t g, g2;
+            igraph_integer_t n = 2000, no_of_loops = 0, above = 0;
+            igraph_real_t p = 0.1, slots, m;
+            igraph_bool_t simple, same;
+            igraph_vector_bool_t is_loop;
+
+            if (directed) {
+                slots = loops ? n * n : n * (n - 1);
+            } else {
+                slots = loops ? n * (n + 1) / 2 : n * (n - 1) / 2;
+            }
+
+            igraph_rng_seed(igraph_rng_default(), 42);
+            igraph_erdos_renyi_game_gnp(&g, n, p, directed, loops);
+            igraph_rng_seed(igraph_rng_default(), 42);
+            igraph_erdos_renyi_game_gnp(&g2, n, p, directed, loops);
+            igraph_is_same_graph(&g, &g2, &same);
+            IGRAPH_ASSERT(same);
+
+            /* Within 5 standard deviations of the expected number of edges. */
+            m = igraph_ecount(&g);
+            IGRAPH_ASSERT(fabs(m - slots * p) < 5 * sqrt(slots * p * (1 - p)));
+
+            igraph_vector_bool_init(&is_loop, 0);
+            igraph_is_loop(&g, &is_loop, igraph_ess_all(IGRAPH_EDGEORDER_ID));
+            for (igraph_integer_t e = 0; e < igraph_ecount(&g); e++) {
+                no_of_loops += VECTOR(is_loop)[e];
+                above += IGRAPH_FROM(&g, e) > IGRAPH_TO(&g, e);
+            }
+            if (loops) {
+                IGRAPH_ASSERT(fabs(no_of_loops - n * p) < 5 * sqrt(n * p * (1 - p)));
+            } else {
+                IGRAPH_ASSERT(no_of_loops == 0);
+                igraph_is_simple(&g, &simple);
+                IGRAPH_ASSERT(simple);
+            }
+            if (directed) {
+                /* Edges are equally likely in both directions. */
+                IGRAPH_ASSERT(fabs(above - (m - no_of_loops) / 2) < 5 * sqrt(m) / 2);
+            }
+
+            igraph_vector_bool_destroy(&is_loop);
+            igraph_destroy(&g2);
+            igraph_destroy(&g);
+        }
+    }
+
     VERIFY_FINALLY_STACK();
 
     return 0;
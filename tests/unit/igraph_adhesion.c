@@ -20,6 +20,26 @@
 
 #include "test_utilities.h"
 
+/* Computes the edge connectivity of a directed graph as the minimum of
+ * all s-t edge connectivities from and to vertex 0. */
+igraph_integer_t reference_adhesion(const igraph_t *graph) {
+    igraph_integer_t n = igraph_vcount(graph);
+    igraph_integer_t res = IGRAPH_INTEGER_MAX, value;
+
+    for (igraph_integer_t i = 1; i < n; i++) {
+        igraph_st_edge_connectivity(graph, &value, 0, i);
+        if (value < res) {
+            res = value;
+        }
+        igraph_st_edge_connectivity(graph, &value, i, 0);
+        if (value < res) {
+            res = value;
+        }
+    }
+
+    return res;
+}
+
 int main(void) {
 
     igraph_t g;
@@ -44,6 +64,38 @@ int main(void) {
 
     igraph_destroy(&g);
 
+    /* Graphs large enough for the parallel code path, if available */
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    for (igraph_integer_t k = 2; k <= 6; k += 2) {
+        igraph_t directed;
+        igraph_integer_t directed_value;
+
+        igraph_k_regular_game(&g, 40, k, IGRAPH_DIRECTED, false);
+        igraph_adhesion(&g, &value, false);
+        IGRAPH_ASSERT(value == reference_adhesion(&g));
+        igraph_destroy(&g);
+
+        /* Undirected graphs use a different algorithm; compare it to
+         * the flow-based calculation on the equivalent directed graph. */
+        igraph_k_regular_game(&g, 40, k + 1, IGRAPH_UNDIRECTED, false);
+        igraph_copy(&directed, &g);
+        igraph_to_directed(&directed, IGRAPH_TO_DIRECTED_MUTUAL);
+        igraph_adhesion(&g, &value, false);
+        igraph_adhesion(&directed, &directed_value, false);
+        IGRAPH_ASSERT(value == directed_value);
+        igraph_destroy(&directed);
+        igraph_destroy(&g);
+    }
+
+    /* Not strongly connected */
+    igraph_ring(&g, 40, IGRAPH_DIRECTED, false, true);
+    igraph_add_vertices(&g, 1, NULL);
+    igraph_add_edge(&g, 40, 0);
+    igraph_adhesion(&g, &value, false);
+    IGRAPH_ASSERT(value == 0);
+    igraph_destroy(&g);
+
     VERIFY_FINALLY_STACK();
     return 0;
 }
@@ -67,6 +67,30 @@ int main(void) {
 
     igraph_destroy(&g);
 
+    /* Counting for all vertices at once must agree with counting for a
+     * vertex set, and with listing the triangles. */
+    {
+        igraph_vector_t res2;
+        igraph_vector_int_t list;
+
+        igraph_rng_seed(igraph_rng_default(), 42);
+        igraph_erdos_renyi_game_gnm(&g, 1000, 20000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+        igraph_vs_range(&vertices, 0, igraph_vcount(&g));
+
+        igraph_vector_init(&res2, 0);
+        igraph_vector_int_init(&list, 0);
+        igraph_adjacent_triangles(&g, &res, igraph_vss_all());
+        igraph_adjacent_triangles(&g, &res2, vertices);
+        IGRAPH_ASSERT(igraph_vector_all_e(&res, &res2));
+        igraph_list_triangles(&g, &list);
+        IGRAPH_ASSERT(igraph_vector_sum(&res) == igraph_vector_int_size(&list));
+
+        igraph_vector_int_destroy(&list);
+        igraph_vector_destroy(&res2);
+        igraph_vs_destroy(&vertices);
+        igraph_destroy(&g);
+    }
+
     igraph_vector_destroy(&res);
 
     VERIFY_FINALLY_STACK();
@@ -60,6 +60,10 @@ int main(void) {
     igraph_blas_dgemm(0, 0, 1, &a, &d, 0, &c);
     igraph_matrix_print(&c);
 
+    printf("add twice the same product to the previous result\n");
+    igraph_blas_dgemm(0, 0, 2, &a, &d, 1, &c);
+    igraph_matrix_print(&c);
+
     printf("matrix multiplication, A={{5,8},{6,9},{7,10}} B={{1,2},{3,4}}\n");
     igraph_blas_dgemm(1, 0, 1, &d, &a, 0, &c);
     igraph_matrix_print(&c);
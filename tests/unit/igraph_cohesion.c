@@ -20,6 +20,27 @@
 
 #include "test_utilities.h"
 
+/* The vertex connectivity of an undirected graph must not change when each
+ * edge is replaced by a pair of mutual directed edges. The undirected
+ * calculation only considers each vertex pair once, the directed one
+ * considers both orders. */
+void check_mutual(const igraph_t *graph) {
+    igraph_t directed;
+    igraph_integer_t value, directed_value;
+
+    igraph_copy(&directed, graph);
+    igraph_to_directed(&directed, IGRAPH_TO_DIRECTED_MUTUAL);
+
+    igraph_cohesion(graph, &value, false);
+    igraph_cohesion(&directed, &directed_value, false);
+    IGRAPH_ASSERT(value == directed_value);
+
+    igraph_cohesion(graph, &directed_value, true);
+    IGRAPH_ASSERT(value == directed_value);
+
+    igraph_destroy(&directed);
+}
+
 int main(void) {
 
     igraph_t g;
@@ -44,6 +65,49 @@ int main(void) {
 
     igraph_destroy(&g);
 
+    /* Graphs large enough for the parallel code path, if available */
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_k_regular_game(&g, 40, 5, IGRAPH_UNDIRECTED, false);
+    check_mutual(&g);
+    igraph_destroy(&g);
+
+    igraph_k_regular_game(&g, 40, 4, IGRAPH_DIRECTED, false);
+    {
+        igraph_integer_t checked_value;
+        igraph_cohesion(&g, &value, false);
+        igraph_cohesion(&g, &checked_value, true);
+        IGRAPH_ASSERT(value == checked_value);
+        IGRAPH_ASSERT(value <= 4);
+    }
+    igraph_destroy(&g);
+
+    igraph_full(&g, 36, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_cohesion(&g, &value, false);
+    IGRAPH_ASSERT(value == 35);
+    igraph_destroy(&g);
+
+    /* Two cliques sharing two vertices */
+    igraph_full(&g, 20, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_add_vertices(&g, 18, NULL);
+    for (igraph_integer_t i = 18; i < 38; i++) {
+        for (igraph_integer_t j = i + 1; j < 38; j++) {
+            igraph_add_edge(&g, i, j);
+        }
+    }
+    check_mutual(&g);
+    igraph_cohesion(&g, &value, false);
+    IGRAPH_ASSERT(value == 2);
+    igraph_destroy(&g);
+
+    /* Disconnected */
+    igraph_ring(&g, 40, IGRAPH_UNDIRECTED, false, false);
+    igraph_delete_edges(&g, igraph_ess_1(0));
+    igraph_delete_edges(&g, igraph_ess_1(20));
+    igraph_cohesion(&g, &value, false);
+    IGRAPH_ASSERT(value == 0);
+    igraph_destroy(&g);
+
     VERIFY_FINALLY_STACK();
     return 0;
 }
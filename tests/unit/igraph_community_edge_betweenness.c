@@ -22,6 +22,7 @@
 */
 
 #include <igraph.h>
+#include <math.h>
 #include "test_utilities.h"
 
 int igraph_vector_between(const igraph_vector_t* v, const igraph_vector_t* lo,
@@ -187,10 +188,180 @@ void test_zero_edge_graph(void) {
     igraph_destroy(&g);
 }
 
+/* Removes the edges one by one, recomputing all edge betweenness scores
+ * from scratch after each removal. Ties are broken the same way as in
+ * igraph_community_edge_betweenness(): scores equal up to rounding errors
+ * go to the smallest edge ID. */
+void full_recomputation(const igraph_t *graph, igraph_bool_t directed,
+                        const igraph_vector_t *weights,
+                        igraph_vector_int_t *removed, igraph_vector_t *removed_eb) {
+    igraph_t g;
+    igraph_vector_int_t ids;
+    igraph_vector_t w, eb;
+
+    igraph_copy(&g, graph);
+    igraph_vector_int_init_range(&ids, 0, igraph_ecount(graph));
+    if (weights) {
+        igraph_vector_init_copy(&w, weights);
+    } else {
+        igraph_vector_init(&w, 0);
+    }
+    igraph_vector_init(&eb, 0);
+    igraph_vector_int_clear(removed);
+    igraph_vector_clear(removed_eb);
+
+    while (igraph_ecount(&g) > 0) {
+        igraph_integer_t maxedge = 0;
+        igraph_real_t max, threshold;
+
+        igraph_edge_betweenness(&g, &eb, directed, weights ? &w : NULL);
+        max = igraph_vector_max(&eb);
+        threshold = max - (fabs(max) + 1) * 1e-10;
+        while (VECTOR(eb)[maxedge] < threshold) {
+            maxedge++;
+        }
+
+        igraph_vector_int_push_back(removed, VECTOR(ids)[maxedge]);
+        igraph_vector_push_back(removed_eb, VECTOR(eb)[maxedge]);
+        igraph_delete_edges(&g, igraph_ess_1(maxedge));
+        igraph_vector_int_remove(&ids, maxedge);
+        if (weights) {
+            igraph_vector_remove(&w, maxedge);
+        }
+    }
+
+    igraph_vector_destroy(&eb);
+    igraph_vector_destroy(&w);
+    igraph_vector_int_destroy(&ids);
+    igraph_destroy(&g);
+}
+
+/* Compares the edges removed by igraph_community_edge_betweenness(), which
+ * only updates the scores of the sources affected by a removal, their
+ * scores, the merges and the modularity with those obtained by full
+ * recomputation. */
+void check_incremental(const igraph_t *graph, igraph_bool_t directed,
+                       const igraph_vector_t *weights) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_bool_t use_directed = directed && igraph_is_directed(graph);
+    igraph_vector_int_t removed, result, bridges, bridges2, membership, membership2, steps_membership;
+    igraph_vector_t removed_eb, eb, modularity, modularity2;
+    igraph_matrix_int_t merges, merges2;
+
+    igraph_vector_int_init(&removed, 0);
+    igraph_vector_init(&removed_eb, 0);
+    full_recomputation(graph, directed, weights, &removed, &removed_eb);
+
+    igraph_vector_int_init(&result, 0);
+    igraph_vector_init(&eb, 0);
+    igraph_matrix_int_init(&merges, 0, 0);
+    igraph_vector_int_init(&bridges, 0);
+    igraph_vector_init(&modularity, 0);
+    igraph_vector_int_init(&membership, 0);
+    igraph_community_edge_betweenness(graph, &result, &eb, &merges, &bridges,
+                                      &modularity, &membership, directed, weights);
+
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&result, &removed));
+    IGRAPH_ASSERT(igraph_vector_size(&eb) == igraph_vector_size(&removed_eb));
+    for (igraph_integer_t i = 0; i < igraph_vector_size(&eb); i++) {
+        IGRAPH_ASSERT(fabs(VECTOR(eb)[i] - VECTOR(removed_eb)[i]) <=
+                      1e-8 * (fabs(VECTOR(removed_eb)[i]) + 1));
+    }
+
+    /* Merges and modularity obtained from the fully recomputed order */
+    igraph_matrix_int_init(&merges2, 0, 0);
+    igraph_vector_int_init(&bridges2, 0);
+    igraph_vector_init(&modularity2, 0);
+    igraph_vector_int_init(&membership2, 0);
+    igraph_community_eb_get_merges(graph, directed, &removed, weights,
+                                   &merges2, &bridges2, &modularity2, &membership2);
+
+    IGRAPH_ASSERT(igraph_matrix_int_all_e(&merges, &merges2));
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&bridges, &bridges2));
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&membership, &membership2));
+    IGRAPH_ASSERT(igraph_vector_all_e(&modularity, &modularity2));
+
+    /* Modularity after each merge, computed directly */
+    IGRAPH_ASSERT(igraph_vector_size(&modularity) == igraph_matrix_int_nrow(&merges) + 1);
+    igraph_vector_int_init(&steps_membership, 0);
+    for (igraph_integer_t steps = 0; steps <= igraph_matrix_int_nrow(&merges); steps++) {
+        igraph_real_t q;
+        igraph_community_to_membership(&merges, no_of_nodes, steps, &steps_membership, NULL);
+        igraph_modularity(graph, &steps_membership, weights, 1, use_directed, &q);
+        IGRAPH_ASSERT(fabs(VECTOR(modularity)[steps] - q) < 1e-12);
+    }
+    igraph_vector_int_destroy(&steps_membership);
+
+    igraph_vector_int_destroy(&membership2);
+    igraph_vector_destroy(&modularity2);
+    igraph_vector_int_destroy(&bridges2);
+    igraph_matrix_int_destroy(&merges2);
+    igraph_vector_int_destroy(&membership);
+    igraph_vector_destroy(&modularity);
+    igraph_vector_int_destroy(&bridges);
+    igraph_matrix_int_destroy(&merges);
+    igraph_vector_destroy(&eb);
+    igraph_vector_int_destroy(&result);
+    igraph_vector_destroy(&removed_eb);
+    igraph_vector_int_destroy(&removed);
+}
+
+void test_incremental(void) {
+    igraph_t g, g1, g2;
+    igraph_vector_t weights;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Warnings about the selection of the membership vector, and about
+     * weighted modularity, are expected. */
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    for (int directed = 0; directed <= 1; directed++) {
+        /* Connected graph */
+        igraph_erdos_renyi_game_gnm(&g1, 40, 100, directed, false);
+        /* Disconnected graph: two random graphs and isolated vertices */
+        igraph_erdos_renyi_game_gnm(&g2, 30, 50, directed, false);
+        igraph_disjoint_union(&g, &g1, &g2);
+        igraph_add_vertices(&g, 3, NULL);
+
+        igraph_vector_init(&weights, igraph_ecount(&g1));
+        RNG_BEGIN();
+        for (igraph_integer_t i = 0; i < igraph_ecount(&g1); i++) {
+            VECTOR(weights)[i] = RNG_UNIF(1, 10);
+        }
+        RNG_END();
+        check_incremental(&g1, directed, NULL);
+        check_incremental(&g1, directed, &weights);
+
+        igraph_vector_resize(&weights, igraph_ecount(&g));
+        RNG_BEGIN();
+        for (igraph_integer_t i = 0; i < igraph_ecount(&g); i++) {
+            VECTOR(weights)[i] = RNG_UNIF(1, 10);
+        }
+        RNG_END();
+        check_incremental(&g, directed, NULL);
+        check_incremental(&g, directed, &weights);
+
+        /* Directed graph, with edge directions ignored */
+        if (directed) {
+            check_incremental(&g, false, NULL);
+            check_incremental(&g, false, &weights);
+        }
+
+        igraph_vector_destroy(&weights);
+        igraph_destroy(&g);
+        igraph_destroy(&g2);
+        igraph_destroy(&g1);
+    }
+
+    igraph_set_warning_handler(igraph_warning_handler_print);
+}
+
 int main(void) {
     test_unweighted();
     test_weighted();
     test_zero_edge_graph();
+    test_incremental();
     VERIFY_FINALLY_STACK();
     return 0;
 }
@@ -0,0 +1,217 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Straightforward peeling, used as a reference for large graphs where
+ * igraph_coreness() may use its parallel implementation. */
+void reference_coreness(const igraph_t *graph, igraph_neimode_t mode, igraph_vector_int_t *cores) {
+    igraph_integer_t n = igraph_vcount(graph);
+    igraph_neimode_t omode = mode == IGRAPH_IN ? IGRAPH_OUT : (mode == IGRAPH_OUT ? IGRAPH_IN : IGRAPH_ALL);
+    igraph_vector_int_t deg, queue;
+    igraph_vector_bool_t done;
+    igraph_adjlist_t al;
+    igraph_integer_t remaining = n;
+
+    igraph_vector_int_init(&deg, 0);
+    igraph_degree(graph, &deg, igraph_vss_all(), mode, IGRAPH_LOOPS);
+    igraph_vector_int_init(&queue, 0);
+    igraph_vector_bool_init(&done, n);
+    igraph_adjlist_init(graph, &al, omode, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE);
+    igraph_vector_int_resize(cores, n);
+
+    for (igraph_integer_t k = 0; remaining > 0; k++) {
+        for (igraph_integer_t v = 0; v < n; v++) {
+            if (!VECTOR(done)[v] && VECTOR(deg)[v] <= k) {
+                VECTOR(done)[v] = true;
+                igraph_vector_int_push_back(&queue, v);
+            }
+        }
+        while (!igraph_vector_int_empty(&queue)) {
+            igraph_integer_t v = igraph_vector_int_pop_back(&queue);
+            igraph_vector_int_t *neis = igraph_adjlist_get(&al, v);
+            VECTOR(*cores)[v] = k;
+            remaining--;
+            for (igraph_integer_t j = 0; j < igraph_vector_int_size(neis); j++) {
+                igraph_integer_t u = VECTOR(*neis)[j];
+                if (!VECTOR(done)[u] && --VECTOR(deg)[u] <= k) {
+                    VECTOR(done)[u] = true;
+                    igraph_vector_int_push_back(&queue, u);
+                }
+            }
+        }
+    }
+
+    igraph_adjlist_destroy(&al);
+    igraph_vector_bool_destroy(&done);
+    igraph_vector_int_destroy(&queue);
+    igraph_vector_int_destroy(&deg);
+}
+
+void check_against_igraph_coreness(const igraph_t *graph, const igraph_coreness_incremental_t *ic) {
+    igraph_vector_int_t expected, actual;
+
+    igraph_vector_int_init(&expected, 0);
+    igraph_vector_int_init(&actual, 0);
+    igraph_coreness(graph, &expected, IGRAPH_ALL);
+    igraph_coreness_incremental_coreness(ic, &actual);
+    IGRAPH_ASSERT(igraph_vcount(graph) == igraph_coreness_incremental_vcount(ic));
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&expected, &actual));
+    for (igraph_integer_t i = 0; i < igraph_vcount(graph); i++) {
+        IGRAPH_ASSERT(igraph_coreness_incremental_get(ic, i) == VECTOR(expected)[i]);
+    }
+    igraph_vector_int_destroy(&actual);
+    igraph_vector_int_destroy(&expected);
+}
+
+void print_cores(const igraph_coreness_incremental_t *ic) {
+    igraph_vector_int_t cores;
+    igraph_vector_int_init(&cores, 0);
+    igraph_coreness_incremental_coreness(ic, &cores);
+    print_vector_int(&cores);
+    igraph_vector_int_destroy(&cores);
+}
+
+/* Applies random insertions and deletions, including self-loops and
+ * multi-edges, and compares the result with igraph_coreness() after
+ * each step. */
+void random_updates(igraph_integer_t n, igraph_integer_t m, igraph_integer_t steps) {
+    igraph_t g;
+    igraph_coreness_incremental_t ic;
+
+    igraph_erdos_renyi_game_gnm(&g, n, m, IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_coreness_incremental_init(&g, &ic);
+    check_against_igraph_coreness(&g, &ic);
+
+    for (igraph_integer_t i = 0; i < steps; i++) {
+        if (RNG_INTEGER(0, 1) == 0 || igraph_ecount(&g) == 0) {
+            igraph_integer_t from = RNG_INTEGER(0, n - 1);
+            igraph_integer_t to = RNG_INTEGER(0, 9) == 0 ? from : RNG_INTEGER(0, n - 1);
+            igraph_add_edge(&g, from, to);
+            igraph_coreness_incremental_add_edge(&ic, from, to);
+        } else {
+            igraph_integer_t eid = RNG_INTEGER(0, igraph_ecount(&g) - 1);
+            igraph_integer_t from = IGRAPH_FROM(&g, eid), to = IGRAPH_TO(&g, eid);
+            igraph_delete_edges(&g, igraph_ess_1(eid));
+            igraph_coreness_incremental_delete_edge(&ic, to, from);
+        }
+        check_against_igraph_coreness(&g, &ic);
+    }
+
+    igraph_coreness_incremental_destroy(&ic);
+    igraph_destroy(&g);
+}
+
+int main(void) {
+    igraph_t g;
+    igraph_coreness_incremental_t ic;
+    igraph_vector_int_t cores, expected;
+
+    igraph_rng_seed(igraph_rng_default(), 137);
+
+    printf("Null graph:\n");
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_coreness_incremental_init(&g, &ic);
+    print_cores(&ic);
+    printf("Adding three vertices:\n");
+    igraph_coreness_incremental_add_vertices(&ic, 3);
+    print_cores(&ic);
+    printf("Closing a triangle:\n");
+    igraph_coreness_incremental_add_edge(&ic, 0, 1);
+    igraph_coreness_incremental_add_edge(&ic, 1, 2);
+    print_cores(&ic);
+    igraph_coreness_incremental_add_edge(&ic, 2, 0);
+    print_cores(&ic);
+    printf("Adding a self-loop:\n");
+    igraph_coreness_incremental_add_vertices(&ic, 1);
+    igraph_coreness_incremental_add_edge(&ic, 3, 3);
+    print_cores(&ic);
+    printf("Removing it:\n");
+    igraph_coreness_incremental_delete_edge(&ic, 3, 3);
+    print_cores(&ic);
+    printf("Breaking the triangle:\n");
+    igraph_coreness_incremental_delete_edge(&ic, 1, 0);
+    print_cores(&ic);
+    igraph_coreness_incremental_destroy(&ic);
+    igraph_destroy(&g);
+
+    printf("\nDirected graph, directions are ignored:\n");
+    igraph_small(&g, 5, IGRAPH_DIRECTED, 0,1, 1,2, 2,0, 2,3, 3,4, 4,2, -1);
+    igraph_coreness_incremental_init(&g, &ic);
+    print_cores(&ic);
+    check_against_igraph_coreness(&g, &ic);
+    printf("Adding a chord:\n");
+    igraph_coreness_incremental_add_edge(&ic, 1, 3);
+    print_cores(&ic);
+    igraph_coreness_incremental_add_edge(&ic, 0, 4);
+    print_cores(&ic);
+    igraph_coreness_incremental_add_edge(&ic, 0, 3);
+    igraph_coreness_incremental_add_edge(&ic, 1, 4);
+    print_cores(&ic);
+    printf("Removing a single edge of the K5:\n");
+    igraph_coreness_incremental_delete_edge(&ic, 2, 4);
+    print_cores(&ic);
+
+    printf("\nErrors:\n");
+    CHECK_ERROR(igraph_coreness_incremental_add_edge(&ic, 0, 5), IGRAPH_EINVVID);
+    CHECK_ERROR(igraph_coreness_incremental_delete_edge(&ic, -1, 0), IGRAPH_EINVVID);
+    CHECK_ERROR(igraph_coreness_incremental_delete_edge(&ic, 2, 4), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_coreness_incremental_add_vertices(&ic, -1), IGRAPH_EINVAL);
+    print_cores(&ic);
+    igraph_coreness_incremental_destroy(&ic);
+    igraph_destroy(&g);
+
+    printf("\nRandom updates:\n");
+    random_updates(10, 10, 200);
+    random_updates(30, 60, 500);
+    random_updates(100, 400, 1000);
+    printf("OK\n");
+
+    /* Large enough to trigger parallel peeling in igraph_coreness()
+     * when it is available. */
+    printf("\nLarge graphs:\n");
+    igraph_vector_int_init(&cores, 0);
+    igraph_vector_int_init(&expected, 0);
+    igraph_barabasi_game(&g, 20000, 1, 5, NULL, true, 1, IGRAPH_DIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE_MULTIPLE, NULL);
+    {
+        const igraph_neimode_t modes[] = { IGRAPH_ALL, IGRAPH_OUT, IGRAPH_IN };
+        for (int i = 0; i < 3; i++) {
+            igraph_coreness(&g, &cores, modes[i]);
+            reference_coreness(&g, modes[i], &expected);
+            IGRAPH_ASSERT(igraph_vector_int_all_e(&cores, &expected));
+        }
+    }
+    igraph_destroy(&g);
+    igraph_erdos_renyi_game_gnm(&g, 30000, 150000, IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_coreness(&g, &cores, IGRAPH_ALL);
+    reference_coreness(&g, IGRAPH_ALL, &expected);
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&cores, &expected));
+    igraph_coreness_incremental_init(&g, &ic);
+    check_against_igraph_coreness(&g, &ic);
+    igraph_coreness_incremental_destroy(&ic);
+    igraph_destroy(&g);
+    igraph_vector_int_destroy(&expected);
+    igraph_vector_int_destroy(&cores);
+    printf("OK\n");
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
@@ -0,0 +1,168 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Checks that the compact adjacency list has the same contents as the
+ * ordinary adjacency list constructed with the same parameters. */
+void check_adjlist(const igraph_t *graph, igraph_neimode_t mode,
+                   igraph_loops_t loops, igraph_multiple_t multiple) {
+    igraph_adjlist_t al;
+    igraph_csr_adjlist_t csr;
+
+    igraph_adjlist_init(graph, &al, mode, loops, multiple);
+    igraph_csr_adjlist_init(graph, &csr, mode, loops, multiple);
+
+    IGRAPH_ASSERT(igraph_csr_adjlist_size(&csr) == igraph_adjlist_size(&al));
+    IGRAPH_ASSERT(!igraph_csr_adjlist_has_eids(&csr));
+
+    for (igraph_integer_t i = 0; i < igraph_adjlist_size(&al); i++) {
+        igraph_vector_int_t *neis = igraph_adjlist_get(&al, i);
+        igraph_integer_t n = igraph_vector_int_size(neis);
+        const igraph_integer_t *csr_neis = igraph_csr_adjlist_get(&csr, i);
+
+        IGRAPH_ASSERT(igraph_csr_adjlist_degree(&csr, i) == n);
+        for (igraph_integer_t j = 0; j < n; j++) {
+            IGRAPH_ASSERT(csr_neis[j] == VECTOR(*neis)[j]);
+        }
+    }
+
+    igraph_csr_adjlist_destroy(&csr);
+    igraph_adjlist_destroy(&al);
+}
+
+/* Checks that the compact adjacency list with edge IDs has the same contents
+ * as the ordinary incidence list constructed with the same parameters. */
+void check_inclist(const igraph_t *graph, igraph_neimode_t mode, igraph_loops_t loops) {
+    igraph_inclist_t il;
+    igraph_csr_adjlist_t csr;
+
+    igraph_inclist_init(graph, &il, mode, loops);
+    igraph_csr_adjlist_init_incident(graph, &csr, mode, loops);
+
+    IGRAPH_ASSERT(igraph_csr_adjlist_size(&csr) == igraph_inclist_size(&il));
+    IGRAPH_ASSERT(igraph_csr_adjlist_has_eids(&csr));
+
+    for (igraph_integer_t i = 0; i < igraph_inclist_size(&il); i++) {
+        igraph_vector_int_t *incs = igraph_inclist_get(&il, i);
+        igraph_integer_t n = igraph_vector_int_size(incs);
+        const igraph_integer_t *csr_neis = igraph_csr_adjlist_get(&csr, i);
+        const igraph_integer_t *csr_eids = igraph_csr_adjlist_get_eids(&csr, i);
+
+        IGRAPH_ASSERT(igraph_csr_adjlist_degree(&csr, i) == n);
+        for (igraph_integer_t j = 0; j < n; j++) {
+            igraph_integer_t eid = VECTOR(*incs)[j];
+            IGRAPH_ASSERT(csr_eids[j] == eid);
+            IGRAPH_ASSERT(csr_neis[j] == IGRAPH_OTHER(graph, eid, i));
+        }
+    }
+
+    igraph_csr_adjlist_destroy(&csr);
+    igraph_inclist_destroy(&il);
+}
+
+void check_all(const igraph_t *graph) {
+    const igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    const igraph_loops_t loops[] = { IGRAPH_NO_LOOPS, IGRAPH_LOOPS_ONCE, IGRAPH_LOOPS_TWICE };
+    const igraph_multiple_t multiple[] = { IGRAPH_NO_MULTIPLE, IGRAPH_MULTIPLE };
+
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            check_inclist(graph, modes[i], loops[j]);
+            for (int k = 0; k < 2; k++) {
+                check_adjlist(graph, modes[i], loops[j], multiple[k]);
+            }
+        }
+    }
+}
+
+int main(void) {
+    igraph_t g;
+    igraph_csr_adjlist_t csr;
+
+    printf("Null graph:\n");
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_csr_adjlist_init(&g, &csr, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE);
+    igraph_csr_adjlist_print(&csr);
+    igraph_csr_adjlist_destroy(&csr);
+    check_all(&g);
+    igraph_destroy(&g);
+
+    printf("\nUndirected graph with loops and multi-edges, loops twice:\n");
+    igraph_small(&g, 6, IGRAPH_UNDIRECTED,
+                 0,1, 0,2, 1,1, 1,3, 2,0, 2,3, 3,4, 3,4, 4,4, 4,4,
+                 -1);
+    igraph_csr_adjlist_init(&g, &csr, IGRAPH_ALL, IGRAPH_LOOPS_TWICE, IGRAPH_MULTIPLE);
+    igraph_csr_adjlist_print(&csr);
+    igraph_csr_adjlist_destroy(&csr);
+
+    printf("\nSame graph, simplified:\n");
+    igraph_csr_adjlist_init(&g, &csr, IGRAPH_ALL, IGRAPH_NO_LOOPS, IGRAPH_NO_MULTIPLE);
+    igraph_csr_adjlist_print(&csr);
+    igraph_csr_adjlist_destroy(&csr);
+
+    printf("\nSame graph, with edge IDs and loops once:\n");
+    igraph_csr_adjlist_init_incident(&g, &csr, IGRAPH_ALL, IGRAPH_LOOPS_ONCE);
+    igraph_csr_adjlist_print(&csr);
+    print_vector_int(&csr.eids);
+    igraph_csr_adjlist_destroy(&csr);
+
+    check_all(&g);
+    igraph_destroy(&g);
+
+    printf("\nDirected graph with loops and multi-edges, out-neighbors:\n");
+    igraph_small(&g, 5, IGRAPH_DIRECTED,
+                 0,1, 1,0, 0,1, 1,2, 2,2, 2,3, 3,0, 3,0, 4,4,
+                 -1);
+    igraph_csr_adjlist_init(&g, &csr, IGRAPH_OUT, IGRAPH_LOOPS_ONCE, IGRAPH_MULTIPLE);
+    igraph_csr_adjlist_print(&csr);
+    igraph_csr_adjlist_destroy(&csr);
+
+    check_all(&g);
+    igraph_destroy(&g);
+
+    printf("\nRandom graphs:\n");
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (int i = 0; i < 10; i++) {
+        igraph_vector_int_t edges;
+
+        igraph_erdos_renyi_game_gnm(&g, 20, 60, i % 2 == 0, IGRAPH_LOOPS);
+
+        /* duplicate some of the edges to create multi-edges */
+        igraph_vector_int_init(&edges, 0);
+        igraph_get_edgelist(&g, &edges, false);
+        igraph_vector_int_resize(&edges, 20);
+        igraph_add_edges(&g, &edges, NULL);
+        igraph_vector_int_destroy(&edges);
+
+        check_all(&g);
+        igraph_destroy(&g);
+    }
+    printf("OK\n");
+
+    printf("\nInvalid mode:\n");
+    igraph_ring(&g, 3, IGRAPH_DIRECTED, false, true);
+    CHECK_ERROR(igraph_csr_adjlist_init(&g, &csr, (igraph_neimode_t) 42, IGRAPH_LOOPS, IGRAPH_MULTIPLE), IGRAPH_EINVMODE);
+    printf("OK\n");
+    igraph_destroy(&g);
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
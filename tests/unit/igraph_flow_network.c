@@ -0,0 +1,202 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Checks that a flow network query gives the same flow value, minimum cut
+ * and partitions as igraph_maxflow(). */
+void check_pair(const igraph_t *graph, igraph_flow_network_t *network,
+                const igraph_vector_t *capacity,
+                igraph_integer_t source, igraph_integer_t target) {
+    igraph_real_t value, expected_value;
+    igraph_vector_int_t cut, partition, partition2;
+    igraph_vector_int_t expected_cut, expected_partition, expected_partition2;
+
+    igraph_vector_int_init(&cut, 0);
+    igraph_vector_int_init(&partition, 0);
+    igraph_vector_int_init(&partition2, 0);
+    igraph_vector_int_init(&expected_cut, 0);
+    igraph_vector_int_init(&expected_partition, 0);
+    igraph_vector_int_init(&expected_partition2, 0);
+
+    igraph_maxflow(graph, &expected_value, NULL, &expected_cut,
+                   &expected_partition, &expected_partition2,
+                   source, target, capacity, NULL);
+    igraph_flow_network_maxflow(network, &value, &cut, &partition, &partition2,
+                                source, target, NULL);
+
+    IGRAPH_ASSERT(value == expected_value);
+    igraph_vector_int_sort(&cut);
+    igraph_vector_int_sort(&expected_cut);
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&cut, &expected_cut));
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&partition, &expected_partition));
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&partition2, &expected_partition2));
+
+    igraph_vector_int_destroy(&expected_partition2);
+    igraph_vector_int_destroy(&expected_partition);
+    igraph_vector_int_destroy(&expected_cut);
+    igraph_vector_int_destroy(&partition2);
+    igraph_vector_int_destroy(&partition);
+    igraph_vector_int_destroy(&cut);
+}
+
+void check_all_pairs(const igraph_t *graph, const igraph_vector_t *capacity) {
+    igraph_flow_network_t network;
+    igraph_integer_t n = igraph_vcount(graph);
+
+    igraph_flow_network_init(&network, graph, capacity);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        for (igraph_integer_t j = 0; j < n; j++) {
+            if (i != j) {
+                check_pair(graph, &network, capacity, i, j);
+            }
+        }
+    }
+    igraph_flow_network_destroy(&network);
+}
+
+void random_capacities(const igraph_t *graph, igraph_vector_t *capacity) {
+    igraph_vector_resize(capacity, igraph_ecount(graph));
+    for (igraph_integer_t i = 0; i < igraph_ecount(graph); i++) {
+        VECTOR(*capacity)[i] = RNG_INTEGER(0, 10);
+    }
+}
+
+int main(void) {
+    igraph_t g;
+    igraph_flow_network_t network;
+    igraph_vector_t capacity;
+    igraph_vector_int_t cut, partition, partition2;
+    igraph_real_t value;
+    igraph_maxflow_stats_t stats;
+    igraph_integer_t cold_pushes;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_vector_int_init(&cut, 0);
+    igraph_vector_int_init(&partition, 0);
+    igraph_vector_int_init(&partition2, 0);
+
+    printf("Small directed graph:\n");
+    igraph_small(&g, 6, IGRAPH_DIRECTED,
+                 0,1, 0,2, 1,2, 1,3, 2,4, 3,4, 3,5, 4,5, -1);
+    igraph_vector_init_int_end(&capacity, -1, 3, 2, 1, 3, 2, 1, 2, 3, -1);
+    igraph_flow_network_init(&network, &g, &capacity);
+    igraph_flow_network_maxflow(&network, &value, &cut, &partition, &partition2, 0, 5, NULL);
+    printf("value: %g\n", value);
+    printf("cut: ");
+    print_vector_int(&cut);
+    printf("partition: ");
+    print_vector_int(&partition);
+    printf("partition2: ");
+    print_vector_int(&partition2);
+    igraph_flow_network_destroy(&network);
+    check_all_pairs(&g, &capacity);
+    check_all_pairs(&g, NULL);
+    igraph_destroy(&g);
+
+    printf("\nSame graph, undirected:\n");
+    igraph_small(&g, 6, IGRAPH_UNDIRECTED,
+                 0,1, 0,2, 1,2, 1,3, 2,4, 3,4, 3,5, 4,5, -1);
+    igraph_flow_network_init(&network, &g, &capacity);
+    igraph_flow_network_maxflow(&network, &value, &cut, &partition, &partition2, 5, 0, NULL);
+    printf("value: %g\n", value);
+    printf("cut: ");
+    print_vector_int(&cut);
+    printf("partition: ");
+    print_vector_int(&partition);
+    printf("partition2: ");
+    print_vector_int(&partition2);
+    igraph_flow_network_destroy(&network);
+    check_all_pairs(&g, &capacity);
+    igraph_destroy(&g);
+
+    printf("\nRandom graphs:\n");
+    for (int i = 0; i < 6; i++) {
+        igraph_erdos_renyi_game_gnm(&g, 12, 40, i % 2 == 0, IGRAPH_LOOPS);
+        random_capacities(&g, &capacity);
+        check_all_pairs(&g, &capacity);
+        igraph_destroy(&g);
+    }
+    printf("OK\n");
+
+    printf("\nChanging capacities:\n");
+    for (int i = 0; i < 6; i++) {
+        igraph_erdos_renyi_game_gnm(&g, 50, 300, i % 2 == 0, IGRAPH_NO_LOOPS);
+        random_capacities(&g, &capacity);
+        igraph_flow_network_init(&network, &g, &capacity);
+        check_pair(&g, &network, &capacity, 0, 1);
+
+        for (int j = 0; j < 20; j++) {
+            igraph_integer_t eid = RNG_INTEGER(0, igraph_ecount(&g) - 1);
+            /* Mostly increases, which allow warm starts, but some decreases as well. */
+            VECTOR(capacity)[eid] = j % 4 == 3 ? RNG_INTEGER(0, 3) : VECTOR(capacity)[eid] + RNG_INTEGER(1, 5);
+            igraph_flow_network_set_capacity(&network, eid, VECTOR(capacity)[eid]);
+            check_pair(&g, &network, &capacity, 0, 1);
+        }
+
+        igraph_flow_network_destroy(&network);
+        igraph_destroy(&g);
+    }
+    printf("OK\n");
+
+    printf("\nWarm start does less work:\n");
+    {
+        igraph_vector_int_t dims;
+        igraph_vector_int_init_int(&dims, 2, 30, 30);
+        igraph_square_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, false, NULL);
+        igraph_vector_int_destroy(&dims);
+    }
+    igraph_vector_resize(&capacity, igraph_ecount(&g));
+    igraph_vector_fill(&capacity, 1);
+    igraph_flow_network_init(&network, &g, &capacity);
+    igraph_flow_network_maxflow(&network, &value, NULL, NULL, NULL, 0, 899, &stats);
+    cold_pushes = stats.nopush;
+    printf("value: %g\n", value);
+    VECTOR(capacity)[0] = VECTOR(capacity)[igraph_ecount(&g) - 1] = 2;
+    igraph_flow_network_set_capacity(&network, 0, 2);
+    igraph_flow_network_set_capacity(&network, igraph_ecount(&g) - 1, 2);
+    igraph_flow_network_maxflow(&network, &value, NULL, NULL, NULL, 0, 899, &stats);
+    printf("value after increasing capacities: %g\n", value);
+    IGRAPH_ASSERT(stats.nopush < cold_pushes);
+    check_pair(&g, &network, &capacity, 0, 899);
+    igraph_flow_network_destroy(&network);
+    igraph_destroy(&g);
+
+    printf("\nErrors:\n");
+    igraph_ring(&g, 4, IGRAPH_DIRECTED, false, true);
+    igraph_vector_resize(&capacity, 3);
+    CHECK_ERROR(igraph_flow_network_init(&network, &g, &capacity), IGRAPH_EINVAL);
+    igraph_flow_network_init(&network, &g, NULL);
+    CHECK_ERROR(igraph_flow_network_maxflow(&network, &value, NULL, NULL, NULL, 0, 4, NULL), IGRAPH_EINVVID);
+    CHECK_ERROR(igraph_flow_network_maxflow(&network, &value, NULL, NULL, NULL, 2, 2, NULL), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_flow_network_set_capacity(&network, 4, 1.0), IGRAPH_EINVAL);
+    igraph_flow_network_destroy(&network);
+    igraph_destroy(&g);
+    printf("OK\n");
+
+    igraph_vector_int_destroy(&partition2);
+    igraph_vector_int_destroy(&partition);
+    igraph_vector_int_destroy(&cut);
+    igraph_vector_destroy(&capacity);
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
@@ -33,7 +33,7 @@ igraph_error_t validate_tree(const igraph_t *graph, const igraph_t *tree,
     igraph_vector_int_t membership;
     igraph_real_t min_weight, flow_value;
     igraph_t copy;
-    igraph_integer_t i, j, k, m;
+    igraph_integer_t i, j, k, m, e;
 
     if (igraph_vcount(tree) != n) {
         printf("Gomory-Hu tree should have %" IGRAPH_PRId " vertices\n", n);
@@ -112,9 +112,9 @@ igraph_error_t validate_tree(const igraph_t *graph, const igraph_t *tree,
              * minimum weight along the path we found above */
             m = igraph_ecount(graph);
             flow_value = 0.0;
-            for (j = 0; j < m; j++) {
-                if (VECTOR(membership)[IGRAPH_FROM(graph, j)] != VECTOR(membership)[IGRAPH_TO(graph, j)]) {
-                    flow_value += capacity ? VECTOR(*capacity)[j] : 1;
+            for (e = 0; e < m; e++) {
+                if (VECTOR(membership)[IGRAPH_FROM(graph, e)] != VECTOR(membership)[IGRAPH_TO(graph, e)]) {
+                    flow_value += capacity ? VECTOR(*capacity)[e] : 1;
                 }
             }
 
@@ -204,6 +204,34 @@ int main(void) {
     igraph_destroy(&tree);
     igraph_destroy(&g);
 
+    /* random graphs, large enough for the parallel code path if available */
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (int i = 0; i < 3; i++) {
+        igraph_erdos_renyi_game_gnm(&g, 40, 120, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+        igraph_vector_resize(&capacity, igraph_ecount(&g));
+        for (igraph_integer_t j = 0; j < igraph_ecount(&g); j++) {
+            VECTOR(capacity)[j] = RNG_INTEGER(1, 10);
+        }
+        IGRAPH_ASSERT(igraph_gomory_hu_tree(&g, &tree, &flow, &capacity) == IGRAPH_SUCCESS);
+        IGRAPH_ASSERT(validate_tree(&g, &tree, &flow, &capacity) == IGRAPH_SUCCESS);
+        igraph_destroy(&tree);
+        igraph_destroy(&g);
+    }
+
+    igraph_barabasi_game(&g, 50, 1, 3, NULL, true, 1, IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE, NULL);
+    IGRAPH_ASSERT(igraph_gomory_hu_tree(&g, &tree, &flow, NULL) == IGRAPH_SUCCESS);
+    IGRAPH_ASSERT(validate_tree(&g, &tree, &flow, NULL) == IGRAPH_SUCCESS);
+    igraph_destroy(&tree);
+    igraph_destroy(&g);
+
+    /* capacity vector of wrong length */
+    igraph_ring(&g, 5, IGRAPH_UNDIRECTED, false, true);
+    igraph_vector_resize(&capacity, 3);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    IGRAPH_ASSERT(igraph_gomory_hu_tree(&g, &tree, &flow, &capacity) == IGRAPH_EINVAL);
+    igraph_set_error_handler(igraph_error_handler_abort);
+    igraph_destroy(&g);
+
     /* simple directed graph - should throw an error */
     igraph_small(&g, 6, 1, 0, 1, 0, 2, 1, 2, 1, 3, 1, 4, 2, 4, 3, 4, 3, 5, 4, 5, -1);
     igraph_set_error_handler(igraph_error_handler_ignore);
@@ -88,6 +88,23 @@ int main(void) {
         }
     }
 
+    /* The sampling chains use random streams derived from the seed, so the
+     * result is reproducible. */
+    {
+        igraph_vector_int_t edges2;
+        igraph_vector_t prob2;
+
+        igraph_rng_seed(igraph_rng_default(), 42);
+        igraph_vector_int_init(&edges2, 0);
+        igraph_vector_init(&prob2, 0);
+        igraph_hrg_predict(&karate, &edges2, &prob2, /* hrg= */ 0, /* start= */ 0,
+                           /* num_samples= */ 100, /* num_bins= */ 25);
+        IGRAPH_ASSERT(igraph_vector_int_all_e(&edges, &edges2));
+        IGRAPH_ASSERT(igraph_vector_all_e(&prob, &prob2));
+        igraph_vector_destroy(&prob2);
+        igraph_vector_int_destroy(&edges2);
+    }
+
     igraph_vector_destroy(&prob);
     igraph_vector_int_destroy(&edges);
 
@@ -19,6 +19,12 @@
 #include <igraph.h>
 #include "test_utilities.h"
 
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 void set_options_fast(igraph_layout_drl_options_t *options) {
     options->edge_cut = 4.0/5.0;
 
@@ -61,10 +67,50 @@ void check_and_destroy(igraph_matrix_t *result, igraph_real_t half_size) {
     igraph_matrix_destroy(result);
 }
 
+/* Lays out graphs large enough for the batched node update, through all
+ * stages including the fine density one, and checks that the layout is
+ * finite, stays within the density grid, and is the same with one and with
+ * several threads. */
+void check_batched(const igraph_t *graph, const igraph_layout_drl_options_t *options,
+                   igraph_real_t half_size) {
+    igraph_matrix_t result, result_threads;
+
+    igraph_matrix_init(&result, 0, 0);
+    igraph_matrix_init(&result_threads, 0, 0);
+
+#ifdef _OPENMP
+    int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    igraph_rng_seed(igraph_rng_default(), 137);
+    IGRAPH_ASSERT(igraph_layout_drl(graph, &result, /*use_seed*/ 0, options,
+                  /*weights*/ NULL) == IGRAPH_SUCCESS);
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+    igraph_rng_seed(igraph_rng_default(), 137);
+    IGRAPH_ASSERT(igraph_layout_drl(graph, &result_threads, /*use_seed*/ 0, options,
+                  /*weights*/ NULL) == IGRAPH_SUCCESS);
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    IGRAPH_ASSERT(igraph_matrix_nrow(&result) == igraph_vcount(graph));
+    IGRAPH_ASSERT(igraph_matrix_ncol(&result) == 2);
+    for (igraph_integer_t i = 0; i < igraph_matrix_size(&result); i++) {
+        IGRAPH_ASSERT(isfinite(VECTOR(result.data)[i]));
+    }
+    IGRAPH_ASSERT(igraph_matrix_all_e(&result, &result_threads));
+
+    igraph_matrix_destroy(&result_threads);
+    check_and_destroy(&result, half_size);
+}
+
 int main(void) {
     igraph_t g;
     igraph_matrix_t result;
     igraph_layout_drl_options_t options;
+    igraph_vector_int_t dims;
     int i;
     igraph_real_t *damping_muls[6] = {&options.init_damping_mult, &options.liquid_damping_mult, &options.expansion_damping_mult, &options.cooldown_damping_mult, &options.crunch_damping_mult, &options.simmer_damping_mult};
 
@@ -94,6 +140,23 @@ int main(void) {
     igraph_matrix_destroy(&result);
     igraph_destroy(&g);
 
+    VERIFY_FINALLY_STACK();
+
+    printf("Lattice, batched update.\n");
+    igraph_vector_int_init_int(&dims, 2, 20, 15);
+    set_options_fast(&options);
+    igraph_square_lattice(&g, &dims, /*nei*/ 1, IGRAPH_UNDIRECTED, /*mutual*/ false, /*circular*/ NULL);
+    check_batched(&g, &options, 2000);
+    igraph_vector_int_destroy(&dims);
+    igraph_destroy(&g);
+
+    printf("Preferential attachment graph, batched update.\n");
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_barabasi_game(&g, 400, /*power*/ 1, /*m*/ 2, NULL, /*outpref*/ false, /*A*/ 1,
+                         IGRAPH_UNDIRECTED, IGRAPH_BARABASI_PSUMTREE, NULL);
+    check_batched(&g, &options, 2000);
+    igraph_destroy(&g);
+
     VERIFY_FINALLY_STACK();
     return 0;
 }
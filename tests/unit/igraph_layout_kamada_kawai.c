@@ -17,6 +17,7 @@
 */
 
 #include <igraph.h>
+#include <math.h>
 #include "test_utilities.h"
 
 void make_box(int vertices, float half_size, igraph_vector_t *bounds) {
@@ -149,6 +150,62 @@ int main(void) {
     destroy_bounds(bounds);
     igraph_vector_destroy(&weights);
 
+    printf("Large lattice, using the sparse stress model.\n");
+    {
+        igraph_vector_int_t dims;
+        igraph_vector_int_init_int(&dims, 2, 40, 40);
+        igraph_square_lattice(&g, &dims, 1, IGRAPH_UNDIRECTED, false, NULL);
+        igraph_vector_int_destroy(&dims);
+    }
+    igraph_matrix_init(&result, 0, 0);
+    igraph_layout_kamada_kawai(&g, &result, /*use_seed*/ 0, /*maxiter*/ 10 * 1600,
+            /*epsilon*/ 0, /*kkconst */ 1600,
+            /*weight*/ NULL, /*minx*/ NULL, /*maxx*/ NULL, /*miny*/ NULL,
+            /*maxy*/ NULL);
+    IGRAPH_ASSERT(distance_correlation(&g, &result) > 0.95);
+
+    printf("Large lattice, seeded, with bounds and weights.\n");
+    make_box(1600, 5.0, bounds);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    igraph_vector_fill(&weights, 2);
+    igraph_layout_kamada_kawai(&g, &result, /*use_seed*/ 1, /*maxiter*/ 10 * 1600,
+            /*epsilon*/ 0.0001, /*kkconst */ 1600,
+            &weights, &bounds[0], &bounds[1], &bounds[2], &bounds[3]);
+    check_and_destroy(&result, 5.0);
+    igraph_vector_destroy(&weights);
+    destroy_bounds(bounds);
+
+    printf("Large 3D lattice, using the sparse stress model.\n");
+    {
+        igraph_t g3;
+        igraph_vector_int_t dims;
+        igraph_vector_int_init_int(&dims, 3, 12, 12, 12);
+        igraph_square_lattice(&g3, &dims, 1, IGRAPH_UNDIRECTED, false, NULL);
+        igraph_vector_int_destroy(&dims);
+        igraph_matrix_init(&result, 0, 0);
+        igraph_layout_kamada_kawai_3d(&g3, &result, /*use_seed*/ 0, /*maxiter*/ 10 * 1728,
+                /*epsilon*/ 0, /*kkconst */ 1728, /*weight*/ NULL,
+                NULL, NULL, NULL, NULL, NULL, NULL);
+        IGRAPH_ASSERT(igraph_matrix_ncol(&result) == 3);
+        IGRAPH_ASSERT(distance_correlation(&g3, &result) > 0.95);
+        igraph_matrix_destroy(&result);
+        igraph_destroy(&g3);
+    }
+
+    printf("Large disconnected graph, using the sparse stress model.\n");
+    igraph_add_vertices(&g, 10, NULL);
+    igraph_matrix_init(&result, 0, 0);
+    igraph_layout_kamada_kawai(&g, &result, /*use_seed*/ 0, /*maxiter*/ 10 * 1610,
+            /*epsilon*/ 0, /*kkconst */ 1610,
+            /*weight*/ NULL, /*minx*/ NULL, /*maxx*/ NULL, /*miny*/ NULL,
+            /*maxy*/ NULL);
+    IGRAPH_ASSERT(igraph_matrix_nrow(&result) == 1610);
+    for (igraph_integer_t i = 0; i < igraph_matrix_size(&result); i++) {
+        IGRAPH_ASSERT(isfinite(VECTOR(result.data)[i]));
+    }
+    igraph_matrix_destroy(&result);
+    igraph_destroy(&g);
+
     VERIFY_FINALLY_STACK();
     return 0;
 }
@@ -0,0 +1,102 @@
+/* IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include <math.h>
+#include "test_utilities.h"
+
+/* Checks that all coordinates are finite and that no two vertices coincide. */
+static void check_layout(const igraph_t *graph, const igraph_matrix_t *res) {
+    igraph_integer_t n = igraph_vcount(graph);
+
+    IGRAPH_ASSERT(igraph_matrix_nrow(res) == n);
+    IGRAPH_ASSERT(igraph_matrix_ncol(res) == 2);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        IGRAPH_ASSERT(isfinite(MATRIX(*res, i, 0)) && isfinite(MATRIX(*res, i, 1)));
+        for (igraph_integer_t j = 0; j < i; j++) {
+            IGRAPH_ASSERT(MATRIX(*res, i, 0) != MATRIX(*res, j, 0) ||
+                          MATRIX(*res, i, 1) != MATRIX(*res, j, 1));
+        }
+    }
+}
+
+int main(void) {
+    igraph_t graph, lattice;
+    igraph_matrix_t res;
+    igraph_vector_int_t dims;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_matrix_init(&res, 0, 0);
+
+    printf("Null graph\n");
+    igraph_empty(&graph, 0, IGRAPH_UNDIRECTED);
+    igraph_layout_multilevel(&graph, &res, 50, 50, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD);
+    print_matrix(&res);
+    igraph_destroy(&graph);
+
+    printf("Singleton graph\n");
+    igraph_empty(&graph, 1, IGRAPH_UNDIRECTED);
+    igraph_layout_multilevel(&graph, &res, 50, 1, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD);
+    check_layout(&graph, &res);
+    igraph_destroy(&graph);
+
+    printf("Star, coarsened to a single vertex\n");
+    igraph_star(&graph, 100, IGRAPH_STAR_UNDIRECTED, 0);
+    igraph_layout_multilevel(&graph, &res, 50, 1, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD);
+    check_layout(&graph, &res);
+    igraph_layout_multilevel(&graph, &res, 50, 1, IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT);
+    check_layout(&graph, &res);
+    igraph_destroy(&graph);
+
+    printf("Disconnected graph with isolated vertices and multi-edges\n");
+    igraph_small(&graph, 12, IGRAPH_DIRECTED,
+                 0, 1, 1, 2, 2, 0, 2, 0, 3, 3, 4, 5, 5, 6, 6, 7, 7, 8, 8, 4,
+                 -1);
+    igraph_layout_multilevel(&graph, &res, 50, 2, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD);
+    check_layout(&graph, &res);
+    igraph_layout_multilevel(&graph, &res, 50, 2, IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT);
+    check_layout(&graph, &res);
+    igraph_destroy(&graph);
+
+    printf("Lattice\n");
+    igraph_vector_int_init_int(&dims, 2, 30, 30);
+    igraph_square_lattice(&lattice, &dims, 1, IGRAPH_UNDIRECTED, /* mutual */ false, /* periodic */ NULL);
+    igraph_vector_int_destroy(&dims);
+    igraph_layout_multilevel(&lattice, &res, 50, 20, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD);
+    check_layout(&lattice, &res);
+    IGRAPH_ASSERT(distance_correlation(&lattice, &res) > 0.9);
+    igraph_layout_multilevel(&lattice, &res, 50, 20, IGRAPH_LAYOUT_MULTILEVEL_GRAPHOPT);
+    check_layout(&lattice, &res);
+    IGRAPH_ASSERT(distance_correlation(&lattice, &res) > 0.5);
+
+    VERIFY_FINALLY_STACK();
+
+    printf("Invalid arguments\n");
+    CHECK_ERROR(igraph_layout_multilevel(&lattice, &res, -1, 20, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD),
+                IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_layout_multilevel(&lattice, &res, 50, 0, IGRAPH_LAYOUT_MULTILEVEL_FRUCHTERMAN_REINGOLD),
+                IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_layout_multilevel(&lattice, &res, 50, 20, (igraph_layout_multilevel_refine_t) 42),
+                IGRAPH_EINVAL);
+    igraph_destroy(&lattice);
+
+    igraph_matrix_destroy(&res);
+
+    VERIFY_FINALLY_STACK();
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include <math.h>
+#include "test_utilities.h"
+
+static void check_finite(const igraph_matrix_t *res, igraph_integer_t n, igraph_integer_t dim) {
+    IGRAPH_ASSERT(igraph_matrix_nrow(res) == n);
+    IGRAPH_ASSERT(igraph_matrix_ncol(res) == dim);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        for (igraph_integer_t j = 0; j < dim; j++) {
+            IGRAPH_ASSERT(isfinite(MATRIX(*res, i, j)));
+        }
+    }
+}
+
+int main(void) {
+    igraph_t graph, lattice;
+    igraph_matrix_t res, res2;
+    igraph_vector_int_t dims;
+    igraph_vector_t weights;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&res2, 0, 0);
+
+    printf("Null graph\n");
+    igraph_empty(&graph, 0, IGRAPH_UNDIRECTED);
+    igraph_layout_pivot_mds(&graph, &res, 2, 50, NULL);
+    print_matrix(&res);
+    igraph_destroy(&graph);
+
+    printf("Singleton graph\n");
+    igraph_empty(&graph, 1, IGRAPH_UNDIRECTED);
+    igraph_layout_pivot_mds(&graph, &res, 2, 50, NULL);
+    print_matrix(&res);
+    igraph_destroy(&graph);
+
+    /* With all vertices as pivots, pivot MDS is classical MDS, which lays
+     * out a path exactly on a line. */
+    printf("Path, all vertices are pivots\n");
+    igraph_ring(&graph, 10, IGRAPH_DIRECTED, /* mutual */ false, /* circular */ false);
+    igraph_layout_pivot_mds(&graph, &res, 1, 10, NULL);
+    check_finite(&res, 10, 1);
+    for (igraph_integer_t i = 0; i < 10; i++) {
+        for (igraph_integer_t j = 0; j < 10; j++) {
+            IGRAPH_ASSERT(fabs(fabs(MATRIX(res, i, 0) - MATRIX(res, j, 0)) - labs(i - j)) < 1e-8);
+        }
+    }
+    igraph_destroy(&graph);
+
+    printf("Lattice\n");
+    igraph_vector_int_init_int(&dims, 2, 30, 30);
+    igraph_square_lattice(&lattice, &dims, 1, IGRAPH_UNDIRECTED, /* mutual */ false, /* periodic */ NULL);
+    igraph_vector_int_destroy(&dims);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_layout_pivot_mds(&lattice, &res, 2, 50, NULL);
+    check_finite(&res, 900, 2);
+    IGRAPH_ASSERT(distance_correlation(&lattice, &res) > 0.9);
+
+    /* Doubling all edge lengths doubles the layout, as long as the same
+     * pivots are sampled. */
+    printf("Lattice, weighted\n");
+    igraph_vector_init(&weights, igraph_ecount(&lattice));
+    igraph_vector_fill(&weights, 2);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_layout_pivot_mds(&lattice, &res2, 2, 50, &weights);
+    check_finite(&res2, 900, 2);
+    igraph_matrix_scale(&res, 2);
+    IGRAPH_ASSERT(igraph_matrix_all_almost_e(&res, &res2, 1e-8));
+
+    printf("3D lattice\n");
+    igraph_vector_int_init_int(&dims, 3, 8, 8, 8);
+    igraph_square_lattice(&graph, &dims, 1, IGRAPH_UNDIRECTED, /* mutual */ false, /* periodic */ NULL);
+    igraph_vector_int_destroy(&dims);
+    igraph_layout_pivot_mds(&graph, &res, 3, 50, NULL);
+    check_finite(&res, 512, 3);
+    IGRAPH_ASSERT(distance_correlation(&graph, &res) > 0.9);
+    igraph_destroy(&graph);
+
+    printf("Disconnected graph with small components and isolated vertices\n");
+    {
+        igraph_t small;
+        igraph_small(&small, 20, IGRAPH_UNDIRECTED,
+                     0, 1, 1, 2, 2, 0, 3, 4, 5, 6, 6, 7, 7, 8, 8, 5, 9, 10, 10, 11,
+                     -1);
+        igraph_disjoint_union(&graph, &small, &lattice);
+        igraph_destroy(&small);
+    }
+    igraph_layout_pivot_mds(&graph, &res, 2, 50, NULL);
+    check_finite(&res, 920, 2);
+
+    VERIFY_FINALLY_STACK();
+
+    printf("Invalid arguments\n");
+    CHECK_ERROR(igraph_layout_pivot_mds(&graph, &res, 3, 50, NULL), IGRAPH_EINVAL);
+    igraph_destroy(&graph);
+    CHECK_ERROR(igraph_layout_pivot_mds(&lattice, &res, 0, 50, NULL), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_layout_pivot_mds(&lattice, &res, 3, 2, NULL), IGRAPH_EINVAL);
+    VECTOR(weights)[0] = 0;
+    CHECK_ERROR(igraph_layout_pivot_mds(&lattice, &res, 2, 50, &weights), IGRAPH_EINVAL);
+    igraph_vector_resize(&weights, 3);
+    CHECK_ERROR(igraph_layout_pivot_mds(&lattice, &res, 2, 50, &weights), IGRAPH_EINVAL);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&lattice);
+
+    igraph_matrix_destroy(&res2);
+    igraph_matrix_destroy(&res);
+
+    VERIFY_FINALLY_STACK();
+
+    return 0;
+}
@@ -178,6 +178,125 @@ void check_graph_twoclusters(const igraph_matrix_t *layout) {
 }
 
 
+/* Checks the weights of a complete graph on four vertices. Each vertex has
+ * one neighbor at distance 1 and two at distance 2, so rho = 1, and sigma is
+ * such that exp(-1 / sigma) = (log2(3) - 1) / 2. The weights of the closest
+ * neighbors are 1. */
+void check_weights_known_values(void) {
+    igraph_t graph;
+    igraph_vector_t distances, weights;
+    igraph_real_t w = (log2(3) - 1) / 2;
+    /* fuzzy union of two edges with weight w */
+    igraph_real_t w_union = 2 * w - w * w;
+    /* The binary search for sigma stops when the sum of the weights is
+     * within 0.01 of its target, after taking one more step. */
+    igraph_real_t eps = 0.03;
+
+    igraph_vector_init(&weights, 0);
+
+    /* Undirected: the weights from both ends are combined */
+    igraph_small(&graph, 4, IGRAPH_UNDIRECTED,
+                 0,1, 2,3, 0,2, 0,3, 1,2, 1,3,
+                 -1);
+    igraph_vector_init_real(&distances, 6, 1.0, 1.0, 2.0, 2.0, 2.0, 2.0);
+    igraph_layout_umap_compute_weights(&graph, &distances, &weights);
+    IGRAPH_ASSERT(igraph_vector_size(&weights) == 6);
+    IGRAPH_ASSERT(VECTOR(weights)[0] == 1 && VECTOR(weights)[1] == 1);
+    for (igraph_integer_t i = 2; i < 6; i++) {
+        IGRAPH_ASSERT(fabs(VECTOR(weights)[i] - w_union) < eps);
+    }
+    igraph_vector_destroy(&distances);
+    igraph_destroy(&graph);
+
+    /* Directed: the union of mutual edges goes to the one with the smaller
+     * ID, the other one gets zero. Vertex 4 has edges out, but none in. */
+    igraph_small(&graph, 5, IGRAPH_DIRECTED,
+                 0,1, 2,3, 0,2, 0,3, 1,2, 1,3,
+                 1,0, 3,2, 2,0, 3,0, 2,1, 3,1,
+                 4,0, 4,1, 4,2,
+                 -1);
+    igraph_vector_init_real(&distances, 15,
+                            1.0, 1.0, 2.0, 2.0, 2.0, 2.0,
+                            1.0, 1.0, 2.0, 2.0, 2.0, 2.0,
+                            1.0, 3.0, 3.0);
+    igraph_layout_umap_compute_weights(&graph, &distances, &weights);
+    IGRAPH_ASSERT(igraph_vector_size(&weights) == 15);
+    IGRAPH_ASSERT(VECTOR(weights)[0] == 1 && VECTOR(weights)[1] == 1);
+    for (igraph_integer_t i = 2; i < 6; i++) {
+        IGRAPH_ASSERT(fabs(VECTOR(weights)[i] - w_union) < eps);
+    }
+    for (igraph_integer_t i = 6; i < 12; i++) {
+        IGRAPH_ASSERT(VECTOR(weights)[i] == 0);
+    }
+    IGRAPH_ASSERT(VECTOR(weights)[12] == 1);
+    IGRAPH_ASSERT(fabs(VECTOR(weights)[13] - w) < eps);
+    IGRAPH_ASSERT(fabs(VECTOR(weights)[14] - w) < eps);
+    igraph_vector_destroy(&distances);
+    igraph_destroy(&graph);
+
+    igraph_vector_destroy(&weights);
+
+    printf("Weights match known values.\n");
+}
+
+
+/* Lays out several cliques with enough edges to be processed in several
+ * blocks, in parallel when more than one thread is available (see the
+ * OMP_NUM_THREADS setting of this test). The layout must be finite, and each
+ * clique must be far from the others compared to its size. */
+void check_graph_cliques(void) {
+    igraph_t graph, clique;
+    igraph_matrix_t layout;
+    igraph_integer_t no_of_cliques = 4, clique_size = 40;
+    igraph_real_t centers[4][2], radius = 0;
+    int nerr = 0;
+
+    igraph_full(&clique, clique_size, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_empty(&graph, 0, IGRAPH_UNDIRECTED);
+    for (igraph_integer_t c = 0; c < no_of_cliques; c++) {
+        igraph_t tmp;
+        igraph_disjoint_union(&tmp, &graph, &clique);
+        igraph_destroy(&graph);
+        graph = tmp;
+    }
+    IGRAPH_ASSERT(igraph_ecount(&graph) > 2 * 1024);
+
+    igraph_matrix_init(&layout, 0, 0);
+    IGRAPH_ASSERT(igraph_layout_umap(&graph, &layout, 0, NULL, 0.0, 50, 0) == IGRAPH_SUCCESS);
+
+    for (igraph_integer_t i = 0; i < igraph_matrix_nrow(&layout); i++) {
+        IGRAPH_ASSERT(isfinite(MATRIX(layout, i, 0)) && isfinite(MATRIX(layout, i, 1)));
+    }
+
+    for (igraph_integer_t c = 0; c < no_of_cliques; c++) {
+        centers[c][0] = centers[c][1] = 0;
+        for (igraph_integer_t i = c * clique_size; i < (c + 1) * clique_size; i++) {
+            centers[c][0] += MATRIX(layout, i, 0) / clique_size;
+            centers[c][1] += MATRIX(layout, i, 1) / clique_size;
+        }
+        for (igraph_integer_t i = c * clique_size; i < (c + 1) * clique_size; i++) {
+            radius = fmax(radius, hypot(MATRIX(layout, i, 0) - centers[c][0],
+                                        MATRIX(layout, i, 1) - centers[c][1]));
+        }
+    }
+    for (igraph_integer_t c = 0; c < no_of_cliques; c++) {
+        for (igraph_integer_t d = 0; d < c; d++) {
+            if (hypot(centers[c][0] - centers[d][0], centers[c][1] - centers[d][1]) < 2 * radius) {
+                printf("Cliques %d and %d overlap.\n", (int) d, (int) c);
+                nerr++;
+            }
+        }
+    }
+    if (nerr == 0) {
+        printf("UMAP layout of cliques seems fine.\n");
+    }
+
+    igraph_matrix_destroy(&layout);
+    igraph_destroy(&graph);
+    igraph_destroy(&clique);
+}
+
+
 void check_graph_singleton(const igraph_matrix_t *layout) {
     igraph_integer_t nrows = igraph_matrix_nrow(layout);
     igraph_integer_t ncols = igraph_matrix_ncol(layout);
@@ -326,6 +445,12 @@ int main(void) {
     igraph_vector_int_destroy(&subgraph_sizes);
     igraph_vector_ptr_destroy(&graph_ptr);
 
+    printf("Weights of a small graph with known values:\n");
+    check_weights_known_values();
+
+    printf("Disjoint union of cliques:\n");
+    check_graph_cliques();
+
     VERIFY_FINALLY_STACK();
 
     return 0;
@@ -0,0 +1,211 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Checks that every step of every walk follows an edge with non-zero weight,
+ * in the direction given by 'mode'. */
+void check_walks(const igraph_t *graph, const igraph_vector_t *weights,
+                 const igraph_matrix_int_t *walks, igraph_neimode_t mode) {
+    igraph_integer_t steps = igraph_matrix_int_nrow(walks) - 1;
+
+    for (igraph_integer_t w = 0; w < igraph_matrix_int_ncol(walks); w++) {
+        for (igraph_integer_t i = 0; i < steps; i++) {
+            igraph_integer_t from = MATRIX(*walks, i, w), to = MATRIX(*walks, i + 1, w);
+            igraph_integer_t eid;
+
+            if (to == -1) {
+                break;
+            }
+            if (mode == IGRAPH_IN) {
+                igraph_integer_t tmp = from;
+                from = to;
+                to = tmp;
+            }
+            igraph_get_eid(graph, &eid, from, to, mode != IGRAPH_ALL, /* error = */ true);
+            if (weights) {
+                /* There may be multiple edges, one of which must have non-zero weight. */
+                igraph_vector_int_t eids;
+                igraph_bool_t found = false;
+                igraph_vector_int_init(&eids, 0);
+                igraph_get_all_eids_between(graph, &eids, from, to, mode != IGRAPH_ALL);
+                for (igraph_integer_t j = 0; j < igraph_vector_int_size(&eids); j++) {
+                    if (VECTOR(*weights)[VECTOR(eids)[j]] > 0) {
+                        found = true;
+                    }
+                }
+                IGRAPH_ASSERT(found);
+                igraph_vector_int_destroy(&eids);
+            }
+        }
+    }
+}
+
+int main(void) {
+    igraph_t g;
+    igraph_matrix_int_t walks, walks2;
+    igraph_vector_t weights;
+    igraph_integer_t counts[4];
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_matrix_int_init(&walks, 0, 0);
+    igraph_matrix_int_init(&walks2, 0, 0);
+    igraph_vector_init(&weights, 0);
+
+    printf("Ring, two walks from each vertex:\n");
+    igraph_ring(&g, 5, IGRAPH_UNDIRECTED, false, true);
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 2, IGRAPH_ALL, 4, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    print_matrix_int(&walks);
+    check_walks(&g, NULL, &walks, IGRAPH_ALL);
+
+    printf("\nNo steps:\n");
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_1(3), 3, IGRAPH_ALL, 0, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    print_matrix_int(&walks);
+
+    printf("\nNo walks:\n");
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_none(), 3, IGRAPH_ALL, 5, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    printf("%" IGRAPH_PRId " x %" IGRAPH_PRId "\n", igraph_matrix_int_nrow(&walks), igraph_matrix_int_ncol(&walks));
+    igraph_destroy(&g);
+
+    printf("\nDirected path, walks get stuck:\n");
+    igraph_ring(&g, 4, IGRAPH_DIRECTED, false, false);
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_OUT, 4, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    print_matrix_int(&walks);
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_IN, 4, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    print_matrix_int(&walks);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_OUT, 4, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_ERROR), IGRAPH_ERWSTUCK);
+
+    printf("\nZero weights count as missing edges:\n");
+    igraph_vector_resize(&weights, 3);
+    igraph_vector_fill(&weights, 1);
+    VECTOR(weights)[1] = 0;
+    igraph_random_walks(&g, &weights, &walks, igraph_vss_1(0), 2, IGRAPH_OUT, 3, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    print_matrix_int(&walks);
+    igraph_destroy(&g);
+
+    printf("\nRandom graphs:\n");
+    for (int i = 0; i < 6; i++) {
+        igraph_neimode_t mode = i % 3 == 0 ? IGRAPH_OUT : (i % 3 == 1 ? IGRAPH_IN : IGRAPH_ALL);
+        igraph_erdos_renyi_game_gnm(&g, 100, 400, i % 2 == 0, IGRAPH_LOOPS);
+        igraph_vector_resize(&weights, igraph_ecount(&g));
+        for (igraph_integer_t j = 0; j < igraph_ecount(&g); j++) {
+            VECTOR(weights)[j] = RNG_INTEGER(0, 3);
+        }
+        igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 3, mode, 20, 1, 1,
+                            IGRAPH_RANDOM_WALK_STUCK_RETURN);
+        check_walks(&g, NULL, &walks, igraph_is_directed(&g) ? mode : IGRAPH_ALL);
+        igraph_random_walks(&g, &weights, &walks, igraph_vss_all(), 3, mode, 20, 1, 1,
+                            IGRAPH_RANDOM_WALK_STUCK_RETURN);
+        check_walks(&g, &weights, &walks, igraph_is_directed(&g) ? mode : IGRAPH_ALL);
+        igraph_random_walks(&g, &weights, &walks, igraph_vss_all(), 3, mode, 20, 0.25, 4,
+                            IGRAPH_RANDOM_WALK_STUCK_RETURN);
+        check_walks(&g, &weights, &walks, igraph_is_directed(&g) ? mode : IGRAPH_ALL);
+        igraph_destroy(&g);
+    }
+    printf("OK\n");
+
+    printf("\nSame seed, same walks:\n");
+    igraph_erdos_renyi_game_gnm(&g, 1000, 5000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_rng_seed(igraph_rng_default(), 123);
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 5, IGRAPH_ALL, 10, 2, 0.5,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    igraph_rng_seed(igraph_rng_default(), 123);
+    igraph_random_walks(&g, NULL, &walks2, igraph_vss_all(), 5, IGRAPH_ALL, 10, 2, 0.5,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    IGRAPH_ASSERT(igraph_matrix_int_all_e(&walks, &walks2));
+    igraph_destroy(&g);
+    printf("OK\n");
+
+    printf("\nWeighted transition probabilities:\n");
+    igraph_star(&g, 5, IGRAPH_STAR_OUT, 0);
+    igraph_vector_resize(&weights, 4);
+    for (igraph_integer_t j = 0; j < 4; j++) {
+        VECTOR(weights)[j] = j + 1;
+        counts[j] = 0;
+    }
+    igraph_random_walks(&g, &weights, &walks, igraph_vss_1(0), 20000, IGRAPH_OUT, 1, 1, 1,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    for (igraph_integer_t w = 0; w < igraph_matrix_int_ncol(&walks); w++) {
+        counts[MATRIX(walks, 1, w) - 1]++;
+    }
+    for (igraph_integer_t j = 0; j < 4; j++) {
+        IGRAPH_ASSERT(fabs(counts[j] / 20000.0 - (j + 1) / 10.0) < 0.02);
+    }
+    igraph_destroy(&g);
+    printf("OK\n");
+
+    printf("\nSecond-order transition probabilities:\n");
+    /* Coming from 0 to 1, the next step returns to 0 with weight 1/p, goes to
+     * 2, which is a neighbor of 0, with weight 1, and goes to 3 with weight 1/q. */
+    igraph_small(&g, 4, IGRAPH_DIRECTED,
+                 0,1, 0,2, 1,0, 1,2, 1,3,
+                 -1);
+    igraph_random_walks(&g, NULL, &walks, igraph_vss_1(0), 40000, IGRAPH_OUT, 2, 0.5, 2,
+                        IGRAPH_RANDOM_WALK_STUCK_RETURN);
+    for (igraph_integer_t j = 0; j < 4; j++) {
+        counts[j] = 0;
+    }
+    for (igraph_integer_t w = 0; w < igraph_matrix_int_ncol(&walks); w++) {
+        if (MATRIX(walks, 1, w) == 1) {
+            counts[MATRIX(walks, 2, w)]++;
+        }
+    }
+    {
+        igraph_real_t total = counts[0] + counts[2] + counts[3];
+        IGRAPH_ASSERT(counts[1] == 0);
+        IGRAPH_ASSERT(fabs(counts[0] / total - 4.0 / 7) < 0.02);
+        IGRAPH_ASSERT(fabs(counts[2] / total - 2.0 / 7) < 0.02);
+        IGRAPH_ASSERT(fabs(counts[3] / total - 1.0 / 7) < 0.02);
+    }
+    printf("OK\n");
+
+    printf("\nErrors:\n");
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_OUT, -1, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), -1, IGRAPH_OUT, 1, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_OUT, 1, 0, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, IGRAPH_OUT, 1, 1, IGRAPH_NAN,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_all(), 1, (igraph_neimode_t) 42, 1, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVMODE);
+    CHECK_ERROR(igraph_random_walks(&g, &weights, &walks, igraph_vss_all(), 1, IGRAPH_OUT, 1, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_random_walks(&g, NULL, &walks, igraph_vss_1(4), 1, IGRAPH_OUT, 1, 1, 1,
+                                    IGRAPH_RANDOM_WALK_STUCK_RETURN), IGRAPH_EINVVID);
+    igraph_destroy(&g);
+    printf("OK\n");
+
+    igraph_matrix_int_destroy(&walks2);
+    igraph_matrix_int_destroy(&walks);
+    igraph_vector_destroy(&weights);
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
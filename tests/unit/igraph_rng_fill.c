@@ -0,0 +1,125 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Checks that the bulk functions give the same values as the one-by-one
+ * functions, and that they leave the generator in the same state. */
+void check_same_as_get(const igraph_rng_type_t *type) {
+    const igraph_integer_t ranges[][2] = {
+        { 0, 9 }, { -5, 5 }, { 3, 3 }, { -100, -3 }, { 0, 2000000000 },
+        { -7, IGRAPH_INTEGER_MAX }, { IGRAPH_INTEGER_MIN, IGRAPH_INTEGER_MAX }
+    };
+    igraph_rng_t rng, rng2;
+    igraph_vector_t v;
+    igraph_vector_int_t vi;
+
+    igraph_rng_init(&rng, type);
+    igraph_rng_init(&rng2, type);
+    igraph_rng_seed(&rng, 42);
+    igraph_rng_seed(&rng2, 42);
+    igraph_vector_init(&v, 1001);
+    igraph_vector_int_init(&vi, 1001);
+
+    /* Start at an odd position of the generator. */
+    igraph_rng_get_integer(&rng, 0, 10);
+    igraph_rng_get_integer(&rng2, 0, 10);
+
+    igraph_rng_fill_unif01(&rng, &v);
+    for (igraph_integer_t i = 0; i < igraph_vector_size(&v); i++) {
+        IGRAPH_ASSERT(VECTOR(v)[i] == igraph_rng_get_unif01(&rng2));
+    }
+
+    for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        igraph_rng_fill_integer(&rng, &vi, ranges[r][0], ranges[r][1]);
+        for (igraph_integer_t i = 0; i < igraph_vector_int_size(&vi); i++) {
+            IGRAPH_ASSERT(VECTOR(vi)[i] == igraph_rng_get_integer(&rng2, ranges[r][0], ranges[r][1]));
+        }
+    }
+
+    IGRAPH_ASSERT(igraph_rng_get_integer(&rng, 0, 1000000) == igraph_rng_get_integer(&rng2, 0, 1000000));
+
+    igraph_vector_int_destroy(&vi);
+    igraph_vector_destroy(&v);
+    igraph_rng_destroy(&rng2);
+    igraph_rng_destroy(&rng);
+}
+
+int main(void) {
+    igraph_vector_t v;
+    igraph_vector_int_t vi;
+    igraph_real_t mean;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    printf("Same values as one-by-one generation:\n");
+    check_same_as_get(&igraph_rngtype_philox4x32);
+    check_same_as_get(&igraph_rngtype_pcg32);
+#if IGRAPH_INTEGER_SIZE == 64
+    check_same_as_get(&igraph_rngtype_pcg64);
+#endif
+    check_same_as_get(&igraph_rngtype_mt19937);
+    check_same_as_get(&igraph_rngtype_glibc2);
+    printf("OK\n");
+
+    printf("\nEmpty vectors:\n");
+    igraph_vector_init(&v, 0);
+    igraph_vector_int_init(&vi, 0);
+    igraph_rng_fill_unif01(igraph_rng_default(), &v);
+    igraph_rng_fill_integer(igraph_rng_default(), &vi, 0, 5);
+    igraph_rng_fill_exp(igraph_rng_default(), &v, 1);
+    igraph_rng_fill_geom(igraph_rng_default(), &v, 0.5);
+    printf("OK\n");
+
+    printf("\nExponential distribution:\n");
+    igraph_vector_resize(&v, 100000);
+    igraph_rng_fill_exp(igraph_rng_default(), &v, 4);
+    IGRAPH_ASSERT(igraph_vector_min(&v) >= 0);
+    mean = igraph_vector_sum(&v) / igraph_vector_size(&v);
+    IGRAPH_ASSERT(fabs(mean - 0.25) < 0.005);
+    printf("OK\n");
+
+    printf("\nGeometric distribution:\n");
+    igraph_rng_fill_geom(igraph_rng_default(), &v, 0.2);
+    IGRAPH_ASSERT(igraph_vector_min(&v) >= 0);
+    mean = igraph_vector_sum(&v) / igraph_vector_size(&v);
+    /* the mean is (1 - p) / p */
+    IGRAPH_ASSERT(fabs(mean - 4) < 0.1);
+    for (igraph_integer_t i = 0; i < igraph_vector_size(&v); i++) {
+        IGRAPH_ASSERT(VECTOR(v)[i] == floor(VECTOR(v)[i]));
+    }
+    igraph_rng_fill_geom(igraph_rng_default(), &v, 1);
+    IGRAPH_ASSERT(igraph_vector_max(&v) == 0);
+    printf("OK\n");
+
+    printf("\nErrors:\n");
+    CHECK_ERROR(igraph_rng_fill_integer(igraph_rng_default(), &vi, 5, 4), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_rng_fill_exp(igraph_rng_default(), &v, 0), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_rng_fill_exp(igraph_rng_default(), &v, IGRAPH_NAN), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_rng_fill_geom(igraph_rng_default(), &v, 0), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_rng_fill_geom(igraph_rng_default(), &v, 1.5), IGRAPH_EINVAL);
+    printf("OK\n");
+
+    igraph_vector_int_destroy(&vi);
+    igraph_vector_destroy(&v);
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
@@ -51,6 +51,40 @@ void print_result(igraph_t *g, igraph_real_t beta, igraph_real_t gamma, igraph_i
     printf("\n");
 }
 
+/* Checks that igraph_sir_summary() gives the same results as summarizing
+ * the output of igraph_sir() with the same random seed. */
+void check_summary(igraph_t *g, igraph_real_t beta, igraph_real_t gamma, igraph_integer_t no_sim) {
+    igraph_vector_ptr_t result;
+    igraph_vector_int_t final_size, peak;
+    igraph_vector_t peak_time;
+
+    igraph_vector_ptr_init(&result, 0);
+    igraph_vector_int_init(&final_size, 0);
+    igraph_vector_int_init(&peak, 0);
+    igraph_vector_init(&peak_time, 0);
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_sir(g, beta, gamma, no_sim, &result);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_sir_summary(g, beta, gamma, no_sim, &final_size, &peak, &peak_time);
+
+    IGRAPH_ASSERT(igraph_vector_int_size(&final_size) == no_sim);
+    for (igraph_integer_t i = 0; i < no_sim; i++) {
+        igraph_sir_t *sir = VECTOR(result)[i];
+        igraph_integer_t max_pos = igraph_vector_int_which_max(&sir->no_i);
+
+        IGRAPH_ASSERT(VECTOR(final_size)[i] == igraph_vector_int_tail(&sir->no_r));
+        IGRAPH_ASSERT(VECTOR(peak)[i] == VECTOR(sir->no_i)[max_pos]);
+        IGRAPH_ASSERT(VECTOR(peak_time)[i] == VECTOR(sir->times)[max_pos]);
+        igraph_sir_destroy(sir);
+    }
+
+    igraph_vector_destroy(&peak_time);
+    igraph_vector_int_destroy(&peak);
+    igraph_vector_int_destroy(&final_size);
+    igraph_vector_ptr_destroy_all(&result);
+}
+
 int main(void) {
     igraph_t g_empty, g_lm, g_line, g_1, g_2, g_full;
 
@@ -78,9 +112,37 @@ int main(void) {
     printf("Full graph, more infections expected than line with same rates:\n");
     print_result(&g_full, 1, 1, 2);
 
+    printf("Summary of full graph simulations:\n");
+    {
+        igraph_vector_int_t final_size, peak;
+        igraph_vector_int_init(&final_size, 0);
+        igraph_vector_int_init(&peak, 0);
+        igraph_sir_summary(&g_full, 1, 1, 10, &final_size, &peak, NULL);
+        printf("final size: ");
+        print_vector_int(&final_size);
+        printf("peak: ");
+        print_vector_int(&peak);
+        igraph_vector_int_destroy(&peak);
+        igraph_vector_int_destroy(&final_size);
+    }
+
+    printf("\nSummaries match the full results:\n");
+    {
+        igraph_t g;
+        igraph_erdos_renyi_game_gnm(&g, 300, 600, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+        check_summary(&g, 0.5, 1, 40);
+        check_summary(&g_line, 1, 1, 10);
+        igraph_destroy(&g);
+    }
+    printf("OK\n");
+
     VERIFY_FINALLY_STACK();
     igraph_set_error_handler(igraph_error_handler_ignore);
 
+    IGRAPH_ASSERT(igraph_sir_summary(&g_lm, 1, 1, 1, NULL, NULL, NULL) == IGRAPH_EINVAL);
+    IGRAPH_ASSERT(igraph_sir_summary(&g_full, 1, 0, 1, NULL, NULL, NULL) == IGRAPH_EINVAL);
+    IGRAPH_ASSERT(igraph_sir_summary(&g_full, 1, 1, 0, NULL, NULL, NULL) == IGRAPH_EINVAL);
+
     IGRAPH_ASSERT(igraph_sir(&g_lm, 1, 1, 1, NULL) == IGRAPH_EINVAL);
     IGRAPH_ASSERT(igraph_sir(&g_empty, 1, 1, 1, NULL) == IGRAPH_EINVAL);
 
@@ -0,0 +1,226 @@
+/* IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include "test_utilities.h"
+
+static void print_csr(const igraph_sparsemat_csr_t *A) {
+    printf("%" IGRAPH_PRId " x %" IGRAPH_PRId ", %" IGRAPH_PRId " entries\n",
+           igraph_sparsemat_csr_nrow(A), igraph_sparsemat_csr_ncol(A),
+           igraph_sparsemat_csr_nonzero_storage(A));
+    print_vector_int(&A->rowptr);
+    print_vector_int(&A->colidx);
+    print_vector(&A->values);
+}
+
+static void fill_unif(igraph_vector_t *v, igraph_real_t lo, igraph_real_t hi) {
+    for (igraph_integer_t i = 0; i < igraph_vector_size(v); i++) {
+        VECTOR(*v)[i] = RNG_UNIF(lo, hi);
+    }
+}
+
+static igraph_bool_t csr_equal(const igraph_sparsemat_csr_t *A, const igraph_sparsemat_csr_t *B) {
+    return A->nrow == B->nrow && A->ncol == B->ncol &&
+           igraph_vector_int_all_e(&A->rowptr, &B->rowptr) &&
+           igraph_vector_int_all_e(&A->colidx, &B->colidx) &&
+           igraph_vector_all_e(&A->values, &B->values);
+}
+
+/* Compares igraph_get_adjacency_csr() with igraph_get_adjacency(). */
+static void check_adjacency(const igraph_t *graph, const igraph_vector_t *weights) {
+    igraph_get_adjacency_t types[] = { IGRAPH_GET_ADJACENCY_UPPER, IGRAPH_GET_ADJACENCY_LOWER, IGRAPH_GET_ADJACENCY_BOTH };
+    igraph_loops_t loops[] = { IGRAPH_NO_LOOPS, IGRAPH_LOOPS_ONCE, IGRAPH_LOOPS_TWICE };
+    igraph_sparsemat_csr_t csr;
+    igraph_sparsemat_t sp;
+    igraph_matrix_t dense, expected;
+
+    igraph_sparsemat_csr_init(&csr, 0, 0);
+    igraph_matrix_init(&dense, 0, 0);
+    igraph_matrix_init(&expected, 0, 0);
+
+    for (int t = 0; t < 3; t++) {
+        for (int l = 0; l < 3; l++) {
+            igraph_get_adjacency_csr(graph, &csr, types[t], weights, loops[l]);
+            igraph_sparsemat_csr_as_sparsemat(&sp, &csr);
+            igraph_sparsemat_as_matrix(&dense, &sp);
+            igraph_sparsemat_destroy(&sp);
+            igraph_get_adjacency(graph, &expected, types[t], weights, loops[l]);
+            IGRAPH_ASSERT(igraph_matrix_all_e(&dense, &expected));
+        }
+    }
+
+    igraph_matrix_destroy(&expected);
+    igraph_matrix_destroy(&dense);
+    igraph_sparsemat_csr_destroy(&csr);
+}
+
+int main(void) {
+    igraph_sparsemat_t A, B;
+    igraph_sparsemat_csr_t csr, csr2, csr3;
+    igraph_t graph;
+    igraph_vector_t weights, x, y, y2;
+    igraph_matrix_t dense, res, res2;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    printf("Empty matrix:\n");
+    igraph_sparsemat_csr_init(&csr, 2, 3);
+    print_csr(&csr);
+    igraph_sparsemat_csr_destroy(&csr);
+
+    printf("\nFrom triplets, with a duplicate entry:\n");
+    igraph_sparsemat_init(&A, 3, 4, 6);
+    igraph_sparsemat_entry(&A, 2, 3, 1.0);
+    igraph_sparsemat_entry(&A, 0, 2, 2.0);
+    igraph_sparsemat_entry(&A, 2, 0, 3.0);
+    igraph_sparsemat_entry(&A, 0, 1, 4.0);
+    igraph_sparsemat_entry(&A, 2, 3, 5.0);
+    igraph_sparsemat_as_csr(&csr, &A);
+    print_csr(&csr);
+
+    printf("\nFrom the column-compressed form:\n");
+    igraph_sparsemat_compress(&A, &B);
+    igraph_sparsemat_as_csr(&csr2, &B);
+    IGRAPH_ASSERT(csr_equal(&csr, &csr2));
+    igraph_sparsemat_csr_destroy(&csr2);
+    igraph_sparsemat_destroy(&B);
+
+    printf("\nTranspose:\n");
+    igraph_sparsemat_csr_transpose(&csr, &csr2);
+    print_csr(&csr2);
+    igraph_sparsemat_csr_destroy(&csr2);
+
+    printf("\nBack to column-compressed form:\n");
+    igraph_sparsemat_csr_as_sparsemat(&B, &csr);
+    IGRAPH_ASSERT(igraph_sparsemat_is_cc(&B));
+    igraph_sparsemat_print(&B, stdout);
+    igraph_sparsemat_destroy(&B);
+
+    printf("\nMatrix-vector product:\n");
+    igraph_vector_init_range(&x, 1, 5);
+    igraph_vector_init(&y, 3);
+    igraph_vector_fill(&y, 1);
+    igraph_sparsemat_csr_gaxpy(&csr, &x, &y);
+    print_vector(&y);
+
+    printf("\nProduct with dense matrix:\n");
+    {
+        igraph_real_t elems[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        matrix_init_real_row_major(&dense, 4, 2, elems);
+    }
+    igraph_matrix_init(&res, 0, 0);
+    igraph_sparsemat_csr_multiply_by_dense(&csr, &dense, &res);
+    print_matrix(&res);
+
+    printf("\nInvalid sizes:\n");
+    CHECK_ERROR(igraph_sparsemat_csr_gaxpy(&csr, &y, &y), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_sparsemat_csr_multiply_by_dense(&csr, &res, &res), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_sparsemat_csr_init(&csr2, -1, 2), IGRAPH_EINVAL);
+
+    igraph_matrix_destroy(&dense);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+    igraph_sparsemat_csr_destroy(&csr);
+    igraph_sparsemat_destroy(&A);
+
+    printf("\nAdjacency matrix of a small graph:\n");
+    igraph_small(&graph, 4, IGRAPH_UNDIRECTED, 0, 1, 1, 2, 2, 2, 3, 1, 0, 1, -1);
+    igraph_sparsemat_csr_init(&csr, 0, 0);
+    igraph_get_adjacency_csr(&graph, &csr, IGRAPH_GET_ADJACENCY_BOTH, NULL, IGRAPH_LOOPS_TWICE);
+    print_csr(&csr);
+    igraph_vector_init(&weights, 1);
+    CHECK_ERROR(igraph_get_adjacency_csr(&graph, &csr, IGRAPH_GET_ADJACENCY_BOTH, &weights, IGRAPH_LOOPS_ONCE), IGRAPH_EINVAL);
+    igraph_vector_destroy(&weights);
+    igraph_sparsemat_csr_destroy(&csr);
+
+    check_adjacency(&graph, NULL);
+    igraph_to_directed(&graph, IGRAPH_TO_DIRECTED_ARBITRARY);
+    check_adjacency(&graph, NULL);
+    igraph_destroy(&graph);
+
+    printf("\nRandom graphs:\n");
+    igraph_erdos_renyi_game_gnp(&graph, 50, 0.1, IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&graph));
+    fill_unif(&weights, 1, 2);
+    check_adjacency(&graph, &weights);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&graph);
+
+    igraph_erdos_renyi_game_gnp(&graph, 50, 0.1, IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    check_adjacency(&graph, NULL);
+    igraph_destroy(&graph);
+
+    /* Large enough to be split between threads. */
+    printf("\nLarge graph:\n");
+    igraph_erdos_renyi_game_gnm(&graph, 20000, 100000, IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    {
+        /* Add some multi-edges. */
+        igraph_vector_int_t edges;
+        igraph_vector_int_init_range(&edges, 0, 2000);
+        igraph_add_edges(&graph, &edges, NULL);
+        igraph_vector_int_destroy(&edges);
+    }
+    igraph_vector_init(&weights, igraph_ecount(&graph));
+    fill_unif(&weights, -1, 1);
+
+    igraph_sparsemat_csr_init(&csr, 0, 0);
+    igraph_get_adjacency_csr(&graph, &csr, IGRAPH_GET_ADJACENCY_BOTH, &weights, IGRAPH_LOOPS_ONCE);
+    igraph_sparsemat_init(&A, 0, 0, 0);
+    igraph_get_adjacency_sparse(&graph, &A, IGRAPH_GET_ADJACENCY_BOTH, &weights, IGRAPH_LOOPS_ONCE);
+    igraph_sparsemat_compress(&A, &B);
+
+    /* Transposing twice sorts the rows stably, like the conversion of
+     * the triplet form does. */
+    igraph_sparsemat_csr_transpose(&csr, &csr2);
+    igraph_sparsemat_csr_transpose(&csr2, &csr3);
+    igraph_sparsemat_csr_destroy(&csr2);
+    igraph_sparsemat_as_csr(&csr2, &A);
+    IGRAPH_ASSERT(csr_equal(&csr2, &csr3));
+    igraph_sparsemat_csr_destroy(&csr3);
+    igraph_sparsemat_csr_destroy(&csr2);
+
+    igraph_vector_init(&x, 20000);
+    fill_unif(&x, -1, 1);
+    igraph_vector_init(&y, 20000);
+    igraph_vector_init(&y2, 20000);
+    igraph_sparsemat_csr_gaxpy(&csr, &x, &y);
+    igraph_sparsemat_gaxpy(&B, &x, &y2);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&y, &y2, 1e-12));
+
+    igraph_matrix_init(&dense, 20000, 20);
+    fill_unif(&dense.data, -1, 1);
+    igraph_matrix_init(&res2, 0, 0);
+    igraph_sparsemat_csr_multiply_by_dense(&csr, &dense, &res);
+    igraph_sparsemat_multiply_by_dense(&B, &dense, &res2);
+    IGRAPH_ASSERT(igraph_matrix_all_almost_e(&res, &res2, 1e-12));
+
+    igraph_matrix_destroy(&res2);
+    igraph_matrix_destroy(&res);
+    igraph_matrix_destroy(&dense);
+    igraph_vector_destroy(&y2);
+    igraph_vector_destroy(&y);
+    igraph_vector_destroy(&x);
+    igraph_sparsemat_destroy(&B);
+    igraph_sparsemat_destroy(&A);
+    igraph_sparsemat_csr_destroy(&csr);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&graph);
+
+    VERIFY_FINALLY_STACK();
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+/* IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include <math.h>
+#include "test_utilities.h"
+
+#include "misc/embedding.h"
+
+/* Checks that the block eigensolver, which is selected through the internal
+ * variants of the embedding and eigen_adjacency functions, gives the same
+ * results as ARPACK. */
+
+static void check_same_vectors(const igraph_matrix_t *a, const igraph_matrix_t *b) {
+    igraph_integer_t n = igraph_matrix_nrow(a), k = igraph_matrix_ncol(a);
+    IGRAPH_ASSERT(igraph_matrix_nrow(b) == n);
+    IGRAPH_ASSERT(igraph_matrix_ncol(b) == k);
+    for (igraph_integer_t j = 0; j < k; j++) {
+        igraph_real_t dot = 0, sign;
+        for (igraph_integer_t i = 0; i < n; i++) {
+            dot += MATRIX(*a, i, j) * MATRIX(*b, i, j);
+        }
+        sign = dot < 0 ? -1 : 1;
+        for (igraph_integer_t i = 0; i < n; i++) {
+            IGRAPH_ASSERT(fabs(MATRIX(*a, i, j) - sign * MATRIX(*b, i, j)) < 1e-6);
+        }
+    }
+}
+
+/* Checks that the columns of 'vectors' are orthonormal eigenvectors of the
+ * adjacency matrix of 'graph'. */
+static void check_eigenpairs(const igraph_t *graph, const igraph_vector_t *values,
+                             const igraph_matrix_t *vectors) {
+    igraph_integer_t n = igraph_vcount(graph), k = igraph_vector_size(values);
+    igraph_matrix_t A, AV, VtV;
+
+    IGRAPH_ASSERT(igraph_matrix_nrow(vectors) == n);
+    IGRAPH_ASSERT(igraph_matrix_ncol(vectors) == k);
+    igraph_matrix_init(&A, 0, 0);
+    igraph_matrix_init(&AV, 0, 0);
+    igraph_matrix_init(&VtV, 0, 0);
+    igraph_get_adjacency(graph, &A, IGRAPH_GET_ADJACENCY_BOTH, NULL, IGRAPH_LOOPS_TWICE);
+    igraph_blas_dgemm(false, false, 1, &A, vectors, 0, &AV);
+    igraph_blas_dgemm(true, false, 1, vectors, vectors, 0, &VtV);
+    for (igraph_integer_t j = 0; j < k; j++) {
+        for (igraph_integer_t i = 0; i < n; i++) {
+            IGRAPH_ASSERT(fabs(MATRIX(AV, i, j) - VECTOR(*values)[j] * MATRIX(*vectors, i, j)) < 1e-6);
+        }
+        for (igraph_integer_t i = 0; i < k; i++) {
+            IGRAPH_ASSERT(fabs(MATRIX(VtV, i, j) - (i == j ? 1 : 0)) < 1e-8);
+        }
+    }
+    igraph_matrix_destroy(&VtV);
+    igraph_matrix_destroy(&AV);
+    igraph_matrix_destroy(&A);
+}
+
+static void check_eigen_adjacency(const igraph_t *graph, igraph_eigen_which_position_t pos,
+                                  igraph_integer_t howmany, igraph_arpack_options_t *options) {
+    igraph_eigen_which_t which;
+    igraph_vector_t values, values2;
+    igraph_matrix_t vectors, vectors2;
+
+    igraph_vector_init(&values, 0);
+    igraph_vector_init(&values2, 0);
+    igraph_matrix_init(&vectors, 0, 0);
+    igraph_matrix_init(&vectors2, 0, 0);
+
+    which.pos = pos;
+    which.howmany = howmany;
+    options->start = 0;
+    igraph_eigen_adjacency(graph, IGRAPH_EIGEN_ARPACK, &which, options, NULL, &values, &vectors, NULL, NULL);
+    options->start = 0;
+    igraph_i_eigen_adjacency_lobpcg(graph, &which, options, &values2, &vectors2);
+
+    IGRAPH_ASSERT(igraph_vector_size(&values2) == howmany);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&values, &values2, 1e-8));
+    check_eigenpairs(graph, &values2, &vectors2);
+
+    igraph_matrix_destroy(&vectors2);
+    igraph_matrix_destroy(&vectors);
+    igraph_vector_destroy(&values2);
+    igraph_vector_destroy(&values);
+}
+
+int main(void) {
+    igraph_t graph, dgraph, small;
+    igraph_matrix_t pref, X, Y, X2, Y2;
+    igraph_vector_int_t block_sizes;
+    igraph_vector_t D, D2, cvec;
+    igraph_arpack_options_t options;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_arpack_options_init(&options);
+
+    /* Four blocks of different sizes, so that the leading eigenvalues are
+     * well separated. */
+    igraph_matrix_init(&pref, 4, 4);
+    igraph_matrix_fill(&pref, 0.02);
+    for (igraph_integer_t i = 0; i < 4; i++) {
+        MATRIX(pref, i, i) = 0.3;
+    }
+    igraph_vector_int_init_int(&block_sizes, 4, 60, 70, 80, 90);
+    igraph_sbm_game(&graph, 300, &pref, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_sbm_game(&dgraph, 300, &pref, &block_sizes, IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_int_destroy(&block_sizes);
+    igraph_matrix_destroy(&pref);
+
+    igraph_matrix_init(&X, 0, 0);
+    igraph_matrix_init(&Y, 0, 0);
+    igraph_matrix_init(&X2, 0, 0);
+    igraph_matrix_init(&Y2, 0, 0);
+    igraph_vector_init(&D, 0);
+    igraph_vector_init(&D2, 0);
+    igraph_vector_init(&cvec, 0);
+
+    printf("Adjacency spectral embedding, undirected\n");
+    igraph_strength(&graph, &cvec, igraph_vss_all(), IGRAPH_ALL, IGRAPH_LOOPS, NULL);
+    igraph_vector_scale(&cvec, 0.5);
+    igraph_adjacency_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_LA, true, &X, NULL, &D, &cvec, &options);
+    igraph_i_adjacency_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_LA, true, &X2, NULL, &D2, &cvec, &options, IGRAPH_I_EIGENSOLVER_LOBPCG);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&D, &D2, 1e-8));
+    check_same_vectors(&X, &X2);
+
+    printf("Adjacency spectral embedding, directed\n");
+    igraph_adjacency_spectral_embedding(&dgraph, 3, NULL, IGRAPH_EIGEN_LA, false, &X, &Y, &D, &cvec, &options);
+    igraph_i_adjacency_spectral_embedding(&dgraph, 3, NULL, IGRAPH_EIGEN_LA, false, &X2, &Y2, &D2, &cvec, &options, IGRAPH_I_EIGENSOLVER_LOBPCG);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&D, &D2, 1e-8));
+    check_same_vectors(&X, &X2);
+    check_same_vectors(&Y, &Y2);
+
+    printf("Laplacian spectral embedding, DAD\n");
+    igraph_laplacian_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_LA, IGRAPH_EMBEDDING_DAD, false, &X, NULL, &D, &options);
+    igraph_i_laplacian_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_LA, IGRAPH_EMBEDDING_DAD, false, &X2, NULL, &D2, &options, IGRAPH_I_EIGENSOLVER_LOBPCG);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&D, &D2, 1e-8));
+    check_same_vectors(&X, &X2);
+
+    printf("Laplacian spectral embedding, D-A, smallest eigenvalues\n");
+    igraph_laplacian_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_SA, IGRAPH_EMBEDDING_D_A, false, &X, NULL, &D, &options);
+    igraph_i_laplacian_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_SA, IGRAPH_EMBEDDING_D_A, false, &X2, NULL, &D2, &options, IGRAPH_I_EIGENSOLVER_LOBPCG);
+    IGRAPH_ASSERT(igraph_vector_all_almost_e(&D, &D2, 1e-8));
+    check_same_vectors(&X, &X2);
+
+    printf("Adjacency eigenvalues, largest algebraic\n");
+    check_eigen_adjacency(&graph, IGRAPH_EIGEN_LA, 4, &options);
+
+    printf("Adjacency eigenvalues, smallest algebraic\n");
+    check_eigen_adjacency(&graph, IGRAPH_EIGEN_SA, 3, &options);
+
+    printf("Adjacency eigenvalues, largest magnitude\n");
+    check_eigen_adjacency(&graph, IGRAPH_EIGEN_LM, 5, &options);
+
+    /* Graphs that are small compared to the block size are solved with a
+     * dense eigensolver. */
+    printf("Small graph\n");
+    igraph_erdos_renyi_game_gnp(&small, 12, 0.4, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    check_eigen_adjacency(&small, IGRAPH_EIGEN_LA, 3, &options);
+    check_eigen_adjacency(&small, IGRAPH_EIGEN_SA, 3, &options);
+    igraph_destroy(&small);
+
+    VERIFY_FINALLY_STACK();
+
+    printf("Not converging\n");
+    options.mxiter = 2;
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    CHECK_ERROR(igraph_i_adjacency_spectral_embedding(&graph, 4, NULL, IGRAPH_EIGEN_LA, true, &X2, NULL, &D2, &cvec, &options, IGRAPH_I_EIGENSOLVER_LOBPCG),
+                IGRAPH_ARPACK_MAXIT);
+    igraph_set_warning_handler(igraph_warning_handler_print);
+
+    igraph_vector_destroy(&cvec);
+    igraph_vector_destroy(&D2);
+    igraph_vector_destroy(&D);
+    igraph_matrix_destroy(&Y2);
+    igraph_matrix_destroy(&X2);
+    igraph_matrix_destroy(&Y);
+    igraph_matrix_destroy(&X);
+    igraph_destroy(&dgraph);
+    igraph_destroy(&graph);
+
+    VERIFY_FINALLY_STACK();
+
+    return 0;
+}
@@ -45,6 +45,84 @@ void print_and_destroy(igraph_t *graph, igraph_vector_int_t *trussness) {
     igraph_destroy(graph);
 }
 
+/* Naive reference: for k = 3, 4, ..., repeatedly removes edges that are in
+ * fewer than k-2 triangles of the remaining graph. */
+void reference_trussness(const igraph_t *graph, igraph_vector_int_t *trussness) {
+    igraph_integer_t m = igraph_ecount(graph);
+    igraph_integer_t remaining = m;
+    igraph_inclist_t il;
+    igraph_vector_bool_t alive;
+    igraph_vector_int_t support;
+
+    igraph_inclist_init(graph, &il, IGRAPH_ALL, IGRAPH_NO_LOOPS);
+    igraph_vector_bool_init(&alive, m);
+    igraph_vector_bool_fill(&alive, true);
+    igraph_vector_int_init(&support, m);
+    igraph_vector_int_resize(trussness, m);
+
+    for (igraph_integer_t e = 0; e < m; e++) {
+        if (IGRAPH_FROM(graph, e) == IGRAPH_TO(graph, e)) {
+            VECTOR(*trussness)[e] = 2;
+            VECTOR(alive)[e] = false;
+            remaining--;
+        }
+    }
+
+    for (igraph_integer_t k = 3; remaining > 0; k++) {
+        igraph_bool_t changed = true;
+        while (changed) {
+            changed = false;
+            for (igraph_integer_t e = 0; e < m; e++) {
+                igraph_integer_t u = IGRAPH_FROM(graph, e), v = IGRAPH_TO(graph, e);
+                igraph_vector_int_t *iu = igraph_inclist_get(&il, u);
+                igraph_vector_int_t *iv = igraph_inclist_get(&il, v);
+                igraph_integer_t i = 0, j = 0, count = 0;
+                if (!VECTOR(alive)[e]) {
+                    continue;
+                }
+                while (i < igraph_vector_int_size(iu) && j < igraph_vector_int_size(iv)) {
+                    igraph_integer_t eu = VECTOR(*iu)[i], ev = VECTOR(*iv)[j];
+                    igraph_integer_t wu = IGRAPH_OTHER(graph, eu, u), wv = IGRAPH_OTHER(graph, ev, v);
+                    if (wu < wv) {
+                        i++;
+                    } else if (wu > wv) {
+                        j++;
+                    } else {
+                        if (VECTOR(alive)[eu] && VECTOR(alive)[ev]) {
+                            count++;
+                        }
+                        i++; j++;
+                    }
+                }
+                VECTOR(support)[e] = count;
+            }
+            for (igraph_integer_t e = 0; e < m; e++) {
+                if (VECTOR(alive)[e] && VECTOR(support)[e] < k - 2) {
+                    VECTOR(alive)[e] = false;
+                    VECTOR(*trussness)[e] = k - 1;
+                    remaining--;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    igraph_vector_int_destroy(&support);
+    igraph_vector_bool_destroy(&alive);
+    igraph_inclist_destroy(&il);
+}
+
+void check_against_reference(const igraph_t *graph) {
+    igraph_vector_int_t trussness, expected;
+    igraph_vector_int_init(&trussness, 0);
+    igraph_vector_int_init(&expected, 0);
+    igraph_trussness(graph, &trussness);
+    reference_trussness(graph, &expected);
+    IGRAPH_ASSERT(igraph_vector_int_all_e(&trussness, &expected));
+    igraph_vector_int_destroy(&expected);
+    igraph_vector_int_destroy(&trussness);
+}
+
 int main(void) {
 
     igraph_t graph;
@@ -100,6 +178,30 @@ int main(void) {
 
     VERIFY_FINALLY_STACK();
 
+    /* Random graphs, the larger ones are processed in parallel when
+     * OpenMP is available */
+    printf("\nRandom graphs:\n");
+    igraph_rng_seed(igraph_rng_default(), 42);
+    for (int i = 0; i < 5; i++) {
+        igraph_erdos_renyi_game_gnm(&graph, 50, 400, IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+        check_against_reference(&graph);
+        igraph_destroy(&graph);
+    }
+    igraph_erdos_renyi_game_gnm(&graph, 60, 600, IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_to_undirected(&graph, IGRAPH_TO_UNDIRECTED_COLLAPSE, NULL);
+    check_against_reference(&graph);
+    igraph_destroy(&graph);
+    igraph_erdos_renyi_game_gnm(&graph, 1000, 20000, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    check_against_reference(&graph);
+    igraph_destroy(&graph);
+    igraph_barabasi_game(&graph, 3000, 1, 8, NULL, true, 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, NULL);
+    check_against_reference(&graph);
+    igraph_destroy(&graph);
+    printf("OK\n");
+
+    VERIFY_FINALLY_STACK();
+
     /* Multigraph */
     printf("\nTrying multigraph:\n");
     igraph_create(&graph, &v, 0, IGRAPH_UNDIRECTED);
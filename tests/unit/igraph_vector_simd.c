@@ -0,0 +1,355 @@
+/* IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+#include <math.h>
+#include <string.h>
+
+#include "core/simd.h"
+
+#include "test_utilities.h"
+
+/* Compares the vector functions, with each instruction set that the CPU
+ * supports, to the plain loops that they used to be. Vectors of all sizes
+ * up to MAXN are tried, at all offsets from an aligned address. */
+
+#define MAXN 70
+#define MAXOFF 8
+
+static igraph_bool_t same(igraph_real_t a, igraph_real_t b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/* Which NaN results from an operation on two NaNs is not specified. */
+static igraph_bool_t same_or_nan(igraph_real_t a, igraph_real_t b) {
+    return same(a, b) || (isnan(a) && isnan(b));
+}
+
+static igraph_real_t ref_max(const igraph_real_t *x, igraph_integer_t n) {
+    igraph_real_t max = x[0];
+    if (isnan(max)) {
+        return max;
+    }
+    for (igraph_integer_t i = 1; i < n; i++) {
+        if (x[i] > max) {
+            max = x[i];
+        } else if (isnan(x[i])) {
+            return x[i];
+        }
+    }
+    return max;
+}
+
+static igraph_real_t ref_min(const igraph_real_t *x, igraph_integer_t n) {
+    igraph_real_t min = x[0];
+    if (isnan(min)) {
+        return min;
+    }
+    for (igraph_integer_t i = 1; i < n; i++) {
+        if (x[i] < min) {
+            min = x[i];
+        } else if (isnan(x[i])) {
+            return x[i];
+        }
+    }
+    return min;
+}
+
+static igraph_integer_t ref_which_max(const igraph_real_t *x, igraph_integer_t n) {
+    igraph_integer_t which = 0;
+    if (isnan(x[0])) {
+        return 0;
+    }
+    for (igraph_integer_t i = 1; i < n; i++) {
+        if (x[i] > x[which]) {
+            which = i;
+        } else if (isnan(x[i])) {
+            return i;
+        }
+    }
+    return which;
+}
+
+static igraph_integer_t ref_which_min(const igraph_real_t *x, igraph_integer_t n) {
+    igraph_integer_t which = 0;
+    if (isnan(x[0])) {
+        return 0;
+    }
+    for (igraph_integer_t i = 1; i < n; i++) {
+        if (x[i] < x[which]) {
+            which = i;
+        } else if (isnan(x[i])) {
+            return i;
+        }
+    }
+    return which;
+}
+
+static igraph_bool_t ref_isininterval(const igraph_real_t *x, igraph_integer_t n,
+                                      igraph_real_t low, igraph_real_t high) {
+    for (igraph_integer_t i = 0; i < n; i++) {
+        if (!(x[i] >= low && x[i] <= high)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static igraph_real_t ref_maxdifference(const igraph_real_t *x, const igraph_real_t *y,
+                                       igraph_integer_t n) {
+    igraph_real_t diff = 0.0;
+    for (igraph_integer_t i = 0; i < n; i++) {
+        igraph_real_t d = fabs(x[i] - y[i]);
+        if (d > diff) {
+            diff = d;
+        } else if (isnan(d)) {
+            return d;
+        }
+    }
+    return diff;
+}
+
+/* Kind 0: uniform, kind 1: few distinct values, with zeros of both signs,
+ * kind 2: like kind 1, with NaNs, kind 3: like kind 0, with infinities. */
+static void fill(igraph_real_t *x, igraph_integer_t n, int kind) {
+    for (igraph_integer_t i = 0; i < n; i++) {
+        if (kind == 0 || kind == 3) {
+            x[i] = RNG_UNIF(-1, 1);
+        } else {
+            x[i] = RNG_INTEGER(-2, 2);
+            if (x[i] == 0 && RNG_UNIF01() < 0.5) {
+                x[i] = -0.0;
+            }
+        }
+    }
+    if (n > 0 && kind == 2) {
+        x[RNG_INTEGER(0, n - 1)] = IGRAPH_NAN;
+        x[RNG_INTEGER(0, n - 1)] = -IGRAPH_NAN;
+    }
+    if (n > 0 && kind == 3) {
+        x[RNG_INTEGER(0, n - 1)] = IGRAPH_INFINITY;
+        x[RNG_INTEGER(0, n - 1)] = -IGRAPH_INFINITY;
+    }
+}
+
+static void check_real(igraph_i_simd_level_t level) {
+    igraph_real_t xbuf[MAXN + MAXOFF], ybuf[MAXN + MAXOFF], zbuf[MAXN + MAXOFF];
+    igraph_vector_t xv, yv, zv;
+
+    for (igraph_integer_t n = 0; n <= MAXN; n++) {
+        for (int off = 0; off < MAXOFF; off++) {
+            for (int kind = 0; kind < 4; kind++) {
+                igraph_real_t *x = xbuf + off, *y = ybuf + off, *z = zbuf + off;
+                igraph_real_t min, max, c = RNG_UNIF(-2, 2);
+
+                fill(x, n, kind);
+                fill(y, n, kind == 2 ? 1 : kind);
+                igraph_vector_view(&xv, x, n);
+                igraph_vector_view(&yv, y, n);
+                igraph_vector_view(&zv, z, n);
+
+                if (n > 0) {
+                    IGRAPH_ASSERT(same(igraph_vector_max(&xv), ref_max(x, n)));
+                    IGRAPH_ASSERT(same(igraph_vector_min(&xv), ref_min(x, n)));
+                    IGRAPH_ASSERT(igraph_vector_which_max(&xv) == ref_which_max(x, n));
+                    IGRAPH_ASSERT(igraph_vector_which_min(&xv) == ref_which_min(x, n));
+                    igraph_vector_minmax(&xv, &min, &max);
+                    if (isnan(ref_max(x, n))) {
+                        IGRAPH_ASSERT(same(min, ref_max(x, n)) && same(max, ref_max(x, n)));
+                    } else {
+                        IGRAPH_ASSERT(same(min, ref_min(x, n)) && same(max, ref_max(x, n)));
+                    }
+                    IGRAPH_ASSERT(same(igraph_vector_maxdifference(&xv, &yv), ref_maxdifference(x, y, n)));
+                }
+                IGRAPH_ASSERT(igraph_vector_isininterval(&xv, -1, 1) == ref_isininterval(x, n, -1, 1));
+                IGRAPH_ASSERT(igraph_vector_isininterval(&xv, -0.9, 0.9) == ref_isininterval(x, n, -0.9, 0.9));
+                IGRAPH_ASSERT(igraph_vector_isininterval(&xv, -IGRAPH_INFINITY, IGRAPH_INFINITY) ==
+                              ref_isininterval(x, n, -IGRAPH_INFINITY, IGRAPH_INFINITY));
+
+#define CHECK_ELEMENTWISE(CALL, EXPR) \
+                do { \
+                    memcpy(z, x, n * sizeof(igraph_real_t)); \
+                    CALL; \
+                    for (igraph_integer_t i = 0; i < n; i++) { \
+                        IGRAPH_ASSERT(same(z[i], EXPR)); \
+                    } \
+                } while (0)
+
+                CHECK_ELEMENTWISE(igraph_vector_add(&zv, &yv), x[i] + y[i]);
+                CHECK_ELEMENTWISE(igraph_vector_sub(&zv, &yv), x[i] - y[i]);
+                CHECK_ELEMENTWISE(igraph_vector_mul(&zv, &yv), x[i] * y[i]);
+                CHECK_ELEMENTWISE(igraph_vector_div(&zv, &yv), x[i] / y[i]);
+                CHECK_ELEMENTWISE(igraph_vector_scale(&zv, c), x[i] * c);
+                CHECK_ELEMENTWISE(igraph_vector_add_constant(&zv, c), x[i] + c);
+
+#undef CHECK_ELEMENTWISE
+
+                /* Sums and products do not depend on the instruction set,
+                 * and are close to the sequential ones. */
+                {
+                    igraph_real_t sum, prod, sumsq, ref_sum = 0, ref_prod = 1, ref_sumsq = 0, abs_sum = 0;
+                    for (igraph_integer_t i = 0; i < n; i++) {
+                        ref_sum += x[i];
+                        ref_prod *= x[i];
+                        ref_sumsq += x[i] * x[i];
+                        abs_sum += fabs(x[i]);
+                    }
+                    sum = igraph_vector_sum(&xv);
+                    prod = igraph_vector_prod(&xv);
+                    sumsq = igraph_vector_sumsq(&xv);
+                    igraph_i_simd_force_level(IGRAPH_I_SIMD_SCALAR);
+                    IGRAPH_ASSERT(same_or_nan(sum, igraph_vector_sum(&xv)));
+                    IGRAPH_ASSERT(same_or_nan(prod, igraph_vector_prod(&xv)));
+                    IGRAPH_ASSERT(same_or_nan(sumsq, igraph_vector_sumsq(&xv)));
+                    igraph_i_simd_force_level(level);
+                    if (kind != 2 && kind != 3) {
+                        IGRAPH_ASSERT(fabs(sum - ref_sum) <= 1e-13 * abs_sum);
+                        IGRAPH_ASSERT(fabs(sumsq - ref_sumsq) <= 1e-13 * ref_sumsq);
+                        IGRAPH_ASSERT(fabs(prod - ref_prod) <= 1e-13 * fabs(ref_prod));
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void check_int(void) {
+    igraph_integer_t xbuf[MAXN + MAXOFF], ybuf[MAXN + MAXOFF], zbuf[MAXN + MAXOFF];
+    igraph_vector_int_t xv, yv, zv;
+
+    for (igraph_integer_t n = 0; n <= MAXN; n++) {
+        for (int off = 0; off < MAXOFF; off++) {
+            igraph_integer_t *x = xbuf + off, *y = ybuf + off, *z = zbuf + off;
+            igraph_integer_t min, max, which_min, which_max, sum, c = RNG_INTEGER(-100, 100);
+            /* Few distinct values, so that there are ties. */
+            igraph_integer_t range = RNG_INTEGER(1, 10);
+
+            for (igraph_integer_t i = 0; i < n; i++) {
+                x[i] = RNG_INTEGER(-range, range);
+                y[i] = RNG_INTEGER(-1000000, 1000000);
+            }
+            igraph_vector_int_view(&xv, x, n);
+            igraph_vector_int_view(&yv, y, n);
+            igraph_vector_int_view(&zv, z, n);
+
+            sum = 0;
+            for (igraph_integer_t i = 0; i < n; i++) {
+                sum += x[i];
+            }
+            IGRAPH_ASSERT(igraph_vector_int_sum(&xv) == sum);
+
+            if (n > 0) {
+                min = max = x[0];
+                which_min = which_max = 0;
+                for (igraph_integer_t i = 1; i < n; i++) {
+                    if (x[i] > max) {
+                        max = x[i];
+                        which_max = i;
+                    }
+                    if (x[i] < min) {
+                        min = x[i];
+                        which_min = i;
+                    }
+                }
+                IGRAPH_ASSERT(igraph_vector_int_max(&xv) == max);
+                IGRAPH_ASSERT(igraph_vector_int_min(&xv) == min);
+                IGRAPH_ASSERT(igraph_vector_int_which_max(&xv) == which_max);
+                IGRAPH_ASSERT(igraph_vector_int_which_min(&xv) == which_min);
+                igraph_vector_int_minmax(&xv, &min, &max);
+                IGRAPH_ASSERT(min == x[which_min] && max == x[which_max]);
+            }
+
+            memcpy(z, x, n * sizeof(igraph_integer_t));
+            igraph_vector_int_add(&zv, &yv);
+            for (igraph_integer_t i = 0; i < n; i++) {
+                IGRAPH_ASSERT(z[i] == x[i] + y[i]);
+            }
+            memcpy(z, x, n * sizeof(igraph_integer_t));
+            igraph_vector_int_sub(&zv, &yv);
+            for (igraph_integer_t i = 0; i < n; i++) {
+                IGRAPH_ASSERT(z[i] == x[i] - y[i]);
+            }
+            memcpy(z, x, n * sizeof(igraph_integer_t));
+            igraph_vector_int_add_constant(&zv, c);
+            for (igraph_integer_t i = 0; i < n; i++) {
+                IGRAPH_ASSERT(z[i] == x[i] + c);
+            }
+
+            /* Cumulative sums, also in place. */
+            {
+                igraph_vector_int_t to;
+                igraph_vector_int_init(&to, 0);
+                igraph_vector_int_cumsum(&to, &yv);
+                sum = 0;
+                for (igraph_integer_t i = 0; i < n; i++) {
+                    sum += y[i];
+                    IGRAPH_ASSERT(VECTOR(to)[i] == sum);
+                }
+                memcpy(z, y, n * sizeof(igraph_integer_t));
+                igraph_vector_int_cumsum(&zv, &zv);
+                IGRAPH_ASSERT(n == 0 || igraph_vector_int_all_e(&zv, &to));
+                igraph_vector_int_destroy(&to);
+            }
+        }
+    }
+}
+
+int main(void) {
+    igraph_i_simd_level_t levels[] = {
+        IGRAPH_I_SIMD_SCALAR, IGRAPH_I_SIMD_SSE2, IGRAPH_I_SIMD_AVX2,
+        IGRAPH_I_SIMD_AVX512, IGRAPH_I_SIMD_NEON
+    };
+    igraph_matrix_t m;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    for (size_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        if (!igraph_i_simd_level_supported(levels[i])) {
+            continue;
+        }
+        igraph_i_simd_force_level(levels[i]);
+        check_real(levels[i]);
+        check_int();
+    }
+    igraph_i_simd_reset_level();
+
+    /* Matrix functions use the same kernels. */
+    printf("Matrix:\n");
+    igraph_matrix_init(&m, 5, 7);
+    for (igraph_integer_t i = 0; i < 35; i++) {
+        MATRIX(m, i % 5, i / 5) = (i * 17) % 11 - 5;
+    }
+    {
+        igraph_integer_t i, j;
+        igraph_real_t min, max;
+        printf("sum: %g, max: %g, min: %g\n", igraph_matrix_sum(&m), igraph_matrix_max(&m), igraph_matrix_min(&m));
+        igraph_matrix_which_max(&m, &i, &j);
+        printf("which max: %" IGRAPH_PRId ", %" IGRAPH_PRId "\n", i, j);
+        igraph_matrix_which_min(&m, &i, &j);
+        printf("which min: %" IGRAPH_PRId ", %" IGRAPH_PRId "\n", i, j);
+        igraph_matrix_minmax(&m, &min, &max);
+        printf("minmax: %g, %g\n", min, max);
+        igraph_matrix_scale(&m, 0.5);
+        igraph_matrix_add_constant(&m, 1);
+        print_matrix(&m);
+    }
+    igraph_matrix_destroy(&m);
+
+    VERIFY_FINALLY_STACK();
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+   IGraph library.
+   Copyright (C) 2023  The igraph development team <igraph@igraph.org>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <igraph.h>
+
+#include "test_utilities.h"
+
+/* Prints the first few raw outputs of a generator. */
+void print_raw(igraph_rng_t *rng, int count) {
+    for (int i = 0; i < count; i++) {
+        printf(" %08" PRIx32, (uint32_t) rng->type->get(rng->state));
+    }
+    printf("\n");
+}
+
+/* Checks that two streams of the same seed differ, and that reseeding a stream
+ * reproduces it. */
+void check_streams(const igraph_rng_type_t *type) {
+    igraph_rng_t rng;
+    igraph_real_t a[100], b[100];
+    igraph_integer_t equal = 0;
+
+    igraph_rng_init(&rng, type);
+
+    igraph_rng_seed_stream(&rng, 42, 0);
+    for (int i = 0; i < 100; i++) {
+        a[i] = igraph_rng_get_unif01(&rng);
+    }
+    igraph_rng_seed_stream(&rng, 42, 1);
+    for (int i = 0; i < 100; i++) {
+        b[i] = igraph_rng_get_unif01(&rng);
+        equal += (a[i] == b[i]);
+    }
+    IGRAPH_ASSERT(equal < 3);
+
+    igraph_rng_seed_stream(&rng, 42, 0);
+    for (int i = 0; i < 100; i++) {
+        IGRAPH_ASSERT(igraph_rng_get_unif01(&rng) == a[i]);
+    }
+
+    igraph_rng_destroy(&rng);
+}
+
+int main(void) {
+    igraph_rng_t rng;
+
+    igraph_rng_init(&rng, &igraph_rngtype_philox4x32);
+    printf("Name: %s, bits: %" IGRAPH_PRId "\n", igraph_rng_name(&rng), igraph_rng_bits(&rng));
+
+    /* Known answers of Philox4x32-10 from the Random123 test suite. With
+     * seed 0 and stream 0, the first counter value is all zeros. */
+    printf("\nKey 0, counter 0:\n");
+    igraph_rng_seed(&rng, 0);
+    print_raw(&rng, 4);
+    printf("Next counter value:\n");
+    print_raw(&rng, 4);
+
+    printf("\nStream 0 is the same as plain seeding:\n");
+    igraph_rng_seed(&rng, 12345);
+    {
+        igraph_integer_t x = igraph_rng_get_integer(&rng, 0, 1000000);
+        igraph_rng_seed_stream(&rng, 12345, 0);
+        IGRAPH_ASSERT(igraph_rng_get_integer(&rng, 0, 1000000) == x);
+    }
+    printf("OK\n");
+
+    printf("\nReproducible values:\n");
+    igraph_rng_seed(&rng, 137);
+    for (int i = 0; i < 8; i++) {
+        printf("%" IGRAPH_PRId "\n", igraph_rng_get_integer(&rng, 0, 100));
+    }
+    igraph_rng_seed_stream(&rng, 137, 1000000);
+    for (int i = 0; i < 8; i++) {
+        printf("%" IGRAPH_PRId "\n", igraph_rng_get_integer(&rng, 0, 100));
+    }
+    igraph_rng_destroy(&rng);
+
+    printf("\nIndependent streams:\n");
+    check_streams(&igraph_rngtype_philox4x32);
+    check_streams(&igraph_rngtype_pcg32);
+    check_streams(&igraph_rngtype_pcg64);
+    check_streams(&igraph_rngtype_mt19937);
+    check_streams(&igraph_rngtype_glibc2);
+    printf("OK\n");
+
+    printf("\nUniform distribution:\n");
+    igraph_rng_init(&rng, &igraph_rngtype_philox4x32);
+    {
+        igraph_integer_t counts[10] = { 0 };
+        for (igraph_integer_t s = 0; s < 100; s++) {
+            igraph_rng_seed_stream(&rng, 7, (igraph_uint_t) s);
+            for (int i = 0; i < 1000; i++) {
+                counts[igraph_rng_get_integer(&rng, 0, 9)]++;
+            }
+        }
+        for (int i = 0; i < 10; i++) {
+            IGRAPH_ASSERT(counts[i] > 9500 && counts[i] < 10500);
+        }
+    }
+    igraph_rng_destroy(&rng);
+    printf("OK\n");
+
+    printf("\nUsing a stream as the default generator:\n");
+    {
+        igraph_rng_t saved = *igraph_rng_default();
+        igraph_integer_t x;
+
+        igraph_rng_init(&rng, &igraph_rngtype_philox4x32);
+        igraph_rng_seed_stream(&rng, 3, 5);
+        igraph_rng_set_default(&rng);
+        x = RNG_INTEGER(0, 1000000);
+        igraph_rng_set_default(&saved);
+
+        igraph_rng_seed_stream(&rng, 3, 5);
+        IGRAPH_ASSERT(igraph_rng_get_integer(&rng, 0, 1000000) == x);
+        igraph_rng_destroy(&rng);
+    }
+    IGRAPH_ASSERT(igraph_rng_default()->type == &igraph_rngtype_pcg32);
+    printf("OK\n");
+
+    VERIFY_FINALLY_STACK();
+    return 0;
+}
@@ -114,6 +114,45 @@ int main(void) {
     printf("Modularity: %g\n", modularity);
     print_vector_int(&membership);
 
+    printf("\nParallel tempering.\n");
+    igraph_community_spinglass_tempering(&g,
+                                         NULL, /* no weights */
+                                         &modularity,
+                                         &temperature,
+                                         &membership,
+                                         &csize,
+                                         10,   /* no of spins */
+                                         4,    /* no of replicas */
+                                         1.0,  /* start temperature */
+                                         0.01, /* stop temperature */
+                                         0.99, /* cooling factor */
+                                         IGRAPH_SPINCOMM_UPDATE_CONFIG,
+                                         1.0 /* gamma */);
+
+    IGRAPH_ASSERT(igraph_vector_int_size(&membership) == igraph_vcount(&g));
+    IGRAPH_ASSERT(igraph_vector_int_size(&csize) == igraph_vector_int_max(&membership) + 1);
+
+    printf("Modularity: %g\n", modularity);
+    print_vector_int(&membership);
+
+    printf("\nParallel tempering, simple update rule.\n");
+    igraph_community_spinglass_tempering(&g, NULL, &modularity, &temperature,
+                                         &membership, &csize, 10, 1, 1.0, 0.01, 0.99,
+                                         IGRAPH_SPINCOMM_UPDATE_SIMPLE, 1.0);
+
+    IGRAPH_ASSERT(igraph_vector_int_size(&membership) == igraph_vcount(&g));
+    IGRAPH_ASSERT(igraph_vector_int_size(&csize) == igraph_vector_int_max(&membership) + 1);
+
+    printf("Modularity: %g\n", modularity);
+    print_vector_int(&membership);
+
+    CHECK_ERROR(igraph_community_spinglass_tempering(&g, NULL, &modularity, &temperature,
+                &membership, &csize, 10, 0, 1.0, 0.01, 0.99,
+                IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0), IGRAPH_EINVAL);
+    CHECK_ERROR(igraph_community_spinglass_tempering(&g, NULL, &modularity, &temperature,
+                &membership, &csize, 10, 4, 0.0, 0.0, 0.99,
+                IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0), IGRAPH_EINVAL);
+
     /* Try to call this as well, we don't check the results currently.... */
 
     igraph_community_spinglass_single(&g,
@@ -176,6 +215,55 @@ int main(void) {
     IGRAPH_ASSERT(isnan(modularity));
     igraph_destroy(&g);
 
+    printf("\nParallel tempering: singleton graph.\n");
+    igraph_empty(&g, 1, IGRAPH_UNDIRECTED);
+    igraph_community_spinglass_tempering(&g, NULL, &modularity, &temperature,
+                                         &membership, &csize, 10, 4, 1.0, 0.01, 0.99,
+                                         IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0);
+    IGRAPH_ASSERT(igraph_vector_int_size(&membership) == 1 && VECTOR(membership)[0] == 0);
+    IGRAPH_ASSERT(igraph_vector_int_size(&csize) == 1 && VECTOR(csize)[0] == 1);
+    igraph_destroy(&g);
+
+    printf("\nParallel tempering: reproducibility.\n");
+    {
+        igraph_matrix_t pref_matrix;
+        igraph_vector_int_t block_sizes, membership2;
+        igraph_real_t modularity2, expected;
+
+        igraph_matrix_init(&pref_matrix, 4, 4);
+        igraph_matrix_fill(&pref_matrix, 0.01);
+        for (igraph_integer_t i = 0; i < 4; i++) {
+            MATRIX(pref_matrix, i, i) = 0.2;
+        }
+        igraph_vector_int_init(&block_sizes, 4);
+        igraph_vector_int_fill(&block_sizes, 50);
+        igraph_sbm_game(&g, 200, &pref_matrix, &block_sizes, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+        igraph_vector_int_init(&membership2, 0);
+
+        igraph_rng_seed(igraph_rng_default(), 42);
+        igraph_community_spinglass_tempering(&g, NULL, &modularity, NULL,
+                                             &membership, NULL, 25, 4, 1.0, 0.01, 0.99,
+                                             IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0);
+        igraph_rng_seed(igraph_rng_default(), 42);
+        igraph_community_spinglass_tempering(&g, NULL, &modularity2, NULL,
+                                             &membership2, NULL, 25, 4, 1.0, 0.01, 0.99,
+                                             IGRAPH_SPINCOMM_UPDATE_CONFIG, 1.0);
+        IGRAPH_ASSERT(igraph_vector_int_all_e(&membership, &membership2));
+        IGRAPH_ASSERT(modularity == modularity2);
+
+        /* The planted partition is found. */
+        for (igraph_integer_t i = 0; i < 200; i++) {
+            VECTOR(membership2)[i] = i / 50;
+        }
+        igraph_modularity(&g, &membership2, NULL, 1.0, IGRAPH_UNDIRECTED, &expected);
+        IGRAPH_ASSERT(modularity > expected - 1e-3);
+
+        igraph_vector_int_destroy(&membership2);
+        igraph_vector_int_destroy(&block_sizes);
+        igraph_matrix_destroy(&pref_matrix);
+        igraph_destroy(&g);
+    }
+
     igraph_vector_int_destroy(&membership);
     igraph_vector_int_destroy(&csize);
 
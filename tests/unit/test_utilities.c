@@ -504,6 +504,33 @@ void vector_chop(igraph_vector_t *vec, igraph_real_t cutoff) {
     }
 }
 
+/* Pearson correlation of the graph distances and the Euclidean distances of
+ * all vertex pairs in a layout, which is close to 1 for a good layout of a
+ * lattice. */
+igraph_real_t distance_correlation(const igraph_t *graph, const igraph_matrix_t *layout) {
+    igraph_integer_t n = igraph_vcount(graph), dim = igraph_matrix_ncol(layout);
+    igraph_matrix_t dist;
+    igraph_real_t sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0, cnt = 0;
+
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_distances(graph, &dist, igraph_vss_all(), igraph_vss_all(), IGRAPH_ALL);
+    for (igraph_integer_t i = 0; i < n; i++) {
+        for (igraph_integer_t j = 0; j < i; j++) {
+            igraph_real_t x = MATRIX(dist, i, j), y = 0;
+            for (igraph_integer_t c = 0; c < dim; c++) {
+                igraph_real_t d = MATRIX(*layout, i, c) - MATRIX(*layout, j, c);
+                y += d * d;
+            }
+            y = sqrt(y);
+            sx += x; sy += y; sxx += x * x; syy += y * y; sxy += x * y; cnt++;
+        }
+    }
+    igraph_matrix_destroy(&dist);
+
+    return (sxy / cnt - sx / cnt * sy / cnt) /
+           sqrt((sxx / cnt - sx * sx / cnt / cnt) * (syy / cnt - sy * sy / cnt / cnt));
+}
+
 /* print all graph, edge and vertex attributes of a graph */
 void print_attributes(const igraph_t *g) {
     igraph_vector_int_t gtypes, vtypes, etypes;
@@ -120,6 +120,10 @@ void matrix_init_real_row_major(igraph_matrix_t *mat, igraph_integer_t nrow, igr
 void matrix_chop(igraph_matrix_t *mat, igraph_real_t cutoff);
 void vector_chop(igraph_vector_t *vec, igraph_real_t cutoff);
 
+/* Pearson correlation of the graph distances and the Euclidean distances of
+ * all vertex pairs in a layout. */
+igraph_real_t distance_correlation(const igraph_t *graph, const igraph_matrix_t *layout);
+
 #define VERIFY_FINALLY_STACK() \
     if (!IGRAPH_FINALLY_STACK_EMPTY) { \
         printf( \